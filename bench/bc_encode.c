@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bench.h"
+#include "utils/jobs.h"
+#include "managers/asset_manager/loaders/image_bcn.h"
+#include "managers/asset_manager/loaders/image_mips.h"
+
+#define IMAGE_SIZE 1024u
+#define ROUNDS 3u
+
+typedef struct bench_image_t
+{
+    const char *name;
+    uint32_t channels;
+    uint32_t has_alpha;
+    uint8_t *pixels;
+} bench_image_t;
+
+static uint32_t bench_rand(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static uint8_t bench_u8(float v)
+{
+    v = v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v);
+    return (uint8_t)(v + 0.5f);
+}
+
+// Color texture: one brightness pattern tinted by a slowly changing hue, so R, G and B move together.
+static void bench_fill_albedo(bench_image_t *img, uint32_t seed)
+{
+    for (uint32_t y = 0; y < IMAGE_SIZE; ++y)
+        for (uint32_t x = 0; x < IMAGE_SIZE; ++x)
+        {
+            uint8_t *p = img->pixels + ((size_t)y * IMAGE_SIZE + x) * img->channels;
+            const float lum = 0.5f + 0.3f * sinf((float)x * 0.031f) * cosf((float)y * 0.017f) + (float)(bench_rand(&seed) & 31u) / 255.0f;
+            const float hue = (float)(x + y) / (float)(2u * IMAGE_SIZE);
+            p[0] = bench_u8(lum * (180.0f + 60.0f * hue));
+            p[1] = bench_u8(lum * (140.0f + 30.0f * hue));
+            p[2] = bench_u8(lum * (100.0f - 40.0f * hue));
+            if (img->channels == 4u)
+                p[3] = ((x / 64u) + (y / 64u)) & 1u ? 255u : bench_u8(128.0f + 127.0f * sinf((float)y * 0.05f));
+        }
+}
+
+// Tangent-space normals of a height field.
+static void bench_fill_normal(bench_image_t *img, uint32_t seed)
+{
+    (void)seed;
+    for (uint32_t y = 0; y < IMAGE_SIZE; ++y)
+        for (uint32_t x = 0; x < IMAGE_SIZE; ++x)
+        {
+            uint8_t *p = img->pixels + ((size_t)y * IMAGE_SIZE + x) * img->channels;
+            const float dx = 0.6f * cosf((float)x * 0.05f) * sinf((float)y * 0.021f);
+            const float dy = 0.6f * sinf((float)x * 0.013f) * cosf((float)y * 0.043f);
+            const float inv = 1.0f / sqrtf(dx * dx + dy * dy + 1.0f);
+            p[0] = bench_u8((-dx * inv * 0.5f + 0.5f) * 255.0f);
+            p[1] = bench_u8((-dy * inv * 0.5f + 0.5f) * 255.0f);
+            p[2] = bench_u8((inv * 0.5f + 0.5f) * 255.0f);
+        }
+}
+
+// Packed occlusion / roughness / metalness: three unrelated patterns, metalness mostly 0 or 255.
+static void bench_fill_orm(bench_image_t *img, uint32_t seed)
+{
+    for (uint32_t y = 0; y < IMAGE_SIZE; ++y)
+        for (uint32_t x = 0; x < IMAGE_SIZE; ++x)
+        {
+            uint8_t *p = img->pixels + ((size_t)y * IMAGE_SIZE + x) * img->channels;
+            p[0] = bench_u8(200.0f + 55.0f * sinf((float)x * 0.011f + (float)y * 0.007f));
+            p[1] = bench_u8(128.0f + 90.0f * cosf((float)y * 0.037f) + (float)(bench_rand(&seed) & 63u) - 32.0f);
+            p[2] = ((x * 7u / 256u) ^ (y * 5u / 256u)) & 1u ? 255u : 0u;
+        }
+}
+
+static double bench_psnr(uint32_t format, const uint8_t *pixels, uint32_t channels, uint8_t *scratch)
+{
+    uint64_t err = 0;
+    if (!asset_image_bc_encode(format, pixels, IMAGE_SIZE, IMAGE_SIZE, channels, scratch, &err))
+        return 0.0;
+    uint32_t kept = channels;
+    if (format == ASSET_IMAGE_BC1 && kept > 3u)
+        kept = 3u;
+    else if (format == ASSET_IMAGE_BC5)
+        kept = 2u;
+    if (!err)
+        return 99.0;
+    const double n = (double)IMAGE_SIZE * IMAGE_SIZE * kept;
+    return 10.0 * log10(255.0 * 255.0 * n / (double)err);
+}
+
+static void bench_run(bench_image_t *img, uint8_t *scratch)
+{
+    asset_image_mip_chain_t *chain = NULL;
+    if (!asset_image_mips_build_u8(&chain, img->pixels, IMAGE_SIZE, IMAGE_SIZE, img->channels, ASSET_IMAGE_MIP_FILTER_BOX, 0u))
+    {
+        fprintf(stderr, "%s: mip build failed\n", img->name);
+        return;
+    }
+
+    asset_image_bc_stats_t st = {0};
+    double best = 0.0;
+    for (uint32_t r = 0; r < ROUNDS; ++r)
+    {
+        asset_image_mip_chain_t *bc = NULL;
+        const double t0 = bench_now();
+        const bool ok = asset_image_bc_compress_chain(&bc, chain, img->channels, img->has_alpha, &st);
+        const double t = bench_now() - t0;
+        if (!ok)
+        {
+            fprintf(stderr, "%s: compression failed\n", img->name);
+            break;
+        }
+        asset_image_mips_free(bc);
+        if (r == 0 || t < best)
+            best = t;
+    }
+
+    printf("%-8s %-5s %8.1f MP/s  PSNR %6.2f dB   base level: BC1 %6.2f  BC7 %6.2f\n",
+           img->name, asset_image_bc_name(st.format),
+           best > 0.0 ? (double)st.pixels / best * 1e-6 : 0.0, st.psnr,
+           bench_psnr(ASSET_IMAGE_BC1, img->pixels, img->channels, scratch),
+           bench_psnr(ASSET_IMAGE_BC7, img->pixels, img->channels, scratch));
+    asset_image_mips_free(chain);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t workers = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 0u;
+    if (!jobs_init(workers))
+        return 1;
+    printf("%u thread(s), %ux%u with mips, best of %u\n", workers + 1u, IMAGE_SIZE, IMAGE_SIZE, ROUNDS);
+
+    bench_image_t images[] = {
+        {"albedo", 3u, 0u, NULL},
+        {"albedoa", 4u, 1u, NULL},
+        {"normal", 3u, 0u, NULL},
+        {"orm", 3u, 0u, NULL},
+    };
+    void (*fill[])(bench_image_t *, uint32_t) = {bench_fill_albedo, bench_fill_albedo, bench_fill_normal, bench_fill_orm};
+
+    uint8_t *scratch = (uint8_t *)malloc((size_t)IMAGE_SIZE * IMAGE_SIZE);
+    int rc = scratch ? 0 : 1;
+    for (uint32_t i = 0; !rc && i < sizeof(images) / sizeof(images[0]); ++i)
+    {
+        images[i].pixels = (uint8_t *)malloc((size_t)IMAGE_SIZE * IMAGE_SIZE * images[i].channels);
+        if (!images[i].pixels)
+        {
+            rc = 1;
+            break;
+        }
+        fill[i](&images[i], 0x9E3779B9u + i);
+        bench_run(&images[i], scratch);
+        free(images[i].pixels);
+    }
+
+    free(scratch);
+    jobs_shutdown();
+    return rc;
+}
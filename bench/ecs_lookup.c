@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "core/systems/ecs/ecs.h"
+#include "core/systems/ecs/components/c_tag.h"
+#include "core/systems/ecs/components/c_transform.h"
+#include "core/systems/ecs/components/c_light.h"
+#include "core/systems/ecs/components/c_mesh_renderer.h"
+#include "core/systems/ecs/components/c_world_transform.h"
+
+#define ENTITY_COUNT 20000
+#define ROUNDS 200
+
+static void bench_register(ecs_world_t *w)
+{
+    c_tag_register(w);
+    c_transform_register(w);
+    c_mesh_renderer_register(w);
+    c_light_register(w);
+    c_world_transform_register(w);
+    ecs_world_set_required_tag(w, ecs_component_id(w, c_tag_t));
+}
+
+int main(void)
+{
+    ecs_world_t w;
+    ecs_world_init(&w, (ecs_world_desc_t){0});
+    bench_register(&w);
+
+    ecs_entity_t *entities = (ecs_entity_t *)malloc(sizeof(ecs_entity_t) * ENTITY_COUNT);
+    if (!entities)
+        return 1;
+
+    for (uint32_t i = 0; i < ENTITY_COUNT; ++i)
+    {
+        entities[i] = ecs_entity_create(&w);
+        ecs_add(&w, entities[i], c_transform_t);
+        if (i % 3 == 0)
+            ecs_add(&w, entities[i], c_light_t);
+    }
+
+    volatile float sink = 0.0f;
+    uint32_t hits = 0;
+
+    double t0 = bench_now();
+    for (uint32_t r = 0; r < ROUNDS; ++r)
+        for (uint32_t i = 0; i < ENTITY_COUNT; ++i)
+            hits += (ecs_component_id(&w, c_light_t) != 0) + (ecs_component_id(&w, c_transform_t) != 0);
+    double t1 = bench_now();
+
+    for (uint32_t r = 0; r < ROUNDS; ++r)
+        for (uint32_t i = 0; i < ENTITY_COUNT; ++i)
+        {
+            c_transform_t *t = ecs_get(&w, entities[i], c_transform_t);
+            sink += t->scale.x;
+            hits += ecs_has(&w, entities[i], c_light_t);
+        }
+    double t2 = bench_now();
+
+    /* A second world invalidates every cached slot on each switch. */
+    ecs_world_t w2;
+    ecs_world_init(&w2, (ecs_world_desc_t){0});
+    bench_register(&w2);
+
+    for (uint32_t r = 0; r < ROUNDS; ++r)
+        for (uint32_t i = 0; i < ENTITY_COUNT / 16; ++i)
+            hits += (ecs_component_id((i & 1) ? &w2 : &w, c_transform_t) != 0);
+    double t3 = bench_now();
+
+    const double n = (double)ROUNDS * ENTITY_COUNT;
+    printf("component id lookup   %8.2f ns/op\n", (t1 - t0) * 1e9 / (n * 2.0));
+    printf("ecs_get + ecs_has     %8.2f ns/op\n", (t2 - t1) * 1e9 / (n * 2.0));
+    printf("world switch lookup   %8.2f ns/op\n", (t3 - t2) * 1e9 / (n / 16.0));
+    printf("(%u hits, %f)\n", hits, (double)sink);
+
+    ecs_world_destroy(&w2);
+    ecs_world_destroy(&w);
+    free(entities);
+    return 0;
+}
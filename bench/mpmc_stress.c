@@ -0,0 +1,384 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "bench.h"
+#include "utils/jobs.h"
+#include "utils/threads.h"
+#include "managers/asset_manager/asset_manager.h"
+#include "managers/asset_manager/asset_ring.h"
+
+#define MAX_WORKERS 32u
+#define ITEMS_TOTAL (1u << 21)
+#define RING_CAPACITY 256u
+
+typedef struct stress_t
+{
+    asset_ring_t ring;
+    uint32_t per_producer;
+    uint32_t total;
+    volatile uint32_t go;
+    volatile uint32_t popped;
+} stress_t;
+
+typedef struct stress_worker_t
+{
+    stress_t *s;
+    uint32_t index;
+    uint32_t count;
+    uint64_t sum;
+} stress_worker_t;
+
+static void stress_wait_go(stress_t *s)
+{
+    while (!atomic_load_u32(&s->go))
+        threads_yield();
+}
+
+static void stress_producer(void *arg)
+{
+    stress_worker_t *w = (stress_worker_t *)arg;
+    stress_t *s = w->s;
+    stress_wait_go(s);
+
+    for (uint32_t i = 0; i < s->per_producer; ++i)
+    {
+        uint64_t v = ((uint64_t)w->index << 32) | (uint64_t)i;
+        while (!asset_ring_push(&s->ring, &v))
+            threads_yield();
+    }
+}
+
+static void stress_consumer(void *arg)
+{
+    stress_worker_t *w = (stress_worker_t *)arg;
+    stress_t *s = w->s;
+    stress_wait_go(s);
+
+    while (atomic_load_u32(&s->popped) < s->total)
+    {
+        uint64_t v;
+        if (!asset_ring_pop(&s->ring, &v))
+        {
+            threads_yield();
+            continue;
+        }
+        w->sum += v;
+        w->count++;
+        atomic_add_u32(&s->popped, 1u);
+    }
+}
+
+// workers producers and workers consumers share one small ring, so both the full and the empty
+// paths are hit constantly. Every value must come out exactly once.
+static bool stress_run(uint32_t workers)
+{
+    stress_t s = {0};
+    asset_ring_init(&s.ring, RING_CAPACITY, sizeof(uint64_t));
+    s.per_producer = ITEMS_TOTAL / workers;
+    s.total = s.per_producer * workers;
+
+    stress_worker_t producers[MAX_WORKERS] = {0};
+    stress_worker_t consumers[MAX_WORKERS] = {0};
+    thread_t threads[MAX_WORKERS * 2u];
+    uint32_t started = 0;
+
+    for (uint32_t i = 0; i < workers; ++i)
+    {
+        producers[i] = (stress_worker_t){.s = &s, .index = i};
+        consumers[i] = (stress_worker_t){.s = &s, .index = i};
+        if (threads_thread_create(&threads[started], stress_producer, &producers[i]))
+            ++started;
+        if (threads_thread_create(&threads[started], stress_consumer, &consumers[i]))
+            ++started;
+    }
+
+    if (started != workers * 2u)
+    {
+        fprintf(stderr, "workers=%u: only %u of %u threads started\n", workers, started, workers * 2u);
+        atomic_store_u32(&s.go, 1u);
+        for (uint32_t i = 0; i < started; ++i)
+            threads_thread_join(&threads[i]);
+        asset_ring_destroy(&s.ring);
+        return false;
+    }
+
+    double t0 = bench_now();
+    atomic_store_u32(&s.go, 1u);
+    for (uint32_t i = 0; i < started; ++i)
+        threads_thread_join(&threads[i]);
+    double t1 = bench_now();
+
+    uint64_t sum = 0;
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < workers; ++i)
+    {
+        sum += consumers[i].sum;
+        count += consumers[i].count;
+    }
+
+    const uint64_t n = s.per_producer;
+    const uint64_t expect = (uint64_t)workers * (n * (n - 1u) / 2u) +
+                            n * ((uint64_t)workers * (workers - 1u) / 2u << 32);
+    const bool ok = count == s.total && sum == expect && asset_ring_count(&s.ring) == 0;
+
+    printf("workers=%2u  %8.2f Mops/s  %s\n", workers, (double)s.total / (t1 - t0) * 1e-6, ok ? "ok" : "MISMATCH");
+    asset_ring_destroy(&s.ring);
+    return ok;
+}
+
+#define MAX_PRODUCERS 8u
+#define REQUESTS_TOTAL (1u << 14)
+// asset_manager_request only queues paths that exist, so each request gets an empty file here.
+#define REQUEST_DIR "mpmc_stress_files"
+
+// End to end: producer threads call asset_manager_request, loader jobs run the dummy module's
+// load_fn, and the pumping thread pops the done queue and publishes. Latency is measured from the
+// request call to the pump that publishes it.
+typedef struct request_bench_t
+{
+    asset_manager_t am;
+    uint32_t total;
+    uint32_t per_producer;
+    uint32_t window; // requests in flight at most, kept below max_inflight_jobs
+    double *requested_at;
+    double *latency;
+    volatile uint32_t issued;
+    volatile uint32_t completed;
+    volatile uint32_t failed;
+    volatile uint32_t go;
+} request_bench_t;
+
+typedef struct request_producer_t
+{
+    request_bench_t *b;
+    uint32_t first;
+} request_producer_t;
+
+static request_bench_t *g_bench;
+
+static bool dummy_can_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr)
+{
+    (void)am;
+    return !path_is_ptr && strncmp(path, REQUEST_DIR "/", sizeof(REQUEST_DIR)) == 0;
+}
+
+static bool dummy_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr, asset_any_t *out, ihandle_t *out_handle)
+{
+    (void)am;
+    (void)path_is_ptr;
+    (void)out_handle;
+    const uint32_t id = (uint32_t)strtoul(path + sizeof(REQUEST_DIR), NULL, 10);
+    out->type = ASSET_MODEL;
+    out->state = ASSET_STATE_LOADING;
+    out->as.model_raw.storage = (void *)(uintptr_t)(id + 1u);
+    return true;
+}
+
+// Runs on the pumping thread right after the done-queue pop.
+static bool dummy_init(asset_manager_t *am, asset_any_t *asset)
+{
+    (void)am;
+    request_bench_t *b = g_bench;
+    const uint32_t id = (uint32_t)(uintptr_t)asset->as.model_raw.storage - 1u;
+    memset(&asset->as, 0, sizeof(asset->as));
+    if (id < b->total)
+        b->latency[id] = bench_now() - b->requested_at[id];
+    atomic_add_u32(&b->completed, 1u);
+    return true;
+}
+
+static void dummy_cleanup(asset_manager_t *am, asset_any_t *asset)
+{
+    (void)am;
+    (void)asset;
+}
+
+static void request_producer(void *arg)
+{
+    request_producer_t *p = (request_producer_t *)arg;
+    request_bench_t *b = p->b;
+    while (!atomic_load_u32(&b->go))
+        threads_yield();
+
+    char path[64];
+    for (uint32_t i = 0; i < b->per_producer; ++i)
+    {
+        while (atomic_load_u32(&b->issued) - atomic_load_u32(&b->completed) - atomic_load_u32(&b->failed) >= b->window)
+            threads_yield();
+
+        const uint32_t id = p->first + i;
+        snprintf(path, sizeof(path), REQUEST_DIR "/%u", id);
+        atomic_add_u32(&b->issued, 1u);
+        b->requested_at[id] = bench_now();
+        if (!ihandle_is_valid(asset_manager_request(&b->am, ASSET_MODEL, path)))
+            atomic_add_u32(&b->failed, 1u);
+    }
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, uint32_t n, double q)
+{
+    if (!n)
+        return 0.0;
+    uint32_t i = (uint32_t)(q * (double)(n - 1u) + 0.5);
+    return sorted[i < n ? i : n - 1u];
+}
+
+static bool request_run(uint32_t producers)
+{
+    request_bench_t *b = (request_bench_t *)calloc(1, sizeof(request_bench_t));
+    if (!b)
+        return false;
+    g_bench = b;
+    b->per_producer = REQUESTS_TOTAL / producers;
+    b->total = b->per_producer * producers;
+    b->requested_at = (double *)calloc(b->total, sizeof(double));
+    b->latency = (double *)calloc(b->total, sizeof(double));
+
+    asset_manager_desc_t desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.worker_count = jobs_background_limit();
+    desc.max_inflight_jobs = 1024u;
+    desc.handle_type = iHANDLE_TYPE_ASSET;
+    desc.pump_per_frame = 1u << 20;
+    b->window = desc.max_inflight_jobs / 2u;
+
+    asset_module_desc_t module;
+    memset(&module, 0, sizeof(module));
+    module.type = ASSET_MODEL;
+    module.name = "bench";
+    module.load_fn = dummy_load;
+    module.init_fn = dummy_init;
+    module.cleanup_fn = dummy_cleanup;
+    module.can_load_fn = dummy_can_load;
+
+    if (!b->requested_at || !b->latency || !asset_manager_init(&b->am, &desc) || !asset_manager_register_module(&b->am, module))
+    {
+        fprintf(stderr, "producers=%u: setup failed\n", producers);
+        free(b->latency);
+        free(b->requested_at);
+        free(b);
+        return false;
+    }
+
+    request_producer_t ps[MAX_PRODUCERS];
+    thread_t threads[MAX_PRODUCERS];
+    uint32_t started = 0;
+    for (uint32_t i = 0; i < producers; ++i)
+    {
+        ps[i] = (request_producer_t){.b = b, .first = i * b->per_producer};
+        if (threads_thread_create(&threads[started], request_producer, &ps[i]))
+            ++started;
+    }
+
+    const double t0 = bench_now();
+    atomic_store_u32(&b->go, 1u);
+    // The pumping thread plays the render thread: it drains the done queue as fast as it can.
+    const uint32_t expected = started * b->per_producer;
+    while (atomic_load_u32(&b->completed) + atomic_load_u32(&b->failed) < expected)
+        asset_manager_pump(&b->am, 1u << 20);
+    const double t1 = bench_now();
+
+    for (uint32_t i = 0; i < started; ++i)
+        threads_thread_join(&threads[i]);
+
+    const uint32_t completed = atomic_load_u32(&b->completed);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < b->total; ++i)
+        if (b->latency[i] > 0.0)
+            b->latency[n++] = b->latency[i];
+    qsort(b->latency, n, sizeof(double), compare_double);
+
+    const bool ok = started == producers && completed == expected && !b->failed;
+    printf("producers=%u  %8.0f req/s  latency us: p50 %7.1f  p90 %7.1f  p99 %7.1f  p99.9 %8.1f  max %8.1f  %s\n",
+           producers, (double)completed / (t1 - t0),
+           percentile(b->latency, n, 0.50) * 1e6, percentile(b->latency, n, 0.90) * 1e6,
+           percentile(b->latency, n, 0.99) * 1e6, percentile(b->latency, n, 0.999) * 1e6,
+           n ? b->latency[n - 1u] * 1e6 : 0.0, ok ? "ok" : "MISMATCH");
+
+    asset_manager_shutdown(&b->am);
+    free(b->latency);
+    free(b->requested_at);
+    free(b);
+    g_bench = NULL;
+    return ok;
+}
+
+static bool request_files(bool create)
+{
+    if (create)
+    {
+#if defined(_WIN32)
+        _mkdir(REQUEST_DIR);
+#else
+        mkdir(REQUEST_DIR, 0755);
+#endif
+    }
+
+    char path[64];
+    for (uint32_t i = 0; i < REQUESTS_TOTAL; ++i)
+    {
+        snprintf(path, sizeof(path), REQUEST_DIR "/%u", i);
+        if (!create)
+        {
+            remove(path);
+            continue;
+        }
+        FILE *f = fopen(path, "wb");
+        if (!f)
+        {
+            fprintf(stderr, "cannot create %s\n", path);
+            return false;
+        }
+        fclose(f);
+    }
+
+    if (!create)
+    {
+#if defined(_WIN32)
+        _rmdir(REQUEST_DIR);
+#else
+        rmdir(REQUEST_DIR);
+#endif
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    bool ok = true;
+    printf("raw ring, %u items\n", ITEMS_TOTAL);
+    for (uint32_t w = 1; w <= MAX_WORKERS; w <<= 1u)
+        ok &= stress_run(w);
+
+    const uint32_t pool = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 3u;
+    if (!jobs_init(pool))
+        return 1;
+    printf("asset_manager_request -> loader -> pump, %u requests, %u pool thread(s), %u loader(s)\n",
+           REQUESTS_TOTAL, pool + 1u, jobs_background_limit());
+    if (request_files(true))
+    {
+        for (uint32_t p = 1; p <= MAX_PRODUCERS; p <<= 1u)
+            ok &= request_run(p);
+    }
+    else
+    {
+        ok = false;
+    }
+    request_files(false);
+    jobs_shutdown();
+    return ok ? 0 : 1;
+}
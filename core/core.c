@@ -19,11 +19,13 @@ ApplicationSpecification create_specification()
     spec.asset_manager_desc.streaming_enabled = 1u;
     spec.asset_manager_desc.upload_budget_bytes_per_pump = 32ull * 1024ull * 1024ull;
     spec.asset_manager_desc.pump_per_frame = 8u;
+    spec.asset_manager_desc.upload_time_budget_us = 2000u;
 
     spec.asset_manager_desc.tex_stream_stable_frames = 3u;
     spec.asset_manager_desc.tex_stream_min_safety_mips_from_bottom = 0u;
     spec.asset_manager_desc.tex_stream_evict_unused_ms = 2000u;
     spec.asset_manager_desc.tex_stream_upload_budget_bytes_per_frame = 8ull * 1024ull * 1024ull;
+    spec.asset_manager_desc.tex_stream_ram_budget_bytes = 256ull * 1024ull * 1024ull;
 
     return spec;
 }
@@ -112,8 +114,16 @@ void init_application(Application *app)
 
     LOG_INFO("Logical Processors: %d", cvar_get_int_name("cl_cpu_threads"));
 
+    LOG_INFO("Initializing job system");
+    {
+        // The main thread is job worker 0, so the pool gets one thread less than CL_CPU_THREADS.
+        int32_t job_threads = cvar_get_int_name("cl_cpu_threads");
+        jobs_init((job_threads > 1) ? (uint32_t)(job_threads - 1) : 0u);
+    }
+
     asset_manager_desc_t desc = g_application.specification->asset_manager_desc;
-    desc.worker_count = (cpu_threads > 0) ? (uint32_t)cpu_threads : 1u;
+    // Loads are background jobs; the pool keeps a worker free of them for frame work.
+    desc.worker_count = jobs_background_limit();
     desc.handle_type = iHANDLE_TYPE_ASSET;
 
     LOG_INFO("Initializing asset manager");
@@ -126,6 +136,7 @@ void init_application(Application *app)
     c_transform_register(&g_application.scene);
     c_mesh_renderer_register(&g_application.scene);
     c_light_register(&g_application.scene);
+    c_world_transform_register(&g_application.scene);
 
     ecs_world_set_required_tag(&g_application.scene, ecs_component_id(&g_application.scene, c_tag_t));
 
@@ -188,6 +199,8 @@ void delete_application(Application *app)
 
     asset_manager_shutdown(&g_application.asset_manager);
 
+    jobs_shutdown();
+
     R_shutdown(&g_application.renderer);
 
     wm_shutdown(&g_application.window_manager);
@@ -23,6 +23,7 @@
 #include "systems/ecs/components/c_transform.h"
 #include "systems/ecs/components/c_mesh_renderer.h"
 #include "systems/ecs/components/c_light.h"
+#include "systems/ecs/components/c_world_transform.h"
 
 #include "systems/scene_renderer/scene_renderer.h"
 
@@ -34,6 +35,7 @@
 #include "utils/hsv_to_rgb.h"
 #include "utils/macros.h"
 #include "utils/threads.h"
+#include "utils/jobs.h"
 
 #define ENGINE_V "25.0.2b"
 #define ENGINE_N "Earthquake"
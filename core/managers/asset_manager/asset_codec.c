@@ -0,0 +1,263 @@
+#include "asset_codec.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lz4.h"
+#include "lz4hc.h"
+#include "zstd.h"
+
+#include "utils/jobs.h"
+#include "utils/threads.h"
+
+#define CODEC_FRAME_MAGIC 0x31464341u // "ACF1"
+#define CODEC_CHUNK_SIZE (256u * 1024u)
+
+typedef struct codec_frame_hdr_t
+{
+    uint32_t magic;
+    uint32_t chunk_size;
+    uint32_t chunk_count;
+    uint32_t raw_size;
+    // uint32_t chunk_end[chunk_count]: compressed end offset of each chunk, relative to the payload.
+} codec_frame_hdr_t;
+
+static size_t lz4_bound(size_t n)
+{
+    return (size_t)LZ4_compressBound((int)n);
+}
+
+static size_t lz4_compress(const void *src, size_t n, void *dst, size_t cap, int level)
+{
+    int r = LZ4_compress_HC((const char *)src, (char *)dst, (int)n, (int)cap, level);
+    return r > 0 ? (size_t)r : 0;
+}
+
+static bool lz4_decompress(const void *src, size_t n, void *dst, size_t dst_size)
+{
+    int r = LZ4_decompress_safe((const char *)src, (char *)dst, (int)n, (int)dst_size);
+    return r >= 0 && (size_t)r == dst_size;
+}
+
+static size_t zstd_bound(size_t n)
+{
+    return ZSTD_compressBound(n);
+}
+
+static size_t zstd_compress(const void *src, size_t n, void *dst, size_t cap, int level)
+{
+    size_t r = ZSTD_compress(dst, cap, src, n, level);
+    return ZSTD_isError(r) ? 0 : r;
+}
+
+static bool zstd_decompress(const void *src, size_t n, void *dst, size_t dst_size)
+{
+    size_t r = ZSTD_decompress(dst, dst_size, src, n);
+    return !ZSTD_isError(r) && r == dst_size;
+}
+
+static const asset_codec_desc_t g_codecs[ASSET_CODEC_COUNT] = {
+    [ASSET_CODEC_NONE] = {"none", 0, NULL, NULL, NULL},
+    [ASSET_CODEC_LZ4] = {"lz4hc", 9, lz4_bound, lz4_compress, lz4_decompress},
+    [ASSET_CODEC_ZSTD] = {"zstd", 9, zstd_bound, zstd_compress, zstd_decompress},
+};
+
+const asset_codec_desc_t *asset_codec_get(uint8_t codec)
+{
+    if (codec == ASSET_CODEC_NONE || codec >= ASSET_CODEC_COUNT)
+        return NULL;
+    return &g_codecs[codec];
+}
+
+const char *asset_codec_name(uint8_t codec)
+{
+    if (codec >= ASSET_CODEC_COUNT)
+        return "unknown";
+    return g_codecs[codec].name;
+}
+
+typedef struct codec_encode_ctx_t
+{
+    const asset_codec_desc_t *c;
+    const uint8_t *src;
+    uint32_t src_size;
+    uint8_t *scratch;
+    size_t slot_cap;
+    uint32_t *sizes;
+    volatile uint32_t failed;
+} codec_encode_ctx_t;
+
+static void codec_encode_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    (void)worker_index;
+    codec_encode_ctx_t *ctx = (codec_encode_ctx_t *)user;
+
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        uint32_t off = i * CODEC_CHUNK_SIZE;
+        uint32_t n = ctx->src_size - off;
+        if (n > CODEC_CHUNK_SIZE)
+            n = CODEC_CHUNK_SIZE;
+
+        size_t r = ctx->c->compress_fn(ctx->src + off, n, ctx->scratch + (size_t)i * ctx->slot_cap, ctx->slot_cap, ctx->c->level);
+        if (!r || r > 0xFFFFFFFFu)
+        {
+            atomic_store_u32(&ctx->failed, 1u);
+            r = 0;
+        }
+        ctx->sizes[i] = (uint32_t)r;
+    }
+}
+
+bool asset_codec_encode(uint8_t codec, const void *src, uint32_t src_size, uint8_t **out_data, uint32_t *out_size)
+{
+    if (!out_data || !out_size)
+        return false;
+    *out_data = NULL;
+    *out_size = 0;
+
+    const asset_codec_desc_t *c = asset_codec_get(codec);
+    if (!c || !src || !src_size)
+        return false;
+
+    uint32_t chunk_count = (src_size + CODEC_CHUNK_SIZE - 1u) / CODEC_CHUNK_SIZE;
+
+    codec_encode_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.c = c;
+    ctx.src = (const uint8_t *)src;
+    ctx.src_size = src_size;
+    ctx.slot_cap = c->bound_fn(src_size < CODEC_CHUNK_SIZE ? src_size : CODEC_CHUNK_SIZE);
+    ctx.scratch = (uint8_t *)malloc(ctx.slot_cap * chunk_count);
+    ctx.sizes = (uint32_t *)malloc(sizeof(uint32_t) * chunk_count);
+
+    bool ok = ctx.scratch && ctx.sizes && ctx.slot_cap;
+    if (ok)
+    {
+        jobs_parallel_for(chunk_count, 1u, codec_encode_range, &ctx);
+        ok = !atomic_load_u32(&ctx.failed);
+    }
+
+    uint64_t total = (uint64_t)sizeof(codec_frame_hdr_t) + (uint64_t)chunk_count * sizeof(uint32_t);
+    for (uint32_t i = 0; ok && i < chunk_count; ++i)
+        total += ctx.sizes[i];
+    if (total > 0xFFFFFFFFull)
+        ok = false;
+
+    uint8_t *out = ok ? (uint8_t *)malloc((size_t)total) : NULL;
+    if (out)
+    {
+        codec_frame_hdr_t h;
+        h.magic = CODEC_FRAME_MAGIC;
+        h.chunk_size = CODEC_CHUNK_SIZE;
+        h.chunk_count = chunk_count;
+        h.raw_size = src_size;
+        memcpy(out, &h, sizeof(h));
+
+        uint32_t *ends = (uint32_t *)(out + sizeof(h));
+        uint8_t *payload = (uint8_t *)(ends + chunk_count);
+        uint32_t cursor = 0;
+        for (uint32_t i = 0; i < chunk_count; ++i)
+        {
+            memcpy(payload + cursor, ctx.scratch + (size_t)i * ctx.slot_cap, ctx.sizes[i]);
+            cursor += ctx.sizes[i];
+            ends[i] = cursor;
+        }
+
+        *out_data = out;
+        *out_size = (uint32_t)total;
+    }
+
+    free(ctx.scratch);
+    free(ctx.sizes);
+    return out != NULL;
+}
+
+typedef struct codec_decode_ctx_t
+{
+    const asset_codec_desc_t *c;
+    const uint32_t *ends;
+    const uint8_t *payload;
+    uint8_t *dst;
+    uint32_t dst_size;
+    uint32_t chunk_size;
+    volatile uint32_t failed;
+} codec_decode_ctx_t;
+
+static void codec_decode_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    (void)worker_index;
+    codec_decode_ctx_t *ctx = (codec_decode_ctx_t *)user;
+
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        uint32_t cb = i ? ctx->ends[i - 1u] : 0u;
+        uint32_t off = i * ctx->chunk_size;
+        uint32_t n = ctx->dst_size - off;
+        if (n > ctx->chunk_size)
+            n = ctx->chunk_size;
+
+        if (!ctx->c->decompress_fn(ctx->payload + cb, ctx->ends[i] - cb, ctx->dst + off, n))
+            atomic_store_u32(&ctx->failed, 1u);
+    }
+}
+
+bool asset_codec_decode(uint8_t codec, const void *src, uint32_t src_size, void *dst, uint32_t dst_size)
+{
+    const asset_codec_desc_t *c = asset_codec_get(codec);
+    if (!c || !src || !dst || !dst_size || src_size < sizeof(codec_frame_hdr_t))
+        return false;
+
+    codec_frame_hdr_t h;
+    memcpy(&h, src, sizeof(h));
+
+    if (h.magic != CODEC_FRAME_MAGIC || h.raw_size != dst_size || !h.chunk_size)
+        return false;
+    if (h.chunk_count != (uint32_t)(((uint64_t)dst_size + h.chunk_size - 1u) / h.chunk_size))
+        return false;
+
+    uint64_t table_end = (uint64_t)sizeof(h) + (uint64_t)h.chunk_count * sizeof(uint32_t);
+    if (table_end > src_size)
+        return false;
+
+    const uint8_t *base = (const uint8_t *)src;
+    uint32_t ends_local[64];
+    uint32_t *ends_heap = NULL;
+    uint32_t *ends = ends_local;
+    if (h.chunk_count > 64u)
+    {
+        ends_heap = (uint32_t *)malloc(sizeof(uint32_t) * h.chunk_count);
+        if (!ends_heap)
+            return false;
+        ends = ends_heap;
+    }
+    // The table may be unaligned inside a pack blob.
+    memcpy(ends, base + sizeof(h), sizeof(uint32_t) * h.chunk_count);
+
+    uint32_t payload_size = src_size - (uint32_t)table_end;
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < h.chunk_count; ++i)
+    {
+        uint32_t prev = i ? ends[i - 1u] : 0u;
+        if (ends[i] < prev || ends[i] > payload_size)
+            ok = false;
+    }
+
+    if (ok)
+    {
+        codec_decode_ctx_t ctx;
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.c = c;
+        ctx.ends = ends;
+        ctx.payload = base + table_end;
+        ctx.dst = (uint8_t *)dst;
+        ctx.dst_size = dst_size;
+        ctx.chunk_size = h.chunk_size;
+
+        jobs_parallel_for(h.chunk_count, 1u, codec_decode_range, &ctx);
+        ok = !atomic_load_u32(&ctx.failed);
+    }
+
+    free(ends_heap);
+    return ok;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Compression codecs for pack blobs and itex payloads. Ids are stored on disk; never renumber.
+typedef enum asset_codec_t
+{
+    ASSET_CODEC_NONE = 0,
+    ASSET_CODEC_LZ4 = 1,  // LZ4-HC at build time, very fast decode
+    ASSET_CODEC_ZSTD = 2, // higher ratio, still several times faster to decode than deflate
+    ASSET_CODEC_COUNT
+} asset_codec_t;
+
+typedef struct asset_codec_desc_t
+{
+    const char *name;
+    int level;
+    size_t (*bound_fn)(size_t src_size);
+    // Returns the compressed size, or 0 on failure.
+    size_t (*compress_fn)(const void *src, size_t src_size, void *dst, size_t dst_cap, int level);
+    // Must produce exactly dst_size bytes.
+    bool (*decompress_fn)(const void *src, size_t src_size, void *dst, size_t dst_size);
+} asset_codec_desc_t;
+
+// NULL for ASSET_CODEC_NONE and unknown ids.
+const asset_codec_desc_t *asset_codec_get(uint8_t codec);
+const char *asset_codec_name(uint8_t codec);
+
+// Encoded data is a small frame header followed by independently compressed chunks, so both
+// directions split across the job pool. *out_data is malloc'd; free with free().
+bool asset_codec_encode(uint8_t codec, const void *src, uint32_t src_size, uint8_t **out_data, uint32_t *out_size);
+// Decodes straight into dst, which must be exactly the uncompressed size.
+bool asset_codec_decode(uint8_t codec, const void *src, uint32_t src_size, void *dst, uint32_t dst_size);
@@ -0,0 +1,748 @@
+#include "asset_io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/logger.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ASSET_IO_HAVE_URING 1
+#endif
+#endif
+
+#if defined(ASSET_IO_HAVE_URING)
+#include <errno.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+struct asset_io_req_t
+{
+    asset_io_req_t *next;
+    asset_io_done_fn fn;
+    void *user;
+    uint8_t *data;
+    uint32_t size;
+    uint32_t done;
+    int fd;
+    char path[];
+};
+
+static void io_push_locked(asset_io_t *io, asset_io_req_t *r)
+{
+    r->next = NULL;
+    if (io->tail)
+        io->tail->next = r;
+    else
+        io->head = r;
+    io->tail = r;
+}
+
+static asset_io_req_t *io_pop_locked(asset_io_t *io)
+{
+    asset_io_req_t *r = io->head;
+    if (!r)
+        return NULL;
+    io->head = r->next;
+    if (!io->head)
+        io->tail = NULL;
+    r->next = NULL;
+    return r;
+}
+
+#if defined(ASSET_IO_HAVE_URING)
+static void io_uring_issue(asset_io_t *io);
+#endif
+
+static void io_release_slot(asset_io_t *io)
+{
+    threads_mutex_lock(&io->m);
+    io->outstanding--;
+    threads_cond_signal(&io->cv);
+    threads_mutex_unlock(&io->m);
+
+#if defined(ASSET_IO_HAVE_URING)
+    if (atomic_load_u32(&io->backend) == ASSET_IO_BACKEND_URING)
+        io_uring_issue(io);
+#endif
+}
+
+// counted: the request held a queue-depth slot, which is given back when the read failed.
+static void io_complete(asset_io_t *io, asset_io_req_t *r, bool ok, bool counted)
+{
+    if (!ok)
+    {
+        free(r->data);
+        r->data = NULL;
+        r->size = 0;
+        if (counted)
+            io_release_slot(io);
+    }
+
+    r->fn(r->user, r->data, r->size);
+    free(r);
+
+    if (atomic_sub_u32(&io->inflight, 1u) == 0u)
+        threads_futex_wake(&io->inflight, true);
+}
+
+static bool io_read_stdio(asset_io_req_t *r)
+{
+    FILE *f = fopen(r->path, "rb");
+    if (!f)
+        return false;
+
+    bool ok = fseek(f, 0, SEEK_END) == 0;
+    long end = ok ? ftell(f) : 0;
+    ok = ok && end > 0 && fseek(f, 0, SEEK_SET) == 0;
+
+    if (ok)
+    {
+        r->size = (uint32_t)end;
+        r->data = (uint8_t *)malloc((size_t)r->size);
+        ok = r->data && fread(r->data, 1, (size_t)r->size, f) == (size_t)r->size;
+    }
+
+    fclose(f);
+    return ok;
+}
+
+static void io_reader_main(void *arg)
+{
+    asset_io_t *io = (asset_io_t *)arg;
+
+    threads_mutex_lock(&io->m);
+    for (;;)
+    {
+        while (!atomic_load_u32(&io->stopping) && (!io->head || io->outstanding >= io->queue_depth))
+            threads_cond_wait(&io->cv, &io->m);
+        if (atomic_load_u32(&io->stopping))
+            break;
+
+        asset_io_req_t *r = io_pop_locked(io);
+        io->outstanding++;
+        threads_mutex_unlock(&io->m);
+
+        io_complete(io, r, io_read_stdio(r), true);
+
+        threads_mutex_lock(&io->m);
+    }
+    threads_mutex_unlock(&io->m);
+}
+
+static uint32_t io_start_readers(asset_io_t *io)
+{
+    const uint32_t want = io->queue_depth < ASSET_IO_MAX_THREADS ? io->queue_depth : ASSET_IO_MAX_THREADS;
+    uint32_t n = 0;
+    while (n < want && threads_thread_create(&io->threads[n], io_reader_main, io))
+        n++;
+    return n;
+}
+
+#if defined(ASSET_IO_HAVE_URING)
+// Raw io_uring: one submission ring shared by all submitters under io->m, and a reaper thread
+// that waits on the completion ring. Reads larger than one syscall allows are resubmitted.
+typedef struct io_uring_ctx_t
+{
+    int fd;
+    uint8_t *sq_ring;
+    size_t sq_ring_size;
+    uint8_t *cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+
+    uint32_t *sq_tail;
+    uint32_t *sq_array;
+    uint32_t sq_mask;
+    uint32_t *cq_head;
+    uint32_t *cq_tail;
+    uint32_t cq_mask;
+    struct io_uring_cqe *cqes;
+
+    thread_t reaper;
+    volatile uint32_t stop; // set by asset_io_shutdown; wakes a reaper that is backing off
+} io_uring_ctx_t;
+
+// io_uring_enter failures in a row before new reads go to reader threads, and the longest the
+// reaper sleeps between polls of the completion ring meanwhile.
+#define IO_URING_FAILOVER_ERRORS 8u
+#define IO_URING_BACKOFF_MAX_MS 100u
+
+static int io_uring_sys_setup(uint32_t entries, struct io_uring_params *p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int io_uring_sys_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static void io_uring_close(io_uring_ctx_t *u)
+{
+    if (u->sqes)
+        munmap(u->sqes, u->sqes_size);
+    if (u->cq_ring && u->cq_ring != u->sq_ring)
+        munmap(u->cq_ring, u->cq_ring_size);
+    if (u->sq_ring)
+        munmap(u->sq_ring, u->sq_ring_size);
+    if (u->fd >= 0)
+        close(u->fd);
+    free(u);
+}
+
+static io_uring_ctx_t *io_uring_open(uint32_t entries)
+{
+    io_uring_ctx_t *u = (io_uring_ctx_t *)calloc(1, sizeof(io_uring_ctx_t));
+    if (!u)
+        return NULL;
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    u->fd = io_uring_sys_setup(entries, &p);
+    if (u->fd < 0)
+    {
+        free(u);
+        return NULL;
+    }
+
+    u->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+    u->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (u->cq_ring_size > u->sq_ring_size)
+            u->sq_ring_size = u->cq_ring_size;
+        u->cq_ring_size = u->sq_ring_size;
+    }
+
+    void *sq = mmap(NULL, u->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED)
+    {
+        io_uring_close(u);
+        return NULL;
+    }
+    u->sq_ring = (uint8_t *)sq;
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        u->cq_ring = u->sq_ring;
+    }
+    else
+    {
+        void *cq = mmap(NULL, u->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED)
+        {
+            io_uring_close(u);
+            return NULL;
+        }
+        u->cq_ring = (uint8_t *)cq;
+    }
+
+    u->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(NULL, u->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        io_uring_close(u);
+        return NULL;
+    }
+    u->sqes = (struct io_uring_sqe *)sqes;
+
+    u->sq_tail = (uint32_t *)(u->sq_ring + p.sq_off.tail);
+    u->sq_array = (uint32_t *)(u->sq_ring + p.sq_off.array);
+    u->sq_mask = *(uint32_t *)(u->sq_ring + p.sq_off.ring_mask);
+    u->cq_head = (uint32_t *)(u->cq_ring + p.cq_off.head);
+    u->cq_tail = (uint32_t *)(u->cq_ring + p.cq_off.tail);
+    u->cq_mask = *(uint32_t *)(u->cq_ring + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe *)(u->cq_ring + p.cq_off.cqes);
+    return u;
+}
+
+// Caller holds io->m. r == NULL submits a NOP that tells the reaper to exit. The ring never
+// fills: it has more entries than queue_depth and every enter consumes what was queued.
+static bool io_uring_submit_locked(io_uring_ctx_t *u, asset_io_req_t *r)
+{
+    uint32_t tail = *u->sq_tail;
+    uint32_t idx = tail & u->sq_mask;
+
+    struct io_uring_sqe *sqe = &u->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    if (r)
+    {
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = r->fd;
+        sqe->addr = (uint64_t)(uintptr_t)(r->data + r->done);
+        sqe->len = r->size - r->done;
+        sqe->off = r->done;
+        sqe->user_data = (uint64_t)(uintptr_t)r;
+    }
+    else
+    {
+        sqe->opcode = IORING_OP_NOP;
+    }
+
+    u->sq_array[idx] = idx;
+    __atomic_store_n(u->sq_tail, tail + 1u, __ATOMIC_RELEASE);
+
+    int rc;
+    do
+        rc = io_uring_sys_enter(u->fd, 1u, 0u, 0u);
+    while (rc < 0 && errno == EINTR);
+
+    if (rc == 1)
+        return true;
+
+    // Not consumed; take the entry back so the next enter does not submit it.
+    __atomic_store_n(u->sq_tail, tail, __ATOMIC_RELEASE);
+    return false;
+}
+
+static bool io_open_fd(asset_io_req_t *r)
+{
+    r->fd = open(r->path, O_RDONLY | O_CLOEXEC);
+    if (r->fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(r->fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= 0xFFFFFFFFull)
+    {
+        r->size = (uint32_t)st.st_size;
+        r->data = (uint8_t *)malloc((size_t)r->size);
+        if (r->data)
+            return true;
+    }
+
+    close(r->fd);
+    r->fd = -1;
+    return false;
+}
+
+static bool io_pread_rest(asset_io_req_t *r)
+{
+    while (r->done < r->size)
+    {
+        ssize_t n = pread(r->fd, r->data + r->done, (size_t)(r->size - r->done), (off_t)r->done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        r->done += (uint32_t)n;
+    }
+    return true;
+}
+
+// Takes a queue-depth slot under io->m, then opens, sizes and allocates with the lock dropped so
+// other submitters (often the main thread) only ever wait for the ring write.
+static void io_uring_issue(asset_io_t *io)
+{
+    io_uring_ctx_t *u = (io_uring_ctx_t *)io->uring;
+
+    for (;;)
+    {
+        threads_mutex_lock(&io->m);
+        if (!io->head || io->outstanding >= io->queue_depth || io->backend != ASSET_IO_BACKEND_URING)
+        {
+            threads_mutex_unlock(&io->m);
+            return;
+        }
+        asset_io_req_t *r = io_pop_locked(io);
+        io->outstanding++;
+        threads_mutex_unlock(&io->m);
+
+        if (!io_open_fd(r))
+        {
+            threads_mutex_lock(&io->m);
+            io->outstanding--;
+            threads_mutex_unlock(&io->m);
+            io_complete(io, r, false, false);
+            continue;
+        }
+
+        threads_mutex_lock(&io->m);
+        bool submitted = io_uring_submit_locked(u, r);
+        threads_mutex_unlock(&io->m);
+
+        if (!submitted)
+        {
+            bool ok = io_pread_rest(r);
+            close(r->fd);
+            io_complete(io, r, ok, true);
+        }
+    }
+}
+
+static void io_uring_on_cqe(asset_io_t *io, asset_io_req_t *r, int res)
+{
+    io_uring_ctx_t *u = (io_uring_ctx_t *)io->uring;
+
+    // The submitter filled r before submitting under io->m. The ring already orders that, but
+    // thread sanitizers cannot see through the kernel, so pass through the lock once.
+    threads_mutex_lock(&io->m);
+    threads_mutex_unlock(&io->m);
+
+    if (res > 0)
+        r->done += (uint32_t)res;
+
+    bool retry = (res > 0 && r->done < r->size) || res == -EINTR || res == -EAGAIN;
+    if (retry)
+    {
+        threads_mutex_lock(&io->m);
+        bool submitted = io_uring_submit_locked(u, r);
+        threads_mutex_unlock(&io->m);
+        if (submitted)
+            return;
+    }
+
+    // Kernels without IORING_OP_READ report -EINVAL; finish those (and failed resubmits) inline.
+    bool ok = r->done == r->size;
+    if (!ok && (retry || res == -EINVAL || res == -EOPNOTSUPP))
+        ok = io_pread_rest(r);
+
+    close(r->fd);
+    io_complete(io, r, ok, true);
+}
+
+// Reads queued from now on go to reader threads. Reads already in the ring still complete
+// through the reaper; io_uring_issue stops submitting once backend changes.
+static void io_uring_failover(asset_io_t *io, int err)
+{
+    threads_mutex_lock(&io->m);
+    if (!atomic_load_u32(&io->stopping) && !io->thread_count)
+    {
+        io->thread_count = io_start_readers(io);
+        if (io->thread_count)
+        {
+            atomic_store_u32(&io->backend, ASSET_IO_BACKEND_THREADS);
+            threads_cond_broadcast(&io->cv);
+        }
+    }
+    const bool switched = io->thread_count != 0;
+    threads_mutex_unlock(&io->m);
+
+    if (switched)
+        LOG_WARN("asset_io: io_uring_enter keeps failing (errno=%d), switching to reader threads", err);
+    else
+        LOG_ERROR("asset_io: io_uring_enter keeps failing (errno=%d) and no reader thread could start", err);
+}
+
+static void io_uring_reaper_main(void *arg)
+{
+    asset_io_t *io = (asset_io_t *)arg;
+    io_uring_ctx_t *u = (io_uring_ctx_t *)io->uring;
+    uint32_t errors = 0;
+
+    for (;;)
+    {
+        uint32_t head = *u->cq_head;
+        uint32_t tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail)
+        {
+            if (io_uring_sys_enter(u->fd, 0u, 1u, IORING_ENTER_GETEVENTS) >= 0 || errno == EINTR)
+            {
+                errors = 0;
+                continue;
+            }
+
+            // The kernel still posts completions for reads in flight, so keep polling the ring,
+            // but with a growing sleep instead of spinning on the failing syscall.
+            const int err = errno;
+            if (++errors == IO_URING_FAILOVER_ERRORS)
+                io_uring_failover(io, err);
+            if (atomic_load_u32(&u->stop))
+                return;
+            const uint32_t ms = errors < 7u ? 1u << errors : IO_URING_BACKOFF_MAX_MS;
+            threads_futex_wait(&u->stop, 0u, ms < IO_URING_BACKOFF_MAX_MS ? ms : IO_URING_BACKOFF_MAX_MS);
+            continue;
+        }
+        errors = 0;
+
+        bool quit = false;
+        for (; head != tail; ++head)
+        {
+            const struct io_uring_cqe *cqe = &u->cqes[head & u->cq_mask];
+            asset_io_req_t *r = (asset_io_req_t *)(uintptr_t)cqe->user_data;
+            int res = cqe->res;
+            __atomic_store_n(u->cq_head, head + 1u, __ATOMIC_RELEASE);
+
+            if (r)
+                io_uring_on_cqe(io, r, res);
+            else
+                quit = true;
+        }
+
+        if (quit)
+            return;
+    }
+}
+#endif
+
+bool asset_io_init(asset_io_t *io, uint32_t queue_depth, asset_io_backend_t backend)
+{
+    memset(io, 0, sizeof(*io));
+
+    if (queue_depth == 0)
+        queue_depth = 1;
+    if (queue_depth > 1024u)
+        queue_depth = 1024u;
+    io->queue_depth = queue_depth;
+
+    if (!threads_mutex_init(&io->m) || !threads_cond_init(&io->cv))
+        return false;
+
+#if defined(ASSET_IO_HAVE_URING)
+    if (backend != ASSET_IO_BACKEND_THREADS)
+    {
+        uint32_t entries = 2u;
+        while (entries < queue_depth + 1u)
+            entries <<= 1;
+
+        io_uring_ctx_t *u = io_uring_open(entries);
+        if (u)
+        {
+            io->uring = u;
+            io->backend = ASSET_IO_BACKEND_URING;
+            if (threads_thread_create(&u->reaper, io_uring_reaper_main, io))
+                return true;
+            io_uring_close(u);
+            io->uring = NULL;
+        }
+        else if (backend == ASSET_IO_BACKEND_URING)
+        {
+            LOG_WARN("asset_io: io_uring unavailable (errno=%d), using reader threads", errno);
+        }
+    }
+#else
+    (void)backend;
+#endif
+
+    io->backend = ASSET_IO_BACKEND_THREADS;
+    io->thread_count = io_start_readers(io);
+
+    if (!io->thread_count)
+    {
+        threads_cond_destroy(&io->cv);
+        threads_mutex_destroy(&io->m);
+        memset(io, 0, sizeof(*io));
+        return false;
+    }
+    return true;
+}
+
+void asset_io_shutdown(asset_io_t *io)
+{
+    if (!io || !io->backend)
+        return;
+
+    threads_mutex_lock(&io->m);
+    atomic_store_u32(&io->stopping, 1u);
+    asset_io_req_t *cancelled = io->head;
+    io->head = NULL;
+    io->tail = NULL;
+    threads_cond_broadcast(&io->cv);
+    threads_mutex_unlock(&io->m);
+
+    while (cancelled)
+    {
+        asset_io_req_t *r = cancelled;
+        cancelled = r->next;
+        io_complete(io, r, false, false);
+    }
+
+    for (;;)
+    {
+        uint32_t n = atomic_load_u32(&io->inflight);
+        if (!n)
+            break;
+        threads_futex_wait(&io->inflight, n, 0);
+    }
+
+    for (uint32_t i = 0; i < io->thread_count; ++i)
+        threads_thread_join(&io->threads[i]);
+
+#if defined(ASSET_IO_HAVE_URING)
+    if (io->uring)
+    {
+        // A reaper blocked in io_uring_enter wakes on the NOP, one backing off on stop.
+        io_uring_ctx_t *u = (io_uring_ctx_t *)io->uring;
+        atomic_store_u32(&u->stop, 1u);
+        threads_futex_wake(&u->stop, true);
+        threads_mutex_lock(&io->m);
+        if (!io_uring_submit_locked(u, NULL))
+            LOG_WARN("asset_io: could not submit the io_uring stop request");
+        threads_mutex_unlock(&io->m);
+        threads_thread_join(&u->reaper);
+        io_uring_close(u);
+    }
+#endif
+
+    threads_cond_destroy(&io->cv);
+    threads_mutex_destroy(&io->m);
+    memset(io, 0, sizeof(*io));
+}
+
+bool asset_io_read(asset_io_t *io, const char *path, asset_io_done_fn fn, void *user)
+{
+    if (!io || !io->backend || !path || !fn)
+        return false;
+
+    size_t n = strlen(path);
+    asset_io_req_t *r = (asset_io_req_t *)malloc(sizeof(asset_io_req_t) + n + 1u);
+    if (!r)
+        return false;
+
+    memset(r, 0, sizeof(*r));
+    r->fn = fn;
+    r->user = user;
+    r->fd = -1;
+    memcpy(r->path, path, n + 1u);
+
+    threads_mutex_lock(&io->m);
+    if (atomic_load_u32(&io->stopping))
+    {
+        threads_mutex_unlock(&io->m);
+        free(r);
+        return false;
+    }
+    atomic_add_u32(&io->inflight, 1u);
+    io_push_locked(io, r);
+    threads_cond_signal(&io->cv);
+    threads_mutex_unlock(&io->m);
+
+#if defined(ASSET_IO_HAVE_URING)
+    if (atomic_load_u32(&io->backend) == ASSET_IO_BACKEND_URING)
+        io_uring_issue(io);
+#endif
+    return true;
+}
+
+void asset_io_release(asset_io_t *io, uint8_t *data)
+{
+    free(data);
+    if (io && io->backend)
+        io_release_slot(io);
+}
+
+const char *asset_io_backend_name(const asset_io_t *io)
+{
+    if (!io)
+        return "none";
+    switch (atomic_load_u32((volatile uint32_t *)&io->backend))
+    {
+    case ASSET_IO_BACKEND_URING:
+        return "io_uring";
+    case ASSET_IO_BACKEND_THREADS:
+        return "threads";
+    default:
+        return "none";
+    }
+}
+
+bool asset_io_map(const char *path, asset_io_map_mode_t mode, asset_file_map_t *out)
+{
+    if (!path || !out)
+        return false;
+    memset(out, 0, sizeof(*out));
+
+#if defined(_WIN32)
+    const DWORD hint = mode == ASSET_IO_MAP_PRELOAD ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, hint, NULL);
+    if (f == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart <= 0)
+    {
+        CloseHandle(f);
+        return false;
+    }
+
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m)
+    {
+        CloseHandle(f);
+        return false;
+    }
+
+    void *base = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!base)
+    {
+        CloseHandle(m);
+        CloseHandle(f);
+        return false;
+    }
+
+    if (mode == ASSET_IO_MAP_PRELOAD)
+    {
+        // Touch every page so the caller never faults on the disk later.
+        volatile uint8_t sink = 0;
+        for (uint64_t i = 0; i < (uint64_t)sz.QuadPart; i += 4096u)
+            sink ^= ((const volatile uint8_t *)base)[i];
+        (void)sink;
+    }
+
+    out->data = (const uint8_t *)base;
+    out->size = (uint64_t)sz.QuadPart;
+    out->os_file = (void *)f;
+    out->os_mapping = (void *)m;
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+    if (mode == ASSET_IO_MAP_PRELOAD)
+        flags |= MAP_POPULATE;
+#endif
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, flags, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return false;
+
+    (void)madvise(base, (size_t)st.st_size, mode == ASSET_IO_MAP_PRELOAD ? MADV_WILLNEED : MADV_RANDOM);
+
+    out->data = (const uint8_t *)base;
+    out->size = (uint64_t)st.st_size;
+    return true;
+#endif
+}
+
+void asset_io_unmap(asset_file_map_t *m)
+{
+    if (!m)
+        return;
+
+#if defined(_WIN32)
+    if (m->data)
+        UnmapViewOfFile((LPCVOID)m->data);
+    if (m->os_mapping)
+        CloseHandle((HANDLE)m->os_mapping);
+    if (m->os_file)
+        CloseHandle((HANDLE)m->os_file);
+#else
+    if (m->data)
+        munmap((void *)(uintptr_t)m->data, (size_t)m->size);
+#endif
+
+    memset(m, 0, sizeof(*m));
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utils/threads.h"
+
+// Whole-file reads for the asset loaders, issued off the job pool so decode workers never block
+// in fread. At most queue_depth buffers are outstanding at once: counted from issue until the
+// consumer calls asset_io_release (or the read fails). Further requests wait in a FIFO.
+typedef enum asset_io_backend_t
+{
+    ASSET_IO_BACKEND_AUTO = 0, // io_uring when the kernel allows it, reader threads otherwise
+    ASSET_IO_BACKEND_THREADS,
+    ASSET_IO_BACKEND_URING
+} asset_io_backend_t;
+
+#define ASSET_IO_MAX_THREADS 16u
+
+// Runs on an I/O thread (or the caller of asset_io_shutdown for requests that were never issued).
+// data is NULL when the read failed or was cancelled; otherwise hand it to asset_io_release.
+typedef void (*asset_io_done_fn)(void *user, uint8_t *data, uint32_t size);
+
+typedef struct asset_io_req_t asset_io_req_t;
+
+typedef struct asset_io_t
+{
+    volatile uint32_t backend; // URING falls back to THREADS if io_uring_enter keeps failing
+    uint32_t queue_depth;
+
+    volatile uint32_t stopping;
+    volatile uint32_t inflight; // issued, callback not yet returned
+    uint32_t outstanding;       // guarded by m
+
+    mutex_t m;
+    cond_t cv;
+    asset_io_req_t *head;
+    asset_io_req_t *tail;
+
+    thread_t threads[ASSET_IO_MAX_THREADS];
+    uint32_t thread_count;
+
+    void *uring;
+} asset_io_t;
+
+bool asset_io_init(asset_io_t *io, uint32_t queue_depth, asset_io_backend_t backend);
+// Cancels queued requests (their callbacks get NULL) and waits for reads already issued.
+void asset_io_shutdown(asset_io_t *io);
+
+// Returns false once shutdown has started; fn is not called in that case.
+bool asset_io_read(asset_io_t *io, const char *path, asset_io_done_fn fn, void *user);
+void asset_io_release(asset_io_t *io, uint8_t *data);
+
+const char *asset_io_backend_name(const asset_io_t *io);
+
+// Read-only mapping of a whole file, for loaders that reference file contents in place instead of
+// reading them into the heap.
+typedef enum asset_io_map_mode_t
+{
+    ASSET_IO_MAP_RANDOM = 0, // pages come in as they are touched (packs)
+    ASSET_IO_MAP_PRELOAD     // the whole file is read in before asset_io_map returns
+} asset_io_map_mode_t;
+
+typedef struct asset_file_map_t
+{
+    const uint8_t *data;
+    uint64_t size;
+    void *os_file;
+    void *os_mapping;
+} asset_file_map_t;
+
+// False for missing or empty files. Independent of the I/O stage; callable from any thread.
+bool asset_io_map(const char *path, asset_io_map_mode_t mode, asset_file_map_t *out);
+void asset_io_unmap(asset_file_map_t *m);
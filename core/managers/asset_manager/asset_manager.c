@@ -1,5 +1,7 @@
 #include "asset_manager.h"
 #include "loaders/register_modules.h"
+#include "loaders/image_mips.h"
+#include "loaders/image_upload.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -13,9 +15,9 @@
 #include <windows.h>
 #include <direct.h>
 #else
-#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 #include <errno.h>
 #endif
 
@@ -32,10 +34,167 @@ typedef struct asset_image_mem_desc_t
     char *debug_name;
 } asset_image_mem_desc_t;
 
+// Starting guess for upload throughput until the first slices have been timed (about 1 GB/s).
+#define ASSET_UPLOAD_BYTES_PER_MS_GUESS (1024ull * 1024ull)
+// Smallest slice handed to upload_fn, so sliced uploads always make progress.
+#define ASSET_UPLOAD_MIN_SLICE_BYTES (64ull * 1024ull)
+
+typedef struct asset_upload_job_t
+{
+    asset_done_t done;
+    asset_upload_t up;
+} asset_upload_job_t;
+
 static uint64_t pack_persistent_key(ihandle_t h)
 {
-    // Layout: [type:16][meta:16][value:32]
-    return ((uint64_t)h.type << 48) | ((uint64_t)h.meta << 32) | (uint64_t)h.value;
+    // Layout: [type:16][meta:16][value:32]. Persistent handles only ever carry a 32-bit value.
+    return ((uint64_t)h.type << 48) | ((uint64_t)h.meta << 32) | (uint64_t)(uint32_t)h.value;
+}
+
+#define PACK_MAGIC 0x4B434150u
+#define PACK_VERSION 3u
+
+// Version 3 widened offsets and the file size to 64 bits; a single blob is still capped at 4 GB.
+typedef struct pack_hdr_t
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved0;
+    uint32_t toc_count;
+    uint32_t reserved1;
+    uint64_t toc_offset;
+    uint64_t data_offset;
+    uint64_t file_size;
+} pack_hdr_t;
+
+typedef struct pack_toc_t
+{
+    uint64_t key;
+    uint16_t type;
+    uint16_t variant;
+    uint32_t flags;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t uncompressed_size;
+    uint8_t codec;
+    uint8_t reserved1;
+    uint16_t reserved2;
+    uint32_t reserved3;
+} pack_toc_t;
+
+static const pack_toc_t *pack_find_entry(const asset_pack_t *p, uint64_t key)
+{
+    const pack_toc_t *toc = (const pack_toc_t *)p->toc;
+    uint32_t lo = 0;
+    uint32_t hi = p->toc_count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + ((hi - lo) >> 1);
+        if (toc[mid].key < key)
+            lo = mid + 1u;
+        else
+            hi = mid;
+    }
+    if (lo < p->toc_count && toc[lo].key == key)
+        return &toc[lo];
+    return NULL;
+}
+
+static bool pack_find_locked(const asset_manager_t *am, uint64_t key, asset_blob_t *out)
+{
+    for (uint32_t i = am->packs.size; i-- > 0;)
+    {
+        const asset_pack_t *p = (const asset_pack_t *)vector_impl_at((vector_t *)&am->packs, i);
+        const pack_toc_t *e = pack_find_entry(p, key);
+        if (!e)
+            continue;
+
+        if (out)
+        {
+            memset(out, 0, sizeof(*out));
+            out->data = (uint8_t *)(uintptr_t)(p->base + e->offset);
+            out->size = e->size;
+            out->align = 64;
+            out->uncompressed_size = e->uncompressed_size;
+            out->codec = e->codec;
+            out->flags = (uint8_t)e->flags;
+        }
+        return true;
+    }
+    return false;
+}
+
+static bool pack_map_file(const char *path, asset_pack_t *out)
+{
+    // Loads touch blobs in request order, not file order.
+    asset_file_map_t m;
+    if (!asset_io_map(path, ASSET_IO_MAP_RANDOM, &m))
+        return false;
+
+    out->base = m.data;
+    out->size = m.size;
+    out->os_file = m.os_file;
+    out->os_mapping = m.os_mapping;
+    return true;
+}
+
+static void pack_unmap(asset_pack_t *p)
+{
+    if (!p)
+        return;
+
+    asset_file_map_t m;
+    m.data = p->base;
+    m.size = p->size;
+    m.os_file = p->os_file;
+    m.os_mapping = p->os_mapping;
+    asset_io_unmap(&m);
+
+    free(p->path);
+    memset(p, 0, sizeof(*p));
+}
+
+static bool pack_validate(const asset_pack_t *p, const char *path)
+{
+    if (p->size < sizeof(pack_hdr_t))
+    {
+        LOG_ERROR("mount_pack: '%s' too small", path);
+        return false;
+    }
+
+    pack_hdr_t hdr;
+    memcpy(&hdr, p->base, sizeof(hdr));
+
+    if (hdr.magic != PACK_MAGIC || hdr.version != PACK_VERSION)
+    {
+        LOG_ERROR("mount_pack: '%s' bad header (magic=%08x version=%u)", path, (unsigned)hdr.magic, (unsigned)hdr.version);
+        return false;
+    }
+
+    uint64_t toc_end = (uint64_t)hdr.toc_offset + (uint64_t)hdr.toc_count * sizeof(pack_toc_t);
+    if (hdr.file_size != p->size || (hdr.toc_offset & 15u) || hdr.toc_offset < sizeof(pack_hdr_t) || toc_end > p->size)
+    {
+        LOG_ERROR("mount_pack: '%s' bad toc (offset=%" PRIu64 " count=%u size=%" PRIu64 ")", path, hdr.toc_offset, (unsigned)hdr.toc_count, p->size);
+        return false;
+    }
+
+    const pack_toc_t *toc = (const pack_toc_t *)(p->base + hdr.toc_offset);
+    for (uint32_t i = 0; i < hdr.toc_count; ++i)
+    {
+        const pack_toc_t *e = &toc[i];
+        if (i && e->key <= toc[i - 1u].key)
+        {
+            LOG_ERROR("mount_pack: '%s' toc not sorted at entry %u", path, (unsigned)i);
+            return false;
+        }
+        if (e->offset < hdr.data_offset || e->offset > hdr.toc_offset || e->size > hdr.toc_offset - e->offset)
+        {
+            LOG_ERROR("mount_pack: '%s' entry %u out of bounds", path, (unsigned)i);
+            return false;
+        }
+    }
+
+    return true;
 }
 
 static uint32_t u32_next_pow2(uint32_t x)
@@ -337,256 +496,69 @@ static uint64_t am_time_ms(void)
 #endif
 }
 
-#if defined(_WIN32)
-
-typedef struct win_mutex_t
-{
-    SRWLOCK l;
-} win_mutex_t;
-
-typedef struct win_cond_t
-{
-    CONDITION_VARIABLE cv;
-} win_cond_t;
-
-typedef struct win_thread_t
-{
-    HANDLE h;
-    void (*fn)(void *);
-    void *arg;
-} win_thread_t;
-
-static DWORD WINAPI win_thread_trampoline(LPVOID p)
-{
-    win_thread_t *t = (win_thread_t *)p;
-    t->fn(t->arg);
-    return 0;
-}
-
-static bool mutex_init_impl(mutex_t *m)
-{
-    win_mutex_t *x = (win_mutex_t *)malloc(sizeof(win_mutex_t));
-    if (!x)
-        return false;
-    InitializeSRWLock(&x->l);
-    m->p = x;
-    return true;
-}
-
-static void mutex_destroy_impl(mutex_t *m)
-{
-    free(m->p);
-    m->p = NULL;
-}
-
-static void mutex_lock_impl(mutex_t *m)
-{
-    win_mutex_t *x = (win_mutex_t *)m->p;
-    AcquireSRWLockExclusive(&x->l);
-}
-
-static void mutex_unlock_impl(mutex_t *m)
-{
-    win_mutex_t *x = (win_mutex_t *)m->p;
-    ReleaseSRWLockExclusive(&x->l);
-}
-
-static bool cond_init_impl(cond_t *c)
-{
-    win_cond_t *x = (win_cond_t *)malloc(sizeof(win_cond_t));
-    if (!x)
-        return false;
-    InitializeConditionVariable(&x->cv);
-    c->p = x;
-    return true;
-}
-
-static void cond_destroy_impl(cond_t *c)
-{
-    free(c->p);
-    c->p = NULL;
-}
-
-static void cond_wait_impl(cond_t *c, mutex_t *m)
-{
-    win_cond_t *cv = (win_cond_t *)c->p;
-    win_mutex_t *mx = (win_mutex_t *)m->p;
-    SleepConditionVariableSRW(&cv->cv, &mx->l, INFINITE, 0);
-}
-
-static void cond_signal_impl(cond_t *c)
-{
-    win_cond_t *cv = (win_cond_t *)c->p;
-    WakeConditionVariable(&cv->cv);
-}
-
-static void cond_broadcast_impl(cond_t *c)
-{
-    win_cond_t *cv = (win_cond_t *)c->p;
-    WakeAllConditionVariable(&cv->cv);
-}
-
-static bool thread_create_impl(thread_t *t, void (*fn)(void *), void *arg)
-{
-    win_thread_t *x = (win_thread_t *)malloc(sizeof(win_thread_t));
-    if (!x)
-        return false;
-    x->fn = fn;
-    x->arg = arg;
-    x->h = CreateThread(NULL, 0, win_thread_trampoline, x, 0, NULL);
-    if (!x->h)
-    {
-        free(x);
-        return false;
-    }
-    t->p = x;
-    return true;
-}
-
-static void thread_join_impl(thread_t *t)
+static uint64_t am_time_us(void)
 {
-    win_thread_t *x = (win_thread_t *)t->p;
-    if (!x)
-        return;
-    WaitForSingleObject(x->h, INFINITE);
-    CloseHandle(x->h);
-    free(x);
-    t->p = NULL;
-}
-
+#if defined(_WIN32)
+    static LARGE_INTEGER freq = {0};
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    if (freq.QuadPart == 0)
+        return (uint64_t)time(NULL) * 1000000ull;
+    return (uint64_t)(((uint64_t)now.QuadPart / (uint64_t)freq.QuadPart) * 1000000ull + (((uint64_t)now.QuadPart % (uint64_t)freq.QuadPart) * 1000000ull) / (uint64_t)freq.QuadPart);
 #else
+    struct timespec ts;
 
-typedef struct posix_mutex_t
-{
-    pthread_mutex_t m;
-} posix_mutex_t;
-
-typedef struct posix_cond_t
-{
-    pthread_cond_t c;
-} posix_cond_t;
-
-typedef struct posix_thread_t
-{
-    pthread_t t;
-    void (*fn)(void *);
-    void *arg;
-} posix_thread_t;
-
-static void *posix_thread_trampoline(void *p)
-{
-    posix_thread_t *x = (posix_thread_t *)p;
-    x->fn(x->arg);
-    return NULL;
-}
-
-static bool mutex_init_impl(mutex_t *m)
-{
-    posix_mutex_t *x = (posix_mutex_t *)malloc(sizeof(posix_mutex_t));
-    if (!x)
-        return false;
-    if (pthread_mutex_init(&x->m, NULL) != 0)
-    {
-        free(x);
-        return false;
-    }
-    m->p = x;
-    return true;
-}
+#if defined(CLOCK_MONOTONIC)
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000ull;
+#else
+    (void)ts;
+#endif
 
-static void mutex_destroy_impl(mutex_t *m)
-{
-    posix_mutex_t *x = (posix_mutex_t *)m->p;
-    if (!x)
-        return;
-    pthread_mutex_destroy(&x->m);
-    free(x);
-    m->p = NULL;
+    return (uint64_t)time(NULL) * 1000000ull;
+#endif
 }
 
-static void mutex_lock_impl(mutex_t *m)
+static uint64_t asset_upload_remaining_us(const asset_manager_t *am)
 {
-    posix_mutex_t *x = (posix_mutex_t *)m->p;
-    pthread_mutex_lock(&x->m);
+    if (!am->upload_time_budget_us)
+        return UINT64_MAX;
+    return am->upload_spent_us < am->upload_time_budget_us ? (uint64_t)(am->upload_time_budget_us - am->upload_spent_us) : 0;
 }
 
-static void mutex_unlock_impl(mutex_t *m)
+// Bytes that should fit in the remaining frame budget at the measured throughput.
+static uint64_t asset_upload_budget_bytes(const asset_manager_t *am)
 {
-    posix_mutex_t *x = (posix_mutex_t *)m->p;
-    pthread_mutex_unlock(&x->m);
+    uint64_t us = asset_upload_remaining_us(am);
+    if (us == UINT64_MAX)
+        return UINT64_MAX;
+    return us * am->upload_bytes_per_ms / 1000ull;
 }
 
-static bool cond_init_impl(cond_t *c)
+static void asset_upload_note(asset_manager_t *am, uint64_t bytes, uint64_t us)
 {
-    posix_cond_t *x = (posix_cond_t *)malloc(sizeof(posix_cond_t));
-    if (!x)
-        return false;
-    if (pthread_cond_init(&x->c, NULL) != 0)
-    {
-        free(x);
-        return false;
-    }
-    c->p = x;
-    return true;
-}
+    am->upload_spent_us += (uint32_t)(us < 0xFFFFFFFFull - am->upload_spent_us ? us : 0xFFFFFFFFull - am->upload_spent_us);
 
-static void cond_destroy_impl(cond_t *c)
-{
-    posix_cond_t *x = (posix_cond_t *)c->p;
-    if (!x)
+    // Tiny copies are dominated by call overhead and would drag the estimate down.
+    if (bytes < ASSET_UPLOAD_MIN_SLICE_BYTES)
         return;
-    pthread_cond_destroy(&x->c);
-    free(x);
-    c->p = NULL;
-}
-
-static void cond_wait_impl(cond_t *c, mutex_t *m)
-{
-    posix_cond_t *cv = (posix_cond_t *)c->p;
-    posix_mutex_t *mx = (posix_mutex_t *)m->p;
-    pthread_cond_wait(&cv->c, &mx->m);
-}
-
-static void cond_signal_impl(cond_t *c)
-{
-    posix_cond_t *cv = (posix_cond_t *)c->p;
-    pthread_cond_signal(&cv->c);
-}
-
-static void cond_broadcast_impl(cond_t *c)
-{
-    posix_cond_t *cv = (posix_cond_t *)c->p;
-    pthread_cond_broadcast(&cv->c);
-}
-
-static bool thread_create_impl(thread_t *t, void (*fn)(void *), void *arg)
-{
-    posix_thread_t *x = (posix_thread_t *)malloc(sizeof(posix_thread_t));
-    if (!x)
-        return false;
-    x->fn = fn;
-    x->arg = arg;
-    if (pthread_create(&x->t, NULL, posix_thread_trampoline, x) != 0)
-    {
-        free(x);
-        return false;
-    }
-    t->p = x;
-    return true;
+    uint64_t rate = bytes * 1000ull / (us ? us : 1ull);
+    am->upload_bytes_per_ms = (am->upload_bytes_per_ms * 7ull + rate) / 8ull;
+    if (!am->upload_bytes_per_ms)
+        am->upload_bytes_per_ms = 1;
 }
 
-static void thread_join_impl(thread_t *t)
+static void asset_init_cost_note(asset_manager_t *am, asset_type_t type, uint64_t us)
 {
-    posix_thread_t *x = (posix_thread_t *)t->p;
-    if (!x)
+    if ((uint32_t)type >= ASSET_MAX)
         return;
-    pthread_join(x->t, NULL);
-    free(x);
-    t->p = NULL;
+    uint32_t sample = us < 0xFFFFFFFFull ? (uint32_t)us : 0xFFFFFFFFu;
+    uint32_t prev = am->init_cost_us[type];
+    am->init_cost_us[type] = prev ? (uint32_t)(((uint64_t)prev * 7ull + sample) / 8ull) : sample;
 }
 
-#endif
-
 static void asset_zero(asset_any_t *a)
 {
     memset(a, 0, sizeof(*a));
@@ -675,6 +647,10 @@ static void asset_cleanup_by_module(asset_manager_t *am, asset_any_t *a, uint16_
     if (!m || m->type != a->type)
         m = find_module_const(am, a->type);
 
+    // Ring copies of paged-in levels belong to the manager, not the module.
+    if (a->type == ASSET_IMAGE)
+        asset_image_upload_unstage_all(am, a->as.image.mips);
+
     if (m && m->cleanup_fn)
         m->cleanup_fn(am, a);
 
@@ -685,6 +661,7 @@ static void slot_cleanup_asset_only(asset_manager_t *am, asset_slot_t *s)
 {
     if (!s)
         return;
+    atomic_store_u32(&s->published, 0u);
     asset_cleanup_by_module(am, &s->asset, s->module_index);
     s->module_index = 0xFFFFu;
 }
@@ -704,11 +681,84 @@ static void slot_destroy(asset_manager_t *am, asset_slot_t *s)
     s->requested_type = 0;
     s->last_touched_frame = 0;
     s->last_requested_ms = 0;
+    s->use_frames = 0;
     s->flags = ASSET_FLAG_NONE;
+    vector_impl_free(&s->deps);
+    vector_impl_free(&s->dependents);
 
     s->persistent = ihandle_invalid();
 }
 
+static bool slot_table_init(asset_slot_table_t *t)
+{
+    memset(t, 0, sizeof(*t));
+    t->pages = (asset_slot_t **)calloc(ASSET_SLOT_MAX_PAGES, sizeof(asset_slot_t *));
+    return t->pages != NULL;
+}
+
+static void slot_table_free(asset_slot_table_t *t)
+{
+    for (uint32_t i = 0; t->pages && i < t->page_count; ++i)
+        free(t->pages[i]);
+    free(t->pages);
+    memset(t, 0, sizeof(*t));
+}
+
+static asset_slot_t *slot_at(const asset_slot_table_t *t, uint32_t i)
+{
+    return &t->pages[i >> ASSET_SLOT_PAGE_SHIFT][i & (ASSET_SLOT_PAGE_SIZE - 1u)];
+}
+
+// Appends a copy of init, or returns NULL when the table is full.
+static asset_slot_t *slot_table_push(asset_slot_table_t *t, const asset_slot_t *init)
+{
+    uint32_t i = t->size;
+    uint32_t page = i >> ASSET_SLOT_PAGE_SHIFT;
+    if (page >= ASSET_SLOT_MAX_PAGES)
+        return NULL;
+    if (page == t->page_count)
+    {
+        t->pages[page] = (asset_slot_t *)calloc(ASSET_SLOT_PAGE_SIZE, sizeof(asset_slot_t));
+        if (!t->pages[page])
+            return NULL;
+        t->page_count++;
+    }
+
+    asset_slot_t *s = slot_at(t, i);
+    *s = *init;
+    atomic_store_u32(&t->size, i + 1u);
+    return s;
+}
+
+// Lock-free lookup of a READY slot. published only matches the handle's generation while the
+// slot is READY, so a hit is a validated pointer into a page that never moves.
+static asset_slot_t *slot_ready_fast(asset_manager_t *am, ihandle_t h)
+{
+    if (!ihandle_is_valid(h) || ihandle_type(h) != am->handle_type)
+        return NULL;
+
+    uint32_t idx = ihandle_index(h);
+    if (idx == 0 || idx > atomic_load_u32(&am->slots.size))
+        return NULL;
+
+    asset_slot_t *s = slot_at(&am->slots, idx - 1u);
+    return atomic_load_u32(&s->published) == ihandle_generation(h) ? s : NULL;
+}
+
+static void slot_publish_ready_locked(asset_slot_t *s)
+{
+    atomic_store_u32(&s->published, s->generation);
+}
+
+static void slot_note_use(asset_manager_t *am, asset_slot_t *s, uint64_t now_ms)
+{
+    const uint64_t frame = atomic_load_u64(&am->frame_index);
+    if (atomic_load_u64(&s->last_touched_frame) != frame)
+        atomic_add_u32(&s->use_frames, 1u);
+    atomic_store_u64(&s->last_touched_frame, frame);
+    atomic_store_u64(&s->last_requested_ms, now_ms);
+}
+
 static bool slot_valid_locked(asset_manager_t *am, ihandle_t h, asset_slot_t **out_slot)
 {
     if (!ihandle_is_valid(h))
@@ -716,15 +766,15 @@ static bool slot_valid_locked(asset_manager_t *am, ihandle_t h, asset_slot_t **o
     if (ihandle_type(h) != am->handle_type)
         return false;
 
-    uint16_t idx = ihandle_index(h);
+    uint32_t idx = ihandle_index(h);
     if (idx == 0)
         return false;
 
-    uint32_t i = (uint32_t)(idx - 1);
+    uint32_t i = idx - 1u;
     if (i >= am->slots.size)
         return false;
 
-    asset_slot_t *s = (asset_slot_t *)vector_impl_at((vector_t *)&am->slots, i);
+    asset_slot_t *s = slot_at(&am->slots, i);
     if (s->generation != ihandle_generation(h))
         return false;
 
@@ -758,144 +808,85 @@ static ihandle_t make_persistent_handle(asset_manager_t *am, asset_type_t type)
     return h;
 }
 
-static void jobq_init(job_queue_t *q, uint32_t cap)
-{
-    q->buf = (asset_job_t *)calloc((size_t)cap, sizeof(asset_job_t));
-    q->cap = cap;
-    q->head = q->tail = q->count = 0;
-    mutex_init_impl(&q->m);
-    cond_init_impl(&q->cv);
-}
-
-static void jobq_destroy(job_queue_t *q)
+static void jobq_drain(asset_ring_t *q)
 {
-    if (q->buf)
+    asset_job_t j;
+    while (asset_ring_pop(q, &j))
     {
-        for (uint32_t i = 0; i < q->count; ++i)
-        {
-            uint32_t idx = (q->head + i) % q->cap;
-            if (!q->buf[idx].path_is_ptr)
-                free(q->buf[idx].path);
-        }
-        free(q->buf);
+        if (!j.path_is_ptr)
+            free(j.path);
     }
-    cond_destroy_impl(&q->cv);
-    mutex_destroy_impl(&q->m);
-    memset(q, 0, sizeof(*q));
 }
 
-static void jobq_drain(job_queue_t *q)
+static bool jobq_push(asset_ring_t *q, const asset_job_t *j)
 {
-    mutex_lock_impl(&q->m);
-    while (q->count > 0)
-    {
-        asset_job_t *j = &q->buf[q->head];
-        if (!j->path_is_ptr)
-            free(j->path);
-        j->path = NULL;
-        j->path_is_ptr = 0;
-        q->head = (q->head + 1) % q->cap;
-        q->count--;
-    }
-    q->head = 0;
-    q->tail = 0;
-    mutex_unlock_impl(&q->m);
+    return asset_ring_push(q, j);
 }
 
-static bool jobq_push(job_queue_t *q, const asset_job_t *j)
+static bool jobq_pop(asset_ring_t *q, asset_job_t *out)
 {
-    mutex_lock_impl(&q->m);
-    if (q->count == q->cap)
-    {
-        mutex_unlock_impl(&q->m);
-        return false;
-    }
-    q->buf[q->tail] = *j;
-    q->tail = (q->tail + 1) % q->cap;
-    q->count++;
-    cond_signal_impl(&q->cv);
-    mutex_unlock_impl(&q->m);
-    return true;
+    return asset_ring_pop(q, out);
 }
 
-static bool jobq_pop_blocking(job_queue_t *q, asset_job_t *out, uint32_t *shutting_down, mutex_t *state_m)
+static bool jobq_pop_any(asset_manager_t *am, asset_job_t *out)
 {
-    mutex_lock_impl(&q->m);
-    for (;;)
+    for (uint32_t p = 0; p < ASSET_PRIORITY_COUNT; ++p)
     {
-        mutex_lock_impl(state_m);
-        uint32_t sd = *shutting_down;
-        mutex_unlock_impl(state_m);
-
-        if (sd)
-        {
-            mutex_unlock_impl(&q->m);
-            return false;
-        }
-
-        if (q->count > 0)
-            break;
-
-        cond_wait_impl(&q->cv, &q->m);
+        if (jobq_pop(&am->jobs[p], out))
+            return true;
     }
+    return false;
+}
 
-    *out = q->buf[q->head];
-    q->head = (q->head + 1) % q->cap;
-    q->count--;
-    mutex_unlock_impl(&q->m);
-    return true;
+static uint32_t jobq_count(asset_manager_t *am)
+{
+    uint32_t n = 0;
+    for (uint32_t p = 0; p < ASSET_PRIORITY_COUNT; ++p)
+        n += asset_ring_count(&am->jobs[p]);
+    return n;
 }
 
-static void doneq_init(done_queue_t *q, uint32_t cap)
+// Queued loads that a loader will actually start; stale entries are dropped when popped.
+static uint32_t jobq_live_count(asset_manager_t *am)
 {
-    q->buf = (asset_done_t *)calloc((size_t)cap, sizeof(asset_done_t));
-    q->cap = cap;
-    q->head = q->tail = q->count = 0;
-    mutex_init_impl(&q->m);
+    const uint32_t n = jobq_count(am);
+    const uint32_t stale = atomic_load_u32(&am->jobs_stale);
+    return n > stale ? n - stale : 0;
 }
 
-static void doneq_destroy(done_queue_t *q)
+static uint32_t job_ticket_next_locked(asset_manager_t *am)
 {
-    free(q->buf);
-    mutex_destroy_impl(&q->m);
-    memset(q, 0, sizeof(*q));
+    if (++am->job_ticket_next == 0)
+        am->job_ticket_next = 1;
+    return am->job_ticket_next;
 }
 
-static bool doneq_push(done_queue_t *q, const asset_done_t *d)
+static bool doneq_pop(asset_manager_t *am, asset_done_t *out)
 {
-    bool ok = false;
-    mutex_lock_impl(&q->m);
-    if (q->count < q->cap)
-    {
-        q->buf[q->tail] = *d;
-        q->tail = (q->tail + 1) % q->cap;
-        q->count++;
-        ok = true;
-    }
-    mutex_unlock_impl(&q->m);
-    return ok;
+    if (!asset_ring_pop(&am->done, out))
+        return false;
+
+    atomic_add_u32(&am->done_popped, 1u);
+    if (atomic_load_u32(&am->done_parked))
+        threads_futex_wake(&am->done_popped, true);
+    return true;
 }
 
-static bool doneq_pop(done_queue_t *q, asset_done_t *out)
+// Results are never dropped: when the main thread falls behind, loaders park until pump frees a cell.
+static void doneq_push(asset_manager_t *am, const asset_done_t *d)
 {
-    bool ok = false;
-    mutex_lock_impl(&q->m);
-    if (q->count > 0)
+    for (;;)
     {
-        *out = q->buf[q->head];
-        q->head = (q->head + 1) % q->cap;
-        q->count--;
-        ok = true;
+        uint32_t popped = atomic_load_u32(&am->done_popped);
+        if (asset_ring_push(&am->done, d))
+            return;
+
+        atomic_add_u32(&am->done_parked, 1u);
+        threads_futex_wait(&am->done_popped, popped, 100u);
+        atomic_sub_u32(&am->done_parked, 1u);
     }
-    mutex_unlock_impl(&q->m);
-    return ok;
 }
 
-typedef struct worker_ctx_t
-{
-    asset_manager_t *am;
-} worker_ctx_t;
-
 static const char *asset_path_ext(const char *path)
 {
     if (!path)
@@ -1077,72 +1068,521 @@ static bool asset_try_load_any(asset_manager_t *am, asset_type_t type, const cha
     return false;
 }
 
-static void worker_main(void *p)
+// Path requests whose persistent key is in a mounted pack load straight from the mapping.
+static bool asset_try_load_packed(asset_manager_t *am, const asset_job_t *j, asset_any_t *out_asset, uint16_t *out_module_index, ihandle_t *out_persistent)
 {
-    worker_ctx_t *ctx = (worker_ctx_t *)p;
-    asset_manager_t *am = ctx->am;
+    if (j->path_is_ptr || !ihandle_is_valid(j->persistent))
+        return false;
 
-    for (;;)
+    asset_blob_t view;
+    threads_mutex_lock(&am->state_m);
+    bool found = am->packs.size && pack_find_locked(am, pack_persistent_key(j->persistent), &view);
+    threads_mutex_unlock(&am->state_m);
+
+    if (!found)
+        return false;
+
+    if (view.codec != ASSET_CODEC_NONE && !asset_codec_get(view.codec))
     {
-        asset_job_t j;
-        if (!jobq_pop_blocking(&am->jobs, &j, &am->shutting_down, &am->state_m))
-            break;
+        LOG_ERROR("pack blob for '%s' uses unknown codec %u", j->path, (unsigned)view.codec);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < am->modules.size; ++i)
+    {
+        const asset_module_desc_t *m = (const asset_module_desc_t *)vector_impl_at(&am->modules, i);
+        if (!m || m->type != j->type || !m->load_blob_fn)
+            continue;
+
+        asset_any_t tmp;
+        asset_zero(&tmp);
 
-        // NOTE: ptr-load modules are allowed to free `j.path` during `load_fn` (e.g. images free their mem desc).
-        // Never access `j.path` after calling `asset_try_load_any` when `j.path_is_ptr == 1`.
-        ihandle_t slot_persistent = ihandle_invalid();
+        ihandle_t hid = ihandle_invalid();
+        if (m->load_blob_fn(am, j->path, &view, &tmp, &hid))
         {
-            mutex_lock_impl(&am->state_m);
-            asset_slot_t *s = NULL;
-            if (slot_valid_locked(am, j.handle, &s) && s)
-                slot_persistent = s->persistent;
-            mutex_unlock_impl(&am->state_m);
+            *out_asset = tmp;
+            *out_module_index = (uint16_t)i;
+            *out_persistent = hid;
+            return true;
         }
+    }
+
+    return false;
+}
+
+uint32_t asset_manager_image_resident_first(const asset_manager_t *am, uint32_t mip_count)
+{
+    if (!am || mip_count == 0)
+        return 0;
+    const uint32_t lowest = mip_count - 1u;
+    const uint32_t safety = am->tex_stream_min_safety_mips_from_bottom;
+    return safety < lowest ? lowest - safety : 0u;
+}
+
+// Images their module can read back from disk only keep the safety mips in RAM; the streamer pages
+// sharper levels in when it wants to upload them.
+static void asset_image_trim_resident(asset_manager_t *am, asset_any_t *a, uint16_t midx)
+{
+    if (a->type != ASSET_IMAGE || !a->as.image.mips)
+        return;
+
+    const asset_module_desc_t *m = asset_manager_get_module_by_index(am, midx);
+    if (!m || !m->mip_read_fn)
+        return;
+
+    asset_image_mip_chain_t *mips = a->as.image.mips;
+    asset_image_mips_trim(mips, asset_manager_image_resident_first(am, mips->mip_count));
+}
+
+static void asset_load_finish(asset_manager_t *am, asset_job_t *j, bool ok, const asset_any_t *out, uint16_t midx, ihandle_t ph)
+{
+    asset_done_t d;
+    memset(&d, 0, sizeof(d));
+    d.handle = j->handle;
+    d.ok = ok;
+    d.module_index = midx;
+    asset_zero(&d.asset);
+
+    // Prefer module-provided persistent handle, otherwise use the slot's persistent (computed at request time).
+    // Do not hash `j->path` here: ptr loaders may have freed it.
+    if (ihandle_is_valid(ph))
+        d.persistent = ph;
+    else if (ihandle_is_valid(j->persistent))
+        d.persistent = j->persistent;
+    else
+        d.persistent = make_persistent_handle_from_job(j->type, j->path, j->path_is_ptr);
+
+    if (ok)
+    {
+        d.asset = *out;
+        if (!j->path_is_ptr)
+            asset_image_trim_resident(am, &d.asset, midx);
+        // The render thread then only issues the copies out of the ring.
+        if (d.asset.type == ASSET_IMAGE)
+            asset_image_upload_stage(am, &d.asset.as.image);
+    }
+
+    if (!j->path_is_ptr)
+        free(j->path);
+    doneq_push(am, &d);
+}
+
+typedef struct asset_io_load_t
+{
+    asset_manager_t *am;
+    asset_job_t job;
+    uint16_t module_index;
+    uint8_t *data;
+    uint32_t size;
+} asset_io_load_t;
 
-        mutex_lock_impl(&am->state_m);
-        uint32_t sd = am->shutting_down;
-        mutex_unlock_impl(&am->state_m);
+static bool asset_state_settled(uint32_t state)
+{
+    return state == ASSET_STATE_READY || state == ASSET_STATE_FAILED;
+}
+
+// Moves deps_pending by delta. When that settles or unsettles the slot's closure, every
+// dependent gains or loses one pending dependency in turn.
+static void slot_deps_adjust_locked(asset_manager_t *am, asset_slot_t *s, int32_t delta)
+{
+    const bool was_settled = s->deps_pending == 0;
+    s->deps_pending = (uint32_t)((int32_t)s->deps_pending + delta);
+    const bool settled = s->deps_pending == 0;
+    if (was_settled == settled)
+        return;
+
+    for (uint32_t i = 0; i < s->dependents.size; ++i)
+    {
+        const uint32_t di = *(const uint32_t *)vector_impl_at(&s->dependents, i);
+        slot_deps_adjust_locked(am, slot_at(&am->slots, di), settled ? -1 : 1);
+    }
+}
+
+static bool slot_closure_failed(const asset_slot_t *s)
+{
+    return s->seen_state == ASSET_STATE_FAILED || s->deps_failed != 0;
+}
+
+static void slot_deps_fail_adjust_locked(asset_manager_t *am, asset_slot_t *s, int32_t delta);
+
+// Tells the dependents of `s` that a FAILED asset entered or left its closure.
+static void slot_closure_failed_changed_locked(asset_manager_t *am, asset_slot_t *s)
+{
+    const int32_t delta = slot_closure_failed(s) ? 1 : -1;
+    for (uint32_t i = 0; i < s->dependents.size; ++i)
+    {
+        const uint32_t di = *(const uint32_t *)vector_impl_at(&s->dependents, i);
+        slot_deps_fail_adjust_locked(am, slot_at(&am->slots, di), delta);
+    }
+}
+
+// Same walk as slot_deps_adjust_locked, for deps_failed.
+static void slot_deps_fail_adjust_locked(asset_manager_t *am, asset_slot_t *s, int32_t delta)
+{
+    const bool was_failed = slot_closure_failed(s);
+    s->deps_failed = (uint32_t)((int32_t)s->deps_failed + delta);
+    if (was_failed != slot_closure_failed(s))
+        slot_closure_failed_changed_locked(am, s);
+}
+
+// Call after every change of s->asset.state.
+static void slot_state_changed_locked(asset_manager_t *am, asset_slot_t *s)
+{
+    const uint32_t prev = s->seen_state;
+    const uint32_t cur = (uint32_t)s->asset.state;
+    if (prev == cur)
+        return;
+    const bool was_failed = slot_closure_failed(s);
+    s->seen_state = (uint8_t)cur;
+
+    if (prev == ASSET_STATE_LOADING)
+        atomic_sub_u32(&am->slots_loading, 1u);
+    if (cur == ASSET_STATE_LOADING)
+        atomic_add_u32(&am->slots_loading, 1u);
+
+    if (asset_state_settled(prev) != asset_state_settled(cur))
+        slot_deps_adjust_locked(am, s, asset_state_settled(cur) ? -1 : 1);
+    if (was_failed != slot_closure_failed(s))
+        slot_closure_failed_changed_locked(am, s);
+}
+
+static bool slot_index_list_has(vector_t *v, uint32_t index)
+{
+    for (uint32_t i = 0; i < v->size; ++i)
+    {
+        if (*(const uint32_t *)vector_impl_at(v, i) == index)
+            return true;
+    }
+    return false;
+}
 
-        if (sd)
+static void slot_index_list_push(vector_t *v, uint32_t index)
+{
+    if (!v->element_size)
+        *v = vector_impl_create_vector(sizeof(uint32_t));
+    vector_impl_push_back(v, &index);
+}
+
+// True when `target` is in the closure of slot `from`.
+static bool asset_dep_reaches_locked(asset_manager_t *am, uint32_t from, uint32_t target)
+{
+    if (++am->dep_walk_epoch == 0)
+        am->dep_walk_epoch = 1;
+    const uint32_t walk = am->dep_walk_epoch;
+
+    vector_t stack = vector_impl_create_vector(sizeof(uint32_t));
+    slot_at(&am->slots, from)->dep_walk = walk;
+    vector_impl_push_back(&stack, &from);
+
+    bool found = false;
+    while (stack.size && !found)
+    {
+        const uint32_t i = *(const uint32_t *)vector_impl_back(&stack);
+        vector_impl_pop_back(&stack);
+        found = i == target;
+
+        asset_slot_t *s = slot_at(&am->slots, i);
+        for (uint32_t k = 0; !found && k < s->deps.size; ++k)
         {
-            if (!j.path_is_ptr)
-                free(j.path);
-            break;
+            uint32_t di = *(const uint32_t *)vector_impl_at(&s->deps, k);
+            asset_slot_t *ds = slot_at(&am->slots, di);
+            if (ds->dep_walk == walk)
+                continue;
+            ds->dep_walk = walk;
+            vector_impl_push_back(&stack, &di);
         }
+    }
 
-        asset_done_t d;
-        memset(&d, 0, sizeof(d));
-        d.handle = j.handle;
-        d.persistent = ihandle_invalid();
-        d.ok = false;
-        d.module_index = 0xFFFFu;
-        asset_zero(&d.asset);
-
-        asset_any_t out;
-        uint16_t midx = 0xFFFFu;
-        ihandle_t ph = ihandle_invalid();
-
-        bool ok = asset_try_load_any(am, j.type, j.path, j.path_is_ptr, &out, &midx, &ph);
-        d.ok = ok;
-        d.module_index = midx;
-        // Prefer module-provided persistent handle, otherwise use the slot's persistent (computed at request time).
-        // Do not hash `j.path` here: ptr loaders may have freed it.
-        if (ihandle_is_valid(ph))
-            d.persistent = ph;
-        else if (ihandle_is_valid(slot_persistent))
-            d.persistent = slot_persistent;
-        else
-            d.persistent = make_persistent_handle_from_job(j.type, j.path, j.path_is_ptr);
+    vector_impl_free(&stack);
+    return found;
+}
+
+// Edges are slot indices; slots are never reused, so they stay valid for the manager's lifetime.
+// An edge that would close a cycle is rejected: neither end could ever count as settled.
+static bool asset_dep_add_locked(asset_manager_t *am, ihandle_t parent, ihandle_t child)
+{
+    asset_slot_t *ps = NULL;
+    asset_slot_t *cs = NULL;
+    if (!slot_valid_locked(am, parent, &ps) || !slot_valid_locked(am, child, &cs) || ps == cs)
+        return false;
+
+    const uint32_t pi = (uint32_t)ihandle_index(parent) - 1u;
+    const uint32_t ci = (uint32_t)ihandle_index(child) - 1u;
+    if (slot_index_list_has(&ps->deps, ci))
+        return true;
+
+    if (cs->deps.size && asset_dep_reaches_locked(am, ci, pi))
+    {
+        LOG_WARN("Asset dependency '%s' -> '%s' would close a cycle; ignored",
+                 ps->path && !ps->path_is_ptr ? ps->path : "<memory>", cs->path && !cs->path_is_ptr ? cs->path : "<memory>");
+        return false;
+    }
+
+    slot_index_list_push(&ps->deps, ci);
+    slot_index_list_push(&cs->dependents, pi);
+    if (cs->deps_pending)
+        slot_deps_adjust_locked(am, ps, 1);
+    if (slot_closure_failed(cs))
+        slot_deps_fail_adjust_locked(am, ps, 1);
+    return true;
+}
+
+static bool asset_image_color_space_locked(asset_manager_t *am, ihandle_t image, uint32_t color_space)
+{
+    asset_slot_t *s = NULL;
+    if (!slot_valid_locked(am, image, &s) || s->requested_type != ASSET_IMAGE)
+        return false;
+    if (s->color_space == color_space || color_space == ASSET_IMAGE_COLOR_SPACE_AUTO)
+        return true;
+    if (s->color_space != ASSET_IMAGE_COLOR_SPACE_AUTO)
+        return false;
+
+    s->color_space = (uint8_t)color_space;
+    // A loader already built the mips without it; pump reloads the image once it is READY.
+    if (s->color_space_decoded)
+        vector_impl_push_back(&am->color_space_reloads, &image);
+    return true;
+}
+
+static void asset_dep_add_material_locked(asset_manager_t *am, ihandle_t h, const asset_material_t *m)
+{
+    const ihandle_t tex[] = {m->albedo_tex, m->normal_tex, m->metallic_tex, m->roughness_tex,
+                             m->emissive_tex, m->occlusion_tex, m->height_tex, m->arm_tex};
+    for (uint32_t i = 0; i < sizeof(tex) / sizeof(tex[0]); ++i)
+    {
+        if (!ihandle_is_valid(tex[i]))
+            continue;
+        asset_dep_add_locked(am, h, tex[i]);
+        // Albedo and emissive hold color; every other slot holds data.
+        const bool color = i == 0 || i == 4;
+        asset_image_color_space_locked(am, tex[i], color ? ASSET_IMAGE_COLOR_SPACE_SRGB : ASSET_IMAGE_COLOR_SPACE_LINEAR);
+    }
+}
+
+// The asset a loader on this thread is producing; requests it makes become its dependencies.
+static THREAD_LOCAL asset_manager_t *g_dep_am;
+static THREAD_LOCAL ihandle_t g_dep_parent;
+
+static void asset_dep_begin(asset_manager_t *am, ihandle_t parent)
+{
+    g_dep_am = am;
+    g_dep_parent = parent;
+}
+
+static void asset_dep_end(void)
+{
+    g_dep_am = NULL;
+}
+
+static void asset_dep_note_request(asset_manager_t *am, ihandle_t child)
+{
+    if (g_dep_am != am || !ihandle_is_valid(child))
+        return;
+    threads_mutex_lock(&am->state_m);
+    asset_dep_add_locked(am, g_dep_parent, child);
+    threads_mutex_unlock(&am->state_m);
+}
+
+// The module try_load_any would pick first, if it can also decode from memory and does not read
+// the file itself.
+static uint32_t asset_find_blob_loader(asset_manager_t *am, asset_type_t type, const char *path)
+{
+    for (uint32_t i = 0; i < am->modules.size; ++i)
+    {
+        const asset_module_desc_t *m = (const asset_module_desc_t *)vector_impl_at(&am->modules, i);
+        if (!m || m->type != type || !m->load_fn || !m->can_load_fn)
+            continue;
+        if (m->can_load_fn(am, path, 0u))
+            return (m->load_blob_fn && !m->maps_source_files && !m->reads_source_ranges) ? i : 0xFFFFFFFFu;
+    }
+    return 0xFFFFFFFFu;
+}
+
+static void asset_io_decode_job(void *user, uint32_t worker_index)
+{
+    (void)worker_index;
+    asset_io_load_t *l = (asset_io_load_t *)user;
+    asset_manager_t *am = l->am;
+
+    // The I/O stage may already be torn down; only give the buffer back while it is alive.
+    if (atomic_load_u32(&am->shutting_down))
+    {
+        free(l->data);
+        free(l->job.path);
+        free(l);
+        return;
+    }
+
+    asset_any_t out;
+    uint16_t midx = 0xFFFFu;
+    ihandle_t ph = ihandle_invalid();
+    bool ok = false;
+
+    if (l->data)
+    {
+        asset_blob_t blob;
+        memset(&blob, 0, sizeof(blob));
+        blob.data = l->data;
+        blob.size = l->size;
+        blob.align = 1;
+        blob.flags = ASSET_BLOB_FLAG_SOURCE_FILE;
+
+        const asset_module_desc_t *m = asset_manager_get_module_by_index(am, l->module_index);
+        asset_zero(&out);
+        asset_dep_begin(am, l->job.handle);
+        if (m && m->load_blob_fn(am, l->job.path, &blob, &out, &ph))
+        {
+            ok = true;
+            midx = l->module_index;
+        }
+        asset_dep_end();
+        asset_io_release(&am->io, l->data);
+    }
+
+    // Read errors and decode failures go through the regular loaders, which report them.
+    if (!ok)
+    {
+        asset_dep_begin(am, l->job.handle);
+        ok = asset_try_load_any(am, l->job.type, l->job.path, 0u, &out, &midx, &ph);
+        asset_dep_end();
+    }
+
+    asset_load_finish(am, &l->job, ok, &out, midx, ph);
+    free(l);
+}
+
+static void asset_io_read_done(void *user, uint8_t *data, uint32_t size)
+{
+    asset_io_load_t *l = (asset_io_load_t *)user;
+    l->data = data;
+    l->size = size;
+    jobs_run_background(asset_io_decode_job, l, &l->am->loaders);
+}
+
+// Hands file reads to the I/O stage so this loader can move on; decoding continues in
+// asset_io_decode_job once the bytes are in memory.
+static bool asset_load_async(asset_manager_t *am, asset_job_t *j)
+{
+    if (j->path_is_ptr || !am->io.backend)
+        return false;
+
+    uint32_t midx = asset_find_blob_loader(am, j->type, j->path);
+    if (midx == 0xFFFFFFFFu)
+        return false;
+
+    asset_io_load_t *l = (asset_io_load_t *)calloc(1, sizeof(asset_io_load_t));
+    if (!l)
+        return false;
+    l->am = am;
+    l->job = *j;
+    l->module_index = (uint16_t)midx;
+
+    if (!asset_io_read(&am->io, j->path, asset_io_read_done, l))
+    {
+        free(l);
+        return false;
+    }
+    return true;
+}
+
+// Takes ownership of the slot's queued load. False for stale ring entries (the job was requeued
+// under another priority or cancelled) and for prefetches that expired while they waited.
+static bool asset_job_claim(asset_manager_t *am, const asset_job_t *j)
+{
+    if (j->path_is_ptr)
+        return true;
+
+    threads_mutex_lock(&am->state_m);
+    asset_slot_t *s = NULL;
+    const bool valid = slot_valid_locked(am, j->handle, &s);
+    bool live = valid && s->inflight && s->job_ticket == j->ticket && s->priority == j->priority;
+    if (!live)
+    {
+        if (valid && s->job_ticket == j->ticket)
+            s->queued_mask &= (uint8_t)~(1u << j->priority);
+        if (atomic_load_u32(&am->jobs_stale))
+            atomic_sub_u32(&am->jobs_stale, 1u);
+    }
+    else
+    {
+        s->job_ticket = 0;
+        s->queued_mask = 0;
 
-        if (ok)
-            d.asset = out;
+        uint64_t now_ms = am_time_ms();
+        if (j->priority == ASSET_PRIORITY_PREFETCH && now_ms > atomic_load_u64(&s->last_requested_ms) + am->prefetch_expire_ms)
+        {
+            s->inflight = 0;
+            s->asset.state = ASSET_STATE_EMPTY;
+            slot_state_changed_locked(am, s);
+            am->stats.jobs_cancelled_total++;
+            live = false;
+        }
+    }
+    threads_mutex_unlock(&am->state_m);
+    return live;
+}
 
+static void asset_load_job(asset_manager_t *am, asset_job_t j)
+{
+    // NOTE: ptr-load modules are allowed to free `j.path` during `load_fn` (e.g. images free their mem desc).
+    // Never access `j.path` after calling `asset_try_load_any` when `j.path_is_ptr == 1`.
+    if (atomic_load_u32(&am->shutting_down) || !asset_job_claim(am, &j))
+    {
         if (!j.path_is_ptr)
             free(j.path);
-        doneq_push(&am->done, &d);
+        return;
+    }
+
+    asset_any_t out;
+    uint16_t midx = 0xFFFFu;
+    ihandle_t ph = ihandle_invalid();
+
+    asset_dep_begin(am, j.handle);
+    bool ok = asset_try_load_packed(am, &j, &out, &midx, &ph);
+    if (!ok && asset_load_async(am, &j))
+    {
+        asset_dep_end();
+        return;
+    }
+    if (!ok)
+        ok = asset_try_load_any(am, j.type, j.path, j.path_is_ptr, &out, &midx, &ph);
+    asset_dep_end();
+
+    asset_load_finish(am, &j, ok, &out, midx, ph);
+}
+
+// Loader jobs run on the engine job pool. At most worker_count of them are active at once and
+// each drains the request queue before retiring, so a burst of requests costs one submit per loader.
+static void asset_loader_main(void *user, uint32_t worker_index)
+{
+    (void)worker_index;
+    asset_manager_t *am = (asset_manager_t *)user;
+
+    for (;;)
+    {
+        asset_job_t j;
+        while (jobq_pop_any(am, &j))
+            asset_load_job(am, j);
+
+        atomic_sub_u32(&am->loaders_active, 1u);
+
+        // A request may have been queued after the last pop but before the decrement above.
+        uint32_t active = atomic_load_u32(&am->loaders_active);
+        if (!jobq_count(am) || active >= am->worker_count || !atomic_cas_u32(&am->loaders_active, active, active + 1u))
+            break;
     }
+}
 
-    free(ctx);
+static void asset_kick_loaders(asset_manager_t *am)
+{
+    for (;;)
+    {
+        uint32_t active = atomic_load_u32(&am->loaders_active);
+        if (active >= am->worker_count || active >= jobq_count(am))
+            return;
+        if (atomic_cas_u32(&am->loaders_active, active, active + 1u))
+            jobs_run_background(asset_loader_main, am, &am->loaders);
+    }
 }
 
 bool asset_manager_register_module(asset_manager_t *am, asset_module_desc_t module)
@@ -1171,7 +1611,8 @@ bool asset_manager_register_module(asset_manager_t *am, asset_module_desc_t modu
         !module.cleanup_fn &&
         !module.save_blob_fn &&
         !module.blob_free_fn &&
-        !module.can_load_fn)
+        !module.can_load_fn &&
+        !module.load_blob_fn)
     {
         LOG_ERROR("asset_manager_register_module: all module functions are NULL (type=%s, name=%s)",
                   ASSET_TYPE_TO_STRING(module.type), module.name);
@@ -1238,14 +1679,22 @@ static asset_slot_t *alloc_slot_locked(asset_manager_t *am, asset_type_t type, i
     s.last_touched_frame = 0;
     s.last_requested_ms = 0;
     s.path = NULL;
+    s.deps_pending = 1;
+    s.seen_state = ASSET_STATE_LOADING;
 
-    vector_impl_push_back(&am->slots, &s);
-
-    uint32_t idx0 = (uint32_t)(am->slots.size - 1);
-    asset_slot_t *slot = (asset_slot_t *)vector_impl_at(&am->slots, idx0);
+    uint32_t idx0 = am->slots.size;
+    asset_slot_t *slot = slot_table_push(&am->slots, &s);
+    if (!slot)
+    {
+        LOG_ERROR("Asset slot table full (%u slots)", (unsigned)idx0);
+        if (out_handle)
+            *out_handle = ihandle_invalid();
+        return NULL;
+    }
 
+    atomic_add_u32(&am->slots_loading, 1u);
     if (out_handle)
-        *out_handle = ihandle_make(am->handle_type, (uint16_t)(idx0 + 1), slot->generation);
+        *out_handle = ihandle_make(am->handle_type, idx0 + 1u, slot->generation);
 
     return slot;
 }
@@ -1263,11 +1712,20 @@ bool asset_manager_init(asset_manager_t *am, const asset_manager_desc_t *desc)
     uint32_t streaming_enabled = 0;
     uint64_t upload_budget_bytes_per_pump = 32ull * 1024ull * 1024ull;
     uint32_t pump_per_frame = 2;
+    uint32_t upload_time_budget_us = 2000;
 
     uint32_t tex_stream_stable_frames = 3;
     uint32_t tex_stream_min_safety_mips_from_bottom = 0;
     uint32_t tex_stream_evict_unused_ms = 2000;
     uint64_t tex_stream_upload_budget_bytes_per_frame = 8ull * 1024ull * 1024ull;
+    uint64_t tex_stream_ram_budget_bytes = 0;
+    uint32_t tex_stream_prefetch_expire_frames = 60;
+    uint32_t io_queue_depth = 32;
+    uint32_t io_backend = ASSET_IO_BACKEND_AUTO;
+    uint32_t prefetch_expire_ms = 1000;
+    uint64_t staging_bytes = 64ull * 1024ull * 1024ull;
+    uint64_t host_budget_bytes = 0;
+    uint32_t host_headroom_pct = 0;
 
     if (desc)
     {
@@ -1289,6 +1747,8 @@ bool asset_manager_init(asset_manager_t *am, const asset_manager_desc_t *desc)
             upload_budget_bytes_per_pump = desc->upload_budget_bytes_per_pump;
         if (desc->pump_per_frame)
             pump_per_frame = desc->pump_per_frame;
+        if (desc->upload_time_budget_us)
+            upload_time_budget_us = desc->upload_time_budget_us;
 
         if (desc->tex_stream_stable_frames)
             tex_stream_stable_frames = desc->tex_stream_stable_frames;
@@ -1297,6 +1757,18 @@ bool asset_manager_init(asset_manager_t *am, const asset_manager_desc_t *desc)
             tex_stream_evict_unused_ms = desc->tex_stream_evict_unused_ms;
         if (desc->tex_stream_upload_budget_bytes_per_frame)
             tex_stream_upload_budget_bytes_per_frame = desc->tex_stream_upload_budget_bytes_per_frame;
+        tex_stream_ram_budget_bytes = desc->tex_stream_ram_budget_bytes;
+        if (desc->tex_stream_prefetch_expire_frames)
+            tex_stream_prefetch_expire_frames = desc->tex_stream_prefetch_expire_frames;
+        if (desc->io_queue_depth)
+            io_queue_depth = desc->io_queue_depth;
+        io_backend = desc->io_backend;
+        if (desc->prefetch_expire_ms)
+            prefetch_expire_ms = desc->prefetch_expire_ms;
+        if (desc->staging_bytes)
+            staging_bytes = desc->staging_bytes;
+        host_budget_bytes = desc->host_budget_bytes;
+        host_headroom_pct = desc->host_headroom_pct;
     }
 
     am->handle_type = ht;
@@ -1307,17 +1779,30 @@ bool asset_manager_init(asset_manager_t *am, const asset_manager_desc_t *desc)
     am->streaming_enabled = streaming_enabled ? 1u : 0u;
     am->upload_budget_bytes_per_pump = upload_budget_bytes_per_pump;
     am->pump_per_frame = (pump_per_frame == 0) ? 1u : pump_per_frame;
+    am->upload_time_budget_us = upload_time_budget_us;
+    am->upload_spent_us = 0;
+    am->upload_bytes_per_ms = ASSET_UPLOAD_BYTES_PER_MS_GUESS;
+    memset(am->init_cost_us, 0, sizeof(am->init_cost_us));
+    am->upload_has_deferred = 0;
+    am->staging_bytes = staging_bytes;
 
     am->tex_stream_stable_frames = tex_stream_stable_frames;
     am->tex_stream_min_safety_mips_from_bottom = tex_stream_min_safety_mips_from_bottom;
     am->tex_stream_evict_unused_ms = tex_stream_evict_unused_ms;
     am->tex_stream_upload_budget_bytes_per_frame = tex_stream_upload_budget_bytes_per_frame;
+    am->tex_stream_ram_budget_bytes = tex_stream_ram_budget_bytes;
+    am->tex_stream_prefetch_expire_frames = tex_stream_prefetch_expire_frames;
+    am->host_budget_bytes = host_budget_bytes;
+    am->host_headroom_pct = host_headroom_pct < 100u ? host_headroom_pct : 99u;
+    am->host_decay_frame = 0;
     am->now_ms = am_time_ms();
     am->unload_scan_index = 0;
 
     memset(&am->stats, 0, sizeof(am->stats));
     am->stats.frame_index = 0;
     am->stats.vram_budget_bytes = am->vram_budget_bytes;
+    am->stats.tex_ram_budget_bytes = am->tex_stream_ram_budget_bytes;
+    am->stats.host_budget_bytes = am->host_budget_bytes;
     am->stats.streaming_enabled = am->streaming_enabled;
     am->stats.tex_stream_uploaded_bytes_last_frame = 0;
     am->stats.tex_stream_evicted_bytes_last_frame = 0;
@@ -1325,14 +1810,37 @@ bool asset_manager_init(asset_manager_t *am, const asset_manager_desc_t *desc)
     am->stats.tex_stream_evictions_last_frame = 0;
     am->stats.tex_stream_pending_uploads = 0;
 
-    am->slots = vector_impl_create_vector(sizeof(asset_slot_t));
-    am->modules = vector_impl_create_vector(sizeof(asset_module_desc_t));
-
-    jobq_init(&am->jobs, cap);
-    doneq_init(&am->done, cap);
+    // Textures compress their payload inside the itex blob; meshes favour decode speed.
+    memset(am->pack_codec, ASSET_CODEC_NONE, sizeof(am->pack_codec));
+    am->pack_codec[ASSET_IMAGE] = ASSET_CODEC_ZSTD;
+    am->pack_codec[ASSET_MODEL] = ASSET_CODEC_LZ4;
+    am->pack_tex_compress = 1;
+    am->mip_filter = ASSET_IMAGE_MIP_FILTER_BOX;
+    am->mip_srgb = 1;
 
-    mutex_init_impl(&am->state_m);
-    am->shutting_down = 0;
+    if (!slot_table_init(&am->slots))
+    {
+        LOG_ERROR("Asset manager: failed to allocate slot table");
+        return false;
+    }
+    am->modules = vector_impl_create_vector(sizeof(asset_module_desc_t));
+    am->packs = vector_impl_create_vector(sizeof(asset_pack_t));
+    am->uploads = vector_impl_create_vector(sizeof(asset_upload_job_t));
+
+    for (uint32_t p = 0; p < ASSET_PRIORITY_COUNT; ++p)
+        asset_ring_init(&am->jobs[p], cap, sizeof(asset_job_t));
+    am->job_ticket_next = 0;
+    am->jobs_stale = 0;
+    am->jobs_deferred = vector_impl_create_vector(sizeof(ihandle_t));
+    am->color_space_reloads = vector_impl_create_vector(sizeof(ihandle_t));
+    am->prefetch_expire_ms = prefetch_expire_ms;
+    asset_ring_init(&am->done, cap, sizeof(asset_done_t));
+    am->done_popped = 0;
+    am->done_parked = 0;
+
+    threads_mutex_init(&am->state_m);
+    threads_mutex_init(&am->build_m);
+    atomic_store_u32(&am->shutting_down, 0u);
     dedupe_init(am, 4096u);
 
     am->prng_state = ((uint64_t)(uintptr_t)am << 1) ^ ((uint64_t)time(NULL) * 0x9E3779B97F4A7C15ull) ^ 0xD1B54A32D192ED03ull;
@@ -1341,69 +1849,540 @@ bool asset_manager_init(asset_manager_t *am, const asset_manager_desc_t *desc)
 
     register_asset_modules(am);
 
-    am->workers = (thread_t *)calloc((size_t)wc, sizeof(thread_t));
     am->worker_count = wc;
+    am->loaders_active = 0;
+    memset(&am->loaders, 0, sizeof(am->loaders));
 
-    for (uint32_t i = 0; i < wc; ++i)
-    {
-        worker_ctx_t *ctx = (worker_ctx_t *)malloc(sizeof(worker_ctx_t));
-        if (!ctx)
-            return false;
-        ctx->am = am;
-        if (!thread_create_impl(&am->workers[i], worker_main, ctx))
-            return false;
-    }
+    // Without an I/O stage every load reads its file on the loader job, as before.
+    if (asset_io_init(&am->io, io_queue_depth, (asset_io_backend_t)io_backend))
+        LOG_INFO("Asset I/O: %s, queue depth %u", asset_io_backend_name(&am->io), (unsigned)am->io.queue_depth);
+    else
+        LOG_WARN("Asset I/O stage unavailable, loaders read files directly");
+
+    asset_mempressure_init(&am->mempressure);
+    asset_mempressure_sample(&am->mempressure, &am->host_seen);
 
     return true;
 }
 
-void asset_manager_shutdown(asset_manager_t *am)
+static uint64_t asset_vram_bytes_if_resident(const asset_any_t *a)
 {
-    mutex_lock_impl(&am->state_m);
-    am->shutting_down = 1;
-    mutex_unlock_impl(&am->state_m);
-
-    mutex_lock_impl(&am->jobs.m);
-    cond_broadcast_impl(&am->jobs.cv);
-    mutex_unlock_impl(&am->jobs.m);
+    if (!a || a->state != ASSET_STATE_READY)
+        return 0;
+    if (a->type != ASSET_IMAGE)
+        return 0;
+    return a->as.image.vram_bytes;
+}
 
-    jobq_drain(&am->jobs);
+static uint64_t asset_host_bytes_if_resident(const asset_any_t *a)
+{
+    if (!a || a->state != ASSET_STATE_READY)
+        return 0;
+
+    uint64_t bytes = sizeof(asset_any_t);
+    if (a->type == ASSET_IMAGE && a->as.image.mips)
+    {
+        bytes += sizeof(asset_image_mip_chain_t) + a->as.image.mips->ram_bytes;
+    }
+    else if (a->type == ASSET_MODEL)
+    {
+        const vector_t *meshes = &a->as.model.meshes;
+        bytes += (uint64_t)meshes->capacity * meshes->element_size;
+        for (uint32_t i = 0; i < meshes->size; ++i)
+        {
+            const mesh_t *m = (const mesh_t *)vector_impl_at((vector_t *)meshes, i);
+            bytes += (uint64_t)m->lods.capacity * m->lods.element_size;
+        }
+    }
+    return bytes;
+}
 
-    for (uint32_t i = 0; i < am->worker_count; ++i)
-        thread_join_impl(&am->workers[i]);
+// Host memory an unload gives back. Only decoded mip levels count: a READY model keeps nothing but
+// GL handles once its LODs are uploaded, and the asset struct stays in its slot either way.
+static uint64_t asset_host_reclaimable_bytes(const asset_any_t *a)
+{
+    if (!a || a->state != ASSET_STATE_READY || a->type != ASSET_IMAGE || !a->as.image.mips)
+        return 0;
+    return a->as.image.mips->ram_bytes;
+}
 
-    free(am->workers);
-    am->workers = NULL;
-    am->worker_count = 0;
+// Drops a READY asset back to EMPTY; the next touch or request loads it again. Returns the
+// VRAM it held.
+static uint64_t asset_unload_slot_locked(asset_manager_t *am, asset_slot_t *s)
+{
+    const uint64_t bytes = asset_vram_bytes_if_resident(&s->asset);
+
+    atomic_store_u32(&s->published, 0u);
+    asset_cleanup_by_module(am, &s->asset, s->module_index);
+    s->asset.type = (asset_type_t)s->requested_type;
+    s->asset.state = ASSET_STATE_EMPTY;
+    slot_state_changed_locked(am, s);
+    memset(&s->asset.as, 0, sizeof(s->asset.as));
+    s->module_index = 0xFFFFu;
+    s->inflight = 0;
+
+    if (bytes)
+    {
+        if (am->stats.vram_resident_bytes >= bytes)
+            am->stats.vram_resident_bytes -= bytes;
+        else
+            am->stats.vram_resident_bytes = 0;
+
+        if (am->stats.textures_resident)
+            am->stats.textures_resident--;
+
+        am->stats.evicted_bytes_last_pump += bytes;
+        am->stats.textures_evicted_total++;
+    }
+    return bytes;
+}
+
+static void asset_pump_fail(asset_manager_t *am, asset_done_t *d)
+{
+    asset_any_t old;
+    asset_zero(&old);
+
+    threads_mutex_lock(&am->state_m);
+    asset_slot_t *slot = NULL;
+    if (slot_valid_locked(am, d->handle, &slot))
+    {
+        old = slot->asset;
+        slot_cleanup_asset_only(am, slot);
+        asset_zero(&slot->asset);
+        slot->asset.state = ASSET_STATE_FAILED;
+        slot_state_changed_locked(am, slot);
+        slot->module_index = 0xFFFFu;
+        slot->asset.type = (asset_type_t)slot->requested_type;
+        slot->inflight = 0;
+    }
+    threads_mutex_unlock(&am->state_m);
 
+    asset_cleanup_by_module(am, &old, 0xFFFFu);
+    asset_cleanup_by_module(am, &d->asset, d->module_index);
+}
+
+static void asset_pump_publish(asset_manager_t *am, asset_done_t *d)
+{
+    asset_any_t old;
+    asset_zero(&old);
+    bool taken = false;
+
+    threads_mutex_lock(&am->state_m);
+    asset_slot_t *slot = NULL;
+    if (slot_valid_locked(am, d->handle, &slot))
+    {
+        uint64_t old_vram = asset_vram_bytes_if_resident(&slot->asset);
+        uint64_t new_vram = asset_vram_bytes_if_resident(&d->asset);
+
+        old = slot->asset;
+        slot_cleanup_asset_only(am, slot);
+
+        ihandle_t ph = d->persistent;
+        if (!ihandle_is_valid(ph))
+            ph = make_persistent_handle(am, d->asset.type);
+
+        d->asset.state = ASSET_STATE_READY;
+        slot->asset = d->asset;
+        slot->module_index = d->module_index;
+        slot->inflight = 0;
+        if (!ihandle_is_valid(slot->persistent))
+            slot->persistent = ph;
+        if (slot->asset.type == ASSET_MATERIAL)
+            asset_dep_add_material_locked(am, d->handle, &slot->asset.as.material);
+        slot_state_changed_locked(am, slot);
+        slot_publish_ready_locked(slot);
+
+        if (old_vram)
+        {
+            if (am->stats.vram_resident_bytes >= old_vram)
+                am->stats.vram_resident_bytes -= old_vram;
+            else
+                am->stats.vram_resident_bytes = 0;
+            if (am->stats.textures_resident)
+                am->stats.textures_resident--;
+        }
+
+        if (new_vram)
+        {
+            am->stats.vram_resident_bytes += new_vram;
+            am->stats.textures_resident++;
+            am->stats.upload_bytes_last_pump += new_vram;
+            am->stats.textures_loaded_total++;
+        }
+
+        asset_zero(&d->asset);
+        d->persistent = ihandle_invalid();
+        taken = true;
+    }
+    threads_mutex_unlock(&am->state_m);
+
+    asset_cleanup_by_module(am, &old, 0xFFFFu);
+    if (!taken)
+        asset_cleanup_by_module(am, &d->asset, d->module_index);
+}
+
+// Advances one sliced upload. Returns true once it has left the list's care (published or failed).
+static bool asset_upload_step(asset_manager_t *am, asset_upload_job_t *u, uint64_t budget_bytes)
+{
+    const asset_module_desc_t *mod = asset_manager_get_module_by_index(am, u->done.module_index);
+
+    threads_mutex_lock(&am->state_m);
+    bool live = slot_valid_locked(am, u->done.handle, NULL);
+    threads_mutex_unlock(&am->state_m);
+
+    if (!live || !mod || !mod->upload_fn || atomic_load_u32(&am->shutting_down))
+        budget_bytes = 0;
+
+    asset_upload_status_t st = ASSET_UPLOAD_FAILED;
+    if (mod && mod->upload_fn)
+        st = mod->upload_fn(am, &u->done.asset, &u->up, budget_bytes);
+
+    if (st == ASSET_UPLOAD_MORE)
+        return false;
+
+    if (st == ASSET_UPLOAD_DONE)
+        asset_pump_publish(am, &u->done);
+    else
+        asset_pump_fail(am, &u->done);
+    return true;
+}
+
+// Continues sliced uploads oldest first until the frame's time budget is gone.
+static void asset_pump_uploads(asset_manager_t *am)
+{
+    uint32_t i = 0;
+    while (i < am->uploads.size)
+    {
+        if (!asset_upload_remaining_us(am))
+            break;
+
+        uint64_t budget = asset_upload_budget_bytes(am);
+        if (budget < ASSET_UPLOAD_MIN_SLICE_BYTES)
+            budget = ASSET_UPLOAD_MIN_SLICE_BYTES;
+
+        asset_upload_job_t *u = (asset_upload_job_t *)vector_impl_at(&am->uploads, i);
+        const uint64_t before = u->up.bytes_done;
+        const uint64_t t0 = am_time_us();
+        const bool finished = asset_upload_step(am, u, budget);
+        const uint64_t dt = am_time_us() - t0;
+
+        asset_upload_note(am, finished ? 0 : u->up.bytes_done - before, dt);
+        if (finished)
+            vector_impl_remove_at(&am->uploads, i);
+        else
+            ++i;
+    }
+}
+
+static void asset_uploads_abort(asset_manager_t *am)
+{
+    for (uint32_t i = 0; i < am->uploads.size; ++i)
+        asset_upload_step(am, (asset_upload_job_t *)vector_impl_at(&am->uploads, i), 0);
+    vector_impl_clear(&am->uploads);
+
+    if (am->upload_has_deferred)
+    {
+        asset_cleanup_by_module(am, &am->upload_deferred.asset, am->upload_deferred.module_index);
+        am->upload_has_deferred = 0;
+    }
+}
+
+void asset_manager_shutdown(asset_manager_t *am)
+{
+    atomic_store_u32(&am->shutting_down, 1u);
+
+    for (uint32_t p = 0; p < ASSET_PRIORITY_COUNT; ++p)
+        jobq_drain(&am->jobs[p]);
+
+    // Loaders may be parked on a full done queue; keep draining it until they have all retired.
     asset_done_t d;
-    while (doneq_pop(&am->done, &d))
+    while (!jobs_counter_done(&am->loaders))
+    {
+        if (doneq_pop(am, &d))
+            asset_cleanup_by_module(am, &d.asset, d.module_index);
+        else
+            threads_yield();
+    }
+    jobs_wait(&am->loaders);
+    am->worker_count = 0;
+
+    // Reads already issued still complete and queue decode jobs; those see shutting_down and
+    // just drop their buffers.
+    asset_io_shutdown(&am->io);
+    jobs_wait(&am->loaders);
+    asset_mempressure_shutdown(&am->mempressure);
+
+    while (doneq_pop(am, &d))
         asset_cleanup_by_module(am, &d.asset, d.module_index);
 
-    mutex_lock_impl(&am->state_m);
+    // Partial uploads may reference pack mappings, which are unmapped below.
+    asset_uploads_abort(am);
+    vector_impl_free(&am->uploads);
+
+    threads_mutex_lock(&am->state_m);
     for (uint32_t i = 0; i < am->slots.size; ++i)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
+        asset_slot_t *s = slot_at(&am->slots, i);
         slot_destroy(am, s);
     }
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_unlock(&am->state_m);
 
-    jobq_destroy(&am->jobs);
-    doneq_destroy(&am->done);
+    atomic_store_u32(&am->staging_ready, 0u);
+    asset_staging_shutdown(&am->staging);
+
+    for (uint32_t p = 0; p < ASSET_PRIORITY_COUNT; ++p)
+    {
+        jobq_drain(&am->jobs[p]);
+        asset_ring_destroy(&am->jobs[p]);
+    }
+    vector_impl_free(&am->jobs_deferred);
+    vector_impl_free(&am->color_space_reloads);
+    asset_ring_destroy(&am->done);
 
     vector_impl_free(&am->modules);
-    vector_impl_free(&am->slots);
+    slot_table_free(&am->slots);
+
+    for (uint32_t i = 0; i < am->packs.size; ++i)
+        pack_unmap((asset_pack_t *)vector_impl_at(&am->packs, i));
+    vector_impl_free(&am->packs);
 
-    mutex_destroy_impl(&am->state_m);
+    free(am->build_cache_dir);
+    am->build_cache_dir = NULL;
+
+    threads_mutex_destroy(&am->build_m);
+    threads_mutex_destroy(&am->state_m);
     dedupe_destroy(am);
     memset(am, 0, sizeof(*am));
 }
 
-ihandle_t asset_manager_request(asset_manager_t *am, asset_type_t type, const char *path)
+// Makes the slot's entry in `priority` the live one; the previous live entry turns stale.
+static void slot_queue_move_locked(asset_manager_t *am, asset_slot_t *slot, uint32_t priority)
+{
+    if (slot->queued_mask & (1u << slot->priority))
+        atomic_add_u32(&am->jobs_stale, 1u);
+    if (slot->queued_mask & (1u << priority))
+        atomic_sub_u32(&am->jobs_stale, 1u);
+    slot->priority = (uint8_t)priority;
+}
+
+// Forgets the slot's queued load; its ring entries are dropped by the loaders.
+static void slot_queue_drop_locked(asset_manager_t *am, asset_slot_t *slot)
+{
+    if (slot->queued_mask & (1u << slot->priority))
+        atomic_add_u32(&am->jobs_stale, 1u);
+    slot->queued_mask = 0;
+    slot->job_ticket = 0;
+}
+
+// Pushes a ring entry for the slot's current load (job_ticket) and makes it the live one.
+static bool asset_queue_slot_locked(asset_manager_t *am, ihandle_t h, asset_slot_t *slot, uint32_t priority)
+{
+    asset_job_t j;
+    memset(&j, 0, sizeof(j));
+    j.handle = h;
+    j.persistent = slot->persistent;
+    j.type = (asset_type_t)slot->requested_type;
+    j.path_is_ptr = 0;
+    j.priority = (uint8_t)priority;
+    j.ticket = slot->job_ticket;
+
+    size_t n = strlen(slot->path);
+    j.path = (char *)malloc(n + 1);
+    if (!j.path)
+        return false;
+    memcpy(j.path, slot->path, n + 1);
+
+    if (!jobq_push(&am->jobs[priority], &j))
+    {
+        free(j.path);
+        return false;
+    }
+
+    slot_queue_move_locked(am, slot, priority);
+    slot->queued_mask |= (uint8_t)(1u << priority);
+    return true;
+}
+
+// The ring was full (or the job could not be built): the slot stays LOADING and pump pushes it
+// once loaders have made room, so a burst of requests never turns into FAILED assets.
+static void asset_defer_slot_locked(asset_manager_t *am, ihandle_t h, asset_slot_t *slot, uint32_t priority)
+{
+    slot->priority = (uint8_t)priority;
+    vector_impl_push_back(&am->jobs_deferred, &h);
+    am->stats.jobs_deferred = am->jobs_deferred.size;
+}
+
+static void asset_manager_touch_priority(asset_manager_t *am, ihandle_t h, asset_priority_t priority);
+
+// Images decoded before a material said what they hold are loaded again from their file, so their
+// mips are rebuilt for the right color space. Unloading deletes GL objects, so this runs in pump.
+static void asset_reload_color_spaces(asset_manager_t *am)
+{
+    threads_mutex_lock(&am->state_m);
+    const uint32_t count = am->color_space_reloads.size;
+    if (!count)
+    {
+        threads_mutex_unlock(&am->state_m);
+        return;
+    }
+
+    vector_t reload = vector_impl_create_vector(sizeof(ihandle_t));
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const ihandle_t h = *(const ihandle_t *)vector_impl_at(&am->color_space_reloads, i);
+        asset_slot_t *s = NULL;
+        if (!slot_valid_locked(am, h, &s) || s->color_space_decoded == s->color_space + 1u)
+            continue;
+        // Files only: a pointer request's bytes are gone once it has loaded.
+        if ((s->flags & ASSET_FLAG_NO_UNLOAD) || s->path_is_ptr || !s->path || !s->path[0])
+            continue;
+
+        const bool busy = s->inflight || s->save_pins || (s->asset.type == ASSET_IMAGE && s->asset.as.image.stream_page_inflight);
+        if (s->asset.state == ASSET_STATE_READY && !busy)
+        {
+            asset_unload_slot_locked(am, s);
+            vector_impl_push_back(&reload, &h);
+        }
+        else if (s->asset.state == ASSET_STATE_READY || s->asset.state == ASSET_STATE_LOADING)
+        {
+            *(ihandle_t *)vector_impl_at(&am->color_space_reloads, kept++) = h;
+        }
+    }
+    vector_impl_resize(&am->color_space_reloads, kept, NULL);
+    threads_mutex_unlock(&am->state_m);
+
+    for (uint32_t i = 0; i < reload.size; ++i)
+        asset_manager_touch_priority(am, *(const ihandle_t *)vector_impl_at(&reload, i), ASSET_PRIORITY_NORMAL);
+    vector_impl_free(&reload);
+}
+
+static void asset_push_deferred(asset_manager_t *am)
+{
+    threads_mutex_lock(&am->state_m);
+    const uint32_t count = am->jobs_deferred.size;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const ihandle_t h = *(const ihandle_t *)vector_impl_at(&am->jobs_deferred, i);
+        asset_slot_t *s = NULL;
+        // Cancelled meanwhile, or already queued by a requeue.
+        if (!slot_valid_locked(am, h, &s) || !s->inflight || !s->job_ticket || s->queued_mask)
+            continue;
+        if (!asset_queue_slot_locked(am, h, s, s->priority))
+            *(ihandle_t *)vector_impl_at(&am->jobs_deferred, kept++) = h;
+    }
+    if (kept != count)
+        vector_impl_resize(&am->jobs_deferred, kept, NULL);
+    am->stats.jobs_deferred = kept;
+    threads_mutex_unlock(&am->state_m);
+
+    if (kept != count)
+        asset_kick_loaders(am);
+}
+
+// Moves a job that is still queued into another priority class. Each class holds at most one entry
+// per load: an entry left in the target ring by an earlier move becomes live again instead of a
+// new one being pushed, and a raise reuses any entry that is already at least as urgent. Loaders
+// drop the entries that are not live when they reach them.
+static bool asset_requeue_locked(asset_manager_t *am, ihandle_t h, asset_slot_t *slot, asset_priority_t priority, bool raise_only)
+{
+    if (slot->path_is_ptr || !slot->path || !slot->inflight || !slot->job_ticket)
+        return false;
+
+    uint32_t target = (uint32_t)priority;
+    const uint32_t urgent = raise_only ? slot->queued_mask & ((2u << target) - 1u) : 0u;
+    if (urgent)
+    {
+        target = 0;
+        while (!(urgent & (1u << target)))
+            ++target;
+    }
+    if (target == slot->priority)
+        return false;
+
+    if (!(slot->queued_mask & (1u << target)) && !asset_queue_slot_locked(am, h, slot, target))
+    {
+        // A deferred load has no entry yet; it is pushed into the new class later.
+        if (!slot->queued_mask)
+            slot->priority = (uint8_t)target;
+        return false;
+    }
+
+    slot_queue_move_locked(am, slot, target);
+    am->stats.jobs_requeued_total++;
+    return true;
+}
+
+static void asset_manager_touch_priority(asset_manager_t *am, ihandle_t h, asset_priority_t priority)
+{
+    if (!am || !ihandle_is_valid(h))
+        return;
+
+    const uint64_t now_ms = am_time_ms();
+
+    threads_mutex_lock(&am->state_m);
+    asset_slot_t *slot = NULL;
+    if (!slot_valid_locked(am, h, &slot) || !slot)
+    {
+        threads_mutex_unlock(&am->state_m);
+        return;
+    }
+
+    slot_note_use(am, slot, now_ms);
+
+    // Touching only ever raises the priority of a queued load; asset_manager_set_priority can lower it.
+    if (slot->inflight)
+    {
+        bool requeued = priority < slot->priority && asset_requeue_locked(am, h, slot, priority, true);
+        threads_mutex_unlock(&am->state_m);
+        if (requeued)
+            asset_kick_loaders(am);
+        return;
+    }
+
+    // A cancelled load leaves the slot EMPTY, so it reloads on the next touch even without streaming.
+    const uint32_t has_path = (slot->path_is_ptr == 0) && (slot->path && slot->path[0]);
+    const uint32_t can_reload = has_path && (am->streaming_enabled != 0 || slot->asset.state == ASSET_STATE_EMPTY);
+
+    const uint32_t should_reload = (slot->asset.state == ASSET_STATE_EMPTY || slot->asset.state == ASSET_STATE_LOADING);
+
+    if (!can_reload || !should_reload)
+    {
+        threads_mutex_unlock(&am->state_m);
+        return;
+    }
+
+    slot->inflight = 1;
+    slot->job_ticket = job_ticket_next_locked(am);
+    slot->queued_mask = 0;
+    slot->asset.type = (asset_type_t)slot->requested_type;
+    slot->asset.state = ASSET_STATE_LOADING;
+    slot_state_changed_locked(am, slot);
+    if (!asset_queue_slot_locked(am, h, slot, (uint32_t)priority))
+        asset_defer_slot_locked(am, h, slot, (uint32_t)priority);
+    am->stats.textures_reloaded_total++;
+    threads_mutex_unlock(&am->state_m);
+
+    asset_kick_loaders(am);
+}
+
+static ihandle_t asset_request_path(asset_manager_t *am, asset_type_t type, const char *path, asset_priority_t priority)
 {
     if (!am || !path || !path[0])
         return ihandle_invalid();
+    if ((uint32_t)priority >= ASSET_PRIORITY_COUNT)
+        priority = ASSET_PRIORITY_NORMAL;
+
+    const uint64_t now_ms = am_time_ms();
+    const ihandle_t persistent = make_persistent_handle_from_job(type, path, 0u);
+    const uint64_t pkey = pack_persistent_key(persistent);
 
+    threads_mutex_lock(&am->state_m);
+    bool packed = pack_find_locked(am, pkey, NULL);
+    threads_mutex_unlock(&am->state_m);
+
+    if (!packed)
     {
         FILE *f = fopen(path, "rb");
         if (!f)
@@ -1414,15 +2393,11 @@ ihandle_t asset_manager_request(asset_manager_t *am, asset_type_t type, const ch
         fclose(f);
     }
 
-    const uint64_t now_ms = am_time_ms();
-    const ihandle_t persistent = make_persistent_handle_from_job(type, path, 0u);
-    const uint64_t pkey = pack_persistent_key(persistent);
-
-    mutex_lock_impl(&am->state_m);
-    uint32_t sd = am->shutting_down;
+    threads_mutex_lock(&am->state_m);
+    uint32_t sd = atomic_load_u32(&am->shutting_down);
     if (sd)
     {
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
         return ihandle_invalid();
     }
 
@@ -1434,15 +2409,14 @@ ihandle_t asset_manager_request(asset_manager_t *am, asset_type_t type, const ch
             uint32_t i = idx1 - 1u;
             if (i < am->slots.size)
             {
-                asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
+                asset_slot_t *s = slot_at(&am->slots, i);
                 if (s && !s->path_is_ptr && (asset_type_t)s->requested_type == type && s->path && s->path[0] && path_norm_eq(s->path, path))
                 {
-                    s->last_touched_frame = am->frame_index;
-                    s->last_requested_ms = now_ms;
+                    slot_note_use(am, s, now_ms);
 
-                    ihandle_t existing = ihandle_make(am->handle_type, (uint16_t)(i + 1u), s->generation);
-                    mutex_unlock_impl(&am->state_m);
-                    asset_manager_touch(am, existing);
+                    ihandle_t existing = ihandle_make(am->handle_type, i + 1u, s->generation);
+                    threads_mutex_unlock(&am->state_m);
+                    asset_manager_touch_priority(am, existing, priority);
                     return existing;
                 }
             }
@@ -1451,68 +2425,56 @@ ihandle_t asset_manager_request(asset_manager_t *am, asset_type_t type, const ch
 
     ihandle_t h;
     asset_slot_t *slot = alloc_slot_locked(am, type, &h);
-    if (slot)
+    if (!slot)
     {
-        slot->path_is_ptr = 0;
-        slot->inflight = 1;
-        slot->requested_type = (uint16_t)type;
-        slot->last_touched_frame = am->frame_index;
-        slot->last_requested_ms = now_ms;
-        slot->persistent = persistent;
-        dedupe_insert_locked(am, pkey, (uint32_t)ihandle_index(h));
-
-        size_t pn = strlen(path);
-        slot->path = (char *)malloc(pn + 1);
-        if (slot->path)
-        {
-            memcpy(slot->path, path, pn + 1);
-        }
+        threads_mutex_unlock(&am->state_m);
+        return ihandle_invalid();
     }
-    mutex_unlock_impl(&am->state_m);
-
-    asset_job_t j;
-    memset(&j, 0, sizeof(j));
-    j.handle = h;
-    j.type = type;
-    j.path_is_ptr = 0;
 
-    size_t n = strlen(path);
-    j.path = (char *)malloc(n + 1);
-    if (!j.path)
+    slot->path_is_ptr = 0;
+    slot->inflight = 1;
+    slot->requested_type = (uint16_t)type;
+    slot_note_use(am, slot, now_ms);
+    slot->persistent = persistent;
+    slot->priority = (uint8_t)priority;
+    slot->job_ticket = job_ticket_next_locked(am);
+    dedupe_insert_locked(am, pkey, (uint32_t)ihandle_index(h));
+
+    size_t pn = strlen(path);
+    slot->path = (char *)malloc(pn + 1);
+    if (!slot->path)
     {
-        mutex_lock_impl(&am->state_m);
-        asset_slot_t *s = NULL;
-        if (slot_valid_locked(am, h, &s))
-        {
-            s->asset.state = ASSET_STATE_FAILED;
-            s->module_index = 0xFFFFu;
-        }
-        mutex_unlock_impl(&am->state_m);
+        slot->asset.state = ASSET_STATE_FAILED;
+        slot_state_changed_locked(am, slot);
+        slot->module_index = 0xFFFFu;
+        slot->inflight = 0;
+        slot->job_ticket = 0;
+        threads_mutex_unlock(&am->state_m);
         return ihandle_invalid();
     }
-    memcpy(j.path, path, n + 1);
-
-    if (!jobq_push(&am->jobs, &j))
-    {
-        free(j.path);
+    memcpy(slot->path, path, pn + 1);
 
-        mutex_lock_impl(&am->state_m);
-        asset_slot_t *s = NULL;
-        if (slot_valid_locked(am, h, &s))
-        {
-            s->asset.state = ASSET_STATE_FAILED;
-            s->module_index = 0xFFFFu;
-            s->inflight = 0;
-        }
-        mutex_unlock_impl(&am->state_m);
+    if (!asset_queue_slot_locked(am, h, slot, (uint32_t)priority))
+        asset_defer_slot_locked(am, h, slot, (uint32_t)priority);
+    threads_mutex_unlock(&am->state_m);
 
-        return ihandle_invalid();
-    }
+    asset_kick_loaders(am);
+    return h;
+}
 
+ihandle_t asset_manager_request_ex(asset_manager_t *am, asset_type_t type, const char *path, asset_priority_t priority)
+{
+    ihandle_t h = asset_request_path(am, type, path, priority);
+    asset_dep_note_request(am, h);
     return h;
 }
 
-ihandle_t asset_manager_request_ptr(asset_manager_t *am, asset_type_t type, void *ptr)
+ihandle_t asset_manager_request(asset_manager_t *am, asset_type_t type, const char *path)
+{
+    return asset_manager_request_ex(am, type, path, ASSET_PRIORITY_NORMAL);
+}
+
+static ihandle_t asset_request_ptr(asset_manager_t *am, asset_type_t type, void *ptr)
 {
     if (!am || !ptr)
         return ihandle_invalid();
@@ -1521,11 +2483,11 @@ ihandle_t asset_manager_request_ptr(asset_manager_t *am, asset_type_t type, void
     const ihandle_t persistent = make_persistent_handle_from_job(type, (const char *)ptr, 1u);
     const uint64_t pkey = pack_persistent_key(persistent);
 
-    mutex_lock_impl(&am->state_m);
-    uint32_t sd = am->shutting_down;
+    threads_mutex_lock(&am->state_m);
+    uint32_t sd = atomic_load_u32(&am->shutting_down);
     if (sd)
     {
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
         return ihandle_invalid();
     }
 
@@ -1537,14 +2499,13 @@ ihandle_t asset_manager_request_ptr(asset_manager_t *am, asset_type_t type, void
             uint32_t i = idx1 - 1u;
             if (i < am->slots.size)
             {
-                asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
+                asset_slot_t *s = slot_at(&am->slots, i);
                 if (s && s->path_is_ptr && (asset_type_t)s->requested_type == type && ihandle_is_valid(s->persistent) && ihandle_eq(s->persistent, persistent))
                 {
-                    s->last_touched_frame = am->frame_index;
-                    s->last_requested_ms = now_ms;
+                    slot_note_use(am, s, now_ms);
 
-                    ihandle_t existing = ihandle_make(am->handle_type, (uint16_t)(i + 1u), s->generation);
-                    mutex_unlock_impl(&am->state_m);
+                    ihandle_t existing = ihandle_make(am->handle_type, i + 1u, s->generation);
+                    threads_mutex_unlock(&am->state_m);
 
                     if (type == ASSET_IMAGE)
                         free_image_mem_desc_ptr(ptr);
@@ -1562,66 +2523,77 @@ ihandle_t asset_manager_request_ptr(asset_manager_t *am, asset_type_t type, void
         slot->path = (char *)ptr;
         slot->path_is_ptr = 1;
         slot->inflight = 1;
+        slot->priority = ASSET_PRIORITY_NORMAL;
         slot->requested_type = (uint16_t)type;
-        slot->last_touched_frame = am->frame_index;
-        slot->last_requested_ms = now_ms;
+        slot_note_use(am, slot, now_ms);
         slot->persistent = persistent;
         dedupe_insert_locked(am, pkey, (uint32_t)ihandle_index(h));
     }
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_unlock(&am->state_m);
 
     asset_job_t j;
     memset(&j, 0, sizeof(j));
     j.handle = h;
+    j.persistent = persistent;
     j.type = type;
     j.path = (char *)ptr;
     j.path_is_ptr = 1;
+    j.priority = ASSET_PRIORITY_NORMAL;
 
-    if (!jobq_push(&am->jobs, &j))
+    if (!jobq_push(&am->jobs[ASSET_PRIORITY_NORMAL], &j))
     {
-        mutex_lock_impl(&am->state_m);
+        threads_mutex_lock(&am->state_m);
         asset_slot_t *s = NULL;
         if (slot_valid_locked(am, h, &s))
         {
             s->asset.state = ASSET_STATE_FAILED;
+            slot_state_changed_locked(am, s);
             s->module_index = 0xFFFFu;
             s->inflight = 0;
         }
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
 
         return ihandle_invalid();
     }
 
+    asset_kick_loaders(am);
     return h;
 }
 
-ihandle_t asset_manager_submit_raw(asset_manager_t *am, asset_type_t type, const void *raw_asset)
+ihandle_t asset_manager_request_ptr(asset_manager_t *am, asset_type_t type, void *ptr)
+{
+    ihandle_t h = asset_request_ptr(am, type, ptr);
+    asset_dep_note_request(am, h);
+    return h;
+}
+
+static ihandle_t asset_submit_raw(asset_manager_t *am, asset_type_t type, const void *raw_asset)
 {
     if (!am || !raw_asset || type == ASSET_NONE)
         return ihandle_invalid();
 
     const uint64_t now_ms = am_time_ms();
 
-    mutex_lock_impl(&am->state_m);
-    uint32_t sd = am->shutting_down;
+    threads_mutex_lock(&am->state_m);
+    uint32_t sd = atomic_load_u32(&am->shutting_down);
     if (sd)
     {
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
         return ihandle_invalid();
     }
 
     uint32_t midx32 = asset_manager_find_first_module_index(am, type);
     if (midx32 == 0xFFFFFFFFu)
     {
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
         return ihandle_invalid();
     }
 
     ihandle_t h;
     asset_slot_t *slot = alloc_slot_locked(am, type, &h);
     if (slot)
-        slot->last_requested_ms = now_ms;
-    mutex_unlock_impl(&am->state_m);
+        atomic_store_u64(&slot->last_requested_ms, now_ms);
+    threads_mutex_unlock(&am->state_m);
 
     if (!slot)
         return ihandle_invalid();
@@ -1629,10 +2601,11 @@ ihandle_t asset_manager_submit_raw(asset_manager_t *am, asset_type_t type, const
     asset_any_t a;
     if (!asset_from_raw(type, raw_asset, &a))
     {
-        mutex_lock_impl(&am->state_m);
+        threads_mutex_lock(&am->state_m);
         slot->asset.state = ASSET_STATE_FAILED;
+        slot_state_changed_locked(am, slot);
         slot->module_index = 0xFFFFu;
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
         return ihandle_invalid();
     }
 
@@ -1645,25 +2618,37 @@ ihandle_t asset_manager_submit_raw(asset_manager_t *am, asset_type_t type, const
     {
         asset_cleanup_by_module(am, &a, (uint16_t)midx32);
 
-        mutex_lock_impl(&am->state_m);
+        threads_mutex_lock(&am->state_m);
         slot_cleanup_asset_only(am, slot);
         slot->asset.state = ASSET_STATE_FAILED;
+        slot_state_changed_locked(am, slot);
         slot->module_index = 0xFFFFu;
         slot->inflight = 0;
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
 
         return ihandle_invalid();
     }
 
-    mutex_lock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
     slot_cleanup_asset_only(am, slot);
     a.state = ASSET_STATE_READY;
     slot->asset = a;
     slot->module_index = (uint16_t)midx32;
     slot->persistent = make_persistent_handle(am, type);
     slot->inflight = 0;
-    mutex_unlock_impl(&am->state_m);
+    if (type == ASSET_MATERIAL)
+        asset_dep_add_material_locked(am, h, &slot->asset.as.material);
+    slot_state_changed_locked(am, slot);
+    slot_publish_ready_locked(slot);
+    threads_mutex_unlock(&am->state_m);
+
+    return h;
+}
 
+ihandle_t asset_manager_submit_raw(asset_manager_t *am, asset_type_t type, const void *raw_asset)
+{
+    ihandle_t h = asset_submit_raw(am, type, raw_asset);
+    asset_dep_note_request(am, h);
     return h;
 }
 
@@ -1671,29 +2656,45 @@ void asset_manager_set_streaming(asset_manager_t *am, uint32_t enabled, uint64_t
 {
     if (!am)
         return;
-    mutex_lock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
     am->streaming_enabled = enabled ? 1u : 0u;
     am->vram_budget_bytes = vram_budget_bytes;
     am->stream_unused_frames = unused_frames;
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_unlock(&am->state_m);
 }
 
-void asset_manager_set_upload_budget(asset_manager_t *am, uint64_t bytes_per_pump)
+bool asset_manager_get_streaming(const asset_manager_t *am)
+{
+    return am && am->streaming_enabled;
+}
+
+void asset_manager_set_tex_ram_budget(asset_manager_t *am, uint64_t bytes)
 {
     if (!am)
         return;
-    mutex_lock_impl(&am->state_m);
-    am->upload_budget_bytes_per_pump = bytes_per_pump;
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
+    am->tex_stream_ram_budget_bytes = bytes;
+    am->stats.tex_ram_budget_bytes = bytes;
+    threads_mutex_unlock(&am->state_m);
 }
 
-static uint64_t asset_vram_bytes_if_resident(const asset_any_t *a)
+void asset_manager_set_host_budget(asset_manager_t *am, uint64_t bytes)
 {
-    if (!a || a->state != ASSET_STATE_READY)
-        return 0;
-    if (a->type != ASSET_IMAGE)
-        return 0;
-    return a->as.image.vram_bytes;
+    if (!am)
+        return;
+    threads_mutex_lock(&am->state_m);
+    am->host_budget_bytes = bytes;
+    am->stats.host_budget_bytes = bytes;
+    threads_mutex_unlock(&am->state_m);
+}
+
+void asset_manager_set_upload_budget(asset_manager_t *am, uint64_t bytes_per_pump)
+{
+    if (!am)
+        return;
+    threads_mutex_lock(&am->state_m);
+    am->upload_budget_bytes_per_pump = bytes_per_pump;
+    threads_mutex_unlock(&am->state_m);
 }
 
 typedef struct am_evict_cand_t
@@ -1758,6 +2759,49 @@ static uint32_t asset_image_desired_top_mip(const asset_image_t *img, float scre
     return mip;
 }
 
+// Returns the image behind a READY streamed texture slot, or NULL. Caller holds state_m.
+static asset_image_t *asset_image_stream_slot_locked(asset_manager_t *am, ihandle_t image, asset_slot_t **out_slot)
+{
+    asset_slot_t *slot = NULL;
+    if (!slot_valid_locked(am, image, &slot) || !slot)
+        return NULL;
+    if (slot->asset.type != ASSET_IMAGE || slot->asset.state != ASSET_STATE_READY)
+        return NULL;
+    if (slot->asset.as.image.mip_count == 0)
+        return NULL;
+    *out_slot = slot;
+    return &slot->asset.as.image;
+}
+
+static void asset_image_stream_aggregate_locked(asset_manager_t *am, asset_slot_t *slot, asset_image_t *img, uint32_t desired, uint16_t priority)
+{
+    uint16_t p = priority;
+    if (slot->flags & ASSET_FLAG_NO_UNLOAD)
+        p = (uint16_t)65535u;
+
+    if (img->stream_best_target_mip_frame != (uint32_t)am->frame_index)
+    {
+        img->stream_best_target_mip_frame = (uint32_t)am->frame_index;
+        img->stream_best_target_mip = desired;
+    }
+    else
+    {
+        if (desired < img->stream_best_target_mip)
+            img->stream_best_target_mip = desired;
+    }
+
+    if (img->stream_best_priority_frame != (uint32_t)am->frame_index)
+    {
+        img->stream_best_priority_frame = (uint32_t)am->frame_index;
+        img->stream_best_priority = p;
+    }
+    else
+    {
+        if (p > img->stream_best_priority)
+            img->stream_best_priority = p;
+    }
+}
+
 void asset_manager_image_stream_record_use(asset_manager_t *am, ihandle_t image, float screen_coverage_px, float uv_scale, uint16_t priority)
 {
     if (!am || !ihandle_is_valid(image))
@@ -1766,60 +2810,65 @@ void asset_manager_image_stream_record_use(asset_manager_t *am, ihandle_t image,
     // Touch to keep the asset warm / queued for load if needed.
     asset_manager_touch(am, image);
 
-    mutex_lock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
 
     asset_slot_t *slot = NULL;
-    if (!slot_valid_locked(am, image, &slot) || !slot)
-    {
-        mutex_unlock_impl(&am->state_m);
-        return;
-    }
-
-    if (slot->asset.type != ASSET_IMAGE || slot->asset.state != ASSET_STATE_READY)
+    asset_image_t *img = asset_image_stream_slot_locked(am, image, &slot);
+    if (!img)
     {
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
         return;
     }
 
-    asset_image_t *img = &slot->asset.as.image;
-    if (img->mip_count == 0)
+    if (img->stream_prefetch_frame)
     {
-        mutex_unlock_impl(&am->state_m);
-        return;
+        am->stats.tex_prefetch_hits_total++;
+        img->stream_prefetch_frame = 0;
+        img->stream_prefetch_bytes = 0;
     }
 
     img->stream_last_used_frame = am->frame_index;
     img->stream_last_used_ms = am->now_ms;
 
-    uint16_t p = priority;
-    if (slot->flags & ASSET_FLAG_NO_UNLOAD)
-        p = (uint16_t)65535u;
+    asset_image_stream_aggregate_locked(am, slot, img, asset_image_desired_top_mip(img, screen_coverage_px, uv_scale), priority);
 
-    const uint32_t desired = asset_image_desired_top_mip(img, screen_coverage_px, uv_scale);
+    threads_mutex_unlock(&am->state_m);
+}
 
-    if (img->stream_best_target_mip_frame != (uint32_t)am->frame_index)
-    {
-        img->stream_best_target_mip_frame = (uint32_t)am->frame_index;
-        img->stream_best_target_mip = desired;
-    }
-    else
-    {
-        if (desired < img->stream_best_target_mip)
-            img->stream_best_target_mip = desired;
-    }
+void asset_manager_image_stream_record_prefetch(asset_manager_t *am, ihandle_t image, float screen_coverage_px, float uv_scale, uint16_t priority)
+{
+    if (!am || !ihandle_is_valid(image))
+        return;
 
-    if (img->stream_best_priority_frame != (uint32_t)am->frame_index)
+    asset_manager_touch(am, image);
+
+    threads_mutex_lock(&am->state_m);
+
+    asset_slot_t *slot = NULL;
+    asset_image_t *img = asset_image_stream_slot_locked(am, image, &slot);
+    if (!img || img->stream_last_used_frame == am->frame_index)
     {
-        img->stream_best_priority_frame = (uint32_t)am->frame_index;
-        img->stream_best_priority = p;
+        threads_mutex_unlock(&am->state_m);
+        return;
     }
-    else
+
+    const uint32_t desired = asset_image_desired_top_mip(img, screen_coverage_px, uv_scale);
+
+    // Only textures that actually need sharper mips are tracked; the rest would read as free hits.
+    if (!img->stream_prefetch_frame && desired < img->stream_current_top_mip && !(slot->flags & ASSET_FLAG_NO_UNLOAD))
     {
-        if (p > img->stream_best_priority)
-            img->stream_best_priority = p;
+        img->stream_prefetch_frame = (uint32_t)am->frame_index;
+        img->stream_prefetch_bytes = 0;
+        am->stats.tex_prefetch_issued_total++;
     }
 
-    mutex_unlock_impl(&am->state_m);
+    // Keeps the speculative mips from aging out under evict_unused; stream_last_used_frame stays
+    // reserved for real uses so eviction order still favours what is on screen.
+    img->stream_last_used_ms = am->now_ms;
+
+    asset_image_stream_aggregate_locked(am, slot, img, desired, priority);
+
+    threads_mutex_unlock(&am->state_m);
 }
 
 void asset_manager_image_stream_force_top_mip(asset_manager_t *am, ihandle_t image, uint32_t enabled, uint32_t top_mip, uint16_t priority)
@@ -1827,19 +2876,19 @@ void asset_manager_image_stream_force_top_mip(asset_manager_t *am, ihandle_t ima
     if (!am || !ihandle_is_valid(image))
         return;
 
-    mutex_lock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
 
     asset_slot_t *slot = NULL;
     if (!slot_valid_locked(am, image, &slot) || !slot || slot->asset.type != ASSET_IMAGE || slot->asset.state != ASSET_STATE_READY)
     {
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
         return;
     }
 
     asset_image_t *img = &slot->asset.as.image;
     if (img->mip_count == 0)
     {
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
         return;
     }
 
@@ -1856,7 +2905,7 @@ void asset_manager_image_stream_force_top_mip(asset_manager_t *am, ihandle_t ima
         img->stream_pending_frames = 0;
     }
 
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_unlock(&am->state_m);
 }
 
 typedef struct am_stream_upload_cand_t
@@ -1897,11 +2946,12 @@ static void asset_manager_texture_stream_finalize_targets_locked(asset_manager_t
         return;
 
     const uint32_t stable_frames = am->tex_stream_stable_frames ? am->tex_stream_stable_frames : 1u;
+    const uint32_t prefetch_expire = am->tex_stream_prefetch_expire_frames ? am->tex_stream_prefetch_expire_frames : 1u;
 
     const uint32_t cap = (uint32_t)am->slots.size;
     for (uint32_t i = 0; i < cap; ++i)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
+        asset_slot_t *s = slot_at(&am->slots, i);
         if (!s)
             continue;
         if (s->flags & ASSET_FLAG_NO_UNLOAD)
@@ -1917,6 +2967,14 @@ static void asset_manager_texture_stream_finalize_targets_locked(asset_manager_t
         if ((img->stream_min_safety_mip == 0 && lowest_mip != 0) || img->stream_min_safety_mip >= img->mip_count)
             img->stream_min_safety_mip = lowest_mip;
 
+        if (img->stream_prefetch_frame && (uint32_t)am->frame_index - img->stream_prefetch_frame >= prefetch_expire)
+        {
+            am->stats.tex_prefetch_misses_total++;
+            am->stats.tex_prefetch_wasted_bytes_total += img->stream_prefetch_bytes;
+            img->stream_prefetch_frame = 0;
+            img->stream_prefetch_bytes = 0;
+        }
+
         if (img->stream_forced)
         {
             uint32_t forced = clamp_u32(img->stream_forced_top_mip, 0u, lowest_mip);
@@ -2005,7 +3063,7 @@ static void asset_manager_texture_stream_evict_budget_locked(asset_manager_t *am
     uint32_t n = 0;
     for (uint32_t i = 0; i < cap; ++i)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
+        asset_slot_t *s = slot_at(&am->slots, i);
         if (!s)
             continue;
         if (s->asset.type != ASSET_IMAGE || s->asset.state != ASSET_STATE_READY)
@@ -2018,7 +3076,7 @@ static void asset_manager_texture_stream_evict_budget_locked(asset_manager_t *am
         if (img->stream_current_top_mip >= img->stream_min_safety_mip)
             continue;
 
-        const uint64_t last_ms = img->stream_last_used_ms ? img->stream_last_used_ms : s->last_requested_ms;
+        const uint64_t last_ms = img->stream_last_used_ms ? img->stream_last_used_ms : atomic_load_u64(&s->last_requested_ms);
         const uint64_t age_ms = (last_ms && am->now_ms > last_ms) ? (am->now_ms - last_ms) : 0;
         if (am->tex_stream_evict_unused_ms && age_ms < (uint64_t)am->tex_stream_evict_unused_ms)
             continue;
@@ -2027,7 +3085,7 @@ static void asset_manager_texture_stream_evict_budget_locked(asset_manager_t *am
         if (!bytes)
             continue;
 
-        const uint64_t last_used = img->stream_last_used_frame ? img->stream_last_used_frame : s->last_touched_frame;
+        const uint64_t last_used = img->stream_last_used_frame ? img->stream_last_used_frame : atomic_load_u64(&s->last_touched_frame);
         cands[n++] = (am_evict_cand_t){i, img->stream_priority, 0, last_used, bytes};
     }
 
@@ -2045,7 +3103,7 @@ static void asset_manager_texture_stream_evict_budget_locked(asset_manager_t *am
 
     for (uint32_t k = 0; k < n && am->stats.vram_resident_bytes > budget; ++k)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, cands[k].slot_index);
+        asset_slot_t *s = slot_at(&am->slots, cands[k].slot_index);
         if (!s || s->asset.type != ASSET_IMAGE || s->asset.state != ASSET_STATE_READY)
             continue;
 
@@ -2096,87 +3154,544 @@ static void asset_manager_texture_stream_evict_budget_locked(asset_manager_t *am
         glBindTexture(GL_TEXTURE_2D, 0);
     }
 
-    am->stats.tex_stream_evicted_bytes_last_frame += evicted_bytes;
-    am->stats.tex_stream_evictions_last_frame += evictions;
-    am->stats.evicted_bytes_last_pump += evicted_bytes;
+    am->stats.tex_stream_evicted_bytes_last_frame += evicted_bytes;
+    am->stats.tex_stream_evictions_last_frame += evictions;
+    am->stats.evicted_bytes_last_pump += evicted_bytes;
+
+    free(cands);
+}
+
+static void asset_manager_texture_stream_evict_unused_locked(asset_manager_t *am)
+{
+    if (!am || !am->streaming_enabled)
+        return;
+
+    const uint32_t cap = (uint32_t)am->slots.size;
+
+    uint64_t evicted_bytes = 0;
+    uint32_t evictions = 0;
+
+    for (uint32_t i = 0; i < cap; ++i)
+    {
+        asset_slot_t *s = slot_at(&am->slots, i);
+        if (!s)
+            continue;
+        if (s->flags & ASSET_FLAG_NO_UNLOAD)
+            continue;
+        if (s->asset.type != ASSET_IMAGE || s->asset.state != ASSET_STATE_READY)
+            continue;
+
+        asset_image_t *img = &s->asset.as.image;
+        if (!img->gl_handle || !img->mips || img->mip_count == 0)
+            continue;
+
+        const uint64_t last_ms = img->stream_last_used_ms ? img->stream_last_used_ms : atomic_load_u64(&s->last_requested_ms);
+        const uint64_t age_ms = (last_ms && am->now_ms > last_ms) ? (am->now_ms - last_ms) : 0;
+        if (am->tex_stream_evict_unused_ms && age_ms < (uint64_t)am->tex_stream_evict_unused_ms)
+            continue;
+
+        // Evict at most one mip per texture per frame (to avoid thrash and keep it incremental).
+        const uint32_t evict_mip = img->stream_current_top_mip;
+        if (evict_mip >= img->mip_count)
+            continue;
+
+        // Never evict below safety.
+        if (evict_mip >= img->stream_min_safety_mip)
+            continue;
+
+        const uint64_t bytes = img->mips->size[evict_mip];
+
+        if (GLEW_ARB_sparse_texture != 0 && img->stream_sparse)
+        {
+            const uint32_t mw = img->mips->width[evict_mip];
+            const uint32_t mh = img->mips->height[evict_mip];
+            glBindTexture(GL_TEXTURE_2D, (GLuint)img->gl_handle);
+            glTexPageCommitmentARB(GL_TEXTURE_2D, (GLint)evict_mip, 0, 0, 0, (GLsizei)mw, (GLsizei)mh, 1, GL_FALSE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+
+        img->stream_current_top_mip = evict_mip + 1u;
+        if (img->stream_current_top_mip > (img->mip_count - 1u))
+            img->stream_current_top_mip = img->mip_count - 1u;
+
+        if (evict_mip < 64u)
+            img->stream_residency_mask &= ~(1ull << evict_mip);
+
+        if (bytes && img->vram_bytes >= bytes)
+            img->vram_bytes -= bytes;
+        if (bytes && am->stats.vram_resident_bytes >= bytes)
+            am->stats.vram_resident_bytes -= bytes;
+
+        glBindTexture(GL_TEXTURE_2D, (GLuint)img->gl_handle);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)img->stream_current_top_mip);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        img->stream_last_evict_frame = (uint32_t)am->frame_index;
+        evicted_bytes += bytes;
+        evictions++;
+    }
+
+    // Accumulate into per-frame stats (budget eviction also adds to these).
+    am->stats.tex_stream_evicted_bytes_last_frame += evicted_bytes;
+    am->stats.tex_stream_evictions_last_frame += evictions;
+    am->stats.evicted_bytes_last_pump += evicted_bytes;
+}
+
+static bool read_file_all(const char *path, uint8_t **out_data, uint32_t *out_size)
+{
+    *out_data = NULL;
+    *out_size = 0;
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    bool ok = fseek(f, 0, SEEK_END) == 0;
+    long n = ok ? ftell(f) : -1;
+    ok = n > 0 && (uint64_t)n <= 0xFFFFFFFFull && fseek(f, 0, SEEK_SET) == 0;
+
+    uint8_t *data = ok ? (uint8_t *)malloc((size_t)n) : NULL;
+    ok = data && fread(data, 1, (size_t)n, f) == (size_t)n;
+    fclose(f);
+
+    if (!ok)
+    {
+        free(data);
+        return false;
+    }
+    *out_data = data;
+    *out_size = (uint32_t)n;
+    return true;
+}
+
+// Where the dropped levels of a trimmed image come from: its pack entry when one is mounted
+// (out_pack->data set), else the source file at s->path.
+static bool asset_mip_source_locked(const asset_manager_t *am, const asset_slot_t *s, asset_blob_t *out_pack)
+{
+    memset(out_pack, 0, sizeof(*out_pack));
+    if (s->path_is_ptr || !s->path)
+        return false;
+    if (am->packs.size && ihandle_is_valid(s->persistent))
+        pack_find_locked(am, pack_persistent_key(s->persistent), out_pack);
+    return true;
+}
+
+// Pack blobs go to whichever image module accepts them, like at load time; source files to the
+// module that loaded the slot.
+static bool asset_mip_read(asset_manager_t *am, uint16_t midx, const char *path, const asset_blob_t *blob, const asset_image_mip_chain_t *layout, uint32_t first, uint32_t last, uint8_t **levels)
+{
+    if (blob->flags & ASSET_BLOB_FLAG_SOURCE_FILE)
+    {
+        const asset_module_desc_t *m = asset_manager_get_module_by_index(am, midx);
+        return m && m->mip_read_fn && m->mip_read_fn(am, path, blob, layout, first, last, levels);
+    }
+
+    for (uint32_t i = 0; i < am->modules.size; ++i)
+    {
+        const asset_module_desc_t *m = (const asset_module_desc_t *)vector_impl_at(&am->modules, i);
+        if (m && m->type == ASSET_IMAGE && m->mip_read_fn && m->mip_read_fn(am, path, blob, layout, first, last, levels))
+            return true;
+    }
+    return false;
+}
+
+typedef struct asset_mip_page_t
+{
+    asset_manager_t *am;
+    ihandle_t handle;
+    uint16_t module_index;
+    uint8_t via_io;
+    uint32_t first_mip;
+    uint32_t last_mip;
+    uint64_t bytes;
+    asset_image_mip_chain_t layout;
+    asset_blob_t blob; // pack entry, or the file once read
+    uint8_t *io_data;
+    char *path;
+    uint8_t *levels[ASSET_IMAGE_MAX_MIPS];
+    asset_staging_alloc_t staged[ASSET_IMAGE_MAX_MIPS];
+} asset_mip_page_t;
+
+static void asset_mip_page_finish(asset_mip_page_t *p, bool ok)
+{
+    asset_manager_t *am = p->am;
+
+    threads_mutex_lock(&am->state_m);
+    asset_slot_t *s = NULL;
+    if (slot_valid_locked(am, p->handle, &s) && s->asset.type == ASSET_IMAGE && s->asset.state == ASSET_STATE_READY)
+    {
+        asset_image_t *img = &s->asset.as.image;
+        asset_image_mip_chain_t *m = img->mips;
+        img->stream_page_inflight = 0;
+
+        // The slot may have been unloaded and reloaded meanwhile; only the same layout takes the levels.
+        if (ok && m && m->mip_count == p->layout.mip_count && m->width[0] == p->layout.width[0] && m->height[0] == p->layout.height[0])
+        {
+            for (uint32_t i = p->first_mip; i <= p->last_mip; ++i)
+            {
+                if (m->level[i] || !p->levels[i])
+                    continue;
+                asset_image_mips_adopt_level(m, i, p->levels[i]);
+                p->levels[i] = NULL;
+                asset_image_upload_unstage(am, m, i);
+                if (p->staged[i].id)
+                {
+                    m->staged_id[i] = p->staged[i].id;
+                    m->staged_offset[i] = p->staged[i].offset;
+                    m->staged_mask |= 1u << i;
+                    p->staged[i].id = 0;
+                }
+                am->stats.tex_ram_resident_bytes += m->size[i];
+                am->stats.tex_stream_paged_in_bytes_total += m->size[i];
+            }
+        }
+        else if (!ok && !atomic_load_u32(&am->shutting_down))
+        {
+            // Stay at the current resolution instead of retrying every frame.
+            img->stream_page_failed = 1;
+            LOG_WARN("mip page-in failed for '%s' (mips %u..%u)", p->path, (unsigned)p->first_mip, (unsigned)p->last_mip);
+        }
+    }
+    am->tex_page_inflight--;
+    am->tex_page_pending_bytes -= p->bytes;
+    threads_mutex_unlock(&am->state_m);
+
+    for (uint32_t i = p->first_mip; i <= p->last_mip; ++i)
+    {
+        if (p->staged[i].id)
+            asset_staging_release(asset_manager_staging(am), p->staged[i].id);
+        free(p->levels[i]);
+    }
+    free(p->path);
+    free(p);
+}
+
+static void asset_mip_page_job(void *user, uint32_t worker_index)
+{
+    (void)worker_index;
+    asset_mip_page_t *p = (asset_mip_page_t *)user;
+    asset_manager_t *am = p->am;
+
+    // Same rule as asset_io_decode_job: the I/O stage may already be torn down.
+    if (atomic_load_u32(&am->shutting_down))
+    {
+        free(p->io_data);
+        asset_mip_page_finish(p, false);
+        return;
+    }
+
+    uint8_t *file = NULL;
+    if (p->via_io)
+    {
+        p->blob.data = p->io_data;
+    }
+    else if (!p->blob.data && read_file_all(p->path, &file, &p->blob.size))
+    {
+        p->blob.data = file;
+    }
+
+    bool ok = p->blob.data && asset_mip_read(am, p->module_index, p->path, &p->blob, &p->layout, p->first_mip, p->last_mip, p->levels);
+
+    // Copy the levels into the upload ring here, so the streamer only has to issue the GPU copies.
+    // Levels over a quarter of the ring would hold up everything behind them; those stay on the
+    // client-memory path.
+    asset_staging_t *staging = ok ? asset_manager_staging(am) : NULL;
+    for (uint32_t i = p->first_mip; staging && i <= p->last_mip; ++i)
+    {
+        const uint64_t size = p->layout.size[i];
+        if (p->levels[i] && size <= staging->size / 4u && asset_staging_alloc(staging, size, 16u, &p->staged[i]))
+            memcpy(p->staged[i].ptr, p->levels[i], (size_t)size);
+    }
+
+    if (p->io_data)
+        asset_io_release(&am->io, p->io_data);
+    free(file);
+    asset_mip_page_finish(p, ok);
+}
+
+static void asset_mip_page_read_done(void *user, uint8_t *data, uint32_t size)
+{
+    asset_mip_page_t *p = (asset_mip_page_t *)user;
+    p->io_data = data;
+    p->blob.size = size;
+    jobs_run_background(asset_mip_page_job, p, &p->am->loaders);
+}
+
+// Reads the levels the streamer needs next, from the one it would upload now up to the target,
+// in a single job: sources without stored mips decode the whole base level on every read.
+static void asset_mip_page_request_locked(asset_manager_t *am, uint32_t slot_index, asset_slot_t *s)
+{
+    asset_image_t *img = &s->asset.as.image;
+    asset_image_mip_chain_t *m = img->mips;
+    if (!m || img->stream_page_inflight || img->stream_page_failed || img->stream_current_top_mip == 0)
+        return;
+    if (atomic_load_u32(&am->shutting_down) || am->tex_page_inflight >= am->worker_count)
+        return;
+
+    const uint32_t last = img->stream_current_top_mip - 1u;
+    if (m->level[last])
+        return;
+
+    // Over the RAM budget the sharpest levels wait; one read is always allowed so streaming moves on.
+    const uint64_t budget = am->tex_stream_ram_budget_bytes;
+    const uint64_t used = am->stats.tex_ram_resident_bytes + am->tex_page_pending_bytes;
+    uint32_t first = img->stream_target_top_mip < last ? img->stream_target_top_mip : last;
+    uint64_t bytes = 0;
+    for (uint32_t i = first; i <= last; ++i)
+        bytes += m->level[i] ? 0 : m->size[i];
+    while (budget && first < last && used + bytes > budget)
+    {
+        bytes -= m->level[first] ? 0 : m->size[first];
+        first++;
+    }
+    if (budget && am->tex_page_inflight && used + bytes > budget)
+        return;
+
+    asset_blob_t pack;
+    if (!asset_mip_source_locked(am, s, &pack))
+        return;
+
+    asset_mip_page_t *p = (asset_mip_page_t *)calloc(1, sizeof(asset_mip_page_t));
+    char *path = p ? strdup(s->path) : NULL;
+    if (!path)
+    {
+        free(p);
+        return;
+    }
+
+    p->am = am;
+    p->handle = ihandle_make(am->handle_type, slot_index + 1u, s->generation);
+    p->module_index = s->module_index;
+    p->first_mip = first;
+    p->last_mip = last;
+    p->bytes = bytes;
+    p->layout = *m;
+    p->blob = pack;
+    p->path = path;
+
+    img->stream_page_inflight = 1;
+    am->tex_page_inflight++;
+    am->tex_page_pending_bytes += bytes;
+
+    if (!pack.data)
+    {
+        p->blob.align = 1;
+        p->blob.flags = ASSET_BLOB_FLAG_SOURCE_FILE;
+        p->via_io = 1;
+        if (am->io.backend && asset_io_read(&am->io, path, asset_mip_page_read_done, p))
+            return;
+        p->via_io = 0;
+    }
+    jobs_run_background(asset_mip_page_job, p, &am->loaders);
+}
+
+// Keeps mip levels in RAM within tex_stream_ram_budget_bytes by dropping paged-in levels the
+// streamer does not need right now (already on the GPU, or sharper than the target), least
+// recently used textures first. Safety mips loaded with the chain are never dropped.
+static void asset_manager_texture_stream_trim_ram_locked(asset_manager_t *am, uint64_t budget)
+{
+    const uint32_t cap = (uint32_t)am->slots.size;
+
+    uint64_t resident = 0;
+    for (uint32_t i = 0; i < cap; ++i)
+    {
+        asset_slot_t *s = slot_at(&am->slots, i);
+        if (s && s->asset.type == ASSET_IMAGE && s->asset.state == ASSET_STATE_READY && s->asset.as.image.mips)
+            resident += s->asset.as.image.mips->ram_bytes;
+    }
+    am->stats.tex_ram_resident_bytes = resident;
+    am->stats.tex_stream_page_ins_pending = am->tex_page_inflight;
+
+    if (budget == 0 || resident <= budget)
+        return;
+
+    am_evict_cand_t *cands = (am_evict_cand_t *)malloc((size_t)cap * sizeof(am_evict_cand_t));
+    if (!cands)
+        return;
+
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < cap; ++i)
+    {
+        asset_slot_t *s = slot_at(&am->slots, i);
+        if (!s || s->asset.type != ASSET_IMAGE || s->asset.state != ASSET_STATE_READY)
+            continue;
+
+        const asset_image_t *img = &s->asset.as.image;
+        if (!img->mips || !img->mips->paged_mask || s->save_pins)
+            continue;
+
+        const uint64_t last_used = img->stream_last_used_frame ? img->stream_last_used_frame : atomic_load_u64(&s->last_touched_frame);
+        cands[n++] = (am_evict_cand_t){i, img->stream_priority, 0, last_used, img->mips->ram_bytes};
+    }
+
+    qsort(cands, (size_t)n, sizeof(am_evict_cand_t), am_evict_cand_cmp);
+
+    for (uint32_t k = 0; k < n && resident > budget; ++k)
+    {
+        asset_image_t *img = &slot_at(&am->slots, cands[k].slot_index)->asset.as.image;
+        asset_image_mip_chain_t *m = img->mips;
+        for (uint32_t i = 0; i < m->resident_first && resident > budget; ++i)
+        {
+            if (i >= img->stream_target_top_mip && i < img->stream_current_top_mip)
+                continue;
+            resident -= asset_image_mips_drop_level(m, i);
+        }
+    }
+    am->stats.tex_ram_resident_bytes = resident;
 
     free(cands);
 }
 
-static void asset_manager_texture_stream_evict_unused_locked(asset_manager_t *am)
+#define ASSET_HOST_DECAY_FRAMES 256u
+// Assets used this recently are never unloaded; the renderer may still hold pointers into them.
+#define ASSET_HOST_MIN_AGE_FRAMES 2u
+// Unloading costs a reload; only worth it when the asset holds at least this much in RAM.
+#define ASSET_HOST_MIN_EVICT_BYTES (256u * 1024u)
+
+typedef struct am_host_cand_t
 {
-    if (!am || !am->streaming_enabled)
-        return;
+    uint32_t slot_index;
+    uint32_t pad0;
+    uint64_t score;
+    uint64_t bytes;
+} am_host_cand_t;
+
+static int am_host_cand_cmp(const void *a, const void *b)
+{
+    const am_host_cand_t *x = (const am_host_cand_t *)a;
+    const am_host_cand_t *y = (const am_host_cand_t *)b;
+    if (x->score > y->score)
+        return -1;
+    if (x->score < y->score)
+        return 1;
+    if (x->bytes > y->bytes)
+        return -1;
+    if (x->bytes < y->bytes)
+        return 1;
+    return 0;
+}
 
+// Works out how much CPU-side asset data to keep from the host budget and the pressure monitor,
+// then frees the difference: paged mip levels first, then whole assets by LRU/frequency score.
+static void asset_manager_host_evict_locked(asset_manager_t *am)
+{
     const uint32_t cap = (uint32_t)am->slots.size;
+    const uint64_t frame = am->frame_index;
 
-    uint64_t evicted_bytes = 0;
-    uint32_t evictions = 0;
+    const bool decay = frame - am->host_decay_frame >= ASSET_HOST_DECAY_FRAMES;
+    if (decay)
+        am->host_decay_frame = frame;
 
+    uint64_t resident = 0;
     for (uint32_t i = 0; i < cap; ++i)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
+        asset_slot_t *s = slot_at(&am->slots, i);
         if (!s)
             continue;
-        if (s->flags & ASSET_FLAG_NO_UNLOAD)
-            continue;
-        if (s->asset.type != ASSET_IMAGE || s->asset.state != ASSET_STATE_READY)
-            continue;
-
-        asset_image_t *img = &s->asset.as.image;
-        if (!img->gl_handle || !img->mips || img->mip_count == 0)
-            continue;
-
-        const uint64_t last_ms = img->stream_last_used_ms ? img->stream_last_used_ms : s->last_requested_ms;
-        const uint64_t age_ms = (last_ms && am->now_ms > last_ms) ? (am->now_ms - last_ms) : 0;
-        if (am->tex_stream_evict_unused_ms && age_ms < (uint64_t)am->tex_stream_evict_unused_ms)
-            continue;
+        if (decay)
+            atomic_store_u32(&s->use_frames, atomic_load_u32(&s->use_frames) >> 1);
+        resident += asset_host_bytes_if_resident(&s->asset);
+    }
+    am->stats.host_resident_bytes = resident;
 
-        // Evict at most one mip per texture per frame (to avoid thrash and keep it incremental).
-        const uint32_t evict_mip = img->stream_current_top_mip;
-        if (evict_mip >= img->mip_count)
-            continue;
+    asset_mempressure_sample_t ps;
+    asset_mempressure_sample(&am->mempressure, &ps);
+    am->stats.host_limit_bytes = ps.limit_bytes;
+    am->stats.host_used_bytes = ps.used_bytes;
 
-        // Never evict below safety.
-        if (evict_mip >= img->stream_min_safety_mip)
-            continue;
+    uint64_t target = am->host_budget_bytes ? am->host_budget_bytes : UINT64_MAX;
 
-        const uint64_t bytes = img->mips->size[evict_mip];
+    if (ps.events != am->host_seen.events)
+    {
+        // The kernel is already stalling on reclaim; give back a quarter of what we hold.
+        am->stats.host_pressure_events_total += ps.events - am->host_seen.events;
+        const uint64_t t = resident - resident / 4u;
+        if (t < target)
+            target = t;
+    }
 
-        if (GLEW_ARB_sparse_texture != 0 && img->stream_sparse)
+    // Limits are sampled about once a second, so act on a shortfall once per sample rather than
+    // every frame until the next one shows the memory we freed.
+    if (ps.samples != am->host_seen.samples && ps.limit_bytes && am->host_headroom_pct)
+    {
+        const uint64_t want_free = ps.limit_bytes / 100u * am->host_headroom_pct;
+        const uint64_t free_bytes = ps.limit_bytes > ps.used_bytes ? ps.limit_bytes - ps.used_bytes : 0;
+        if (free_bytes < want_free)
         {
-            const uint32_t mw = img->mips->width[evict_mip];
-            const uint32_t mh = img->mips->height[evict_mip];
-            glBindTexture(GL_TEXTURE_2D, (GLuint)img->gl_handle);
-            glTexPageCommitmentARB(GL_TEXTURE_2D, (GLint)evict_mip, 0, 0, 0, (GLsizei)mw, (GLsizei)mh, 1, GL_FALSE);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            const uint64_t short_by = want_free - free_bytes;
+            const uint64_t t = resident > short_by ? resident - short_by : 0;
+            if (t < target)
+                target = t;
         }
+    }
+    am->host_seen = ps;
 
-        img->stream_current_top_mip = evict_mip + 1u;
-        if (img->stream_current_top_mip > (img->mip_count - 1u))
-            img->stream_current_top_mip = img->mip_count - 1u;
+    if (resident <= target)
+        return;
 
-        if (evict_mip < 64u)
-            img->stream_residency_mask &= ~(1ull << evict_mip);
+    // Paged mip levels come back cheaply from disk, so they go first.
+    const uint64_t tex_before = am->stats.tex_ram_resident_bytes;
+    const uint64_t need = resident - target;
+    asset_manager_texture_stream_trim_ram_locked(am, tex_before > need ? tex_before - need : 1u);
+    const uint64_t tex_freed = tex_before - am->stats.tex_ram_resident_bytes;
+    resident -= tex_freed < resident ? tex_freed : resident;
+    am->stats.host_evicted_bytes_total += tex_freed;
+    if (resident <= target)
+    {
+        am->stats.host_resident_bytes = resident;
+        return;
+    }
 
-        if (bytes && img->vram_bytes >= bytes)
-            img->vram_bytes -= bytes;
-        if (bytes && am->stats.vram_resident_bytes >= bytes)
-            am->stats.vram_resident_bytes -= bytes;
+    am_host_cand_t *cands = (am_host_cand_t *)malloc((size_t)cap * sizeof(am_host_cand_t));
+    if (!cands)
+        return;
 
-        glBindTexture(GL_TEXTURE_2D, (GLuint)img->gl_handle);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)img->stream_current_top_mip);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < cap; ++i)
+    {
+        asset_slot_t *s = slot_at(&am->slots, i);
+        if (!s || s->asset.state != ASSET_STATE_READY || s->inflight || s->save_pins)
+            continue;
+        if ((s->flags & ASSET_FLAG_NO_UNLOAD) || s->path_is_ptr || !s->path || !s->path[0])
+            continue;
+        if (s->asset.type == ASSET_IMAGE && s->asset.as.image.stream_page_inflight)
+            continue;
 
-        img->stream_last_evict_frame = (uint32_t)am->frame_index;
-        evicted_bytes += bytes;
+        const uint64_t bytes = asset_host_reclaimable_bytes(&s->asset);
+        if (bytes < ASSET_HOST_MIN_EVICT_BYTES)
+            continue;
+
+        const uint64_t last = atomic_load_u64(&s->last_touched_frame);
+        const uint64_t age = frame > last ? frame - last : 0;
+        if (age < ASSET_HOST_MIN_AGE_FRAMES)
+            continue;
+
+        // LRU weighted by how many frames the asset was used in: a long-idle asset that was
+        // needed often still outlives one that was looked at once.
+        const uint64_t score = (age << 8) / (1u + (uint64_t)atomic_load_u32(&s->use_frames));
+        cands[n++] = (am_host_cand_t){i, 0, score, bytes};
+    }
+
+    qsort(cands, (size_t)n, sizeof(am_host_cand_t), am_host_cand_cmp);
+
+    uint32_t evictions = 0;
+    for (uint32_t k = 0; k < n && resident > target; ++k)
+    {
+        asset_unload_slot_locked(am, slot_at(&am->slots, cands[k].slot_index));
+        resident -= cands[k].bytes < resident ? cands[k].bytes : resident;
+        am->stats.host_evicted_bytes_total += cands[k].bytes;
         evictions++;
     }
+    am->stats.host_evictions_total += evictions;
+    am->stats.host_resident_bytes = resident;
 
-    // Accumulate into per-frame stats (budget eviction also adds to these).
-    am->stats.tex_stream_evicted_bytes_last_frame += evicted_bytes;
-    am->stats.tex_stream_evictions_last_frame += evictions;
-    am->stats.evicted_bytes_last_pump += evicted_bytes;
+    if (evictions)
+        LOG_INFO("Asset memory: unloaded %u assets, %llu MB held, target %llu MB",
+                 (unsigned)evictions,
+                 (unsigned long long)(resident >> 20),
+                 (unsigned long long)(target >> 20));
+
+    free(cands);
 }
 
 static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
@@ -2198,7 +3713,7 @@ static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
 
     for (uint32_t i = 0; i < cap; ++i)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
+        asset_slot_t *s = slot_at(&am->slots, i);
         if (!s)
             continue;
         if (s->asset.type != ASSET_IMAGE || s->asset.state != ASSET_STATE_READY)
@@ -2208,8 +3723,12 @@ static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
         if (!img->gl_handle || !img->mips || img->mip_count == 0)
             continue;
 
+        // Staged levels nobody is going to upload would pin the ring.
         if (img->stream_current_top_mip <= img->stream_target_top_mip)
+        {
+            asset_image_upload_unstage_all(am, img->mips);
             continue;
+        }
 
         pending++;
 
@@ -2233,6 +3752,15 @@ static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
 
     qsort(cands, (size_t)n, sizeof(am_stream_upload_cand_t), am_stream_upload_cmp);
 
+    // Levels that are not in RAM are read back first; the loop below skips them until they land.
+    for (uint32_t k = 0; k < n; ++k)
+    {
+        asset_slot_t *s = slot_at(&am->slots, cands[k].slot_index);
+        asset_image_t *img = &s->asset.as.image;
+        if (!img->mips->level[img->stream_current_top_mip - 1u])
+            asset_mip_page_request_locked(am, cands[k].slot_index, s);
+    }
+
     uint64_t uploaded = 0;
     uint32_t uploads = 0;
 
@@ -2240,8 +3768,10 @@ static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
     {
         if (uploaded >= upload_budget)
             break;
+        if (uploaded && !asset_upload_remaining_us(am))
+            break;
 
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, cands[k].slot_index);
+        asset_slot_t *s = slot_at(&am->slots, cands[k].slot_index);
         if (!s || s->asset.type != ASSET_IMAGE || s->asset.state != ASSET_STATE_READY)
             continue;
 
@@ -2254,18 +3784,13 @@ static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
 
         const uint32_t next_mip = img->stream_current_top_mip - 1u;
         const uint64_t mip_bytes = img->mips->size[next_mip];
-        if (mip_bytes == 0)
+        if (mip_bytes == 0 || !img->mips->level[next_mip])
             continue;
 
-        const GLenum fmt = (img->channels == 4) ? GL_RGBA : (img->channels == 3 ? GL_RGB : GL_RED);
-        const GLenum type = img->is_float ? GL_FLOAT : GL_UNSIGNED_BYTE;
-
-        const uint32_t mw = img->mips->width[next_mip];
-        const uint32_t mh = img->mips->height[next_mip];
-
-        const uint32_t bytes_per_comp = img->is_float ? 4u : 1u;
-        const uint32_t row_bytes_u32 = mw * img->channels * bytes_per_comp;
-        if (row_bytes_u32 == 0 || mh == 0)
+        // Block-compressed levels go up in rows of 4x4 blocks; stream_upload_row counts those.
+        const uint32_t row_bytes_u32 = asset_image_upload_row_bytes(img, next_mip);
+        const uint32_t row_count = asset_image_upload_row_count(img, next_mip);
+        if (row_bytes_u32 == 0 || row_count == 0)
             continue;
 
         // Ensure we only upload one mip at a time per texture, but allow that mip to be uploaded across frames.
@@ -2275,7 +3800,7 @@ static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
             img->stream_upload_row = 0u;
         }
 
-        if (img->stream_upload_row >= mh)
+        if (img->stream_upload_row >= row_count)
         {
             img->stream_upload_inflight_mip = 0xFFFFFFFFu;
             img->stream_upload_row = 0u;
@@ -2283,7 +3808,10 @@ static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
         }
 
         const uint64_t row_bytes = (uint64_t)row_bytes_u32;
-        const uint64_t remaining_budget = (uploaded < upload_budget) ? (upload_budget - uploaded) : 0;
+        uint64_t remaining_budget = (uploaded < upload_budget) ? (upload_budget - uploaded) : 0;
+        const uint64_t time_budget = asset_upload_budget_bytes(am);
+        if (remaining_budget > time_budget)
+            remaining_budget = time_budget;
 
         // If the next row alone doesn't fit, skip to other textures unless we haven't uploaded anything yet this frame.
         // This guarantees forward progress for very large mips without permanently wedging the streamer.
@@ -2294,39 +3822,29 @@ static void asset_manager_texture_stream_upload_locked(asset_manager_t *am)
         if (max_rows < 1u)
             max_rows = 1u;
 
-        uint32_t rows_left = mh - img->stream_upload_row;
+        uint32_t rows_left = row_count - img->stream_upload_row;
         uint32_t rows = (rows_left < max_rows) ? rows_left : max_rows;
         if (rows < 1u)
             rows = 1u;
 
-        const uint64_t slice_bytes = row_bytes * (uint64_t)rows;
-        const uint64_t mip_off = img->mips->offset[next_mip];
-        const uint64_t src_off = mip_off + (uint64_t)img->stream_upload_row * row_bytes;
-        const void *src = (const void *)(img->mips->data + (size_t)src_off);
+        const uint64_t t0 = am_time_us();
 
         glBindTexture(GL_TEXTURE_2D, (GLuint)img->gl_handle);
-        if (GLEW_ARB_sparse_texture != 0 && img->stream_sparse && img->stream_upload_row == 0u)
-            glTexPageCommitmentARB(GL_TEXTURE_2D, (GLint)next_mip, 0, 0, 0, (GLsizei)mw, (GLsizei)mh, 1, GL_TRUE);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        glTexSubImage2D(GL_TEXTURE_2D,
-                        (GLint)next_mip,
-                        0,
-                        (GLint)img->stream_upload_row,
-                        (GLsizei)mw,
-                        (GLsizei)rows,
-                        fmt,
-                        type,
-                        src);
+        const uint64_t slice_bytes = asset_image_upload_rows(am, img, next_mip, img->stream_upload_row, rows);
         glBindTexture(GL_TEXTURE_2D, 0);
 
+        asset_upload_note(am, slice_bytes, am_time_us() - t0);
+
         img->stream_upload_row += rows;
         img->stream_last_upload_frame = (uint32_t)am->frame_index;
+        if (img->stream_prefetch_frame)
+            img->stream_prefetch_bytes += slice_bytes;
 
         uploaded += slice_bytes;
         uploads++;
 
         // If we finished the mip, make it resident for sampling and account bytes once.
-        if (img->stream_upload_row >= mh)
+        if (img->stream_upload_row >= row_count)
         {
             img->stream_upload_inflight_mip = 0xFFFFFFFFu;
             img->stream_upload_row = 0u;
@@ -2359,73 +3877,143 @@ static void asset_manager_try_evict_textures_locked(asset_manager_t *am)
 
 void asset_manager_touch(asset_manager_t *am, ihandle_t h)
 {
-    if (!am || !ihandle_is_valid(h))
-        return;
+    asset_manager_touch_priority(am, h, ASSET_PRIORITY_VISIBLE);
+}
 
-    const uint64_t now_ms = am_time_ms();
+bool asset_manager_set_priority(asset_manager_t *am, ihandle_t h, asset_priority_t priority)
+{
+    if (!am || !ihandle_is_valid(h) || (uint32_t)priority >= ASSET_PRIORITY_COUNT)
+        return false;
 
-    mutex_lock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
     asset_slot_t *slot = NULL;
-    if (!slot_valid_locked(am, h, &slot) || !slot)
-    {
-        mutex_unlock_impl(&am->state_m);
-        return;
-    }
+    bool ok = slot_valid_locked(am, h, &slot) && slot && asset_requeue_locked(am, h, slot, priority, false);
+    threads_mutex_unlock(&am->state_m);
 
-    slot->last_touched_frame = am->frame_index;
-    slot->last_requested_ms = now_ms;
-
-    const uint32_t can_stream = (am->streaming_enabled != 0) && (slot->path_is_ptr == 0) && (slot->path && slot->path[0]);
+    if (ok)
+        asset_kick_loaders(am);
+    return ok;
+}
 
-    const uint32_t should_reload = (slot->asset.state == ASSET_STATE_EMPTY || slot->asset.state == ASSET_STATE_LOADING) && (slot->inflight == 0);
+bool asset_manager_cancel(asset_manager_t *am, ihandle_t h)
+{
+    if (!am || !ihandle_is_valid(h))
+        return false;
 
-    if (!can_stream || !should_reload)
+    threads_mutex_lock(&am->state_m);
+    asset_slot_t *slot = NULL;
+    bool ok = slot_valid_locked(am, h, &slot) && slot && !slot->path_is_ptr && slot->inflight && slot->job_ticket;
+    if (ok)
     {
-        mutex_unlock_impl(&am->state_m);
-        return;
+        slot_queue_drop_locked(am, slot);
+        slot->inflight = 0;
+        slot->asset.state = ASSET_STATE_EMPTY;
+        slot_state_changed_locked(am, slot);
+        am->stats.jobs_cancelled_total++;
     }
+    threads_mutex_unlock(&am->state_m);
+    return ok;
+}
 
-    const asset_type_t type = (asset_type_t)slot->requested_type;
-    const char *path = slot->path;
+bool asset_manager_add_dependency(asset_manager_t *am, ihandle_t parent, ihandle_t child)
+{
+    if (!am)
+        return false;
 
-    asset_job_t j;
-    memset(&j, 0, sizeof(j));
-    j.handle = h;
-    j.type = type;
-    j.path_is_ptr = 0;
+    threads_mutex_lock(&am->state_m);
+    bool ok = asset_dep_add_locked(am, parent, child);
+    threads_mutex_unlock(&am->state_m);
+    return ok;
+}
 
-    size_t n = strlen(path);
-    j.path = (char *)malloc(n + 1);
-    if (!j.path)
-    {
-        slot->asset.state = ASSET_STATE_FAILED;
-        mutex_unlock_impl(&am->state_m);
-        return;
-    }
-    memcpy(j.path, path, n + 1);
+uint32_t asset_manager_request_closure(asset_manager_t *am, ihandle_t root, asset_priority_t priority)
+{
+    if (!am || !ihandle_is_valid(root))
+        return 0;
+    if ((uint32_t)priority >= ASSET_PRIORITY_COUNT)
+        priority = ASSET_PRIORITY_NORMAL;
 
-    slot->inflight = 1;
-    slot->asset.type = type;
-    slot->asset.state = ASSET_STATE_LOADING;
-    mutex_unlock_impl(&am->state_m);
+    vector_t order = vector_impl_create_vector(sizeof(ihandle_t));
+    vector_t stack = vector_impl_create_vector(sizeof(uint32_t));
 
-    if (!jobq_push(&am->jobs, &j))
+    // Collect the closure under the lock; touching takes state_m itself.
+    threads_mutex_lock(&am->state_m);
+    asset_slot_t *rs = NULL;
+    if (slot_valid_locked(am, root, &rs))
     {
-        free(j.path);
-        mutex_lock_impl(&am->state_m);
-        if (slot_valid_locked(am, h, &slot) && slot)
+        if (++am->dep_walk_epoch == 0)
+            am->dep_walk_epoch = 1;
+        const uint32_t walk = am->dep_walk_epoch;
+
+        uint32_t ri = (uint32_t)ihandle_index(root) - 1u;
+        rs->dep_walk = walk;
+        vector_impl_push_back(&stack, &ri);
+        while (stack.size)
         {
-            slot->inflight = 0;
-            slot->asset.state = ASSET_STATE_FAILED;
+            const uint32_t i = *(const uint32_t *)vector_impl_back(&stack);
+            vector_impl_pop_back(&stack);
+
+            asset_slot_t *s = slot_at(&am->slots, i);
+            ihandle_t h = ihandle_make(am->handle_type, i + 1u, s->generation);
+            vector_impl_push_back(&order, &h);
+
+            for (uint32_t k = 0; k < s->deps.size; ++k)
+            {
+                uint32_t di = *(const uint32_t *)vector_impl_at(&s->deps, k);
+                asset_slot_t *ds = slot_at(&am->slots, di);
+                if (ds->dep_walk == walk)
+                    continue;
+                ds->dep_walk = walk;
+                vector_impl_push_back(&stack, &di);
+            }
         }
-        mutex_unlock_impl(&am->state_m);
     }
-    else
+    threads_mutex_unlock(&am->state_m);
+
+    // Reverse discovery order, so leaves tend to be queued ahead of the assets that reference them.
+    const uint32_t visited = order.size;
+    for (uint32_t n = visited; n-- > 0;)
+        asset_manager_touch_priority(am, *(const ihandle_t *)vector_impl_at(&order, n), priority);
+
+    vector_impl_free(&order);
+    vector_impl_free(&stack);
+    return visited;
+}
+
+bool asset_manager_closure_ready(const asset_manager_t *am, ihandle_t root)
+{
+    if (!am)
+        return false;
+
+    asset_manager_t *mut = (asset_manager_t *)am;
+    threads_mutex_lock(&mut->state_m);
+    asset_slot_t *s = NULL;
+    bool ready = slot_valid_locked(mut, root, &s) && s->asset.state == ASSET_STATE_READY && s->deps_pending == 0 && s->deps_failed == 0;
+    threads_mutex_unlock(&mut->state_m);
+    return ready;
+}
+
+asset_state_t asset_manager_closure_state(const asset_manager_t *am, ihandle_t root)
+{
+    if (!am)
+        return ASSET_STATE_EMPTY;
+
+    asset_manager_t *mut = (asset_manager_t *)am;
+    threads_mutex_lock(&mut->state_m);
+    asset_slot_t *s = NULL;
+    asset_state_t state = ASSET_STATE_EMPTY;
+    if (slot_valid_locked(mut, root, &s))
     {
-        mutex_lock_impl(&am->state_m);
-        am->stats.textures_reloaded_total++;
-        mutex_unlock_impl(&am->state_m);
+        // A failure anywhere wins, even while other parts are still loading.
+        if (slot_closure_failed(s))
+            state = ASSET_STATE_FAILED;
+        else if (s->asset.state == ASSET_STATE_READY && s->deps_pending == 0)
+            state = ASSET_STATE_READY;
+        else if (s->asset.state != ASSET_STATE_EMPTY)
+            state = ASSET_STATE_LOADING;
     }
+    threads_mutex_unlock(&mut->state_m);
+    return state;
 }
 
 bool asset_manager_update_flags(asset_manager_t *am, ihandle_t h, asset_flags_t set_mask, asset_flags_t clear_mask)
@@ -2433,7 +4021,7 @@ bool asset_manager_update_flags(asset_manager_t *am, ihandle_t h, asset_flags_t
     if (!am || !ihandle_is_valid(h))
         return false;
 
-    mutex_lock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
     asset_slot_t *slot = NULL;
     const bool ok = slot_valid_locked(am, h, &slot);
     if (ok && slot)
@@ -2441,7 +4029,7 @@ bool asset_manager_update_flags(asset_manager_t *am, ihandle_t h, asset_flags_t
         slot->flags |= set_mask;
         slot->flags &= ~clear_mask;
     }
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_unlock(&am->state_m);
 
     return ok;
 }
@@ -2451,15 +4039,55 @@ bool asset_manager_get_stats(const asset_manager_t *am, asset_manager_stats_t *o
     if (!am || !out)
         return false;
     asset_manager_t *mut = (asset_manager_t *)am;
-    mutex_lock_impl(&mut->state_m);
+    threads_mutex_lock(&mut->state_m);
     *out = mut->stats;
     out->frame_index = mut->frame_index;
     out->vram_budget_bytes = mut->vram_budget_bytes;
+    out->tex_ram_budget_bytes = mut->tex_stream_ram_budget_bytes;
     out->streaming_enabled = mut->streaming_enabled;
-    mutex_unlock_impl(&mut->state_m);
+    threads_mutex_unlock(&mut->state_m);
     return true;
 }
 
+static void asset_get_any_counters_roll(asset_manager_t *am)
+{
+    uint32_t n = atomic_load_u32(&am->asset_get_any_cnt_frame);
+    uint32_t locked = atomic_load_u32(&am->asset_get_any_locked_cnt_frame);
+    atomic_sub_u32(&am->asset_get_any_cnt_frame, n);
+    atomic_sub_u32(&am->asset_get_any_locked_cnt_frame, locked);
+
+    am->asset_get_any_cnt_last_frame = n;
+    am->asset_get_any_locked_cnt_last_frame = locked;
+}
+
+static void asset_staging_setup(asset_manager_t *am)
+{
+    if (am->staging_tried)
+        return;
+    am->staging_tried = 1;
+
+    asset_staging_backend_t backend;
+    memset(&backend, 0, sizeof(backend));
+    if (!asset_staging_gl_backend(&backend))
+    {
+        LOG_INFO("Asset staging: ARB_buffer_storage unavailable, uploading from client memory");
+        return;
+    }
+    if (!asset_staging_init(&am->staging, am->staging_bytes, 4096u, &backend))
+    {
+        LOG_WARN("Asset staging: failed to map a %llu byte ring", (unsigned long long)am->staging_bytes);
+        return;
+    }
+
+    atomic_store_u32(&am->staging_ready, 1u);
+    LOG_INFO("Asset staging: %llu MB persistent ring", (unsigned long long)(am->staging.size >> 20));
+}
+
+asset_staging_t *asset_manager_staging(asset_manager_t *am)
+{
+    return am && atomic_load_u32(&am->staging_ready) ? &am->staging : NULL;
+}
+
 void asset_manager_pump(asset_manager_t *am, uint32_t max_per_frame)
 {
 
@@ -2469,163 +4097,116 @@ void asset_manager_pump(asset_manager_t *am, uint32_t max_per_frame)
     if (max_per_frame == 0)
         return;
 
-    mutex_lock_impl(&am->state_m);
-    am->frame_index++;
+    asset_get_any_counters_roll(am);
+
+    threads_mutex_lock(&am->state_m);
+    atomic_store_u64(&am->frame_index, am->frame_index + 1u);
     am->now_ms = am_time_ms();
     am->stats.frame_index = am->frame_index;
+    am->stats.get_any_last_frame = am->asset_get_any_cnt_last_frame;
+    am->stats.get_any_locked_last_frame = am->asset_get_any_locked_cnt_last_frame;
+    am->stats.upload_us_last_frame = am->upload_spent_us;
     am->stats.upload_bytes_last_pump = 0;
     am->stats.evicted_bytes_last_pump = 0;
     am->stats.vram_budget_bytes = am->vram_budget_bytes;
     am->stats.streaming_enabled = am->streaming_enabled;
-    mutex_unlock_impl(&am->state_m);
+    am->upload_spent_us = 0;
+    threads_mutex_unlock(&am->state_m);
 
-    {
-        mutex_lock_impl(&am->jobs.m);
-        am->stats.jobs_pending = am->jobs.count;
-        mutex_unlock_impl(&am->jobs.m);
+    asset_staging_setup(am);
+    asset_staging_retire(&am->staging);
+    asset_push_deferred(am);
+    asset_reload_color_spaces(am);
 
-        mutex_lock_impl(&am->done.m);
-        am->stats.done_pending = am->done.count;
-        mutex_unlock_impl(&am->done.m);
+    {
+        am->stats.jobs_pending = jobq_live_count(am);
+        am->stats.jobs_stale = atomic_load_u32(&am->jobs_stale);
+        am->stats.done_pending = asset_ring_count(&am->done) + am->upload_has_deferred;
     }
 
+    // Work already on the GPU's way goes first so a big mesh cannot be starved by a stream of small ones.
+    asset_pump_uploads(am);
+
     asset_done_t d;
     uint32_t processed = 0;
+    bool ran = am->upload_spent_us != 0;
 
     while (processed < max_per_frame)
     {
-        mutex_lock_impl(&am->state_m);
+        threads_mutex_lock(&am->state_m);
         const uint64_t upload_budget = am->upload_budget_bytes_per_pump;
         const uint64_t uploaded_so_far = am->stats.upload_bytes_last_pump;
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
 
         if (upload_budget && uploaded_so_far >= upload_budget)
             break;
 
-        if (!doneq_pop(&am->done, &d))
+        const uint64_t remaining_us = asset_upload_remaining_us(am);
+        if (ran && !remaining_us)
             break;
 
-        processed++;
+        if (am->upload_has_deferred)
+        {
+            d = am->upload_deferred;
+            am->upload_has_deferred = 0;
+        }
+        else if (!doneq_pop(am, &d))
+            break;
 
-        mutex_lock_impl(&am->state_m);
-        asset_slot_t *slot = NULL;
-        bool ok_slot = slot_valid_locked(am, d.handle, &slot);
-        if (ok_slot && slot)
-            slot->inflight = 0;
-        mutex_unlock_impl(&am->state_m);
+        const asset_module_desc_t *mod = asset_manager_get_module_by_index(am, d.module_index);
+        const bool sliced = d.ok && mod && mod->upload_fn;
 
-        if (!ok_slot)
+        // Something already ran this frame and the learnt init cost says this one would blow the
+        // deadline: keep it for next frame, where it goes first.
+        if (ran && d.ok && !sliced && (uint32_t)d.asset.type < ASSET_MAX && am->init_cost_us[d.asset.type] > remaining_us)
         {
-            asset_cleanup_by_module(am, &d.asset, d.module_index);
-            continue;
+            am->upload_deferred = d;
+            am->upload_has_deferred = 1;
+            am->stats.uploads_deferred_total++;
+            break;
         }
 
+        processed++;
+        ran = true;
+
         if (!d.ok)
         {
-            asset_any_t old;
-            asset_zero(&old);
-
-            mutex_lock_impl(&am->state_m);
-            slot = NULL;
-            if (slot_valid_locked(am, d.handle, &slot))
-            {
-                old = slot->asset;
-                slot_cleanup_asset_only(am, slot);
-                asset_zero(&slot->asset);
-                slot->asset.state = ASSET_STATE_FAILED;
-                slot->module_index = 0xFFFFu;
-                slot->asset.type = (asset_type_t)slot->requested_type;
-                slot->inflight = 0;
-            }
-            mutex_unlock_impl(&am->state_m);
-
-            asset_cleanup_by_module(am, &old, 0xFFFFu);
-            asset_cleanup_by_module(am, &d.asset, d.module_index);
+            asset_pump_fail(am, &d);
             continue;
         }
 
-        const asset_module_desc_t *mod = asset_manager_get_module_by_index(am, d.module_index);
-        bool init_ok = true;
-        if (mod && mod->init_fn)
-            init_ok = mod->init_fn(am, &d.asset);
-
-        if (!init_ok)
+        if (sliced)
         {
-            asset_cleanup_by_module(am, &d.asset, d.module_index);
-
-            asset_any_t old;
-            asset_zero(&old);
-
-            mutex_lock_impl(&am->state_m);
-            slot = NULL;
-            if (slot_valid_locked(am, d.handle, &slot))
-            {
-                old = slot->asset;
-                slot_cleanup_asset_only(am, slot);
-                asset_zero(&slot->asset);
-                slot->asset.state = ASSET_STATE_FAILED;
-                slot->module_index = 0xFFFFu;
-                slot->asset.type = (asset_type_t)slot->requested_type;
-                slot->inflight = 0;
-            }
-            mutex_unlock_impl(&am->state_m);
-
-            asset_cleanup_by_module(am, &old, 0xFFFFu);
+            asset_upload_job_t u;
+            memset(&u, 0, sizeof(u));
+            u.done = d;
+            vector_impl_push_back(&am->uploads, &u);
             continue;
         }
 
-        asset_any_t old;
-        asset_zero(&old);
-
-        mutex_lock_impl(&am->state_m);
-        slot = NULL;
-        if (slot_valid_locked(am, d.handle, &slot))
-        {
-            uint64_t old_vram = asset_vram_bytes_if_resident(&slot->asset);
-            uint64_t new_vram = asset_vram_bytes_if_resident(&d.asset);
-
-            old = slot->asset;
-            slot_cleanup_asset_only(am, slot);
-
-            ihandle_t ph = d.persistent;
-            if (!ihandle_is_valid(ph))
-                ph = make_persistent_handle(am, d.asset.type);
-
-            d.asset.state = ASSET_STATE_READY;
-            slot->asset = d.asset;
-            slot->module_index = d.module_index;
-            if (!ihandle_is_valid(slot->persistent))
-                slot->persistent = ph;
-
-            if (old_vram)
-            {
-                if (am->stats.vram_resident_bytes >= old_vram)
-                    am->stats.vram_resident_bytes -= old_vram;
-                else
-                    am->stats.vram_resident_bytes = 0;
-                if (am->stats.textures_resident)
-                    am->stats.textures_resident--;
-            }
+        const uint64_t t0 = am_time_us();
+        bool init_ok = true;
+        if (mod && mod->init_fn)
+            init_ok = mod->init_fn(am, &d.asset);
+        const uint64_t dt = am_time_us() - t0;
+        asset_upload_note(am, 0, dt);
+        asset_init_cost_note(am, d.asset.type, dt);
 
-            if (new_vram)
-            {
-                am->stats.vram_resident_bytes += new_vram;
-                am->stats.textures_resident++;
-                am->stats.upload_bytes_last_pump += new_vram;
-                am->stats.textures_loaded_total++;
-            }
+        if (init_ok)
+            asset_pump_publish(am, &d);
+        else
+            asset_pump_fail(am, &d);
+    }
 
-            asset_zero(&d.asset);
-            d.persistent = ihandle_invalid();
-        }
-        mutex_unlock_impl(&am->state_m);
+    asset_pump_uploads(am);
+    am->stats.upload_slices_pending = am->uploads.size;
 
-        asset_cleanup_by_module(am, &old, 0xFFFFu);
-    }
+    asset_staging_fence(&am->staging);
+    asset_staging_usage(&am->staging, &am->stats.staging_used_bytes, &am->stats.staging_alloc_failures);
 
     if (am->streaming_enabled && am->stream_unused_ms)
     {
-        mutex_lock_impl(&am->state_m);
+        threads_mutex_lock(&am->state_m);
         const uint32_t scan_count = (uint32_t)((max_per_frame > 0) ? max_per_frame : 0);
         const uint64_t now_ms = am->now_ms ? am->now_ms : am_time_ms();
         const uint32_t cap = (uint32_t)am->slots.size;
@@ -2634,19 +4215,19 @@ void asset_manager_pump(asset_manager_t *am, uint32_t max_per_frame)
             const uint32_t idx = am->unload_scan_index % cap;
             am->unload_scan_index++;
 
-            asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, idx);
+            asset_slot_t *s = slot_at(&am->slots, idx);
             if (!s)
                 continue;
             if (s->flags & ASSET_FLAG_NO_UNLOAD)
                 continue;
             if (s->path_is_ptr || !s->path || !s->path[0])
                 continue;
-            if (s->inflight)
+            if (s->inflight || s->save_pins)
                 continue;
             if (s->asset.state != ASSET_STATE_READY)
                 continue;
 
-            const uint64_t last = s->last_requested_ms;
+            const uint64_t last = atomic_load_u64(&s->last_requested_ms);
             const uint64_t age_ms = (now_ms > last) ? (now_ms - last) : 0;
             if (age_ms < (uint64_t)am->stream_unused_ms)
                 continue;
@@ -2659,7 +4240,6 @@ void asset_manager_pump(asset_manager_t *am, uint32_t max_per_frame)
             handle_hex_triplet_filesafe(hb, persistent0);
 
             const char *p = s->path;
-            const uint64_t bytes = asset_vram_bytes_if_resident(&s->asset);
 
             // LOG_INFO("Unloading asset: type=%s handle=%s age_ms=%llu bytes=%llu path=%s",
             //          ASSET_TYPE_TO_STRING(s->asset.type),
@@ -2698,33 +4278,14 @@ void asset_manager_pump(asset_manager_t *am, uint32_t max_per_frame)
                     glBindTexture(GL_TEXTURE_2D, (GLuint)img->gl_handle);
                     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)img->stream_current_top_mip);
                     glBindTexture(GL_TEXTURE_2D, 0);
-                }
-
-                continue;
-            }
-
-            asset_cleanup_by_module(am, &s->asset, s->module_index);
-            s->asset.type = (asset_type_t)s->requested_type;
-            s->asset.state = ASSET_STATE_EMPTY;
-            memset(&s->asset.as, 0, sizeof(s->asset.as));
-            s->module_index = 0xFFFFu;
-            s->inflight = 0;
-
-            if (bytes)
-            {
-                if (am->stats.vram_resident_bytes >= bytes)
-                    am->stats.vram_resident_bytes -= bytes;
-                else
-                    am->stats.vram_resident_bytes = 0;
-
-                if (am->stats.textures_resident)
-                    am->stats.textures_resident--;
+                }
 
-                am->stats.evicted_bytes_last_pump += bytes;
-                am->stats.textures_evicted_total++;
+                continue;
             }
+
+            asset_unload_slot_locked(am, s);
         }
-        mutex_unlock_impl(&am->state_m);
+        threads_mutex_unlock(&am->state_m);
     }
 }
 
@@ -2734,10 +4295,10 @@ void asset_manager_pump_frame(asset_manager_t *am)
         return;
 
     uint32_t pump = 1;
-    mutex_lock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
     if (am->pump_per_frame)
         pump = am->pump_per_frame;
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_unlock(&am->state_m);
 
     asset_manager_pump(am, pump);
 }
@@ -2746,8 +4307,7 @@ void asset_manager_begin_frame(asset_manager_t *am)
 {
     if (!am)
         return;
-    am->asset_get_any_cnt_last_frame = am->asset_get_any_cnt_frame;
-    am->asset_get_any_cnt_frame = 0;
+    asset_get_any_counters_roll(am);
 }
 
 void asset_manager_end_frame(asset_manager_t *am)
@@ -2755,7 +4315,7 @@ void asset_manager_end_frame(asset_manager_t *am)
     if (!am)
         return;
 
-    mutex_lock_impl(&am->state_m);
+    threads_mutex_lock(&am->state_m);
 
     am->stats.tex_stream_uploaded_bytes_last_frame = 0;
     am->stats.tex_stream_evicted_bytes_last_frame = 0;
@@ -2768,8 +4328,12 @@ void asset_manager_end_frame(asset_manager_t *am)
     asset_manager_texture_stream_finalize_targets_locked(am);
     asset_manager_texture_stream_evict_unused_locked(am);
     asset_manager_texture_stream_evict_budget_locked(am);
+    asset_manager_texture_stream_trim_ram_locked(am, am->tex_stream_ram_budget_bytes);
+    asset_manager_host_evict_locked(am);
     asset_manager_texture_stream_upload_locked(am);
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_unlock(&am->state_m);
+
+    asset_staging_fence(&am->staging);
 }
 
 const asset_any_t *asset_manager_get_any(const asset_manager_t *am, ihandle_t h)
@@ -2778,19 +4342,28 @@ const asset_any_t *asset_manager_get_any(const asset_manager_t *am, ihandle_t h)
         return NULL;
 
     asset_manager_t *am_mut = (asset_manager_t *)am;
+    atomic_add_u32(&am_mut->asset_get_any_cnt_frame, 1u);
+
+    // Usage timestamps only need frame resolution, so READY hits write them once per frame.
+    asset_slot_t *slot = slot_ready_fast(am_mut, h);
+    if (slot)
+    {
+        if (atomic_load_u64(&slot->last_touched_frame) != atomic_load_u64(&am_mut->frame_index))
+            slot_note_use(am_mut, slot, am_time_ms());
+        return &slot->asset;
+    }
+
+    atomic_add_u32(&am_mut->asset_get_any_locked_cnt_frame, 1u);
     const uint64_t now_ms = am_time_ms();
 
-    mutex_lock_impl(&am_mut->state_m);
-    asset_slot_t *slot = NULL;
+    threads_mutex_lock(&am_mut->state_m);
     bool ok = slot_valid_locked(am_mut, h, &slot);
     if (ok && slot && slot->asset.state == ASSET_STATE_READY)
     {
-        slot->last_touched_frame = am_mut->frame_index;
-        slot->last_requested_ms = now_ms;
+        slot_note_use(am_mut, slot, now_ms);
     }
     const asset_any_t *ret = ok ? &slot->asset : NULL;
-    mutex_unlock_impl(&am_mut->state_m);
-
+    threads_mutex_unlock(&am_mut->state_m);
 
     return ret;
 }
@@ -2800,9 +4373,9 @@ uint32_t asset_manager_debug_get_slot_count(const asset_manager_t *am)
     if (!am)
         return 0;
     asset_manager_t *mut = (asset_manager_t *)am;
-    mutex_lock_impl(&mut->state_m);
+    threads_mutex_lock(&mut->state_m);
     uint32_t n = (uint32_t)mut->slots.size;
-    mutex_unlock_impl(&mut->state_m);
+    threads_mutex_unlock(&mut->state_m);
     return n;
 }
 
@@ -2813,7 +4386,7 @@ bool asset_manager_debug_get_slots(const asset_manager_t *am, asset_debug_slot_t
 
     asset_manager_t *mut = (asset_manager_t *)am;
 
-    mutex_lock_impl(&mut->state_m);
+    threads_mutex_lock(&mut->state_m);
 
     const uint32_t slot_count = (uint32_t)mut->slots.size;
 
@@ -2826,6 +4399,8 @@ bool asset_manager_debug_get_slots(const asset_manager_t *am, asset_debug_slot_t
     out_snapshot->now_ms = mut->now_ms;
     out_snapshot->vram_budget_bytes = mut->vram_budget_bytes;
     out_snapshot->vram_resident_bytes = mut->stats.vram_resident_bytes;
+    out_snapshot->tex_ram_budget_bytes = mut->tex_stream_ram_budget_bytes;
+    out_snapshot->tex_ram_resident_bytes = mut->stats.tex_ram_resident_bytes;
 
     out_snapshot->tex_stream_upload_budget_bytes_per_frame = mut->tex_stream_upload_budget_bytes_per_frame;
     out_snapshot->tex_stream_stable_frames = mut->tex_stream_stable_frames;
@@ -2838,19 +4413,25 @@ bool asset_manager_debug_get_slots(const asset_manager_t *am, asset_debug_slot_t
     out_snapshot->tex_stream_evictions_last_frame = mut->stats.tex_stream_evictions_last_frame;
     out_snapshot->tex_stream_pending_uploads = mut->stats.tex_stream_pending_uploads;
 
-    mutex_lock_impl(&mut->jobs.m);
-    out_snapshot->jobs_pending = mut->jobs.count;
-    mutex_unlock_impl(&mut->jobs.m);
+    out_snapshot->tex_prefetch_issued_total = mut->stats.tex_prefetch_issued_total;
+    out_snapshot->tex_prefetch_hits_total = mut->stats.tex_prefetch_hits_total;
+    out_snapshot->tex_prefetch_misses_total = mut->stats.tex_prefetch_misses_total;
+    out_snapshot->tex_prefetch_wasted_bytes_total = mut->stats.tex_prefetch_wasted_bytes_total;
+
+    out_snapshot->host_budget_bytes = mut->host_budget_bytes;
+    out_snapshot->host_resident_bytes = mut->stats.host_resident_bytes;
+    out_snapshot->host_limit_bytes = mut->stats.host_limit_bytes;
+    out_snapshot->host_used_bytes = mut->stats.host_used_bytes;
+    out_snapshot->host_evictions_total = mut->stats.host_evictions_total;
 
-    mutex_lock_impl(&mut->done.m);
-    out_snapshot->done_pending = mut->done.count;
-    mutex_unlock_impl(&mut->done.m);
+    out_snapshot->jobs_pending = jobq_live_count(mut);
+    out_snapshot->done_pending = asset_ring_count(&mut->done);
 
     const uint32_t ncopy = (out_slots && cap < slot_count) ? cap : slot_count;
 
     for (uint32_t i = 0; i < ncopy; ++i)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&mut->slots, i);
+        asset_slot_t *s = slot_at(&mut->slots, i);
         if (!s)
             continue;
 
@@ -2858,7 +4439,7 @@ bool asset_manager_debug_get_slots(const asset_manager_t *am, asset_debug_slot_t
         memset(d, 0, sizeof(*d));
 
         d->slot_index = i;
-        d->handle = ihandle_make(mut->handle_type, (uint16_t)(i + 1), s->generation);
+        d->handle = ihandle_make(mut->handle_type, i + 1u, s->generation);
         d->persistent = s->persistent;
 
         d->type = s->asset.type;
@@ -2870,9 +4451,15 @@ bool asset_manager_debug_get_slots(const asset_manager_t *am, asset_debug_slot_t
         d->path_is_ptr = s->path_is_ptr;
         d->flags = s->flags;
 
-        d->last_touched_frame = s->last_touched_frame;
-        d->last_requested_ms = s->last_requested_ms;
+        d->last_touched_frame = atomic_load_u64(&s->last_touched_frame);
+        d->last_requested_ms = atomic_load_u64(&s->last_requested_ms);
         d->vram_bytes = asset_vram_bytes_if_resident(&s->asset);
+        d->host_bytes = asset_host_bytes_if_resident(&s->asset);
+        d->use_frames = atomic_load_u32(&s->use_frames);
+        d->dep_count = s->deps.size;
+        d->dependent_count = s->dependents.size;
+        d->deps_pending = s->deps_pending;
+        d->deps_failed = s->deps_failed;
 
         d->img_mip_count = 0;
         d->img_resident_top_mip = 0;
@@ -2919,51 +4506,28 @@ bool asset_manager_debug_get_slots(const asset_manager_t *am, asset_debug_slot_t
         }
     }
 
-    mutex_unlock_impl(&mut->state_m);
+    threads_mutex_unlock(&mut->state_m);
 
     return true;
 }
 
-typedef struct pack_hdr_t
-{
-    uint32_t magic;
-    uint16_t version;
-    uint16_t reserved0;
-    uint32_t toc_count;
-    uint32_t toc_offset;
-    uint32_t data_offset;
-    uint32_t file_size;
-} pack_hdr_t;
-
-typedef struct pack_toc_t
-{
-    uint64_t key;
-    uint16_t type;
-    uint16_t variant;
-    uint32_t flags;
-    uint32_t offset;
-    uint32_t size;
-    uint32_t uncompressed_size;
-    uint8_t codec;
-    uint8_t reserved1;
-    uint16_t reserved2;
-} pack_toc_t;
-
 typedef struct buf_t
 {
     uint8_t *p;
-    uint32_t size;
-    uint32_t cap;
+    uint64_t size;
+    uint64_t cap;
 } buf_t;
 
 static bool buf_reserve(buf_t *b, uint32_t add)
 {
-    uint32_t need = b->size + add;
+    uint64_t need = b->size + add;
     if (need <= b->cap)
         return true;
-    uint32_t nc = b->cap ? b->cap : 4096u;
+    uint64_t nc = b->cap ? b->cap : 4096u;
     while (nc < need)
         nc = nc + (nc >> 1) + 1024u;
+    if (nc > (uint64_t)SIZE_MAX)
+        return false;
     uint8_t *np = (uint8_t *)realloc(b->p, (size_t)nc);
     if (!np)
         return false;
@@ -2994,14 +4558,14 @@ static bool buf_align(buf_t *b, uint32_t align)
 {
     if (align == 0)
         return true;
-    uint32_t m = align - 1u;
+    uint64_t m = align - 1u;
     uint32_t pad = (uint32_t)((align - (b->size & m)) & m);
     if (pad)
         return buf_push_zero(b, pad);
     return true;
 }
 
-static bool write_file_all(const char *path, const void *data, uint32_t size)
+static bool write_file_all(const char *path, const void *data, uint64_t size)
 {
     FILE *f = fopen(path, "wb");
     if (!f)
@@ -3037,6 +4601,94 @@ static bool ensure_directory(const char *path)
 #endif
 }
 
+// What saving a slot needs, copied under state_m so save_blob_fn can run without it. The slot is
+// pinned (save_pins) until asset_save_unpin_locked: it is not unloaded and keeps its paged mip
+// levels, so the pointers in the copy stay valid.
+typedef struct asset_save_snap_t
+{
+    asset_slot_t *slot;
+    asset_any_t asset;
+    asset_image_mip_chain_t chain; // copy of the image's chain, which the slot may change meanwhile
+    const char *path;
+    uint16_t module_index;
+    uint8_t page_levels; // sharp mips are only on disk; mip_source is their pack entry, or empty for the file
+    asset_blob_t mip_source;
+} asset_save_snap_t;
+
+static void asset_save_snapshot_locked(asset_manager_t *am, asset_slot_t *s, asset_save_snap_t *snap)
+{
+    memset(snap, 0, sizeof(*snap));
+    snap->slot = s;
+    snap->asset = s->asset;
+    snap->path = s->path_is_ptr ? NULL : s->path;
+    snap->module_index = s->module_index;
+    s->save_pins++;
+
+    const asset_image_mip_chain_t *m = (s->asset.type == ASSET_IMAGE) ? s->asset.as.image.mips : NULL;
+    if (!m)
+        return;
+
+    snap->chain = *m;
+    if (m->resident_first != 0 && !(m->level[0] && !m->bc_format))
+        snap->page_levels = asset_mip_source_locked(am, s, &snap->mip_source);
+}
+
+static void asset_save_unpin_locked(asset_save_snap_t *snap)
+{
+    if (snap->slot && snap->slot->save_pins)
+        snap->slot->save_pins--;
+    snap->slot = NULL;
+}
+
+// Returns the snapshot's asset in *view, with images pointing at *chain. Sharp mips of a streamed
+// image may only exist on disk; they are read back into one block (*out_paged, freed by the
+// caller). Pixel chains only need mip 0; block-compressed ones are saved level by level and need
+// them all.
+static const asset_any_t *asset_save_view(asset_manager_t *am, const asset_save_snap_t *snap, asset_any_t *view, asset_image_mip_chain_t *chain, uint8_t **out_paged)
+{
+    *out_paged = NULL;
+    *view = snap->asset;
+    if (view->type == ASSET_IMAGE && view->as.image.mips)
+    {
+        *chain = snap->chain;
+        view->as.image.mips = chain;
+    }
+    if (!snap->page_levels)
+        return view;
+
+    const asset_image_mip_chain_t *m = &snap->chain;
+    asset_blob_t blob = snap->mip_source;
+    uint8_t *file = NULL;
+    if (!blob.data)
+    {
+        if (!read_file_all(snap->path, &file, &blob.size))
+            return view;
+        blob.data = file;
+        blob.align = 1;
+        blob.flags = ASSET_BLOB_FLAG_SOURCE_FILE;
+    }
+
+    const uint32_t last = m->bc_format ? m->resident_first - 1u : 0u;
+    uint8_t *levels[ASSET_IMAGE_MAX_MIPS] = {0};
+    const bool ok = asset_mip_read(am, snap->module_index, snap->path, &blob, m, 0, last, levels);
+    free(file);
+    if (!ok)
+        return view;
+
+    uint8_t *block = (uint8_t *)malloc((size_t)m->offset[last + 1u]);
+    for (uint32_t i = 0; i <= last; ++i)
+    {
+        if (block)
+        {
+            memcpy(block + m->offset[i], levels[i], (size_t)m->size[i]);
+            chain->level[i] = block + m->offset[i];
+        }
+        free(levels[i]);
+    }
+    *out_paged = block;
+    return view;
+}
+
 static bool asset_save_blob(asset_manager_t *am, const asset_module_desc_t *m, ihandle_t persistent, const asset_any_t *a, asset_blob_t *out_blob)
 {
     if (!out_blob)
@@ -3074,6 +4726,8 @@ static bool asset_save_blob(asset_manager_t *am, const asset_module_desc_t *m, i
 
     if (!m->save_blob_fn(am, persistent, a, out_blob))
     {
+        if (out_blob->flags & ASSET_BLOB_FLAG_NEEDS_MAIN_THREAD)
+            return false;
         LOG_ERROR("save_blob_fn returned false (type=%s handle=%s module=%s)", type_str, hb, mod_name);
         return false;
     }
@@ -3092,47 +4746,575 @@ static bool asset_save_blob(asset_manager_t *am, const asset_module_desc_t *m, i
         return false;
     }
 
-    return true;
+    return true;
+}
+
+static void asset_free_blob(asset_manager_t *am, const asset_module_desc_t *m, asset_blob_t *blob)
+{
+    if (!blob)
+        return;
+
+    if (m && m->blob_free_fn)
+        m->blob_free_fn(am, blob);
+    else
+        free(blob->data);
+
+    memset(blob, 0, sizeof(*blob));
+}
+
+enum
+{
+    PACK_ITEM_PENDING = 0,
+    PACK_ITEM_OK,
+    PACK_ITEM_FAILED,
+    PACK_ITEM_RETRY_MAIN
+};
+
+#define BUILD_CACHE_MAGIC 0x31434242u // "BBC1"
+#define BUILD_CACHE_VERSION 2u
+
+typedef struct build_cache_hdr_t
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    uint64_t pack_size;
+    uint64_t pack_toc_hash; // ties the index to the pack written alongside it
+} build_cache_hdr_t;
+
+// Fingerprint of the source a blob was produced from. Entries are sorted by key on disk.
+typedef struct build_cache_entry_t
+{
+    uint64_t key;
+    uint64_t module_sig;
+    uint64_t src_mtime;
+    uint64_t src_size;
+    uint64_t src_hash;
+    uint64_t blob_hash;
+    uint32_t align;
+    uint32_t reserved0;
+} build_cache_entry_t;
+
+typedef struct build_cache_t
+{
+    asset_pack_t pack;
+    build_cache_entry_t *entries;
+    uint32_t count;
+} build_cache_t;
+
+typedef struct pack_item_t
+{
+    asset_save_snap_t snap;
+    const asset_module_desc_t *module;
+    ihandle_t persistent;
+
+    build_cache_entry_t fp;
+    uint8_t has_source; // slot has a source file and the build cache is enabled
+    uint8_t src_hashed;
+    uint8_t cached;
+
+    asset_blob_t blob;
+    uint8_t *packed; // codec output, replaces blob.data as the payload when set
+
+    const uint8_t *payload;
+    uint32_t payload_size;
+    uint32_t uncompressed_size;
+    uint8_t codec;
+    uint8_t state;
+    uint64_t hash;
+} pack_item_t;
+
+typedef struct pack_encode_ctx_t
+{
+    asset_manager_t *am;
+    const build_cache_t *cache;
+    pack_item_t *items;
+} pack_encode_ctx_t;
+
+static uint64_t pack_blob_hash(const uint8_t *p, uint64_t n)
+{
+    // Word-at-a-time multiply/xorshift mix; collisions are resolved by comparing bytes.
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (n * 0xC2B2AE3D27D4EB4Full);
+    uint64_t i = 0;
+    for (; i + 8u <= n; i += 8u)
+    {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        h ^= v * 0x87C37B91114253D5ull;
+        h = (h << 31) | (h >> 33);
+        h *= 0x4CF5AD432745937Full;
+    }
+    for (; i < n; ++i)
+    {
+        h ^= p[i];
+        h *= 0x100000001B3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+static bool build_cache_stat_source(const char *path, uint64_t *out_mtime, uint64_t *out_size)
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA fa;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &fa))
+        return false;
+    *out_mtime = ((uint64_t)fa.ftLastWriteTime.dwHighDateTime << 32) | (uint64_t)fa.ftLastWriteTime.dwLowDateTime;
+    *out_size = ((uint64_t)fa.nFileSizeHigh << 32) | (uint64_t)fa.nFileSizeLow;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return false;
+#if defined(__APPLE__)
+    *out_mtime = (uint64_t)st.st_mtimespec.tv_sec * 1000000000ull + (uint64_t)st.st_mtimespec.tv_nsec;
+#else
+    *out_mtime = (uint64_t)st.st_mtim.tv_sec * 1000000000ull + (uint64_t)st.st_mtim.tv_nsec;
+#endif
+    *out_size = (uint64_t)st.st_size;
+#endif
+    return true;
+}
+
+static bool build_cache_hash_source(pack_item_t *it)
+{
+    if (it->src_hashed)
+        return true;
+
+    asset_pack_t m;
+    memset(&m, 0, sizeof(m));
+    if (!pack_map_file(it->snap.path, &m))
+        return false;
+
+    bool ok = m.size == it->fp.src_size && m.size <= 0xFFFFFFFFull;
+    if (ok)
+    {
+        it->fp.src_hash = pack_blob_hash(m.base, m.size);
+        it->src_hashed = 1;
+    }
+    pack_unmap(&m);
+    return ok;
+}
+
+// `options` covers pack settings that change what save_blob_fn writes.
+static uint64_t build_cache_module_sig(const asset_module_desc_t *load, const asset_module_desc_t *save, uint8_t codec, uint32_t options)
+{
+    const asset_module_desc_t *ms[2] = {load, save};
+    uint64_t h = 0xCBF29CE484222325ull ^ codec ^ ((uint64_t)options << 8);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        const char *name = (ms[i] && ms[i]->name) ? ms[i]->name : "";
+        h = (h ^ pack_blob_hash((const uint8_t *)name, strlen(name))) * 0x100000001B3ull;
+        h = (h ^ (ms[i] ? ms[i]->version : 0u)) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+static const build_cache_entry_t *build_cache_find(const build_cache_t *c, uint64_t key)
+{
+    uint32_t lo = 0;
+    uint32_t hi = c->count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + ((hi - lo) >> 1);
+        if (c->entries[mid].key < key)
+            lo = mid + 1u;
+        else
+            hi = mid;
+    }
+    if (lo < c->count && c->entries[lo].key == key)
+        return &c->entries[lo];
+    return NULL;
+}
+
+// Points the item at the previous build's blob when its source and modules are unchanged.
+static bool build_cache_reuse(const build_cache_t *c, pack_item_t *it)
+{
+    if (!build_cache_stat_source(it->snap.path, &it->fp.src_mtime, &it->fp.src_size))
+    {
+        it->has_source = 0;
+        return false;
+    }
+
+    if (!c || !c->count)
+        return false;
+
+    const build_cache_entry_t *e = build_cache_find(c, it->fp.key);
+    if (!e || e->module_sig != it->fp.module_sig || e->src_size != it->fp.src_size)
+        return false;
+
+    // A new mtime alone (checkout, copy) is not a change; compare content before re-encoding.
+    if (e->src_mtime != it->fp.src_mtime)
+    {
+        if (!build_cache_hash_source(it) || it->fp.src_hash != e->src_hash)
+            return false;
+    }
+    else
+    {
+        it->fp.src_hash = e->src_hash;
+        it->src_hashed = 1;
+    }
+
+    const pack_toc_t *t = pack_find_entry(&c->pack, it->fp.key);
+    if (!t)
+        return false;
+
+    it->payload = c->pack.base + t->offset;
+    it->payload_size = t->size;
+    it->uncompressed_size = t->uncompressed_size;
+    it->codec = t->codec;
+    it->blob.flags = (uint8_t)t->flags;
+    it->blob.align = e->align;
+    it->hash = e->blob_hash;
+    it->cached = 1;
+    it->state = PACK_ITEM_OK;
+    return true;
+}
+
+static bool build_cache_path(char *out, size_t cap, const char *dir, const char *name)
+{
+#if defined(_WIN32)
+    int n = snprintf(out, cap, "%s\\%s", dir, name);
+#else
+    int n = snprintf(out, cap, "%s/%s", dir, name);
+#endif
+    return n > 0 && (size_t)n < cap;
+}
+
+static uint64_t build_cache_toc_hash(const uint8_t *pack, uint64_t size)
+{
+    pack_hdr_t hdr;
+    memcpy(&hdr, pack, sizeof(hdr));
+    if (hdr.toc_offset > size || (uint64_t)hdr.toc_count * sizeof(pack_toc_t) > size - hdr.toc_offset)
+        return 0;
+    return pack_blob_hash(pack + hdr.toc_offset, (uint64_t)hdr.toc_count * sizeof(pack_toc_t));
+}
+
+static void build_cache_free(build_cache_t *c)
+{
+    pack_unmap(&c->pack);
+    free(c->entries);
+    memset(c, 0, sizeof(*c));
+}
+
+static bool build_cache_load(build_cache_t *c, const char *dir)
+{
+    memset(c, 0, sizeof(*c));
+
+    char pack_path[512];
+    char idx_path[512];
+    if (!build_cache_path(pack_path, sizeof(pack_path), dir, "build_cache.pack") || !build_cache_path(idx_path, sizeof(idx_path), dir, "build_cache.idx"))
+        return false;
+
+    FILE *f = fopen(idx_path, "rb");
+    if (!f)
+        return false;
+
+    build_cache_hdr_t hdr;
+    bool ok = fread(&hdr, 1, sizeof(hdr), f) == sizeof(hdr) && hdr.magic == BUILD_CACHE_MAGIC && hdr.version == BUILD_CACHE_VERSION;
+    if (ok && hdr.entry_count)
+    {
+        c->entries = (build_cache_entry_t *)malloc(sizeof(build_cache_entry_t) * hdr.entry_count);
+        ok = c->entries && fread(c->entries, sizeof(build_cache_entry_t), hdr.entry_count, f) == hdr.entry_count;
+        c->count = hdr.entry_count;
+    }
+    fclose(f);
+
+    if (ok)
+        ok = pack_map_file(pack_path, &c->pack) && pack_validate(&c->pack, pack_path);
+
+    if (ok)
+    {
+        pack_hdr_t ph;
+        memcpy(&ph, c->pack.base, sizeof(ph));
+        c->pack.toc = c->pack.base + ph.toc_offset;
+        c->pack.toc_count = ph.toc_count;
+        ok = c->pack.size == hdr.pack_size && build_cache_toc_hash(c->pack.base, c->pack.size) == hdr.pack_toc_hash;
+    }
+
+    for (uint32_t i = 1; ok && i < c->count; ++i)
+        ok = c->entries[i - 1u].key < c->entries[i].key;
+
+    if (!ok)
+    {
+        LOG_WARN("build_pack: ignoring stale build cache in '%s'", dir);
+        build_cache_free(c);
+    }
+    return ok;
+}
+
+static bool build_cache_replace_file(const char *tmp, const char *path)
+{
+#if defined(_WIN32)
+    return MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(tmp, path) == 0;
+#endif
+}
+
+static int build_cache_entry_cmp(const void *a, const void *b)
+{
+    uint64_t x = ((const build_cache_entry_t *)a)->key;
+    uint64_t y = ((const build_cache_entry_t *)b)->key;
+    return (x > y) - (x < y);
+}
+
+// Writes the new pack and its index next to each other, then swaps them in. The previous cache
+// is unmapped first since Windows cannot replace a mapped file.
+static bool build_cache_store(build_cache_t *c, const char *dir, const uint8_t *pack, uint64_t pack_size, vector_t *entries)
+{
+    if (!ensure_directory(dir))
+        return false;
+
+    char pack_path[512];
+    char idx_path[512];
+    char pack_tmp[520];
+    char idx_tmp[520];
+    if (!build_cache_path(pack_path, sizeof(pack_path), dir, "build_cache.pack") || !build_cache_path(idx_path, sizeof(idx_path), dir, "build_cache.idx"))
+        return false;
+    snprintf(pack_tmp, sizeof(pack_tmp), "%s.tmp", pack_path);
+    snprintf(idx_tmp, sizeof(idx_tmp), "%s.tmp", idx_path);
+
+    if (entries->size > 1)
+    {
+        qsort(entries->data, entries->size, sizeof(build_cache_entry_t), build_cache_entry_cmp);
+
+        // Several slots can share a source; they produce the same key and the pack keeps one.
+        uint32_t w = 1;
+        for (uint32_t r = 1; r < entries->size; ++r)
+        {
+            build_cache_entry_t *prev = (build_cache_entry_t *)vector_impl_at(entries, w - 1u);
+            build_cache_entry_t *cur = (build_cache_entry_t *)vector_impl_at(entries, r);
+            if (cur->key == prev->key)
+                continue;
+            if (w != r)
+                memcpy(vector_impl_at(entries, w), cur, sizeof(*cur));
+            w++;
+        }
+        entries->size = w;
+    }
+
+    build_cache_hdr_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = BUILD_CACHE_MAGIC;
+    hdr.version = BUILD_CACHE_VERSION;
+    hdr.entry_count = entries->size;
+    hdr.pack_size = pack_size;
+    hdr.pack_toc_hash = build_cache_toc_hash(pack, pack_size);
+
+    bool ok = write_file_all(pack_tmp, pack, pack_size);
+
+    FILE *f = ok ? fopen(idx_tmp, "wb") : NULL;
+    if (f)
+    {
+        ok = fwrite(&hdr, 1, sizeof(hdr), f) == sizeof(hdr);
+        if (ok && entries->size)
+            ok = fwrite(entries->data, sizeof(build_cache_entry_t), entries->size, f) == entries->size;
+        ok = (fclose(f) == 0) && ok;
+    }
+    else
+    {
+        ok = false;
+    }
+
+    build_cache_free(c);
+
+    if (ok)
+        ok = build_cache_replace_file(pack_tmp, pack_path) && build_cache_replace_file(idx_tmp, idx_path);
+
+    if (!ok)
+    {
+        remove(pack_tmp);
+        remove(idx_tmp);
+        LOG_WARN("build_pack: failed to write build cache to '%s'", dir);
+    }
+    return ok;
+}
+
+static void pack_encode_item(asset_manager_t *am, const build_cache_t *cache, pack_item_t *it)
+{
+    if (it->state == PACK_ITEM_PENDING && it->has_source && build_cache_reuse(cache, it))
+        return;
+
+    asset_any_t view;
+    asset_image_mip_chain_t chain;
+    uint8_t *paged = NULL;
+    const asset_any_t *a = asset_save_view(am, &it->snap, &view, &chain, &paged);
+    const bool saved = asset_save_blob(am, it->module, it->persistent, a, &it->blob);
+    free(paged);
+
+    if (!saved)
+    {
+        if (it->blob.flags & ASSET_BLOB_FLAG_NEEDS_MAIN_THREAD)
+        {
+            memset(&it->blob, 0, sizeof(it->blob));
+            it->state = PACK_ITEM_RETRY_MAIN;
+            return;
+        }
+
+        char hb[64];
+        handle_hex_triplet(hb, it->persistent);
+        LOG_ERROR("Asset save failed: type=%s handle=%s", ASSET_TYPE_TO_STRING(it->snap.asset.type), hb);
+        asset_free_blob(am, it->module, &it->blob);
+        it->state = PACK_ITEM_FAILED;
+        return;
+    }
+
+    it->payload = it->blob.data;
+    it->payload_size = it->blob.size;
+    it->codec = it->blob.codec;
+    it->uncompressed_size = it->blob.uncompressed_size;
+
+    uint8_t want = am->pack_codec[it->snap.asset.type];
+    if (want != ASSET_CODEC_NONE && it->blob.codec == ASSET_CODEC_NONE && !(it->blob.flags & ASSET_BLOB_FLAG_PRECOMPRESSED))
+    {
+        uint8_t *packed = NULL;
+        uint32_t packed_size = 0;
+
+        // Keep incompressible blobs raw so loaders can still reference them in place.
+        if (asset_codec_encode(want, it->blob.data, it->blob.size, &packed, &packed_size) && packed_size < it->blob.size - it->blob.size / 32u)
+        {
+            it->packed = packed;
+            it->payload = packed;
+            it->payload_size = packed_size;
+            it->codec = want;
+            it->uncompressed_size = it->blob.size;
+        }
+        else
+        {
+            free(packed);
+        }
+    }
+
+    it->hash = pack_blob_hash(it->payload, it->payload_size);
+    it->state = PACK_ITEM_OK;
+
+    if (it->has_source && !build_cache_hash_source(it))
+        it->has_source = 0;
 }
 
-static void asset_free_blob(asset_manager_t *am, const asset_module_desc_t *m, asset_blob_t *blob)
+static void pack_encode_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
 {
-    if (!blob)
-        return;
+    (void)worker_index;
+    pack_encode_ctx_t *ctx = (pack_encode_ctx_t *)user;
+    for (uint32_t i = begin; i < end; ++i)
+        pack_encode_item(ctx->am, ctx->cache, &ctx->items[i]);
+}
 
-    if (m && m->blob_free_fn)
-        m->blob_free_fn(am, blob);
-    else
-        free(blob->data);
+static void pack_item_release(asset_manager_t *am, pack_item_t *it)
+{
+    if (it->blob.data)
+        asset_free_blob(am, it->module, &it->blob);
+    free(it->packed);
+    it->packed = NULL;
+    it->payload = NULL;
+}
 
-    memset(blob, 0, sizeof(*blob));
+// Content-addressed store of blobs already written to the pack: hash -> (offset, size).
+typedef struct pack_dedup_entry_t
+{
+    uint64_t hash;
+    uint64_t offset;
+    uint32_t size;
+} pack_dedup_entry_t;
+
+typedef struct pack_dedup_t
+{
+    pack_dedup_entry_t *entries;
+    uint32_t cap;
+    uint32_t count;
+    uint32_t shared_count;
+    uint64_t shared_bytes;
+} pack_dedup_t;
+
+static uint64_t pack_dedup_find(pack_dedup_t *d, const buf_t *data, const pack_item_t *it)
+{
+    if (!d->cap)
+        return UINT64_MAX;
+
+    uint32_t mask = d->cap - 1u;
+    for (uint32_t i = (uint32_t)it->hash & mask;; i = (i + 1u) & mask)
+    {
+        const pack_dedup_entry_t *e = &d->entries[i];
+        if (!e->size)
+            return UINT64_MAX;
+        if (e->hash == it->hash && e->size == it->payload_size && memcmp(data->p + e->offset, it->payload, it->payload_size) == 0)
+        {
+            d->shared_count++;
+            d->shared_bytes += it->payload_size;
+            return e->offset;
+        }
+    }
 }
 
-static bool asset_manager_build_pack_locked(asset_manager_t *am, uint8_t **out_data, uint32_t *out_size)
+static bool pack_dedup_insert(pack_dedup_t *d, uint64_t hash, uint64_t offset, uint32_t size)
 {
-    *out_data = NULL;
-    *out_size = 0;
+    if ((d->count + 1u) * 2u > d->cap)
+    {
+        uint32_t ncap = d->cap ? d->cap * 2u : 256u;
+        pack_dedup_entry_t *ne = (pack_dedup_entry_t *)calloc(ncap, sizeof(pack_dedup_entry_t));
+        if (!ne)
+            return false;
 
-    vector_t tocs = vector_impl_create_vector(sizeof(pack_toc_t));
+        for (uint32_t i = 0; i < d->cap; ++i)
+        {
+            pack_dedup_entry_t *e = &d->entries[i];
+            if (!e->size)
+                continue;
+            uint32_t j = (uint32_t)e->hash & (ncap - 1u);
+            while (ne[j].size)
+                j = (j + 1u) & (ncap - 1u);
+            ne[j] = *e;
+        }
 
-    buf_t data;
-    memset(&data, 0, sizeof(data));
+        free(d->entries);
+        d->entries = ne;
+        d->cap = ncap;
+    }
 
-    pack_hdr_t hdr;
-    memset(&hdr, 0, sizeof(hdr));
-    hdr.magic = 0x4B434150u;
-    hdr.version = 1;
+    uint32_t mask = d->cap - 1u;
+    uint32_t i = (uint32_t)hash & mask;
+    while (d->entries[i].size)
+        i = (i + 1u) & mask;
 
-    bool ok = true;
+    d->entries[i].hash = hash;
+    d->entries[i].offset = offset;
+    d->entries[i].size = size;
+    d->count++;
+    return true;
+}
 
-    if (!buf_push_bytes(&data, &hdr, (uint32_t)sizeof(hdr)))
-        ok = false;
+static void pack_dedup_free(pack_dedup_t *d)
+{
+    free(d->entries);
+    memset(d, 0, sizeof(*d));
+}
+
+static int pack_toc_cmp(const void *a, const void *b)
+{
+    const pack_toc_t *x = (const pack_toc_t *)a;
+    const pack_toc_t *y = (const pack_toc_t *)b;
+    if (x->key < y->key)
+        return -1;
+    if (x->key > y->key)
+        return 1;
+    // Stable with respect to build order so duplicate resolution is deterministic.
+    if (x->offset < y->offset)
+        return -1;
+    return x->offset > y->offset;
+}
 
+// Pins and snapshots every READY slot that has a save module. A `cache_dir` also fills in the
+// source fingerprints for the build cache.
+static void asset_save_collect_locked(asset_manager_t *am, vector_t *items, const char *cache_dir)
+{
     uint32_t slot_count = (uint32_t)am->slots.size;
 
-    for (uint32_t i = 0; ok && i < slot_count; ++i)
+    for (uint32_t i = 0; i < slot_count; ++i)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
+        asset_slot_t *s = slot_at(&am->slots, i);
         if (!s)
             continue;
 
@@ -3175,57 +5357,174 @@ static bool asset_manager_build_pack_locked(asset_manager_t *am, uint8_t **out_d
             continue;
         }
 
-        asset_blob_t blob;
-        memset(&blob, 0, sizeof(blob));
-
-        if (!asset_save_blob(am, m, persistent, &s->asset, &blob))
+        pack_item_t it;
+        memset(&it, 0, sizeof(it));
+        asset_save_snapshot_locked(am, s, &it.snap);
+        it.module = m;
+        it.persistent = persistent;
+        if (cache_dir && s->path && !s->path_is_ptr)
         {
-            char hb[64];
-            handle_hex_triplet(hb, persistent);
-            LOG_ERROR("Asset save failed: type=%s handle=%s", ASSET_TYPE_TO_STRING(s->asset.type), hb);
-            asset_free_blob(am, m, &blob);
-            continue;
+            it.has_source = 1;
+            it.fp.key = pack_persistent_key(persistent);
+            uint32_t options = 0;
+            if (s->asset.type == ASSET_IMAGE)
+                options = am->pack_tex_compress | ((uint32_t)am->mip_filter << 1) | ((uint32_t)am->mip_srgb << 3) | (s->asset.as.image.color_space << 4);
+            it.fp.module_sig = build_cache_module_sig(asset_manager_get_module_by_index(am, s->module_index), m, am->pack_codec[s->asset.type], options);
         }
+        vector_impl_push_back(items, &it);
+    }
+}
 
-        if (!buf_align(&data, blob.align ? blob.align : 64u))
-        {
-            ok = false;
-            asset_free_blob(am, m, &blob);
-            break;
-        }
+static void asset_save_release_items(asset_manager_t *am, vector_t *items)
+{
+    threads_mutex_lock(&am->state_m);
+    for (uint32_t i = 0; i < items->size; ++i)
+        asset_save_unpin_locked(&((pack_item_t *)vector_impl_at(items, i))->snap);
+    threads_mutex_unlock(&am->state_m);
+    vector_impl_free(items);
+}
+
+static bool asset_manager_build_pack_items(asset_manager_t *am, vector_t *items, const char *cache_dir, uint8_t **out_data, uint64_t *out_size)
+{
+    *out_data = NULL;
+    *out_size = 0;
+
+    vector_t tocs = vector_impl_create_vector(sizeof(pack_toc_t));
+
+    buf_t data;
+    memset(&data, 0, sizeof(data));
+
+    pack_hdr_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = PACK_MAGIC;
+    hdr.version = PACK_VERSION;
+
+    bool ok = true;
+
+    if (!buf_push_bytes(&data, &hdr, (uint32_t)sizeof(hdr)))
+        ok = false;
+
+    build_cache_t cache;
+    memset(&cache, 0, sizeof(cache));
+    if (cache_dir)
+        build_cache_load(&cache, cache_dir);
+
+    vector_t cache_entries = vector_impl_create_vector(sizeof(build_cache_entry_t));
+    uint32_t cache_hits = 0;
+
+    pack_dedup_t dedup;
+    memset(&dedup, 0, sizeof(dedup));
+
+    pack_encode_ctx_t ctx;
+    ctx.am = am;
+    ctx.cache = &cache;
+
+    // Encode a window of assets in parallel, then append it in slot order so the output only
+    // depends on the slot table. The window bounds how many encoded blobs are alive at once.
+    uint32_t window = jobs_pool_size() * 4u;
+    if (window < 4u)
+        window = 4u;
+
+    for (uint32_t w0 = 0; ok && w0 < items->size; w0 += window)
+    {
+        uint32_t w1 = w0 + window;
+        if (w1 > items->size)
+            w1 = items->size;
+
+        ctx.items = (pack_item_t *)vector_impl_at(items, w0);
+        jobs_parallel_for(w1 - w0, 1u, pack_encode_range, &ctx);
 
-        uint32_t off = data.size;
-        if (!buf_push_bytes(&data, blob.data, blob.size))
+        for (uint32_t i = w0; i < w1; ++i)
         {
-            ok = false;
-            asset_free_blob(am, m, &blob);
-            break;
+            pack_item_t *it = (pack_item_t *)vector_impl_at(items, i);
+
+            // GL readbacks cannot run on pool workers; redo those on this thread.
+            if (it->state == PACK_ITEM_RETRY_MAIN)
+                pack_encode_item(am, &cache, it);
+
+            if (it->state == PACK_ITEM_OK && ok)
+            {
+                pack_toc_t e;
+                memset(&e, 0, sizeof(e));
+                e.key = pack_persistent_key(it->persistent);
+                e.type = (uint16_t)it->snap.asset.type;
+                e.variant = 0;
+                e.flags = (uint32_t)it->blob.flags;
+                e.size = it->payload_size;
+                e.uncompressed_size = it->uncompressed_size;
+                e.codec = it->codec;
+
+                uint64_t shared = pack_dedup_find(&dedup, &data, it);
+                if (shared != UINT64_MAX)
+                {
+                    e.offset = shared;
+                }
+                else
+                {
+                    uint32_t align = it->blob.align ? it->blob.align : 64u;
+                    if (!buf_align(&data, align) || !buf_push_bytes(&data, it->payload, it->payload_size))
+                        ok = false;
+                    e.offset = data.size - it->payload_size;
+                    if (ok && !pack_dedup_insert(&dedup, it->hash, e.offset, it->payload_size))
+                        ok = false;
+                }
+
+                if (ok)
+                    vector_impl_push_back(&tocs, &e);
+
+                if (ok && it->has_source)
+                {
+                    it->fp.blob_hash = it->hash;
+                    it->fp.align = it->blob.align;
+                    vector_impl_push_back(&cache_entries, &it->fp);
+                    cache_hits += it->cached;
+                }
+            }
+
+            pack_item_release(am, it);
         }
+    }
+
+    for (uint32_t i = 0; i < items->size; ++i)
+        pack_item_release(am, (pack_item_t *)vector_impl_at(items, i));
 
-        pack_toc_t e;
-        memset(&e, 0, sizeof(e));
-        e.key = ((uint64_t)((uint16_t)s->asset.type) << 48) | (uint64_t)persistent.value;
-        e.type = (uint16_t)s->asset.type;
-        e.variant = 0;
-        e.flags = (uint32_t)blob.flags;
-        e.offset = off;
-        e.size = blob.size;
-        e.uncompressed_size = blob.uncompressed_size;
-        e.codec = blob.codec;
+    if (dedup.shared_count)
+        LOG_INFO("build_pack: %u duplicate blobs shared (%" PRIu64 " bytes saved)", (unsigned)dedup.shared_count, dedup.shared_bytes);
+    pack_dedup_free(&dedup);
 
-        vector_impl_push_back(&tocs, &e);
+    if (cache_dir)
+        LOG_INFO("build_pack: %u of %u source assets reused from build cache", (unsigned)cache_hits, (unsigned)cache_entries.size);
+
+    if (ok && tocs.size > 1)
+    {
+        qsort(tocs.data, tocs.size, sizeof(pack_toc_t), pack_toc_cmp);
 
-        asset_free_blob(am, m, &blob);
+        // Readers binary-search the TOC, so keys must be unique; first entry wins.
+        uint32_t w = 1;
+        for (uint32_t r = 1; r < tocs.size; ++r)
+        {
+            pack_toc_t *prev = (pack_toc_t *)vector_impl_at(&tocs, w - 1u);
+            pack_toc_t *cur = (pack_toc_t *)vector_impl_at(&tocs, r);
+            if (cur->key == prev->key)
+            {
+                LOG_WARN("build_pack: duplicate key %016" PRIx64 ", keeping first entry", cur->key);
+                continue;
+            }
+            if (w != r)
+                memcpy(vector_impl_at(&tocs, w), cur, sizeof(*cur));
+            w++;
+        }
+        tocs.size = w;
     }
 
     if (ok)
     {
-        hdr.toc_count = (uint32_t)tocs.size;
-        hdr.toc_offset = data.size;
-        hdr.data_offset = (uint32_t)sizeof(pack_hdr_t);
-
         if (!buf_align(&data, 16))
             ok = false;
+
+        hdr.toc_count = (uint32_t)tocs.size;
+        hdr.toc_offset = data.size;
+        hdr.data_offset = sizeof(pack_hdr_t);
     }
 
     for (uint32_t i = 0; ok && i < tocs.size; ++i)
@@ -3241,6 +5540,10 @@ static bool asset_manager_build_pack_locked(asset_manager_t *am, uint8_t **out_d
         memcpy(data.p, &hdr, sizeof(hdr));
         *out_data = data.p;
         *out_size = data.size;
+
+        // Cached payloads point into the old cache mapping; they were copied into data above.
+        if (cache_dir)
+            build_cache_store(&cache, cache_dir, data.p, data.size, &cache_entries);
     }
     else
     {
@@ -3249,11 +5552,13 @@ static bool asset_manager_build_pack_locked(asset_manager_t *am, uint8_t **out_d
         *out_size = 0;
     }
 
+    build_cache_free(&cache);
+    vector_impl_free(&cache_entries);
     vector_impl_free(&tocs);
     return ok;
 }
 
-static bool asset_manager_save_separate_assets_locked(asset_manager_t *am, const char *base_path)
+static bool asset_manager_save_separate_assets(asset_manager_t *am, vector_t *items, const char *base_path)
 {
     const char *dir = (base_path && base_path[0]) ? base_path : ".";
     if (strcmp(dir, ".") != 0)
@@ -3262,90 +5567,53 @@ static bool asset_manager_save_separate_assets_locked(asset_manager_t *am, const
             return false;
     }
 
-    uint32_t slot_count = (uint32_t)am->slots.size;
-
-    for (uint32_t i = 0; i < slot_count; ++i)
+    for (uint32_t i = 0; i < items->size; ++i)
     {
-        asset_slot_t *s = (asset_slot_t *)vector_impl_at(&am->slots, i);
-        if (!s)
-            continue;
-
-        if (s->asset.state != ASSET_STATE_READY)
-            continue;
-
-        if ((unsigned)s->asset.type >= (unsigned)ASSET_MAX)
-            continue;
-
-        if (!am->asset_type_has_save[s->asset.type])
-        {
-            ihandle_t persistent0 = s->persistent;
-            if (!ihandle_is_valid(persistent0))
-                persistent0 = make_persistent_handle(am, s->asset.type);
-            char hb0[64];
-            handle_hex_triplet_filesafe(hb0, persistent0);
-            LOG_ERROR("Asset has no save function registered: type=%s handle=%s", ASSET_TYPE_TO_STRING(s->asset.type), hb0);
-            continue;
-        }
-
-        ihandle_t persistent = s->persistent;
-        if (!ihandle_is_valid(persistent))
-            persistent = make_persistent_handle(am, s->asset.type);
-
-        uint32_t midx32 = asset_manager_find_first_save_module_index(am, s->asset.type);
-        if (midx32 == 0xFFFFFFFFu)
-        {
-            char hb[64];
-            handle_hex_triplet_filesafe(hb, persistent);
-            LOG_ERROR("Asset has no save module: type=%s handle=%s", ASSET_TYPE_TO_STRING(s->asset.type), hb);
-            continue;
-        }
-
-        const asset_module_desc_t *m = asset_manager_get_module_by_index(am, midx32);
-        if (!m || !m->save_blob_fn || !m->blob_free_fn)
-        {
-            char hb[64];
-            handle_hex_triplet_filesafe(hb, persistent);
-            LOG_ERROR("Asset save module invalid: type=%s handle=%s", ASSET_TYPE_TO_STRING(s->asset.type), hb);
-            continue;
-        }
+        pack_item_t *it = (pack_item_t *)vector_impl_at(items, i);
+        const asset_type_t type = it->snap.asset.type;
 
         asset_blob_t blob;
         memset(&blob, 0, sizeof(blob));
 
-        if (!asset_save_blob(am, m, persistent, &s->asset, &blob))
+        asset_any_t view;
+        asset_image_mip_chain_t chain;
+        uint8_t *paged = NULL;
+        const asset_any_t *a = asset_save_view(am, &it->snap, &view, &chain, &paged);
+        const bool saved = asset_save_blob(am, it->module, it->persistent, a, &blob);
+        free(paged);
+
+        char hb[64];
+        handle_hex_triplet_filesafe(hb, it->persistent);
+
+        if (!saved)
         {
-            char hb[64];
-            handle_hex_triplet_filesafe(hb, persistent);
-            LOG_ERROR("Asset save failed: type=%s handle=%s", ASSET_TYPE_TO_STRING(s->asset.type), hb);
-            asset_free_blob(am, m, &blob);
+            LOG_ERROR("Asset save failed: type=%s handle=%s", ASSET_TYPE_TO_STRING(type), hb);
+            asset_free_blob(am, it->module, &blob);
             continue;
         }
 
-        char hb[64];
-        handle_hex_triplet_filesafe(hb, persistent);
-
         char path[512];
 #if defined(_WIN32)
-        snprintf(path, sizeof(path), "%s\\%s_%s.iasset", dir, ASSET_TYPE_TO_STRING(s->asset.type), hb);
+        snprintf(path, sizeof(path), "%s\\%s_%s.iasset", dir, ASSET_TYPE_TO_STRING(type), hb);
 #else
-        snprintf(path, sizeof(path), "%s/%s_%s.iasset", dir, ASSET_TYPE_TO_STRING(s->asset.type), hb);
+        snprintf(path, sizeof(path), "%s/%s_%s.iasset", dir, ASSET_TYPE_TO_STRING(type), hb);
 #endif
 
         if (!write_file_all(path, blob.data, blob.size))
             LOG_ERROR("Failed to write asset file: %s", path);
 
-        asset_free_blob(am, m, &blob);
+        asset_free_blob(am, it->module, &blob);
     }
 
     return true;
 }
 
-bool asset_manager_build_pack(asset_manager_t *am, uint8_t **out_data, uint32_t *out_size)
+bool asset_manager_build_pack(asset_manager_t *am, uint8_t **out_data, uint64_t *out_size)
 {
     return asset_manager_build_pack_ex(am, out_data, out_size, SAVE_FLAG_NONE, NULL);
 }
 
-bool asset_manager_build_pack_ex(asset_manager_t *am, uint8_t **out_data, uint32_t *out_size, uint32_t flags, const char *base_path)
+bool asset_manager_build_pack_ex(asset_manager_t *am, uint8_t **out_data, uint64_t *out_size, uint32_t flags, const char *base_path)
 {
     if (!am || !out_data || !out_size)
         return false;
@@ -3354,13 +5622,29 @@ bool asset_manager_build_pack_ex(asset_manager_t *am, uint8_t **out_data, uint32
     *out_size = 0;
 
     bool ok = false;
+    const bool separate = (flags & SAVE_FLAG_SEPARATE_ASSETS) != 0;
+
+    // Only the snapshot takes state_m; saving, encoding and writing run without it so loads and
+    // pumps carry on during a build. build_m keeps concurrent builds off the shared build cache.
+    threads_mutex_lock(&am->build_m);
+
+    vector_t items = vector_impl_create_vector(sizeof(pack_item_t));
+    char *cache_dir = NULL;
+
+    threads_mutex_lock(&am->state_m);
+    if (!separate && am->build_cache_dir)
+        cache_dir = strdup(am->build_cache_dir);
+    asset_save_collect_locked(am, &items, cache_dir);
+    threads_mutex_unlock(&am->state_m);
 
-    mutex_lock_impl(&am->state_m);
-    if (flags & SAVE_FLAG_SEPARATE_ASSETS)
-        ok = asset_manager_save_separate_assets_locked(am, base_path);
+    if (separate)
+        ok = asset_manager_save_separate_assets(am, &items, base_path);
     else
-        ok = asset_manager_build_pack_locked(am, out_data, out_size);
-    mutex_unlock_impl(&am->state_m);
+        ok = asset_manager_build_pack_items(am, &items, cache_dir, out_data, out_size);
+
+    asset_save_release_items(am, &items);
+    free(cache_dir);
+    threads_mutex_unlock(&am->build_m);
 
     return ok;
 }
@@ -3370,25 +5654,165 @@ void asset_manager_free_pack(uint8_t *data)
     free(data);
 }
 
-int all_loaded(asset_manager_t *am)
+void asset_manager_set_pack_codec(asset_manager_t *am, asset_type_t type, uint8_t codec)
+{
+    if (!am || (unsigned)type >= (unsigned)ASSET_MAX || codec >= ASSET_CODEC_COUNT)
+        return;
+    am->pack_codec[type] = codec;
+}
+
+uint8_t asset_manager_get_pack_codec(const asset_manager_t *am, asset_type_t type)
+{
+    if (!am || (unsigned)type >= (unsigned)ASSET_MAX)
+        return ASSET_CODEC_NONE;
+    return am->pack_codec[type];
+}
+
+void asset_manager_set_pack_texture_compression(asset_manager_t *am, bool enabled)
+{
+    if (!am)
+        return;
+    am->pack_tex_compress = enabled ? 1u : 0u;
+}
+
+bool asset_manager_get_pack_texture_compression(const asset_manager_t *am)
+{
+    return am && am->pack_tex_compress;
+}
+
+void asset_manager_set_image_mip_filter(asset_manager_t *am, uint32_t filter)
+{
+    if (!am || filter >= ASSET_IMAGE_MIP_FILTER_COUNT)
+        return;
+    am->mip_filter = (uint8_t)filter;
+}
+
+uint32_t asset_manager_get_image_mip_filter(const asset_manager_t *am)
+{
+    return am ? am->mip_filter : ASSET_IMAGE_MIP_FILTER_BOX;
+}
+
+void asset_manager_set_image_mip_srgb(asset_manager_t *am, bool enabled)
+{
+    if (!am)
+        return;
+    am->mip_srgb = enabled ? 1u : 0u;
+}
+
+uint32_t asset_manager_get_image_mip_flags(const asset_manager_t *am, uint32_t color_space)
+{
+    if (color_space == ASSET_IMAGE_COLOR_SPACE_SRGB)
+        return ASSET_IMAGE_MIP_SRGB | ASSET_IMAGE_MIP_COLOR_KNOWN;
+    if (color_space == ASSET_IMAGE_COLOR_SPACE_LINEAR)
+        return ASSET_IMAGE_MIP_COLOR_KNOWN;
+    return am && am->mip_srgb ? ASSET_IMAGE_MIP_SRGB : 0u;
+}
+
+bool asset_manager_set_image_color_space(asset_manager_t *am, ihandle_t image, uint32_t color_space)
 {
-    int done = 1;
+    if (!am || color_space >= ASSET_IMAGE_COLOR_SPACE_COUNT)
+        return false;
+
+    threads_mutex_lock(&am->state_m);
+    const bool ok = asset_image_color_space_locked(am, image, color_space);
+    threads_mutex_unlock(&am->state_m);
+    return ok;
+}
 
-    mutex_lock_impl(&am->state_m);
-    uint32_t n = (uint32_t)am->slots.size;
-    for (uint32_t i = 0; i < n; i++)
+uint32_t asset_manager_get_loading_image_color_space(const asset_manager_t *am)
+{
+    if (!am || g_dep_am != am)
+        return ASSET_IMAGE_COLOR_SPACE_AUTO;
+
+    asset_manager_t *mut = (asset_manager_t *)am;
+    threads_mutex_lock(&mut->state_m);
+    asset_slot_t *s = NULL;
+    uint32_t color_space = ASSET_IMAGE_COLOR_SPACE_AUTO;
+    if (slot_valid_locked(mut, g_dep_parent, &s))
     {
-        asset_slot_t *s = (asset_slot_t *)vector_at(&am->slots, i);
-        if (!s)
-            continue;
+        color_space = s->color_space;
+        // A color space recorded from now on no longer reaches this decode.
+        s->color_space_decoded = (uint8_t)(color_space + 1u);
+    }
+    threads_mutex_unlock(&mut->state_m);
+    return color_space;
+}
+
+void asset_manager_set_build_cache_dir(asset_manager_t *am, const char *dir)
+{
+    if (!am)
+        return;
 
-        if (s->asset.state == ASSET_STATE_LOADING)
+    threads_mutex_lock(&am->state_m);
+    if (!dir || !dir[0])
+    {
+        free(am->build_cache_dir);
+        am->build_cache_dir = NULL;
+    }
+    else if (!am->build_cache_dir || strcmp(am->build_cache_dir, dir) != 0)
+    {
+        size_t n = strlen(dir);
+        char *copy = (char *)malloc(n + 1);
+        if (copy)
         {
-            done = 0;
-            break;
+            memcpy(copy, dir, n + 1);
+            free(am->build_cache_dir);
+            am->build_cache_dir = copy;
         }
     }
-    mutex_unlock_impl(&am->state_m);
+    threads_mutex_unlock(&am->state_m);
+}
+
+bool asset_manager_mount_pack(asset_manager_t *am, const char *path)
+{
+    if (!am || !path || !path[0])
+        return false;
+
+    asset_pack_t p;
+    memset(&p, 0, sizeof(p));
+
+    if (!pack_map_file(path, &p))
+    {
+        LOG_ERROR("mount_pack: failed to map '%s'", path);
+        return false;
+    }
+
+    if (!pack_validate(&p, path))
+    {
+        pack_unmap(&p);
+        return false;
+    }
+
+    pack_hdr_t hdr;
+    memcpy(&hdr, p.base, sizeof(hdr));
+    p.toc = p.base + hdr.toc_offset;
+    p.toc_count = hdr.toc_count;
+
+    size_t n = strlen(path);
+    p.path = (char *)malloc(n + 1);
+    if (p.path)
+        memcpy(p.path, path, n + 1);
+
+    threads_mutex_lock(&am->state_m);
+    vector_impl_push_back(&am->packs, &p);
+    threads_mutex_unlock(&am->state_m);
+
+    LOG_INFO("Mounted pack '%s' (%u entries, %" PRIu64 " bytes)", path, (unsigned)p.toc_count, p.size);
+    return true;
+}
+
+bool asset_manager_pack_find(asset_manager_t *am, ihandle_t persistent, asset_blob_t *out)
+{
+    if (!am || !ihandle_is_valid(persistent))
+        return false;
 
-    return done;
+    threads_mutex_lock(&am->state_m);
+    bool found = pack_find_locked(am, pack_persistent_key(persistent), out);
+    threads_mutex_unlock(&am->state_m);
+    return found;
+}
+
+int all_loaded(asset_manager_t *am)
+{
+    return atomic_load_u32(&am->slots_loading) == 0;
 }
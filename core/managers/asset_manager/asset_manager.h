@@ -3,9 +3,16 @@
 #include <stdbool.h>
 
 #include "utils/logger.h"
+#include "utils/threads.h"
+#include "utils/jobs.h"
 #include "vector.h"
 #include "handle.h"
 #include "asset_types.h"
+#include "asset_codec.h"
+#include "asset_io.h"
+#include "asset_staging.h"
+#include "asset_ring.h"
+#include "asset_mempressure.h"
 
 #define iHANDLE_TYPE_ASSET 1
 
@@ -17,40 +24,74 @@ typedef uint32_t asset_flags_t;
 #define ASSET_FLAG_NONE 0u
 #define ASSET_FLAG_NO_UNLOAD (1u << 0)
 
-typedef struct mutex_t
+// Loader queue classes, served strictly in order. asset_manager_touch promotes queued loads to
+// VISIBLE; PREFETCH loads that nobody touches or requests again expire before they start.
+typedef enum asset_priority_t
 {
-    void *p;
-} mutex_t;
-typedef struct cond_t
-{
-    void *p;
-} cond_t;
-typedef struct thread_t
-{
-    void *p;
-} thread_t;
+    ASSET_PRIORITY_VISIBLE = 0,
+    ASSET_PRIORITY_NORMAL,
+    ASSET_PRIORITY_PREFETCH,
+    ASSET_PRIORITY_BACKGROUND,
+    ASSET_PRIORITY_COUNT
+} asset_priority_t;
 
 typedef struct asset_slot_t
 {
-    uint16_t generation;
+    uint32_t generation;
+    volatile uint32_t published; // generation while READY, 0 otherwise; read without state_m by asset_manager_get_any
     uint16_t module_index;
     ihandle_t persistent;
     asset_any_t asset;
 
     asset_flags_t flags;
+    uint16_t save_pins; // pack builds saving the asset without state_m; it stays loaded meanwhile
     uint8_t path_is_ptr;
     uint8_t inflight;
     uint16_t requested_type;
+    uint8_t priority;
+    uint8_t queued_mask; // priority rings holding an entry with job_ticket; the one at priority is live
+    uint8_t color_space; // images: asset_image_color_space_t from the material slots they are bound to
+    uint8_t color_space_decoded; // color_space + 1 as last read by a loader, 0 before the first decode
+    uint32_t job_ticket; // ticket of the queued job; 0 once a loader has picked it up
+    // asset_manager_get_any updates these without state_m; always use atomic_load/store_u64.
     uint64_t last_touched_frame;
     uint64_t last_requested_ms;
+    volatile uint32_t use_frames; // frames the asset was used in, halved every ASSET_HOST_DECAY_FRAMES
     char *path;
+
+    // Dependency edges as slot indices, both directions. deps_pending counts the slot itself while
+    // it is neither READY nor FAILED, plus each direct dependency whose closure has not settled, so
+    // the whole closure is settled exactly when it reaches 0.
+    vector_t deps;
+    vector_t dependents;
+    uint32_t deps_pending;
+    uint32_t deps_failed; // direct dependencies whose closure holds a FAILED asset
+    uint32_t dep_walk; // last closure walk that visited the slot
+    uint8_t seen_state; // asset.state as last accounted for in deps_pending and slots_loading
 } asset_slot_t;
 
+// Slots live in fixed pages that never move once allocated, so a slot pointer stays valid for the
+// lifetime of the manager. The page directory is sized once at init for the full index range, and
+// size is published after the new slot is written, so lookups can index it without state_m.
+#define ASSET_SLOT_PAGE_SHIFT 10u
+#define ASSET_SLOT_PAGE_SIZE (1u << ASSET_SLOT_PAGE_SHIFT)
+#define ASSET_SLOT_MAX_PAGES (1u << 14) // 16M slots
+
+typedef struct asset_slot_table_t
+{
+    asset_slot_t **pages;
+    volatile uint32_t size;
+    uint32_t page_count;
+} asset_slot_table_t;
+
 typedef struct asset_job_t
 {
     ihandle_t handle;
+    ihandle_t persistent;
     asset_type_t type;
     uint8_t path_is_ptr;
+    uint8_t priority;
+    uint32_t ticket; // stale unless it matches the slot's job_ticket and priority (requeued or cancelled)
     char *path;
 } asset_job_t;
 
@@ -63,26 +104,14 @@ typedef struct asset_done_t
     asset_any_t asset;
 } asset_done_t;
 
-typedef struct job_queue_t
-{
-    asset_job_t *buf;
-    uint32_t cap;
-    uint32_t head;
-    uint32_t tail;
-    uint32_t count;
-    mutex_t m;
-    cond_t cv;
-} job_queue_t;
-
-typedef struct done_queue_t
-{
-    asset_done_t *buf;
-    uint32_t cap;
-    uint32_t head;
-    uint32_t tail;
-    uint32_t count;
-    mutex_t m;
-} done_queue_t;
+#define ASSET_BLOB_FLAG_NONE 0u
+#define ASSET_BLOB_FLAG_PRECOMPRESSED (1u << 0) // payload carries its own codec; packs store it as-is
+// Set by save_blob_fn (returning false) when it was called on a pool worker but needs the thread
+// that owns the GL context; the pack builder retries it there.
+#define ASSET_BLOB_FLAG_NEEDS_MAIN_THREAD (1u << 1)
+// The blob is a source file read by the I/O stage rather than saved output. Its data is freed
+// when load_blob_fn returns, so loaders must not keep pointers into it.
+#define ASSET_BLOB_FLAG_SOURCE_FILE (1u << 2)
 
 typedef struct asset_blob_t
 {
@@ -99,10 +128,41 @@ struct asset_manager_t;
 typedef struct asset_manager_t asset_manager_t;
 
 typedef bool (*asset_load_fn_t)(asset_manager_t *am, const char *path, uint32_t path_is_ptr, asset_any_t *out, ihandle_t *out_handle);
+// Loads from a blob previously produced by save_blob_fn; `path` is the requested path (for resolving
+// siblings). For mounted packs the blob is a read-only view into the mapping that stays valid until
+// asset_manager_shutdown, so it may be referenced in place. When blob->codec is not ASSET_CODEC_NONE
+// the data is an asset_codec frame; decode it into the final allocation with asset_codec_decode.
+typedef bool (*asset_load_blob_fn_t)(asset_manager_t *am, const char *path, const asset_blob_t *blob, asset_any_t *out, ihandle_t *out_handle);
 
 typedef bool (*asset_init_fn_t)(asset_manager_t *am, asset_any_t *asset);
 typedef void (*asset_cleanup_fn_t)(asset_manager_t *am, asset_any_t *asset);
 
+typedef enum asset_upload_status_t
+{
+    ASSET_UPLOAD_MORE = 0,
+    ASSET_UPLOAD_DONE,
+    ASSET_UPLOAD_FAILED
+} asset_upload_status_t;
+
+// Cursor of an upload that is spread over several pumps. state belongs to the module.
+typedef struct asset_upload_t
+{
+    void *state;
+    uint64_t bytes_done;
+    uint64_t bytes_total;
+} asset_upload_t;
+
+// Uploads roughly budget_bytes per call and returns MORE until the asset is fully on the GPU, at
+// which point it behaves like init_fn. budget_bytes == 0 asks it to drop any partial GL objects
+// and state and return FAILED; asset cleanup_fn runs afterwards as usual.
+typedef asset_upload_status_t (*asset_upload_fn_t)(asset_manager_t *am, asset_any_t *asset, asset_upload_t *up, uint64_t budget_bytes);
+
+// Reads mip levels [first_mip, last_mip] of an image whose chain was trimmed after load (see
+// asset_image_mips_trim) back from `blob`: its pack entry, or the whole source file at `path`
+// (ASSET_BLOB_FLAG_SOURCE_FILE). Fills out_levels[first_mip..last_mip] with malloc'd pixels laid out
+// like `layout`. Runs on a job worker.
+typedef bool (*asset_mip_read_fn_t)(asset_manager_t *am, const char *path, const asset_blob_t *blob, const asset_image_mip_chain_t *layout, uint32_t first_mip, uint32_t last_mip, uint8_t **out_levels);
+
 typedef bool (*asset_save_blob_fn_t)(asset_manager_t *am, ihandle_t h, const asset_any_t *a, asset_blob_t *out);
 
 typedef void (*asset_blob_free_fn_t)(asset_manager_t *am, asset_blob_t *blob);
@@ -118,8 +178,33 @@ typedef struct asset_module_desc_t
     asset_save_blob_fn_t save_blob_fn;
     asset_blob_free_fn_t blob_free_fn;
     asset_can_load_fn_t can_load_fn;
+    asset_load_blob_fn_t load_blob_fn;
+    // Optional; replaces init_fn in asset_manager_pump so large assets can be uploaded in slices.
+    asset_upload_fn_t upload_fn;
+    // Optional, images only; without it the full mip chain of the module's images stays in RAM.
+    asset_mip_read_fn_t mip_read_fn;
+    // Bump when load or save output changes; stale build cache entries are then re-encoded.
+    uint32_t version;
+    // load_fn maps its source files and references them in place (see asset_io_map), so the I/O
+    // stage leaves reading them to load_fn instead of copying them into the heap first.
+    bool maps_source_files;
+    // load_fn reads only the parts of its source files it keeps (e.g. the resident mips), which
+    // beats the I/O stage reading the whole file; it is left to load_fn as well.
+    bool reads_source_ranges;
 } asset_module_desc_t;
 
+// Read-only pack file mapped into memory (see asset_manager_mount_pack).
+typedef struct asset_pack_t
+{
+    const uint8_t *base;
+    uint64_t size;
+    const void *toc; // pack_toc_t[toc_count], sorted by key
+    uint32_t toc_count;
+    void *os_file;
+    void *os_mapping;
+    char *path;
+} asset_pack_t;
+
 typedef struct asset_manager_desc_t
 {
     uint32_t worker_count;
@@ -133,12 +218,32 @@ typedef struct asset_manager_desc_t
 
     uint64_t upload_budget_bytes_per_pump;
     uint32_t pump_per_frame;
+    // GPU upload time per frame shared by pump (init_fn/upload_fn) and texture streaming; default 2000.
+    uint32_t upload_time_budget_us;
 
     // Texture mip streaming (Disk -> RAM mip chain -> GPU mips).
     uint32_t tex_stream_stable_frames;
     uint32_t tex_stream_min_safety_mips_from_bottom; // 0 => keep only lowest mip as safety, 1 => keep last 2 mips, etc.
     uint32_t tex_stream_evict_unused_ms;             // cooldown: only evict mips if unused for this long
     uint64_t tex_stream_upload_budget_bytes_per_frame;
+    uint64_t tex_stream_ram_budget_bytes; // mip levels held in RAM (safety mips + paged-in levels); 0 = no limit
+    uint32_t tex_stream_prefetch_expire_frames; // prefetched textures not used within this many frames count as misses; default 60
+
+    // File reads for modules with load_blob_fn go through the I/O stage (see asset_io.h), unless
+    // the module reads its source files itself (maps_source_files, reads_source_ranges).
+    uint32_t io_queue_depth; // concurrent reads + buffers awaiting decode; default 32
+    uint32_t io_backend;     // asset_io_backend_t
+
+    uint32_t prefetch_expire_ms; // PREFETCH loads not requested/touched for this long are dropped; default 1000
+
+    uint64_t staging_bytes; // persistently mapped upload ring (see asset_staging.h); default 64 MB
+
+    // CPU-side asset data (mip levels in RAM plus the asset structs). Over budget, or when the
+    // process' cgroup reports memory pressure (see asset_mempressure.h), paged mip levels are
+    // dropped first and then whole images holding decoded levels, least recently and least often
+    // used first.
+    uint64_t host_budget_bytes; // 0 = only react to memory pressure
+    uint32_t host_headroom_pct; // keep this much of the cgroup's memory limit free; 0 = off (default)
 } asset_manager_desc_t;
 
 typedef struct asset_manager_stats_t
@@ -147,15 +252,40 @@ typedef struct asset_manager_stats_t
 
     uint64_t vram_budget_bytes;
     uint64_t vram_resident_bytes;
+    uint64_t tex_ram_budget_bytes;
+    uint64_t tex_ram_resident_bytes;
 
     uint64_t upload_bytes_last_pump;
     uint64_t evicted_bytes_last_pump;
 
+    uint32_t upload_us_last_frame;  // measured GPU upload time, pump + texture streaming
+    uint32_t upload_slices_pending; // assets part way through upload_fn
+    uint32_t uploads_deferred_total; // done items pushed to the next frame because they would not fit
+    uint64_t staging_used_bytes;
+    uint64_t staging_alloc_failures; // loads and mip slices that fell back to client memory
+
     uint64_t tex_stream_uploaded_bytes_last_frame;
     uint64_t tex_stream_evicted_bytes_last_frame;
     uint32_t tex_stream_uploads_last_frame; // number of mip uploads
     uint32_t tex_stream_evictions_last_frame; // number of mip evictions
     uint32_t tex_stream_pending_uploads; // textures currently wanting sharper mips
+    uint32_t tex_stream_page_ins_pending; // mip reads from disk in flight
+    uint64_t tex_stream_paged_in_bytes_total;
+
+    // Speculative uses: a hit is a texture really used within tex_stream_prefetch_expire_frames,
+    // a miss one that was not. Wasted bytes were uploaded for misses.
+    uint32_t tex_prefetch_issued_total;
+    uint32_t tex_prefetch_hits_total;
+    uint32_t tex_prefetch_misses_total;
+    uint64_t tex_prefetch_wasted_bytes_total;
+
+    uint64_t host_budget_bytes;
+    uint64_t host_resident_bytes;
+    uint64_t host_limit_bytes; // from the pressure monitor, 0 = unknown
+    uint64_t host_used_bytes;
+    uint32_t host_pressure_events_total;
+    uint32_t host_evictions_total; // assets unloaded to free host memory
+    uint64_t host_evicted_bytes_total;
 
     uint32_t textures_resident;
 
@@ -163,26 +293,44 @@ typedef struct asset_manager_stats_t
     uint32_t textures_reloaded_total;
     uint32_t textures_evicted_total;
 
-    uint32_t jobs_pending;
+    uint32_t jobs_pending;  // live queued loads; stale ring entries are counted in jobs_stale
+    uint32_t jobs_stale;
+    uint32_t jobs_deferred; // loads waiting for room in a full ring
     uint32_t done_pending;
+    uint32_t jobs_requeued_total;  // priority changes of queued loads
+    uint32_t jobs_cancelled_total; // queued loads dropped before a loader started them
+
+    uint32_t get_any_last_frame;        // asset_manager_get_any calls during the previous frame
+    uint32_t get_any_locked_last_frame; // of those, lookups that missed the lock-free path
 
     uint32_t streaming_enabled;
 } asset_manager_stats_t;
 
 typedef struct asset_manager_t
 {
-    vector_t slots;
+    asset_slot_table_t slots;
     vector_t modules;
 
-    job_queue_t jobs;
-    done_queue_t done;
-
-    thread_t *workers;
+    asset_ring_t jobs[ASSET_PRIORITY_COUNT];
+    asset_ring_t done;
+    uint32_t job_ticket_next; // guarded by state_m
+    volatile uint32_t jobs_stale; // ring entries a loader will drop; written under state_m
+    vector_t jobs_deferred;       // ihandle_t of loads whose ring was full; guarded by state_m
+    vector_t color_space_reloads; // ihandle_t of images decoded before their color space was known; state_m
+    uint32_t prefetch_expire_ms;
+    volatile uint32_t done_popped; // bumped on every done-queue pop; loaders park on it when the queue is full
+    volatile uint32_t done_parked;
+
+    // Loads run as background jobs on the engine pool; worker_count caps how many run at once.
+    // File reads are handed to the I/O stage and decoded by separate jobs once the bytes arrive.
     uint32_t worker_count;
+    volatile uint32_t loaders_active;
+    jobs_counter_t loaders;
+    asset_io_t io;
 
     ihandle_type_t handle_type;
 
-    uint32_t shutting_down;
+    volatile uint32_t shutting_down;
     mutex_t state_m;
 
     uint64_t prng_state;
@@ -201,16 +349,59 @@ typedef struct asset_manager_t
     uint64_t upload_budget_bytes_per_pump;
     uint32_t pump_per_frame;
 
+    // Upload deadline. Costs are learnt as running averages: bytes per ms for sliced copies and
+    // microseconds per init_fn call per asset type, used to decide what still fits this frame.
+    uint32_t upload_time_budget_us;
+    uint32_t upload_spent_us;
+    uint64_t upload_bytes_per_ms;
+    uint32_t init_cost_us[ASSET_MAX];
+    vector_t uploads; // asset_upload_job_t, oldest first
+    asset_done_t upload_deferred;
+    uint32_t upload_has_deferred;
+
+    // Created on the first pump, which runs on the thread that owns the GL context. Loaders only
+    // see it once staging_ready is set (asset_manager_staging).
+    asset_staging_t staging;
+    uint64_t staging_bytes;
+    volatile uint32_t staging_ready;
+    uint32_t staging_tried;
+
     // Texture mip streaming knobs (see asset_manager_desc_t).
     uint32_t tex_stream_stable_frames;
     uint32_t tex_stream_min_safety_mips_from_bottom;
     uint32_t tex_stream_evict_unused_ms;
     uint64_t tex_stream_upload_budget_bytes_per_frame;
 
+    // Mip levels dropped from RAM after load are read back by jobs on the loaders counter.
+    uint64_t tex_stream_ram_budget_bytes;
+    uint32_t tex_page_inflight;
+    uint64_t tex_page_pending_bytes;
+
+    uint32_t tex_stream_prefetch_expire_frames;
+
+    uint64_t host_budget_bytes;
+    uint32_t host_headroom_pct;
+    uint64_t host_decay_frame;
+    asset_mempressure_sample_t host_seen; // last sample acted on
+    asset_mempressure_t mempressure;
+
+    volatile uint32_t slots_loading; // slots in ASSET_STATE_LOADING, for all_loaded
+    uint32_t dep_walk_epoch;
+
     asset_manager_stats_t stats;
 
-    uint32_t asset_get_any_cnt_frame;
+    // Codec applied to each asset type's blobs when building packs (ASSET_CODEC_*).
+    uint8_t pack_codec[ASSET_MAX];
+    // Saved 8-bit textures are stored as BCn blocks.
+    uint8_t pack_tex_compress;
+    // Mip generation: asset_image_mip_filter_t, and whether 8-bit color is filtered in linear light.
+    uint8_t mip_filter;
+    uint8_t mip_srgb;
+
+    volatile uint32_t asset_get_any_cnt_frame;
     uint32_t asset_get_any_cnt_last_frame;
+    volatile uint32_t asset_get_any_locked_cnt_frame;
+    uint32_t asset_get_any_locked_cnt_last_frame;
 
     // Dedupe map: persistent-key -> slot index (1-based like handle index).
     // Used to avoid allocating duplicate slots when requesting the same path/payload repeatedly.
@@ -218,6 +409,14 @@ typedef struct asset_manager_t
     uint32_t *dedupe_vals;
     uint32_t dedupe_cap;
     uint32_t dedupe_count;
+
+    // Mounted packs, searched newest first. Guarded by state_m; mappings live until shutdown.
+    vector_t packs;
+
+    // Incremental pack builds (see asset_manager_set_build_cache_dir). NULL = disabled.
+    char *build_cache_dir;
+    // Serializes asset_manager_build_pack_ex calls, which run without state_m.
+    mutex_t build_m;
 } asset_manager_t;
 
 enum
@@ -245,6 +444,12 @@ typedef struct asset_debug_slot_t
     uint64_t last_touched_frame;
     uint64_t last_requested_ms;
     uint64_t vram_bytes;
+    uint64_t host_bytes;
+    uint32_t use_frames;
+    uint32_t dep_count;
+    uint32_t dependent_count;
+    uint32_t deps_pending;
+    uint32_t deps_failed;
 
     // Image streaming debug (valid when type==ASSET_IMAGE and state==READY).
     uint32_t img_mip_count;
@@ -276,6 +481,8 @@ typedef struct asset_manager_debug_snapshot_t
     uint64_t now_ms;
     uint64_t vram_budget_bytes;
     uint64_t vram_resident_bytes;
+    uint64_t tex_ram_budget_bytes;
+    uint64_t tex_ram_resident_bytes;
 
     uint64_t tex_stream_upload_budget_bytes_per_frame;
     uint32_t tex_stream_stable_frames;
@@ -287,12 +494,31 @@ typedef struct asset_manager_debug_snapshot_t
     uint32_t tex_stream_uploads_last_frame;
     uint32_t tex_stream_evictions_last_frame;
     uint32_t tex_stream_pending_uploads;
+
+    uint32_t tex_prefetch_issued_total;
+    uint32_t tex_prefetch_hits_total;
+    uint32_t tex_prefetch_misses_total;
+    uint64_t tex_prefetch_wasted_bytes_total;
+
+    uint64_t host_budget_bytes;
+    uint64_t host_resident_bytes;
+    uint64_t host_limit_bytes;
+    uint64_t host_used_bytes;
+    uint32_t host_evictions_total;
 } asset_manager_debug_snapshot_t;
 
 // Called by the renderer for visible texture usage. Updates per-texture target mip selection for the current frame.
 // `screen_coverage_px` should be roughly the max pixel diameter of the drawable using the texture.
 void asset_manager_image_stream_record_use(asset_manager_t *am, ihandle_t image, float screen_coverage_px, float uv_scale, uint16_t priority);
 
+// Same for textures the renderer expects to become visible soon. Ignored for textures already used this
+// frame; pass a lower priority than visible uses so they only take spare upload budget.
+void asset_manager_image_stream_record_prefetch(asset_manager_t *am, ihandle_t image, float screen_coverage_px, float uv_scale, uint16_t priority);
+
+// First mip level a path-loaded image keeps in RAM when its module has mip_read_fn; sharper levels
+// are dropped after load. Loaders that can decode single levels may skip them up front.
+uint32_t asset_manager_image_resident_first(const asset_manager_t *am, uint32_t mip_count);
+
 // Forces a texture to target (and keep) a specific top mip until cleared.
 // `top_mip` is clamped to [0, mip_count-1]. Use `enabled=0` to clear.
 void asset_manager_image_stream_force_top_mip(asset_manager_t *am, ihandle_t image, uint32_t enabled, uint32_t top_mip, uint16_t priority);
@@ -304,28 +530,95 @@ bool asset_manager_register_module(asset_manager_t *am, asset_module_desc_t modu
 
 ihandle_t asset_manager_request_ptr(asset_manager_t *am, asset_type_t type, void *ptr);
 ihandle_t asset_manager_request(asset_manager_t *am, asset_type_t type, const char *path);
+// Same as asset_manager_request (which uses ASSET_PRIORITY_NORMAL). Requesting a queued asset
+// again only ever raises its priority. When the queue for its class is full the asset stays
+// LOADING and asset_manager_pump queues it once there is room.
+ihandle_t asset_manager_request_ex(asset_manager_t *am, asset_type_t type, const char *path, asset_priority_t priority);
 ihandle_t asset_manager_submit_raw(asset_manager_t *am, asset_type_t type, const void *raw_asset);
 
 void asset_manager_pump(asset_manager_t *am, uint32_t max_per_frame);
+// Upload ring for loaders to decode into, or NULL when the context cannot provide one (yet).
+asset_staging_t *asset_manager_staging(asset_manager_t *am);
 void asset_manager_pump_frame(asset_manager_t *am);
 
 void asset_manager_begin_frame(asset_manager_t *am);
 
 const asset_any_t *asset_manager_get_any(const asset_manager_t *am, ihandle_t h);
 void asset_manager_touch(asset_manager_t *am, ihandle_t h);
+// Moves a load that is still queued to another class. False if it already started or finished.
+bool asset_manager_set_priority(asset_manager_t *am, ihandle_t h, asset_priority_t priority);
+// Drops a load that no loader has started yet. The slot goes back to EMPTY and the next touch or
+// request queues it again. Pointer requests cannot be cancelled.
+bool asset_manager_cancel(asset_manager_t *am, ihandle_t h);
 bool asset_manager_update_flags(asset_manager_t *am, ihandle_t h, asset_flags_t set_mask, asset_flags_t clear_mask);
+
+// Records that `parent` needs `child`. Requests made from inside a loader (a model requesting its
+// materials, a material its textures) and the textures of published materials are recorded
+// automatically; duplicate and self edges are ignored. False (and a warning) for an edge that would
+// close a cycle.
+bool asset_manager_add_dependency(asset_manager_t *am, ihandle_t parent, ihandle_t child);
+// Requests or touches every asset reachable from `root` over known edges at `priority`, so the
+// leaves of a closure that was loaded before are queued in one go instead of level by level.
+// Returns the number of assets visited.
+uint32_t asset_manager_request_closure(asset_manager_t *am, ihandle_t root, asset_priority_t priority);
+// True once `root` and everything it depends on are READY. O(1).
+bool asset_manager_closure_ready(const asset_manager_t *am, ihandle_t root);
+// FAILED as soon as `root` or anything it depends on failed, READY as for closure_ready, LOADING
+// while parts are still on the way, EMPTY for invalid or unloaded roots. O(1).
+asset_state_t asset_manager_closure_state(const asset_manager_t *am, ihandle_t root);
+
 bool asset_manager_get_stats(const asset_manager_t *am, asset_manager_stats_t *out);
 void asset_manager_set_streaming(asset_manager_t *am, uint32_t enabled, uint64_t vram_budget_bytes, uint32_t unused_frames);
+bool asset_manager_get_streaming(const asset_manager_t *am);
+// Limit for mip levels held in RAM; 0 = no limit.
+void asset_manager_set_tex_ram_budget(asset_manager_t *am, uint64_t bytes);
+// Limit for all CPU-side asset data; 0 = only react to memory pressure.
+void asset_manager_set_host_budget(asset_manager_t *am, uint64_t bytes);
 void asset_manager_set_upload_budget(asset_manager_t *am, uint64_t bytes_per_pump);
 void asset_manager_end_frame(asset_manager_t *am);
 
 uint32_t asset_manager_debug_get_slot_count(const asset_manager_t *am);
 bool asset_manager_debug_get_slots(const asset_manager_t *am, asset_debug_slot_t *out_slots, uint32_t cap, asset_manager_debug_snapshot_t *out_snapshot);
 
-bool asset_manager_build_pack(asset_manager_t *am, uint8_t **out_data, uint32_t *out_size);
-bool asset_manager_build_pack_ex(asset_manager_t *am, uint8_t **out_data, uint32_t *out_size, uint32_t flags, const char *base_path);
+bool asset_manager_build_pack(asset_manager_t *am, uint8_t **out_data, uint64_t *out_size);
+bool asset_manager_build_pack_ex(asset_manager_t *am, uint8_t **out_data, uint64_t *out_size, uint32_t flags, const char *base_path);
 void asset_manager_free_pack(uint8_t *data);
 
+void asset_manager_set_pack_codec(asset_manager_t *am, asset_type_t type, uint8_t codec);
+uint8_t asset_manager_get_pack_codec(const asset_manager_t *am, asset_type_t type);
+// On by default. Textures saved already compressed stay compressed either way.
+void asset_manager_set_pack_texture_compression(asset_manager_t *am, bool enabled);
+bool asset_manager_get_pack_texture_compression(const asset_manager_t *am);
+
+// Filter for mip chains built from decoded images (ASSET_IMAGE_MIP_FILTER_*, box by default).
+// sRGB images are averaged in linear light so mips keep their brightness; linear ones as stored.
+// srgb (on by default) applies to images of unknown color space, except those that look like normal
+// maps or packed masks.
+void asset_manager_set_image_mip_filter(asset_manager_t *am, uint32_t filter);
+uint32_t asset_manager_get_image_mip_filter(const asset_manager_t *am);
+void asset_manager_set_image_mip_srgb(asset_manager_t *am, bool enabled);
+// Flags for asset_image_mips_build_u8 for an image in `color_space` (asset_image_color_space_t).
+uint32_t asset_manager_get_image_mip_flags(const asset_manager_t *am, uint32_t color_space);
+// Records what `image` holds. Published materials do this for their textures: albedo and emissive
+// are sRGB, the other slots linear. The first known color space sticks; an image already decoded
+// for AUTO is loaded again from its file. False for invalid handles and conflicting color spaces.
+bool asset_manager_set_image_color_space(asset_manager_t *am, ihandle_t image, uint32_t color_space);
+// For loaders: the color space recorded for the image this thread is decoding, AUTO if none.
+uint32_t asset_manager_get_loading_image_color_space(const asset_manager_t *am);
+
+// Keeps the last built pack and a source fingerprint index (path, mtime, size, content hash,
+// module versions) in `dir`. Later builds copy blobs of unchanged path assets from it instead of
+// calling save_blob_fn again. In-memory edits that were never written back to the source file
+// are not detected. NULL or "" disables the cache.
+void asset_manager_set_build_cache_dir(asset_manager_t *am, const char *dir);
+
+// Maps a pack built by asset_manager_build_pack. Path requests whose persistent key is in a mounted
+// pack are loaded from the mapping through the module's load_blob_fn instead of opening the file.
+bool asset_manager_mount_pack(asset_manager_t *am, const char *path);
+// Zero-copy view of the blob stored for `persistent`. out->data points into the mapping (read-only).
+bool asset_manager_pack_find(asset_manager_t *am, ihandle_t persistent, asset_blob_t *out);
+
+// True when no slot is LOADING. O(1); see asset_manager_closure_ready for a single asset tree.
 int all_loaded(asset_manager_t *am);
 
 static inline const asset_image_t *asset_manager_get_image(const asset_manager_t *am, ihandle_t h)
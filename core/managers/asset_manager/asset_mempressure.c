@@ -0,0 +1,192 @@
+#include "asset_mempressure.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "utils/logger.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#define MEMPRESSURE_SAMPLE_MS 1000
+
+// 150 ms of partial memory stall within 2 s. Unprivileged triggers need a 2 s multiple window.
+static const char k_psi_trigger[] = "some 150000 2000000";
+
+static bool mp_read_u64_file(const char *path, uint64_t *out)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+    unsigned long long v = 0;
+    const bool ok = fscanf(f, "%llu", &v) == 1; // "max" fails, which reads as no limit
+    fclose(f);
+    if (ok)
+        *out = (uint64_t)v;
+    return ok;
+}
+
+static void mp_find_cgroup(asset_mempressure_t *mp)
+{
+    mp->cgroup_dir[0] = 0;
+
+    FILE *f = fopen("/proc/self/cgroup", "r");
+    if (!f)
+        return;
+
+    // cgroup v2 has a single "0::/path" line. The root cgroup's files describe the whole machine,
+    // which other processes fill as much as we do, so a process there reports nothing.
+    char line[512];
+    while (fgets(line, sizeof(line), f))
+    {
+        if (strncmp(line, "0::", 3) != 0)
+            continue;
+        line[strcspn(line, "\n")] = 0;
+        if (strcmp(line + 3, "/") == 0)
+            break;
+        snprintf(mp->cgroup_dir, sizeof(mp->cgroup_dir), "/sys/fs/cgroup%s", line + 3);
+        break;
+    }
+    fclose(f);
+}
+
+static int mp_open_trigger(const char *path)
+{
+    int fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+    if (write(fd, k_psi_trigger, sizeof(k_psi_trigger)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void mp_sample_limits(asset_mempressure_t *mp)
+{
+    uint64_t limit = 0;
+    uint64_t used = 0;
+
+    if (mp->cgroup_dir[0])
+    {
+        char path[320];
+        uint64_t v = 0;
+        snprintf(path, sizeof(path), "%s/memory.max", mp->cgroup_dir);
+        if (mp_read_u64_file(path, &v))
+            limit = v;
+        // memory.high is where the kernel starts throttling, so that is the one to stay under.
+        snprintf(path, sizeof(path), "%s/memory.high", mp->cgroup_dir);
+        if (mp_read_u64_file(path, &v) && (!limit || v < limit))
+            limit = v;
+        snprintf(path, sizeof(path), "%s/memory.current", mp->cgroup_dir);
+        if (!limit || !mp_read_u64_file(path, &used))
+            limit = 0;
+    }
+
+    atomic_store_u64(&mp->limit_bytes, limit);
+    atomic_store_u64(&mp->used_bytes, used);
+    atomic_add_u32(&mp->samples, 1u);
+}
+
+static void mp_thread_main(void *arg)
+{
+    asset_mempressure_t *mp = (asset_mempressure_t *)arg;
+
+    while (!atomic_load_u32(&mp->stopping))
+    {
+        mp_sample_limits(mp);
+
+        struct pollfd fds[2];
+        nfds_t n = 0;
+        fds[n++] = (struct pollfd){.fd = mp->wake_fd[0], .events = POLLIN};
+        if (mp->psi_fd >= 0)
+            fds[n++] = (struct pollfd){.fd = mp->psi_fd, .events = POLLPRI};
+
+        if (poll(fds, n, MEMPRESSURE_SAMPLE_MS) <= 0 || n < 2)
+            continue;
+
+        if (fds[1].revents & POLLERR)
+        {
+            // The cgroup went away; keep sampling limits without the trigger.
+            close(mp->psi_fd);
+            mp->psi_fd = -1;
+        }
+        else if (fds[1].revents & POLLPRI)
+        {
+            atomic_add_u32(&mp->events, 1u);
+        }
+    }
+}
+#endif
+
+void asset_mempressure_init(asset_mempressure_t *mp)
+{
+    memset(mp, 0, sizeof(*mp));
+    mp->psi_fd = -1;
+    mp->wake_fd[0] = -1;
+    mp->wake_fd[1] = -1;
+
+#if defined(__linux__)
+    mp_find_cgroup(mp);
+
+    if (mp->cgroup_dir[0])
+    {
+        char path[320];
+        snprintf(path, sizeof(path), "%s/memory.pressure", mp->cgroup_dir);
+        mp->psi_fd = mp_open_trigger(path);
+    }
+
+    mp_sample_limits(mp);
+
+    if (pipe2(mp->wake_fd, O_CLOEXEC | O_NONBLOCK) != 0)
+    {
+        mp->wake_fd[0] = -1;
+        mp->wake_fd[1] = -1;
+    }
+    else if (threads_thread_create(&mp->thread, mp_thread_main, mp))
+    {
+        mp->thread_running = 1;
+    }
+
+    LOG_INFO("Asset memory: PSI %s, limit %llu MB%s",
+             mp->psi_fd >= 0 ? "on" : "off",
+             (unsigned long long)(atomic_load_u64(&mp->limit_bytes) >> 20),
+             mp->cgroup_dir[0] ? " (cgroup)" : "");
+#endif
+}
+
+void asset_mempressure_shutdown(asset_mempressure_t *mp)
+{
+#if defined(__linux__)
+    atomic_store_u32(&mp->stopping, 1u);
+    if (mp->thread_running)
+    {
+        // If the write fails the poll still times out within MEMPRESSURE_SAMPLE_MS.
+        const char b = 1;
+        ssize_t w = write(mp->wake_fd[1], &b, 1);
+        (void)w;
+        threads_thread_join(&mp->thread);
+        mp->thread_running = 0;
+    }
+    if (mp->psi_fd >= 0)
+        close(mp->psi_fd);
+    if (mp->wake_fd[0] >= 0)
+        close(mp->wake_fd[0]);
+    if (mp->wake_fd[1] >= 0)
+        close(mp->wake_fd[1]);
+#endif
+    mp->psi_fd = -1;
+    mp->wake_fd[0] = -1;
+    mp->wake_fd[1] = -1;
+}
+
+void asset_mempressure_sample(asset_mempressure_t *mp, asset_mempressure_sample_t *out)
+{
+    out->events = atomic_load_u32(&mp->events);
+    out->samples = atomic_load_u32(&mp->samples);
+    out->limit_bytes = atomic_load_u64(&mp->limit_bytes);
+    out->used_bytes = atomic_load_u64(&mp->used_bytes);
+}
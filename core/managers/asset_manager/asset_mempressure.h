@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utils/threads.h"
+
+// Host memory pressure for the asset manager. On Linux a thread registers a PSI trigger on the
+// process' own cgroup (memory.pressure) and counts the stalls it reports. The same thread samples
+// the cgroup's limit and usage. System-wide numbers are never used: in the root cgroup or on other
+// platforms nothing is reported and only the configured budget applies, and a cgroup without a
+// limit only reports stalls.
+typedef struct asset_mempressure_t
+{
+    volatile uint32_t stopping;
+    volatile uint32_t events;  // PSI triggers fired so far
+    volatile uint32_t samples; // limit/used refreshes so far
+    volatile uint64_t limit_bytes; // 0 = unknown
+    volatile uint64_t used_bytes;
+
+    int psi_fd;
+    int wake_fd[2]; // shutdown writes to [1] to end the poll early
+    char cgroup_dir[256];
+    thread_t thread;
+    uint32_t thread_running;
+} asset_mempressure_t;
+
+// Never fails hard: without PSI support the monitor only samples limits.
+void asset_mempressure_init(asset_mempressure_t *mp);
+void asset_mempressure_shutdown(asset_mempressure_t *mp);
+
+typedef struct asset_mempressure_sample_t
+{
+    uint32_t events;
+    uint32_t samples;
+    uint64_t limit_bytes; // cgroup memory.high/memory.max, 0 = no limit
+    uint64_t used_bytes;
+} asset_mempressure_sample_t;
+
+// Any thread. Counters only grow; compare against the previous sample to see what is new.
+void asset_mempressure_sample(asset_mempressure_t *mp, asset_mempressure_sample_t *out);
@@ -0,0 +1,98 @@
+#include "asset_ring.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void asset_ring_init(asset_ring_t *q, uint32_t cap, uint32_t elem_size)
+{
+    uint32_t n = 2u;
+    while (n < cap)
+        n <<= 1u;
+
+    memset(q, 0, sizeof(*q));
+    q->buf = (uint8_t *)calloc((size_t)n, elem_size);
+    q->seq = (volatile uint32_t *)malloc((size_t)n * sizeof(uint32_t));
+    q->elem_size = elem_size;
+    q->mask = n - 1u;
+
+    if (q->seq)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+            q->seq[i] = i;
+    }
+}
+
+void asset_ring_destroy(asset_ring_t *q)
+{
+    free(q->buf);
+    free((void *)q->seq);
+    memset(q, 0, sizeof(*q));
+}
+
+bool asset_ring_push(asset_ring_t *q, const void *elem)
+{
+    if (!q->buf || !q->seq)
+        return false;
+
+    uint32_t pos = atomic_load_u32(&q->tail);
+    for (;;)
+    {
+        uint32_t seq = atomic_load_u32(&q->seq[pos & q->mask]);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0)
+        {
+            if (atomic_cas_u32(&q->tail, pos, pos + 1u))
+                break;
+            pos = atomic_load_u32(&q->tail);
+        }
+        else if (dif < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_u32(&q->tail);
+        }
+    }
+
+    memcpy(q->buf + (size_t)(pos & q->mask) * q->elem_size, elem, q->elem_size);
+    atomic_store_u32(&q->seq[pos & q->mask], pos + 1u);
+    return true;
+}
+
+bool asset_ring_pop(asset_ring_t *q, void *out)
+{
+    if (!q->buf || !q->seq)
+        return false;
+
+    uint32_t pos = atomic_load_u32(&q->head);
+    for (;;)
+    {
+        uint32_t seq = atomic_load_u32(&q->seq[pos & q->mask]);
+        int32_t dif = (int32_t)(seq - (pos + 1u));
+        if (dif == 0)
+        {
+            if (atomic_cas_u32(&q->head, pos, pos + 1u))
+                break;
+            pos = atomic_load_u32(&q->head);
+        }
+        else if (dif < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_u32(&q->head);
+        }
+    }
+
+    memcpy(out, q->buf + (size_t)(pos & q->mask) * q->elem_size, q->elem_size);
+    atomic_store_u32(&q->seq[pos & q->mask], pos + q->mask + 1u);
+    return true;
+}
+
+uint32_t asset_ring_count(asset_ring_t *q)
+{
+    int32_t n = (int32_t)(atomic_load_u32(&q->tail) - atomic_load_u32(&q->head));
+    return n > 0 ? (uint32_t)n : 0u;
+}
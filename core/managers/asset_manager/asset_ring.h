@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utils/threads.h"
+
+// Bounded lock-free MPMC ring (Vyukov): each cell carries a sequence number that tells producers
+// and consumers whether it is free or filled for the current lap. Capacity is a power of two.
+typedef struct asset_ring_t
+{
+    uint8_t *buf;
+    volatile uint32_t *seq;
+    uint32_t elem_size;
+    uint32_t mask;
+    uint8_t pad0[40];
+    volatile uint32_t head;
+    uint8_t pad1[60];
+    volatile uint32_t tail;
+    uint8_t pad2[60];
+} asset_ring_t;
+
+// cap is rounded up to a power of two (at least 2).
+void asset_ring_init(asset_ring_t *q, uint32_t cap, uint32_t elem_size);
+void asset_ring_destroy(asset_ring_t *q);
+// Both return false instead of blocking: push when the ring is full, pop when it is empty.
+bool asset_ring_push(asset_ring_t *q, const void *elem);
+bool asset_ring_pop(asset_ring_t *q, void *out);
+// Approximate under concurrent use.
+uint32_t asset_ring_count(asset_ring_t *q);
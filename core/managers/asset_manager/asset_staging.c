@@ -0,0 +1,222 @@
+#include "asset_staging.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum
+{
+    STAGING_REGION_WRITING = 0,
+    STAGING_REGION_RELEASED
+};
+
+static uint64_t staging_align_up(uint64_t x, uint64_t a)
+{
+    return (x + a - 1u) & ~(a - 1u);
+}
+
+static asset_staging_region_t *staging_region_locked(asset_staging_t *s, uint64_t id)
+{
+    if (id < s->oldest_id || id >= s->next_id)
+        return NULL;
+    asset_staging_region_t *r = &s->regions[id & s->region_mask];
+    return r->id == id ? r : NULL;
+}
+
+// Advances the tail over the oldest regions whose fence has signalled. Later regions wait for
+// earlier ones, which keeps the free space contiguous.
+static void staging_reclaim_locked(asset_staging_t *s)
+{
+    while (s->oldest_id < s->next_id)
+    {
+        asset_staging_region_t *r = &s->regions[s->oldest_id & s->region_mask];
+        if (r->state != STAGING_REGION_RELEASED || !r->epoch || r->epoch > s->done_epoch)
+            break;
+        s->tail = r->end;
+        r->id = 0;
+        s->oldest_id++;
+    }
+}
+
+bool asset_staging_init(asset_staging_t *s, uint64_t size, uint32_t max_regions, const asset_staging_backend_t *backend)
+{
+    memset(s, 0, sizeof(*s));
+
+    size &= ~255ull;
+    if (!size || !backend || !backend->create_fn || !backend->fence_fn || !backend->fence_wait_fn)
+        return false;
+
+    uint32_t cap = 2u;
+    while (cap < max_regions && cap < (1u << 20))
+        cap <<= 1;
+
+    s->backend = *backend;
+    s->regions = (asset_staging_region_t *)calloc(cap, sizeof(asset_staging_region_t));
+    if (!s->regions)
+        return false;
+    s->region_mask = cap - 1u;
+    s->next_id = 1;
+    s->oldest_id = 1;
+
+    s->base = (uint8_t *)s->backend.create_fn(s->backend.user, size, &s->buffer);
+    if (!s->base || !threads_mutex_init(&s->m))
+    {
+        if (s->base && s->backend.destroy_fn)
+            s->backend.destroy_fn(s->backend.user, s->buffer);
+        free(s->regions);
+        memset(s, 0, sizeof(*s));
+        return false;
+    }
+    s->size = size;
+    return true;
+}
+
+void asset_staging_shutdown(asset_staging_t *s)
+{
+    if (!s->base)
+        return;
+
+    for (uint32_t i = 0; i < s->fence_count; ++i)
+    {
+        void *f = s->fences[(s->fence_first + i) % ASSET_STAGING_MAX_FENCES];
+        s->backend.fence_wait_fn(s->backend.user, f, UINT64_MAX);
+        if (s->backend.fence_free_fn)
+            s->backend.fence_free_fn(s->backend.user, f);
+    }
+
+    if (s->backend.destroy_fn)
+        s->backend.destroy_fn(s->backend.user, s->buffer);
+    threads_mutex_destroy(&s->m);
+    free(s->regions);
+    memset(s, 0, sizeof(*s));
+}
+
+bool asset_staging_alloc(asset_staging_t *s, uint64_t size, uint32_t align, asset_staging_alloc_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!s->base || !size || size > s->size)
+        return false;
+    if (align < 16u || (align & (align - 1u)) || align > 256u)
+        align = align > 256u ? 256u : 16u;
+
+    threads_mutex_lock(&s->m);
+
+    uint64_t pos = staging_align_up(s->head, align);
+    const uint64_t off = pos % s->size;
+    if (off + size > s->size)
+        pos += s->size - off;
+
+    const bool ok = s->next_id - s->oldest_id <= s->region_mask && pos + size - s->tail <= s->size;
+    if (ok)
+    {
+        asset_staging_region_t *r = &s->regions[s->next_id & s->region_mask];
+        r->id = s->next_id++;
+        r->end = pos + size;
+        r->epoch = 0;
+        r->state = STAGING_REGION_WRITING;
+        s->head = pos + size;
+
+        out->id = r->id;
+        out->offset = pos % s->size;
+        out->ptr = s->base + out->offset;
+    }
+    else
+    {
+        s->alloc_failures++;
+    }
+
+    threads_mutex_unlock(&s->m);
+    return ok;
+}
+
+void asset_staging_release(asset_staging_t *s, uint64_t id)
+{
+    if (!s->base || !id)
+        return;
+
+    threads_mutex_lock(&s->m);
+    asset_staging_region_t *r = staging_region_locked(s, id);
+    if (r && r->state == STAGING_REGION_WRITING)
+    {
+        r->state = STAGING_REGION_RELEASED;
+        s->unfenced++;
+    }
+    threads_mutex_unlock(&s->m);
+}
+
+void asset_staging_fence(asset_staging_t *s)
+{
+    if (!s->base)
+        return;
+
+    threads_mutex_lock(&s->m);
+    // With the fence table full the released regions simply wait for the next call.
+    if (s->unfenced && s->fence_count < ASSET_STAGING_MAX_FENCES)
+    {
+        void *f = s->backend.fence_fn(s->backend.user);
+        if (f)
+        {
+            s->epoch++;
+            const uint32_t at = (s->fence_first + s->fence_count) % ASSET_STAGING_MAX_FENCES;
+            s->fences[at] = f;
+            s->fence_epochs[at] = s->epoch;
+            s->fence_count++;
+
+            for (uint64_t id = s->oldest_id; id < s->next_id; ++id)
+            {
+                asset_staging_region_t *r = &s->regions[id & s->region_mask];
+                if (r->state == STAGING_REGION_RELEASED && !r->epoch)
+                    r->epoch = s->epoch;
+            }
+            s->unfenced = 0;
+        }
+    }
+    threads_mutex_unlock(&s->m);
+}
+
+void asset_staging_retire(asset_staging_t *s)
+{
+    if (!s->base)
+        return;
+
+    threads_mutex_lock(&s->m);
+    while (s->fence_count)
+    {
+        void *f = s->fences[s->fence_first];
+        if (!s->backend.fence_wait_fn(s->backend.user, f, 0))
+            break;
+        if (s->backend.fence_free_fn)
+            s->backend.fence_free_fn(s->backend.user, f);
+        s->done_epoch = s->fence_epochs[s->fence_first];
+        s->fence_first = (s->fence_first + 1u) % ASSET_STAGING_MAX_FENCES;
+        s->fence_count--;
+    }
+    staging_reclaim_locked(s);
+    threads_mutex_unlock(&s->m);
+}
+
+bool asset_staging_offset_of(const asset_staging_t *s, const void *ptr, uint64_t *out_offset)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    if (!s->base || !p || p < s->base || p >= s->base + s->size)
+        return false;
+    if (out_offset)
+        *out_offset = (uint64_t)(p - s->base);
+    return true;
+}
+
+void asset_staging_usage(asset_staging_t *s, uint64_t *out_used_bytes, uint64_t *out_alloc_failures)
+{
+    uint64_t used = 0;
+    uint64_t failures = 0;
+    if (s->base)
+    {
+        threads_mutex_lock(&s->m);
+        used = s->head - s->tail;
+        failures = s->alloc_failures;
+        threads_mutex_unlock(&s->m);
+    }
+    if (out_used_bytes)
+        *out_used_bytes = used;
+    if (out_alloc_failures)
+        *out_alloc_failures = failures;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utils/threads.h"
+
+// Upload staging ring: one persistently mapped buffer that loader workers write into and the
+// render thread copies out of with GPU commands. Space is reclaimed in allocation order once a
+// fence issued after a region's last copy has signalled. The GPU side sits behind a backend so
+// the allocator and fence bookkeeping also run without a context.
+typedef struct asset_staging_backend_t
+{
+    void *user;
+    // Creates the buffer and returns a write mapping that stays valid and coherent until destroy_fn.
+    void *(*create_fn)(void *user, uint64_t size, uint32_t *out_buffer);
+    void (*destroy_fn)(void *user, uint32_t buffer);
+    // Fence after every command issued so far; NULL on failure.
+    void *(*fence_fn)(void *user);
+    // True once signalled. timeout_ns == 0 only polls.
+    bool (*fence_wait_fn)(void *user, void *fence, uint64_t timeout_ns);
+    void (*fence_free_fn)(void *user, void *fence);
+} asset_staging_backend_t;
+
+#define ASSET_STAGING_MAX_FENCES 64u
+
+typedef struct asset_staging_region_t
+{
+    uint64_t id;
+    uint64_t end;   // ring position just past the region, including bytes skipped at the wrap
+    uint64_t epoch; // fence covering the region's last copy, 0 = not fenced yet
+    uint32_t state;
+} asset_staging_region_t;
+
+typedef struct asset_staging_alloc_t
+{
+    uint64_t id;     // 0 = none
+    uint64_t offset; // into the buffer, for copy commands
+    void *ptr;
+} asset_staging_alloc_t;
+
+typedef struct asset_staging_t
+{
+    asset_staging_backend_t backend;
+    uint8_t *base;
+    uint64_t size;
+    uint32_t buffer;
+
+    mutex_t m;
+    // Positions only grow; the byte offset is pos % size.
+    uint64_t head;
+    uint64_t tail;
+
+    // Live regions in allocation order, indexed by id & region_mask.
+    asset_staging_region_t *regions;
+    uint32_t region_mask;
+    uint64_t next_id;
+    uint64_t oldest_id;
+    uint32_t unfenced;
+
+    void *fences[ASSET_STAGING_MAX_FENCES];
+    uint64_t fence_epochs[ASSET_STAGING_MAX_FENCES];
+    uint32_t fence_first;
+    uint32_t fence_count;
+    uint64_t epoch;
+    uint64_t done_epoch;
+
+    uint64_t alloc_failures;
+} asset_staging_t;
+
+// size is rounded down to a multiple of 256; max_regions up to a power of two.
+bool asset_staging_init(asset_staging_t *s, uint64_t size, uint32_t max_regions, const asset_staging_backend_t *backend);
+// Waits for outstanding fences, then releases the buffer.
+void asset_staging_shutdown(asset_staging_t *s);
+
+// Any thread. Fails instead of waiting when the ring is full; callers fall back to client memory.
+bool asset_staging_alloc(asset_staging_t *s, uint64_t size, uint32_t align, asset_staging_alloc_t *out);
+// Any thread, once no further copies will be issued from the region (or it was never used).
+void asset_staging_release(asset_staging_t *s, uint64_t id);
+
+// Render thread: fence() after issuing the frame's copies, retire() to reclaim finished regions.
+void asset_staging_fence(asset_staging_t *s);
+void asset_staging_retire(asset_staging_t *s);
+
+bool asset_staging_offset_of(const asset_staging_t *s, const void *ptr, uint64_t *out_offset);
+void asset_staging_usage(asset_staging_t *s, uint64_t *out_used_bytes, uint64_t *out_alloc_failures);
+
+// False when the context lacks ARB_buffer_storage.
+bool asset_staging_gl_backend(asset_staging_backend_t *out);
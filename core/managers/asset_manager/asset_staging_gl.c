@@ -0,0 +1,89 @@
+#include "asset_staging.h"
+
+#include <stddef.h>
+
+#if defined(__APPLE__)
+#include <OpenGL/gl3.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#if !defined(__APPLE__)
+#define STAGING_GL_MAP_FLAGS (GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)
+
+static void *gl_staging_create(void *user, uint64_t size, uint32_t *out_buffer)
+{
+    (void)user;
+
+    GLuint b = 0;
+    glGenBuffers(1, &b);
+    if (!b)
+        return NULL;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, b);
+    glBufferStorage(GL_COPY_READ_BUFFER, (GLsizeiptr)size, NULL, STAGING_GL_MAP_FLAGS);
+    void *p = glMapBufferRange(GL_COPY_READ_BUFFER, 0, (GLsizeiptr)size, STAGING_GL_MAP_FLAGS);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    if (!p)
+    {
+        glDeleteBuffers(1, &b);
+        return NULL;
+    }
+
+    *out_buffer = (uint32_t)b;
+    return p;
+}
+
+static void gl_staging_destroy(void *user, uint32_t buffer)
+{
+    (void)user;
+
+    GLuint b = (GLuint)buffer;
+    glBindBuffer(GL_COPY_READ_BUFFER, b);
+    glUnmapBuffer(GL_COPY_READ_BUFFER);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glDeleteBuffers(1, &b);
+}
+
+static void *gl_staging_fence(void *user)
+{
+    (void)user;
+    return (void *)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+static bool gl_staging_fence_wait(void *user, void *fence, uint64_t timeout_ns)
+{
+    (void)user;
+    // Flushing makes sure a fence that was only queued still gets a chance to signal.
+    GLenum r = glClientWaitSync((GLsync)fence, GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64)timeout_ns);
+    return r == GL_ALREADY_SIGNALED || r == GL_CONDITION_SATISFIED;
+}
+
+static void gl_staging_fence_free(void *user, void *fence)
+{
+    (void)user;
+    glDeleteSync((GLsync)fence);
+}
+#endif
+
+bool asset_staging_gl_backend(asset_staging_backend_t *out)
+{
+    if (!out)
+        return false;
+
+#if defined(__APPLE__)
+    return false;
+#else
+    if (!GLEW_VERSION_4_4 && !GLEW_ARB_buffer_storage)
+        return false;
+
+    out->user = NULL;
+    out->create_fn = gl_staging_create;
+    out->destroy_fn = gl_staging_destroy;
+    out->fence_fn = gl_staging_fence;
+    out->fence_wait_fn = gl_staging_fence_wait;
+    out->fence_free_fn = gl_staging_fence_free;
+    return true;
+#endif
+}
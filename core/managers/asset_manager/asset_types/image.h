@@ -5,10 +5,21 @@
 // (Typical textures are far smaller; this is just a safety cap.)
 #define ASSET_IMAGE_MAX_MIPS 20u
 
+// What the 8-bit rgb of an image holds; decides whether its mips are averaged in linear light.
+typedef enum asset_image_color_space_t
+{
+    ASSET_IMAGE_COLOR_SPACE_AUTO = 0, // unknown: the manager default, except for images that look like data
+    ASSET_IMAGE_COLOR_SPACE_SRGB,     // color: albedo, emissive
+    ASSET_IMAGE_COLOR_SPACE_LINEAR,   // data: normal, metallic, roughness, occlusion, height, ORM
+    ASSET_IMAGE_COLOR_SPACE_COUNT
+} asset_image_color_space_t;
+
 typedef struct asset_image_mip_chain_t
 {
     uint32_t mip_count;
-    uint32_t bytes_per_pixel;
+    uint32_t bytes_per_pixel; // per 4x4 block when bc_format is set
+    uint32_t bc_format;       // ASSET_IMAGE_BC*, 0 = uncompressed pixels
+    uint32_t color_space;     // asset_image_color_space_t the levels were filtered for
 
     uint32_t width[ASSET_IMAGE_MAX_MIPS];
     uint32_t height[ASSET_IMAGE_MAX_MIPS];
@@ -17,7 +28,23 @@ typedef struct asset_image_mip_chain_t
     uint64_t size[ASSET_IMAGE_MAX_MIPS];
 
     uint64_t total_size;
+    // Block holding the levels loaded with the chain; after asset_image_mips_trim only
+    // [resident_first, mip_count) remain in it.
     uint8_t *data;
+
+    // Pixels of each level while it is in RAM, NULL otherwise. Levels sharper than resident_first
+    // are paged in by the streamer on demand and owned individually (paged_mask).
+    uint8_t *level[ASSET_IMAGE_MAX_MIPS];
+    uint32_t resident_first;
+    uint32_t paged_mask;
+    uint64_t ram_bytes; // data block plus paged levels
+
+    // Copies of paged-in levels in the upload ring (asset_staging region id and buffer offset),
+    // written by the page-in job so the render thread only issues the GPU copy. Given back once
+    // the level is uploaded or no longer wanted.
+    uint64_t staged_id[ASSET_IMAGE_MAX_MIPS];
+    uint64_t staged_offset[ASSET_IMAGE_MAX_MIPS];
+    uint32_t staged_mask;
 } asset_image_mip_chain_t;
 
 typedef struct asset_image_t
@@ -32,10 +59,10 @@ typedef struct asset_image_t
     uint32_t has_smooth_alpha;
 
     uint32_t mip_count;
-    uint32_t reserved0;
+    uint32_t color_space; // asset_image_color_space_t the mips were built for
 
-    // If non-NULL, contains a full mip chain in RAM (generated on worker threads).
-    // The render thread uploads individual mip levels from this staging buffer.
+    // If non-NULL, describes the full mip chain (generated on worker threads). Only the levels with a
+    // non-NULL mips->level[] are in RAM; the render thread uploads individual mip levels from them.
     asset_image_mip_chain_t *mips;
 
     // Streaming state (mip indices: 0 = highest quality, mip_count-1 = lowest quality).
@@ -63,8 +90,15 @@ typedef struct asset_image_t
     uint8_t stream_forced_pad0[3];
     uint32_t stream_forced_top_mip;
 
+    // Speculative use (asset_manager_image_stream_record_prefetch) not yet confirmed by a real one.
+    uint32_t stream_prefetch_frame; // frame it was first recorded, 0 = none
+    uint32_t stream_prefetch_pad0;
+    uint64_t stream_prefetch_bytes; // uploaded since then
+
     uint8_t stream_sparse;
-    uint8_t stream_sparse_pad0[3];
+    uint8_t stream_page_inflight; // a job is reading missing levels back from disk
+    uint8_t stream_page_failed;   // reading them failed; streaming stays at the current top mip
+    uint8_t stream_sparse_pad0[1];
 
     // Partial mip upload state (one mip at a time, uploaded in row slices).
     uint32_t stream_upload_inflight_mip; // 0xFFFFFFFF when idle
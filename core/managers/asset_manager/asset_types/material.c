@@ -54,8 +54,8 @@ static bool ikv_read_handle(const ikv_node_t *parent, const char *key, ihandle_t
 
     ihandle_type_t type = (ihandle_type_t)ikv_as_int(nt);
     uint16_t meta = (uint16_t)ikv_as_int(nm);
-    uint16_t index = (uint16_t)ikv_as_int(ni);
-    uint16_t gen = (uint16_t)ikv_as_int(ng);
+    uint32_t index = (uint32_t)ikv_as_int(ni);
+    uint32_t gen = (uint32_t)ikv_as_int(ng);
 
     ihandle_t h = ihandle_make(type, index, gen);
     h = ihandle_with_meta(h, meta);
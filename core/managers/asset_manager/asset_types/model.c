@@ -32,7 +32,10 @@ static void model_cpu_submesh_free(model_cpu_submesh_t *sm)
     for (uint32_t i = 0; i < sm->lods.size; ++i)
     {
         model_cpu_lod_t *l = (model_cpu_lod_t *)vector_impl_at(&sm->lods, i);
-        model_cpu_lod_free(l);
+        if (sm->flags & CPU_SUBMESH_FLAG_BORROWED_LODS)
+            memset(l, 0, sizeof(*l));
+        else
+            model_cpu_lod_free(l);
     }
     vector_impl_free(&sm->lods);
 
@@ -58,6 +61,8 @@ void model_raw_destroy(model_raw_t *r)
 
     free(r->mtllib_path);
     r->mtllib_path = NULL;
+    free(r->storage);
+    r->storage = NULL;
     r->mtllib = ihandle_invalid();
     r->lod_count = 1;
 }
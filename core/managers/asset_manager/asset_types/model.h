@@ -31,7 +31,9 @@ typedef struct aabb_t
 
 enum model_cpu_submesh_flags_t
 {
-    CPU_SUBMESH_FLAG_HAS_AABB = 1 << 0
+    CPU_SUBMESH_FLAG_HAS_AABB = 1 << 0,
+    // LOD vertex/index arrays point into a mounted pack and are not owned by the submesh.
+    CPU_SUBMESH_FLAG_BORROWED_LODS = 1 << 1
 };
 
 typedef struct model_cpu_submesh_t
@@ -51,6 +53,9 @@ typedef struct model_raw_t
     char *mtllib_path;
     ihandle_t mtllib;
     uint8_t lod_count;
+    void *storage; // owned backing buffer for borrowed LOD arrays (decoded pack blobs), may be NULL
+    uint64_t staging_region; // asset_staging region holding borrowed LOD arrays; released by the loader, 0 = none
+    void *file_map; // asset_file_map_t of a mapped source file holding borrowed LOD arrays; released by the loader, may be NULL
 } model_raw_t;
 
 typedef struct mesh_lod_t
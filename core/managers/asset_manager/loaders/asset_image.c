@@ -9,6 +9,9 @@
 #include "stb_image.h"
 
 #include "image_mips.h"
+#include "image_upload.h"
+#include "utils/jobs.h"
+#include "utils/threads.h"
 
 #include <GL/glew.h>
 
@@ -40,96 +43,164 @@ static int asset_path_has_ext(const char *path, const char *ext_lower)
     return 1;
 }
 
-static int rgba_has_any_alpha(const uint8_t *rgba, uint32_t w, uint32_t h)
+// Pixels per job range for the row-parallel passes over a decoded image.
+#define IMAGE_RANGE_PIXELS 65536u
+
+static uint32_t image_row_grain(uint32_t w)
 {
-    size_t n = (size_t)w * (size_t)h;
-    for (size_t i = 0; i < n; ++i)
-    {
-        if (rgba[i * 4u + 3u] != 255u)
-            return 1;
-    }
-    return 0;
+    return w >= IMAGE_RANGE_PIXELS ? 1u : IMAGE_RANGE_PIXELS / w;
 }
 
-static int rgba_has_smooth_alpha(const uint8_t *rgba, uint32_t w, uint32_t h)
+typedef struct rgba_alpha_scan_t
 {
-    size_t n = (size_t)w * (size_t)h;
-    for (size_t i = 0; i < n; ++i)
+    const uint8_t *rgba;
+    uint32_t w;
+    volatile uint32_t any;
+    volatile uint32_t smooth;
+} rgba_alpha_scan_t;
+
+static void rgba_alpha_scan_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    (void)worker_index;
+    rgba_alpha_scan_t *scan = (rgba_alpha_scan_t *)user;
+    // Smooth alpha implies some alpha, so once any range has seen it the answer is known.
+    if (atomic_load_u32(&scan->smooth))
+        return;
+
+    uint32_t any = 0;
+    uint32_t smooth = 0;
+    for (uint32_t y = begin; y < end && !smooth; ++y)
     {
-        uint8_t a = rgba[i * 4u + 3u];
-        if (a != 0u && a != 255u)
-            return 1;
+        const uint8_t *a = scan->rgba + (size_t)y * scan->w * 4u + 3u;
+        uint8_t row_and = 255u;
+        for (uint32_t x = 0; x < scan->w; ++x)
+            row_and &= a[(size_t)x * 4u];
+        if (row_and == 255u)
+            continue;
+
+        any = 1u;
+        for (uint32_t x = 0; x < scan->w && !smooth; ++x)
+            smooth = (uint8_t)(a[(size_t)x * 4u] - 1u) < 254u;
     }
-    return 0;
+    if (any)
+        atomic_store_u32(&scan->any, 1u);
+    if (smooth)
+        atomic_store_u32(&scan->smooth, 1u);
 }
 
-static void rgba_dilate_rgb_into_zero_alpha(uint8_t *rgba, uint32_t w, uint32_t h, int passes)
+// One pass answers both questions: is any alpha below 255, and is any strictly between 0 and 255.
+static void rgba_scan_alpha(const uint8_t *rgba, uint32_t w, uint32_t h, uint32_t *out_any, uint32_t *out_smooth)
 {
-    if (!rgba || w == 0 || h == 0 || passes <= 0)
-        return;
+    rgba_alpha_scan_t scan;
+    scan.rgba = rgba;
+    scan.w = w;
+    scan.any = 0;
+    scan.smooth = 0;
+    jobs_parallel_for(h, image_row_grain(w), rgba_alpha_scan_range, &scan);
+    *out_smooth = atomic_load_u32(&scan.smooth);
+    *out_any = *out_smooth || atomic_load_u32(&scan.any);
+}
 
-    size_t n = (size_t)w * (size_t)h * 4u;
-    uint8_t *tmp = (uint8_t *)malloc(n);
-    if (!tmp)
-        return;
+typedef struct rgba_dilate_t
+{
+    const uint8_t *src;
+    uint8_t *dst;
+    uint32_t w;
+    uint32_t h;
+} rgba_dilate_t;
 
-    for (int p = 0; p < passes; ++p)
+static void rgba_dilate_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    (void)worker_index;
+    const rgba_dilate_t *d = (const rgba_dilate_t *)user;
+    const uint8_t *tmp = d->src;
+    const uint32_t w = d->w;
+    const uint32_t h = d->h;
+    const size_t row = (size_t)w * 4u;
+
+    for (uint32_t y = begin; y < end; ++y)
     {
-        memcpy(tmp, rgba, n);
+        uint8_t *rgba = d->dst;
+        memcpy(rgba + (size_t)y * row, tmp + (size_t)y * row, row);
 
-        for (uint32_t y = 0; y < h; ++y)
+        for (uint32_t x = 0; x < w; ++x)
         {
-            for (uint32_t x = 0; x < w; ++x)
+            size_t i = ((size_t)y * (size_t)w + (size_t)x) * 4u;
+            uint8_t a0 = tmp[i + 3u];
+            if (a0 != 0u)
+                continue;
+
+            uint8_t best_a = 0u;
+            uint8_t best_r = 0u, best_g = 0u, best_b = 0u;
+
+            for (int oy = -1; oy <= 1; ++oy)
             {
-                size_t i = ((size_t)y * (size_t)w + (size_t)x) * 4u;
-                uint8_t a0 = tmp[i + 3u];
-                if (a0 != 0u)
+                int yy = (int)y + oy;
+                if (yy < 0 || yy >= (int)h)
                     continue;
 
-                uint8_t best_a = 0u;
-                uint8_t best_r = 0u, best_g = 0u, best_b = 0u;
-
-                for (int oy = -1; oy <= 1; ++oy)
+                for (int ox = -1; ox <= 1; ++ox)
                 {
-                    int yy = (int)y + oy;
-                    if (yy < 0 || yy >= (int)h)
+                    int xx = (int)x + ox;
+                    if (xx < 0 || xx >= (int)w)
+                        continue;
+                    if (ox == 0 && oy == 0)
                         continue;
 
-                    for (int ox = -1; ox <= 1; ++ox)
+                    size_t j = ((size_t)yy * (size_t)w + (size_t)xx) * 4u;
+                    uint8_t aj = tmp[j + 3u];
+                    if (aj > best_a)
                     {
-                        int xx = (int)x + ox;
-                        if (xx < 0 || xx >= (int)w)
-                            continue;
-                        if (ox == 0 && oy == 0)
-                            continue;
-
-                        size_t j = ((size_t)yy * (size_t)w + (size_t)xx) * 4u;
-                        uint8_t aj = tmp[j + 3u];
-                        if (aj > best_a)
-                        {
-                            best_a = aj;
-                            best_r = tmp[j + 0u];
-                            best_g = tmp[j + 1u];
-                            best_b = tmp[j + 2u];
-                        }
+                        best_a = aj;
+                        best_r = tmp[j + 0u];
+                        best_g = tmp[j + 1u];
+                        best_b = tmp[j + 2u];
                     }
                 }
+            }
 
-                if (best_a != 0u)
-                {
-                    rgba[i + 0u] = best_r;
-                    rgba[i + 1u] = best_g;
-                    rgba[i + 2u] = best_b;
-                    rgba[i + 3u] = 0u;
-                }
+            if (best_a != 0u)
+            {
+                rgba[i + 0u] = best_r;
+                rgba[i + 1u] = best_g;
+                rgba[i + 2u] = best_b;
+                rgba[i + 3u] = 0u;
             }
         }
     }
+}
+
+// Each pass reads one buffer and writes every row of the other, so rows can be split across
+// threads; the buffers swap roles between passes.
+static void rgba_dilate_rgb_into_zero_alpha(uint8_t *rgba, uint32_t w, uint32_t h, int passes)
+{
+    if (!rgba || w == 0 || h == 0 || passes <= 0)
+        return;
+
+    size_t n = (size_t)w * (size_t)h * 4u;
+    uint8_t *tmp = (uint8_t *)malloc(n);
+    if (!tmp)
+        return;
+
+    rgba_dilate_t d;
+    d.src = rgba;
+    d.dst = tmp;
+    d.w = w;
+    d.h = h;
+    for (int p = 0; p < passes; ++p)
+    {
+        jobs_parallel_for(h, image_row_grain(w), rgba_dilate_range, &d);
+        uint8_t *written = d.dst;
+        d.dst = (uint8_t *)d.src;
+        d.src = written;
+    }
+    if (d.src != rgba)
+        memcpy(rgba, d.src, n);
 
     free(tmp);
 }
 
-static bool asset_image_load_from_memory(const asset_image_mem_desc_t *src, asset_any_t *out_asset)
+static bool asset_image_load_from_memory(const asset_manager_t *am, const asset_image_mem_desc_t *src, uint32_t color_space, asset_any_t *out_asset)
 {
     if (!src || !out_asset || !src->bytes || src->bytes_n == 0)
         return false;
@@ -156,26 +227,12 @@ static bool asset_image_load_from_memory(const asset_image_mem_desc_t *src, asse
         if (!data)
             return false;
 
-        size_t count = (size_t)w * (size_t)h * 3u;
-        size_t sz = count * sizeof(float);
-
-        float *copy = (float *)malloc(sz);
-        if (!copy)
-        {
-            stbi_image_free(data);
-            return false;
-        }
-
-        memcpy(copy, data, sz);
+        // The chain copies the base level, so it can be built straight from the decoder's buffer.
+        const bool built = asset_image_mips_build_f32(&mips, data, (uint32_t)w, (uint32_t)h, 3u, asset_manager_get_image_mip_filter(am));
         stbi_image_free(data);
-
-        if (!asset_image_mips_build_f32(&mips, copy, (uint32_t)w, (uint32_t)h, 3u))
-        {
-            free(copy);
+        if (!built)
             return false;
-        }
 
-        free(copy);
         pixels = NULL;
         channels = 3;
         is_float = 1;
@@ -188,33 +245,18 @@ static bool asset_image_load_from_memory(const asset_image_mem_desc_t *src, asse
         if (!data)
             return false;
 
-        size_t sz = (size_t)w * (size_t)h * (size_t)want_channels;
-
-        uint8_t *copy = (uint8_t *)malloc(sz);
-        if (!copy)
+        if (want_channels == 4)
         {
-            stbi_image_free(data);
-            return false;
+            rgba_scan_alpha(data, (uint32_t)w, (uint32_t)h, &has_alpha, &has_smooth_alpha);
+            if (has_alpha)
+                rgba_dilate_rgb_into_zero_alpha(data, (uint32_t)w, (uint32_t)h, 6);
         }
 
-        memcpy(copy, data, sz);
+        const bool built = asset_image_mips_build_u8(&mips, data, (uint32_t)w, (uint32_t)h, (uint32_t)want_channels, asset_manager_get_image_mip_filter(am), asset_manager_get_image_mip_flags(am, color_space));
         stbi_image_free(data);
-
-        if (want_channels == 4 && rgba_has_any_alpha(copy, (uint32_t)w, (uint32_t)h))
-        {
-            has_alpha = 1u;
-            if (rgba_has_smooth_alpha(copy, (uint32_t)w, (uint32_t)h))
-                has_smooth_alpha = 1u;
-            rgba_dilate_rgb_into_zero_alpha(copy, (uint32_t)w, (uint32_t)h, 6);
-        }
-
-        if (!asset_image_mips_build_u8(&mips, copy, (uint32_t)w, (uint32_t)h, (uint32_t)want_channels))
-        {
-            free(copy);
+        if (!built)
             return false;
-        }
 
-        free(copy);
         pixels = NULL;
         channels = (uint32_t)want_channels;
         is_float = 0;
@@ -233,11 +275,14 @@ static bool asset_image_load_from_memory(const asset_image_mem_desc_t *src, asse
     out_asset->as.image.has_smooth_alpha = has_smooth_alpha;
     out_asset->as.image.mips = mips;
     out_asset->as.image.mip_count = mips ? mips->mip_count : 0u;
+    out_asset->as.image.color_space = color_space;
+    if (mips)
+        mips->color_space = color_space;
 
     return true;
 }
 
-static bool asset_image_load_from_file(const char *path, asset_any_t *out_asset)
+static bool asset_image_load_from_file(const asset_manager_t *am, const char *path, uint32_t color_space, asset_any_t *out_asset)
 {
     if (!path || !path[0] || !out_asset)
         return false;
@@ -262,26 +307,12 @@ static bool asset_image_load_from_file(const char *path, asset_any_t *out_asset)
         if (!data)
             return false;
 
-        size_t count = (size_t)w * (size_t)h * 3u;
-        size_t sz = count * sizeof(float);
-
-        float *copy = (float *)malloc(sz);
-        if (!copy)
-        {
-            stbi_image_free(data);
-            return false;
-        }
-
-        memcpy(copy, data, sz);
+        // The chain copies the base level, so it can be built straight from the decoder's buffer.
+        const bool built = asset_image_mips_build_f32(&mips, data, (uint32_t)w, (uint32_t)h, 3u, asset_manager_get_image_mip_filter(am));
         stbi_image_free(data);
-
-        if (!asset_image_mips_build_f32(&mips, copy, (uint32_t)w, (uint32_t)h, 3u))
-        {
-            free(copy);
+        if (!built)
             return false;
-        }
 
-        free(copy);
         pixels = NULL;
         channels = 3;
         is_float = 1;
@@ -292,33 +323,18 @@ static bool asset_image_load_from_file(const char *path, asset_any_t *out_asset)
         if (!data)
             return false;
 
-        size_t sz = (size_t)w * (size_t)h * (size_t)want_channels;
-
-        uint8_t *copy = (uint8_t *)malloc(sz);
-        if (!copy)
+        if (want_channels == 4)
         {
-            stbi_image_free(data);
-            return false;
+            rgba_scan_alpha(data, (uint32_t)w, (uint32_t)h, &has_alpha, &has_smooth_alpha);
+            if (has_alpha)
+                rgba_dilate_rgb_into_zero_alpha(data, (uint32_t)w, (uint32_t)h, 6);
         }
 
-        memcpy(copy, data, sz);
+        const bool built = asset_image_mips_build_u8(&mips, data, (uint32_t)w, (uint32_t)h, (uint32_t)want_channels, asset_manager_get_image_mip_filter(am), asset_manager_get_image_mip_flags(am, color_space));
         stbi_image_free(data);
-
-        if (want_channels == 4 && rgba_has_any_alpha(copy, (uint32_t)w, (uint32_t)h))
-        {
-            has_alpha = 1u;
-            if (rgba_has_smooth_alpha(copy, (uint32_t)w, (uint32_t)h))
-                has_smooth_alpha = 1u;
-            rgba_dilate_rgb_into_zero_alpha(copy, (uint32_t)w, (uint32_t)h, 6);
-        }
-
-        if (!asset_image_mips_build_u8(&mips, copy, (uint32_t)w, (uint32_t)h, (uint32_t)want_channels))
-        {
-            free(copy);
+        if (!built)
             return false;
-        }
 
-        free(copy);
         pixels = NULL;
         channels = (uint32_t)want_channels;
         is_float = 0;
@@ -337,13 +353,15 @@ static bool asset_image_load_from_file(const char *path, asset_any_t *out_asset)
     out_asset->as.image.has_smooth_alpha = has_smooth_alpha;
     out_asset->as.image.mips = mips;
     out_asset->as.image.mip_count = mips ? mips->mip_count : 0u;
+    out_asset->as.image.color_space = color_space;
+    if (mips)
+        mips->color_space = color_space;
 
     return true;
 }
 
 static bool asset_image_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr, asset_any_t *out_asset, ihandle_t *out_handle)
 {
-    (void)am;
     if (out_handle)
         *out_handle = ihandle_invalid();
 
@@ -354,7 +372,7 @@ static bool asset_image_load(asset_manager_t *am, const char *path, uint32_t pat
     {
         const asset_image_mem_desc_t *src = (const asset_image_mem_desc_t *)path;
 
-        bool ok = asset_image_load_from_memory(src, out_asset);
+        bool ok = asset_image_load_from_memory(am, src, asset_manager_get_loading_image_color_space(am), out_asset);
 
         if (src)
         {
@@ -368,133 +386,47 @@ static bool asset_image_load(asset_manager_t *am, const char *path, uint32_t pat
         return ok;
     }
 
-    return asset_image_load_from_file(path, out_asset);
+    return asset_image_load_from_file(am, path, asset_manager_get_loading_image_color_space(am), out_asset);
 }
 
-static bool asset_image_init(asset_manager_t *am, asset_any_t *asset)
+// Only decodes source files handed over by the I/O stage; pack blobs belong to the itex module.
+static bool asset_image_load_blob(asset_manager_t *am, const char *path, const asset_blob_t *blob, asset_any_t *out_asset, ihandle_t *out_handle)
 {
-    (void)am;
+    (void)path;
+    if (out_handle)
+        *out_handle = ihandle_invalid();
 
-    if (!asset || asset->type != ASSET_IMAGE)
+    if (!blob || !out_asset || !(blob->flags & ASSET_BLOB_FLAG_SOURCE_FILE) || blob->codec != ASSET_CODEC_NONE)
         return false;
 
-    asset_image_t *img = &asset->as.image;
-    if (img->gl_handle != 0)
-        return true;
+    asset_image_mem_desc_t src;
+    memset(&src, 0, sizeof(src));
+    src.bytes = blob->data;
+    src.bytes_n = blob->size;
+    return asset_image_load_from_memory(am, &src, asset_manager_get_loading_image_color_space(am), out_asset);
+}
 
-    if (!img->mips || !img->mips->data || img->mips->mip_count == 0 || img->width == 0 || img->height == 0)
-        return false;
+static bool asset_image_mip_read(asset_manager_t *am, const char *path, const asset_blob_t *blob, const asset_image_mip_chain_t *layout, uint32_t first_mip, uint32_t last_mip, uint8_t **out_levels)
+{
+    (void)path;
 
-    GLuint tex = 0;
-    glGenTextures(1, &tex);
-    if (!tex)
+    if (!blob || !(blob->flags & ASSET_BLOB_FLAG_SOURCE_FILE) || blob->codec != ASSET_CODEC_NONE || !layout || !out_levels)
         return false;
 
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    asset_image_mem_desc_t src;
+    memset(&src, 0, sizeof(src));
+    src.bytes = blob->data;
+    src.bytes_n = blob->size;
 
-    const uint32_t mip_count = img->mips->mip_count;
-    const uint32_t lowest_mip = (mip_count > 0) ? (mip_count - 1u) : 0u;
-
-    int sparse_ok = 0;
-#if !defined(__APPLE__)
-    if (GLEW_ARB_sparse_texture != 0)
-    {
-        GLint num_levels = 0;
-        GLenum internal_query = 0;
-        if (img->is_float)
-            internal_query = (img->channels == 4) ? GL_RGBA16F : (img->channels == 3 ? GL_RGB16F : GL_R16F);
-        else
-            internal_query = (img->channels == 4) ? GL_RGBA8 : (img->channels == 3 ? GL_RGB8 : GL_R8);
-
-        glGetInternalformativ(GL_TEXTURE_2D, internal_query, GL_NUM_SPARSE_LEVELS_ARB, 1, &num_levels);
-        if (glGetError() == GL_NO_ERROR && num_levels > 0)
-            sparse_ok = 1;
-    }
-#endif
-
-    if (img->is_float)
-    {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-        const GLenum fmt = (img->channels == 4) ? GL_RGBA : (img->channels == 3 ? GL_RGB : GL_RED);
-        const GLint internal = (img->channels == 4) ? GL_RGBA16F : (img->channels == 3 ? GL_RGB16F : GL_R16F);
-
-        if (sparse_ok)
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
-        glTexStorage2D(GL_TEXTURE_2D, (GLsizei)mip_count, (GLenum)internal, (GLsizei)img->width, (GLsizei)img->height);
-
-        const uint32_t mw = img->mips->width[lowest_mip];
-        const uint32_t mh = img->mips->height[lowest_mip];
-        const void *src = (const void *)(img->mips->data + (size_t)img->mips->offset[lowest_mip]);
-        if (sparse_ok)
-            glTexPageCommitmentARB(GL_TEXTURE_2D, (GLint)lowest_mip, 0, 0, 0, (GLsizei)mw, (GLsizei)mh, 1, GL_TRUE);
-        glTexSubImage2D(GL_TEXTURE_2D, (GLint)lowest_mip, 0, 0, (GLsizei)mw, (GLsizei)mh, fmt, GL_FLOAT, src);
-    }
-    else
-    {
-        const int has_alpha = (img->has_alpha != 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, has_alpha ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, has_alpha ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-
-        const GLenum fmt = (img->channels == 4) ? GL_RGBA : (img->channels == 3 ? GL_RGB : GL_RED);
-        const GLint internal = (img->channels == 4) ? GL_RGBA8 : (img->channels == 3 ? GL_RGB8 : GL_R8);
-
-        if (sparse_ok)
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
-        glTexStorage2D(GL_TEXTURE_2D, (GLsizei)mip_count, (GLenum)internal, (GLsizei)img->width, (GLsizei)img->height);
-
-        const uint32_t mw = img->mips->width[lowest_mip];
-        const uint32_t mh = img->mips->height[lowest_mip];
-        const void *src = (const void *)(img->mips->data + (size_t)img->mips->offset[lowest_mip]);
-        if (sparse_ok)
-            glTexPageCommitmentARB(GL_TEXTURE_2D, (GLint)lowest_mip, 0, 0, 0, (GLsizei)mw, (GLsizei)mh, 1, GL_TRUE);
-        glTexSubImage2D(GL_TEXTURE_2D, (GLint)lowest_mip, 0, 0, (GLsizei)mw, (GLsizei)mh, fmt, GL_UNSIGNED_BYTE, src);
-    }
-
-    // Clamp sampling to resident mip range (starts at lowest mip only).
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)lowest_mip);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)lowest_mip);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    img->gl_handle = (uint32_t)tex;
-
-    img->stream_current_top_mip = lowest_mip;
-    img->stream_target_top_mip = lowest_mip;
-    img->stream_min_safety_mip = lowest_mip;
-    img->stream_pending_target_top_mip = lowest_mip;
-    img->stream_pending_frames = 0;
-    img->stream_priority = 0;
-    img->stream_residency_mask = (lowest_mip < 64u) ? (1ull << lowest_mip) : 0ull;
-    img->stream_last_used_frame = 0;
-    img->stream_last_used_ms = 0;
-    img->stream_best_target_mip_frame = 0;
-    img->stream_best_target_mip = lowest_mip;
-    img->stream_best_priority_frame = 0;
-    img->stream_best_priority = 0;
-    img->stream_last_upload_frame = 0;
-    img->stream_last_evict_frame = 0;
-    img->stream_forced = 0;
-    img->stream_forced_top_mip = 0;
-    img->stream_sparse = sparse_ok ? 1u : 0u;
-    img->stream_upload_inflight_mip = 0xFFFFFFFFu;
-    img->stream_upload_row = 0u;
-
-    img->vram_bytes = img->mips->size[lowest_mip];
-
-    if (img->pixels)
-    {
-        free(img->pixels);
-        img->pixels = NULL;
-    }
+    asset_any_t tmp;
+    // Rebuilt for the color space the resident levels were filtered for.
+    if (!asset_image_load_from_memory(am, &src, layout->color_space, &tmp))
+        return false;
 
-    return true;
+    bool ok = asset_image_mips_extract(tmp.as.image.mips, layout, first_mip, last_mip, out_levels);
+    asset_image_mips_free(tmp.as.image.mips);
+    free(tmp.as.image.pixels);
+    return ok;
 }
 
 static void asset_image_cleanup(asset_manager_t *am, asset_any_t *asset)
@@ -596,13 +528,17 @@ static bool asset_image_can_load(asset_manager_t *am, const char *path, uint32_t
 asset_module_desc_t asset_module_image(void)
 {
     asset_module_desc_t m;
+    memset(&m, 0, sizeof(m));
     m.type = ASSET_IMAGE;
     m.name = "ASSET_IMAGE_STB";
     m.load_fn = asset_image_load;
-    m.init_fn = asset_image_init;
+    m.init_fn = asset_image_upload_all;
+    m.upload_fn = asset_image_upload;
     m.cleanup_fn = asset_image_cleanup;
     m.save_blob_fn = NULL;
     m.blob_free_fn = NULL;
     m.can_load_fn = asset_image_can_load;
+    m.load_blob_fn = asset_image_load_blob;
+    m.mip_read_fn = asset_image_mip_read;
     return m;
 }
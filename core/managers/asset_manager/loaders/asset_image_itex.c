@@ -12,6 +12,8 @@
 #include <GL/glew.h>
 
 #include "image_mips.h"
+#include "image_bcn.h"
+#include "image_upload.h"
 
 #if defined(_WIN32)
 #define ITEX_STRICMP _stricmp
@@ -21,7 +23,16 @@
 #endif
 
 #define ITEX_MAGIC 0x58455449u
-#define ITEX_VERSION 1u
+#define ITEX_VERSION 4u
+#define ITEX_VERSION_MIPS 3u    // legacy: uncompressed levels only
+#define ITEX_VERSION_CODEC 2u   // legacy: base level only, one ASSET_CODEC_* stream
+#define ITEX_VERSION_DEFLATE 1u // legacy: base level only, a single zlib stream, `codec` is unused
+
+// Versions 1-3 end the header after mip_count.
+#define ITEX_HEADER_SIZE_V3 56u
+
+// Levels smaller than this are stored raw; the codec frame would cost more than it saves.
+#define ITEX_MIP_MIN_ENCODE_BYTES 4096u
 
 #pragma pack(push, 1)
 typedef struct itex_header_t
@@ -38,6 +49,7 @@ typedef struct itex_header_t
     uint32_t has_alpha;
     uint32_t has_smooth_alpha;
 
+    // Version 3: the whole chain and everything after the mip table.
     uint32_t uncompressed_size;
     uint32_t compressed_size;
 
@@ -45,9 +57,21 @@ typedef struct itex_header_t
     uint16_t handle_type;
     uint16_t handle_meta;
 
-    uint32_t reserved0;
-    uint32_t reserved1;
+    uint32_t codec;     // ASSET_CODEC_* (version 2+; per level from version 3)
+    uint32_t mip_count; // version 3+: entries in the mip table following the header
+
+    uint32_t bc_format;   // version 4: ASSET_IMAGE_BC*, levels hold 4x4 blocks instead of pixels
+    uint32_t color_space; // version 4: asset_image_color_space_t the levels were built for, 0 if unknown
 } itex_header_t;
+
+// Version 3+ stores every level of the chain, already flipped, each encoded on its own.
+typedef struct itex_mip_t
+{
+    uint32_t offset; // from the start of the file
+    uint32_t size;   // stored bytes
+    uint32_t codec;  // ASSET_CODEC_*
+    uint32_t reserved;
+} itex_mip_t;
 #pragma pack(pop)
 
 static int asset_path_has_ext_lower(const char *path, const char *ext_lower)
@@ -94,6 +118,25 @@ static void image_flip_y_bytes(void *pixels, uint32_t w, uint32_t h, uint32_t by
     free(tmp);
 }
 
+static uint32_t itex_bytes_per_pixel(uint32_t channels, uint32_t is_float)
+{
+    uint32_t b = channels;
+    if (is_float)
+        b *= 4u;
+    return b;
+}
+
+static bool itex_has_mips(const itex_header_t *h)
+{
+    return h->version >= ITEX_VERSION_MIPS;
+}
+
+// Size of the unit a stored level is made of: a pixel, or a 4x4 block.
+static uint32_t itex_unit_bytes(const itex_header_t *h)
+{
+    return h->bc_format ? asset_image_bc_block_bytes(h->bc_format) : itex_bytes_per_pixel(h->channels, h->is_float);
+}
+
 static bool itex_can_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr)
 {
     (void)am;
@@ -106,259 +149,395 @@ static bool itex_can_load(asset_manager_t *am, const char *path, uint32_t path_i
     return asset_path_has_ext_lower(path, ".itex");
 }
 
-static bool itex_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr, asset_any_t *out_asset, ihandle_t *out_handle)
+static bool itex_check_header(const itex_header_t *h, const char *name)
 {
-    (void)am;
-
-    if (out_handle)
-        *out_handle = ihandle_invalid();
-
-    if (!out_asset || !out_handle || !path || path_is_ptr)
+    const uint32_t header_size = h->version >= ITEX_VERSION ? (uint32_t)sizeof(itex_header_t) : ITEX_HEADER_SIZE_V3;
+    if (h->magic != ITEX_MAGIC || h->version == 0 || h->version > ITEX_VERSION || h->header_size != header_size)
+    {
+        LOG_ERROR("itex: bad header '%s'", name);
         return false;
+    }
 
-    FILE *f = fopen(path, "rb");
-    if (!f)
+    if (h->width == 0 || h->height == 0 || h->channels == 0)
     {
-        LOG_ERROR("itex: open failed '%s'", path);
+        LOG_ERROR("itex: bad dims '%s'", name);
         return false;
     }
 
-    itex_header_t h;
-    if (fread(&h, 1, sizeof(h), f) != sizeof(h))
+    if (h->compressed_size == 0 || h->uncompressed_size == 0)
     {
-        fclose(f);
-        LOG_ERROR("itex: header read failed '%s'", path);
+        LOG_ERROR("itex: bad sizes '%s'", name);
         return false;
     }
 
-    if (h.magic != ITEX_MAGIC || h.version != ITEX_VERSION || h.header_size != (uint16_t)sizeof(itex_header_t))
+    if (h->version == ITEX_VERSION_CODEC && h->codec != ASSET_CODEC_NONE && !asset_codec_get((uint8_t)h->codec))
     {
-        fclose(f);
-        LOG_ERROR("itex: bad header '%s'", path);
+        LOG_ERROR("itex: unknown codec %u '%s'", (unsigned)h->codec, name);
         return false;
     }
 
-    if (h.width == 0 || h.height == 0 || h.channels == 0)
+    if (itex_has_mips(h) && (h->mip_count == 0 || h->mip_count > ASSET_IMAGE_MAX_MIPS))
     {
-        fclose(f);
-        LOG_ERROR("itex: bad dims '%s'", path);
+        LOG_ERROR("itex: bad mip count %u '%s'", (unsigned)h->mip_count, name);
         return false;
     }
 
-    if (h.compressed_size == 0 || h.uncompressed_size == 0)
+    if (h->bc_format && (!asset_image_bc_block_bytes(h->bc_format) || h->is_float))
     {
-        fclose(f);
-        LOG_ERROR("itex: bad sizes '%s'", path);
+        LOG_ERROR("itex: bad block format %u '%s'", (unsigned)h->bc_format, name);
         return false;
     }
 
-    uint8_t *comp = (uint8_t *)malloc((size_t)h.compressed_size);
-    if (!comp)
+    if (h->color_space >= ASSET_IMAGE_COLOR_SPACE_COUNT)
     {
-        fclose(f);
-        LOG_ERROR("itex: oom compressed '%s'", path);
+        LOG_ERROR("itex: bad color space %u '%s'", (unsigned)h->color_space, name);
         return false;
     }
 
-    if (fread(comp, 1, (size_t)h.compressed_size, f) != (size_t)h.compressed_size)
+    return true;
+}
+
+static bool itex_decode_payload(const itex_header_t *h, const uint8_t *comp, uint8_t *pixels)
+{
+    if (h->version == ITEX_VERSION_DEFLATE)
     {
-        free(comp);
-        fclose(f);
-        LOG_ERROR("itex: data read failed '%s'", path);
-        return false;
+        mz_ulong dst_len = (mz_ulong)h->uncompressed_size;
+        int z = mz_uncompress(pixels, &dst_len, comp, (mz_ulong)h->compressed_size);
+        return z == MZ_OK && (uint32_t)dst_len == h->uncompressed_size;
     }
 
-    fclose(f);
+    if (h->codec == ASSET_CODEC_NONE)
+    {
+        if (h->compressed_size != h->uncompressed_size)
+            return false;
+        memcpy(pixels, comp, (size_t)h->uncompressed_size);
+        return true;
+    }
+
+    return asset_codec_decode((uint8_t)h->codec, comp, h->compressed_size, pixels, h->uncompressed_size);
+}
+
+static void itex_fill_asset(const itex_header_t *h, asset_image_mip_chain_t *mips, asset_any_t *out_asset, ihandle_t *out_handle)
+{
+    memset(out_asset, 0, sizeof(*out_asset));
+    out_asset->type = ASSET_IMAGE;
+    out_asset->state = ASSET_STATE_LOADING;
+
+    out_asset->as.image.width = h->width;
+    out_asset->as.image.height = h->height;
+    out_asset->as.image.channels = h->channels;
+    out_asset->as.image.pixels = NULL;
+    out_asset->as.image.gl_handle = 0;
+    out_asset->as.image.is_float = h->is_float;
+    out_asset->as.image.has_alpha = h->has_alpha;
+    out_asset->as.image.has_smooth_alpha = h->has_smooth_alpha;
+    out_asset->as.image.mips = mips;
+    out_asset->as.image.mip_count = mips ? mips->mip_count : 0u;
+    out_asset->as.image.color_space = h->color_space;
 
-    uint8_t *pixels = (uint8_t *)malloc((size_t)h.uncompressed_size);
+    ihandle_t stored;
+    stored.value = h->handle_value;
+    stored.type = h->handle_type;
+    stored.meta = h->handle_meta;
+    *out_handle = stored;
+}
+
+// Legacy files: decodes the base level in `comp` (h->compressed_size bytes, read-only) and builds the chain.
+// Legacy headers carry no color space; the caller passes the one to build the chain for.
+static bool itex_decode_base(const asset_manager_t *am, const itex_header_t *h, uint32_t color_space, const uint8_t *comp, const char *name, asset_any_t *out_asset, ihandle_t *out_handle)
+{
+    uint8_t *pixels = (uint8_t *)malloc((size_t)h->uncompressed_size);
     if (!pixels)
     {
-        free(comp);
-        LOG_ERROR("itex: oom pixels '%s'", path);
+        LOG_ERROR("itex: oom pixels '%s'", name);
         return false;
     }
 
-    mz_ulong dst_len = (mz_ulong)h.uncompressed_size;
-    int z = mz_uncompress(pixels, &dst_len, comp, (mz_ulong)h.compressed_size);
-    free(comp);
-
-    if (z != MZ_OK || (uint32_t)dst_len != h.uncompressed_size)
+    if (!itex_decode_payload(h, comp, pixels))
     {
         free(pixels);
-        LOG_ERROR("itex: decompress failed '%s'", path);
+        LOG_ERROR("itex: decompress failed '%s'", name);
         return false;
     }
 
     // Keep UVs consistent by flipping at load time (matches previous init-time behavior).
-    {
-        uint32_t bpp = h.channels * (h.is_float ? (uint32_t)sizeof(float) : 1u);
-        image_flip_y_bytes(pixels, h.width, h.height, bpp);
-    }
+    image_flip_y_bytes(pixels, h->width, h->height, itex_bytes_per_pixel(h->channels, h->is_float));
 
     asset_image_mip_chain_t *mips = NULL;
-    if (h.is_float)
+    if (h->is_float)
     {
-        if (!asset_image_mips_build_f32(&mips, (const float *)(const void *)pixels, h.width, h.height, h.channels))
+        if (!asset_image_mips_build_f32(&mips, (const float *)(const void *)pixels, h->width, h->height, h->channels, asset_manager_get_image_mip_filter(am)))
         {
             free(pixels);
-            LOG_ERROR("itex: mip build failed '%s'", path);
+            LOG_ERROR("itex: mip build failed '%s'", name);
             return false;
         }
     }
     else
     {
-        if (!asset_image_mips_build_u8(&mips, pixels, h.width, h.height, h.channels))
+        if (!asset_image_mips_build_u8(&mips, pixels, h->width, h->height, h->channels, asset_manager_get_image_mip_filter(am), asset_manager_get_image_mip_flags(am, color_space)))
         {
             free(pixels);
-            LOG_ERROR("itex: mip build failed '%s'", path);
+            LOG_ERROR("itex: mip build failed '%s'", name);
             return false;
         }
     }
 
     free(pixels);
-    pixels = NULL;
+    mips->color_space = color_space;
+    itex_fill_asset(h, mips, out_asset, out_handle);
+    out_asset->as.image.color_space = color_space;
+    return true;
+}
 
-    memset(out_asset, 0, sizeof(*out_asset));
-    out_asset->type = ASSET_IMAGE;
-    out_asset->state = ASSET_STATE_LOADING;
+// Checks a version 3+ mip table against the chain the header describes. `file_size` bounds the offsets.
+static bool itex_check_mips(const itex_header_t *h, const itex_mip_t *mips, const asset_image_mip_chain_t *layout, uint64_t file_size, const char *name)
+{
+    if (layout->mip_count != h->mip_count)
+    {
+        LOG_ERROR("itex: mip count %u does not match %ux%u '%s'", (unsigned)h->mip_count, (unsigned)h->width, (unsigned)h->height, name);
+        return false;
+    }
 
-    out_asset->as.image.width = h.width;
-    out_asset->as.image.height = h.height;
-    out_asset->as.image.channels = h.channels;
-    out_asset->as.image.pixels = NULL;
-    out_asset->as.image.gl_handle = 0;
-    out_asset->as.image.is_float = h.is_float;
-    out_asset->as.image.has_alpha = h.has_alpha;
-    out_asset->as.image.has_smooth_alpha = h.has_smooth_alpha;
-    out_asset->as.image.mips = mips;
-    out_asset->as.image.mip_count = mips ? mips->mip_count : 0u;
+    for (uint32_t i = 0; i < h->mip_count; ++i)
+    {
+        const itex_mip_t *e = &mips[i];
+        const bool raw = e->codec == ASSET_CODEC_NONE;
+        if ((uint64_t)e->offset + e->size > file_size || (raw && e->size != layout->size[i]) || (!raw && !asset_codec_get((uint8_t)e->codec)))
+        {
+            LOG_ERROR("itex: bad mip %u '%s'", (unsigned)i, name);
+            return false;
+        }
+    }
+    return true;
+}
 
-    ihandle_t stored;
-    stored.value = h.handle_value;
-    stored.type = h.handle_type;
-    stored.meta = h.handle_meta;
-    *out_handle = stored;
+// Decodes levels [first, last] into dst[]. `data` holds the file from byte `data_offset` on.
+static bool itex_decode_levels(const itex_mip_t *mips, const asset_image_mip_chain_t *layout, uint32_t first, uint32_t last, const uint8_t *data, uint64_t data_offset, uint64_t data_size, uint8_t *const *dst)
+{
+    for (uint32_t i = first; i <= last; ++i)
+    {
+        const itex_mip_t *e = &mips[i];
+        if (e->offset < data_offset || (uint64_t)e->offset + e->size > data_offset + data_size)
+            return false;
 
+        const uint8_t *src = data + (size_t)(e->offset - data_offset);
+        if (e->codec == ASSET_CODEC_NONE)
+            memcpy(dst[i], src, (size_t)e->size);
+        else if (!asset_codec_decode((uint8_t)e->codec, src, e->size, dst[i], (uint32_t)layout->size[i]))
+            return false;
+    }
     return true;
 }
 
-static bool itex_init(asset_manager_t *am, asset_any_t *asset)
+// Version 3+: only the levels the manager keeps after load are decoded; the streamer reads the
+// sharper ones through itex_mip_read when it needs them.
+static bool itex_decode_chain(asset_manager_t *am, const itex_header_t *h, const itex_mip_t *mips, uint64_t file_size,
+                              const uint8_t *data, uint64_t data_offset, uint64_t data_size, const char *name,
+                              asset_any_t *out_asset, ihandle_t *out_handle)
 {
-    (void)am;
+    asset_image_mip_chain_t *chain = NULL;
+    const uint32_t first = asset_manager_image_resident_first(am, h->mip_count);
+    if (!asset_image_mips_alloc(&chain, h->width, h->height, itex_unit_bytes(h), h->bc_format, first))
+    {
+        LOG_ERROR("itex: oom mips '%s'", name);
+        return false;
+    }
 
-    if (!asset || asset->type != ASSET_IMAGE)
+    if (!itex_check_mips(h, mips, chain, file_size, name) ||
+        !itex_decode_levels(mips, chain, chain->resident_first, chain->mip_count - 1u, data, data_offset, data_size, chain->level))
+    {
+        asset_image_mips_free(chain);
+        LOG_ERROR("itex: mip decode failed '%s'", name);
         return false;
+    }
 
-    asset_image_t *img = &asset->as.image;
-    if (img->gl_handle != 0)
-        return true;
+    chain->color_space = h->color_space;
+    itex_fill_asset(h, chain, out_asset, out_handle);
+    return true;
+}
 
-    if (!img->mips || !img->mips->data || img->mips->mip_count == 0 || img->width == 0 || img->height == 0 || img->channels == 0)
-        return false;
+static bool itex_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr, asset_any_t *out_asset, ihandle_t *out_handle)
+{
+    if (out_handle)
+        *out_handle = ihandle_invalid();
 
-    GLuint tex = 0;
-    glGenTextures(1, &tex);
-    if (!tex)
+    if (!out_asset || !out_handle || !path || path_is_ptr)
         return false;
 
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        LOG_ERROR("itex: open failed '%s'", path);
+        return false;
+    }
 
-    const uint32_t mip_count = img->mips->mip_count;
-    const uint32_t lowest_mip = (mip_count > 0) ? (mip_count - 1u) : 0u;
+    itex_header_t h;
+    memset(&h, 0, sizeof(h));
+    bool read_ok = fread(&h, 1, ITEX_HEADER_SIZE_V3, f) == ITEX_HEADER_SIZE_V3;
+    if (read_ok && h.version >= ITEX_VERSION)
+        read_ok = fread((uint8_t *)&h + ITEX_HEADER_SIZE_V3, 1, sizeof(h) - ITEX_HEADER_SIZE_V3, f) == sizeof(h) - ITEX_HEADER_SIZE_V3;
+    if (!read_ok)
+    {
+        fclose(f);
+        LOG_ERROR("itex: header read failed '%s'", path);
+        return false;
+    }
 
-    int sparse_ok = 0;
-#if !defined(__APPLE__)
-    if (GLEW_ARB_sparse_texture != 0)
+    if (!itex_check_header(&h, path))
     {
-        GLint num_levels = 0;
-        GLenum internal_query = img->is_float ? ((img->channels == 4) ? GL_RGBA16F : (img->channels == 3 ? GL_RGB16F : GL_R16F))
-                                              : ((img->channels == 4) ? GL_RGBA8 : (img->channels == 3 ? GL_RGB8 : GL_R8));
-        glGetInternalformativ(GL_TEXTURE_2D, internal_query, GL_NUM_SPARSE_LEVELS_ARB, 1, &num_levels);
-        if (glGetError() == GL_NO_ERROR && num_levels > 0)
-            sparse_ok = 1;
+        fclose(f);
+        return false;
     }
-#endif
 
-    if (img->is_float)
+    if (itex_has_mips(&h))
     {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        itex_mip_t mips[ASSET_IMAGE_MAX_MIPS];
+        const uint64_t file_size = (uint64_t)h.header_size + (uint64_t)h.mip_count * sizeof(itex_mip_t) + h.compressed_size;
+        const uint32_t first = asset_manager_image_resident_first(am, h.mip_count);
+        bool ok = fread(mips, sizeof(itex_mip_t), h.mip_count, f) == h.mip_count;
 
-        const GLenum fmt = (img->channels == 4) ? GL_RGBA : (img->channels == 3 ? GL_RGB : GL_RED);
-        const GLint internal = (img->channels == 4) ? GL_RGBA16F : (img->channels == 3 ? GL_RGB16F : GL_R16F);
+        // Levels are stored sharpest first, so the ones kept after load are one range at the end.
+        const uint64_t from = ok ? mips[first].offset : 0;
+        const uint64_t size = ok && file_size > from ? file_size - from : 0;
+        uint8_t *data = size ? (uint8_t *)malloc((size_t)size) : NULL;
+        ok = data && fseek(f, (long)from, SEEK_SET) == 0 && fread(data, 1, (size_t)size, f) == (size_t)size;
+        fclose(f);
+        if (!ok)
+        {
+            free(data);
+            LOG_ERROR("itex: data read failed '%s'", path);
+            return false;
+        }
 
-        if (sparse_ok)
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
-        glTexStorage2D(GL_TEXTURE_2D, (GLsizei)mip_count, (GLenum)internal, (GLsizei)img->width, (GLsizei)img->height);
+        ok = itex_decode_chain(am, &h, mips, file_size, data, from, size, path, out_asset, out_handle);
+        free(data);
+        return ok;
+    }
 
-        const uint32_t mw = img->mips->width[lowest_mip];
-        const uint32_t mh = img->mips->height[lowest_mip];
-        const void *src = (const void *)(img->mips->data + (size_t)img->mips->offset[lowest_mip]);
-        if (sparse_ok)
-            glTexPageCommitmentARB(GL_TEXTURE_2D, (GLint)lowest_mip, 0, 0, 0, (GLsizei)mw, (GLsizei)mh, 1, GL_TRUE);
-        glTexSubImage2D(GL_TEXTURE_2D, (GLint)lowest_mip, 0, 0, (GLsizei)mw, (GLsizei)mh, fmt, GL_FLOAT, src);
+    uint8_t *comp = (uint8_t *)malloc((size_t)h.compressed_size);
+    if (!comp)
+    {
+        fclose(f);
+        LOG_ERROR("itex: oom compressed '%s'", path);
+        return false;
     }
-    else
+
+    if (fread(comp, 1, (size_t)h.compressed_size, f) != (size_t)h.compressed_size)
     {
-        int has_alpha = (img->has_alpha != 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, has_alpha ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, has_alpha ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+        free(comp);
+        fclose(f);
+        LOG_ERROR("itex: data read failed '%s'", path);
+        return false;
+    }
 
-        const GLenum fmt = (img->channels == 4) ? GL_RGBA : (img->channels == 3 ? GL_RGB : GL_RED);
-        const GLint internal = (img->channels == 4) ? GL_RGBA8 : (img->channels == 3 ? GL_RGB8 : GL_R8);
+    fclose(f);
 
-        if (sparse_ok)
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
-        glTexStorage2D(GL_TEXTURE_2D, (GLsizei)mip_count, (GLenum)internal, (GLsizei)img->width, (GLsizei)img->height);
+    bool ok = itex_decode_base(am, &h, asset_manager_get_loading_image_color_space(am), comp, path, out_asset, out_handle);
+    free(comp);
+    return ok;
+}
 
-        const uint32_t mw = img->mips->width[lowest_mip];
-        const uint32_t mh = img->mips->height[lowest_mip];
-        const void *src = (const void *)(img->mips->data + (size_t)img->mips->offset[lowest_mip]);
-        if (sparse_ok)
-            glTexPageCommitmentARB(GL_TEXTURE_2D, (GLint)lowest_mip, 0, 0, 0, (GLsizei)mw, (GLsizei)mh, 1, GL_TRUE);
-        glTexSubImage2D(GL_TEXTURE_2D, (GLint)lowest_mip, 0, 0, (GLsizei)mw, (GLsizei)mh, fmt, GL_UNSIGNED_BYTE, src);
+// Validates the header and, for version 3+, returns the mip table inside the blob.
+static bool itex_blob_header(const asset_blob_t *blob, const char *name, itex_header_t *h, itex_mip_t *mips)
+{
+    memset(h, 0, sizeof(*h));
+    if (blob->size >= ITEX_HEADER_SIZE_V3)
+        memcpy(h, blob->data, ITEX_HEADER_SIZE_V3);
+    if (blob->size < ITEX_HEADER_SIZE_V3 || (h->version >= ITEX_VERSION && blob->size < (uint32_t)sizeof(itex_header_t)))
+    {
+        LOG_ERROR("itex: blob too small '%s'", name);
+        return false;
     }
+    if (h->version >= ITEX_VERSION)
+        memcpy(h, blob->data, sizeof(*h));
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)lowest_mip);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)lowest_mip);
+    if (!itex_check_header(h, name))
+        return false;
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    const uint64_t table = itex_has_mips(h) ? (uint64_t)h->mip_count * sizeof(itex_mip_t) : 0u;
+    if (table + h->compressed_size > (uint64_t)blob->size - h->header_size)
+    {
+        LOG_ERROR("itex: blob truncated '%s'", name);
+        return false;
+    }
 
-    img->gl_handle = (uint32_t)tex;
-
-    img->stream_current_top_mip = lowest_mip;
-    img->stream_target_top_mip = lowest_mip;
-    img->stream_min_safety_mip = lowest_mip;
-    img->stream_pending_target_top_mip = lowest_mip;
-    img->stream_pending_frames = 0;
-    img->stream_priority = 0;
-    img->stream_residency_mask = (lowest_mip < 64u) ? (1ull << lowest_mip) : 0ull;
-    img->stream_last_used_frame = 0;
-    img->stream_last_used_ms = 0;
-    img->stream_best_target_mip_frame = 0;
-    img->stream_best_target_mip = lowest_mip;
-    img->stream_best_priority_frame = 0;
-    img->stream_best_priority = 0;
-    img->stream_last_upload_frame = 0;
-    img->stream_last_evict_frame = 0;
-    img->stream_forced = 0;
-    img->stream_forced_top_mip = 0;
-    img->stream_sparse = sparse_ok ? 1u : 0u;
-    img->stream_upload_inflight_mip = 0xFFFFFFFFu;
-    img->stream_upload_row = 0u;
-    img->vram_bytes = img->mips->size[lowest_mip];
+    if (table)
+        memcpy(mips, blob->data + h->header_size, (size_t)table);
+    return true;
+}
 
-    if (img->pixels)
+// Pack blobs are the same bytes as an .itex file; decode straight out of the mapping.
+static bool itex_load_blob(asset_manager_t *am, const char *path, const asset_blob_t *blob, asset_any_t *out_asset, ihandle_t *out_handle)
+{
+    if (out_handle)
+        *out_handle = ihandle_invalid();
+
+    if (!blob || !blob->data || !out_asset || !out_handle)
+        return false;
+
+    const char *name = path ? path : "<pack>";
+
+    itex_header_t h;
+    itex_mip_t mips[ASSET_IMAGE_MAX_MIPS];
+    if (!itex_blob_header(blob, name, &h, mips))
+        return false;
+
+    if (itex_has_mips(&h))
+        return itex_decode_chain(am, &h, mips, blob->size, blob->data, 0u, blob->size, name, out_asset, out_handle);
+    return itex_decode_base(am, &h, asset_manager_get_loading_image_color_space(am), blob->data + h.header_size, name, out_asset, out_handle);
+}
+
+// Version 3+ decodes just the requested levels; legacy files only store the base level, so those
+// rebuild the whole chain and copy out the levels.
+static bool itex_mip_read(asset_manager_t *am, const char *path, const asset_blob_t *blob, const asset_image_mip_chain_t *layout, uint32_t first_mip, uint32_t last_mip, uint8_t **out_levels)
+{
+    if (!blob || !blob->data || blob->codec != ASSET_CODEC_NONE || !layout || !out_levels)
+        return false;
+
+    const char *name = path ? path : "<pack>";
+
+    itex_header_t h;
+    itex_mip_t mips[ASSET_IMAGE_MAX_MIPS];
+    if (!itex_blob_header(blob, name, &h, mips))
+        return false;
+
+    if (!itex_has_mips(&h))
     {
-        free(img->pixels);
-        img->pixels = NULL;
+        asset_any_t tmp;
+        ihandle_t hid;
+        if (!itex_decode_base(am, &h, layout->color_space, blob->data + h.header_size, name, &tmp, &hid))
+            return false;
+
+        bool ok = asset_image_mips_extract(tmp.as.image.mips, layout, first_mip, last_mip, out_levels);
+        asset_image_mips_free(tmp.as.image.mips);
+        return ok;
     }
-    return true;
+
+    // The file may have changed since the chain was loaded.
+    if (h.mip_count != layout->mip_count || first_mip > last_mip || last_mip >= layout->mip_count ||
+        h.width != layout->width[0] || h.height != layout->height[0] ||
+        itex_unit_bytes(&h) != layout->bytes_per_pixel || h.bc_format != layout->bc_format ||
+        !itex_check_mips(&h, mips, layout, blob->size, name))
+        return false;
+
+    bool ok = true;
+    for (uint32_t i = first_mip; i <= last_mip; ++i)
+    {
+        out_levels[i] = (uint8_t *)malloc((size_t)layout->size[i]);
+        ok = ok && out_levels[i];
+    }
+
+    ok = ok && itex_decode_levels(mips, layout, first_mip, last_mip, blob->data, 0u, blob->size, out_levels);
+    if (!ok)
+    {
+        for (uint32_t i = first_mip; i <= last_mip; ++i)
+        {
+            free(out_levels[i]);
+            out_levels[i] = NULL;
+        }
+    }
+    return ok;
 }
 
 static void itex_cleanup(asset_manager_t *am, asset_any_t *asset)
@@ -399,14 +578,6 @@ static void itex_cleanup(asset_manager_t *am, asset_any_t *asset)
     img->vram_bytes = 0;
 }
 
-static uint32_t itex_bytes_per_pixel(uint32_t channels, uint32_t is_float)
-{
-    uint32_t b = channels;
-    if (is_float)
-        b *= 4u;
-    return b;
-}
-
 static const char *itex_gl_err_str(GLenum e)
 {
     switch (e)
@@ -482,10 +653,103 @@ static bool itex_pull_pixels_from_gl(const asset_image_t *img, uint8_t **out_pix
     return true;
 }
 
-static bool itex_save_blob(asset_manager_t *am, ihandle_t h, const asset_any_t *a, asset_blob_t *out)
+// Writes the header, the mip table and every level of `chain`, each encoded on its own so a load or
+// a page-in only decodes the levels it wants.
+static bool itex_write_chain(asset_manager_t *am, ihandle_t h, const asset_image_t *img, const asset_image_mip_chain_t *chain, const char *hb, asset_blob_t *out)
 {
-    (void)am;
+    // Chunked LZ4/zstd instead of one zlib stream: decodes several times faster and in parallel.
+    const uint8_t codec = asset_manager_get_pack_codec(am, ASSET_IMAGE);
+    itex_mip_t mips[ASSET_IMAGE_MAX_MIPS];
+    uint8_t *enc[ASSET_IMAGE_MAX_MIPS];
+    memset(mips, 0, sizeof(mips));
+    memset(enc, 0, sizeof(enc));
+
+    const uint32_t mip_count = chain->mip_count;
+    uint64_t total64 = (uint64_t)sizeof(itex_header_t) + (uint64_t)mip_count * sizeof(itex_mip_t);
+    const uint64_t payload_at = total64;
+    for (uint32_t i = 0; i < mip_count; ++i)
+    {
+        const uint32_t raw = (uint32_t)chain->size[i];
+        uint32_t size = 0;
+        if (codec != ASSET_CODEC_NONE && raw >= ITEX_MIP_MIN_ENCODE_BYTES && asset_codec_encode(codec, chain->level[i], raw, &enc[i], &size) && size < raw)
+            mips[i].codec = codec;
+        else
+        {
+            free(enc[i]);
+            enc[i] = NULL;
+            size = raw;
+        }
+        mips[i].size = size;
+        mips[i].offset = (uint32_t)total64;
+        total64 += size;
+    }
+
+    if (total64 > 0xFFFFFFFFull)
+    {
+        LOG_ERROR(" total size overflow/invalid (mips=%u => %" PRIu64 ") (handle=%s)", (unsigned)mip_count, (uint64_t)total64, hb);
+        for (uint32_t i = 0; i < mip_count; ++i)
+            free(enc[i]);
+        return false;
+    }
+
+    uint32_t total = (uint32_t)total64;
+
+    uint8_t *buf = (uint8_t *)malloc((size_t)total);
+    if (!buf)
+    {
+        LOG_ERROR(" OOM allocating output buffer (%u bytes) (handle=%s)", (unsigned)total, hb);
+        for (uint32_t i = 0; i < mip_count; ++i)
+            free(enc[i]);
+        return false;
+    }
+
+    itex_header_t hd;
+    memset(&hd, 0, sizeof(hd));
+    hd.magic = ITEX_MAGIC;
+    hd.version = (uint16_t)ITEX_VERSION;
+    hd.header_size = (uint16_t)sizeof(itex_header_t);
+
+    hd.width = img->width;
+    hd.height = img->height;
+    hd.channels = img->channels;
+    hd.is_float = img->is_float;
+
+    hd.has_alpha = img->has_alpha;
+    hd.has_smooth_alpha = img->has_smooth_alpha;
+
+    hd.uncompressed_size = (uint32_t)chain->total_size;
+    hd.compressed_size = (uint32_t)(total64 - payload_at);
+    hd.codec = codec;
+    hd.mip_count = mip_count;
+    hd.bc_format = chain->bc_format;
+    hd.color_space = img->color_space;
 
+    hd.handle_value = (uint32_t)h.value;
+    hd.handle_type = h.type;
+    hd.handle_meta = h.meta;
+
+    memcpy(buf, &hd, sizeof(hd));
+    memcpy(buf + sizeof(hd), mips, (size_t)mip_count * sizeof(itex_mip_t));
+    for (uint32_t i = 0; i < mip_count; ++i)
+    {
+        memcpy(buf + mips[i].offset, enc[i] ? enc[i] : chain->level[i], (size_t)mips[i].size);
+        free(enc[i]);
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->data = buf;
+    out->size = total;
+    out->align = 4;
+    out->uncompressed_size = total;
+    out->codec = ASSET_CODEC_NONE;
+    out->flags = ASSET_BLOB_FLAG_PRECOMPRESSED;
+    out->reserved = 0;
+
+    return true;
+}
+
+static bool itex_save_blob(asset_manager_t *am, ihandle_t h, const asset_any_t *a, asset_blob_t *out)
+{
     char hb[64];
     handle_hex_triplet_filesafe(hb, h);
 
@@ -523,6 +787,20 @@ static bool itex_save_blob(asset_manager_t *am, ihandle_t h, const asset_any_t *
         return false;
     }
 
+    // Block-compressed chains cannot be rebuilt from a base level; they are written as they are.
+    if (img->mips && img->mips->bc_format)
+    {
+        for (uint32_t i = 0; i < img->mips->mip_count; ++i)
+        {
+            if (!img->mips->level[i])
+            {
+                LOG_ERROR(" mip %u of a block-compressed image is not in RAM (handle=%s)", (unsigned)i, hb);
+                return false;
+            }
+        }
+        return itex_write_chain(am, h, img, img->mips, hb, out);
+    }
+
     uint8_t *src_pixels = NULL;
     uint32_t src_size = 0;
 
@@ -560,7 +838,7 @@ static bool itex_save_blob(asset_manager_t *am, ihandle_t h, const asset_any_t *
     }
     else
     {
-        if (img->mips && img->mips->data && img->mips->mip_count > 0)
+        if (img->mips && img->mips->mip_count > 0 && img->mips->level[0])
         {
             const uint32_t bpp = itex_bytes_per_pixel(img->channels, img->is_float);
             const uint64_t sz64 = (uint64_t)img->width * (uint64_t)img->height * (uint64_t)bpp;
@@ -578,13 +856,24 @@ static bool itex_save_blob(asset_manager_t *am, ihandle_t h, const asset_any_t *
                 LOG_ERROR(" OOM allocating src_pixels (%u bytes) (handle=%s)", (unsigned)src_size, hb);
                 return false;
             }
-            memcpy(src_pixels, img->mips->data + (size_t)img->mips->offset[0], (size_t)src_size);
+            memcpy(src_pixels, img->mips->level[0], (size_t)src_size);
         }
         else if (!img->gl_handle)
         {
             LOG_ERROR(" no CPU pixels and gl_handle=0 (cannot read back) (handle=%s)", hb);
             return false;
         }
+        else if (img->mips && img->stream_current_top_mip != 0)
+        {
+            LOG_ERROR(" mip 0 neither in RAM nor on the GPU (handle=%s)", hb);
+            return false;
+        }
+        else if (jobs_worker_index() != 0)
+        {
+            // Readback needs the GL thread; the pack builder retries there.
+            out->flags = ASSET_BLOB_FLAG_NEEDS_MAIN_THREAD;
+            return false;
+        }
         else if (!itex_pull_pixels_from_gl(img, &src_pixels, &src_size))
         {
             LOG_ERROR(" failed to pull pixels from GL (gl_handle=%u w=%u h=%u ch=%u is_float=%u) (handle=%s)",
@@ -602,97 +891,40 @@ static bool itex_save_blob(asset_manager_t *am, ihandle_t h, const asset_any_t *
         }
     }
 
-    mz_ulong comp_cap = mz_compressBound((mz_ulong)src_size);
-    if (comp_cap == 0)
-    {
-        LOG_ERROR(" compressBound returned 0 (src_size=%u) (handle=%s)", (unsigned)src_size, hb);
-        free(src_pixels);
-        return false;
-    }
-
-    if (comp_cap > 0xFFFFFFFFul)
-        LOG_WARN(" comp_cap exceeds 4GB (%lu) (handle=%s)", (unsigned long)comp_cap, hb);
-
-    uint8_t *comp = (uint8_t *)malloc((size_t)comp_cap);
-    if (!comp)
-    {
-        LOG_ERROR(" OOM allocating comp buffer (%lu bytes) (handle=%s)", (unsigned long)comp_cap, hb);
-        free(src_pixels);
-        return false;
-    }
+    // Store the chain the loader used to build, flipped like itex_decode_base, block-compressed
+    // unless the pack setting is off.
+    image_flip_y_bytes(src_pixels, img->width, img->height, itex_bytes_per_pixel(img->channels, img->is_float));
 
-    mz_ulong comp_size = comp_cap;
-    int z = mz_compress2(comp, &comp_size, (const unsigned char *)src_pixels, (mz_ulong)src_size, 1);
+    asset_image_mip_chain_t *chain = NULL;
+    bool built = img->is_float ? asset_image_mips_build_f32(&chain, (const float *)(const void *)src_pixels, img->width, img->height, img->channels, asset_manager_get_image_mip_filter(am))
+                               : asset_image_mips_build_u8(&chain, src_pixels, img->width, img->height, img->channels, asset_manager_get_image_mip_filter(am), asset_manager_get_image_mip_flags(am, img->color_space));
     free(src_pixels);
-
-    if (z != MZ_OK)
-    {
-        LOG_ERROR(" mz_compress2 failed (z=%d src_size=%u) (handle=%s)", z, (unsigned)src_size, hb);
-        free(comp);
-        return false;
-    }
-
-    if (comp_size == 0)
-    {
-        LOG_ERROR(" compression produced size=0 (src_size=%u) (handle=%s)", (unsigned)src_size, hb);
-        free(comp);
-        return false;
-    }
-
-    uint64_t total64 = (uint64_t)sizeof(itex_header_t) + (uint64_t)comp_size;
-    if (total64 == 0 || total64 > 0xFFFFFFFFull)
+    if (!built)
     {
-        LOG_ERROR(" total size overflow/invalid (header=%u comp=%lu => %" PRIu64 ") (handle=%s)",
-                  (unsigned)sizeof(itex_header_t), (unsigned long)comp_size, (uint64_t)total64, hb);
-        free(comp);
+        LOG_ERROR(" mip build failed (w=%u h=%u) (handle=%s)", (unsigned)img->width, (unsigned)img->height, hb);
         return false;
     }
 
-    uint32_t total = (uint32_t)total64;
-
-    uint8_t *buf = (uint8_t *)malloc((size_t)total);
-    if (!buf)
+    if (!img->is_float && asset_manager_get_pack_texture_compression(am))
     {
-        LOG_ERROR(" OOM allocating output buffer (%u bytes) (handle=%s)", (unsigned)total, hb);
-        free(comp);
-        return false;
+        asset_image_mip_chain_t *bc = NULL;
+        asset_image_bc_stats_t st;
+        if (asset_image_bc_compress_chain(&bc, chain, img->channels, img->has_alpha, &st))
+        {
+            LOG_DEBUG("itex: %s %ux%u, PSNR %.2f dB (handle=%s)",
+                      asset_image_bc_name(st.format), (unsigned)img->width, (unsigned)img->height, st.psnr, hb);
+            asset_image_mips_free(chain);
+            chain = bc;
+        }
+        else
+        {
+            LOG_WARN(" block compression failed, storing pixels (handle=%s)", hb);
+        }
     }
 
-    itex_header_t hd;
-    memset(&hd, 0, sizeof(hd));
-    hd.magic = ITEX_MAGIC;
-    hd.version = (uint16_t)ITEX_VERSION;
-    hd.header_size = (uint16_t)sizeof(itex_header_t);
-
-    hd.width = img->width;
-    hd.height = img->height;
-    hd.channels = img->channels;
-    hd.is_float = img->is_float;
-
-    hd.has_alpha = img->has_alpha;
-    hd.has_smooth_alpha = img->has_smooth_alpha;
-
-    hd.uncompressed_size = src_size;
-    hd.compressed_size = (uint32_t)comp_size;
-
-    hd.handle_value = h.value;
-    hd.handle_type = h.type;
-    hd.handle_meta = h.meta;
-
-    memcpy(buf, &hd, sizeof(hd));
-    memcpy(buf + sizeof(hd), comp, (size_t)comp_size);
-    free(comp);
-
-    memset(out, 0, sizeof(*out));
-    out->data = buf;
-    out->size = total;
-    out->align = 4;
-    out->uncompressed_size = total;
-    out->codec = 0;
-    out->flags = 0;
-    out->reserved = 0;
-
-    return true;
+    const bool ok = itex_write_chain(am, h, img, chain, hb, out);
+    asset_image_mips_free(chain);
+    return ok;
 }
 
 static void itex_blob_free(asset_manager_t *am, asset_blob_t *blob)
@@ -712,10 +944,16 @@ asset_module_desc_t asset_module_image_itex(void)
     m.type = ASSET_IMAGE;
     m.name = "ASSET_IMAGE_ITEX";
     m.load_fn = itex_load;
-    m.init_fn = itex_init;
+    m.init_fn = asset_image_upload_all;
+    m.upload_fn = asset_image_upload;
     m.cleanup_fn = itex_cleanup;
     m.save_blob_fn = itex_save_blob;
     m.blob_free_fn = itex_blob_free;
     m.can_load_fn = itex_can_load;
+    m.load_blob_fn = itex_load_blob;
+    m.mip_read_fn = itex_mip_read;
+    m.version = ITEX_VERSION;
+    // itex_load reads the header, the mip table and then only the resident levels.
+    m.reads_source_ranges = true;
     return m;
 }
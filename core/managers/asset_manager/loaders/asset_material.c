@@ -301,7 +301,7 @@ static bool ikv_try_read_ihandle(const ikv_node_t *root, ihandle_t *out_h)
 
     ihandle_t h;
     memset(&h, 0, sizeof(h));
-    h.value = (uint32_t)v->value.i;
+    h.value = (uint64_t)v->value.i;
     h.type = (ihandle_type_t)t->value.i;
     h.meta = (uint16_t)m->value.i;
 
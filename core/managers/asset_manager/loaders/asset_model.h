@@ -10,12 +10,7 @@
 #include "asset_manager/asset_manager.h"
 #include "asset_manager/asset_types/model.h"
 #include "asset_manager/asset_types/material.h"
-
-#if defined(__APPLE__)
-#include <OpenGL/gl3.h>
-#else
-#include <GL/glew.h>
-#endif
+#include "model_upload.h"
 
 typedef struct obj_v3_t
 {
@@ -776,21 +771,6 @@ static bool mdl_obj_load_to_raw_fast(const char *path, model_raw_t *out_raw, cha
     return true;
 }
 
-static void mdl_vao_setup_model_vertex(void)
-{
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, px));
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, nx));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, u));
-
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, tx));
-}
-
 typedef struct mdl_mtl_entry_t
 {
     char *name;
@@ -1009,7 +989,6 @@ static void mdl_free_mtl_entries(vector_t *entries)
 
 static bool asset_model_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr, asset_any_t *out_asset, ihandle_t *out_handle)
 {
-    (void)am;
     if (out_handle)
         *out_handle = ihandle_invalid();
 
@@ -1028,6 +1007,8 @@ static bool asset_model_load(asset_manager_t *am, const char *path, uint32_t pat
     if (!mdl_obj_load_to_raw_fast(path, &raw, &mtllib))
         return false;
 
+    asset_model_upload_stage(am, &raw);
+
     memset(out_asset, 0, sizeof(*out_asset));
     out_asset->type = ASSET_MODEL;
     out_asset->state = ASSET_STATE_LOADING;
@@ -1044,32 +1025,21 @@ static bool asset_model_load(asset_manager_t *am, const char *path, uint32_t pat
     return true;
 }
 
-static const model_cpu_lod_t *mdl_get_cpu_lod0(const model_cpu_submesh_t *sm)
-{
-    if (!sm)
-        return NULL;
-    if (sm->lods.size == 0)
-        return NULL;
-    return (const model_cpu_lod_t *)vector_impl_at((vector_t *)&sm->lods, 0);
-}
-
-static bool asset_model_init(asset_manager_t *am, asset_any_t *asset)
+// Binds each submesh to its material from the mtllib, submitting the library's materials first.
+static void mdl_resolve_materials(asset_manager_t *am, model_raw_t *raw)
 {
-    if (!asset || asset->type != ASSET_MODEL)
-        return false;
-
     vector_t mtl_entries = {0};
 
-    asset->as.model_raw.mtllib = ihandle_invalid();
+    raw->mtllib = ihandle_invalid();
 
-    if (asset->as.model_raw.mtllib_path && asset->as.model_raw.mtllib_path[0])
+    if (raw->mtllib_path && raw->mtllib_path[0])
     {
-        if (!mdl_load_mtl_and_submit_all(am, asset->as.model_raw.mtllib_path, &mtl_entries))
+        if (!mdl_load_mtl_and_submit_all(am, raw->mtllib_path, &mtl_entries))
             mtl_entries = vector_impl_create_vector(sizeof(mdl_mtl_entry_t));
 
-        for (uint32_t i = 0; i < asset->as.model_raw.submeshes.size; ++i)
+        for (uint32_t i = 0; i < raw->submeshes.size; ++i)
         {
-            model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&asset->as.model_raw.submeshes, i);
+            model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&raw->submeshes, i);
             if (!sm)
                 continue;
 
@@ -1079,103 +1049,32 @@ static bool asset_model_init(asset_manager_t *am, asset_any_t *asset)
     else
     {
         mtl_entries = vector_impl_create_vector(sizeof(mdl_mtl_entry_t));
-        for (uint32_t i = 0; i < asset->as.model_raw.submeshes.size; ++i)
+        for (uint32_t i = 0; i < raw->submeshes.size; ++i)
         {
-            model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&asset->as.model_raw.submeshes, i);
+            model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&raw->submeshes, i);
             if (!sm)
                 continue;
             sm->material = ihandle_invalid();
         }
     }
 
-    asset_model_t model = asset_model_make();
-
-    for (uint32_t i = 0; i < asset->as.model_raw.submeshes.size; ++i)
-    {
-        model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&asset->as.model_raw.submeshes, i);
-        if (!sm)
-            continue;
-
-        const model_cpu_lod_t *cpu0 = mdl_get_cpu_lod0(sm);
-        if (!cpu0 || !cpu0->vertices || !cpu0->indices || cpu0->index_count == 0 || cpu0->vertex_count == 0)
-            continue;
-
-        mesh_t gm;
-        memset(&gm, 0, sizeof(gm));
-        gm.material = sm->material;
-        gm.lods = vector_impl_create_vector(sizeof(mesh_lod_t));
-        mesh_set_local_aabb_from_cpu(&gm, sm);
-
-        mesh_lod_t lod0;
-        memset(&lod0, 0, sizeof(lod0));
-        lod0.index_count = cpu0->index_count;
-
-        glGenVertexArrays(1, &lod0.vao);
-        glBindVertexArray(lod0.vao);
-
-        glGenBuffers(1, &lod0.vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, lod0.vbo);
-        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(cpu0->vertex_count * sizeof(model_vertex_t)), cpu0->vertices, GL_STATIC_DRAW);
-
-        glGenBuffers(1, &lod0.ibo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lod0.ibo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(cpu0->index_count * sizeof(uint32_t)), cpu0->indices, GL_STATIC_DRAW);
-
-        mdl_vao_setup_model_vertex();
-
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-        vector_impl_push_back(&gm.lods, &lod0);
-        vector_impl_push_back(&model.meshes, &gm);
-    }
-
     mdl_free_mtl_entries(&mtl_entries);
-
-    model_raw_destroy(&asset->as.model_raw);
-    asset->as.model = model;
-
-    return true;
 }
 
-static void asset_model_cleanup(asset_manager_t *am, asset_any_t *asset)
+static bool asset_model_init(asset_manager_t *am, asset_any_t *asset)
 {
-    (void)am;
-
     if (!asset || asset->type != ASSET_MODEL)
-        return;
-
-    if (asset->state != ASSET_STATE_READY)
-        model_raw_destroy(&asset->as.model_raw);
-
-    for (uint32_t i = 0; i < asset->as.model.meshes.size; ++i)
-    {
-        mesh_t *m = (mesh_t *)vector_impl_at(&asset->as.model.meshes, i);
-        if (!m)
-            continue;
-
-        for (uint32_t li = 0; li < m->lods.size; ++li)
-        {
-            mesh_lod_t *l = (mesh_lod_t *)vector_impl_at(&m->lods, li);
-            if (!l)
-                continue;
-
-            if (l->ibo)
-                glDeleteBuffers(1, &l->ibo);
-            if (l->vbo)
-                glDeleteBuffers(1, &l->vbo);
-            if (l->vao)
-                glDeleteVertexArrays(1, &l->vao);
-
-            memset(l, 0, sizeof(*l));
-        }
+        return false;
 
-        vector_impl_free(&m->lods);
-        memset(m, 0, sizeof(*m));
-    }
+    mdl_resolve_materials(am, &asset->as.model_raw);
+    return asset_model_upload_all(am, asset);
+}
 
-    asset_model_destroy_cpu_only(&asset->as.model);
+static asset_upload_status_t asset_model_obj_upload(asset_manager_t *am, asset_any_t *asset, asset_upload_t *up, uint64_t budget_bytes)
+{
+    if (!up->state && budget_bytes && asset && asset->type == ASSET_MODEL)
+        mdl_resolve_materials(am, &asset->as.model_raw);
+    return asset_model_upload(am, asset, up, budget_bytes);
 }
 
 static bool asset_model_obj_can_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr)
@@ -1198,7 +1097,8 @@ static asset_module_desc_t asset_module_model(void)
     m.name = "ASSET_MODEL_OBJ";
     m.load_fn = asset_model_load;
     m.init_fn = asset_model_init;
-    m.cleanup_fn = asset_model_cleanup;
+    m.cleanup_fn = asset_model_upload_cleanup;
+    m.upload_fn = asset_model_obj_upload;
     m.save_blob_fn = NULL;
     m.blob_free_fn = NULL;
     m.can_load_fn = asset_model_obj_can_load;
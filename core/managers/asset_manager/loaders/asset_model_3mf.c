@@ -15,30 +15,10 @@
 #include "vector.h"
 #include "systems/model_lod.h"
 #include "types/vec3.h"
-
-#if defined(__APPLE__)
-#include <OpenGL/gl3.h>
-#else
-#include <GL/glew.h>
-#endif
+#include "model_upload.h"
 
 #include "miniz.h"
 
-static void mdl_vao_setup_model_vertex(void)
-{
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, px));
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, nx));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, u));
-
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, tx));
-}
-
 static vec3 mf_vec3_sub(vec3 a, vec3 b) { return (vec3){a.x - b.x, a.y - b.y, a.z - b.z}; }
 
 static vec3 mf_vec3_cross(vec3 a, vec3 b)
@@ -585,6 +565,7 @@ bool asset_model_3mf_load(asset_manager_t *am, const char *path, uint32_t path_i
     }
 
     model_raw_generate_lods(&raw);
+    asset_model_upload_stage(am, &raw);
 
     memset(out_asset, 0, sizeof(*out_asset));
     out_asset->type = ASSET_MODEL;
@@ -594,125 +575,6 @@ bool asset_model_3mf_load(asset_manager_t *am, const char *path, uint32_t path_i
     return true;
 }
 
-bool asset_model_3mf_init(asset_manager_t *am, asset_any_t *asset)
-{
-    (void)am;
-
-    if (!asset || asset->type != ASSET_MODEL)
-        return false;
-
-    asset_model_t model = asset_model_make();
-
-    for (uint32_t i = 0; i < asset->as.model_raw.submeshes.size; ++i)
-    {
-        model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&asset->as.model_raw.submeshes, i);
-        if (!sm || sm->lods.size == 0)
-            continue;
-
-        mesh_t gm;
-        memset(&gm, 0, sizeof(gm));
-        gm.material = sm->material;
-        gm.lods = vector_impl_create_vector(sizeof(mesh_lod_t));
-        gm.flags = 0;
-
-        mesh_set_local_aabb_from_cpu(&gm, sm);
-
-        uint32_t want_lods = sm->lods.size;
-        uint32_t uploaded = 0;
-
-        for (uint32_t li = 0; li < sm->lods.size; ++li)
-        {
-            model_cpu_lod_t *cl = (model_cpu_lod_t *)vector_impl_at(&sm->lods, li);
-            if (!cl || !cl->vertices || !cl->indices || !cl->vertex_count || !cl->index_count)
-                continue;
-
-            mesh_lod_t glod;
-            memset(&glod, 0, sizeof(glod));
-            glod.index_count = cl->index_count;
-
-            glGenVertexArrays(1, &glod.vao);
-            glBindVertexArray(glod.vao);
-
-            glGenBuffers(1, &glod.vbo);
-            glBindBuffer(GL_ARRAY_BUFFER, glod.vbo);
-            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(cl->vertex_count * sizeof(model_vertex_t)), cl->vertices, GL_STATIC_DRAW);
-
-            glGenBuffers(1, &glod.ibo);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glod.ibo);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(cl->index_count * sizeof(uint32_t)), cl->indices, GL_STATIC_DRAW);
-
-            mdl_vao_setup_model_vertex();
-
-            glBindVertexArray(0);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-            vector_impl_push_back(&gm.lods, &glod);
-            uploaded++;
-
-            if (li == 0)
-                gm.flags |= (uint8_t)MESH_FLAG_LOD0_READY;
-        }
-
-        if (uploaded > 0)
-        {
-            if (uploaded == want_lods)
-                gm.flags |= (uint8_t)MESH_FLAG_LODS_READY;
-
-            vector_impl_push_back(&model.meshes, &gm);
-        }
-        else
-        {
-            vector_impl_free(&gm.lods);
-        }
-    }
-
-    model_raw_destroy(&asset->as.model_raw);
-    asset->as.model = model;
-
-    return true;
-}
-
-void asset_model_3mf_cleanup(asset_manager_t *am, asset_any_t *asset)
-{
-    (void)am;
-
-    if (!asset || asset->type != ASSET_MODEL)
-        return;
-
-    if (asset->state != ASSET_STATE_READY)
-        model_raw_destroy(&asset->as.model_raw);
-
-    for (uint32_t i = 0; i < asset->as.model.meshes.size; ++i)
-    {
-        mesh_t *m = (mesh_t *)vector_impl_at(&asset->as.model.meshes, i);
-        if (!m)
-            continue;
-
-        for (uint32_t li = 0; li < m->lods.size; ++li)
-        {
-            mesh_lod_t *l = (mesh_lod_t *)vector_impl_at(&m->lods, li);
-            if (!l)
-                continue;
-            if (l->ibo)
-                glDeleteBuffers(1, &l->ibo);
-            if (l->vbo)
-                glDeleteBuffers(1, &l->vbo);
-            if (l->vao)
-                glDeleteVertexArrays(1, &l->vao);
-            memset(l, 0, sizeof(*l));
-        }
-
-        vector_impl_free(&m->lods);
-        m->material = ihandle_invalid();
-        m->flags = 0;
-        m->local_aabb.min = (vec3){0, 0, 0};
-        m->local_aabb.max = (vec3){0, 0, 0};
-    }
-
-    asset_model_destroy_cpu_only(&asset->as.model);
-}
-
 static bool asset_model_3mf_can_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr)
 {
     (void)am;
@@ -732,8 +594,9 @@ asset_module_desc_t asset_module_model_3mf(void)
     m.type = ASSET_MODEL;
     m.name = "ASSET_MODEL_3MF";
     m.load_fn = asset_model_3mf_load;
-    m.init_fn = asset_model_3mf_init;
-    m.cleanup_fn = asset_model_3mf_cleanup;
+    m.init_fn = asset_model_upload_all;
+    m.cleanup_fn = asset_model_upload_cleanup;
+    m.upload_fn = asset_model_upload;
     m.save_blob_fn = NULL;
     m.blob_free_fn = NULL;
     m.can_load_fn = asset_model_3mf_can_load;
@@ -12,6 +12,7 @@
 #include "asset_manager/asset_types/material.h"
 #include "vector.h"
 #include "handle.h"
+#include "model_upload.h"
 
 #if defined(__APPLE__)
 #include <OpenGL/gl3.h>
@@ -22,6 +23,18 @@
 #define IMESH_LOGE(...) LOG_ERROR(__VA_ARGS__)
 #define IMESH_LOGW(...) LOG_ERROR(__VA_ARGS__)
 
+#define IMESH_VERSION 3u
+
+// On-disk ihandle_t, in the 8-byte layout the format has always used. The model handle is
+// persistent (32-bit value). Material handles are runtime handles: version 3 keeps the index in
+// value and the generation in the submesh record; version 2 packed [generation:16][index:16].
+typedef struct imesh_handle_t
+{
+    uint32_t value;
+    uint16_t type;
+    uint16_t meta;
+} imesh_handle_t;
+
 typedef struct imesh_header_t
 {
     char magic[4];
@@ -29,7 +42,7 @@ typedef struct imesh_header_t
     uint32_t flags;
     uint32_t submesh_count;
     uint32_t reserved0;
-    ihandle_t model_handle;
+    imesh_handle_t model_handle;
     uint64_t submesh_table_offset;
 } imesh_header_t;
 
@@ -38,11 +51,11 @@ typedef struct imesh_submesh_record_t
     uint32_t flags;
     uint32_t material_name_len;
     uint64_t material_name_offset;
-    ihandle_t material_handle;
+    imesh_handle_t material_handle;
     float aabb_min[3];
     float aabb_max[3];
     uint32_t lod_count;
-    uint32_t reserved0;
+    uint32_t material_generation; // version 3+, reserved before
     uint64_t lods_offset;
 } imesh_submesh_record_t;
 
@@ -59,6 +72,57 @@ enum
     IMESH_SUBMESH_HAS_AABB = 1u << 0
 };
 
+static imesh_handle_t imesh_handle_from_persistent(ihandle_t h)
+{
+    imesh_handle_t d;
+    d.value = (uint32_t)h.value;
+    d.type = h.type;
+    d.meta = h.meta;
+    return d;
+}
+
+static ihandle_t imesh_handle_to_persistent(imesh_handle_t d)
+{
+    ihandle_t h = ihandle_invalid();
+    h.value = d.value;
+    h.type = d.type;
+    h.meta = d.meta;
+    return h;
+}
+
+static imesh_handle_t imesh_handle_from_runtime(ihandle_t h, uint32_t *out_generation)
+{
+    imesh_handle_t d;
+    memset(&d, 0, sizeof(d));
+    *out_generation = 0;
+    if (!ihandle_is_valid(h))
+        return d;
+    d.value = ihandle_index(h);
+    d.type = h.type;
+    d.meta = h.meta;
+    *out_generation = ihandle_generation(h);
+    return d;
+}
+
+static ihandle_t imesh_handle_to_runtime(imesh_handle_t d, uint32_t generation, uint32_t version)
+{
+    if (!d.type)
+        return ihandle_invalid();
+    if (version < 3u)
+    {
+        if (!d.value)
+            return ihandle_invalid();
+        return ihandle_with_meta(ihandle_make(d.type, d.value & 0xFFFFu, d.value >> 16), d.meta);
+    }
+    ihandle_t h = ihandle_with_meta(ihandle_make(d.type, d.value, generation), d.meta);
+    return ihandle_is_valid(h) ? h : ihandle_invalid();
+}
+
+static bool imesh_version_supported(uint32_t version)
+{
+    return version == 2u || version == IMESH_VERSION;
+}
+
 static bool imesh_has_ext(const char *p)
 {
     if (!p)
@@ -151,62 +215,6 @@ static char *imesh_make_imat_path(const char *mesh_path, const char *mat_name, u
     return full;
 }
 
-static bool imesh_read_all(const char *path, uint8_t **out_data, uint32_t *out_size)
-{
-    if (!path || !out_data || !out_size)
-        return false;
-
-    *out_data = 0;
-    *out_size = 0;
-
-    FILE *f = fopen(path, "rb");
-    if (!f)
-        return false;
-
-    bool ok = true;
-
-    if (fseek(f, 0, SEEK_END) != 0)
-        ok = false;
-
-    long end = ok ? ftell(f) : 0;
-    if (ok && end <= 0)
-        ok = false;
-
-    if (ok && fseek(f, 0, SEEK_SET) != 0)
-        ok = false;
-
-    uint8_t *data = 0;
-    uint32_t size = 0;
-
-    if (ok)
-    {
-        size = (uint32_t)end;
-        data = (uint8_t *)malloc((size_t)size);
-        if (!data)
-            ok = false;
-    }
-
-    if (ok)
-    {
-        size_t got = fread(data, 1, (size_t)size, f);
-        if (got != (size_t)size)
-            ok = false;
-    }
-
-    fclose(f);
-
-    if (!ok)
-    {
-        if (data)
-            free(data);
-        return false;
-    }
-
-    *out_data = data;
-    *out_size = size;
-    return true;
-}
-
 static bool imesh_validate_blob(const uint8_t *data, uint32_t size, const imesh_header_t **out_h)
 {
     if (!data || size < (uint32_t)sizeof(imesh_header_t) || !out_h)
@@ -216,7 +224,7 @@ static bool imesh_validate_blob(const uint8_t *data, uint32_t size, const imesh_
 
     if (memcmp(h->magic, "IMSH", 4) != 0)
         return false;
-    if (h->version != 2)
+    if (!imesh_version_supported(h->version))
         return false;
     if (h->submesh_table_offset >= size)
         return false;
@@ -229,19 +237,12 @@ static bool imesh_validate_blob(const uint8_t *data, uint32_t size, const imesh_
     return true;
 }
 
-static void imesh_setup_model_vertex_vao(void)
+static uint64_t imesh_align_u64(uint64_t x, uint64_t a)
 {
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, px));
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, nx));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, u));
-
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, tx));
+    if (a == 0)
+        return x;
+    uint64_t m = a - 1ull;
+    return (x + m) & ~m;
 }
 
 static void imesh_free_raw(model_raw_t *raw)
@@ -251,7 +252,31 @@ static void imesh_free_raw(model_raw_t *raw)
     model_raw_destroy(raw);
 }
 
-static bool imesh_parse_to_raw(asset_manager_t *am, const char *mesh_path, const uint8_t *data, uint32_t size, model_raw_t *out_raw, ihandle_t *out_handle)
+static void imesh_unmap_raw(model_raw_t *raw)
+{
+    asset_file_map_t *fm = (asset_file_map_t *)raw->file_map;
+    if (!fm)
+        return;
+    asset_io_unmap(fm);
+    free(fm);
+    raw->file_map = NULL;
+}
+
+static bool imesh_raw_borrows(const model_raw_t *raw)
+{
+    for (uint32_t i = 0; i < raw->submeshes.size; ++i)
+    {
+        const model_cpu_submesh_t *sm = (const model_cpu_submesh_t *)vector_impl_at((vector_t *)&raw->submeshes, i);
+        if (sm && (sm->flags & CPU_SUBMESH_FLAG_BORROWED_LODS))
+            return true;
+    }
+    return false;
+}
+
+// With `borrow` set the LOD arrays reference `data` directly, which must outlive the raw model
+// (mounted pack mappings do; mapped source files are kept alive by raw->file_map). Misaligned
+// payloads fall back to copies.
+static bool imesh_parse_to_raw(asset_manager_t *am, const char *mesh_path, const uint8_t *data, uint32_t size, bool borrow, model_raw_t *out_raw, ihandle_t *out_handle)
 {
     if (!am || !data || !out_raw)
         return false;
@@ -261,7 +286,7 @@ static bool imesh_parse_to_raw(asset_manager_t *am, const char *mesh_path, const
         return false;
 
     if (out_handle)
-        *out_handle = h->model_handle;
+        *out_handle = imesh_handle_to_persistent(h->model_handle);
 
     model_raw_t raw = model_raw_make();
     raw.mtllib_path = 0;
@@ -314,9 +339,10 @@ static bool imesh_parse_to_raw(asset_manager_t *am, const char *mesh_path, const
         if (sr->lod_count > raw.lod_count)
             raw.lod_count = (uint8_t)sr->lod_count;
 
-        if (ihandle_is_valid(sr->material_handle))
+        ihandle_t material = imesh_handle_to_runtime(sr->material_handle, sr->material_generation, h->version);
+        if (ihandle_is_valid(material))
         {
-            sm.material = sr->material_handle;
+            sm.material = material;
         }
         else if (sr->material_name_len)
         {
@@ -331,6 +357,15 @@ static bool imesh_parse_to_raw(asset_manager_t *am, const char *mesh_path, const
 
         const imesh_lod_record_t *lrs = (const imesh_lod_record_t *)(data + sr->lods_offset);
 
+        if (borrow)
+        {
+            uintptr_t mis = 0;
+            for (uint32_t li = 0; li < sr->lod_count; ++li)
+                mis |= (uintptr_t)(data + lrs[li].vertices_offset) | (uintptr_t)(data + lrs[li].indices_offset);
+            if ((mis & 3u) == 0)
+                sm.flags = (uint8_t)(sm.flags | (uint8_t)CPU_SUBMESH_FLAG_BORROWED_LODS);
+        }
+
         for (uint32_t li = 0; li < sr->lod_count && ok; ++li)
         {
             const imesh_lod_record_t *lr = &lrs[li];
@@ -355,6 +390,14 @@ static bool imesh_parse_to_raw(asset_manager_t *am, const char *mesh_path, const
             lod.vertex_count = lr->vertex_count;
             lod.index_count = lr->index_count;
 
+            if (sm.flags & CPU_SUBMESH_FLAG_BORROWED_LODS)
+            {
+                lod.vertices = (model_vertex_t *)(uintptr_t)(data + vb);
+                lod.indices = (uint32_t *)(uintptr_t)(data + ib);
+                vector_impl_push_back(&sm.lods, &lod);
+                continue;
+            }
+
             size_t vbytes = (size_t)lr->vertex_count * sizeof(model_vertex_t);
             size_t ibytes = (size_t)lr->index_count * sizeof(uint32_t);
 
@@ -382,8 +425,11 @@ static bool imesh_parse_to_raw(asset_manager_t *am, const char *mesh_path, const
                 model_cpu_lod_t *cl = (model_cpu_lod_t *)vector_impl_at(&sm.lods, li);
                 if (!cl)
                     continue;
-                free(cl->vertices);
-                free(cl->indices);
+                if (!(sm.flags & CPU_SUBMESH_FLAG_BORROWED_LODS))
+                {
+                    free(cl->vertices);
+                    free(cl->indices);
+                }
                 cl->vertices = 0;
                 cl->indices = 0;
                 cl->vertex_count = 0;
@@ -417,8 +463,9 @@ bool asset_model_imesh_load(asset_manager_t *am, const char *path, uint32_t path
     const uint8_t *blob = 0;
     uint32_t blob_size = 0;
 
-    uint8_t *file_data = 0;
-    uint32_t file_size = 0;
+    // Source files are mapped and their LODs borrowed in place; the mapping goes away once the
+    // LODs are uploaded or copied into the upload ring, so no heap copy of the file is ever made.
+    asset_file_map_t *fm = NULL;
 
     if (path_is_ptr)
     {
@@ -432,22 +479,39 @@ bool asset_model_imesh_load(asset_manager_t *am, const char *path, uint32_t path
     {
         if (!imesh_has_ext(path))
             return false;
-        if (!imesh_read_all(path, &file_data, &file_size))
+        fm = (asset_file_map_t *)malloc(sizeof(asset_file_map_t));
+        if (!fm || !asset_io_map(path, ASSET_IO_MAP_PRELOAD, fm))
+        {
+            free(fm);
             return false;
-        blob = file_data;
-        blob_size = file_size;
+        }
+        if (fm->size > (uint64_t)UINT32_MAX)
+        {
+            IMESH_LOGE("imesh: '%s' is larger than 4 GiB", path);
+            asset_io_unmap(fm);
+            free(fm);
+            return false;
+        }
+        blob = fm->data;
+        blob_size = (uint32_t)fm->size;
     }
 
     model_raw_t raw = model_raw_make();
     ihandle_t ph = ihandle_invalid();
 
-    bool ok = imesh_parse_to_raw(am, path_is_ptr ? "" : path, blob, blob_size, &raw, &ph);
-
-    if (file_data)
-        free(file_data);
-
+    bool ok = imesh_parse_to_raw(am, path_is_ptr ? "" : path, blob, blob_size, fm != NULL, &raw, &ph);
     if (!ok)
+    {
+        if (fm)
+            asset_io_unmap(fm);
+        free(fm);
         return false;
+    }
+
+    raw.file_map = fm;
+    if (fm && !imesh_raw_borrows(&raw))
+        imesh_unmap_raw(&raw);
+    asset_model_upload_stage(am, &raw);
 
     memset(out_asset, 0, sizeof(*out_asset));
     out_asset->type = ASSET_MODEL;
@@ -460,130 +524,68 @@ bool asset_model_imesh_load(asset_manager_t *am, const char *path, uint32_t path
     return true;
 }
 
-bool asset_model_imesh_init(asset_manager_t *am, asset_any_t *asset)
+static bool asset_model_imesh_load_blob(asset_manager_t *am, const char *path, const asset_blob_t *blob, asset_any_t *out_asset, ihandle_t *out_handle)
 {
-    if (!am || !asset || asset->type != ASSET_MODEL)
+    if (out_handle)
+        *out_handle = ihandle_invalid();
+
+    if (!am || !blob || !blob->data || !out_asset)
         return false;
 
-    asset_model_t model = asset_model_make();
+    const uint8_t *data = blob->data;
+    uint32_t size = blob->size;
+    uint8_t *storage = NULL;
+    asset_staging_alloc_t staged;
+    memset(&staged, 0, sizeof(staged));
 
-    for (uint32_t i = 0; i < asset->as.model_raw.submeshes.size; ++i)
+    // Compressed blobs decode into one buffer that the raw model keeps; LODs point into it. With
+    // an upload ring that buffer is a ring region, so the LODs are already where the GPU copies from.
+    if (blob->codec != ASSET_CODEC_NONE)
     {
-        model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&asset->as.model_raw.submeshes, i);
-        if (!sm || sm->lods.size == 0)
-            continue;
-
-        mesh_t gm;
-        memset(&gm, 0, sizeof(gm));
-        gm.material = sm->material;
-        gm.lods = vector_impl_create_vector(sizeof(mesh_lod_t));
-        gm.flags = 0;
-
-        mesh_set_local_aabb_from_cpu(&gm, sm);
-
-        uint32_t want_lods = sm->lods.size;
-        uint32_t uploaded = 0;
-
-        for (uint32_t li = 0; li < sm->lods.size; ++li)
-        {
-            model_cpu_lod_t *cl = (model_cpu_lod_t *)vector_impl_at(&sm->lods, li);
-            if (!cl || !cl->vertices || !cl->indices || !cl->vertex_count || !cl->index_count)
-                continue;
-
-            mesh_lod_t glod;
-            memset(&glod, 0, sizeof(glod));
-            glod.index_count = cl->index_count;
-
-            glGenVertexArrays(1, &glod.vao);
-            glBindVertexArray(glod.vao);
-
-            glGenBuffers(1, &glod.vbo);
-            glBindBuffer(GL_ARRAY_BUFFER, glod.vbo);
-            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(cl->vertex_count * sizeof(model_vertex_t)), cl->vertices, GL_STATIC_DRAW);
-
-            glGenBuffers(1, &glod.ibo);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glod.ibo);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(cl->index_count * sizeof(uint32_t)), cl->indices, GL_STATIC_DRAW);
-
-            imesh_setup_model_vertex_vao();
-
-            glBindVertexArray(0);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-            vector_impl_push_back(&gm.lods, &glod);
-            uploaded++;
-
-            if (li == 0)
-                gm.flags = (uint8_t)(gm.flags | (uint8_t)MESH_FLAG_LOD0_READY);
-        }
-
-        if (uploaded > 0)
-        {
-            if (uploaded == want_lods)
-                gm.flags = (uint8_t)(gm.flags | (uint8_t)MESH_FLAG_LODS_READY);
-            vector_impl_push_back(&model.meshes, &gm);
-        }
+        asset_staging_t *staging = asset_manager_staging(am);
+        uint8_t *dst = NULL;
+        if (staging && asset_staging_alloc(staging, blob->uncompressed_size, 16u, &staged))
+            dst = (uint8_t *)staged.ptr;
         else
+            dst = storage = (uint8_t *)malloc((size_t)blob->uncompressed_size);
+
+        if (!dst || !asset_codec_decode(blob->codec, blob->data, blob->size, dst, blob->uncompressed_size))
         {
-            vector_impl_free(&gm.lods);
+            IMESH_LOGE("imesh: %s decode failed '%s'", asset_codec_name(blob->codec), path ? path : "<pack>");
+            if (staged.id)
+                asset_staging_release(staging, staged.id);
+            free(storage);
+            return false;
         }
+        data = dst;
+        size = blob->uncompressed_size;
     }
 
-    model_raw_destroy(&asset->as.model_raw);
-    asset->as.model = model;
-
-    asset->state = ASSET_STATE_READY;
-
-    return true;
-}
-
-void asset_model_imesh_cleanup(asset_manager_t *am, asset_any_t *asset)
-{
-    (void)am;
-
-    if (!asset || asset->type != ASSET_MODEL)
-        return;
-
-    if (asset->state != ASSET_STATE_READY)
-        model_raw_destroy(&asset->as.model_raw);
+    model_raw_t raw = model_raw_make();
+    ihandle_t ph = ihandle_invalid();
 
-    for (uint32_t i = 0; i < asset->as.model.meshes.size; ++i)
+    // Source files from the I/O stage are freed after this call; copy their LODs out.
+    bool borrow = blob->codec != ASSET_CODEC_NONE || !(blob->flags & ASSET_BLOB_FLAG_SOURCE_FILE);
+    if (!imesh_parse_to_raw(am, path ? path : "", data, size, borrow, &raw, &ph))
     {
-        mesh_t *m = (mesh_t *)vector_impl_at(&asset->as.model.meshes, i);
-        if (!m)
-            continue;
-
-        for (uint32_t li = 0; li < m->lods.size; ++li)
-        {
-            mesh_lod_t *l = (mesh_lod_t *)vector_impl_at(&m->lods, li);
-            if (!l)
-                continue;
-            if (l->ibo)
-                glDeleteBuffers(1, &l->ibo);
-            if (l->vbo)
-                glDeleteBuffers(1, &l->vbo);
-            if (l->vao)
-                glDeleteVertexArrays(1, &l->vao);
-            memset(l, 0, sizeof(*l));
-        }
-
-        vector_impl_free(&m->lods);
-        m->material = ihandle_invalid();
-        m->flags = 0;
-        m->local_aabb.min = (vec3){0, 0, 0};
-        m->local_aabb.max = (vec3){0, 0, 0};
+        if (staged.id)
+            asset_staging_release(asset_manager_staging(am), staged.id);
+        free(storage);
+        return false;
     }
+    raw.storage = storage;
+    raw.staging_region = staged.id;
+    asset_model_upload_stage(am, &raw);
 
-    asset_model_destroy_cpu_only(&asset->as.model);
-}
+    memset(out_asset, 0, sizeof(*out_asset));
+    out_asset->type = ASSET_MODEL;
+    out_asset->state = ASSET_STATE_LOADING;
+    out_asset->as.model_raw = raw;
 
-static uint64_t imesh_align_u64(uint64_t x, uint64_t a)
-{
-    if (a == 0)
-        return x;
-    uint64_t m = a - 1ull;
-    return (x + m) & ~m;
+    if (out_handle)
+        *out_handle = ph;
+
+    return true;
 }
 
 static bool asset_model_imesh_save_blob(asset_manager_t *am, ihandle_t h, const asset_any_t *a, asset_blob_t *out)
@@ -789,11 +791,11 @@ static bool asset_model_imesh_save_blob(asset_manager_t *am, ihandle_t h, const
     hdr.magic[1] = 'M';
     hdr.magic[2] = 'S';
     hdr.magic[3] = 'H';
-    hdr.version = 2;
+    hdr.version = IMESH_VERSION;
     hdr.flags = 0;
     hdr.submesh_count = submesh_count;
     hdr.reserved0 = 0;
-    hdr.model_handle = h;
+    hdr.model_handle = imesh_handle_from_persistent(h);
     hdr.submesh_table_offset = smt_off;
 
     memcpy(buf, &hdr, sizeof(hdr));
@@ -813,7 +815,7 @@ static bool asset_model_imesh_save_blob(asset_manager_t *am, ihandle_t h, const
         sr.flags = IMESH_SUBMESH_HAS_AABB;
         sr.material_name_len = 0;
         sr.material_name_offset = 0;
-        sr.material_handle = sm->material;
+        sr.material_handle = imesh_handle_from_runtime(sm->material, &sr.material_generation);
         sr.aabb_min[0] = sm->local_aabb.min.x;
         sr.aabb_min[1] = sm->local_aabb.min.y;
         sr.aabb_min[2] = sm->local_aabb.min.z;
@@ -821,7 +823,6 @@ static bool asset_model_imesh_save_blob(asset_manager_t *am, ihandle_t h, const
         sr.aabb_max[1] = sm->local_aabb.max.y;
         sr.aabb_max[2] = sm->local_aabb.max.z;
         sr.lod_count = lc;
-        sr.reserved0 = 0;
         sr.lods_offset = lod_table_cursor;
 
         smt[si] = sr;
@@ -901,7 +902,7 @@ static bool asset_model_imesh_can_load(asset_manager_t *am, const char *path, ui
         const imesh_header_t *h = (const imesh_header_t *)b->data;
         if (memcmp(h->magic, "IMSH", 4) != 0)
             return false;
-        return h->version == 2;
+        return imesh_version_supported(h->version);
     }
 
     if (!imesh_has_ext(path))
@@ -919,7 +920,7 @@ static bool asset_model_imesh_can_load(asset_manager_t *am, const char *path, ui
         return false;
     if (memcmp(h.magic, "IMSH", 4) != 0)
         return false;
-    return h.version == 2;
+    return imesh_version_supported(h.version);
 }
 
 asset_module_desc_t asset_module_model_imesh(void)
@@ -928,10 +929,14 @@ asset_module_desc_t asset_module_model_imesh(void)
     m.type = ASSET_MODEL;
     m.name = "ASSET_MODEL_IMESH";
     m.load_fn = asset_model_imesh_load;
-    m.init_fn = asset_model_imesh_init;
-    m.cleanup_fn = asset_model_imesh_cleanup;
+    m.init_fn = asset_model_upload_all;
+    m.cleanup_fn = asset_model_upload_cleanup;
     m.save_blob_fn = asset_model_imesh_save_blob;
     m.blob_free_fn = asset_model_imesh_blob_free;
     m.can_load_fn = asset_model_imesh_can_load;
+    m.load_blob_fn = asset_model_imesh_load_blob;
+    m.upload_fn = asset_model_upload;
+    m.version = IMESH_VERSION;
+    m.maps_source_files = true;
     return m;
 }
\ No newline at end of file
@@ -0,0 +1,894 @@
+#include "image_bcn.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include <GL/glew.h>
+
+#include "image_mips.h"
+#include "utils/jobs.h"
+
+// Detect SSE2 on x86/x64
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && \
+    (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+#define BCN_USE_SSE2 1
+#include <immintrin.h>
+#else
+#define BCN_USE_SSE2 0
+#endif
+
+// Base-level PSNR below which BC1/BC3 color is given up for BC7.
+#define BCN_BC7_FALLBACK_PSNR 35.0
+
+// 16 texels of a block, one row of floats per channel so the index search runs 4 texels wide.
+typedef struct bcn_block_t
+{
+    float c[4][16];
+} bcn_block_t;
+
+static const float k_bc1_weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+static const uint32_t k_bc7_weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+static const float k_bc7_weights_f[16] = {0.0f / 64, 4.0f / 64, 9.0f / 64, 13.0f / 64, 17.0f / 64, 21.0f / 64, 26.0f / 64, 30.0f / 64,
+                                          34.0f / 64, 38.0f / 64, 43.0f / 64, 47.0f / 64, 51.0f / 64, 55.0f / 64, 60.0f / 64, 64.0f / 64};
+static const uint32_t k_bc7_weights2[4] = {0, 21, 43, 64};
+static const float k_bc7_weights2_f[4] = {0.0f, 21.0f / 64, 43.0f / 64, 1.0f};
+
+static uint64_t bcn_time_us(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER freq = {0};
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    if (freq.QuadPart == 0)
+        return (uint64_t)time(NULL) * 1000000ull;
+    return (uint64_t)(((uint64_t)now.QuadPart / (uint64_t)freq.QuadPart) * 1000000ull + (((uint64_t)now.QuadPart % (uint64_t)freq.QuadPart) * 1000000ull) / (uint64_t)freq.QuadPart);
+#else
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000ull;
+    return (uint64_t)time(NULL) * 1000000ull;
+#endif
+}
+
+static float bcn_clamp255(float v)
+{
+    return v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v);
+}
+
+uint32_t asset_image_bc_block_bytes(uint32_t format)
+{
+    switch (format)
+    {
+    case ASSET_IMAGE_BC1:
+    case ASSET_IMAGE_BC4:
+        return 8u;
+    case ASSET_IMAGE_BC3:
+    case ASSET_IMAGE_BC5:
+    case ASSET_IMAGE_BC7:
+        return 16u;
+    default:
+        return 0u;
+    }
+}
+
+const char *asset_image_bc_name(uint32_t format)
+{
+    switch (format)
+    {
+    case ASSET_IMAGE_BC_NONE:
+        return "none";
+    case ASSET_IMAGE_BC1:
+        return "BC1";
+    case ASSET_IMAGE_BC3:
+        return "BC3";
+    case ASSET_IMAGE_BC4:
+        return "BC4";
+    case ASSET_IMAGE_BC5:
+        return "BC5";
+    case ASSET_IMAGE_BC7:
+        return "BC7";
+    default:
+        return "unknown";
+    }
+}
+
+// Channels each format keeps, for PSNR.
+static uint32_t bcn_kept_channels(uint32_t format, uint32_t channels)
+{
+    switch (format)
+    {
+    case ASSET_IMAGE_BC1:
+        return 3u;
+    case ASSET_IMAGE_BC3:
+        return 4u;
+    case ASSET_IMAGE_BC4:
+        return 1u;
+    case ASSET_IMAGE_BC5:
+        return 2u;
+    default:
+        return channels;
+    }
+}
+
+static double bcn_psnr(uint64_t sq_err, uint64_t samples)
+{
+    if (!sq_err || !samples)
+        return 99.0;
+    return 10.0 * log10(255.0 * 255.0 * (double)samples / (double)sq_err);
+}
+
+// Edge blocks repeat the last row and column.
+static void bcn_load_block(bcn_block_t *b, const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels, uint32_t bx, uint32_t by)
+{
+    for (uint32_t y = 0; y < 4u; ++y)
+    {
+        const uint32_t sy = (by * 4u + y < h) ? by * 4u + y : h - 1u;
+        for (uint32_t x = 0; x < 4u; ++x)
+        {
+            const uint32_t sx = (bx * 4u + x < w) ? bx * 4u + x : w - 1u;
+            const uint8_t *p = pixels + ((size_t)sy * w + sx) * channels;
+            const uint32_t i = y * 4u + x;
+            b->c[0][i] = (float)p[0];
+            b->c[1][i] = channels >= 3u ? (float)p[1] : 0.0f;
+            b->c[2][i] = channels >= 3u ? (float)p[2] : 0.0f;
+            b->c[3][i] = channels == 4u ? (float)p[3] : 255.0f;
+        }
+    }
+}
+
+// Picks the closest palette entry for each texel over channels px[0..nc). Returns the summed
+// squared error.
+static float bcn_nearest(const float (*px)[16], uint32_t nc, const float (*pal)[4], uint32_t pal_count, uint8_t *idx)
+{
+    float err = 0.0f;
+#if BCN_USE_SSE2
+    for (uint32_t p = 0; p < 16u; p += 4u)
+    {
+        __m128 best = _mm_set1_ps(3.0e38f);
+        __m128 best_i = _mm_setzero_ps();
+        for (uint32_t k = 0; k < pal_count; ++k)
+        {
+            __m128 d = _mm_setzero_ps();
+            for (uint32_t c = 0; c < nc; ++c)
+            {
+                const __m128 t = _mm_sub_ps(_mm_loadu_ps(&px[c][p]), _mm_set1_ps(pal[k][c]));
+                d = _mm_add_ps(d, _mm_mul_ps(t, t));
+            }
+            const __m128 lt = _mm_cmplt_ps(d, best);
+            best = _mm_min_ps(d, best);
+            best_i = _mm_or_ps(_mm_and_ps(lt, _mm_set1_ps((float)k)), _mm_andnot_ps(lt, best_i));
+        }
+
+        int32_t bi[4];
+        float be[4];
+        _mm_storeu_si128((__m128i *)(void *)bi, _mm_cvttps_epi32(best_i));
+        _mm_storeu_ps(be, best);
+        for (uint32_t j = 0; j < 4u; ++j)
+        {
+            idx[p + j] = (uint8_t)bi[j];
+            err += be[j];
+        }
+    }
+#else
+    for (uint32_t p = 0; p < 16u; ++p)
+    {
+        float best = 3.0e38f;
+        uint32_t best_i = 0;
+        for (uint32_t k = 0; k < pal_count; ++k)
+        {
+            float d = 0.0f;
+            for (uint32_t c = 0; c < nc; ++c)
+            {
+                const float t = px[c][p] - pal[k][c];
+                d += t * t;
+            }
+            if (d < best)
+            {
+                best = d;
+                best_i = k;
+            }
+        }
+        idx[p] = (uint8_t)best_i;
+        err += best;
+    }
+#endif
+    return err;
+}
+
+// Endpoints at the ends of the block's principal axis over channels [0, nc).
+static void bcn_principal_range(const bcn_block_t *b, uint32_t nc, float *e0, float *e1)
+{
+    float mean[4] = {0};
+    float lo[4];
+    float hi[4];
+    for (uint32_t c = 0; c < nc; ++c)
+    {
+        lo[c] = hi[c] = b->c[c][0];
+        for (uint32_t i = 0; i < 16u; ++i)
+        {
+            const float v = b->c[c][i];
+            mean[c] += v;
+            lo[c] = v < lo[c] ? v : lo[c];
+            hi[c] = v > hi[c] ? v : hi[c];
+        }
+        mean[c] *= 1.0f / 16.0f;
+    }
+
+    float cov[4][4] = {{0}};
+    for (uint32_t i = 0; i < 16u; ++i)
+    {
+        for (uint32_t r = 0; r < nc; ++r)
+        {
+            const float dr = b->c[r][i] - mean[r];
+            for (uint32_t c = r; c < nc; ++c)
+                cov[r][c] += dr * (b->c[c][i] - mean[c]);
+        }
+    }
+    for (uint32_t r = 0; r < nc; ++r)
+        for (uint32_t c = 0; c < r; ++c)
+            cov[r][c] = cov[c][r];
+
+    // Power iteration from the bounding box diagonal.
+    float axis[4] = {0};
+    for (uint32_t c = 0; c < nc; ++c)
+        axis[c] = hi[c] - lo[c];
+    for (uint32_t it = 0; it < 8u; ++it)
+    {
+        float next[4] = {0};
+        float len = 0.0f;
+        for (uint32_t r = 0; r < nc; ++r)
+        {
+            for (uint32_t c = 0; c < nc; ++c)
+                next[r] += cov[r][c] * axis[c];
+            len += next[r] * next[r];
+        }
+        if (len < 1e-12f)
+            break;
+        len = 1.0f / sqrtf(len);
+        for (uint32_t c = 0; c < nc; ++c)
+            axis[c] = next[c] * len;
+    }
+
+    float len = 0.0f;
+    for (uint32_t c = 0; c < nc; ++c)
+        len += axis[c] * axis[c];
+    if (len < 1e-12f)
+    {
+        for (uint32_t c = 0; c < nc; ++c)
+            e0[c] = e1[c] = mean[c];
+        return;
+    }
+    len = 1.0f / sqrtf(len);
+    for (uint32_t c = 0; c < nc; ++c)
+        axis[c] *= len;
+
+    float tmin = 0.0f;
+    float tmax = 0.0f;
+    for (uint32_t i = 0; i < 16u; ++i)
+    {
+        float t = 0.0f;
+        for (uint32_t c = 0; c < nc; ++c)
+            t += (b->c[c][i] - mean[c]) * axis[c];
+        tmin = t < tmin ? t : tmin;
+        tmax = t > tmax ? t : tmax;
+    }
+    for (uint32_t c = 0; c < nc; ++c)
+    {
+        e0[c] = bcn_clamp255(mean[c] + axis[c] * tmin);
+        e1[c] = bcn_clamp255(mean[c] + axis[c] * tmax);
+    }
+}
+
+// Least-squares endpoints for the chosen indices, where weight[idx] is the position between e0 and
+// e1. False when every texel landed on the same weight.
+static bool bcn_refit(const bcn_block_t *b, uint32_t nc, const uint8_t *idx, const float *weight, float *e0, float *e1)
+{
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    float x[4] = {0};
+    float y[4] = {0};
+    for (uint32_t i = 0; i < 16u; ++i)
+    {
+        const float t = weight[idx[i]];
+        const float s = 1.0f - t;
+        aa += s * s;
+        ab += s * t;
+        bb += t * t;
+        for (uint32_t c = 0; c < nc; ++c)
+        {
+            x[c] += s * b->c[c][i];
+            y[c] += t * b->c[c][i];
+        }
+    }
+
+    const float det = aa * bb - ab * ab;
+    if (fabsf(det) < 1e-6f)
+        return false;
+    const float inv = 1.0f / det;
+    for (uint32_t c = 0; c < nc; ++c)
+    {
+        e0[c] = bcn_clamp255((bb * x[c] - ab * y[c]) * inv);
+        e1[c] = bcn_clamp255((aa * y[c] - ab * x[c]) * inv);
+    }
+    return true;
+}
+
+static uint16_t bcn_pack565(const float *c)
+{
+    const uint32_t r = (uint32_t)(c[0] * (31.0f / 255.0f) + 0.5f);
+    const uint32_t g = (uint32_t)(c[1] * (63.0f / 255.0f) + 0.5f);
+    const uint32_t b = (uint32_t)(c[2] * (31.0f / 255.0f) + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void bcn_unpack565(uint16_t v, float *c)
+{
+    const uint32_t r = (v >> 11) & 31u;
+    const uint32_t g = (v >> 5) & 63u;
+    const uint32_t b = v & 31u;
+    c[0] = (float)((r << 3) | (r >> 2));
+    c[1] = (float)((g << 2) | (g >> 4));
+    c[2] = (float)((b << 3) | (b >> 2));
+    c[3] = 255.0f;
+}
+
+// Four-color mode only: c0 > c1, or both equal with every index 0.
+static float bcn_bc1_try(const bcn_block_t *b, const float *e0, const float *e1, uint16_t *c, uint8_t *idx)
+{
+    c[0] = bcn_pack565(e0);
+    c[1] = bcn_pack565(e1);
+    if (c[0] < c[1])
+    {
+        const uint16_t t = c[0];
+        c[0] = c[1];
+        c[1] = t;
+    }
+
+    float pal[4][4];
+    bcn_unpack565(c[0], pal[0]);
+    bcn_unpack565(c[1], pal[1]);
+    for (uint32_t k = 0; k < 3u; ++k)
+    {
+        pal[2][k] = (2.0f * pal[0][k] + pal[1][k]) * (1.0f / 3.0f);
+        pal[3][k] = (pal[0][k] + 2.0f * pal[1][k]) * (1.0f / 3.0f);
+    }
+    return bcn_nearest(b->c, 3u, (const float (*)[4])pal, c[0] == c[1] ? 1u : 4u, idx);
+}
+
+static float bcn_encode_bc1(const bcn_block_t *b, uint8_t *out)
+{
+    float e0[4];
+    float e1[4];
+    uint16_t c[2];
+    uint8_t idx[16];
+    bcn_principal_range(b, 3u, e0, e1);
+    float err = bcn_bc1_try(b, e0, e1, c, idx);
+
+    uint16_t rc[2];
+    uint8_t ridx[16];
+    if (err > 0.0f && bcn_refit(b, 3u, idx, k_bc1_weights, e0, e1))
+    {
+        const float rerr = bcn_bc1_try(b, e0, e1, rc, ridx);
+        if (rerr < err)
+        {
+            err = rerr;
+            memcpy(c, rc, sizeof(c));
+            memcpy(idx, ridx, sizeof(idx));
+        }
+    }
+
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < 16u; ++i)
+        bits |= (uint32_t)idx[i] << (i * 2u);
+
+    out[0] = (uint8_t)c[0];
+    out[1] = (uint8_t)(c[0] >> 8);
+    out[2] = (uint8_t)c[1];
+    out[3] = (uint8_t)(c[1] >> 8);
+    for (uint32_t i = 0; i < 4u; ++i)
+        out[4 + i] = (uint8_t)(bits >> (i * 8u));
+    return err;
+}
+
+// Eight-value mode (e0 > e1) spanning the channel's range.
+static float bcn_encode_bc4(const float *v, uint8_t *out)
+{
+    float lo = v[0];
+    float hi = v[0];
+    for (uint32_t i = 1; i < 16u; ++i)
+    {
+        lo = v[i] < lo ? v[i] : lo;
+        hi = v[i] > hi ? v[i] : hi;
+    }
+
+    const uint32_t e0 = (uint32_t)(hi + 0.5f);
+    const uint32_t e1 = (uint32_t)(lo + 0.5f);
+
+    float pal[8][4];
+    pal[0][0] = (float)e0;
+    pal[1][0] = (float)e1;
+    for (uint32_t k = 2; k < 8u; ++k)
+        pal[k][0] = (float)((8u - k) * e0 + (k - 1u) * e1) * (1.0f / 7.0f);
+
+    uint8_t idx[16];
+    const float err = bcn_nearest((const float (*)[16])v, 1u, (const float (*)[4])pal, e0 == e1 ? 1u : 8u, idx);
+
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < 16u; ++i)
+        bits |= (uint64_t)idx[i] << (i * 3u);
+
+    out[0] = (uint8_t)e0;
+    out[1] = (uint8_t)e1;
+    for (uint32_t i = 0; i < 6u; ++i)
+        out[2 + i] = (uint8_t)(bits >> (i * 8u));
+    return err;
+}
+
+// 7-bit endpoint plus a shared p-bit: keeps whichever p-bit lands closer over all four channels.
+static void bcn_bc7_quant(const float *e, uint32_t *q, uint32_t *pbit)
+{
+    float best = 3.0e38f;
+    for (uint32_t p = 0; p < 2u; ++p)
+    {
+        uint32_t t[4];
+        float err = 0.0f;
+        for (uint32_t c = 0; c < 4u; ++c)
+        {
+            const float f = (e[c] - (float)p) * 0.5f + 0.5f;
+            t[c] = f <= 0.0f ? 0u : (f >= 127.0f ? 127u : (uint32_t)f);
+            const float d = e[c] - (float)(t[c] * 2u + p);
+            err += d * d;
+        }
+        if (err < best)
+        {
+            best = err;
+            memcpy(q, t, sizeof(t));
+            *pbit = p;
+        }
+    }
+}
+
+static float bcn_bc7_try(const bcn_block_t *b, const float *e0, const float *e1, uint32_t (*q)[4], uint32_t *p, uint8_t *idx)
+{
+    bcn_bc7_quant(e0, q[0], &p[0]);
+    bcn_bc7_quant(e1, q[1], &p[1]);
+
+    float pal[16][4];
+    for (uint32_t c = 0; c < 4u; ++c)
+    {
+        const uint32_t v0 = q[0][c] * 2u + p[0];
+        const uint32_t v1 = q[1][c] * 2u + p[1];
+        for (uint32_t k = 0; k < 16u; ++k)
+            pal[k][c] = (float)(((64u - k_bc7_weights[k]) * v0 + k_bc7_weights[k] * v1 + 32u) >> 6);
+    }
+    return bcn_nearest(b->c, 4u, (const float (*)[4])pal, 16u, idx);
+}
+
+typedef struct bcn_bits_t
+{
+    uint64_t lo;
+    uint64_t hi;
+    uint32_t pos;
+} bcn_bits_t;
+
+static void bcn_bits_put(bcn_bits_t *w, uint32_t v, uint32_t n)
+{
+    if (w->pos < 64u)
+    {
+        w->lo |= (uint64_t)v << w->pos;
+        if (w->pos + n > 64u)
+            w->hi |= (uint64_t)v >> (64u - w->pos);
+    }
+    else
+    {
+        w->hi |= (uint64_t)v << (w->pos - 64u);
+    }
+    w->pos += n;
+}
+
+// Mode 6: one subset, RGBA endpoints, 4-bit indices.
+static float bcn_encode_bc7_mode6(const bcn_block_t *b, uint8_t *out)
+{
+    float e0[4];
+    float e1[4];
+    uint32_t q[2][4];
+    uint32_t p[2];
+    uint8_t idx[16];
+    bcn_principal_range(b, 4u, e0, e1);
+    float err = bcn_bc7_try(b, e0, e1, q, p, idx);
+
+    uint32_t rq[2][4];
+    uint32_t rp[2];
+    uint8_t ridx[16];
+    if (err > 0.0f && bcn_refit(b, 4u, idx, k_bc7_weights_f, e0, e1))
+    {
+        const float rerr = bcn_bc7_try(b, e0, e1, rq, rp, ridx);
+        if (rerr < err)
+        {
+            err = rerr;
+            memcpy(q, rq, sizeof(q));
+            memcpy(p, rp, sizeof(p));
+            memcpy(idx, ridx, sizeof(idx));
+        }
+    }
+
+    // The anchor texel stores only three index bits, so its top bit has to be 0.
+    if (idx[0] & 8u)
+    {
+        for (uint32_t c = 0; c < 4u; ++c)
+        {
+            const uint32_t t = q[0][c];
+            q[0][c] = q[1][c];
+            q[1][c] = t;
+        }
+        const uint32_t t = p[0];
+        p[0] = p[1];
+        p[1] = t;
+        for (uint32_t i = 0; i < 16u; ++i)
+            idx[i] = (uint8_t)(15u - idx[i]);
+    }
+
+    bcn_bits_t w = {0, 0, 0};
+    bcn_bits_put(&w, 1u << 6, 7u);
+    for (uint32_t c = 0; c < 4u; ++c)
+    {
+        bcn_bits_put(&w, q[0][c], 7u);
+        bcn_bits_put(&w, q[1][c], 7u);
+    }
+    bcn_bits_put(&w, p[0], 1u);
+    bcn_bits_put(&w, p[1], 1u);
+    bcn_bits_put(&w, idx[0], 3u);
+    for (uint32_t i = 1; i < 16u; ++i)
+        bcn_bits_put(&w, idx[i], 4u);
+
+    for (uint32_t i = 0; i < 8u; ++i)
+    {
+        out[i] = (uint8_t)(w.lo >> (i * 8u));
+        out[8 + i] = (uint8_t)(w.hi >> (i * 8u));
+    }
+    return err;
+}
+
+static float bcn_bc7_mode5_color(const bcn_block_t *b, const float *e0, const float *e1, uint32_t (*q)[4], uint8_t *idx)
+{
+    float pal[4][4];
+    for (uint32_t c = 0; c < 3u; ++c)
+    {
+        q[0][c] = (uint32_t)(e0[c] * (127.0f / 255.0f) + 0.5f);
+        q[1][c] = (uint32_t)(e1[c] * (127.0f / 255.0f) + 0.5f);
+        const uint32_t v0 = (q[0][c] << 1) | (q[0][c] >> 6);
+        const uint32_t v1 = (q[1][c] << 1) | (q[1][c] >> 6);
+        for (uint32_t k = 0; k < 4u; ++k)
+            pal[k][c] = (float)(((64u - k_bc7_weights2[k]) * v0 + k_bc7_weights2[k] * v1 + 32u) >> 6);
+    }
+    return bcn_nearest(b->c, 3u, (const float (*)[4])pal, 4u, idx);
+}
+
+// Mode 5: RGB plus a separately indexed scalar channel, 2-bit indices each. The rotation swaps a
+// color channel with alpha before encoding (the decoder swaps it back), so a channel that does not
+// follow the others, like metalness next to occlusion and roughness, gets endpoints of its own.
+static float bcn_encode_bc7_mode5(const bcn_block_t *src, uint32_t rotation, uint8_t *out)
+{
+    bcn_block_t b = *src;
+    if (rotation)
+    {
+        float t[16];
+        memcpy(t, b.c[rotation - 1u], sizeof(t));
+        memcpy(b.c[rotation - 1u], b.c[3], sizeof(t));
+        memcpy(b.c[3], t, sizeof(t));
+    }
+
+    float e0[4];
+    float e1[4];
+    uint32_t q[2][4];
+    uint8_t idx[16];
+    bcn_principal_range(&b, 3u, e0, e1);
+    float err = bcn_bc7_mode5_color(&b, e0, e1, q, idx);
+
+    uint32_t rq[2][4];
+    uint8_t ridx[16];
+    if (err > 0.0f && bcn_refit(&b, 3u, idx, k_bc7_weights2_f, e0, e1))
+    {
+        const float rerr = bcn_bc7_mode5_color(&b, e0, e1, rq, ridx);
+        if (rerr < err)
+        {
+            err = rerr;
+            memcpy(q, rq, sizeof(q));
+            memcpy(idx, ridx, sizeof(idx));
+        }
+    }
+
+    float lo = b.c[3][0];
+    float hi = b.c[3][0];
+    for (uint32_t i = 1; i < 16u; ++i)
+    {
+        lo = b.c[3][i] < lo ? b.c[3][i] : lo;
+        hi = b.c[3][i] > hi ? b.c[3][i] : hi;
+    }
+    uint32_t a[2] = {(uint32_t)(lo + 0.5f), (uint32_t)(hi + 0.5f)};
+    float apal[4][4];
+    for (uint32_t k = 0; k < 4u; ++k)
+        apal[k][0] = (float)(((64u - k_bc7_weights2[k]) * a[0] + k_bc7_weights2[k] * a[1] + 32u) >> 6);
+    uint8_t aidx[16];
+    err += bcn_nearest(&b.c[3], 1u, (const float (*)[4])apal, a[0] == a[1] ? 1u : 4u, aidx);
+
+    // Both index sets store their anchor with one bit.
+    if (idx[0] & 2u)
+    {
+        for (uint32_t c = 0; c < 3u; ++c)
+        {
+            const uint32_t t = q[0][c];
+            q[0][c] = q[1][c];
+            q[1][c] = t;
+        }
+        for (uint32_t i = 0; i < 16u; ++i)
+            idx[i] = (uint8_t)(3u - idx[i]);
+    }
+    if (aidx[0] & 2u)
+    {
+        const uint32_t t = a[0];
+        a[0] = a[1];
+        a[1] = t;
+        for (uint32_t i = 0; i < 16u; ++i)
+            aidx[i] = (uint8_t)(3u - aidx[i]);
+    }
+
+    bcn_bits_t w = {0, 0, 0};
+    bcn_bits_put(&w, 1u << 5, 6u);
+    bcn_bits_put(&w, rotation, 2u);
+    for (uint32_t c = 0; c < 3u; ++c)
+    {
+        bcn_bits_put(&w, q[0][c], 7u);
+        bcn_bits_put(&w, q[1][c], 7u);
+    }
+    bcn_bits_put(&w, a[0], 8u);
+    bcn_bits_put(&w, a[1], 8u);
+    bcn_bits_put(&w, idx[0], 1u);
+    for (uint32_t i = 1; i < 16u; ++i)
+        bcn_bits_put(&w, idx[i], 2u);
+    bcn_bits_put(&w, aidx[0], 1u);
+    for (uint32_t i = 1; i < 16u; ++i)
+        bcn_bits_put(&w, aidx[i], 2u);
+
+    for (uint32_t i = 0; i < 8u; ++i)
+    {
+        out[i] = (uint8_t)(w.lo >> (i * 8u));
+        out[8 + i] = (uint8_t)(w.hi >> (i * 8u));
+    }
+    return err;
+}
+
+// Modes 5 and 6 only: the partitioned modes would do better on blocks with several unrelated
+// colors, but need a much larger search.
+static float bcn_encode_bc7(const bcn_block_t *b, uint8_t *out)
+{
+    float best = bcn_encode_bc7_mode6(b, out);
+    uint8_t tmp[16];
+    for (uint32_t r = 0; r < 4u && best > 0.0f; ++r)
+    {
+        const float err = bcn_encode_bc7_mode5(b, r, tmp);
+        if (err < best)
+        {
+            best = err;
+            memcpy(out, tmp, sizeof(tmp));
+        }
+    }
+    return best;
+}
+
+uint32_t asset_image_bc_choose(const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels, uint32_t has_alpha)
+{
+    if (channels == 1u)
+        return ASSET_IMAGE_BC4;
+    if (!pixels || !w || !h)
+        return has_alpha && channels == 4u ? ASSET_IMAGE_BC3 : ASSET_IMAGE_BC1;
+
+    // Two channels are enough for unit normals; the shader rebuilds z.
+    if (!has_alpha && asset_image_looks_like_normal_map(pixels, w, h, channels))
+        return ASSET_IMAGE_BC5;
+
+    // BC1/BC3 fit one color line per block, which smears unrelated channels into each other. BC7
+    // mode 5 keeps the fourth channel separate and mode 6 has far more precision per endpoint.
+    if (asset_image_looks_like_packed_mask(pixels, w, h, channels))
+        return ASSET_IMAGE_BC7;
+
+    if (has_alpha && channels == 4u)
+        return ASSET_IMAGE_BC3;
+    return ASSET_IMAGE_BC1;
+}
+
+typedef struct bcn_encode_ctx_t
+{
+    uint32_t format;
+    const uint8_t *pixels;
+    uint32_t w;
+    uint32_t h;
+    uint32_t channels;
+    uint32_t blocks_x;
+    uint32_t block_bytes;
+    uint8_t *out;
+    double *row_err;
+} bcn_encode_ctx_t;
+
+static void bcn_encode_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    (void)worker_index;
+    bcn_encode_ctx_t *ctx = (bcn_encode_ctx_t *)user;
+
+    bcn_block_t b;
+    for (uint32_t by = begin; by < end; ++by)
+    {
+        double err = 0.0;
+        uint8_t *dst = ctx->out + (size_t)by * ctx->blocks_x * ctx->block_bytes;
+        for (uint32_t bx = 0; bx < ctx->blocks_x; ++bx, dst += ctx->block_bytes)
+        {
+            bcn_load_block(&b, ctx->pixels, ctx->w, ctx->h, ctx->channels, bx, by);
+            switch (ctx->format)
+            {
+            case ASSET_IMAGE_BC1:
+                err += bcn_encode_bc1(&b, dst);
+                break;
+            case ASSET_IMAGE_BC3:
+                err += bcn_encode_bc4(b.c[3], dst);
+                err += bcn_encode_bc1(&b, dst + 8);
+                break;
+            case ASSET_IMAGE_BC4:
+                err += bcn_encode_bc4(b.c[0], dst);
+                break;
+            case ASSET_IMAGE_BC5:
+                err += bcn_encode_bc4(b.c[0], dst);
+                err += bcn_encode_bc4(b.c[1], dst + 8);
+                break;
+            default:
+                err += bcn_encode_bc7(&b, dst);
+                break;
+            }
+        }
+        ctx->row_err[by] = err;
+    }
+}
+
+bool asset_image_bc_encode(uint32_t format, const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels, uint8_t *out, uint64_t *out_sq_err)
+{
+    if (out_sq_err)
+        *out_sq_err = 0;
+    if (!pixels || !out || !w || !h || (channels != 1u && channels != 3u && channels != 4u))
+        return false;
+    if (!asset_image_bc_block_bytes(format) || (channels == 1u && format != ASSET_IMAGE_BC4))
+        return false;
+
+    bcn_encode_ctx_t ctx;
+    ctx.format = format;
+    ctx.pixels = pixels;
+    ctx.w = w;
+    ctx.h = h;
+    ctx.channels = channels;
+    ctx.blocks_x = (w + 3u) / 4u;
+    ctx.block_bytes = asset_image_bc_block_bytes(format);
+    ctx.out = out;
+
+    const uint32_t blocks_y = (h + 3u) / 4u;
+    ctx.row_err = (double *)malloc(sizeof(double) * blocks_y);
+    if (!ctx.row_err)
+        return false;
+
+    // A few block rows per range keeps small levels on one thread.
+    const uint32_t grain = ctx.blocks_x >= 64u ? 1u : 64u / ctx.blocks_x;
+    jobs_parallel_for(blocks_y, grain, bcn_encode_range, &ctx);
+
+    double err = 0.0;
+    for (uint32_t i = 0; i < blocks_y; ++i)
+        err += ctx.row_err[i];
+    free(ctx.row_err);
+
+    if (out_sq_err)
+        *out_sq_err = (uint64_t)(err + 0.5);
+    return true;
+}
+
+static bool bcn_encode_chain(asset_image_mip_chain_t **out, const asset_image_mip_chain_t *src, uint32_t format, uint32_t channels, uint64_t *out_sq_err)
+{
+    asset_image_mip_chain_t *m = NULL;
+    if (!asset_image_mips_alloc(&m, src->width[0], src->height[0], asset_image_bc_block_bytes(format), format, 0u))
+        return false;
+
+    bool ok = m->mip_count == src->mip_count;
+    for (uint32_t i = 0; ok && i < m->mip_count; ++i)
+        ok = asset_image_bc_encode(format, src->level[i], src->width[i], src->height[i], channels, m->level[i], i == 0 ? out_sq_err : NULL);
+
+    if (!ok)
+    {
+        asset_image_mips_free(m);
+        return false;
+    }
+    *out = m;
+    return true;
+}
+
+bool asset_image_bc_compress_chain(asset_image_mip_chain_t **out, const asset_image_mip_chain_t *src, uint32_t channels, uint32_t has_alpha, asset_image_bc_stats_t *out_stats)
+{
+    if (out)
+        *out = NULL;
+    if (!out || !src || src->bc_format || src->bytes_per_pixel != channels || src->resident_first != 0)
+        return false;
+
+    const uint64_t t0 = bcn_time_us();
+    uint32_t format = asset_image_bc_choose(src->level[0], src->width[0], src->height[0], channels, has_alpha);
+
+    uint64_t err = 0;
+    asset_image_mip_chain_t *m = NULL;
+    if (!bcn_encode_chain(&m, src, format, channels, &err))
+        return false;
+
+    const uint64_t base = (uint64_t)src->width[0] * src->height[0];
+    double psnr = bcn_psnr(err, base * bcn_kept_channels(format, channels));
+    if ((format == ASSET_IMAGE_BC1 || format == ASSET_IMAGE_BC3) && psnr < BCN_BC7_FALLBACK_PSNR)
+    {
+        asset_image_mip_chain_t *m7 = NULL;
+        if (bcn_encode_chain(&m7, src, ASSET_IMAGE_BC7, channels, &err))
+        {
+            asset_image_mips_free(m);
+            m = m7;
+            format = ASSET_IMAGE_BC7;
+            psnr = bcn_psnr(err, base * bcn_kept_channels(format, channels));
+        }
+    }
+
+    if (out_stats)
+    {
+        out_stats->format = format;
+        out_stats->pixels = 0;
+        for (uint32_t i = 0; i < src->mip_count; ++i)
+            out_stats->pixels += (uint64_t)src->width[i] * src->height[i];
+        out_stats->encode_us = bcn_time_us() - t0;
+        out_stats->psnr = psnr;
+    }
+
+    *out = m;
+    return true;
+}
+
+uint32_t asset_image_bc_gl_format(uint32_t format)
+{
+    switch (format)
+    {
+    case ASSET_IMAGE_BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case ASSET_IMAGE_BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case ASSET_IMAGE_BC4:
+        return GL_COMPRESSED_RED_RGTC1;
+    case ASSET_IMAGE_BC5:
+        return GL_COMPRESSED_RG_RGTC2;
+    case ASSET_IMAGE_BC7:
+        return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    default:
+        return 0u;
+    }
+}
+
+bool asset_image_bc_gl_supported(uint32_t format)
+{
+    switch (format)
+    {
+    case ASSET_IMAGE_BC1:
+    case ASSET_IMAGE_BC3:
+        return GLEW_EXT_texture_compression_s3tc != 0;
+    case ASSET_IMAGE_BC4:
+    case ASSET_IMAGE_BC5:
+        return GLEW_VERSION_3_0 || GLEW_ARB_texture_compression_rgtc;
+    case ASSET_IMAGE_BC7:
+        return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "asset_manager/asset_types/image.h"
+
+// Block-compressed texture formats. Ids are stored in .itex files; never renumber.
+typedef enum asset_image_bc_t
+{
+    ASSET_IMAGE_BC_NONE = 0,
+    ASSET_IMAGE_BC1 = 1, // RGB, 4 bpp
+    ASSET_IMAGE_BC3 = 3, // RGB + interpolated alpha, 8 bpp
+    ASSET_IMAGE_BC4 = 4, // R, 4 bpp
+    ASSET_IMAGE_BC5 = 5, // RG, 8 bpp; tangent-space normal maps, z is rebuilt in the shader
+    ASSET_IMAGE_BC7 = 7, // RGBA, 8 bpp, much closer to the source than BC1/BC3
+} asset_image_bc_t;
+
+// Bytes per 4x4 block; 0 for NONE and unknown ids.
+uint32_t asset_image_bc_block_bytes(uint32_t format);
+const char *asset_image_bc_name(uint32_t format);
+
+// Picks a format from the base level's content: BC4 for one channel, BC5 for tangent-space normal
+// maps, BC7 for packed masks (ORM/ARM) whose channels vary independently, BC3 with alpha, BC1
+// otherwise. `pixels` is the base level, tightly packed.
+uint32_t asset_image_bc_choose(const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels, uint32_t has_alpha);
+
+// Encodes a w x h level (channels 1, 3 or 4) into ceil(w/4) * ceil(h/4) blocks, rows of blocks
+// split across the job pool. *out_sq_err (optional) receives the summed squared error of the
+// channels the format keeps, in 8-bit units.
+bool asset_image_bc_encode(uint32_t format, const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels, uint8_t *out, uint64_t *out_sq_err);
+
+typedef struct asset_image_bc_stats_t
+{
+    uint32_t format;
+    uint64_t pixels;    // every level
+    uint64_t encode_us; // including the trial encode when falling back to BC7
+    double psnr;        // base level, dB
+} asset_image_bc_stats_t;
+
+// Compresses an 8-bit chain with every level in RAM. Starts from asset_image_bc_choose and moves
+// BC1/BC3 to BC7 when the base level still loses too much. Float chains are left alone.
+bool asset_image_bc_compress_chain(asset_image_mip_chain_t **out, const asset_image_mip_chain_t *src, uint32_t channels, uint32_t has_alpha, asset_image_bc_stats_t *out_stats);
+
+// GL internal format for glCompressedTex*, and whether the current context can sample it.
+uint32_t asset_image_bc_gl_format(uint32_t format);
+bool asset_image_bc_gl_supported(uint32_t format);
@@ -1,8 +1,25 @@
 #include "image_mips.h"
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "utils/jobs.h"
+#include "utils/threads.h"
+
+// Share of sampled texels that have to look like unit tangent-space normals.
+#define MIPS_NORMAL_MAP_RATIO 0.95f
+#define MIPS_NORMAL_MAP_SAMPLES 4096u
+// Packed masks: every pair of channels that varies at all correlates less than this. Color
+// textures keep a strong luminance link between at least two of R, G and B.
+#define MIPS_PACKED_MASK_MAX_CORR 0.5
+// Channels with a smaller standard deviation (8-bit units) are treated as constant.
+#define MIPS_PACKED_MASK_MIN_STDDEV 4.0
+// Destination pixels per job range when a level is split across threads. Windowed filters re-filter
+// the source rows around each range edge, so their ranges also span at least MIPS_WINDOWED_ROWS.
+#define MIPS_RANGE_PIXELS 65536u
+#define MIPS_WINDOWED_ROWS 32u
+
 static uint32_t image_mip_count(uint32_t w, uint32_t h)
 {
     uint32_t n = 1;
@@ -19,64 +36,96 @@ static uint32_t image_mip_count(uint32_t w, uint32_t h)
     return n;
 }
 
-static uint32_t clamp_u32(uint32_t v, uint32_t lo, uint32_t hi)
+bool asset_image_looks_like_normal_map(const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels)
 {
-    if (v < lo)
-        return lo;
-    if (v > hi)
-        return hi;
-    return v;
+    if (!pixels || !w || !h || channels < 3u)
+        return false;
+
+    // Tangent-space normal maps decode to unit vectors facing +z.
+    const uint64_t count = (uint64_t)w * h;
+    const uint64_t step = count > MIPS_NORMAL_MAP_SAMPLES ? count / MIPS_NORMAL_MAP_SAMPLES : 1u;
+    uint32_t sampled = 0;
+    uint32_t normals = 0;
+    for (uint64_t i = 0; i < count; i += step)
+    {
+        const uint8_t *p = pixels + (size_t)i * channels;
+        const float x = (float)p[0] * (2.0f / 255.0f) - 1.0f;
+        const float y = (float)p[1] * (2.0f / 255.0f) - 1.0f;
+        const float z = (float)p[2] * (2.0f / 255.0f) - 1.0f;
+        const float len2 = x * x + y * y + z * z;
+        sampled++;
+        if (z > -0.01f && len2 > 0.85f && len2 < 1.15f)
+            normals++;
+    }
+    return (float)normals >= (float)sampled * MIPS_NORMAL_MAP_RATIO;
 }
 
-static void downsample_box_u8(uint8_t *dst, uint32_t dw, uint32_t dh, const uint8_t *src, uint32_t sw, uint32_t sh, uint32_t channels)
+bool asset_image_looks_like_packed_mask(const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels)
 {
-    for (uint32_t y = 0; y < dh; ++y)
+    if (!pixels || !w || !h || channels < 3u)
+        return false;
+
+    const uint64_t count = (uint64_t)w * h;
+    const uint64_t step = count > MIPS_NORMAL_MAP_SAMPLES ? count / MIPS_NORMAL_MAP_SAMPLES : 1u;
+    double sum[3] = {0.0, 0.0, 0.0};
+    double sq[3] = {0.0, 0.0, 0.0};
+    double cross[3] = {0.0, 0.0, 0.0}; // RG, RB, GB
+    double n = 0.0;
+    for (uint64_t i = 0; i < count; i += step)
     {
-        uint32_t sy0 = clamp_u32(y * 2u + 0u, 0u, sh ? (sh - 1u) : 0u);
-        uint32_t sy1 = clamp_u32(y * 2u + 1u, 0u, sh ? (sh - 1u) : 0u);
-        for (uint32_t x = 0; x < dw; ++x)
-        {
-            uint32_t sx0 = clamp_u32(x * 2u + 0u, 0u, sw ? (sw - 1u) : 0u);
-            uint32_t sx1 = clamp_u32(x * 2u + 1u, 0u, sw ? (sw - 1u) : 0u);
+        const uint8_t *p = pixels + (size_t)i * channels;
+        const double r = (double)p[0];
+        const double g = (double)p[1];
+        const double b = (double)p[2];
+        sum[0] += r;
+        sum[1] += g;
+        sum[2] += b;
+        sq[0] += r * r;
+        sq[1] += g * g;
+        sq[2] += b * b;
+        cross[0] += r * g;
+        cross[1] += r * b;
+        cross[2] += g * b;
+        n += 1.0;
+    }
 
-            const uint8_t *p00 = src + ((size_t)sy0 * (size_t)sw + (size_t)sx0) * (size_t)channels;
-            const uint8_t *p10 = src + ((size_t)sy0 * (size_t)sw + (size_t)sx1) * (size_t)channels;
-            const uint8_t *p01 = src + ((size_t)sy1 * (size_t)sw + (size_t)sx0) * (size_t)channels;
-            const uint8_t *p11 = src + ((size_t)sy1 * (size_t)sw + (size_t)sx1) * (size_t)channels;
+    const double min_var = MIPS_PACKED_MASK_MIN_STDDEV * MIPS_PACKED_MASK_MIN_STDDEV;
+    double var[3];
+    uint32_t varying = 0;
+    for (uint32_t c = 0; c < 3u; ++c)
+    {
+        const double mean = sum[c] / n;
+        var[c] = sq[c] / n - mean * mean;
+        if (var[c] >= min_var)
+            varying++;
+    }
+    if (varying < 2u)
+        return false;
 
-            uint8_t *d = dst + ((size_t)y * (size_t)dw + (size_t)x) * (size_t)channels;
-            for (uint32_t c = 0; c < channels; ++c)
-            {
-                uint32_t sum = (uint32_t)p00[c] + (uint32_t)p10[c] + (uint32_t)p01[c] + (uint32_t)p11[c];
-                d[c] = (uint8_t)((sum + 2u) / 4u);
-            }
-        }
+    static const uint32_t pairs[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    for (uint32_t k = 0; k < 3u; ++k)
+    {
+        const uint32_t a = pairs[k][0];
+        const uint32_t b = pairs[k][1];
+        if (var[a] < min_var || var[b] < min_var)
+            continue;
+        const double cov = cross[k] / n - (sum[a] / n) * (sum[b] / n);
+        const double corr = cov / sqrt(var[a] * var[b]);
+        if (corr > MIPS_PACKED_MASK_MAX_CORR || corr < -MIPS_PACKED_MASK_MAX_CORR)
+            return false;
     }
+    return true;
 }
 
-static void downsample_box_f32(float *dst, uint32_t dw, uint32_t dh, const float *src, uint32_t sw, uint32_t sh, uint32_t channels)
+static uint64_t mips_paged_bytes(const asset_image_mip_chain_t *m)
 {
-    for (uint32_t y = 0; y < dh; ++y)
+    uint64_t n = 0;
+    for (uint32_t i = 0; i < m->mip_count; ++i)
     {
-        uint32_t sy0 = clamp_u32(y * 2u + 0u, 0u, sh ? (sh - 1u) : 0u);
-        uint32_t sy1 = clamp_u32(y * 2u + 1u, 0u, sh ? (sh - 1u) : 0u);
-        for (uint32_t x = 0; x < dw; ++x)
-        {
-            uint32_t sx0 = clamp_u32(x * 2u + 0u, 0u, sw ? (sw - 1u) : 0u);
-            uint32_t sx1 = clamp_u32(x * 2u + 1u, 0u, sw ? (sw - 1u) : 0u);
-
-            const float *p00 = src + ((size_t)sy0 * (size_t)sw + (size_t)sx0) * (size_t)channels;
-            const float *p10 = src + ((size_t)sy0 * (size_t)sw + (size_t)sx1) * (size_t)channels;
-            const float *p01 = src + ((size_t)sy1 * (size_t)sw + (size_t)sx0) * (size_t)channels;
-            const float *p11 = src + ((size_t)sy1 * (size_t)sw + (size_t)sx1) * (size_t)channels;
-
-            float *d = dst + ((size_t)y * (size_t)dw + (size_t)x) * (size_t)channels;
-            for (uint32_t c = 0; c < channels; ++c)
-            {
-                d[c] = 0.25f * (p00[c] + p10[c] + p01[c] + p11[c]);
-            }
-        }
+        if (m->paged_mask & (1u << i))
+            n += m->size[i];
     }
+    return n;
 }
 
 static bool mips_alloc(asset_image_mip_chain_t **out, uint32_t mip_count, uint32_t bytes_per_pixel)
@@ -94,6 +143,26 @@ static bool mips_alloc(asset_image_mip_chain_t **out, uint32_t mip_count, uint32
     return true;
 }
 
+static void mips_layout(asset_image_mip_chain_t *m, uint32_t w, uint32_t h)
+{
+    uint64_t off = 0;
+    for (uint32_t i = 0; i < m->mip_count; ++i)
+    {
+        const uint64_t sz = m->bc_format ? (uint64_t)((w + 3u) / 4u) * (uint64_t)((h + 3u) / 4u) * (uint64_t)m->bytes_per_pixel
+                                         : (uint64_t)w * (uint64_t)h * (uint64_t)m->bytes_per_pixel;
+        m->width[i] = w;
+        m->height[i] = h;
+        m->offset[i] = off;
+        m->size[i] = sz;
+        off += sz;
+        if (w > 1u)
+            w >>= 1u;
+        if (h > 1u)
+            h >>= 1u;
+    }
+    m->total_size = off;
+}
+
 static bool mips_alloc_data(asset_image_mip_chain_t *m)
 {
     if (!m || m->total_size == 0)
@@ -101,10 +170,78 @@ static bool mips_alloc_data(asset_image_mip_chain_t *m)
     m->data = (uint8_t *)malloc((size_t)m->total_size);
     if (!m->data)
         return false;
+    for (uint32_t i = 0; i < m->mip_count; ++i)
+        m->level[i] = m->data + (size_t)m->offset[i];
+    m->resident_first = 0;
+    m->ram_bytes = m->total_size;
+    return true;
+}
+
+typedef struct mips_level_ctx_t
+{
+    asset_image_mip_chain_t *m;
+    const void *base;
+    uint32_t level;
+    uint32_t channels;
+    uint32_t filter;
+    uint32_t flags;
+    uint32_t is_f32;
+    volatile uint32_t failed;
+} mips_level_ctx_t;
+
+static void mips_level_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    (void)worker_index;
+    mips_level_ctx_t *ctx = (mips_level_ctx_t *)user;
+    asset_image_mip_chain_t *m = ctx->m;
+    const uint32_t i = ctx->level;
+    uint8_t *dst = m->data + (size_t)m->offset[i];
+
+    if (i == 0)
+    {
+        const size_t row = (size_t)m->width[0] * m->bytes_per_pixel;
+        memcpy(dst + (size_t)begin * row, (const uint8_t *)ctx->base + (size_t)begin * row, (size_t)(end - begin) * row);
+        return;
+    }
+
+    const uint8_t *src = m->data + (size_t)m->offset[i - 1u];
+    const uint32_t sw = m->width[i - 1u];
+    const uint32_t sh = m->height[i - 1u];
+    const bool ok = ctx->is_f32 ? asset_image_downsample_f32_rows((float *)(void *)dst, (const float *)(const void *)src, sw, sh, ctx->channels, ctx->filter, begin, end)
+                                : asset_image_downsample_u8_rows(dst, src, sw, sh, ctx->channels, ctx->filter, ctx->flags, begin, end);
+    if (!ok)
+        atomic_store_u32(&ctx->failed, 1u);
+}
+
+// Copies the base in and downsamples level by level. Each level is split into row ranges on the job
+// system; small levels stay on the calling thread. The ranges are disjoint and every destination row
+// depends only on the finished level above it, so the chain is the same as a single-threaded build.
+static bool mips_fill(asset_image_mip_chain_t *m, const void *base, uint32_t channels, uint32_t filter, uint32_t flags, uint32_t is_f32)
+{
+    mips_level_ctx_t ctx;
+    ctx.m = m;
+    ctx.base = base;
+    ctx.channels = channels;
+    ctx.filter = filter;
+    ctx.flags = flags;
+    ctx.is_f32 = is_f32;
+    ctx.failed = 0;
+
+    for (uint32_t i = 0; i < m->mip_count; ++i)
+    {
+        const uint32_t w = m->width[i];
+        uint32_t grain = w >= MIPS_RANGE_PIXELS ? 1u : MIPS_RANGE_PIXELS / w;
+        if (i > 0 && filter != ASSET_IMAGE_MIP_FILTER_BOX && grain < MIPS_WINDOWED_ROWS)
+            grain = MIPS_WINDOWED_ROWS;
+        ctx.level = i;
+        jobs_parallel_for(m->height[i], grain, mips_level_range, &ctx);
+        if (atomic_load_u32(&ctx.failed))
+            return false;
+    }
     return true;
 }
 
-bool asset_image_mips_build_u8(asset_image_mip_chain_t **out, const uint8_t *base, uint32_t w, uint32_t h, uint32_t channels)
+bool asset_image_mips_build_u8(asset_image_mip_chain_t **out, const uint8_t *base, uint32_t w, uint32_t h, uint32_t channels, uint32_t filter, uint32_t flags)
 {
     if (out)
         *out = NULL;
@@ -114,29 +251,11 @@ bool asset_image_mips_build_u8(asset_image_mip_chain_t **out, const uint8_t *bas
         return false;
 
     const uint32_t mip_count = image_mip_count(w, h);
-    const uint32_t bpp = channels;
 
     asset_image_mip_chain_t *m = NULL;
-    if (!mips_alloc(&m, mip_count, bpp))
+    if (!mips_alloc(&m, mip_count, channels))
         return false;
-
-    uint64_t off = 0;
-    uint32_t mw = w;
-    uint32_t mh = h;
-    for (uint32_t i = 0; i < mip_count; ++i)
-    {
-        uint64_t sz = (uint64_t)mw * (uint64_t)mh * (uint64_t)bpp;
-        m->width[i] = mw;
-        m->height[i] = mh;
-        m->offset[i] = off;
-        m->size[i] = sz;
-        off += sz;
-        if (mw > 1u)
-            mw >>= 1u;
-        if (mh > 1u)
-            mh >>= 1u;
-    }
-    m->total_size = off;
+    mips_layout(m, w, h);
 
     if (!mips_alloc_data(m))
     {
@@ -144,20 +263,21 @@ bool asset_image_mips_build_u8(asset_image_mip_chain_t **out, const uint8_t *bas
         return false;
     }
 
-    memcpy(m->data + (size_t)m->offset[0], base, (size_t)m->size[0]);
+    if ((flags & ASSET_IMAGE_MIP_SRGB) && !(flags & ASSET_IMAGE_MIP_COLOR_KNOWN) &&
+        (asset_image_looks_like_normal_map(base, w, h, channels) || asset_image_looks_like_packed_mask(base, w, h, channels)))
+        flags &= ~ASSET_IMAGE_MIP_SRGB;
 
-    for (uint32_t i = 1; i < mip_count; ++i)
+    if (!mips_fill(m, base, channels, filter, flags, 0u))
     {
-        const uint8_t *src = m->data + (size_t)m->offset[i - 1u];
-        uint8_t *dst = m->data + (size_t)m->offset[i];
-        downsample_box_u8(dst, m->width[i], m->height[i], src, m->width[i - 1u], m->height[i - 1u], channels);
+        asset_image_mips_free(m);
+        return false;
     }
 
     *out = m;
     return true;
 }
 
-bool asset_image_mips_build_f32(asset_image_mip_chain_t **out, const float *base, uint32_t w, uint32_t h, uint32_t channels)
+bool asset_image_mips_build_f32(asset_image_mip_chain_t **out, const float *base, uint32_t w, uint32_t h, uint32_t channels, uint32_t filter)
 {
     if (out)
         *out = NULL;
@@ -167,53 +287,140 @@ bool asset_image_mips_build_f32(asset_image_mip_chain_t **out, const float *base
         return false;
 
     const uint32_t mip_count = image_mip_count(w, h);
-    const uint32_t bpp = channels * 4u;
 
     asset_image_mip_chain_t *m = NULL;
-    if (!mips_alloc(&m, mip_count, bpp))
+    if (!mips_alloc(&m, mip_count, channels * 4u))
         return false;
+    mips_layout(m, w, h);
 
-    uint64_t off = 0;
-    uint32_t mw = w;
-    uint32_t mh = h;
-    for (uint32_t i = 0; i < mip_count; ++i)
+    if (!mips_alloc_data(m))
     {
-        uint64_t sz = (uint64_t)mw * (uint64_t)mh * (uint64_t)bpp;
-        m->width[i] = mw;
-        m->height[i] = mh;
-        m->offset[i] = off;
-        m->size[i] = sz;
-        off += sz;
-        if (mw > 1u)
-            mw >>= 1u;
-        if (mh > 1u)
-            mh >>= 1u;
+        asset_image_mips_free(m);
+        return false;
     }
-    m->total_size = off;
 
-    if (!mips_alloc_data(m))
+    if (!mips_fill(m, base, channels, filter, 0u, 1u))
     {
         asset_image_mips_free(m);
         return false;
     }
 
-    memcpy(m->data + (size_t)m->offset[0], base, (size_t)m->size[0]);
+    *out = m;
+    return true;
+}
+
+bool asset_image_mips_alloc(asset_image_mip_chain_t **out, uint32_t w, uint32_t h, uint32_t bytes_per_pixel, uint32_t bc_format, uint32_t resident_first)
+{
+    if (out)
+        *out = NULL;
+    if (!out || w == 0 || h == 0)
+        return false;
 
-    for (uint32_t i = 1; i < mip_count; ++i)
+    asset_image_mip_chain_t *m = NULL;
+    if (!mips_alloc(&m, image_mip_count(w, h), bytes_per_pixel))
+        return false;
+    m->bc_format = bc_format;
+    mips_layout(m, w, h);
+
+    if (resident_first >= m->mip_count)
+        resident_first = m->mip_count - 1u;
+
+    const uint64_t base = m->offset[resident_first];
+    const uint64_t kept = m->total_size - base;
+    m->data = (uint8_t *)malloc((size_t)kept);
+    if (!m->data)
     {
-        const float *src = (const float *)(const void *)(m->data + (size_t)m->offset[i - 1u]);
-        float *dst = (float *)(void *)(m->data + (size_t)m->offset[i]);
-        downsample_box_f32(dst, m->width[i], m->height[i], src, m->width[i - 1u], m->height[i - 1u], channels);
+        free(m);
+        return false;
     }
+    for (uint32_t i = resident_first; i < m->mip_count; ++i)
+        m->level[i] = m->data + (size_t)(m->offset[i] - base);
+    m->resident_first = resident_first;
+    m->ram_bytes = kept;
 
     *out = m;
     return true;
 }
 
+bool asset_image_mips_trim(asset_image_mip_chain_t *m, uint32_t keep_first)
+{
+    if (!m || !m->data || keep_first >= m->mip_count)
+        return false;
+    if (keep_first <= m->resident_first)
+        return true;
+
+    const uint64_t base = m->offset[keep_first];
+    const uint64_t kept = m->total_size - base;
+
+    uint8_t *block = (uint8_t *)malloc((size_t)kept);
+    if (!block)
+        return false;
+    memcpy(block, m->level[keep_first], (size_t)kept);
+
+    for (uint32_t i = m->resident_first; i < m->mip_count; ++i)
+        m->level[i] = (i >= keep_first) ? block + (size_t)(m->offset[i] - base) : NULL;
+    free(m->data);
+    m->data = block;
+    m->ram_bytes = kept + mips_paged_bytes(m);
+    m->resident_first = keep_first;
+    return true;
+}
+
+bool asset_image_mips_extract(const asset_image_mip_chain_t *src, const asset_image_mip_chain_t *layout, uint32_t first, uint32_t last, uint8_t **out_levels)
+{
+    if (!src || !layout || !out_levels || first > last || last >= layout->mip_count)
+        return false;
+    if (src->mip_count != layout->mip_count || src->bytes_per_pixel != layout->bytes_per_pixel || src->bc_format != layout->bc_format ||
+        src->width[0] != layout->width[0] || src->height[0] != layout->height[0])
+        return false;
+
+    for (uint32_t i = first; i <= last; ++i)
+    {
+        out_levels[i] = src->level[i] ? (uint8_t *)malloc((size_t)src->size[i]) : NULL;
+        if (!out_levels[i])
+        {
+            for (uint32_t k = first; k <= i; ++k)
+            {
+                free(out_levels[k]);
+                out_levels[k] = NULL;
+            }
+            return false;
+        }
+        memcpy(out_levels[i], src->level[i], (size_t)src->size[i]);
+    }
+    return true;
+}
+
+void asset_image_mips_adopt_level(asset_image_mip_chain_t *m, uint32_t mip, uint8_t *pixels)
+{
+    if (!m || mip >= m->resident_first || !pixels)
+    {
+        free(pixels);
+        return;
+    }
+    asset_image_mips_drop_level(m, mip);
+    m->level[mip] = pixels;
+    m->paged_mask |= 1u << mip;
+    m->ram_bytes += m->size[mip];
+}
+
+uint64_t asset_image_mips_drop_level(asset_image_mip_chain_t *m, uint32_t mip)
+{
+    if (!m || mip >= m->mip_count || !(m->paged_mask & (1u << mip)))
+        return 0;
+    free(m->level[mip]);
+    m->level[mip] = NULL;
+    m->paged_mask &= ~(1u << mip);
+    m->ram_bytes -= m->size[mip];
+    return m->size[mip];
+}
+
 void asset_image_mips_free(asset_image_mip_chain_t *mips)
 {
     if (!mips)
         return;
+    for (uint32_t i = 0; i < mips->mip_count; ++i)
+        asset_image_mips_drop_level(mips, i);
     free(mips->data);
     mips->data = NULL;
     free(mips);
@@ -3,11 +3,39 @@
 #include <stdbool.h>
 
 #include "asset_manager/asset_types/image.h"
+#include "image_resample.h"
 
 // Builds a full mip chain from a decoded base level. Returned chain owns `data` and must be freed.
-// Note: `out->data` uses tightly packed rows (no padding).
-bool asset_image_mips_build_u8(asset_image_mip_chain_t **out, const uint8_t *base_rgba, uint32_t w, uint32_t h, uint32_t channels);
-bool asset_image_mips_build_f32(asset_image_mip_chain_t **out, const float *base_rgb, uint32_t w, uint32_t h, uint32_t channels);
+// Note: `out->data` uses tightly packed rows (no padding); out->level[i] points at each level.
+// `filter` is an asset_image_mip_filter_t. Unless ASSET_IMAGE_MIP_COLOR_KNOWN is set, ASSET_IMAGE_MIP_SRGB
+// is dropped for images that look like tangent-space normal maps or packed masks, which hold vectors
+// and data rather than color.
+bool asset_image_mips_build_u8(asset_image_mip_chain_t **out, const uint8_t *base_rgba, uint32_t w, uint32_t h, uint32_t channels, uint32_t filter, uint32_t flags);
+bool asset_image_mips_build_f32(asset_image_mip_chain_t **out, const float *base_rgb, uint32_t w, uint32_t h, uint32_t channels, uint32_t filter);
+
+// Samples up to a few thousand texels of an 8-bit image with at least 3 channels.
+bool asset_image_looks_like_normal_map(const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels);
+// Same sampling; true when R, G and B vary independently of each other, as in packed occlusion /
+// roughness / metalness (ORM, ARM) maps. Normal maps match too, so test for those first.
+bool asset_image_looks_like_packed_mask(const uint8_t *pixels, uint32_t w, uint32_t h, uint32_t channels);
+
+// Lays out the chain of a w x h image like the build functions, but only allocates levels
+// [resident_first, mip_count), as if trimmed. The caller fills them in, e.g. from stored mips.
+// With a bc_format, bytes_per_pixel is the block size and levels hold ceil(w/4) x ceil(h/4) blocks.
+bool asset_image_mips_alloc(asset_image_mip_chain_t **out, uint32_t w, uint32_t h, uint32_t bytes_per_pixel, uint32_t bc_format, uint32_t resident_first);
+
+// Keeps levels [keep_first, mip_count) in a compacted block and releases the sharper ones, which the
+// streamer pages back in from disk when it needs them. False (chain unchanged) on OOM.
+bool asset_image_mips_trim(asset_image_mip_chain_t *m, uint32_t keep_first);
+
+// Copies levels [first, last] of a freshly built chain into separate allocations for a trimmed
+// chain with the same layout. False if the layouts differ, e.g. the file changed on disk.
+bool asset_image_mips_extract(const asset_image_mip_chain_t *src, const asset_image_mip_chain_t *layout, uint32_t first, uint32_t last, uint8_t **out_levels);
+
+// Takes ownership of a paged-in level (freed right away if the chain already keeps it in `data`).
+void asset_image_mips_adopt_level(asset_image_mip_chain_t *m, uint32_t mip, uint8_t *pixels);
+// Frees a paged-in level and returns its size; levels in `data` are never dropped.
+uint64_t asset_image_mips_drop_level(asset_image_mip_chain_t *m, uint32_t mip);
 
 void asset_image_mips_free(asset_image_mip_chain_t *mips);
 
@@ -0,0 +1,926 @@
+#include "image_resample.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/threads.h"
+
+// The SIMD kernels promise the scalar reference's results bit for bit, which only holds if neither
+// side gets its multiplies and adds fused behind our back.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#define RESAMPLE_X86 1
+#else
+#define RESAMPLE_X86 0
+#endif
+
+#if RESAMPLE_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define RESAMPLE_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define RESAMPLE_SSE2 0
+#endif
+
+// AVX2 kernels are built into every x86 binary and only run when cpuid reports AVX2.
+#if RESAMPLE_SSE2 && (defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__))
+#define RESAMPLE_AVX2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#define RESAMPLE_TARGET_AVX2
+#else
+#define RESAMPLE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define RESAMPLE_AVX2 0
+#endif
+
+// AArch64 only: 32-bit NEON flushes denormals, which the scalar path does not.
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define RESAMPLE_NEON 1
+#include <arm_neon.h>
+#else
+#define RESAMPLE_NEON 0
+#endif
+
+// 8-bit levels are filtered as floats and quantized to this many linear steps before the encode
+// table; 14 bits keep every sRGB byte distinct in the darks, so flat areas round-trip exactly.
+#define RESAMPLE_ENCODE_BITS 14u
+#define RESAMPLE_ENCODE_SIZE (1u << RESAMPLE_ENCODE_BITS)
+
+#define RESAMPLE_MAX_TAPS 12u
+// Windowed filters reach 3 destination pixels (6 source pixels) each side of the center.
+#define RESAMPLE_WINDOW_RADIUS 3.0
+#define RESAMPLE_KAISER_ALPHA 4.0
+
+typedef struct resample_kernels_t
+{
+    // 2x2 average of float rows r0 and r1: ((r0[a] + r1[a]) + (r0[b] + r1[b])) * 0.25 per channel.
+    void (*box)(float *out, const float *r0, const float *r1, uint32_t dw, uint32_t sw, uint32_t channels);
+    // out[x] = sum_t w[t] * in[2x + t], per channel; `in` may be read up to 4 floats past the last tap.
+    void (*hconv)(float *out, const float *in, uint32_t dw, uint32_t channels, const float *w, uint32_t taps);
+    // out[i] = sum_t w[t] * rows[t][i], clamped at 0 when asked.
+    void (*vconv)(float *out, const float *const *rows, const float *w, uint32_t taps, size_t n, uint32_t clamp);
+    // out[i] = round(clamp(in[i], 0, 1) * (RESAMPLE_ENCODE_SIZE - 1)).
+    void (*quantize)(int32_t *out, const float *in, size_t n);
+} resample_kernels_t;
+
+typedef struct resample_filter_t
+{
+    uint32_t taps;
+    int32_t origin; // first source pixel of destination pixel 0
+    float w[RESAMPLE_MAX_TAPS];
+} resample_filter_t;
+
+static volatile uint32_t g_resample_state; // 0 = not set up, 1 = being set up, 2 = ready
+static volatile uint32_t g_resample_isa;
+static float g_resample_decode_srgb[256];
+static float g_resample_decode_unorm[256];
+// The same, in encode-table steps, for the 8-bit box filter.
+static uint16_t g_resample_decode16_srgb[256];
+static uint16_t g_resample_decode16_unorm[256];
+static uint8_t g_resample_encode_srgb[RESAMPLE_ENCODE_SIZE];
+static uint8_t g_resample_encode_unorm[RESAMPLE_ENCODE_SIZE];
+static resample_filter_t g_resample_filters[ASSET_IMAGE_MIP_FILTER_COUNT]; // box has its own kernels
+
+static void resample_box_scalar(float *out, const float *r0, const float *r1, uint32_t dw, uint32_t sw, uint32_t channels)
+{
+    const size_t step = sw > 1u ? channels : 0u;
+    for (uint32_t x = 0; x < dw; ++x)
+    {
+        const size_t a = (size_t)x * 2u * channels;
+        for (uint32_t c = 0; c < channels; ++c)
+            out[(size_t)x * channels + c] = ((r0[a + c] + r1[a + c]) + (r0[a + c + step] + r1[a + c + step])) * 0.25f;
+    }
+}
+
+static void resample_hconv_scalar(float *out, const float *in, uint32_t dw, uint32_t channels, const float *w, uint32_t taps)
+{
+    for (uint32_t x = 0; x < dw; ++x)
+    {
+        const float *s = in + (size_t)x * 2u * channels;
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            float acc = w[0] * s[c];
+            for (uint32_t t = 1; t < taps; ++t)
+                acc += w[t] * s[(size_t)t * channels + c];
+            out[(size_t)x * channels + c] = acc;
+        }
+    }
+}
+
+static void resample_vconv_range(float *out, const float *const *rows, const float *w, uint32_t taps, size_t begin, size_t end, uint32_t clamp)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        float acc = w[0] * rows[0][i];
+        for (uint32_t t = 1; t < taps; ++t)
+            acc += w[t] * rows[t][i];
+        if (clamp)
+            acc = acc > 0.0f ? acc : 0.0f;
+        out[i] = acc;
+    }
+}
+
+static void resample_vconv_scalar(float *out, const float *const *rows, const float *w, uint32_t taps, size_t n, uint32_t clamp)
+{
+    resample_vconv_range(out, rows, w, taps, 0, n, clamp);
+}
+
+static void resample_quantize_scalar(int32_t *out, const float *in, size_t n)
+{
+    const float scale = (float)(RESAMPLE_ENCODE_SIZE - 1u);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v = in[i];
+        v = v > 0.0f ? v : 0.0f;
+        v = v < 1.0f ? v : 1.0f;
+        out[i] = (int32_t)(v * scale + 0.5f);
+    }
+}
+
+#if RESAMPLE_SSE2
+static void resample_box_sse2(float *out, const float *r0, const float *r1, uint32_t dw, uint32_t sw, uint32_t channels)
+{
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    uint32_t x = 0;
+    if (sw >= 2u && channels == 1u)
+    {
+        for (; x + 4u <= dw; x += 4u)
+        {
+            const __m128 lo = _mm_add_ps(_mm_loadu_ps(r0 + 2u * x), _mm_loadu_ps(r1 + 2u * x));
+            const __m128 hi = _mm_add_ps(_mm_loadu_ps(r0 + 2u * x + 4u), _mm_loadu_ps(r1 + 2u * x + 4u));
+            const __m128 even = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 odd = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(out + x, _mm_mul_ps(_mm_add_ps(even, odd), quarter));
+        }
+    }
+    else if (sw >= 2u)
+    {
+        // RGB stores a junk fourth lane that the next pixel overwrites, so the last one is scalar.
+        const uint32_t n = channels == 4u ? dw : dw - 1u;
+        for (; x < n; ++x)
+        {
+            const size_t a = (size_t)x * 2u * channels;
+            const __m128 p = _mm_add_ps(_mm_loadu_ps(r0 + a), _mm_loadu_ps(r1 + a));
+            const __m128 q = _mm_add_ps(_mm_loadu_ps(r0 + a + channels), _mm_loadu_ps(r1 + a + channels));
+            _mm_storeu_ps(out + (size_t)x * channels, _mm_mul_ps(_mm_add_ps(p, q), quarter));
+        }
+    }
+    resample_box_scalar(out + (size_t)x * channels, r0 + (size_t)x * 2u * channels, r1 + (size_t)x * 2u * channels, dw - x, sw, channels);
+}
+
+static void resample_hconv_sse2(float *out, const float *in, uint32_t dw, uint32_t channels, const float *w, uint32_t taps)
+{
+    __m128 wv[RESAMPLE_MAX_TAPS];
+    for (uint32_t t = 0; t < taps; ++t)
+        wv[t] = _mm_set1_ps(w[t]);
+
+    if (channels == 1u)
+    {
+        // Four destination pixels at a time; their taps are the even floats of 8 in a row.
+        uint32_t x = 0;
+        for (; x + 4u <= dw; x += 4u)
+        {
+            const float *s = in + (size_t)x * 2u;
+            __m128 acc = _mm_mul_ps(wv[0], _mm_shuffle_ps(_mm_loadu_ps(s), _mm_loadu_ps(s + 4), _MM_SHUFFLE(2, 0, 2, 0)));
+            for (uint32_t t = 1; t < taps; ++t)
+            {
+                const __m128 v = _mm_shuffle_ps(_mm_loadu_ps(s + t), _mm_loadu_ps(s + t + 4), _MM_SHUFFLE(2, 0, 2, 0));
+                acc = _mm_add_ps(acc, _mm_mul_ps(wv[t], v));
+            }
+            _mm_storeu_ps(out + x, acc);
+        }
+        resample_hconv_scalar(out + x, in + (size_t)x * 2u, dw - x, 1u, w, taps);
+        return;
+    }
+
+    // One pixel per register. RGB rows carry a junk fourth lane that the next pixel overwrites;
+    // the last one is left to the scalar loop so nothing lands past the row.
+    const uint32_t n = channels == 4u ? dw : (dw ? dw - 1u : 0u);
+    for (uint32_t x = 0; x < n; ++x)
+    {
+        const float *s = in + (size_t)x * 2u * channels;
+        __m128 acc = _mm_mul_ps(wv[0], _mm_loadu_ps(s));
+        for (uint32_t t = 1; t < taps; ++t)
+            acc = _mm_add_ps(acc, _mm_mul_ps(wv[t], _mm_loadu_ps(s + (size_t)t * channels)));
+        _mm_storeu_ps(out + (size_t)x * channels, acc);
+    }
+    resample_hconv_scalar(out + (size_t)n * channels, in + (size_t)n * 2u * channels, dw - n, channels, w, taps);
+}
+
+static void resample_vconv_sse2(float *out, const float *const *rows, const float *w, uint32_t taps, size_t n, uint32_t clamp)
+{
+    __m128 wv[RESAMPLE_MAX_TAPS];
+    for (uint32_t t = 0; t < taps; ++t)
+        wv[t] = _mm_set1_ps(w[t]);
+
+    const __m128 zero = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4u <= n; i += 4u)
+    {
+        __m128 acc = _mm_mul_ps(wv[0], _mm_loadu_ps(rows[0] + i));
+        for (uint32_t t = 1; t < taps; ++t)
+            acc = _mm_add_ps(acc, _mm_mul_ps(wv[t], _mm_loadu_ps(rows[t] + i)));
+        // maxps returns the second operand for NaN and -0, matching the scalar compare.
+        if (clamp)
+            acc = _mm_max_ps(acc, zero);
+        _mm_storeu_ps(out + i, acc);
+    }
+    resample_vconv_range(out, rows, w, taps, i, n, clamp);
+}
+
+static void resample_quantize_sse2(int32_t *out, const float *in, size_t n)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps((float)(RESAMPLE_ENCODE_SIZE - 1u));
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 4u <= n; i += 4u)
+    {
+        __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), zero), one);
+        _mm_storeu_si128((__m128i *)(void *)(out + i), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half)));
+    }
+    resample_quantize_scalar(out + i, in + i, n - i);
+}
+#endif
+
+#if RESAMPLE_AVX2
+RESAMPLE_TARGET_AVX2 static void resample_box_avx2(float *out, const float *r0, const float *r1, uint32_t dw, uint32_t sw, uint32_t channels)
+{
+    if (sw < 2u || channels == 3u)
+    {
+        resample_box_sse2(out, r0, r1, dw, sw, channels);
+        return;
+    }
+
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    uint32_t x = 0;
+    if (channels == 1u)
+    {
+        for (; x + 8u <= dw; x += 8u)
+        {
+            const __m256 lo = _mm256_add_ps(_mm256_loadu_ps(r0 + 2u * x), _mm256_loadu_ps(r1 + 2u * x));
+            const __m256 hi = _mm256_add_ps(_mm256_loadu_ps(r0 + 2u * x + 8u), _mm256_loadu_ps(r1 + 2u * x + 8u));
+            const __m256 sum = _mm256_add_ps(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)), _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+            const __m256 v = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm256_storeu_ps(out + x, _mm256_mul_ps(v, quarter));
+        }
+    }
+    else
+    {
+        // Two RGBA pixels per register: regroup sums of pixels (0 1) (2 3) into (0 2) (1 3).
+        for (; x + 2u <= dw; x += 2u)
+        {
+            const __m256 p = _mm256_add_ps(_mm256_loadu_ps(r0 + 8u * x), _mm256_loadu_ps(r1 + 8u * x));
+            const __m256 q = _mm256_add_ps(_mm256_loadu_ps(r0 + 8u * x + 8u), _mm256_loadu_ps(r1 + 8u * x + 8u));
+            const __m256 sum = _mm256_add_ps(_mm256_permute2f128_ps(p, q, 0x20), _mm256_permute2f128_ps(p, q, 0x31));
+            _mm256_storeu_ps(out + 4u * x, _mm256_mul_ps(sum, quarter));
+        }
+    }
+    resample_box_scalar(out + (size_t)x * channels, r0 + (size_t)x * 2u * channels, r1 + (size_t)x * 2u * channels, dw - x, sw, channels);
+}
+
+RESAMPLE_TARGET_AVX2 static void resample_hconv_avx2(float *out, const float *in, uint32_t dw, uint32_t channels, const float *w, uint32_t taps)
+{
+    if (channels == 3u)
+    {
+        resample_hconv_sse2(out, in, dw, channels, w, taps);
+        return;
+    }
+
+    __m256 wv[RESAMPLE_MAX_TAPS];
+    for (uint32_t t = 0; t < taps; ++t)
+        wv[t] = _mm256_set1_ps(w[t]);
+
+    uint32_t x = 0;
+    if (channels == 1u)
+    {
+        // Even floats of 16 in a row; the in-lane shuffle leaves them in 64-bit pairs 0, 2, 1, 3.
+        for (; x + 8u <= dw; x += 8u)
+        {
+            const float *s = in + (size_t)x * 2u;
+            __m256 acc = _mm256_setzero_ps();
+            for (uint32_t t = 0; t < taps; ++t)
+            {
+                const __m256 e = _mm256_shuffle_ps(_mm256_loadu_ps(s + t), _mm256_loadu_ps(s + t + 8), _MM_SHUFFLE(2, 0, 2, 0));
+                const __m256 v = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(e), _MM_SHUFFLE(3, 1, 2, 0)));
+                acc = t ? _mm256_add_ps(acc, _mm256_mul_ps(wv[t], v)) : _mm256_mul_ps(wv[0], v);
+            }
+            _mm256_storeu_ps(out + x, acc);
+        }
+    }
+    else
+    {
+        // Two RGBA pixels per register; their taps start 8 floats apart.
+        for (; x + 2u <= dw; x += 2u)
+        {
+            const float *s = in + (size_t)x * 8u;
+            __m256 acc = _mm256_setzero_ps();
+            for (uint32_t t = 0; t < taps; ++t)
+            {
+                const float *p = s + (size_t)t * 4u;
+                const __m256 v = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 8), 1);
+                acc = t ? _mm256_add_ps(acc, _mm256_mul_ps(wv[t], v)) : _mm256_mul_ps(wv[0], v);
+            }
+            _mm256_storeu_ps(out + (size_t)x * 4u, acc);
+        }
+    }
+    resample_hconv_scalar(out + (size_t)x * channels, in + (size_t)x * 2u * channels, dw - x, channels, w, taps);
+}
+
+RESAMPLE_TARGET_AVX2 static void resample_vconv_avx2(float *out, const float *const *rows, const float *w, uint32_t taps, size_t n, uint32_t clamp)
+{
+    __m256 wv[RESAMPLE_MAX_TAPS];
+    for (uint32_t t = 0; t < taps; ++t)
+        wv[t] = _mm256_set1_ps(w[t]);
+
+    const __m256 zero = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8u <= n; i += 8u)
+    {
+        __m256 acc = _mm256_mul_ps(wv[0], _mm256_loadu_ps(rows[0] + i));
+        for (uint32_t t = 1; t < taps; ++t)
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(wv[t], _mm256_loadu_ps(rows[t] + i)));
+        if (clamp)
+            acc = _mm256_max_ps(acc, zero);
+        _mm256_storeu_ps(out + i, acc);
+    }
+    resample_vconv_range(out, rows, w, taps, i, n, clamp);
+}
+
+RESAMPLE_TARGET_AVX2 static void resample_quantize_avx2(int32_t *out, const float *in, size_t n)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps((float)(RESAMPLE_ENCODE_SIZE - 1u));
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 8u <= n; i += 8u)
+    {
+        __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i), zero), one);
+        _mm256_storeu_si256((__m256i *)(void *)(out + i), _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, scale), half)));
+    }
+    resample_quantize_scalar(out + i, in + i, n - i);
+}
+#endif
+
+#if RESAMPLE_NEON
+// vmaxq propagates NaN, so the clamps select on a compare like the scalar code does.
+static inline float32x4_t resample_max0_neon(float32x4_t v)
+{
+    return vbslq_f32(vcgtq_f32(v, vdupq_n_f32(0.0f)), v, vdupq_n_f32(0.0f));
+}
+
+static void resample_box_neon(float *out, const float *r0, const float *r1, uint32_t dw, uint32_t sw, uint32_t channels)
+{
+    uint32_t x = 0;
+    if (sw >= 2u && channels == 1u)
+    {
+        for (; x + 4u <= dw; x += 4u)
+        {
+            const float32x4x2_t a = vld2q_f32(r0 + 2u * x);
+            const float32x4x2_t b = vld2q_f32(r1 + 2u * x);
+            const float32x4_t sum = vaddq_f32(vaddq_f32(a.val[0], b.val[0]), vaddq_f32(a.val[1], b.val[1]));
+            vst1q_f32(out + x, vmulq_n_f32(sum, 0.25f));
+        }
+    }
+    else if (sw >= 2u)
+    {
+        const uint32_t n = channels == 4u ? dw : dw - 1u;
+        for (; x < n; ++x)
+        {
+            const size_t a = (size_t)x * 2u * channels;
+            const float32x4_t p = vaddq_f32(vld1q_f32(r0 + a), vld1q_f32(r1 + a));
+            const float32x4_t q = vaddq_f32(vld1q_f32(r0 + a + channels), vld1q_f32(r1 + a + channels));
+            vst1q_f32(out + (size_t)x * channels, vmulq_n_f32(vaddq_f32(p, q), 0.25f));
+        }
+    }
+    resample_box_scalar(out + (size_t)x * channels, r0 + (size_t)x * 2u * channels, r1 + (size_t)x * 2u * channels, dw - x, sw, channels);
+}
+
+static void resample_hconv_neon(float *out, const float *in, uint32_t dw, uint32_t channels, const float *w, uint32_t taps)
+{
+    uint32_t x = 0;
+    if (channels == 1u)
+    {
+        for (; x + 4u <= dw; x += 4u)
+        {
+            const float *s = in + (size_t)x * 2u;
+            float32x4_t acc = vmulq_n_f32(vld2q_f32(s).val[0], w[0]);
+            for (uint32_t t = 1; t < taps; ++t)
+                acc = vaddq_f32(acc, vmulq_n_f32(vld2q_f32(s + t).val[0], w[t]));
+            vst1q_f32(out + x, acc);
+        }
+    }
+    else
+    {
+        const uint32_t n = channels == 4u ? dw : (dw ? dw - 1u : 0u);
+        for (; x < n; ++x)
+        {
+            const float *s = in + (size_t)x * 2u * channels;
+            float32x4_t acc = vmulq_n_f32(vld1q_f32(s), w[0]);
+            for (uint32_t t = 1; t < taps; ++t)
+                acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(s + (size_t)t * channels), w[t]));
+            vst1q_f32(out + (size_t)x * channels, acc);
+        }
+    }
+    resample_hconv_scalar(out + (size_t)x * channels, in + (size_t)x * 2u * channels, dw - x, channels, w, taps);
+}
+
+static void resample_vconv_neon(float *out, const float *const *rows, const float *w, uint32_t taps, size_t n, uint32_t clamp)
+{
+    size_t i = 0;
+    for (; i + 4u <= n; i += 4u)
+    {
+        float32x4_t acc = vmulq_n_f32(vld1q_f32(rows[0] + i), w[0]);
+        for (uint32_t t = 1; t < taps; ++t)
+            acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(rows[t] + i), w[t]));
+        if (clamp)
+            acc = resample_max0_neon(acc);
+        vst1q_f32(out + i, acc);
+    }
+    resample_vconv_range(out, rows, w, taps, i, n, clamp);
+}
+
+static void resample_quantize_neon(int32_t *out, const float *in, size_t n)
+{
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    size_t i = 0;
+    for (; i + 4u <= n; i += 4u)
+    {
+        float32x4_t v = resample_max0_neon(vld1q_f32(in + i));
+        v = vbslq_f32(vcltq_f32(v, one), v, one);
+        vst1q_s32(out + i, vcvtq_s32_f32(vaddq_f32(vmulq_n_f32(v, (float)(RESAMPLE_ENCODE_SIZE - 1u)), half)));
+    }
+    resample_quantize_scalar(out + i, in + i, n - i);
+}
+#endif
+
+static const resample_kernels_t k_resample_kernels[ASSET_IMAGE_ISA_COUNT] = {
+    {resample_box_scalar, resample_hconv_scalar, resample_vconv_scalar, resample_quantize_scalar},
+#if RESAMPLE_SSE2
+    {resample_box_sse2, resample_hconv_sse2, resample_vconv_sse2, resample_quantize_sse2},
+#else
+    {NULL, NULL, NULL, NULL},
+#endif
+#if RESAMPLE_AVX2
+    {resample_box_avx2, resample_hconv_avx2, resample_vconv_avx2, resample_quantize_avx2},
+#else
+    {NULL, NULL, NULL, NULL},
+#endif
+#if RESAMPLE_NEON
+    {resample_box_neon, resample_hconv_neon, resample_vconv_neon, resample_quantize_neon},
+#else
+    {NULL, NULL, NULL, NULL},
+#endif
+};
+
+static bool resample_cpu_has_avx2(void)
+{
+#if RESAMPLE_AVX2 && defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // OSXSAVE and AVX, and the OS has to save ymm state.
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+        return false;
+    if ((_xgetbv(0) & 6u) != 6u)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif RESAMPLE_AVX2
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+static double resample_sinc(double x)
+{
+    if (fabs(x) < 1e-9)
+        return 1.0;
+    x *= 3.14159265358979323846;
+    return sin(x) / x;
+}
+
+static double resample_bessel_i0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (uint32_t k = 1; k < 32u; ++k)
+    {
+        term *= (x * 0.5 / (double)k) * (x * 0.5 / (double)k);
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+static void resample_setup_filters(void)
+{
+    for (uint32_t f = ASSET_IMAGE_MIP_FILTER_KAISER; f < ASSET_IMAGE_MIP_FILTER_COUNT; ++f)
+    {
+        resample_filter_t *flt = &g_resample_filters[f];
+        flt->taps = RESAMPLE_MAX_TAPS;
+        flt->origin = -(int32_t)(RESAMPLE_MAX_TAPS / 2u - 1u);
+
+        double w[RESAMPLE_MAX_TAPS];
+        double sum = 0.0;
+        for (uint32_t t = 0; t < RESAMPLE_MAX_TAPS; ++t)
+        {
+            // Source pixel center (s + 0.5) to destination pixel center (2x + 1), in destination pixels.
+            const double u = ((double)((int32_t)t + flt->origin) - 0.5) * 0.5;
+            const double r = u / RESAMPLE_WINDOW_RADIUS;
+            double window = 0.0;
+            if (fabs(r) < 1.0)
+            {
+                window = f == ASSET_IMAGE_MIP_FILTER_KAISER ? resample_bessel_i0(RESAMPLE_KAISER_ALPHA * sqrt(1.0 - r * r)) / resample_bessel_i0(RESAMPLE_KAISER_ALPHA)
+                                                            : resample_sinc(r);
+            }
+            w[t] = resample_sinc(u) * window;
+            sum += w[t];
+        }
+        for (uint32_t t = 0; t < RESAMPLE_MAX_TAPS; ++t)
+            flt->w[t] = (float)(w[t] / sum);
+    }
+}
+
+static double resample_srgb_to_linear(double v)
+{
+    return v <= 0.04045 ? v / 12.92 : pow((v + 0.055) / 1.055, 2.4);
+}
+
+static double resample_linear_to_srgb(double v)
+{
+    return v <= 0.0031308 ? v * 12.92 : 1.055 * pow(v, 1.0 / 2.4) - 0.055;
+}
+
+static void resample_setup_tables(void)
+{
+    for (uint32_t i = 0; i < 256u; ++i)
+    {
+        g_resample_decode_srgb[i] = (float)resample_srgb_to_linear((double)i / 255.0);
+        g_resample_decode_unorm[i] = (float)i / 255.0f;
+        g_resample_decode16_srgb[i] = (uint16_t)floor(resample_srgb_to_linear((double)i / 255.0) * (double)(RESAMPLE_ENCODE_SIZE - 1u) + 0.5);
+        g_resample_decode16_unorm[i] = (uint16_t)floor((double)i / 255.0 * (double)(RESAMPLE_ENCODE_SIZE - 1u) + 0.5);
+    }
+    for (uint32_t i = 0; i < RESAMPLE_ENCODE_SIZE; ++i)
+    {
+        const double v = (double)i / (double)(RESAMPLE_ENCODE_SIZE - 1u);
+        g_resample_encode_srgb[i] = (uint8_t)floor(resample_linear_to_srgb(v) * 255.0 + 0.5);
+        g_resample_encode_unorm[i] = (uint8_t)floor(v * 255.0 + 0.5);
+    }
+}
+
+static void resample_setup(void)
+{
+    if (atomic_load_u32(&g_resample_state) == 2u)
+        return;
+    if (!atomic_cas_u32(&g_resample_state, 0u, 1u))
+    {
+        while (atomic_load_u32(&g_resample_state) != 2u)
+            threads_yield();
+        return;
+    }
+
+    resample_setup_filters();
+    resample_setup_tables();
+
+    uint32_t isa = ASSET_IMAGE_ISA_SCALAR;
+    if (RESAMPLE_NEON)
+        isa = ASSET_IMAGE_ISA_NEON;
+    if (RESAMPLE_SSE2)
+        isa = ASSET_IMAGE_ISA_SSE2;
+    if (RESAMPLE_AVX2 && resample_cpu_has_avx2())
+        isa = ASSET_IMAGE_ISA_AVX2;
+    atomic_store_u32(&g_resample_isa, isa);
+    atomic_store_u32(&g_resample_state, 2u);
+}
+
+uint32_t asset_image_resample_isa(void)
+{
+    resample_setup();
+    return atomic_load_u32(&g_resample_isa);
+}
+
+const char *asset_image_resample_isa_name(uint32_t isa)
+{
+    switch (isa)
+    {
+    case ASSET_IMAGE_ISA_SCALAR:
+        return "scalar";
+    case ASSET_IMAGE_ISA_SSE2:
+        return "SSE2";
+    case ASSET_IMAGE_ISA_AVX2:
+        return "AVX2";
+    case ASSET_IMAGE_ISA_NEON:
+        return "NEON";
+    default:
+        return "?";
+    }
+}
+
+bool asset_image_resample_isa_supported(uint32_t isa)
+{
+    if (isa >= ASSET_IMAGE_ISA_COUNT || !k_resample_kernels[isa].hconv)
+        return false;
+    return isa != ASSET_IMAGE_ISA_AVX2 || resample_cpu_has_avx2();
+}
+
+bool asset_image_resample_set_isa(uint32_t isa)
+{
+    resample_setup();
+    if (!asset_image_resample_isa_supported(isa))
+        return false;
+    atomic_store_u32(&g_resample_isa, isa);
+    return true;
+}
+
+typedef struct resample_ctx_t
+{
+    const resample_kernels_t *k;
+    const resample_filter_t *f;
+    uint32_t sw;
+    uint32_t sh;
+    uint32_t dw;
+    uint32_t dh;
+    uint32_t channels;
+    uint32_t pad; // source pixels replicated past each edge
+
+    const uint8_t *src_u8;
+    const float *src_f32;
+    const float *decode[4];
+
+    float *padded;
+    float *rows; // ring of horizontally filtered rows, one slot per tap
+    size_t row_stride;
+    int32_t slot_row[RESAMPLE_MAX_TAPS];
+} resample_ctx_t;
+
+static void resample_fill_padded(resample_ctx_t *ctx, uint32_t sy)
+{
+    const uint32_t c = ctx->channels;
+    float *row = ctx->padded + (size_t)ctx->pad * c;
+    if (ctx->src_f32)
+    {
+        memcpy(row, ctx->src_f32 + (size_t)sy * ctx->sw * c, sizeof(float) * ctx->sw * c);
+    }
+    else
+    {
+        const uint8_t *s = ctx->src_u8 + (size_t)sy * ctx->sw * c;
+        const size_t n = (size_t)ctx->sw * c;
+        if (c == 4u)
+        {
+            for (size_t i = 0; i < n; i += 4u)
+            {
+                row[i + 0] = ctx->decode[0][s[i + 0]];
+                row[i + 1] = ctx->decode[1][s[i + 1]];
+                row[i + 2] = ctx->decode[2][s[i + 2]];
+                row[i + 3] = ctx->decode[3][s[i + 3]];
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+                row[i] = ctx->decode[i % c][s[i]];
+        }
+    }
+
+    for (uint32_t i = 0; i < ctx->pad; ++i)
+    {
+        memcpy(ctx->padded + (size_t)i * c, row, sizeof(float) * c);
+        memcpy(row + (size_t)(ctx->sw + i) * c, row + (size_t)(ctx->sw - 1u) * c, sizeof(float) * c);
+    }
+}
+
+static const float *resample_row(resample_ctx_t *ctx, int32_t sy)
+{
+    sy = sy < 0 ? 0 : (sy >= (int32_t)ctx->sh ? (int32_t)ctx->sh - 1 : sy);
+
+    // Rows a destination row needs are consecutive once clamped, so they never share a slot.
+    const uint32_t slot = (uint32_t)sy % ctx->f->taps;
+    float *out = ctx->rows + ctx->row_stride * slot;
+    if (ctx->slot_row[slot] != sy)
+    {
+        resample_fill_padded(ctx, (uint32_t)sy);
+        const float *in = ctx->padded + (size_t)((int32_t)ctx->pad + ctx->f->origin) * ctx->channels;
+        ctx->k->hconv(out, in, ctx->dw, ctx->channels, ctx->f->w, ctx->f->taps);
+        ctx->slot_row[slot] = sy;
+    }
+    return out;
+}
+
+// Windowed filters only; arguments are checked by the callers.
+static bool resample_begin(resample_ctx_t *ctx, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter)
+{
+    ctx->k = &k_resample_kernels[atomic_load_u32(&g_resample_isa)];
+    ctx->f = &g_resample_filters[filter];
+    ctx->sw = sw;
+    ctx->sh = sh;
+    ctx->dw = sw > 1u ? sw >> 1u : 1u;
+    ctx->dh = sh > 1u ? sh >> 1u : 1u;
+    ctx->channels = channels;
+    ctx->pad = RESAMPLE_MAX_TAPS;
+    for (uint32_t t = 0; t < RESAMPLE_MAX_TAPS; ++t)
+        ctx->slot_row[t] = -1;
+
+    // The SIMD kernels read a few floats past the taps they use and write one past an RGB row.
+    ctx->row_stride = (size_t)ctx->dw * channels + 4u;
+    ctx->padded = (float *)malloc(sizeof(float) * ((size_t)(sw + 2u * ctx->pad) * channels + 16u));
+    ctx->rows = (float *)malloc(sizeof(float) * ctx->row_stride * ctx->f->taps);
+    if (!ctx->padded || !ctx->rows)
+    {
+        free(ctx->padded);
+        free(ctx->rows);
+        return false;
+    }
+    return true;
+}
+
+static void resample_gather_rows(resample_ctx_t *ctx, uint32_t y, const float **rows)
+{
+    const int32_t first = (int32_t)y * 2 + ctx->f->origin;
+    for (uint32_t t = 0; t < ctx->f->taps; ++t)
+        rows[t] = resample_row(ctx, first + (int32_t)t);
+}
+
+// 2x2 average of 8-bit pixels in integers: four table lookups, a sum and one encode lookup per
+// sample. Nothing to vectorize without gathers, and it is several times cheaper than the float path.
+static void resample_box_u8(uint8_t *dst, const uint8_t *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t y0, uint32_t y1, const uint16_t *const *decode, const uint8_t *const *encode)
+{
+    const uint32_t dw = sw > 1u ? sw >> 1u : 1u;
+    const size_t step = sw > 1u ? channels : 0u;
+    const size_t row = (size_t)sw * channels;
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        const uint8_t *r0 = src + (size_t)y * 2u * row;
+        const uint8_t *r1 = sh > 1u ? r0 + row : r0;
+        uint8_t *d = dst + (size_t)y * dw * channels;
+        if (channels == 4u)
+        {
+            for (uint32_t x = 0; x < dw; ++x, r0 += 8, r1 += 8, d += 4)
+            {
+                for (uint32_t c = 0; c < 4u; ++c)
+                {
+                    const uint32_t sum = (uint32_t)decode[c][r0[c]] + decode[c][r0[c + step]] + decode[c][r1[c]] + decode[c][r1[c + step]];
+                    d[c] = encode[c][(sum + 2u) >> 2u];
+                }
+            }
+            continue;
+        }
+        for (uint32_t x = 0; x < dw; ++x, r0 += 2u * channels, r1 += 2u * channels, d += channels)
+        {
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                const uint32_t sum = (uint32_t)decode[c][r0[c]] + decode[c][r0[c + step]] + decode[c][r1[c]] + decode[c][r1[c + step]];
+                d[c] = encode[c][(sum + 2u) >> 2u];
+            }
+        }
+    }
+}
+
+static bool resample_args_ok(const void *dst, const void *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter, uint32_t y0, uint32_t y1)
+{
+    const uint32_t dh = sh > 1u ? sh >> 1u : 1u;
+    return dst && src && sw && sh && (channels == 1u || channels == 3u || channels == 4u) && filter < ASSET_IMAGE_MIP_FILTER_COUNT && y0 <= y1 && y1 <= dh;
+}
+
+bool asset_image_downsample_u8_rows(uint8_t *dst, const uint8_t *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter, uint32_t flags, uint32_t y0, uint32_t y1)
+{
+    if (!resample_args_ok(dst, src, sw, sh, channels, filter, y0, y1))
+        return false;
+    if (y0 == y1)
+        return true;
+    resample_setup();
+
+    const float *decode[4];
+    const uint16_t *decode16[4];
+    const uint8_t *encode[4];
+    for (uint32_t c = 0; c < channels; ++c)
+    {
+        const bool srgb = (flags & ASSET_IMAGE_MIP_SRGB) && channels >= 3u && c < 3u;
+        decode[c] = srgb ? g_resample_decode_srgb : g_resample_decode_unorm;
+        decode16[c] = srgb ? g_resample_decode16_srgb : g_resample_decode16_unorm;
+        encode[c] = srgb ? g_resample_encode_srgb : g_resample_encode_unorm;
+    }
+
+    if (filter == ASSET_IMAGE_MIP_FILTER_BOX)
+    {
+        resample_box_u8(dst, src, sw, sh, channels, y0, y1, decode16, encode);
+        return true;
+    }
+
+    resample_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    if (!resample_begin(&ctx, sw, sh, channels, filter))
+        return false;
+    memcpy(ctx.decode, decode, sizeof(decode));
+    ctx.src_u8 = src;
+
+    const size_t n = (size_t)ctx.dw * channels;
+    float *line = (float *)malloc(sizeof(float) * n);
+    int32_t *idx = (int32_t *)malloc(sizeof(int32_t) * n);
+    if (!line || !idx)
+    {
+        free(line);
+        free(idx);
+        free(ctx.padded);
+        free(ctx.rows);
+        return false;
+    }
+
+    const float *rows[RESAMPLE_MAX_TAPS];
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        resample_gather_rows(&ctx, y, rows);
+        ctx.k->vconv(line, rows, ctx.f->w, ctx.f->taps, n, 0u);
+        ctx.k->quantize(idx, line, n);
+
+        uint8_t *d = dst + (size_t)y * n;
+        if (channels == 4u)
+        {
+            for (size_t i = 0; i < n; i += 4u)
+            {
+                d[i + 0] = encode[0][idx[i + 0]];
+                d[i + 1] = encode[1][idx[i + 1]];
+                d[i + 2] = encode[2][idx[i + 2]];
+                d[i + 3] = encode[3][idx[i + 3]];
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+                d[i] = encode[i % channels][idx[i]];
+        }
+    }
+
+    free(line);
+    free(idx);
+    free(ctx.padded);
+    free(ctx.rows);
+    return true;
+}
+
+bool asset_image_downsample_u8(uint8_t *dst, const uint8_t *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter, uint32_t flags)
+{
+    return asset_image_downsample_u8_rows(dst, src, sw, sh, channels, filter, flags, 0u, sh > 1u ? sh >> 1u : 1u);
+}
+
+bool asset_image_downsample_f32_rows(float *dst, const float *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter, uint32_t y0, uint32_t y1)
+{
+    if (!resample_args_ok(dst, src, sw, sh, channels, filter, y0, y1))
+        return false;
+    if (y0 == y1)
+        return true;
+    resample_setup();
+
+    if (filter == ASSET_IMAGE_MIP_FILTER_BOX)
+    {
+        const resample_kernels_t *k = &k_resample_kernels[atomic_load_u32(&g_resample_isa)];
+        const uint32_t dw = sw > 1u ? sw >> 1u : 1u;
+        const size_t row = (size_t)sw * channels;
+        for (uint32_t y = y0; y < y1; ++y)
+        {
+            const float *r0 = src + (size_t)y * 2u * row;
+            k->box(dst + (size_t)y * dw * channels, r0, sh > 1u ? r0 + row : r0, dw, sw, channels);
+        }
+        return true;
+    }
+
+    resample_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    if (!resample_begin(&ctx, sw, sh, channels, filter))
+        return false;
+    ctx.src_f32 = src;
+
+    const size_t n = (size_t)ctx.dw * channels;
+    const float *rows[RESAMPLE_MAX_TAPS];
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        resample_gather_rows(&ctx, y, rows);
+        ctx.k->vconv(dst + (size_t)y * n, rows, ctx.f->w, ctx.f->taps, n, 1u);
+    }
+
+    free(ctx.padded);
+    free(ctx.rows);
+    return true;
+}
+
+bool asset_image_downsample_f32(float *dst, const float *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter)
+{
+    return asset_image_downsample_f32_rows(dst, src, sw, sh, channels, filter, 0u, sh > 1u ? sh >> 1u : 1u);
+}
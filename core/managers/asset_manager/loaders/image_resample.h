@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// 2:1 downsampling kernels for mip generation. Every ISA computes exactly what the scalar
+// reference computes (same taps, same summation order, no fused multiply-add), so a chain built
+// with SSE2, AVX2 or NEON is byte-identical to one built without.
+
+typedef enum asset_image_mip_filter_t
+{
+    ASSET_IMAGE_MIP_FILTER_BOX = 0,      // 2x2 average
+    ASSET_IMAGE_MIP_FILTER_KAISER = 1,   // Kaiser-windowed sinc, 12x12 taps; sharper than box
+    ASSET_IMAGE_MIP_FILTER_LANCZOS3 = 2, // 12x12 taps, sharpest; rings a little on hard edges
+    ASSET_IMAGE_MIP_FILTER_COUNT
+} asset_image_mip_filter_t;
+
+// Flags for the 8-bit kernels.
+#define ASSET_IMAGE_MIP_SRGB 1u // rgb is sRGB-encoded color: filter in linear light. Alpha is always linear.
+#define ASSET_IMAGE_MIP_COLOR_KNOWN 2u // the color space was given, not guessed: keep ASSET_IMAGE_MIP_SRGB as is
+
+typedef enum asset_image_isa_t
+{
+    ASSET_IMAGE_ISA_SCALAR = 0,
+    ASSET_IMAGE_ISA_SSE2 = 1,
+    ASSET_IMAGE_ISA_AVX2 = 2,
+    ASSET_IMAGE_ISA_NEON = 3,
+    ASSET_IMAGE_ISA_COUNT
+} asset_image_isa_t;
+
+// Kernels in use: the best the CPU supports unless overridden.
+uint32_t asset_image_resample_isa(void);
+const char *asset_image_resample_isa_name(uint32_t isa);
+bool asset_image_resample_isa_supported(uint32_t isa);
+// Switches every later downsample to `isa` (for comparing against the scalar reference). False if
+// the CPU or the build lacks it.
+bool asset_image_resample_set_isa(uint32_t isa);
+
+// Writes the next mip of a sw x sh level: max(sw / 2, 1) x max(sh / 2, 1) pixels, tightly packed.
+// channels is 1, 3 or 4. False on bad arguments or OOM.
+bool asset_image_downsample_u8(uint8_t *dst, const uint8_t *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter, uint32_t flags);
+// Windowed filters clamp their negative lobes at 0 so HDR mips never go below black.
+bool asset_image_downsample_f32(float *dst, const float *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter);
+
+// Same, restricted to destination rows [y0, y1). dst and src still point at the whole levels, so
+// disjoint row ranges of one level can be filled from different threads; the result is identical
+// to a single full-level call.
+bool asset_image_downsample_u8_rows(uint8_t *dst, const uint8_t *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter, uint32_t flags, uint32_t y0, uint32_t y1);
+bool asset_image_downsample_f32_rows(float *dst, const float *src, uint32_t sw, uint32_t sh, uint32_t channels, uint32_t filter, uint32_t y0, uint32_t y1);
@@ -0,0 +1,349 @@
+#include "image_upload.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_manager/asset_manager.h"
+#include "image_mips.h"
+#include "image_bcn.h"
+
+#if defined(__APPLE__)
+#include <OpenGL/gl3.h>
+#else
+#include <GL/glew.h>
+#endif
+
+// Upload cursor: rows below `row` of level `mip` are in; levels (mip, lowest] are complete.
+typedef struct image_upload_state_t
+{
+    GLuint tex;
+    uint32_t mip;
+    uint32_t top;
+    uint32_t row;
+} image_upload_state_t;
+
+static GLenum image_upload_internal_format(const asset_image_t *img)
+{
+    if (img->mips->bc_format)
+        return (GLenum)asset_image_bc_gl_format(img->mips->bc_format);
+    if (img->is_float)
+        return (img->channels == 4) ? GL_RGBA16F : (img->channels == 3 ? GL_RGB16F : GL_R16F);
+    return (img->channels == 4) ? GL_RGBA8 : (img->channels == 3 ? GL_RGB8 : GL_R8);
+}
+
+uint32_t asset_image_upload_row_bytes(const asset_image_t *img, uint32_t mip)
+{
+    const uint32_t mw = img->mips->width[mip];
+    if (img->mips->bc_format)
+        return ((mw + 3u) / 4u) * img->mips->bytes_per_pixel;
+    return mw * img->channels * (img->is_float ? 4u : 1u);
+}
+
+uint32_t asset_image_upload_row_count(const asset_image_t *img, uint32_t mip)
+{
+    const uint32_t mh = img->mips->height[mip];
+    return img->mips->bc_format ? (mh + 3u) / 4u : mh;
+}
+
+void asset_image_upload_unstage(asset_manager_t *am, asset_image_mip_chain_t *m, uint32_t mip)
+{
+    if (!m || mip >= ASSET_IMAGE_MAX_MIPS || !(m->staged_mask & (1u << mip)))
+        return;
+    asset_staging_t *staging = asset_manager_staging(am);
+    if (staging)
+        asset_staging_release(staging, m->staged_id[mip]);
+    m->staged_id[mip] = 0;
+    m->staged_offset[mip] = 0;
+    m->staged_mask &= ~(1u << mip);
+}
+
+void asset_image_upload_unstage_all(asset_manager_t *am, asset_image_mip_chain_t *m)
+{
+    for (uint32_t i = 0; m && m->staged_mask && i < ASSET_IMAGE_MAX_MIPS; ++i)
+        asset_image_upload_unstage(am, m, i);
+}
+
+static bool image_upload_stage_level(asset_staging_t *staging, asset_image_mip_chain_t *m, uint32_t mip)
+{
+    asset_staging_alloc_t st;
+    if (!asset_staging_alloc(staging, m->size[mip], 16u, &st))
+        return false;
+
+    memcpy(st.ptr, m->level[mip], (size_t)m->size[mip]);
+    m->staged_id[mip] = st.id;
+    m->staged_offset[mip] = st.offset;
+    m->staged_mask |= 1u << mip;
+    return true;
+}
+
+void asset_image_upload_stage(asset_manager_t *am, asset_image_t *img)
+{
+    asset_staging_t *staging = asset_manager_staging(am);
+    asset_image_mip_chain_t *m = img ? img->mips : NULL;
+    if (!staging || !m || m->mip_count == 0)
+        return;
+
+    // The levels asset_image_upload sends, in its order: the lowest, then with streaming off every
+    // level held in RAM above it.
+    const uint32_t lowest_mip = m->mip_count - 1u;
+    uint32_t top = lowest_mip;
+    if (!asset_manager_get_streaming(am))
+    {
+        while (top > 0 && m->level[top - 1u])
+            top--;
+    }
+
+    for (uint32_t mip = lowest_mip + 1u; mip-- > top;)
+    {
+        // Levels over a quarter of the ring would hold up everything behind them; those go up
+        // from client memory, as do the rest once the ring is full.
+        if ((m->staged_mask & (1u << mip)) || !m->level[mip] || m->size[mip] > staging->size / 4u)
+            continue;
+        if (!image_upload_stage_level(staging, m, mip))
+            break;
+    }
+}
+
+uint64_t asset_image_upload_rows(asset_manager_t *am, asset_image_t *img, uint32_t mip, uint32_t row, uint32_t rows)
+{
+    const uint32_t mw = img->mips->width[mip];
+    const uint32_t mh = img->mips->height[mip];
+    const uint64_t row_bytes = asset_image_upload_row_bytes(img, mip);
+    const uint64_t slice_bytes = row_bytes * (uint64_t)rows;
+    const uint64_t src_off = (uint64_t)row * row_bytes;
+    const void *src = (const void *)(img->mips->level[mip] + (size_t)src_off);
+
+    // Levels staged by the decode or page-in job go up from a buffer offset, so the driver can return
+    // immediately; the rest are read from client memory. Nothing is copied on this thread.
+    asset_staging_t *staging = asset_manager_staging(am);
+    const bool staged = staging && (img->mips->staged_mask & (1u << mip));
+    if (staged)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)staging->buffer);
+        src = (const void *)(uintptr_t)(img->mips->staged_offset[mip] + src_off);
+    }
+
+#if !defined(__APPLE__)
+    if (GLEW_ARB_sparse_texture != 0 && img->stream_sparse && row == 0u)
+        glTexPageCommitmentARB(GL_TEXTURE_2D, (GLint)mip, 0, 0, 0, (GLsizei)mw, (GLsizei)mh, 1, GL_TRUE);
+#endif
+
+    if (img->mips->bc_format)
+    {
+        const uint32_t y = row * 4u;
+        const uint32_t sh = (rows * 4u < mh - y) ? rows * 4u : mh - y;
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, (GLint)mip, 0, (GLint)y, (GLsizei)mw, (GLsizei)sh, image_upload_internal_format(img), (GLsizei)slice_bytes, src);
+    }
+    else
+    {
+        const GLenum fmt = (img->channels == 4) ? GL_RGBA : (img->channels == 3 ? GL_RGB : GL_RED);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, (GLint)mip, 0, (GLint)row, (GLsizei)mw, (GLsizei)rows, fmt, img->is_float ? GL_FLOAT : GL_UNSIGNED_BYTE, src);
+    }
+
+    if (staged)
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (staged && row + rows >= asset_image_upload_row_count(img, mip))
+        asset_image_upload_unstage(am, img->mips, mip);
+    return slice_bytes;
+}
+
+// Creates the texture with storage for every level and leaves it bound. Sparse when the context
+// supports it for the format, so levels the streamer has not paged in take no memory.
+static GLuint image_upload_create(asset_image_t *img)
+{
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    if (!tex)
+        return 0;
+
+    glBindTexture(GL_TEXTURE_2D, tex);
+
+    const GLenum internal = image_upload_internal_format(img);
+
+    int sparse_ok = 0;
+#if !defined(__APPLE__)
+    if (GLEW_ARB_sparse_texture != 0)
+    {
+        GLint num_levels = 0;
+        glGetInternalformativ(GL_TEXTURE_2D, internal, GL_NUM_SPARSE_LEVELS_ARB, 1, &num_levels);
+        if (glGetError() == GL_NO_ERROR && num_levels > 0)
+            sparse_ok = 1;
+    }
+#endif
+
+    const int clamp = img->is_float || img->has_alpha;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, clamp ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, clamp ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+
+#if !defined(__APPLE__)
+    if (sparse_ok)
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+#endif
+    glTexStorage2D(GL_TEXTURE_2D, (GLsizei)img->mips->mip_count, internal, (GLsizei)img->width, (GLsizei)img->height);
+
+    img->stream_sparse = sparse_ok ? 1u : 0u;
+    return tex;
+}
+
+// Clamps sampling to the levels that went up and hands the texture to the streamer.
+static void image_upload_finish(asset_image_t *img, GLuint tex, uint32_t top)
+{
+    const uint32_t lowest_mip = img->mips->mip_count - 1u;
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)top);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)lowest_mip);
+
+    img->gl_handle = (uint32_t)tex;
+
+    img->stream_current_top_mip = top;
+    img->stream_target_top_mip = top;
+    img->stream_min_safety_mip = lowest_mip;
+    img->stream_pending_target_top_mip = top;
+    img->stream_pending_frames = 0;
+    img->stream_priority = 0;
+    img->stream_residency_mask = 0ull;
+    img->vram_bytes = 0;
+    for (uint32_t m = top; m <= lowest_mip; ++m)
+    {
+        if (m < 64u)
+            img->stream_residency_mask |= 1ull << m;
+        img->vram_bytes += img->mips->size[m];
+    }
+    img->stream_last_used_frame = 0;
+    img->stream_last_used_ms = 0;
+    img->stream_best_target_mip_frame = 0;
+    img->stream_best_target_mip = top;
+    img->stream_best_priority_frame = 0;
+    img->stream_best_priority = 0;
+    img->stream_last_upload_frame = 0;
+    img->stream_last_evict_frame = 0;
+    img->stream_forced = 0;
+    img->stream_forced_top_mip = 0;
+    img->stream_upload_inflight_mip = 0xFFFFFFFFu;
+    img->stream_upload_row = 0u;
+
+    if (img->pixels)
+    {
+        free(img->pixels);
+        img->pixels = NULL;
+    }
+}
+
+asset_upload_status_t asset_image_upload(asset_manager_t *am, asset_any_t *asset, asset_upload_t *up, uint64_t budget_bytes)
+{
+    image_upload_state_t *st = (image_upload_state_t *)up->state;
+    if (!asset || asset->type != ASSET_IMAGE || budget_bytes == 0)
+    {
+        if (st && st->tex)
+            glDeleteTextures(1, &st->tex);
+        free(st);
+        up->state = NULL;
+        return ASSET_UPLOAD_FAILED;
+    }
+
+    asset_image_t *img = &asset->as.image;
+    if (!st)
+    {
+        if (img->gl_handle != 0)
+            return ASSET_UPLOAD_DONE;
+
+        if (!img->mips || img->mips->mip_count == 0 || !img->mips->level[img->mips->mip_count - 1u] || img->width == 0 || img->height == 0 || img->channels == 0)
+            return ASSET_UPLOAD_FAILED;
+
+        const uint32_t bc = img->mips->bc_format;
+        if (bc && !asset_image_bc_gl_supported(bc))
+        {
+            LOG_ERROR("Image: %s textures are not supported by this context", asset_image_bc_name(bc));
+            return ASSET_UPLOAD_FAILED;
+        }
+
+        st = (image_upload_state_t *)calloc(1, sizeof(*st));
+        if (!st)
+            return ASSET_UPLOAD_FAILED;
+
+        const uint32_t lowest_mip = img->mips->mip_count - 1u;
+        st->mip = lowest_mip;
+        st->top = lowest_mip;
+        if (!asset_manager_get_streaming(am))
+        {
+            while (st->top > 0 && img->mips->level[st->top - 1u])
+                st->top--;
+        }
+
+        st->tex = image_upload_create(img);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        if (!st->tex)
+        {
+            free(st);
+            return ASSET_UPLOAD_FAILED;
+        }
+
+        up->state = st;
+        up->bytes_total = 0;
+        for (uint32_t m = st->top; m <= lowest_mip; ++m)
+            up->bytes_total += img->mips->size[m];
+    }
+
+    glBindTexture(GL_TEXTURE_2D, st->tex);
+
+    uint64_t spent = 0;
+    for (;;)
+    {
+        const uint32_t row_count = asset_image_upload_row_count(img, st->mip);
+        if (st->row >= row_count)
+        {
+            if (st->mip == st->top)
+            {
+                image_upload_finish(img, st->tex, st->top);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                free(st);
+                up->state = NULL;
+                up->bytes_done += spent;
+                return ASSET_UPLOAD_DONE;
+            }
+            st->mip--;
+            st->row = 0;
+            continue;
+        }
+
+        // Whole rows only; a row larger than the budget still goes up alone so the upload moves.
+        const uint64_t row_bytes = asset_image_upload_row_bytes(img, st->mip);
+        if (row_bytes == 0)
+        {
+            st->row = row_count;
+            continue;
+        }
+
+        uint64_t rows = (budget_bytes - spent) / row_bytes;
+        if (rows == 0 && spent == 0)
+            rows = 1;
+        if (rows == 0)
+            break;
+        if (rows > row_count - st->row)
+            rows = row_count - st->row;
+
+        spent += asset_image_upload_rows(am, img, st->mip, st->row, (uint32_t)rows);
+        st->row += (uint32_t)rows;
+        if (spent >= budget_bytes)
+            break;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    up->bytes_done += spent;
+    return ASSET_UPLOAD_MORE;
+}
+
+bool asset_image_upload_all(asset_manager_t *am, asset_any_t *asset)
+{
+    if (!asset || asset->type != ASSET_IMAGE)
+        return false;
+
+    asset_upload_t up;
+    memset(&up, 0, sizeof(up));
+    return asset_image_upload(am, asset, &up, UINT64_MAX) == ASSET_UPLOAD_DONE;
+}
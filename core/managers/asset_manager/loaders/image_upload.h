@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "asset_manager/asset_manager.h"
+#include "asset_manager/asset_types/image.h"
+
+// GPU side shared by the image loaders and the mip streamer. Levels go up in rows (rows of 4x4
+// blocks for BC formats) so one large level can be spread over several frames.
+
+uint32_t asset_image_upload_row_bytes(const asset_image_t *img, uint32_t mip);
+uint32_t asset_image_upload_row_count(const asset_image_t *img, uint32_t mip);
+
+// Any thread: copies the levels the first asset_image_upload will send into the staging ring, so
+// the render thread only issues GPU copies. Levels that do not fit stay in client memory.
+void asset_image_upload_stage(asset_manager_t *am, asset_image_t *img);
+
+// Uploads rows [row, row + rows) of level `mip` into the texture bound to GL_TEXTURE_2D. Staged
+// levels are copied straight from the ring, which gets them back after the last row; the others
+// are read from client memory. Sparse pages of the level are committed with its first row.
+// Returns the bytes sent.
+uint64_t asset_image_upload_rows(asset_manager_t *am, asset_image_t *img, uint32_t mip, uint32_t row, uint32_t rows);
+
+// Gives back the ring copy of one staged level, or of all of them.
+void asset_image_upload_unstage(asset_manager_t *am, asset_image_mip_chain_t *m, uint32_t mip);
+void asset_image_upload_unstage_all(asset_manager_t *am, asset_image_mip_chain_t *m);
+
+// asset_upload_fn_t for images. Creates storage for the whole chain and uploads from the lowest mip
+// up. With streaming on only the lowest mip goes up here and the streamer pages in the rest; with
+// it off every level held in RAM does. Frees the decoded pixels once the texture is complete.
+asset_upload_status_t asset_image_upload(asset_manager_t *am, asset_any_t *asset, asset_upload_t *up, uint64_t budget_bytes);
+
+// Uploads everything in one go; the init_fn counterpart of asset_image_upload.
+bool asset_image_upload_all(asset_manager_t *am, asset_any_t *asset);
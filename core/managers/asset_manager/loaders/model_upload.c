@@ -0,0 +1,404 @@
+#include "model_upload.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "asset_manager/asset_manager.h"
+#include "asset_manager/asset_types/model.h"
+#include "vector.h"
+#include "handle.h"
+
+#if defined(__APPLE__)
+#include <OpenGL/gl3.h>
+#else
+#include <GL/glew.h>
+#endif
+
+static void model_setup_vertex_vao(void)
+{
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, px));
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, nx));
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, u));
+
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(model_vertex_t), (void *)offsetof(model_vertex_t, tx));
+}
+
+static uint64_t model_align_u64(uint64_t x, uint64_t a)
+{
+    if (a == 0)
+        return x;
+    uint64_t m = a - 1ull;
+    return (x + m) & ~m;
+}
+
+static void model_unmap_raw(model_raw_t *raw)
+{
+    asset_file_map_t *fm = (asset_file_map_t *)raw->file_map;
+    if (!fm)
+        return;
+    asset_io_unmap(fm);
+    free(fm);
+    raw->file_map = NULL;
+}
+
+void asset_model_upload_release_raw(asset_manager_t *am, model_raw_t *raw)
+{
+    asset_staging_t *staging = asset_manager_staging(am);
+    if (staging && raw->staging_region)
+        asset_staging_release(staging, raw->staging_region);
+    raw->staging_region = 0;
+    model_unmap_raw(raw);
+    model_raw_destroy(raw);
+}
+
+void asset_model_upload_stage(asset_manager_t *am, model_raw_t *raw)
+{
+    asset_staging_t *staging = asset_manager_staging(am);
+    if (!staging || raw->staging_region)
+        return;
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < raw->submeshes.size; ++i)
+    {
+        model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&raw->submeshes, i);
+        for (uint32_t li = 0; sm && li < sm->lods.size; ++li)
+        {
+            model_cpu_lod_t *cl = (model_cpu_lod_t *)vector_impl_at(&sm->lods, li);
+            if (!cl || !cl->vertices || !cl->indices)
+                continue;
+            total += model_align_u64((uint64_t)cl->vertex_count * sizeof(model_vertex_t), 16);
+            total += model_align_u64((uint64_t)cl->index_count * sizeof(uint32_t), 16);
+        }
+    }
+
+    asset_staging_alloc_t st;
+    if (!total || !asset_staging_alloc(staging, total, 16u, &st))
+        return;
+
+    uint8_t *dst = (uint8_t *)st.ptr;
+    for (uint32_t i = 0; i < raw->submeshes.size; ++i)
+    {
+        model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&raw->submeshes, i);
+        if (!sm)
+            continue;
+
+        const bool owned = !(sm->flags & CPU_SUBMESH_FLAG_BORROWED_LODS);
+        for (uint32_t li = 0; li < sm->lods.size; ++li)
+        {
+            model_cpu_lod_t *cl = (model_cpu_lod_t *)vector_impl_at(&sm->lods, li);
+            if (!cl || !cl->vertices || !cl->indices)
+            {
+                if (cl && owned)
+                {
+                    free(cl->vertices);
+                    free(cl->indices);
+                }
+                if (cl)
+                    memset(cl, 0, sizeof(*cl));
+                continue;
+            }
+
+            const uint64_t vbytes = (uint64_t)cl->vertex_count * sizeof(model_vertex_t);
+            const uint64_t ibytes = (uint64_t)cl->index_count * sizeof(uint32_t);
+            memcpy(dst, cl->vertices, (size_t)vbytes);
+            memcpy(dst + model_align_u64(vbytes, 16), cl->indices, (size_t)ibytes);
+            if (owned)
+            {
+                free(cl->vertices);
+                free(cl->indices);
+            }
+            cl->vertices = (model_vertex_t *)dst;
+            cl->indices = (uint32_t *)(dst + model_align_u64(vbytes, 16));
+            dst += model_align_u64(vbytes, 16) + model_align_u64(ibytes, 16);
+        }
+        sm->flags = (uint8_t)(sm->flags | CPU_SUBMESH_FLAG_BORROWED_LODS);
+    }
+
+    free(raw->storage);
+    raw->storage = NULL;
+    model_unmap_raw(raw);
+    raw->staging_region = st.id;
+}
+
+// Upload cursor: LOD `lod` of submesh `submesh`; stage 0 creates its buffers, 1 fills vertices, 2 indices.
+typedef struct model_upload_state_t
+{
+    asset_model_t model;
+    mesh_t mesh;
+    mesh_lod_t lod;
+    uint32_t submesh;
+    uint32_t lod_index;
+    uint32_t uploaded;
+    uint32_t stage;
+    uint64_t offset;
+    bool mesh_open;
+} model_upload_state_t;
+
+static void model_lod_delete(mesh_lod_t *l)
+{
+    if (l->ibo)
+        glDeleteBuffers(1, &l->ibo);
+    if (l->vbo)
+        glDeleteBuffers(1, &l->vbo);
+    if (l->vao)
+        glDeleteVertexArrays(1, &l->vao);
+    memset(l, 0, sizeof(*l));
+}
+
+static void model_mesh_delete(mesh_t *m)
+{
+    for (uint32_t li = 0; li < m->lods.size; ++li)
+    {
+        mesh_lod_t *l = (mesh_lod_t *)vector_impl_at(&m->lods, li);
+        if (l)
+            model_lod_delete(l);
+    }
+    vector_impl_free(&m->lods);
+}
+
+static void model_upload_abort(model_upload_state_t *st)
+{
+    model_lod_delete(&st->lod);
+    if (st->mesh_open)
+        model_mesh_delete(&st->mesh);
+    for (uint32_t i = 0; i < st->model.meshes.size; ++i)
+    {
+        mesh_t *m = (mesh_t *)vector_impl_at(&st->model.meshes, i);
+        if (m)
+            model_mesh_delete(m);
+    }
+    asset_model_destroy_cpu_only(&st->model);
+    free(st);
+}
+
+static uint64_t model_raw_bytes(const model_raw_t *raw)
+{
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < raw->submeshes.size; ++i)
+    {
+        const model_cpu_submesh_t *sm = (const model_cpu_submesh_t *)vector_impl_at((vector_t *)&raw->submeshes, i);
+        for (uint32_t li = 0; sm && li < sm->lods.size; ++li)
+        {
+            const model_cpu_lod_t *cl = (const model_cpu_lod_t *)vector_impl_at((vector_t *)&sm->lods, li);
+            if (cl)
+                total += (uint64_t)cl->vertex_count * sizeof(model_vertex_t) + (uint64_t)cl->index_count * sizeof(uint32_t);
+        }
+    }
+    return total;
+}
+
+// Copies up to `budget` bytes of [offset, size) into buf through the copy-write binding, leaving the
+// VAO's element binding alone. Sources inside the staging ring become GPU-side buffer copies.
+static uint64_t model_upload_range(GLuint buf, const asset_staging_t *staging, const void *src, uint64_t size, uint64_t *offset, uint64_t budget)
+{
+    uint64_t n = size - *offset;
+    if (n > budget)
+        n = budget;
+    if (n == 0)
+        return 0;
+
+    uint64_t src_off = 0;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buf);
+    if (staging && asset_staging_offset_of(staging, src, &src_off))
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, (GLuint)staging->buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)(src_off + *offset), (GLintptr)*offset, (GLsizeiptr)n);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    else
+    {
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)*offset, (GLsizeiptr)n, (const uint8_t *)src + *offset);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    *offset += n;
+    return n;
+}
+
+asset_upload_status_t asset_model_upload(asset_manager_t *am, asset_any_t *asset, asset_upload_t *up, uint64_t budget_bytes)
+{
+    model_upload_state_t *st = (model_upload_state_t *)up->state;
+    if (!asset || asset->type != ASSET_MODEL || budget_bytes == 0)
+    {
+        if (st)
+            model_upload_abort(st);
+        up->state = NULL;
+        return ASSET_UPLOAD_FAILED;
+    }
+
+    if (!st)
+    {
+        st = (model_upload_state_t *)calloc(1, sizeof(*st));
+        if (!st)
+            return ASSET_UPLOAD_FAILED;
+        st->model = asset_model_make();
+        up->state = st;
+        up->bytes_total = model_raw_bytes(&asset->as.model_raw);
+    }
+
+    const asset_staging_t *staging = asset->as.model_raw.staging_region ? asset_manager_staging(am) : NULL;
+
+    uint64_t spent = 0;
+    while (spent < budget_bytes)
+    {
+        if (st->submesh >= asset->as.model_raw.submeshes.size)
+        {
+            asset_model_upload_release_raw(am, &asset->as.model_raw);
+            asset->as.model = st->model;
+            asset->state = ASSET_STATE_READY;
+            free(st);
+            up->state = NULL;
+            up->bytes_done += spent;
+            return ASSET_UPLOAD_DONE;
+        }
+
+        model_cpu_submesh_t *sm = (model_cpu_submesh_t *)vector_impl_at(&asset->as.model_raw.submeshes, st->submesh);
+        if (!st->mesh_open)
+        {
+            if (!sm || sm->lods.size == 0)
+            {
+                st->submesh++;
+                continue;
+            }
+
+            memset(&st->mesh, 0, sizeof(st->mesh));
+            st->mesh.material = sm->material;
+            st->mesh.lods = vector_impl_create_vector(sizeof(mesh_lod_t));
+            st->mesh.flags = 0;
+            mesh_set_local_aabb_from_cpu(&st->mesh, sm);
+
+            st->mesh_open = true;
+            st->lod_index = 0;
+            st->uploaded = 0;
+            st->stage = 0;
+        }
+
+        if (st->lod_index >= sm->lods.size)
+        {
+            if (st->uploaded > 0)
+            {
+                if (st->uploaded == sm->lods.size)
+                    st->mesh.flags = (uint8_t)(st->mesh.flags | (uint8_t)MESH_FLAG_LODS_READY);
+                vector_impl_push_back(&st->model.meshes, &st->mesh);
+            }
+            else
+            {
+                vector_impl_free(&st->mesh.lods);
+            }
+            memset(&st->mesh, 0, sizeof(st->mesh));
+            st->mesh_open = false;
+            st->submesh++;
+            continue;
+        }
+
+        model_cpu_lod_t *cl = (model_cpu_lod_t *)vector_impl_at(&sm->lods, st->lod_index);
+        if (!cl || !cl->vertices || !cl->indices || !cl->vertex_count || !cl->index_count)
+        {
+            st->lod_index++;
+            continue;
+        }
+
+        const uint64_t vbytes = (uint64_t)cl->vertex_count * sizeof(model_vertex_t);
+        const uint64_t ibytes = (uint64_t)cl->index_count * sizeof(uint32_t);
+
+        if (st->stage == 0)
+        {
+            memset(&st->lod, 0, sizeof(st->lod));
+            st->lod.index_count = cl->index_count;
+
+            glGenVertexArrays(1, &st->lod.vao);
+            glBindVertexArray(st->lod.vao);
+
+            glGenBuffers(1, &st->lod.vbo);
+            glBindBuffer(GL_ARRAY_BUFFER, st->lod.vbo);
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vbytes, NULL, GL_STATIC_DRAW);
+
+            glGenBuffers(1, &st->lod.ibo);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, st->lod.ibo);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)ibytes, NULL, GL_STATIC_DRAW);
+
+            model_setup_vertex_vao();
+
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+            st->stage = 1;
+            st->offset = 0;
+        }
+
+        if (st->stage == 1)
+        {
+            spent += model_upload_range(st->lod.vbo, staging, cl->vertices, vbytes, &st->offset, budget_bytes - spent);
+            if (st->offset < vbytes)
+                break;
+            st->stage = 2;
+            st->offset = 0;
+        }
+
+        spent += model_upload_range(st->lod.ibo, staging, cl->indices, ibytes, &st->offset, budget_bytes - spent);
+        if (st->offset < ibytes)
+            break;
+
+        vector_impl_push_back(&st->mesh.lods, &st->lod);
+        memset(&st->lod, 0, sizeof(st->lod));
+        if (st->lod_index == 0)
+            st->mesh.flags = (uint8_t)(st->mesh.flags | (uint8_t)MESH_FLAG_LOD0_READY);
+        st->uploaded++;
+        st->lod_index++;
+        st->stage = 0;
+    }
+
+    up->bytes_done += spent;
+    return ASSET_UPLOAD_MORE;
+}
+
+bool asset_model_upload_all(asset_manager_t *am, asset_any_t *asset)
+{
+    if (!am || !asset || asset->type != ASSET_MODEL)
+        return false;
+
+    asset_upload_t up;
+    memset(&up, 0, sizeof(up));
+    return asset_model_upload(am, asset, &up, UINT64_MAX) == ASSET_UPLOAD_DONE;
+}
+
+void asset_model_upload_cleanup(asset_manager_t *am, asset_any_t *asset)
+{
+    if (!asset || asset->type != ASSET_MODEL)
+        return;
+
+    if (asset->state != ASSET_STATE_READY)
+        asset_model_upload_release_raw(am, &asset->as.model_raw);
+
+    for (uint32_t i = 0; i < asset->as.model.meshes.size; ++i)
+    {
+        mesh_t *m = (mesh_t *)vector_impl_at(&asset->as.model.meshes, i);
+        if (!m)
+            continue;
+
+        for (uint32_t li = 0; li < m->lods.size; ++li)
+        {
+            mesh_lod_t *l = (mesh_lod_t *)vector_impl_at(&m->lods, li);
+            if (l)
+                model_lod_delete(l);
+        }
+
+        vector_impl_free(&m->lods);
+        m->material = ihandle_invalid();
+        m->flags = 0;
+        m->local_aabb.min = (vec3){0, 0, 0};
+        m->local_aabb.max = (vec3){0, 0, 0};
+    }
+
+    asset_model_destroy_cpu_only(&asset->as.model);
+}
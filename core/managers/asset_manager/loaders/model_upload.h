@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "asset_manager/asset_manager.h"
+#include "asset_manager/asset_types/model.h"
+
+// GPU side shared by the model loaders. A raw model's LOD arrays become one VAO/VBO/IBO per LOD,
+// uploaded in budget-sized byte ranges so a large mesh spreads over several frames.
+
+// Moves the LOD arrays into the upload ring so the render thread only has to issue buffer copies.
+// Call from the load job. Without room in the ring they stay where they are and upload from client memory.
+void asset_model_upload_stage(asset_manager_t *am, model_raw_t *raw);
+
+// Frees a raw model together with its ring region and file mapping.
+void asset_model_upload_release_raw(asset_manager_t *am, model_raw_t *raw);
+
+// asset_upload_fn_t for models. Releases the raw model and marks the asset ready once every LOD is in.
+asset_upload_status_t asset_model_upload(asset_manager_t *am, asset_any_t *asset, asset_upload_t *up, uint64_t budget_bytes);
+
+// Uploads everything in one go; the init_fn counterpart of asset_model_upload.
+bool asset_model_upload_all(asset_manager_t *am, asset_any_t *asset);
+
+// cleanup_fn for models uploaded through the functions above.
+void asset_model_upload_cleanup(asset_manager_t *am, asset_any_t *asset);
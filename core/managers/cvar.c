@@ -62,6 +62,7 @@ static cvar_entry_t g_cvars[SV_CVAR_COUNT] = {
     [CL_AUTO_EXPOSURE] = {.name = "cl_auto_exposure", .type = CVAR_BOOL, .def.b = false, .flags = CVAR_FLAG_NONE},
     [CL_AUTO_EXPOSURE_HZ] = {.name = "cl_auto_exposure_hz", .type = CVAR_INT, .def.i = 10, .flags = CVAR_FLAG_NONE},
     [CL_R_RESTORE_GL_STATE] = {.name = "cl_r_restore_gl_state", .type = CVAR_BOOL, .def.b = false, .flags = CVAR_FLAG_NONE},
+    [CL_R_TEX_PREFETCH_FRAMES] = {.name = "cl_r_tex_prefetch_frames", .type = CVAR_INT, .def.i = 8, .flags = CVAR_FLAG_NONE},
     [CL_R_FORCE_LOD_LEVEL] = {.name = "cl_r_force_lod_level", .type = CVAR_INT, .def.i = -1, .flags = CVAR_FLAG_NO_LOAD | CVAR_FLAG_NO_SAVE},
     [CL_R_WIREFRAME] = {.name = "cl_r_wireframe", .type = CVAR_BOOL, .def.b = false, .flags = CVAR_FLAG_NO_LOAD | CVAR_FLAG_NO_SAVE},
 };
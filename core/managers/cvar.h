@@ -40,6 +40,7 @@ typedef enum
     CL_AUTO_EXPOSURE,
     CL_AUTO_EXPOSURE_HZ,
     CL_R_RESTORE_GL_STATE,
+    CL_R_TEX_PREFETCH_FRAMES,
 
     // Renderer dev/debug (not intended to be saved)
     CL_R_FORCE_LOD_LEVEL,
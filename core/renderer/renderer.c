@@ -34,6 +34,10 @@
 #define R_SHADOW_PAD_XY 10.0f
 #define R_SHADOW_PAD_Z 50.0f
 
+// Texture streaming priorities; speculative uses only get upload budget left over by visible ones.
+#define R_STREAM_PRIORITY_VISIBLE 1u
+#define R_STREAM_PRIORITY_PREFETCH 0u
+
 static void R_bind_common_uniforms(renderer_t *r, const shader_t *s);
 static uint32_t R_post_scene_color_tex(const renderer_t *r);
 
@@ -276,7 +280,8 @@ static uint32_t g_model_bounds_size = 0;
 
 static uint64_t model_key64(ihandle_t h)
 {
-    return ((uint64_t)h.type << 48) | ((uint64_t)h.meta << 32) | (uint64_t)h.value;
+    // XOR keeps the key unique per value for a given type/meta once generations pass 16 bits.
+    return ((uint64_t)h.type << 48) ^ ((uint64_t)h.meta << 32) ^ h.value;
 }
 
 static uint32_t u64_hash32(uint64_t x)
@@ -959,7 +964,7 @@ static void R_quad3d_render(renderer_t *r)
                 screen_px = R_sphere_screen_diameter_px(r, q->center, r0);
             }
 
-            const uint16_t prio = (uint16_t)(((q->flags & QUAD3D_ON_TOP) != 0u || (q->flags & QUAD3D_SCALE_WITH_VIEW) != 0u) ? 50000u : 0u);
+            const uint16_t prio = (uint16_t)(((q->flags & QUAD3D_ON_TOP) != 0u || (q->flags & QUAD3D_SCALE_WITH_VIEW) != 0u) ? 50000u : R_STREAM_PRIORITY_VISIBLE);
             asset_manager_image_stream_record_use(r->assets, q->texture.handle, screen_px, 1.0f, prio);
         }
 
@@ -2300,7 +2305,7 @@ static vec3 R_mesh_local_center(const mesh_t *mesh)
     return c;
 }
 
-static float R_sphere_screen_diameter_px(const renderer_t *r, vec3 world_center, float world_radius)
+static float R_sphere_screen_diameter_px_from(const renderer_t *r, vec3 eye, vec3 world_center, float world_radius)
 {
     if (!r || r->fb_size.y <= 0)
         return 1.0f;
@@ -2312,7 +2317,7 @@ static float R_sphere_screen_diameter_px(const renderer_t *r, vec3 world_center,
     float radius_ndc = 0.0f;
     if (fabsf(proj_m11) > 1e-6f)
     {
-        float dist = vec3_dist(world_center, r->camera.position);
+        float dist = vec3_dist(world_center, eye);
         if (dist < 1e-3f)
             dist = 1e-3f;
         radius_ndc = (world_radius / dist) * proj_y;
@@ -2328,19 +2333,26 @@ static float R_sphere_screen_diameter_px(const renderer_t *r, vec3 world_center,
     return diameter_px;
 }
 
-static void R_stream_record_material_textures(renderer_t *r, const asset_material_t *mat, float screen_coverage_px, float uv_scale, uint16_t priority)
+static float R_sphere_screen_diameter_px(const renderer_t *r, vec3 world_center, float world_radius)
+{
+    return R_sphere_screen_diameter_px_from(r, r ? r->camera.position : (vec3){0.0f, 0.0f, 0.0f}, world_center, world_radius);
+}
+
+typedef void (*stream_record_fn_t)(asset_manager_t *am, ihandle_t image, float screen_coverage_px, float uv_scale, uint16_t priority);
+
+static void R_stream_record_material_textures(renderer_t *r, stream_record_fn_t record, const asset_material_t *mat, float screen_coverage_px, float uv_scale, uint16_t priority)
 {
     if (!r || !r->assets || !mat)
         return;
 
-    asset_manager_image_stream_record_use(r->assets, mat->albedo_tex, screen_coverage_px, uv_scale, priority);
-    asset_manager_image_stream_record_use(r->assets, mat->normal_tex, screen_coverage_px, uv_scale, priority);
-    asset_manager_image_stream_record_use(r->assets, mat->metallic_tex, screen_coverage_px, uv_scale, priority);
-    asset_manager_image_stream_record_use(r->assets, mat->roughness_tex, screen_coverage_px, uv_scale, priority);
-    asset_manager_image_stream_record_use(r->assets, mat->emissive_tex, screen_coverage_px, uv_scale, priority);
-    asset_manager_image_stream_record_use(r->assets, mat->occlusion_tex, screen_coverage_px, uv_scale, priority);
-    asset_manager_image_stream_record_use(r->assets, mat->height_tex, screen_coverage_px, uv_scale, priority);
-    asset_manager_image_stream_record_use(r->assets, mat->arm_tex, screen_coverage_px, uv_scale, priority);
+    record(r->assets, mat->albedo_tex, screen_coverage_px, uv_scale, priority);
+    record(r->assets, mat->normal_tex, screen_coverage_px, uv_scale, priority);
+    record(r->assets, mat->metallic_tex, screen_coverage_px, uv_scale, priority);
+    record(r->assets, mat->roughness_tex, screen_coverage_px, uv_scale, priority);
+    record(r->assets, mat->emissive_tex, screen_coverage_px, uv_scale, priority);
+    record(r->assets, mat->occlusion_tex, screen_coverage_px, uv_scale, priority);
+    record(r->assets, mat->height_tex, screen_coverage_px, uv_scale, priority);
+    record(r->assets, mat->arm_tex, screen_coverage_px, uv_scale, priority);
 }
 
 static vec3 R_transform_point(mat4 m, vec3 p)
@@ -2374,9 +2386,8 @@ static void R_plane_normalize(frustum_plane_t *pl)
     pl->d *= inv;
 }
 
-static void R_frustum_build(frustum_t *f, const renderer_t *r)
+static void R_frustum_build_vp(frustum_t *f, mat4 vp)
 {
-    mat4 vp = mat4_mul(r->camera.proj, r->camera.view);
 
     float r0x = vp.m[0], r0y = vp.m[4], r0z = vp.m[8], r0w = vp.m[12];
     float r1x = vp.m[1], r1y = vp.m[5], r1z = vp.m[9], r1w = vp.m[13];
@@ -2394,6 +2405,11 @@ static void R_frustum_build(frustum_t *f, const renderer_t *r)
         R_plane_normalize(&f->p[i]);
 }
 
+static void R_frustum_build(frustum_t *f, const renderer_t *r)
+{
+    R_frustum_build_vp(f, mat4_mul(r->camera.proj, r->camera.view));
+}
+
 static int R_frustum_sphere_visible(const frustum_t *f, vec3 c, float r)
 {
     for (int i = 0; i < 6; ++i)
@@ -2430,9 +2446,9 @@ static void R_log_missing_forced_lod_once(ihandle_t model, uint32_t mesh_index,
         return;
     budget--;
 
-    LOG_WARN("Forced LOD %u requested but mesh has %u lods (model type=%u val=%u meta=%u mesh=%u). Using lod=%u",
+    LOG_WARN("Forced LOD %u requested but mesh has %u lods (model type=%u val=%llu meta=%u mesh=%u). Using lod=%u",
              lod_wanted, lods,
-             (unsigned)model.type, (unsigned)model.value, (unsigned)model.meta,
+             (unsigned)model.type, (unsigned long long)model.value, (unsigned)model.meta,
              (unsigned)mesh_index,
              (lods ? (lods - 1u) : 0u));
 }
@@ -2919,6 +2935,104 @@ static void R_emit_batches_from_items(renderer_t *r, inst_item_t *items, uint32_
     }
 }
 
+// Extrapolates the camera by repeating last frame's view change `frames` more times. Also rolls
+// the stored view, so call once per frame. Returns 0 while there is nothing to extrapolate.
+static int R_stream_predict_view(renderer_t *r, uint32_t frames, mat4 *out_view, vec3 *out_eye)
+{
+    const mat4 prev = r->stream_prev_view;
+    const int had_prev = r->stream_prev_view_valid;
+    r->stream_prev_view = r->camera.view;
+    r->stream_prev_view_valid = 1;
+    if (!had_prev || !frames)
+        return 0;
+
+    const mat4 delta = mat4_mul(r->camera.view, mat4_inverse(prev));
+
+    float moved = 0.0f;
+    for (int i = 0; i < 16; ++i)
+        moved += fabsf(delta.m[i] - ((i % 5) == 0 ? 1.0f : 0.0f));
+    if (!(moved > 1e-5f))
+        return 0;
+
+    mat4 v = r->camera.view;
+    for (uint32_t i = 0; i < frames; ++i)
+        v = mat4_mul(delta, v);
+
+    const mat4 inv = mat4_inverse(v);
+    *out_view = v;
+    *out_eye = (vec3){inv.m[12], inv.m[13], inv.m[14]};
+    return 1;
+}
+
+// Meshes inside the predicted frustum but outside the current one get speculative texture uses,
+// sized for the predicted eye position.
+static void R_stream_prefetch_models(renderer_t *r, const vector_t *models, const frustum_t *cur, const frustum_t *pred, vec3 eye)
+{
+    for (uint32_t i = 0; i < models->size; ++i)
+    {
+        pushed_model_t *pm = (pushed_model_t *)vector_at((vector_t *)models, i);
+        if (!pm || !ihandle_is_valid(pm->model))
+            continue;
+
+        asset_model_t *mdl = R_resolve_model(r, pm->model);
+        if (!mdl)
+            continue;
+
+        float max_scale = R_mat4_max_scale_xyz(&pm->model_matrix);
+        const model_bounds_entry_t *mb = model_bounds_get_or_build(pm->model, mdl);
+        if (mb)
+        {
+            vec3 wc = R_transform_point(pm->model_matrix, mb->c_local);
+            float wr = mb->r_local * max_scale;
+            if (!R_frustum_sphere_visible(pred, wc, wr))
+                continue;
+        }
+
+        for (uint32_t mi = 0; mi < mdl->meshes.size; ++mi)
+        {
+            mesh_t *mesh = (mesh_t *)vector_at((vector_t *)&mdl->meshes, mi);
+            if (!mesh || !(mesh->flags & MESH_FLAG_HAS_AABB))
+                continue;
+
+            if (!R_mesh_visible_frustum(pred, mesh, &pm->model_matrix, max_scale))
+                continue;
+            if (R_mesh_visible_frustum(cur, mesh, &pm->model_matrix, max_scale))
+                continue;
+
+            asset_material_t *mat = R_resolve_material(r, mesh->material);
+
+            const vec3 wc = R_transform_point(pm->model_matrix, R_mesh_local_center(mesh));
+            const float wr = R_mesh_local_radius(mesh) * max_scale;
+            const float screen_px = R_sphere_screen_diameter_px_from(r, eye, wc, wr);
+            R_stream_record_material_textures(r, asset_manager_image_stream_record_prefetch, mat, screen_px, 1.0f, R_STREAM_PRIORITY_PREFETCH);
+        }
+    }
+}
+
+// Runs after R_build_instancing so textures already used this frame ignore the speculative uses.
+static void R_stream_prefetch(renderer_t *r)
+{
+    if (!r->assets)
+        return;
+
+    int frames = cvar_get_int_name("cl_r_tex_prefetch_frames");
+    if (frames < 0)
+        frames = 0;
+
+    mat4 view;
+    vec3 eye;
+    if (!R_stream_predict_view(r, (uint32_t)frames, &view, &eye))
+        return;
+
+    frustum_t cur;
+    frustum_t pred;
+    R_frustum_build(&cur, r);
+    R_frustum_build_vp(&pred, mat4_mul(r->camera.proj, view));
+
+    R_stream_prefetch_models(r, &r->models, &cur, &pred, eye);
+    R_stream_prefetch_models(r, &r->fwd_models, &cur, &pred, eye);
+}
+
 static void R_build_instancing(renderer_t *r)
 {
     vector_clear(&r->inst_batches);
@@ -3022,7 +3136,7 @@ static void R_build_instancing(renderer_t *r)
                 const vec3 wc = R_transform_point(pm->model_matrix, lc);
                 const float wr = lr * max_scale;
                 const float screen_px = R_sphere_screen_diameter_px(r, wc, wr);
-                R_stream_record_material_textures(r, mat, screen_px, 1.0f, 0);
+                R_stream_record_material_textures(r, asset_manager_image_stream_record_use, mat, screen_px, 1.0f, R_STREAM_PRIORITY_VISIBLE);
             }
 
             int mat_cutout = 0;
@@ -3130,7 +3244,7 @@ static void R_build_instancing(renderer_t *r)
                 const vec3 wc = R_transform_point(pm->model_matrix, lc);
                 const float wr = lr * max_scale;
                 const float screen_px = R_sphere_screen_diameter_px(r, wc, wr);
-                R_stream_record_material_textures(r, mat, screen_px, 1.0f, 0);
+                R_stream_record_material_textures(r, asset_manager_image_stream_record_use, mat, screen_px, 1.0f, R_STREAM_PRIORITY_VISIBLE);
             }
 
             int mat_cutout = 0;
@@ -5004,6 +5118,7 @@ void R_end_frame(renderer_t *r)
     {
         double t0 = R_time_now_ms();
         R_build_instancing(r);
+        R_stream_prefetch(r);
         r->cpu_timings.ms[R_CPU_BUILD_INSTANCING] = R_time_now_ms() - t0;
         r->cpu_timings.valid = 1;
     }
@@ -234,6 +234,9 @@ typedef struct renderer_t
     uint32_t exposure_reduce_cap_vec4; // elements
 
     camera_t camera;
+    // Last frame's view, extrapolated to prefetch textures ahead of camera motion.
+    mat4 stream_prev_view;
+    uint8_t stream_prev_view_valid;
 
     vector_t lights;
     vector_t models;
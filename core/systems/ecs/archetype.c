@@ -0,0 +1,422 @@
+#include "core/systems/ecs/archetype.h"
+#include "core/systems/ecs/internal.h"
+
+static ecs_archetype_t *ecs_arch_at(const ecs_world_t *w, uint32_t ai)
+{
+    return (ecs_archetype_t *)((uint8_t *)w->archetypes.data + (size_t)ai * w->archetypes.element_size);
+}
+
+static ecs_entity_record_t *ecs_arch_record(const ecs_world_t *w, uint32_t entity_index)
+{
+    return (ecs_entity_record_t *)((uint8_t *)w->entity_records.data + (size_t)entity_index * w->entity_records.element_size);
+}
+
+static uint32_t ecs_arch_type_size(const ecs_world_t *w, ecs_component_id_t type_id)
+{
+    const ecs_type_info_t *ti = (const ecs_type_info_t *)((uint8_t *)w->types.data + (size_t)type_id * w->types.element_size);
+    return ti->size;
+}
+
+static uint32_t ecs_arch_align_up(uint32_t v, uint32_t a)
+{
+    return (v + (a - 1u)) & ~(a - 1u);
+}
+
+uint32_t ecs_arch_column(const ecs_archetype_t *a, ecs_component_id_t type_id)
+{
+    if (!(a->mask & ecs_arch_type_bit(type_id)))
+        return ECS_INVALID_U32;
+
+    const ecs_component_id_t *ids = (const ecs_component_id_t *)a->type_ids.data;
+    uint32_t lo = 0;
+    uint32_t hi = a->type_ids.size;
+
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) >> 1;
+        if (ids[mid] < type_id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < a->type_ids.size && ids[lo] == type_id)
+        return lo;
+    return ECS_INVALID_U32;
+}
+
+static void ecs_arch_layout(const ecs_world_t *w, ecs_archetype_t *a)
+{
+    uint32_t n = a->type_ids.size;
+    uint32_t row_bytes = (uint32_t)sizeof(uint32_t);
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t sz = ecs_arch_type_size(w, ecs_vec_u32_get(&a->type_ids, i));
+        ecs_vec_u32_set(&a->column_sizes, i, sz);
+        row_bytes += sz;
+    }
+
+    uint32_t pad = (n + 1u) * ECS_ARCH_COLUMN_ALIGN;
+    uint32_t cap = ECS_ARCH_CHUNK_BYTES > pad ? (ECS_ARCH_CHUNK_BYTES - pad) / row_bytes : 0;
+    if (cap == 0)
+        cap = 1;
+
+    uint32_t off = ecs_arch_align_up(cap * (uint32_t)sizeof(uint32_t), ECS_ARCH_COLUMN_ALIGN);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        ecs_vec_u32_set(&a->column_offsets, i, off);
+        off = ecs_arch_align_up(off + cap * ecs_vec_u32_get(&a->column_sizes, i), ECS_ARCH_COLUMN_ALIGN);
+    }
+
+    a->row_capacity = cap;
+    a->chunk_bytes = off;
+}
+
+static uint32_t ecs_arch_find(const ecs_world_t *w, const ecs_component_id_t *ids, uint32_t n)
+{
+    for (uint32_t ai = 0; ai < w->archetypes.size; ++ai)
+    {
+        const ecs_archetype_t *a = ecs_arch_at(w, ai);
+        if (a->type_ids.size != n)
+            continue;
+        if (n && memcmp(a->type_ids.data, ids, (size_t)n * sizeof(ecs_component_id_t)) != 0)
+            continue;
+        return ai;
+    }
+    return ECS_INVALID_U32;
+}
+
+static uint32_t ecs_arch_get_or_create(ecs_world_t *w, const ecs_component_id_t *ids, uint32_t n)
+{
+    uint32_t found = ecs_arch_find(w, ids, n);
+    if (found != ECS_INVALID_U32)
+        return found;
+
+    ecs_archetype_t a = (ecs_archetype_t){0};
+    a.type_ids = create_vector(ecs_component_id_t);
+    a.column_offsets = create_vector(uint32_t);
+    a.column_sizes = create_vector(uint32_t);
+    a.edges = create_vector(ecs_archetype_edge_t);
+    a.chunks = create_vector(ecs_chunk_t);
+
+    uint32_t z = 0;
+    vector_resize(&a.type_ids, n, &z);
+    vector_resize(&a.column_offsets, n, &z);
+    vector_resize(&a.column_sizes, n, &z);
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        ecs_vec_u32_set(&a.type_ids, i, ids[i]);
+        a.mask |= ecs_arch_type_bit(ids[i]);
+    }
+
+    ecs_arch_layout(w, &a);
+
+    vector_push_back(&w->archetypes, &a);
+    return w->archetypes.size - 1;
+}
+
+static ecs_archetype_edge_t *ecs_arch_edge(ecs_archetype_t *a, ecs_component_id_t type_id)
+{
+    ecs_archetype_edge_t *e = NULL;
+    VECTOR_FOR_EACH(a->edges, ecs_archetype_edge_t, e)
+    {
+        if (e->type_id == type_id)
+            return e;
+    }
+
+    ecs_archetype_edge_t ne = {type_id, ECS_INVALID_U32, ECS_INVALID_U32};
+    vector_push_back(&a->edges, &ne);
+    return vector_back_type(&a->edges, ecs_archetype_edge_t);
+}
+
+static uint32_t ecs_arch_transition(ecs_world_t *w, uint32_t from, ecs_component_id_t type_id, int add)
+{
+    if (from != ECS_INVALID_U32)
+    {
+        ecs_archetype_edge_t *edge = ecs_arch_edge(ecs_arch_at(w, from), type_id);
+        uint32_t cached = add ? edge->add : edge->remove;
+        if (cached != ECS_INVALID_U32)
+            return cached;
+    }
+
+    vector_t ids = create_vector(ecs_component_id_t);
+
+    if (from != ECS_INVALID_U32)
+    {
+        const ecs_archetype_t *src = ecs_arch_at(w, from);
+        for (uint32_t i = 0; i < src->type_ids.size; ++i)
+        {
+            ecs_component_id_t id = ecs_vec_u32_get(&src->type_ids, i);
+            if (id == type_id)
+                continue;
+            if (add && type_id < id && (ids.size == 0 || ecs_vec_u32_get(&ids, ids.size - 1) < type_id))
+                vector_push_back(&ids, &type_id);
+            vector_push_back(&ids, &id);
+        }
+    }
+
+    if (add && (ids.size == 0 || ecs_vec_u32_get(&ids, ids.size - 1) < type_id))
+        vector_push_back(&ids, &type_id);
+
+    uint32_t to = ECS_INVALID_U32;
+    if (ids.size)
+        to = ecs_arch_get_or_create(w, (const ecs_component_id_t *)ids.data, ids.size);
+
+    vector_free(&ids);
+
+    if (from != ECS_INVALID_U32)
+    {
+        ecs_archetype_edge_t *edge = ecs_arch_edge(ecs_arch_at(w, from), type_id);
+        if (add)
+            edge->add = to;
+        else
+            edge->remove = to;
+    }
+
+    return to;
+}
+
+static uint32_t ecs_arch_alloc_row(ecs_archetype_t *a, uint32_t entity_index)
+{
+    uint32_t row = a->count;
+    uint32_t ci = row / a->row_capacity;
+
+    if (ci >= a->chunks.size)
+    {
+        ecs_chunk_t c = (ecs_chunk_t){0};
+        c.data = (uint8_t *)calloc(1, a->chunk_bytes);
+        if (!c.data)
+            return ECS_INVALID_U32;
+        vector_push_back(&a->chunks, &c);
+    }
+
+    ecs_chunk_t *c = vector_at_type(&a->chunks, ci, ecs_chunk_t);
+    ecs_arch_chunk_entities(c)[c->count] = entity_index;
+    c->count++;
+    a->count++;
+    return row;
+}
+
+static uint8_t *ecs_arch_row_ptr(const ecs_archetype_t *a, uint32_t row, uint32_t column)
+{
+    const ecs_chunk_t *c = (const ecs_chunk_t *)a->chunks.data + row / a->row_capacity;
+    return ecs_arch_chunk_column(a, c, column) + (size_t)(row % a->row_capacity) * ecs_vec_u32_get(&a->column_sizes, column);
+}
+
+/* Swap-removes a row so every chunk but the last stays full. */
+static void ecs_arch_free_row(ecs_world_t *w, ecs_archetype_t *a, uint32_t row)
+{
+    uint32_t last = a->count - 1u;
+
+    ecs_chunk_t *lc = vector_at_type(&a->chunks, last / a->row_capacity, ecs_chunk_t);
+
+    if (row != last)
+    {
+        for (uint32_t col = 0; col < a->type_ids.size; ++col)
+            memcpy(ecs_arch_row_ptr(a, row, col), ecs_arch_row_ptr(a, last, col), ecs_vec_u32_get(&a->column_sizes, col));
+
+        uint32_t moved = ecs_arch_chunk_entities(lc)[last % a->row_capacity];
+        ecs_chunk_t *rc = vector_at_type(&a->chunks, row / a->row_capacity, ecs_chunk_t);
+        ecs_arch_chunk_entities(rc)[row % a->row_capacity] = moved;
+        ecs_arch_record(w, moved)->row = row;
+    }
+
+    lc->count--;
+    a->count--;
+
+    if (lc->count == 0)
+    {
+        free(lc->data);
+        vector_pop_back(&a->chunks);
+    }
+}
+
+/* Returns 0 when no row could be allocated in `to`; the entity then stays where it was. */
+static int ecs_arch_move(ecs_world_t *w, uint32_t entity_index, uint32_t to)
+{
+    ecs_entity_record_t *rec = ecs_arch_record(w, entity_index);
+    uint32_t from = rec->archetype;
+    uint32_t from_row = rec->row;
+
+    uint32_t to_row = ECS_INVALID_U32;
+    if (to != ECS_INVALID_U32)
+    {
+        ecs_archetype_t *dst = ecs_arch_at(w, to);
+        to_row = ecs_arch_alloc_row(dst, entity_index);
+        if (to_row == ECS_INVALID_U32)
+            return 0;
+
+        if (from != ECS_INVALID_U32)
+        {
+            ecs_archetype_t *src = ecs_arch_at(w, from);
+            for (uint32_t col = 0; col < src->type_ids.size; ++col)
+            {
+                uint32_t dcol = ecs_arch_column(dst, ecs_vec_u32_get(&src->type_ids, col));
+                if (dcol == ECS_INVALID_U32)
+                    continue;
+                memcpy(ecs_arch_row_ptr(dst, to_row, dcol), ecs_arch_row_ptr(src, from_row, col), ecs_vec_u32_get(&src->column_sizes, col));
+            }
+        }
+    }
+
+    if (from != ECS_INVALID_U32)
+        ecs_arch_free_row(w, ecs_arch_at(w, from), from_row);
+
+    rec = ecs_arch_record(w, entity_index);
+    rec->archetype = to;
+    rec->row = to_row;
+    return 1;
+}
+
+void ecs_arch_world_init(ecs_world_t *w)
+{
+    w->archetypes = create_vector(ecs_archetype_t);
+    w->entity_records = create_vector(ecs_entity_record_t);
+}
+
+void ecs_arch_world_clear(ecs_world_t *w)
+{
+    ecs_archetype_t *a = NULL;
+    VECTOR_FOR_EACH(w->archetypes, ecs_archetype_t, a)
+    {
+        ecs_chunk_t *c = NULL;
+        VECTOR_FOR_EACH(a->chunks, ecs_chunk_t, c)
+        {
+            free(c->data);
+        }
+        vector_clear(&a->chunks);
+        a->count = 0;
+    }
+
+    ecs_entity_record_t inv = {ECS_INVALID_U32, ECS_INVALID_U32};
+    for (uint32_t i = 0; i < w->entity_records.size; ++i)
+        *ecs_arch_record(w, i) = inv;
+}
+
+void ecs_arch_world_destroy(ecs_world_t *w)
+{
+    ecs_arch_world_clear(w);
+
+    ecs_archetype_t *a = NULL;
+    VECTOR_FOR_EACH(w->archetypes, ecs_archetype_t, a)
+    {
+        vector_free(&a->type_ids);
+        vector_free(&a->column_offsets);
+        vector_free(&a->column_sizes);
+        vector_free(&a->edges);
+        vector_free(&a->chunks);
+    }
+
+    vector_free(&w->archetypes);
+    vector_free(&w->entity_records);
+}
+
+void ecs_arch_ensure_entity_capacity(ecs_world_t *w, uint32_t entity_count)
+{
+    if (w->entity_records.size >= entity_count)
+        return;
+
+    ecs_entity_record_t inv = {ECS_INVALID_U32, ECS_INVALID_U32};
+    vector_resize(&w->entity_records, entity_count, &inv);
+}
+
+void *ecs_arch_get(const ecs_world_t *w, uint32_t entity_index, ecs_component_id_t type_id)
+{
+    if (entity_index >= w->entity_records.size)
+        return NULL;
+
+    const ecs_entity_record_t *rec = ecs_arch_record(w, entity_index);
+    if (rec->archetype == ECS_INVALID_U32)
+        return NULL;
+
+    const ecs_archetype_t *a = ecs_arch_at(w, rec->archetype);
+    uint32_t col = ecs_arch_column(a, type_id);
+    if (col == ECS_INVALID_U32)
+        return NULL;
+
+    return ecs_arch_row_ptr(a, rec->row, col);
+}
+
+void *ecs_arch_add(ecs_world_t *w, uint32_t entity_index, ecs_component_id_t type_id, int *out_created)
+{
+    if (out_created)
+        *out_created = 0;
+
+    void *existing = ecs_arch_get(w, entity_index, type_id);
+    if (existing)
+        return existing;
+
+    ecs_arch_ensure_entity_capacity(w, entity_index + 1u);
+
+    uint32_t from = ecs_arch_record(w, entity_index)->archetype;
+    uint32_t to = ecs_arch_transition(w, from, type_id, 1);
+    if (to == ECS_INVALID_U32)
+        return NULL;
+
+    if (!ecs_arch_move(w, entity_index, to))
+        return NULL;
+
+    uint8_t *ptr = (uint8_t *)ecs_arch_get(w, entity_index, type_id);
+    if (ptr)
+    {
+        memset(ptr, 0, ecs_arch_type_size(w, type_id));
+        if (out_created)
+            *out_created = 1;
+    }
+
+    return ptr;
+}
+
+int ecs_arch_remove(ecs_world_t *w, uint32_t entity_index, ecs_component_id_t type_id)
+{
+    if (!ecs_arch_get(w, entity_index, type_id))
+        return 0;
+
+    uint32_t from = ecs_arch_record(w, entity_index)->archetype;
+    uint32_t to = ecs_arch_transition(w, from, type_id, 0);
+
+    return ecs_arch_move(w, entity_index, to);
+}
+
+void ecs_arch_entity_clear(ecs_world_t *w, uint32_t entity_index)
+{
+    if (entity_index >= w->entity_records.size)
+        return;
+    if (ecs_arch_record(w, entity_index)->archetype == ECS_INVALID_U32)
+        return;
+
+    ecs_arch_move(w, entity_index, ECS_INVALID_U32);
+}
+
+uint32_t ecs_arch_count(const ecs_world_t *w, ecs_component_id_t type_id)
+{
+    uint32_t n = 0;
+    for (uint32_t ai = 0; ai < w->archetypes.size; ++ai)
+    {
+        const ecs_archetype_t *a = ecs_arch_at(w, ai);
+        if (ecs_arch_column(a, type_id) != ECS_INVALID_U32)
+            n += a->count;
+    }
+    return n;
+}
+
+uint32_t ecs_arch_entity_at(const ecs_world_t *w, ecs_component_id_t type_id, uint32_t n)
+{
+    for (uint32_t ai = 0; ai < w->archetypes.size; ++ai)
+    {
+        const ecs_archetype_t *a = ecs_arch_at(w, ai);
+        if (ecs_arch_column(a, type_id) == ECS_INVALID_U32)
+            continue;
+
+        if (n < a->count)
+        {
+            const ecs_chunk_t *c = (const ecs_chunk_t *)a->chunks.data + n / a->row_capacity;
+            return ecs_arch_chunk_entities(c)[n % a->row_capacity];
+        }
+
+        n -= a->count;
+    }
+    return ECS_INVALID_U32;
+}
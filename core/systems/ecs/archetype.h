@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "core/systems/ecs/world.h"
+
+#define ECS_ARCH_CHUNK_BYTES (16u * 1024u)
+#define ECS_ARCH_COLUMN_ALIGN 16u
+
+typedef struct ecs_chunk_t
+{
+    uint8_t *data;
+    uint32_t count;
+} ecs_chunk_t;
+
+typedef struct ecs_archetype_edge_t
+{
+    ecs_component_id_t type_id;
+    uint32_t add;
+    uint32_t remove;
+} ecs_archetype_edge_t;
+
+typedef struct ecs_archetype_t
+{
+    vector_t type_ids;
+    vector_t column_offsets;
+    vector_t column_sizes;
+    vector_t edges;
+    vector_t chunks;
+
+    uint64_t mask;
+    uint32_t row_capacity;
+    uint32_t chunk_bytes;
+    uint32_t count;
+} ecs_archetype_t;
+
+typedef struct ecs_entity_record_t
+{
+    uint32_t archetype;
+    uint32_t row;
+} ecs_entity_record_t;
+
+void ecs_arch_world_init(ecs_world_t *w);
+void ecs_arch_world_destroy(ecs_world_t *w);
+void ecs_arch_world_clear(ecs_world_t *w);
+void ecs_arch_ensure_entity_capacity(ecs_world_t *w, uint32_t entity_count);
+
+void *ecs_arch_add(ecs_world_t *w, uint32_t entity_index, ecs_component_id_t type_id, int *out_created);
+void *ecs_arch_get(const ecs_world_t *w, uint32_t entity_index, ecs_component_id_t type_id);
+int ecs_arch_remove(ecs_world_t *w, uint32_t entity_index, ecs_component_id_t type_id);
+void ecs_arch_entity_clear(ecs_world_t *w, uint32_t entity_index);
+
+uint32_t ecs_arch_count(const ecs_world_t *w, ecs_component_id_t type_id);
+uint32_t ecs_arch_entity_at(const ecs_world_t *w, ecs_component_id_t type_id, uint32_t n);
+
+uint32_t ecs_arch_column(const ecs_archetype_t *a, ecs_component_id_t type_id);
+
+static inline uint64_t ecs_arch_type_bit(ecs_component_id_t type_id)
+{
+    return 1ull << (type_id & 63u);
+}
+
+static inline uint32_t *ecs_arch_chunk_entities(const ecs_chunk_t *c)
+{
+    return (uint32_t *)c->data;
+}
+
+static inline uint8_t *ecs_arch_chunk_column(const ecs_archetype_t *a, const ecs_chunk_t *c, uint32_t column)
+{
+    return c->data + ((const uint32_t *)a->column_offsets.data)[column];
+}
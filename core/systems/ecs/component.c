@@ -6,19 +6,72 @@ static const ecs_type_info_t *ecs_type_at_const(const ecs_world_t *w, ecs_compon
     return (const ecs_type_info_t *)((uint8_t *)w->types.data + (size_t)id * w->types.element_size);
 }
 
+static uint32_t ecs_name_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+    while (*s)
+    {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h ? h : 1u;
+}
+
+static void ecs_type_lookup_insert(ecs_world_t *w, ecs_component_id_t id)
+{
+    uint32_t cap = w->type_lookup.size;
+    if (!cap)
+        return;
+
+    uint32_t mask = cap - 1u;
+    uint32_t i = ecs_type_at_const(w, id)->name_hash & mask;
+
+    while (ecs_vec_u32_get(&w->type_lookup, i) != 0)
+        i = (i + 1u) & mask;
+
+    ecs_vec_u32_set(&w->type_lookup, i, id);
+}
+
+static void ecs_type_lookup_grow(ecs_world_t *w)
+{
+    uint32_t need = (w->types.size) * 2u;
+    if (w->type_lookup.size >= need)
+        return;
+
+    uint32_t cap = w->type_lookup.size ? w->type_lookup.size : 16u;
+    while (cap < need)
+        cap *= 2u;
+
+    uint32_t z = 0;
+    vector_clear(&w->type_lookup);
+    vector_resize(&w->type_lookup, cap, &z);
+
+    for (uint32_t i = 1; i < w->types.size; ++i)
+        ecs_type_lookup_insert(w, (ecs_component_id_t)i);
+}
+
 ecs_component_id_t ecs_component_id_by_name(const ecs_world_t *w, const char *name)
 {
     if (!w || !name || !name[0])
         return 0;
 
-    for (uint32_t i = 1; i < w->types.size; ++i)
+    uint32_t cap = w->type_lookup.size;
+    if (!cap)
+        return 0;
+
+    uint32_t h = ecs_name_hash(name);
+    uint32_t mask = cap - 1u;
+
+    for (uint32_t i = h & mask;; i = (i + 1u) & mask)
     {
-        const ecs_type_info_t *t = ecs_type_at_const(w, (ecs_component_id_t)i);
-        if (t->name && strcmp(t->name, name) == 0)
-            return (ecs_component_id_t)i;
-    }
+        uint32_t id = ecs_vec_u32_get(&w->type_lookup, i);
+        if (id == 0)
+            return 0;
 
-    return 0;
+        const ecs_type_info_t *t = ecs_type_at_const(w, (ecs_component_id_t)id);
+        if (t->name_hash == h && t->name && strcmp(t->name, name) == 0)
+            return (ecs_component_id_t)id;
+    }
 }
 
 ecs_component_id_t ecs_register_component_type(
@@ -40,6 +93,8 @@ ecs_component_id_t ecs_register_component_type(
 
     ecs_type_info_t t = (ecs_type_info_t){0};
     t.name = ecs_strdup_local(name);
+    t.name_hash = ecs_name_hash(name);
+    t.pool_index = ECS_INVALID_U32;
     t.size = size;
     t.base_offset = base_offset;
     t.save_fn = save_fn;
@@ -51,5 +106,41 @@ ecs_component_id_t ecs_register_component_type(
     ecs_component_id_t id = (ecs_component_id_t)(w->types.size - 1);
     ecs_pool_get_or_create(w, id);
 
+    uint32_t before = w->type_lookup.size;
+    ecs_type_lookup_grow(w);
+    if (before == w->type_lookup.size)
+        ecs_type_lookup_insert(w, id);
+
+    return id;
+}
+
+void ecs_component_set_flags(ecs_world_t *w, ecs_component_id_t id, uint32_t flags)
+{
+    if (!w || !id || id >= w->types.size)
+        return;
+    ((ecs_type_info_t *)vector_impl_at(&w->types, id))->flags = flags;
+}
+
+ecs_component_id_t ecs_component_slot_resolve_slow(ecs_world_t *w, ecs_component_slot_t *slot, const char *name, uint32_t size, uint32_t base_offset)
+{
+    if (!w || !slot)
+        return 0;
+
+    ecs_component_id_t id = ecs_register_component_type(w, name, size, base_offset, NULL, NULL, NULL);
+    if (id)
+        atomic_store_u64_relaxed(&slot->key, ((uint64_t)w->serial << 32) | (uint64_t)id);
+
+    return id;
+}
+
+ecs_component_id_t ecs_component_slot_lookup_slow(const ecs_world_t *w, ecs_component_slot_t *slot, const char *name)
+{
+    if (!w || !slot)
+        return 0;
+
+    ecs_component_id_t id = ecs_component_id_by_name(w, name);
+    if (id)
+        atomic_store_u64_relaxed(&slot->key, ((uint64_t)w->serial << 32) | (uint64_t)id);
+
     return id;
 }
@@ -5,9 +5,24 @@
 #include <string.h>
 
 #include "ecs_types.h"
+#include "world.h"
+#include "utils/threads.h"
 
 typedef struct ecs_world_t ecs_world_t;
 
+/* Per-type cache of a component id. The high 32 bits hold the serial of the
+   world the id was resolved against, so a slot is reused only for that world.
+   Slots are shared by every world and thread; the key is read and written as
+   one relaxed atomic word, so a reader sees either a whole key or a stale one
+   that fails the serial check and takes the slow path. */
+typedef struct ecs_component_slot_t
+{
+    volatile uint64_t key;
+} ecs_component_slot_t;
+
+#define ECS_COMPONENT_DECLARE(T) extern ecs_component_slot_t ecs_slot_##T
+#define ECS_COMPONENT_DEFINE(T) ecs_component_slot_t ecs_slot_##T = {0}
+
 ecs_component_id_t ecs_register_component_type(
     ecs_world_t *w,
     const char *name,
@@ -18,9 +33,33 @@ ecs_component_id_t ecs_register_component_type(
     ecs_component_ctor_fn ctor_fn);
 
 ecs_component_id_t ecs_component_id_by_name(const ecs_world_t *w, const char *name);
+void ecs_component_set_flags(ecs_world_t *w, ecs_component_id_t id, uint32_t flags);
+
+ecs_component_id_t ecs_component_slot_resolve_slow(ecs_world_t *w, ecs_component_slot_t *slot, const char *name, uint32_t size, uint32_t base_offset);
+ecs_component_id_t ecs_component_slot_lookup_slow(const ecs_world_t *w, ecs_component_slot_t *slot, const char *name);
+
+static inline ecs_component_id_t ecs_component_slot_resolve(ecs_world_t *w, ecs_component_slot_t *slot, const char *name, uint32_t size, uint32_t base_offset)
+{
+    const uint64_t key = atomic_load_u64_relaxed(&slot->key);
+    if (w && (uint32_t)(key >> 32) == w->serial)
+        return (ecs_component_id_t)(key & 0xFFFFFFFFu);
+    return ecs_component_slot_resolve_slow(w, slot, name, size, base_offset);
+}
+
+static inline ecs_component_id_t ecs_component_slot_lookup(const ecs_world_t *w, ecs_component_slot_t *slot, const char *name)
+{
+    const uint64_t key = atomic_load_u64_relaxed(&slot->key);
+    if (w && (uint32_t)(key >> 32) == w->serial)
+        return (ecs_component_id_t)(key & 0xFFFFFFFFu);
+    return ecs_component_slot_lookup_slow(w, slot, name);
+}
 
 #define ecs_register_component(w, T) ecs_register_component_type((w), #T, (uint32_t)sizeof(T), (uint32_t)offsetof(T, base), NULL, NULL, NULL)
 #define ecs_register_component_ex(w, T, save_fn, load_fn) ecs_register_component_type((w), #T, (uint32_t)sizeof(T), (uint32_t)offsetof(T, base), (save_fn), (load_fn), NULL)
 #define ecs_register_component_ctor(w, T, ctor_fn) ecs_register_component_type((w), #T, (uint32_t)sizeof(T), (uint32_t)offsetof(T, base), NULL, NULL, (ctor_fn))
 #define ecs_register_component_ex_ctor(w, T, save_fn, load_fn, ctor_fn) ecs_register_component_type((w), #T, (uint32_t)sizeof(T), (uint32_t)offsetof(T, base), (save_fn), (load_fn), (ctor_fn))
-#define ecs_component_id(w, T) ecs_component_id_by_name((w), #T)
+
+/* Typed id access. Registers T on first use like ecs_register_component, then
+   costs one compare per call. T must have an ECS_COMPONENT_DECLARE in scope. */
+#define ecs_component_slot(w, T) ecs_component_slot_resolve((w), &ecs_slot_##T, #T, (uint32_t)sizeof(T), (uint32_t)offsetof(T, base))
+#define ecs_component_id(w, T) ecs_component_slot_lookup((w), &ecs_slot_##T, #T)
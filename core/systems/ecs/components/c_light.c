@@ -4,6 +4,8 @@
 
 #include "core/systems/ecs/component.h"
 
+ECS_COMPONENT_DEFINE(c_light_t);
+
 static void c_light_ctor(void *component)
 {
     c_light_t *l = (c_light_t *)component;
@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 #include "ecs/ecs_types.h"
+#include "ecs/component.h"
 #include "types/vec3.h"
 #include "renderer/light.h"
 
@@ -21,4 +22,6 @@ typedef struct c_light_t
 
 typedef struct ecs_world_t ecs_world_t;
 
+ECS_COMPONENT_DECLARE(c_light_t);
+
 void c_light_register(ecs_world_t *w);
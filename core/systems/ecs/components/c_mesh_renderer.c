@@ -1,14 +1,66 @@
 #include "c_mesh_renderer.h"
 
+#include <string.h>
+
 #include "ecs/component.h"
 
+ECS_COMPONENT_DEFINE(c_mesh_renderer_t);
+
+// Scene records: u64 value, u16 type, u16 meta. Scenes written while ihandle_t was 8 bytes store
+// the raw struct: u32 value as [generation:16][index:16], then type and meta. Records of the raw
+// 16-byte struct carry 4 padding bytes after meta.
+#define C_MESH_RENDERER_RECORD_SIZE 12u
+#define C_MESH_RENDERER_RECORD_SIZE_V1 8u
+#define C_MESH_RENDERER_RECORD_SIZE_RAW 16u
+
 static void c_mesh_renderer_ctor(void *component)
 {
     c_mesh_renderer_t *m = (c_mesh_renderer_t *)component;
     m->model = ihandle_invalid();
 }
 
+static int c_mesh_renderer_save(const void *component, vector_t *out_bytes)
+{
+    const c_mesh_renderer_t *m = (const c_mesh_renderer_t *)component;
+
+    uint8_t rec[C_MESH_RENDERER_RECORD_SIZE];
+    memcpy(rec, &m->model.value, 8);
+    memcpy(rec + 8, &m->model.type, 2);
+    memcpy(rec + 10, &m->model.meta, 2);
+
+    uint32_t old = out_bytes->size;
+    uint8_t z = 0;
+    vector_resize(out_bytes, old + C_MESH_RENDERER_RECORD_SIZE, &z);
+    memcpy((uint8_t *)out_bytes->data + old, rec, C_MESH_RENDERER_RECORD_SIZE);
+    return 1;
+}
+
+static int c_mesh_renderer_load(void *component, const uint8_t *payload, uint32_t payload_size)
+{
+    c_mesh_renderer_t *m = (c_mesh_renderer_t *)component;
+
+    if (payload_size == C_MESH_RENDERER_RECORD_SIZE_V1)
+    {
+        uint32_t value = 0;
+        ihandle_type_t type = 0;
+        uint16_t meta = 0;
+        memcpy(&value, payload, 4);
+        memcpy(&type, payload + 4, 2);
+        memcpy(&meta, payload + 6, 2);
+        m->model = ihandle_with_meta(ihandle_make(type, value & 0xFFFFu, value >> 16), meta);
+        return 1;
+    }
+
+    if (payload_size != C_MESH_RENDERER_RECORD_SIZE && payload_size != C_MESH_RENDERER_RECORD_SIZE_RAW)
+        return 0;
+
+    memcpy(&m->model.value, payload, 8);
+    memcpy(&m->model.type, payload + 8, 2);
+    memcpy(&m->model.meta, payload + 10, 2);
+    return 1;
+}
+
 void c_mesh_renderer_register(ecs_world_t *w)
 {
-    ecs_register_component_ctor(w, c_mesh_renderer_t, c_mesh_renderer_ctor);
+    ecs_register_component_ex_ctor(w, c_mesh_renderer_t, c_mesh_renderer_save, c_mesh_renderer_load, c_mesh_renderer_ctor);
 }
@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 #include "ecs/ecs_types.h"
+#include "ecs/component.h"
 #include "handle.h"
 
 typedef struct c_mesh_renderer_t
@@ -14,4 +15,6 @@ typedef struct c_mesh_renderer_t
 
 typedef struct ecs_world_t ecs_world_t;
 
+ECS_COMPONENT_DECLARE(c_mesh_renderer_t);
+
 void c_mesh_renderer_register(ecs_world_t *w);
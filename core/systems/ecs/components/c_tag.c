@@ -2,6 +2,8 @@
 
 #include "ecs/component.h"
 
+ECS_COMPONENT_DEFINE(c_tag_t);
+
 static void c_tag_ctor(void *component)
 {
     c_tag_t *t = (c_tag_t *)component;
@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 #include "ecs/ecs_types.h"
+#include "ecs/component.h"
 
 #define C_TAG_NAME_MAX 64u
 
@@ -18,4 +19,6 @@ typedef struct c_tag_t
 
 typedef struct ecs_world_t ecs_world_t;
 
+ECS_COMPONENT_DECLARE(c_tag_t);
+
 void c_tag_register(ecs_world_t *w);
@@ -1,6 +1,8 @@
 #include "c_transform.h"
 #include "ecs/component.h"
 
+ECS_COMPONENT_DEFINE(c_transform_t);
+
 static void c_transform_ctor(void *component)
 {
     c_transform_t *t = (c_transform_t *)component;
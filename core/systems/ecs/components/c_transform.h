@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 #include "ecs/ecs_types.h"
+#include "ecs/component.h"
 #include "types/vec3.h"
 
 typedef struct c_transform_t
@@ -16,4 +17,6 @@ typedef struct c_transform_t
 
 typedef struct ecs_world_t ecs_world_t;
 
+ECS_COMPONENT_DECLARE(c_transform_t);
+
 void c_transform_register(ecs_world_t *w);
@@ -0,0 +1,21 @@
+#include "c_world_transform.h"
+
+#include "ecs/component.h"
+
+ECS_COMPONENT_DEFINE(c_world_transform_t);
+
+static void c_world_transform_ctor(void *component)
+{
+    c_world_transform_t *t = (c_world_transform_t *)component;
+    t->local = mat4_identity();
+    t->world = mat4_identity();
+    t->src_scale = (vec3){1.0f, 1.0f, 1.0f};
+    t->visible = 1;
+}
+
+void c_world_transform_register(ecs_world_t *w)
+{
+    /* Derived from c_transform_t every frame and added on demand, so scenes never store it. */
+    ecs_component_id_t id = ecs_register_component_ctor(w, c_world_transform_t, c_world_transform_ctor);
+    ecs_component_set_flags(w, id, ECS_TYPE_FLAG_TRANSIENT);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "ecs/ecs_types.h"
+#include "ecs/component.h"
+#include "types/vec3.h"
+#include "types/mat4.h"
+
+typedef struct c_world_transform_t
+{
+    mat4 local;
+    mat4 world;
+
+    vec3 src_position;
+    vec3 src_rotation;
+    vec3 src_scale;
+    ecs_entity_t src_parent;
+
+    uint32_t generation;
+    uint32_t parent_generation;
+
+    uint8_t has_local;
+    uint8_t visible;
+
+    base_component_t base;
+} c_world_transform_t;
+
+typedef struct ecs_world_t ecs_world_t;
+
+ECS_COMPONENT_DECLARE(c_world_transform_t);
+
+void c_world_transform_register(ecs_world_t *w);
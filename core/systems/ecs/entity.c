@@ -1,6 +1,10 @@
 #include "core/systems/ecs/entity.h"
+
+#include <string.h>
+
 #include "core/systems/ecs/internal.h"
 #include "core/systems/ecs/pool.h"
+#include "core/systems/ecs/archetype.h"
 
 ecs_entity_t ecs_world_root(const ecs_world_t *w)
 {
@@ -78,7 +82,11 @@ int ecs_entity_set_parent(ecs_world_t *w, ecs_entity_t e, ecs_entity_t parent)
         return 0;
 
     uint32_t idx = ecs_entity_index(e);
-    ecs_vec_ent_set(&w->entity_parent, idx, parent);
+    if (ecs_vec_ent_get(&w->entity_parent, idx) != parent)
+    {
+        ecs_vec_ent_set(&w->entity_parent, idx, parent);
+        w->hierarchy_version++;
+    }
     return 1;
 }
 
@@ -112,6 +120,7 @@ ecs_entity_t ecs_entity_create(ecs_world_t *w)
     ecs_entity_t e = ecs_entity_pack(idx, gen);
 
     ecs_vec_ent_set(&w->entity_parent, idx, w->root_entity);
+    w->hierarchy_version++;
 
     if (w->required_tag_id && w->required_tag_id < w->types.size)
         ecs_add_raw(w, e, w->required_tag_id);
@@ -148,10 +157,17 @@ void ecs_entity_destroy(ecs_world_t *w, ecs_entity_t e)
     ecs_component_id_t saved_req = w->required_tag_id;
     w->required_tag_id = 0;
 
-    ecs_pool_t *p = NULL;
-    VECTOR_FOR_EACH(w->pools, ecs_pool_t, p)
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+    {
+        ecs_arch_entity_clear(w, idx);
+    }
+    else
     {
-        ecs_remove_raw(w, e, p->type_id);
+        ecs_pool_t *p = NULL;
+        VECTOR_FOR_EACH(w->pools, ecs_pool_t, p)
+        {
+            ecs_remove_raw(w, e, p->type_id);
+        }
     }
 
     w->required_tag_id = saved_req;
@@ -159,6 +175,137 @@ void ecs_entity_destroy(ecs_world_t *w, ecs_entity_t e)
     ecs_vec_u8_set(&w->entity_alive, idx, 0);
     ecs_vec_u32_set(&w->entity_gen, idx, ecs_vec_u32_get(&w->entity_gen, idx) + 1);
     ecs_vec_ent_set(&w->entity_parent, idx, 0);
+    w->hierarchy_version++;
 
     vector_push_back(&w->free_list, &idx);
 }
+
+static uint32_t ecs_parent_index_alive(const ecs_world_t *w, uint32_t idx)
+{
+    ecs_entity_t p = ecs_vec_ent_get(&w->entity_parent, idx);
+    if (p == 0)
+        return ECS_INVALID_U32;
+    uint32_t pi = ecs_entity_index(p);
+    if (!ecs_entity_is_alive_indexed(w, pi, ecs_entity_gen(p)))
+        return ECS_INVALID_U32;
+    return pi;
+}
+
+static void ecs_hierarchy_rebuild_order(ecs_world_t *w)
+{
+    uint32_t n = w->entity_alive.size;
+
+    vector_t depth = create_vector(uint32_t);
+    uint32_t inv = ECS_INVALID_U32;
+    vector_resize(&depth, n, &inv);
+
+    vector_t chain = create_vector(uint32_t);
+
+    uint32_t max_depth = 0;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (!ecs_vec_u8_get(&w->entity_alive, i))
+            continue;
+        if (ecs_vec_u32_get(&depth, i) != ECS_INVALID_U32)
+            continue;
+
+        vector_clear(&chain);
+
+        uint32_t cur = i;
+        uint32_t base = 0;
+
+        while (cur != ECS_INVALID_U32)
+        {
+            uint32_t d = ecs_vec_u32_get(&depth, cur);
+            if (d != ECS_INVALID_U32)
+            {
+                base = d + 1;
+                break;
+            }
+
+            vector_push_back(&chain, &cur);
+            if (chain.size > n)
+                break;
+
+            cur = ecs_parent_index_alive(w, cur);
+        }
+
+        for (uint32_t k = chain.size; k-- > 0;)
+        {
+            uint32_t ci = ecs_vec_u32_get(&chain, k);
+            ecs_vec_u32_set(&depth, ci, base);
+            if (base > max_depth)
+                max_depth = base;
+            base++;
+        }
+    }
+
+    vector_t offsets = create_vector(uint32_t);
+    uint32_t z = 0;
+    vector_resize(&offsets, max_depth + 2, &z);
+
+    uint32_t alive = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t d = ecs_vec_u32_get(&depth, i);
+        if (d == ECS_INVALID_U32)
+            continue;
+        ecs_vec_u32_set(&offsets, d + 1, ecs_vec_u32_get(&offsets, d + 1) + 1);
+        alive++;
+    }
+
+    for (uint32_t d = 1; d < offsets.size; ++d)
+        ecs_vec_u32_set(&offsets, d, ecs_vec_u32_get(&offsets, d) + ecs_vec_u32_get(&offsets, d - 1));
+
+    vector_resize(&w->hierarchy_order, alive, &z);
+
+    vector_resize(&w->hierarchy_levels, offsets.size, &z);
+    memcpy(w->hierarchy_levels.data, offsets.data, (size_t)offsets.size * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t d = ecs_vec_u32_get(&depth, i);
+        if (d == ECS_INVALID_U32)
+            continue;
+        uint32_t at = ecs_vec_u32_get(&offsets, d);
+        ecs_vec_u32_set(&w->hierarchy_order, at, i);
+        ecs_vec_u32_set(&offsets, d, at + 1);
+    }
+
+    vector_free(&offsets);
+    vector_free(&chain);
+    vector_free(&depth);
+
+    w->hierarchy_order_version = w->hierarchy_version;
+}
+
+const uint32_t *ecs_hierarchy_order(ecs_world_t *w, uint32_t *out_count)
+{
+    if (out_count)
+        *out_count = 0;
+    if (!w)
+        return NULL;
+
+    if (w->hierarchy_order_version != w->hierarchy_version)
+        ecs_hierarchy_rebuild_order(w);
+
+    if (out_count)
+        *out_count = w->hierarchy_order.size;
+    return (const uint32_t *)w->hierarchy_order.data;
+}
+
+const uint32_t *ecs_hierarchy_levels(ecs_world_t *w, uint32_t *out_level_count)
+{
+    if (out_level_count)
+        *out_level_count = 0;
+    if (!w)
+        return NULL;
+
+    if (w->hierarchy_order_version != w->hierarchy_version)
+        ecs_hierarchy_rebuild_order(w);
+
+    if (out_level_count && w->hierarchy_levels.size)
+        *out_level_count = w->hierarchy_levels.size - 1u;
+    return (const uint32_t *)w->hierarchy_levels.data;
+}
@@ -29,3 +29,7 @@ int ecs_entity_is_alive(const ecs_world_t *w, ecs_entity_t e);
 ecs_entity_t ecs_entity_get_parent(const ecs_world_t *w, ecs_entity_t e);
 int ecs_entity_set_parent(ecs_world_t *w, ecs_entity_t e, ecs_entity_t parent);
 int ecs_entity_is_root(const ecs_world_t *w, ecs_entity_t e);
+
+const uint32_t *ecs_hierarchy_order(ecs_world_t *w, uint32_t *out_count);
+// Depth level offsets into ecs_hierarchy_order: level d spans [levels[d], levels[d + 1]).
+const uint32_t *ecs_hierarchy_levels(ecs_world_t *w, uint32_t *out_level_count);
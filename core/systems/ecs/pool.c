@@ -1,15 +1,17 @@
 #include "pool.h"
 #include "internal.h"
+#include "archetype.h"
 
 static ecs_pool_t *ecs_pool_find(ecs_world_t *w, ecs_component_id_t type_id)
 {
-    ecs_pool_t *p = NULL;
-    VECTOR_FOR_EACH(w->pools, ecs_pool_t, p)
-    {
-        if (p->type_id == type_id)
-            return p;
-    }
-    return NULL;
+    if (type_id == 0 || type_id >= w->types.size)
+        return NULL;
+
+    const ecs_type_info_t *ti = (const ecs_type_info_t *)vector_impl_at(&w->types, type_id);
+    if (ti->pool_index >= w->pools.size)
+        return NULL;
+
+    return (ecs_pool_t *)vector_impl_at(&w->pools, ti->pool_index);
 }
 
 ecs_pool_t *ecs_pool_get_or_create(ecs_world_t *w, ecs_component_id_t type_id)
@@ -17,6 +19,8 @@ ecs_pool_t *ecs_pool_get_or_create(ecs_world_t *w, ecs_component_id_t type_id)
     ecs_pool_t *p = ecs_pool_find(w, type_id);
     if (p)
         return p;
+    if (type_id == 0 || type_id >= w->types.size)
+        return NULL;
 
     ecs_pool_t np = (ecs_pool_t){0};
     np.type_id = type_id;
@@ -28,6 +32,10 @@ ecs_pool_t *ecs_pool_get_or_create(ecs_world_t *w, ecs_component_id_t type_id)
     vector_resize(&np.sparse, w->entity_gen.size, &inv);
 
     vector_push_back(&w->pools, &np);
+
+    ecs_type_info_t *ti = (ecs_type_info_t *)vector_impl_at(&w->types, type_id);
+    ti->pool_index = w->pools.size - 1;
+
     return vector_back_type(&w->pools, ecs_pool_t);
 }
 
@@ -55,39 +63,60 @@ static void ecs_pool_sparse_set(ecs_pool_t *p, uint32_t entity_index, uint32_t d
     ecs_vec_u32_set(&p->sparse, entity_index, dense_index);
 }
 
-int ecs_has_raw(const ecs_world_t *w, ecs_entity_t e, ecs_component_id_t type_id)
+static uint32_t ecs_pool_dense_index(const ecs_world_t *w, ecs_entity_t e, ecs_component_id_t type_id, ecs_pool_t **out_pool)
 {
     if (!w)
-        return 0;
+        return ECS_INVALID_U32;
     if (!ecs_valid_entity_for_world(w, e))
-        return 0;
-    if (type_id == 0 || type_id >= w->types.size)
-        return 0;
+        return ECS_INVALID_U32;
 
     ecs_pool_t *p = ecs_pool_find((ecs_world_t *)w, type_id);
     if (!p)
-        return 0;
+        return ECS_INVALID_U32;
 
     uint32_t idx = ecs_entity_index(e);
     uint32_t di = ecs_pool_sparse_get(p, idx);
     if (di == ECS_INVALID_U32)
-        return 0;
+        return ECS_INVALID_U32;
     if (di >= p->dense_entities.size)
-        return 0;
+        return ECS_INVALID_U32;
 
-    uint32_t owner = *(uint32_t *)vector_impl_at(&p->dense_entities, di);
-    return owner == idx;
+    uint32_t owner = ecs_vec_u32_get(&p->dense_entities, di);
+    if (owner != idx)
+        return ECS_INVALID_U32;
+
+    if (out_pool)
+        *out_pool = p;
+    return di;
+}
+
+int ecs_has_raw(const ecs_world_t *w, ecs_entity_t e, ecs_component_id_t type_id)
+{
+    if (w && w->storage == ECS_STORAGE_ARCHETYPE)
+    {
+        if (!ecs_valid_entity_for_world(w, e))
+            return 0;
+        return ecs_arch_get(w, ecs_entity_index(e), type_id) != NULL;
+    }
+
+    return ecs_pool_dense_index(w, e, type_id, NULL) != ECS_INVALID_U32;
 }
 
 void *ecs_get_raw(ecs_world_t *w, ecs_entity_t e, ecs_component_id_t type_id)
 {
-    if (!ecs_has_raw(w, e, type_id))
-        return NULL;
+    if (w && w->storage == ECS_STORAGE_ARCHETYPE)
+    {
+        if (!ecs_valid_entity_for_world(w, e))
+            return NULL;
+        return ecs_arch_get(w, ecs_entity_index(e), type_id);
+    }
 
-    ecs_pool_t *p = ecs_pool_find(w, type_id);
-    uint32_t di = ecs_pool_sparse_get(p, ecs_entity_index(e));
+    ecs_pool_t *p = NULL;
+    uint32_t di = ecs_pool_dense_index(w, e, type_id, &p);
+    if (di == ECS_INVALID_U32)
+        return NULL;
 
-    ecs_type_info_t *ti = (ecs_type_info_t *)vector_impl_at(&w->types, type_id);
+    const ecs_type_info_t *ti = (const ecs_type_info_t *)vector_impl_at(&w->types, type_id);
     return (void *)((uint8_t *)p->dense_data.data + (size_t)di * ti->size);
 }
 
@@ -106,30 +135,42 @@ void *ecs_add_raw(ecs_world_t *w, ecs_entity_t e, ecs_component_id_t type_id)
             ecs_add_raw(w, e, w->required_tag_id);
     }
 
-    ecs_pool_t *p = ecs_pool_get_or_create(w, type_id);
     uint32_t idx = ecs_entity_index(e);
+    ecs_type_info_t *ti = (ecs_type_info_t *)vector_impl_at(&w->types, type_id);
+    uint8_t *ptr = NULL;
 
-    if (idx >= p->sparse.size)
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
     {
-        uint32_t inv = ECS_INVALID_U32;
-        vector_resize(&p->sparse, idx + 1, &inv);
+        int created = 0;
+        ptr = (uint8_t *)ecs_arch_add(w, idx, type_id, &created);
+        if (!ptr || !created)
+            return (void *)ptr;
     }
+    else
+    {
+        ecs_pool_t *p = ecs_pool_get_or_create(w, type_id);
 
-    uint32_t di = ecs_pool_sparse_get(p, idx);
-    if (di != ECS_INVALID_U32)
-        return ecs_get_raw(w, e, type_id);
+        if (idx >= p->sparse.size)
+        {
+            uint32_t inv = ECS_INVALID_U32;
+            vector_resize(&p->sparse, idx + 1, &inv);
+        }
 
-    ecs_type_info_t *ti = (ecs_type_info_t *)vector_impl_at(&w->types, type_id);
+        uint32_t di = ecs_pool_sparse_get(p, idx);
+        if (di != ECS_INVALID_U32)
+            return ecs_get_raw(w, e, type_id);
 
-    uint32_t dense_index = p->dense_entities.size;
-    vector_push_back(&p->dense_entities, &idx);
+        uint32_t dense_index = p->dense_entities.size;
+        vector_push_back(&p->dense_entities, &idx);
 
-    uint8_t z = 0;
-    vector_resize(&p->dense_data, (dense_index + 1) * ti->size, &z);
+        uint8_t z = 0;
+        vector_resize(&p->dense_data, (dense_index + 1) * ti->size, &z);
 
-    ecs_pool_sparse_set(p, idx, dense_index);
+        ecs_pool_sparse_set(p, idx, dense_index);
+
+        ptr = (uint8_t *)p->dense_data.data + (size_t)dense_index * ti->size;
+    }
 
-    uint8_t *ptr = (uint8_t *)p->dense_data.data + (size_t)dense_index * ti->size;
     base_component_t *b = (base_component_t *)(ptr + ti->base_offset);
     b->entity = e;
     b->type_id = type_id;
@@ -155,6 +196,9 @@ int ecs_remove_raw(ecs_world_t *w, ecs_entity_t e, ecs_component_id_t type_id)
     if (w->required_tag_id && type_id == w->required_tag_id)
         return 0;
 
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+        return ecs_arch_remove(w, ecs_entity_index(e), type_id);
+
     ecs_pool_t *p = ecs_pool_find(w, type_id);
     if (!p)
         return 0;
@@ -201,6 +245,9 @@ uint32_t ecs_count_raw(const ecs_world_t *w, ecs_component_id_t type_id)
     if (type_id == 0 || type_id >= w->types.size)
         return 0;
 
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+        return ecs_arch_count(w, type_id);
+
     ecs_pool_t *p = ecs_pool_find((ecs_world_t *)w, type_id);
     if (!p)
         return 0;
@@ -215,6 +262,9 @@ void *ecs_dense_raw(ecs_world_t *w, ecs_component_id_t type_id)
     if (type_id == 0 || type_id >= w->types.size)
         return NULL;
 
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+        return NULL;
+
     ecs_pool_t *p = ecs_pool_find(w, type_id);
     if (!p)
         return NULL;
@@ -229,13 +279,25 @@ ecs_entity_t ecs_entity_at_raw(const ecs_world_t *w, ecs_component_id_t type_id,
     if (type_id == 0 || type_id >= w->types.size)
         return 0;
 
-    ecs_pool_t *p = ecs_pool_find((ecs_world_t *)w, type_id);
-    if (!p)
-        return 0;
-    if (dense_index >= p->dense_entities.size)
-        return 0;
+    uint32_t idx = ECS_INVALID_U32;
+
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+    {
+        idx = ecs_arch_entity_at(w, type_id, dense_index);
+        if (idx == ECS_INVALID_U32)
+            return 0;
+    }
+    else
+    {
+        ecs_pool_t *p = ecs_pool_find((ecs_world_t *)w, type_id);
+        if (!p)
+            return 0;
+        if (dense_index >= p->dense_entities.size)
+            return 0;
+
+        idx = *(uint32_t *)vector_impl_at(&p->dense_entities, dense_index);
+    }
 
-    uint32_t idx = *(uint32_t *)vector_impl_at(&p->dense_entities, dense_index);
     uint32_t gen = ecs_vec_u32_get(&w->entity_gen, idx);
     return ecs_entity_pack(idx, gen);
 }
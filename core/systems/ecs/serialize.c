@@ -5,6 +5,7 @@
 
 #include "internal.h"
 #include "pool.h"
+#include "archetype.h"
 
 static void ecs_bytes_write(vector_t *b, const void *p, uint32_t n)
 {
@@ -108,6 +109,38 @@ static int ecs_default_load_raw(void *component, const ecs_type_info_t *ti, cons
     return 1;
 }
 
+static int ecs_save_component(vector_t *out_bytes, const ecs_type_info_t *ti, const uint8_t *comp, uint32_t ent_index)
+{
+    ecs_bytes_write_u32(out_bytes, ent_index);
+
+    uint32_t size_pos = out_bytes->size;
+    ecs_bytes_write_u32(out_bytes, 0);
+
+    uint32_t start = out_bytes->size;
+
+    const base_component_t *b = (const base_component_t *)(comp + ti->base_offset);
+
+    if (b->save_fn)
+    {
+        if (!b->save_fn(comp, out_bytes))
+            return 0;
+    }
+    else if (ti->save_fn)
+    {
+        if (!ti->save_fn(comp, out_bytes))
+            return 0;
+    }
+    else
+    {
+        if (!ecs_default_save_raw(comp, ti, out_bytes))
+            return 0;
+    }
+
+    uint32_t end = out_bytes->size;
+    ecs_bytes_patch_u32(out_bytes, size_pos, end - start);
+    return 1;
+}
+
 static uint32_t ecs_alive_entity_count(const ecs_world_t *w)
 {
     uint32_t n = 0;
@@ -144,12 +177,19 @@ int ecs_scene_save_to_memory(const ecs_world_t *w, vector_t *out_bytes)
         ecs_bytes_write_u32(out_bytes, gen);
     }
 
-    uint32_t type_count = w->types.size > 1 ? (w->types.size - 1) : 0;
+    uint32_t type_count = 0;
+    for (ecs_component_id_t type_id = 1; type_id < w->types.size; ++type_id)
+    {
+        const ecs_type_info_t *ti = (const ecs_type_info_t *)vector_impl_at((vector_t *)&w->types, type_id);
+        type_count += (ti->flags & ECS_TYPE_FLAG_TRANSIENT) ? 0u : 1u;
+    }
     ecs_bytes_write_u32(out_bytes, type_count);
 
     for (ecs_component_id_t type_id = 1; type_id < w->types.size; ++type_id)
     {
         const ecs_type_info_t *ti = (const ecs_type_info_t *)vector_impl_at((vector_t *)&w->types, type_id);
+        if (ti->flags & ECS_TYPE_FLAG_TRANSIENT)
+            continue;
 
         uint16_t name_len = (uint16_t)(ti->name ? strlen(ti->name) : 0);
         ecs_bytes_write(out_bytes, &name_len, 2);
@@ -162,6 +202,23 @@ int ecs_scene_save_to_memory(const ecs_world_t *w, vector_t *out_bytes)
         if (!comp_count)
             continue;
 
+        if (w->storage == ECS_STORAGE_ARCHETYPE)
+        {
+            for (uint32_t ent_index = 0; ent_index < w->entity_alive.size; ++ent_index)
+            {
+                if (!ecs_vec_u8_get(&w->entity_alive, ent_index))
+                    continue;
+
+                const uint8_t *comp = (const uint8_t *)ecs_arch_get(w, ent_index, type_id);
+                if (!comp)
+                    continue;
+
+                if (!ecs_save_component(out_bytes, ti, comp, ent_index))
+                    return 0;
+            }
+            continue;
+        }
+
         ecs_pool_t *p = NULL;
         ecs_pool_t *it = NULL;
         VECTOR_FOR_EACH(w->pools, ecs_pool_t, it)
@@ -178,34 +235,10 @@ int ecs_scene_save_to_memory(const ecs_world_t *w, vector_t *out_bytes)
         for (uint32_t di = 0; di < p->dense_entities.size; ++di)
         {
             uint32_t ent_index = *(uint32_t *)vector_impl_at(&p->dense_entities, di);
-            ecs_bytes_write_u32(out_bytes, ent_index);
-
-            uint32_t size_pos = out_bytes->size;
-            ecs_bytes_write_u32(out_bytes, 0);
-
-            uint32_t start = out_bytes->size;
-
             const uint8_t *comp = (const uint8_t *)p->dense_data.data + (size_t)di * ti->size;
-            const base_component_t *b = (const base_component_t *)(comp + ti->base_offset);
-
-            if (b->save_fn)
-            {
-                if (!b->save_fn(comp, out_bytes))
-                    return 0;
-            }
-            else if (ti->save_fn)
-            {
-                if (!ti->save_fn(comp, out_bytes))
-                    return 0;
-            }
-            else
-            {
-                if (!ecs_default_save_raw(comp, ti, out_bytes))
-                    return 0;
-            }
 
-            uint32_t end = out_bytes->size;
-            ecs_bytes_patch_u32(out_bytes, size_pos, end - start);
+            if (!ecs_save_component(out_bytes, ti, comp, ent_index))
+                return 0;
         }
     }
 
@@ -239,6 +272,9 @@ static void ecs_world_clear_runtime(ecs_world_t *w)
     vector_resize(&w->entity_gen, w->entity_gen.size, &z32);
 
     vector_clear(&w->free_list);
+    w->hierarchy_version++;
+
+    ecs_arch_world_clear(w);
 
     ecs_pool_t *p = NULL;
     VECTOR_FOR_EACH(w->pools, ecs_pool_t, p)
@@ -373,7 +409,8 @@ int ecs_scene_load_from_memory(ecs_world_t *w, const uint8_t *bytes, uint32_t si
             const uint8_t *payload = bytes + o;
             o += payload_size;
 
-            if (!ti)
+            /* Scenes written before a type became transient still carry its records. */
+            if (!ti || (ti->flags & ECS_TYPE_FLAG_TRANSIENT))
                 continue;
 
             ecs_entity_t e = ecs_entity_pack(ent_index, ecs_vec_u32_get(&w->entity_gen, ent_index));
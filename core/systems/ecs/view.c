@@ -2,6 +2,8 @@
 
 #include "core/systems/ecs/internal.h"
 #include "core/systems/ecs/entity.h"
+#include "core/systems/ecs/archetype.h"
+#include "utils/jobs.h"
 
 static ecs_pool_t *ecs_view_pool_at(ecs_world_t *w, uint32_t pool_index)
 {
@@ -49,7 +51,12 @@ bool ecs_view_init(ecs_view_t *v, ecs_world_t *w, uint8_t count, const ecs_compo
     v->w = w;
     v->count = count;
     v->cursor = 0;
+    v->cursor_end = ECS_INVALID_U32;
     v->primary = 0;
+    v->arch_mask = 0;
+    v->arch_cursor = 0;
+    v->arch_end = ECS_INVALID_U32;
+    v->arch_bound = ECS_INVALID_U32;
 
     for (uint8_t i = 0; i < count; ++i)
     {
@@ -64,26 +71,22 @@ bool ecs_view_init(ecs_view_t *v, ecs_world_t *w, uint8_t count, const ecs_compo
         v->comp_sizes[i] = ti ? ti->size : 0;
         if (!v->comp_sizes[i])
             return false;
+
+        v->arch_mask |= ecs_arch_type_bit(id);
     }
 
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+        return true;
+
     uint32_t best = 0xFFFFFFFFu;
     uint8_t primary = 0;
 
     for (uint8_t i = 0; i < count; ++i)
     {
-        uint32_t found = ECS_INVALID_U32;
-
-        for (uint32_t pi = 0; pi < w->pools.size; ++pi)
-        {
-            ecs_pool_t *p = (ecs_pool_t *)vector_impl_at(&w->pools, pi);
-            if (p && p->type_id == v->ids[i])
-            {
-                found = pi;
-                break;
-            }
-        }
+        ecs_type_info_t *ti = (ecs_type_info_t *)vector_impl_at(&w->types, v->ids[i]);
+        uint32_t found = ti->pool_index;
 
-        if (found == ECS_INVALID_U32)
+        if (found >= w->pools.size)
             return false;
 
         v->pool_indices[i] = found;
@@ -107,6 +110,67 @@ void ecs_view_reset(ecs_view_t *v)
     if (!v)
         return;
     v->cursor = 0;
+    v->arch_cursor = 0;
+    v->arch_bound = ECS_INVALID_U32;
+}
+
+static bool ecs_view_bind_archetype(ecs_view_t *v, const ecs_archetype_t *a)
+{
+    if ((a->mask & v->arch_mask) != v->arch_mask)
+        return false;
+
+    for (uint8_t i = 0; i < v->count; ++i)
+    {
+        uint32_t col = ecs_arch_column(a, v->ids[i]);
+        if (col == ECS_INVALID_U32)
+            return false;
+        v->arch_columns[i] = col;
+    }
+
+    v->arch_bound = v->arch_cursor;
+    return true;
+}
+
+static bool ecs_view_next_archetype(ecs_view_t *v, ecs_entity_t *out_e, void **out_components)
+{
+    ecs_world_t *w = v->w;
+
+    uint32_t arch_n = w->archetypes.size;
+    if (v->arch_end < arch_n)
+        arch_n = v->arch_end;
+
+    for (; v->arch_cursor < arch_n; ++v->arch_cursor, v->cursor = 0)
+    {
+        const ecs_archetype_t *a = (const ecs_archetype_t *)vector_impl_at(&w->archetypes, v->arch_cursor);
+        uint32_t rows = a->count;
+        if (v->cursor_end < rows)
+            rows = v->cursor_end;
+
+        if (v->cursor >= rows)
+            continue;
+
+        if (v->arch_bound != v->arch_cursor && !ecs_view_bind_archetype(v, a))
+            continue;
+
+        while (v->cursor < rows)
+        {
+            uint32_t row = v->cursor++;
+            const ecs_chunk_t *c = (const ecs_chunk_t *)a->chunks.data + row / a->row_capacity;
+            uint32_t r = row % a->row_capacity;
+
+            uint32_t idx = ecs_arch_chunk_entities(c)[r];
+            if (!ecs_vec_u8_get(&w->entity_alive, idx))
+                continue;
+
+            for (uint8_t i = 0; i < v->count; ++i)
+                out_components[i] = (void *)(ecs_arch_chunk_column(a, c, v->arch_columns[i]) + (size_t)r * (size_t)v->comp_sizes[i]);
+
+            *out_e = ecs_entity_pack(idx, ecs_vec_u32_get(&w->entity_gen, idx));
+            return true;
+        }
+    }
+
+    return false;
 }
 
 bool ecs_view_next(ecs_view_t *v, ecs_entity_t *out_e, void **out_components)
@@ -116,6 +180,9 @@ bool ecs_view_next(ecs_view_t *v, ecs_entity_t *out_e, void **out_components)
 
     ecs_world_t *w = v->w;
 
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+        return ecs_view_next_archetype(v, out_e, out_components);
+
     if (v->primary >= v->count)
         return false;
 
@@ -128,6 +195,8 @@ bool ecs_view_next(ecs_view_t *v, ecs_entity_t *out_e, void **out_components)
         return false;
 
     uint32_t pn = pp->dense_entities.size;
+    if (v->cursor_end < pn)
+        pn = v->cursor_end;
 
     for (; v->cursor < pn; ++v->cursor)
     {
@@ -167,3 +236,87 @@ bool ecs_view_next(ecs_view_t *v, ecs_entity_t *out_e, void **out_components)
 
     return false;
 }
+
+uint32_t ecs_view_split(const ecs_view_t *v, uint32_t chunk_rows, vector_t *out_chunks)
+{
+    if (!v || !v->w || !out_chunks)
+        return 0;
+
+    vector_clear(out_chunks);
+
+    if (!chunk_rows)
+        chunk_rows = 1u;
+
+    ecs_world_t *w = v->w;
+    ecs_view_t sub = *v;
+
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+    {
+        for (uint32_t ai = 0; ai < w->archetypes.size; ++ai)
+        {
+            const ecs_archetype_t *a = (const ecs_archetype_t *)vector_impl_at(&w->archetypes, ai);
+            if (!a->count)
+                continue;
+
+            sub.arch_cursor = ai;
+            if (!ecs_view_bind_archetype(&sub, a))
+                continue;
+
+            uint32_t step = ((chunk_rows + a->row_capacity - 1u) / a->row_capacity) * a->row_capacity;
+            for (uint32_t b = 0; b < a->count; b += step)
+            {
+                sub.cursor = b;
+                sub.cursor_end = (a->count - b > step) ? b + step : a->count;
+                sub.arch_end = ai + 1u;
+                vector_push_back(out_chunks, &sub);
+            }
+        }
+        return out_chunks->size;
+    }
+
+    if (v->primary >= v->count || v->pool_indices[v->primary] == ECS_INVALID_U32)
+        return 0;
+
+    ecs_pool_t *pp = ecs_view_pool_at(w, v->pool_indices[v->primary]);
+    uint32_t pn = pp ? pp->dense_entities.size : 0;
+
+    for (uint32_t b = 0; b < pn; b += chunk_rows)
+    {
+        sub.cursor = b;
+        sub.cursor_end = (pn - b > chunk_rows) ? b + chunk_rows : pn;
+        vector_push_back(out_chunks, &sub);
+    }
+
+    return out_chunks->size;
+}
+
+typedef struct ecs_view_job_t
+{
+    vector_t *chunks;
+    ecs_view_chunk_fn fn;
+    void *user;
+} ecs_view_job_t;
+
+static void ecs_view_job_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    ecs_view_job_t *job = (ecs_view_job_t *)user;
+    for (uint32_t i = begin; i < end; ++i)
+        job->fn((ecs_view_t *)vector_impl_at(job->chunks, i), i, worker_index, job->user);
+}
+
+void ecs_view_run_chunks(vector_t *chunks, ecs_view_chunk_fn fn, void *user)
+{
+    if (!chunks || !fn || !chunks->size)
+        return;
+
+    ecs_view_job_t job = {chunks, fn, user};
+    jobs_parallel_for(chunks->size, 1u, ecs_view_job_range, &job);
+}
+
+void ecs_view_parallel_for(const ecs_view_t *v, uint32_t chunk_rows, ecs_view_chunk_fn fn, void *user)
+{
+    vector_t chunks = create_vector(ecs_view_t);
+    if (ecs_view_split(v, chunk_rows, &chunks))
+        ecs_view_run_chunks(&chunks, fn, user);
+    vector_free(&chunks);
+}
@@ -18,12 +18,32 @@ typedef struct ecs_view_t
     uint32_t comp_sizes[ECS_VIEW_MAX];
     uint8_t primary;
     uint32_t cursor;
+    uint32_t cursor_end;
+
+    uint64_t arch_mask;
+    uint32_t arch_cursor;
+    uint32_t arch_end;
+    uint32_t arch_bound;
+    uint32_t arch_columns[ECS_VIEW_MAX];
 } ecs_view_t;
 
+// Called once per chunk of a split view. chunk is a bounded copy of the source view and can be
+// walked with ecs_view_next; worker_index < jobs_thread_count() and is stable per thread.
+typedef void (*ecs_view_chunk_fn)(ecs_view_t *chunk, uint32_t chunk_index, uint32_t worker_index, void *user);
+
 bool ecs_view_init(ecs_view_t *v, ecs_world_t *w, uint8_t count, const ecs_component_id_t *ids);
 void ecs_view_reset(ecs_view_t *v);
 bool ecs_view_next(ecs_view_t *v, ecs_entity_t *out_e, void **out_components);
 
+// Splits the view into bounded sub-views of roughly chunk_rows rows (archetype chunks are never
+// split). out_chunks must be a vector of ecs_view_t; returns the number of chunks written.
+uint32_t ecs_view_split(const ecs_view_t *v, uint32_t chunk_rows, vector_t *out_chunks);
+void ecs_view_run_chunks(vector_t *chunks, ecs_view_chunk_fn fn, void *user);
+
+// Split + run on the job pool. The world must not change structurally (create/destroy/add/remove)
+// until the call returns; writing to the iterated components of the current entity is fine.
+void ecs_view_parallel_for(const ecs_view_t *v, uint32_t chunk_rows, ecs_view_chunk_fn fn, void *user);
+
 #define ECS_VIEW2(v, w, a, b) ecs_view_init((v), (w), 2u, (ecs_component_id_t[2]){(a), (b)})
 #define ECS_VIEW3(v, w, a, b, c) ecs_view_init((v), (w), 3u, (ecs_component_id_t[3]){(a), (b), (c)})
 #define ECS_VIEW4(v, w, a, b, c, d) ecs_view_init((v), (w), 4u, (ecs_component_id_t[4]){(a), (b), (c), (d)})
@@ -1,5 +1,9 @@
 #include "core/systems/ecs/world.h"
 #include "core/systems/ecs/internal.h"
+#include "core/systems/ecs/archetype.h"
+#include "utils/threads.h"
+
+static volatile uint32_t g_ecs_world_serial = 0;
 
 void ecs_world_init(ecs_world_t *w, ecs_world_desc_t desc)
 {
@@ -15,6 +19,17 @@ void ecs_world_init(ecs_world_t *w, ecs_world_desc_t desc)
 
     w->types = create_vector(ecs_type_info_t);
     w->pools = create_vector(ecs_pool_t);
+    w->type_lookup = create_vector(uint32_t);
+    w->hierarchy_order = create_vector(uint32_t);
+    w->hierarchy_levels = create_vector(uint32_t);
+
+    w->storage = desc.storage;
+    ecs_arch_world_init(w);
+
+    uint32_t serial = atomic_add_u32(&g_ecs_world_serial, 1u);
+    if (serial == 0)
+        serial = atomic_add_u32(&g_ecs_world_serial, 1u);
+    w->serial = serial;
 
     ecs_type_info_t zero = (ecs_type_info_t){0};
     vector_push_back(&w->types, &zero);
@@ -27,6 +42,8 @@ void ecs_world_init(ecs_world_t *w, ecs_world_desc_t desc)
 
     w->required_tag_id = 0;
     w->root_entity = 0;
+    w->hierarchy_version = 1;
+    w->hierarchy_order_version = 0;
 
     ecs_world_ensure_entity_capacity_for_index(w, 1);
 
@@ -56,12 +73,17 @@ void ecs_world_destroy(ecs_world_t *w)
         vector_free(&p->sparse);
     }
 
+    ecs_arch_world_destroy(w);
+
     vector_free(&w->entity_gen);
     vector_free(&w->entity_alive);
     vector_free(&w->entity_parent);
     vector_free(&w->free_list);
     vector_free(&w->types);
     vector_free(&w->pools);
+    vector_free(&w->type_lookup);
+    vector_free(&w->hierarchy_order);
+    vector_free(&w->hierarchy_levels);
 
     *w = (ecs_world_t){0};
 }
@@ -93,6 +115,12 @@ void ecs_world_ensure_entity_capacity_for_index(ecs_world_t *w, uint32_t new_ent
     vector_resize(&w->entity_alive, new_entity_count, &alive0);
     vector_resize(&w->entity_parent, new_entity_count, &p0);
 
+    if (w->storage == ECS_STORAGE_ARCHETYPE)
+    {
+        ecs_arch_ensure_entity_capacity(w, new_entity_count);
+        return;
+    }
+
     ecs_pool_t *p = NULL;
     VECTOR_FOR_EACH(w->pools, ecs_pool_t, p)
     {
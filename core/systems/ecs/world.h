@@ -8,13 +8,19 @@
 typedef struct ecs_type_info_t
 {
     char *name;
+    uint32_t name_hash;
+    uint32_t pool_index;
     uint32_t size;
     uint32_t base_offset;
     ecs_component_save_fn save_fn;
     ecs_component_load_fn load_fn;
     ecs_component_ctor_fn ctor_fn;
+    uint32_t flags;
 } ecs_type_info_t;
 
+/* Runtime-only data (caches rebuilt by systems): left out of scene files. */
+#define ECS_TYPE_FLAG_TRANSIENT 1u
+
 typedef struct ecs_pool_t
 {
     ecs_component_id_t type_id;
@@ -23,6 +29,12 @@ typedef struct ecs_pool_t
     vector_t sparse;
 } ecs_pool_t;
 
+typedef enum ecs_storage_t
+{
+    ECS_STORAGE_SPARSE = 0,
+    ECS_STORAGE_ARCHETYPE = 1,
+} ecs_storage_t;
+
 typedef struct ecs_world_t
 {
     vector_t entity_gen;
@@ -32,14 +44,30 @@ typedef struct ecs_world_t
 
     vector_t types;
     vector_t pools;
+    vector_t type_lookup;
+
+    uint32_t serial;
+
+    ecs_storage_t storage;
+    vector_t archetypes;
+    vector_t entity_records;
 
     ecs_component_id_t required_tag_id;
     ecs_entity_t root_entity;
+
+    uint32_t hierarchy_version;
+    uint32_t hierarchy_order_version;
+    vector_t hierarchy_order;
+    vector_t hierarchy_levels;
 } ecs_world_t;
 
 typedef struct ecs_world_desc_t
 {
     uint32_t initial_entity_capacity;
+
+    /* ECS_STORAGE_ARCHETYPE groups entities by component signature into fixed
+       size SoA chunks. ecs_dense_raw is not available in that mode; use views. */
+    ecs_storage_t storage;
 } ecs_world_desc_t;
 
 void ecs_world_init(ecs_world_t *w, ecs_world_desc_t desc);
@@ -420,7 +420,13 @@ ikv_node_t *ikv_array_get(const ikv_node_t *arr, uint32_t index)
 
 const char *ikv_as_string(const ikv_node_t *n) { return (n && n->type == IKV_STRING && n->value.string) ? n->value.string : ""; }
 int64_t ikv_as_int(const ikv_node_t *n) { return (n && n->type == IKV_INT) ? n->value.i : 0; }
-double ikv_as_float(const ikv_node_t *n) { return (n && n->type == IKV_FLOAT) ? n->value.f : 0.0; }
+// "%.17g" writes integral floats without a '.', so they parse back as IKV_INT.
+double ikv_as_float(const ikv_node_t *n)
+{
+    if (n && n->type == IKV_INT)
+        return (double)n->value.i;
+    return (n && n->type == IKV_FLOAT) ? n->value.f : 0.0;
+}
 bool ikv_as_bool(const ikv_node_t *n) { return (n && n->type == IKV_BOOL) ? n->value.b : false; }
 
 static void write_indent(FILE *f, int indent)
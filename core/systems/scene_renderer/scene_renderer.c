@@ -1,6 +1,7 @@
 #include "core/systems/scene_renderer/scene_renderer.h"
 
 #include <math.h>
+#include <stdlib.h>
 
 #include "renderer/renderer.h"
 
@@ -11,14 +12,14 @@
 #include "core/systems/ecs/components/c_transform.h"
 #include "core/systems/ecs/components/c_mesh_renderer.h"
 #include "core/systems/ecs/components/c_light.h"
+#include "core/systems/ecs/components/c_world_transform.h"
+#include "core/systems/transform_system/transform_system.h"
 
 #include "types/mat4.h"
 #include "core/renderer/light.h"
 
-static float sr_deg_to_rad(float d)
-{
-    return d * 0.01745329251994329577f;
-}
+#define SR_CHUNK_ROWS 512u
+#define SR_PARALLEL_MIN 4096u
 
 static vec3 sr_vec3_norm(vec3 v)
 {
@@ -29,167 +30,198 @@ static vec3 sr_vec3_norm(vec3 v)
     return (vec3){v.x * inv, v.y * inv, v.z * inv};
 }
 
-static mat4 sr_trs(const c_transform_t *tr)
+static light_t sr_make_light(const c_world_transform_t *wt, const c_light_t *cl)
 {
-    mat4 T = mat4_translate(tr->position);
+    light_t L;
+    L.type = cl->type;
+    L.color = cl->color;
+    L.intensity = cl->intensity;
+    L.radius = cl->radius;
+    L.range = cl->range;
 
-    float rx = sr_deg_to_rad(tr->rotation.x);
-    float ry = sr_deg_to_rad(tr->rotation.y);
-    float rz = sr_deg_to_rad(tr->rotation.z);
+    const mat4 *M = &wt->world;
 
-    mat4 Rx = mat4_rotate_x(rx);
-    mat4 Ry = mat4_rotate_y(ry);
-    mat4 Rz = mat4_rotate_z(rz);
+    L.position = (vec3){M->m[12], M->m[13], M->m[14]};
 
-    mat4 R = mat4_mul(mat4_mul(Rz, Ry), Rx);
+    vec3 d;
+    d.x = -M->m[8];
+    d.y = -M->m[9];
+    d.z = -M->m[10];
 
-    mat4 S = mat4_scale(tr->scale);
+    L.direction = sr_vec3_norm(d);
 
-    return mat4_mul(mat4_mul(T, R), S);
+    return L;
 }
 
-static mat4 sr_tr_no_scale(const c_transform_t *tr)
+typedef struct sr_model_item_t
 {
-    float rx = sr_deg_to_rad(tr->rotation.x);
-    float ry = sr_deg_to_rad(tr->rotation.y);
-    float rz = sr_deg_to_rad(tr->rotation.z);
+    ihandle_t model;
+    mat4 world;
+} sr_model_item_t;
 
-    mat4 Rx = mat4_rotate_x(rx);
-    mat4 Ry = mat4_rotate_y(ry);
-    mat4 Rz = mat4_rotate_z(rz);
-
-    return mat4_mul(mat4_mul(Rz, Ry), Rx);
-}
+typedef struct sr_extract_t
+{
+    vector_t chunks;
+    vector_t offsets;
+    vector_t counts;
+    void *items;
+} sr_extract_t;
 
-static int sr_is_visible_in_hierarchy(ecs_world_t *w, ecs_entity_t e)
+static bool sr_extract_begin(sr_extract_t *x, const ecs_view_t *v, size_t item_size)
 {
-    ecs_entity_t cur = e;
+    x->chunks = create_vector(ecs_view_t);
+    x->offsets = create_vector(uint32_t);
+    x->counts = create_vector(uint32_t);
+    x->items = NULL;
 
-    while (cur != 0 && ecs_entity_is_alive(w, cur))
-    {
-        c_tag_t *tag = ecs_get(w, cur, c_tag_t);
-        if (tag && tag->visible == 0)
-            return 0;
+    uint32_t n = ecs_view_split(v, SR_CHUNK_ROWS, &x->chunks);
+    if (n < 2u)
+        return false;
 
-        cur = ecs_entity_get_parent(w, cur);
+    uint32_t z = 0;
+    vector_resize(&x->offsets, n, &z);
+    vector_resize(&x->counts, n, &z);
+
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const ecs_view_t *c = (const ecs_view_t *)vector_impl_at(&x->chunks, i);
+        *(uint32_t *)vector_impl_at(&x->offsets, i) = total;
+        total += c->cursor_end - c->cursor;
     }
 
-    return 1;
+    if (total < SR_PARALLEL_MIN)
+        return false;
+
+    x->items = malloc((size_t)total * item_size);
+    return x->items != NULL;
 }
 
-static mat4 sr_world_matrix(ecs_world_t *w, ecs_entity_t e)
+static void sr_extract_end(sr_extract_t *x)
 {
-    mat4 mats[128];
-    uint32_t mcount = 0;
-
-    ecs_entity_t cur = e;
+    free(x->items);
+    vector_free(&x->counts);
+    vector_free(&x->offsets);
+    vector_free(&x->chunks);
+}
 
-    while (cur != 0 && ecs_entity_is_alive(w, cur))
+static void sr_extract_models_chunk(ecs_view_t *chunk, uint32_t chunk_index, uint32_t worker_index, void *user)
+{
+    (void)worker_index;
+    sr_extract_t *x = (sr_extract_t *)user;
+    sr_model_item_t *out = (sr_model_item_t *)x->items + *(uint32_t *)vector_impl_at(&x->offsets, chunk_index);
+    uint32_t n = 0;
+
+    ecs_entity_t e = 0;
+    void *c[3];
+    while (ecs_view_next(chunk, &e, c))
     {
-        c_transform_t *tr = ecs_get(w, cur, c_transform_t);
-        if (tr)
-        {
-            if (mcount < (uint32_t)(sizeof(mats) / sizeof(mats[0])))
-                mats[mcount++] = sr_trs(tr);
-        }
+        c_mesh_renderer_t *mr = (c_mesh_renderer_t *)c[1];
+        c_world_transform_t *wt = (c_world_transform_t *)c[2];
 
-        cur = ecs_entity_get_parent(w, cur);
+        if (!wt->visible)
+            continue;
+
+        out[n].model = mr->model;
+        out[n].world = wt->world;
+        n++;
     }
 
-    mat4 world = mat4_identity();
+    *(uint32_t *)vector_impl_at(&x->counts, chunk_index) = n;
+}
 
-    while (mcount)
+static void sr_extract_lights_chunk(ecs_view_t *chunk, uint32_t chunk_index, uint32_t worker_index, void *user)
+{
+    (void)worker_index;
+    sr_extract_t *x = (sr_extract_t *)user;
+    light_t *out = (light_t *)x->items + *(uint32_t *)vector_impl_at(&x->offsets, chunk_index);
+    uint32_t n = 0;
+
+    ecs_entity_t e = 0;
+    void *c[3];
+    while (ecs_view_next(chunk, &e, c))
     {
-        mcount--;
-        world = mat4_mul(world, mats[mcount]);
+        c_light_t *cl = (c_light_t *)c[1];
+        c_world_transform_t *wt = (c_world_transform_t *)c[2];
+
+        if (!wt->visible)
+            continue;
+
+        out[n++] = sr_make_light(wt, cl);
     }
 
-    return world;
+    *(uint32_t *)vector_impl_at(&x->counts, chunk_index) = n;
 }
 
-static mat4 sr_world_rotation_matrix(ecs_world_t *w, ecs_entity_t e)
+static void sr_push_models(renderer_t *r, ecs_view_t *v)
 {
-    mat4 mats[128];
-    uint32_t mcount = 0;
-
-    ecs_entity_t cur = e;
-
-    while (cur != 0 && ecs_entity_is_alive(w, cur))
+    sr_extract_t x;
+    if (sr_extract_begin(&x, v, sizeof(sr_model_item_t)))
     {
-        c_transform_t *tr = ecs_get(w, cur, c_transform_t);
-        if (tr)
+        ecs_view_run_chunks(&x.chunks, sr_extract_models_chunk, &x);
+
+        // Merge in chunk order so the submission order matches the serial walk.
+        for (uint32_t i = 0; i < x.chunks.size; ++i)
         {
-            if (mcount < (uint32_t)(sizeof(mats) / sizeof(mats[0])))
-                mats[mcount++] = sr_tr_no_scale(tr);
+            const sr_model_item_t *items = (const sr_model_item_t *)x.items + *(uint32_t *)vector_impl_at(&x.offsets, i);
+            uint32_t n = *(uint32_t *)vector_impl_at(&x.counts, i);
+            for (uint32_t k = 0; k < n; ++k)
+                R_push_model(r, items[k].model, items[k].world);
         }
 
-        cur = ecs_entity_get_parent(w, cur);
+        sr_extract_end(&x);
+        return;
     }
+    sr_extract_end(&x);
 
-    mat4 worldR = mat4_identity();
+    ecs_entity_t e = 0;
+    void *c[3];
 
-    while (mcount)
+    while (ecs_view_next(v, &e, c))
     {
-        mcount--;
-        worldR = mat4_mul(worldR, mats[mcount]);
-    }
+        c_mesh_renderer_t *mr = (c_mesh_renderer_t *)c[1];
+        c_world_transform_t *wt = (c_world_transform_t *)c[2];
 
-    return worldR;
+        if (!wt->visible)
+            continue;
+
+        R_push_model(r, mr->model, wt->world);
+    }
 }
 
-static vec3 sr_forward_from_euler_deg(vec3 rot_deg)
+static void sr_push_lights(renderer_t *r, ecs_view_t *v)
 {
-    float rx = sr_deg_to_rad(rot_deg.x);
-    float ry = sr_deg_to_rad(rot_deg.y);
-    float rz = sr_deg_to_rad(rot_deg.z);
-
-    mat4 Rx = mat4_rotate_x(rx);
-    mat4 Ry = mat4_rotate_y(ry);
-    mat4 Rz = mat4_rotate_z(rz);
-
-    mat4 R = mat4_mul(mat4_mul(Rz, Ry), Rx);
-
-    vec3 f = (vec3){0.0f, 0.0f, -1.0f};
-
-    vec3 o;
-    o.x = R.m[0] * f.x + R.m[4] * f.y + R.m[8] * f.z;
-    o.y = R.m[1] * f.x + R.m[5] * f.y + R.m[9] * f.z;
-    o.z = R.m[2] * f.x + R.m[6] * f.y + R.m[10] * f.z;
+    sr_extract_t x;
+    if (sr_extract_begin(&x, v, sizeof(light_t)))
+    {
+        ecs_view_run_chunks(&x.chunks, sr_extract_lights_chunk, &x);
 
-    return o;
-}
+        for (uint32_t i = 0; i < x.chunks.size; ++i)
+        {
+            const light_t *items = (const light_t *)x.items + *(uint32_t *)vector_impl_at(&x.offsets, i);
+            uint32_t n = *(uint32_t *)vector_impl_at(&x.counts, i);
+            for (uint32_t k = 0; k < n; ++k)
+                R_push_light(r, items[k]);
+        }
 
-static light_t sr_make_light(ecs_world_t *scene, ecs_entity_t e, const c_transform_t *tr, const c_light_t *cl)
-{
-    light_t L;
-    L.type = cl->type;
-    L.color = cl->color;
-    L.intensity = cl->intensity;
-    L.radius = cl->radius;
-    L.range = cl->range;
+        sr_extract_end(&x);
+        return;
+    }
+    sr_extract_end(&x);
 
-    L.position = tr ? tr->position : (vec3){0.0f, 0.0f, 0.0f};
+    ecs_entity_t e = 0;
+    void *c[3];
 
-    if (cl->type == LIGHT_DIRECTIONAL)
+    while (ecs_view_next(v, &e, c))
     {
-        mat4 R = sr_world_rotation_matrix(scene, e);
+        c_light_t *cl = (c_light_t *)c[1];
+        c_world_transform_t *wt = (c_world_transform_t *)c[2];
 
-        vec3 d;
-        d.x = -R.m[8];
-        d.y = -R.m[9];
-        d.z = -R.m[10];
+        if (!wt->visible)
+            continue;
 
-        L.direction = sr_vec3_norm(d);
+        R_push_light(r, sr_make_light(wt, cl));
     }
-    else
-    {
-        if (tr)
-            L.direction = sr_vec3_norm(sr_forward_from_euler_deg(tr->rotation));
-        else
-            L.direction = (vec3){0.0f, 0.0f, -1.0f};
-    }
-
-    return L;
 }
 
 void scene_renderer_render(renderer_t *r, ecs_world_t *scene)
@@ -197,62 +229,29 @@ void scene_renderer_render(renderer_t *r, ecs_world_t *scene)
     if (!r || !scene)
         return;
 
-    static ecs_component_id_t s_tr_id = 0;
-    static ecs_component_id_t s_mr_id = 0;
-    static ecs_component_id_t s_li_id = 0;
+    ecs_component_id_t tr_id = ecs_component_id(scene, c_transform_t);
+    ecs_component_id_t mr_id = ecs_component_id(scene, c_mesh_renderer_t);
+    ecs_component_id_t li_id = ecs_component_id(scene, c_light_t);
+    ecs_component_id_t wt_id = ecs_component_id(scene, c_world_transform_t);
 
-    if (!s_tr_id)
-        s_tr_id = ecs_component_id_by_name(scene, "c_transform_t");
-    if (!s_mr_id)
-        s_mr_id = ecs_component_id_by_name(scene, "c_mesh_renderer_t");
-    if (!s_li_id)
-        s_li_id = ecs_component_id_by_name(scene, "c_light_t");
-
-    if (!s_tr_id)
+    if (!tr_id || !wt_id)
         return;
 
-    if (s_mr_id)
+    transform_system_update(scene);
+
+    if (mr_id)
     {
         ecs_view_t v;
-        ecs_component_id_t ids[2] = {s_tr_id, s_mr_id};
-        if (ecs_view_init(&v, scene, 2u, ids))
-        {
-            ecs_entity_t e = 0;
-            void *c[2];
-
-            while (ecs_view_next(&v, &e, c))
-            {
-                c_mesh_renderer_t *mr = (c_mesh_renderer_t *)c[1];
-
-                if (!sr_is_visible_in_hierarchy(scene, e))
-                    continue;
-
-                mat4 world_mtx = sr_world_matrix(scene, e);
-                R_push_model(r, mr->model, world_mtx);
-            }
-        }
+        ecs_component_id_t ids[3] = {tr_id, mr_id, wt_id};
+        if (ecs_view_init(&v, scene, 3u, ids))
+            sr_push_models(r, &v);
     }
 
-    if (s_li_id)
+    if (li_id)
     {
         ecs_view_t v;
-        ecs_component_id_t ids[2] = {s_tr_id, s_li_id};
-        if (ecs_view_init(&v, scene, 2u, ids))
-        {
-            ecs_entity_t e = 0;
-            void *c[2];
-
-            while (ecs_view_next(&v, &e, c))
-            {
-                c_transform_t *tr = (c_transform_t *)c[0];
-                c_light_t *cl = (c_light_t *)c[1];
-
-                if (!sr_is_visible_in_hierarchy(scene, e))
-                    continue;
-
-                light_t L = sr_make_light(scene, e, tr, cl);
-                R_push_light(r, L);
-            }
-        }
+        ecs_component_id_t ids[3] = {tr_id, li_id, wt_id};
+        if (ecs_view_init(&v, scene, 3u, ids))
+            sr_push_lights(r, &v);
     }
 }
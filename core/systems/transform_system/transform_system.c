@@ -0,0 +1,180 @@
+#include "core/systems/transform_system/transform_system.h"
+
+#include <string.h>
+
+#include "core/systems/ecs/entity.h"
+#include "core/systems/ecs/components/c_tag.h"
+#include "core/systems/ecs/components/c_transform.h"
+#include "core/systems/ecs/components/c_world_transform.h"
+#include "utils/jobs.h"
+
+#define TS_PARALLEL_MIN 1024u
+#define TS_PARALLEL_GRAIN 256u
+
+static float ts_deg_to_rad(float d)
+{
+    return d * 0.01745329251994329577f;
+}
+
+static int ts_vec3_eq(vec3 a, vec3 b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static mat4 ts_local_trs(vec3 position, vec3 rotation_deg, vec3 scale)
+{
+    mat4 T = mat4_translate(position);
+
+    mat4 Rx = mat4_rotate_x(ts_deg_to_rad(rotation_deg.x));
+    mat4 Ry = mat4_rotate_y(ts_deg_to_rad(rotation_deg.y));
+    mat4 Rz = mat4_rotate_z(ts_deg_to_rad(rotation_deg.z));
+
+    mat4 R = mat4_mul(mat4_mul(Rz, Ry), Rx);
+
+    mat4 S = mat4_scale(scale);
+
+    return mat4_mul(mat4_mul(T, R), S);
+}
+
+static void ts_ensure_components(ecs_world_t *w, ecs_component_id_t wt_id, const uint32_t *order, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t idx = order[i];
+        ecs_entity_t e = ecs_entity_pack(idx, *(uint32_t *)vector_impl_at(&w->entity_gen, idx));
+        if (e == w->root_entity)
+            continue;
+        if (!ecs_has_raw(w, e, wt_id))
+            ecs_add_raw(w, e, wt_id);
+    }
+}
+
+typedef struct ts_ctx_t
+{
+    ecs_world_t *w;
+    const uint32_t *order;
+    uint32_t level_begin;
+    ecs_component_id_t wt_id;
+    ecs_component_id_t tr_id;
+    ecs_component_id_t tag_id;
+    mat4 identity;
+} ts_ctx_t;
+
+static void ts_update_entity(const ts_ctx_t *ctx, uint32_t idx)
+{
+    ecs_world_t *w = ctx->w;
+    ecs_entity_t e = ecs_entity_pack(idx, *(uint32_t *)vector_impl_at(&w->entity_gen, idx));
+    if (e == w->root_entity)
+        return;
+
+    c_world_transform_t *wt = (c_world_transform_t *)ecs_get_raw(w, e, ctx->wt_id);
+    if (!wt)
+        return;
+
+    int dirty = wt->generation == 0;
+
+    c_transform_t *tr = ctx->tr_id ? (c_transform_t *)ecs_get_raw(w, e, ctx->tr_id) : NULL;
+    if (tr)
+    {
+        if (!wt->has_local ||
+            !ts_vec3_eq(tr->position, wt->src_position) ||
+            !ts_vec3_eq(tr->rotation, wt->src_rotation) ||
+            !ts_vec3_eq(tr->scale, wt->src_scale))
+        {
+            wt->src_position = tr->position;
+            wt->src_rotation = tr->rotation;
+            wt->src_scale = tr->scale;
+            wt->local = ts_local_trs(tr->position, tr->rotation, tr->scale);
+            wt->has_local = 1;
+            dirty = 1;
+        }
+    }
+    else if (wt->has_local)
+    {
+        wt->local = ctx->identity;
+        wt->has_local = 0;
+        dirty = 1;
+    }
+
+    ecs_entity_t parent = ecs_entity_get_parent(w, e);
+    const c_world_transform_t *pwt = NULL;
+    if (parent != 0 && parent != w->root_entity)
+        pwt = (const c_world_transform_t *)ecs_get_raw(w, parent, ctx->wt_id);
+
+    if (parent != wt->src_parent)
+    {
+        wt->src_parent = parent;
+        dirty = 1;
+    }
+
+    uint32_t parent_gen = pwt ? pwt->generation : 0u;
+    if (parent_gen != wt->parent_generation)
+        dirty = 1;
+
+    c_tag_t *tag = ctx->tag_id ? (c_tag_t *)ecs_get_raw(w, e, ctx->tag_id) : NULL;
+    uint8_t local_visible = (tag && tag->visible == 0) ? 0u : 1u;
+    wt->visible = (pwt && !pwt->visible) ? 0u : local_visible;
+
+    if (!dirty)
+        return;
+
+    if (pwt)
+        wt->world = mat4_mul(pwt->world, wt->local);
+    else
+        wt->world = wt->local;
+
+    wt->parent_generation = parent_gen;
+    wt->generation++;
+    if (!wt->generation)
+        wt->generation = 1;
+}
+
+static void ts_update_range(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    (void)worker_index;
+    const ts_ctx_t *ctx = (const ts_ctx_t *)user;
+    for (uint32_t i = begin; i < end; ++i)
+        ts_update_entity(ctx, ctx->order[ctx->level_begin + i]);
+}
+
+void transform_system_update(ecs_world_t *w)
+{
+    if (!w)
+        return;
+
+    ecs_component_id_t wt_id = ecs_component_id(w, c_world_transform_t);
+    if (!wt_id)
+        return;
+
+    uint32_t order_version = w->hierarchy_order_version;
+    uint32_t count = 0;
+    const uint32_t *order = ecs_hierarchy_order(w, &count);
+    if (!order || !count)
+        return;
+
+    if (order_version != w->hierarchy_order_version)
+        ts_ensure_components(w, wt_id, order, count);
+
+    uint32_t level_count = 0;
+    const uint32_t *levels = ecs_hierarchy_levels(w, &level_count);
+
+    ts_ctx_t ctx;
+    ctx.w = w;
+    ctx.order = order;
+    ctx.wt_id = wt_id;
+    ctx.tr_id = ecs_component_id(w, c_transform_t);
+    ctx.tag_id = ecs_component_id(w, c_tag_t);
+    ctx.identity = mat4_identity();
+
+    // Each depth level only reads the level above it, so entities within a level are independent.
+    for (uint32_t d = 0; d < level_count; ++d)
+    {
+        uint32_t n = levels[d + 1] - levels[d];
+        ctx.level_begin = levels[d];
+
+        if (n < TS_PARALLEL_MIN)
+            ts_update_range(&ctx, 0, n, 0);
+        else
+            jobs_parallel_for(n, TS_PARALLEL_GRAIN, ts_update_range, &ctx);
+    }
+}
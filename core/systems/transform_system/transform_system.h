@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "core/systems/ecs/ecs.h"
+#include "types/mat4.h"
+
+/* Brings every c_world_transform_t up to date. Entities are walked parents-first
+   using ecs_hierarchy_order, and only entities whose local transform, visibility,
+   parent or parent world matrix changed since the last call are recomputed. */
+void transform_system_update(ecs_world_t *w);
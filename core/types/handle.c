@@ -1,25 +1,25 @@
 #include "handle.h"
 #include <stdio.h>
 
-static uint32_t pack_u16_u16(uint16_t a, uint16_t b)
+static uint64_t pack_u32_u32(uint32_t a, uint32_t b)
 {
-    return ((uint32_t)a << 16) | (uint32_t)b;
+    return ((uint64_t)a << 32) | (uint64_t)b;
 }
 
-static uint16_t hi_u16(uint32_t v)
+static uint32_t hi_u32(uint64_t v)
 {
-    return (uint16_t)(v >> 16);
+    return (uint32_t)(v >> 32);
 }
 
-static uint16_t lo_u16(uint32_t v)
+static uint32_t lo_u32(uint64_t v)
 {
-    return (uint16_t)(v & 0xFFFFu);
+    return (uint32_t)(v & 0xFFFFFFFFu);
 }
 
-ihandle_t ihandle_make(ihandle_type_t type, uint16_t index, uint16_t generation)
+ihandle_t ihandle_make(ihandle_type_t type, uint32_t index, uint32_t generation)
 {
     ihandle_t h;
-    h.value = pack_u16_u16(generation, index);
+    h.value = pack_u32_u32(generation, index);
     h.type = type;
     h.meta = 0;
     return h;
@@ -44,14 +44,14 @@ bool ihandle_eq(ihandle_t a, ihandle_t b)
     return a.value == b.value && a.type == b.type && a.meta == b.meta;
 }
 
-uint16_t ihandle_index(ihandle_t h)
+uint32_t ihandle_index(ihandle_t h)
 {
-    return lo_u16(h.value);
+    return lo_u32(h.value);
 }
 
-uint16_t ihandle_generation(ihandle_t h)
+uint32_t ihandle_generation(ihandle_t h)
 {
-    return hi_u16(h.value);
+    return hi_u32(h.value);
 }
 
 ihandle_type_t ihandle_type(ihandle_t h)
@@ -73,26 +73,31 @@ ihandle_t ihandle_with_meta(ihandle_t h, uint16_t meta)
 
 uint32_t ihandle_hash(ihandle_t h)
 {
-    uint32_t x = h.value;
-    x ^= (uint32_t)h.type * 0x9e3779b9u;
-    x ^= (uint32_t)h.meta * 0x85ebca6bu;
-    x ^= x >> 16;
-    x *= 0x7feb352du;
-    x ^= x >> 15;
-    x *= 0x846ca68bu;
-    x ^= x >> 16;
-    return x;
+    uint64_t x = h.value;
+    x ^= (uint64_t)h.type * 0x9e3779b97f4a7c15ull;
+    x ^= (uint64_t)h.meta * 0xc2b2ae3d27d4eb4full;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return (uint32_t)x;
 }
 
 void handle_hex_triplet(char out[64], ihandle_t h)
 {
-    snprintf(out, 64, "%08X:%04X:%04X", (unsigned)h.value, (unsigned)h.type, (unsigned)h.meta);
+    if (hi_u32(h.value))
+        snprintf(out, 64, "%016llX:%04X:%04X", (unsigned long long)h.value, (unsigned)h.type, (unsigned)h.meta);
+    else
+        snprintf(out, 64, "%08X:%04X:%04X", (unsigned)h.value, (unsigned)h.type, (unsigned)h.meta);
 }
 
 void handle_hex_triplet_filesafe(char out[64], ihandle_t h)
 {
-    uint32_t v = h.value;
-    uint16_t idx = ihandle_index(h);
-    uint16_t gen = ihandle_generation(h);
-    snprintf(out, 64, "%08X_%04X_%04X", (unsigned)v, (unsigned)idx, (unsigned)gen);
+    // Persistent handles name files in the cache; keep their pre-widening names stable.
+    uint32_t v = lo_u32(h.value);
+    if (hi_u32(h.value))
+        snprintf(out, 64, "%08X_%08X", (unsigned)hi_u32(h.value), (unsigned)v);
+    else
+        snprintf(out, 64, "%08X_%04X_%04X", (unsigned)v, (unsigned)(v & 0xFFFFu), (unsigned)(v >> 16));
 }
\ No newline at end of file
@@ -6,21 +6,23 @@
 
 typedef uint16_t ihandle_type_t;
 
+// Runtime handles pack [generation:32][index:32] into value. Persistent handles keep a 32-bit
+// hash in value, so everything written to disk before the widening still reads back unchanged.
 typedef struct ihandle_t
 {
-    uint32_t value;
+    uint64_t value;
     ihandle_type_t type;
     uint16_t meta;
 } ihandle_t;
 
-ihandle_t ihandle_make(ihandle_type_t type, uint16_t index, uint16_t generation);
+ihandle_t ihandle_make(ihandle_type_t type, uint32_t index, uint32_t generation);
 ihandle_t ihandle_invalid(void);
 
 bool ihandle_is_valid(ihandle_t h);
 bool ihandle_eq(ihandle_t a, ihandle_t b);
 
-uint16_t ihandle_index(ihandle_t h);
-uint16_t ihandle_generation(ihandle_t h);
+uint32_t ihandle_index(ihandle_t h);
+uint32_t ihandle_generation(ihandle_t h);
 
 ihandle_type_t ihandle_type(ihandle_t h);
 
@@ -0,0 +1,717 @@
+#include "utils/jobs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/threads.h"
+#include "utils/logger.h"
+
+#define JOBS_DEQUE_CAP 4096u
+#define JOBS_IDLE_SPINS 64u
+// Worker indices for threads outside the pool (asset I/O, tools). The last one is shared by any
+// threads beyond that, which take turns on it.
+#define JOBS_EXTERNAL_SLOTS 8u
+
+struct jobs_job_t
+{
+    jobs_fn fn;
+    void *user;
+    jobs_counter_t *counter;
+    jobs_job_t *next;
+    uint8_t background;
+};
+
+// Chase-Lev work-stealing deque: the owner pushes/takes at bottom, thieves steal from top.
+typedef struct jobs_deque_t
+{
+    volatile uint32_t top;
+    uint8_t pad0[60];
+    volatile uint32_t bottom;
+    uint8_t pad1[60];
+    void *volatile buf[JOBS_DEQUE_CAP];
+} jobs_deque_t;
+
+typedef struct jobs_fifo_t
+{
+    jobs_job_t *head;
+    jobs_job_t *tail;
+    volatile uint32_t count;
+} jobs_fifo_t;
+
+typedef struct jobs_pool_t
+{
+    thread_t *threads;
+    uint32_t *thread_indices;
+    uint32_t worker_count;
+
+    // One deque per worker index: the init thread, the workers, then the external slots.
+    jobs_deque_t *deques;
+    uint32_t slot_count;
+    volatile uint32_t external_next;
+    mutex_t overflow_m;
+
+    mutex_t queue_m;
+    jobs_fifo_t inject;
+    jobs_fifo_t background;
+    volatile uint32_t foreground; // queued jobs any helping thread may run
+    volatile uint32_t background_running;
+    volatile uint32_t background_limit;
+
+    mutex_t sleep_m;
+    cond_t sleep_cv;
+    volatile uint32_t sleepers;
+
+    // jobs_wait parks here once there is nothing left to help with.
+    mutex_t wait_m;
+    cond_t wait_cv;
+    volatile uint32_t waiting;
+    uint32_t wait_seq;
+
+    volatile uint32_t stop;
+    bool initialized;
+} jobs_pool_t;
+
+static jobs_pool_t g_jobs;
+// Bumped by every jobs_init so slots claimed under an earlier pool are not reused.
+static uint32_t g_jobs_generation;
+
+static THREAD_LOCAL uint32_t g_jobs_worker_index;
+static THREAD_LOCAL uint32_t g_jobs_slot_generation;
+static THREAD_LOCAL bool g_jobs_pool_thread;
+static THREAD_LOCAL bool g_jobs_overflow;
+static THREAD_LOCAL uint32_t g_jobs_overflow_depth;
+
+// Worker index of the calling thread. Threads outside the pool claim an external slot the first
+// time they need one.
+static uint32_t jobs_self(void)
+{
+    if (!g_jobs.initialized)
+        return 0u;
+    if (g_jobs_slot_generation == g_jobs_generation)
+        return g_jobs_worker_index;
+
+    const uint32_t k = atomic_add_u32(&g_jobs.external_next, 1u) - 1u;
+    g_jobs_slot_generation = g_jobs_generation;
+    g_jobs_overflow = k + 1u >= JOBS_EXTERNAL_SLOTS;
+    g_jobs_worker_index = g_jobs.worker_count + 1u + (g_jobs_overflow ? JOBS_EXTERNAL_SLOTS - 1u : k);
+    if (k + 1u == JOBS_EXTERNAL_SLOTS)
+        LOG_WARN("jobs: more than %u threads outside the pool use jobs; the rest share one slot", JOBS_EXTERNAL_SLOTS - 1u);
+    return g_jobs_worker_index;
+}
+
+// Only the owner pushes to or takes from a deque; overflow threads go through the inject queue.
+static bool jobs_owns_deque(void)
+{
+    jobs_self();
+    return g_jobs.initialized && !g_jobs_overflow;
+}
+
+// Overflow threads share a worker index, so only one of them may run code that sees it. Nested
+// entries (a job running a parallel_for) keep the lock they already hold.
+static void jobs_overflow_enter(void)
+{
+    if (g_jobs_overflow && g_jobs_overflow_depth++ == 0)
+        threads_mutex_lock(&g_jobs.overflow_m);
+}
+
+static void jobs_overflow_leave(void)
+{
+    if (g_jobs_overflow && --g_jobs_overflow_depth == 0)
+        threads_mutex_unlock(&g_jobs.overflow_m);
+}
+
+static bool jobs_deque_push(jobs_deque_t *d, jobs_job_t *j)
+{
+    uint32_t b = atomic_load_u32(&d->bottom);
+    uint32_t t = atomic_load_u32(&d->top);
+    if ((int32_t)(b - t) >= (int32_t)JOBS_DEQUE_CAP)
+        return false;
+
+    atomic_store_ptr(&d->buf[b & (JOBS_DEQUE_CAP - 1u)], j);
+    atomic_store_u32(&d->bottom, b + 1u);
+    return true;
+}
+
+static jobs_job_t *jobs_deque_take(jobs_deque_t *d)
+{
+    uint32_t b = atomic_load_u32(&d->bottom) - 1u;
+    atomic_store_u32(&d->bottom, b);
+    uint32_t t = atomic_load_u32(&d->top);
+
+    int32_t size = (int32_t)(b - t);
+    if (size < 0)
+    {
+        atomic_store_u32(&d->bottom, b + 1u);
+        return NULL;
+    }
+
+    jobs_job_t *j = (jobs_job_t *)atomic_load_ptr(&d->buf[b & (JOBS_DEQUE_CAP - 1u)]);
+    if (size > 0)
+        return j;
+
+    if (!atomic_cas_u32(&d->top, t, t + 1u))
+        j = NULL;
+    atomic_store_u32(&d->bottom, b + 1u);
+    return j;
+}
+
+static jobs_job_t *jobs_deque_steal(jobs_deque_t *d)
+{
+    uint32_t t = atomic_load_u32(&d->top);
+    uint32_t b = atomic_load_u32(&d->bottom);
+    if ((int32_t)(b - t) <= 0)
+        return NULL;
+
+    jobs_job_t *j = (jobs_job_t *)atomic_load_ptr(&d->buf[t & (JOBS_DEQUE_CAP - 1u)]);
+    if (!atomic_cas_u32(&d->top, t, t + 1u))
+        return NULL;
+    return j;
+}
+
+static void jobs_fifo_push(jobs_fifo_t *q, jobs_job_t *j)
+{
+    threads_mutex_lock(&g_jobs.queue_m);
+    j->next = NULL;
+    if (q->tail)
+        q->tail->next = j;
+    else
+        q->head = j;
+    q->tail = j;
+    atomic_add_u32(&q->count, 1u);
+    threads_mutex_unlock(&g_jobs.queue_m);
+}
+
+static jobs_job_t *jobs_fifo_pop(jobs_fifo_t *q)
+{
+    if (!atomic_load_u32(&q->count))
+        return NULL;
+
+    threads_mutex_lock(&g_jobs.queue_m);
+    jobs_job_t *j = q->head;
+    if (j)
+    {
+        q->head = j->next;
+        if (!q->head)
+            q->tail = NULL;
+        atomic_sub_u32(&q->count, 1u);
+    }
+    threads_mutex_unlock(&g_jobs.queue_m);
+    return j;
+}
+
+static void jobs_spin_lock(volatile uint32_t *l)
+{
+    while (!atomic_cas_u32(l, 0u, 1u))
+        threads_yield();
+}
+
+static void jobs_spin_unlock(volatile uint32_t *l)
+{
+    atomic_store_u32(l, 0u);
+}
+
+static void jobs_wake_one(void)
+{
+    if (!atomic_load_u32(&g_jobs.sleepers))
+        return;
+    threads_mutex_lock(&g_jobs.sleep_m);
+    threads_cond_signal(&g_jobs.sleep_cv);
+    threads_mutex_unlock(&g_jobs.sleep_m);
+}
+
+static void jobs_wake_waiters(void)
+{
+    if (!atomic_load_u32(&g_jobs.waiting))
+        return;
+    threads_mutex_lock(&g_jobs.wait_m);
+    g_jobs.wait_seq++;
+    threads_cond_broadcast(&g_jobs.wait_cv);
+    threads_mutex_unlock(&g_jobs.wait_m);
+}
+
+// Something a sleeping worker could pick up: foreground work, or background work while fewer than
+// background_limit workers are busy with it.
+static bool jobs_runnable(void)
+{
+    return atomic_load_u32(&g_jobs.foreground) ||
+           (atomic_load_u32(&g_jobs.background.count) && atomic_load_u32(&g_jobs.background_running) < atomic_load_u32(&g_jobs.background_limit));
+}
+
+static void jobs_execute(jobs_job_t *j, uint32_t worker_index);
+
+static void jobs_enqueue(jobs_job_t *j)
+{
+    if (!g_jobs.worker_count)
+    {
+        const uint32_t self = jobs_self();
+        jobs_overflow_enter();
+        jobs_execute(j, self);
+        jobs_overflow_leave();
+        return;
+    }
+
+    if (j->background)
+    {
+        jobs_fifo_push(&g_jobs.background, j);
+    }
+    else
+    {
+        atomic_add_u32(&g_jobs.foreground, 1u);
+        if (!jobs_owns_deque() || !jobs_deque_push(&g_jobs.deques[g_jobs_worker_index], j))
+            jobs_fifo_push(&g_jobs.inject, j);
+        jobs_wake_waiters();
+    }
+
+    jobs_wake_one();
+}
+
+static void jobs_counter_release(jobs_counter_t *c)
+{
+    jobs_spin_lock(&c->lock);
+    jobs_job_t *ready = NULL;
+    const bool done = atomic_sub_u32(&c->value, 1u) == 0;
+    if (done)
+    {
+        ready = c->waiters;
+        c->waiters = NULL;
+    }
+    jobs_spin_unlock(&c->lock);
+
+    // c may be freed by its waiter from here on.
+    if (done)
+        jobs_wake_waiters();
+
+    while (ready)
+    {
+        jobs_job_t *next = ready->next;
+        jobs_enqueue(ready);
+        ready = next;
+    }
+}
+
+static void jobs_execute(jobs_job_t *j, uint32_t worker_index)
+{
+    jobs_counter_t *c = j->counter;
+    j->fn(j->user, worker_index);
+    free(j);
+    if (c)
+        jobs_counter_release(c);
+}
+
+// Claims one of the background_limit slots before taking a background job, so blocking work
+// cannot occupy every worker.
+static jobs_job_t *jobs_find_background(void)
+{
+    for (;;)
+    {
+        const uint32_t running = atomic_load_u32(&g_jobs.background_running);
+        if (running >= atomic_load_u32(&g_jobs.background_limit) || !atomic_load_u32(&g_jobs.background.count))
+            return NULL;
+        if (!atomic_cas_u32(&g_jobs.background_running, running, running + 1u))
+            continue;
+
+        jobs_job_t *j = jobs_fifo_pop(&g_jobs.background);
+        if (!j)
+            atomic_sub_u32(&g_jobs.background_running, 1u);
+        return j;
+    }
+}
+
+static jobs_job_t *jobs_find(uint32_t self, bool allow_background)
+{
+    jobs_job_t *j = g_jobs_overflow ? NULL : jobs_deque_take(&g_jobs.deques[self]);
+    if (!j)
+        j = jobs_fifo_pop(&g_jobs.inject);
+
+    uint32_t n = g_jobs.slot_count;
+    for (uint32_t k = 1; !j && k < n; ++k)
+        j = jobs_deque_steal(&g_jobs.deques[(self + k) % n]);
+
+    if (j)
+    {
+        atomic_sub_u32(&g_jobs.foreground, 1u);
+        return j;
+    }
+    return allow_background ? jobs_find_background() : NULL;
+}
+
+// Runs a job taken by jobs_find and gives back its background slot, if it held one.
+static void jobs_execute_found(jobs_job_t *j, uint32_t worker_index)
+{
+    const bool background = j->background;
+    jobs_execute(j, worker_index);
+    if (!background)
+        return;
+    atomic_sub_u32(&g_jobs.background_running, 1u);
+    if (atomic_load_u32(&g_jobs.background.count))
+        jobs_wake_one();
+}
+
+static void jobs_worker_main(void *arg)
+{
+    uint32_t self = *(uint32_t *)arg;
+    g_jobs_worker_index = self;
+    g_jobs_slot_generation = g_jobs_generation;
+    g_jobs_pool_thread = true;
+
+    uint32_t spins = 0;
+
+    for (;;)
+    {
+        jobs_job_t *j = jobs_find(self, true);
+        if (j)
+        {
+            jobs_execute_found(j, self);
+            spins = 0;
+            continue;
+        }
+
+        if (atomic_load_u32(&g_jobs.stop))
+            break;
+
+        if (++spins < JOBS_IDLE_SPINS)
+        {
+            threads_yield();
+            continue;
+        }
+        spins = 0;
+
+        threads_mutex_lock(&g_jobs.sleep_m);
+        atomic_add_u32(&g_jobs.sleepers, 1u);
+        while (!atomic_load_u32(&g_jobs.stop) && !jobs_runnable())
+            threads_cond_wait(&g_jobs.sleep_cv, &g_jobs.sleep_m);
+        atomic_sub_u32(&g_jobs.sleepers, 1u);
+        threads_mutex_unlock(&g_jobs.sleep_m);
+    }
+}
+
+bool jobs_init(uint32_t worker_count)
+{
+    if (g_jobs.initialized)
+        return true;
+
+    memset(&g_jobs, 0, sizeof(g_jobs));
+
+    if (!threads_mutex_init(&g_jobs.queue_m) || !threads_mutex_init(&g_jobs.sleep_m) ||
+        !threads_mutex_init(&g_jobs.wait_m) || !threads_mutex_init(&g_jobs.overflow_m))
+        return false;
+    if (!threads_cond_init(&g_jobs.sleep_cv) || !threads_cond_init(&g_jobs.wait_cv))
+        return false;
+
+    g_jobs.slot_count = worker_count + 1u + JOBS_EXTERNAL_SLOTS;
+    g_jobs.deques = (jobs_deque_t *)calloc(g_jobs.slot_count, sizeof(jobs_deque_t));
+    if (!g_jobs.deques)
+        return false;
+
+    g_jobs_generation++;
+    g_jobs_worker_index = 0;
+    g_jobs_slot_generation = g_jobs_generation;
+    g_jobs_pool_thread = true;
+    g_jobs.background_limit = 1u;
+    g_jobs.initialized = true;
+
+    if (!worker_count)
+        return true;
+
+    g_jobs.threads = (thread_t *)calloc(worker_count, sizeof(thread_t));
+    g_jobs.thread_indices = (uint32_t *)calloc(worker_count, sizeof(uint32_t));
+    if (!g_jobs.threads || !g_jobs.thread_indices)
+        return true;
+
+    // Publish the final count before any worker runs; it bounds the steal loop.
+    g_jobs.worker_count = worker_count;
+    // Leave one worker for short jobs whenever there is more than one.
+    g_jobs.background_limit = worker_count > 1u ? worker_count - 1u : 1u;
+
+    for (uint32_t i = 0; i < worker_count; ++i)
+    {
+        g_jobs.thread_indices[i] = i + 1u;
+        if (!threads_thread_create(&g_jobs.threads[i], jobs_worker_main, &g_jobs.thread_indices[i]))
+        {
+            LOG_ERROR("jobs: failed to create worker %u, running without a pool", i + 1u);
+            threads_mutex_lock(&g_jobs.sleep_m);
+            atomic_store_u32(&g_jobs.stop, 1u);
+            threads_cond_broadcast(&g_jobs.sleep_cv);
+            threads_mutex_unlock(&g_jobs.sleep_m);
+            for (uint32_t k = 0; k < i; ++k)
+                threads_thread_join(&g_jobs.threads[k]);
+            g_jobs.worker_count = 0;
+            g_jobs.background_limit = 1u;
+            atomic_store_u32(&g_jobs.stop, 0u);
+            return true;
+        }
+    }
+
+    return true;
+}
+
+void jobs_shutdown(void)
+{
+    if (!g_jobs.initialized)
+        return;
+
+    threads_mutex_lock(&g_jobs.sleep_m);
+    atomic_store_u32(&g_jobs.stop, 1u);
+    threads_cond_broadcast(&g_jobs.sleep_cv);
+    threads_mutex_unlock(&g_jobs.sleep_m);
+
+    for (uint32_t i = 0; i < g_jobs.worker_count; ++i)
+        threads_thread_join(&g_jobs.threads[i]);
+
+    // Anything still queued was submitted without a matching wait; run it here so counters settle.
+    jobs_job_t *j;
+    while ((j = jobs_find(0, true)) != NULL)
+        jobs_execute_found(j, 0);
+
+    free(g_jobs.thread_indices);
+    free(g_jobs.threads);
+    free(g_jobs.deques);
+
+    threads_cond_destroy(&g_jobs.wait_cv);
+    threads_cond_destroy(&g_jobs.sleep_cv);
+    threads_mutex_destroy(&g_jobs.overflow_m);
+    threads_mutex_destroy(&g_jobs.wait_m);
+    threads_mutex_destroy(&g_jobs.sleep_m);
+    threads_mutex_destroy(&g_jobs.queue_m);
+
+    memset(&g_jobs, 0, sizeof(g_jobs));
+    g_jobs_pool_thread = false;
+}
+
+uint32_t jobs_thread_count(void)
+{
+    return g_jobs.initialized ? g_jobs.slot_count : 1u;
+}
+
+uint32_t jobs_pool_size(void)
+{
+    return g_jobs.worker_count + 1u;
+}
+
+uint32_t jobs_worker_index(void)
+{
+    return jobs_self();
+}
+
+bool jobs_is_pool_thread(void)
+{
+    return g_jobs_pool_thread;
+}
+
+uint32_t jobs_background_limit(void)
+{
+    return g_jobs.initialized ? atomic_load_u32(&g_jobs.background_limit) : 1u;
+}
+
+void jobs_set_background_limit(uint32_t limit)
+{
+    if (!g_jobs.initialized)
+        return;
+    if (limit < 1u)
+        limit = 1u;
+    if (g_jobs.worker_count && limit > g_jobs.worker_count)
+        limit = g_jobs.worker_count;
+    atomic_store_u32(&g_jobs.background_limit, limit);
+
+    threads_mutex_lock(&g_jobs.sleep_m);
+    threads_cond_broadcast(&g_jobs.sleep_cv);
+    threads_mutex_unlock(&g_jobs.sleep_m);
+}
+
+static jobs_job_t *jobs_alloc(jobs_fn fn, void *user, jobs_counter_t *counter, uint8_t background)
+{
+    jobs_job_t *j = (jobs_job_t *)malloc(sizeof(jobs_job_t));
+    if (!j)
+        return NULL;
+    j->fn = fn;
+    j->user = user;
+    j->counter = counter;
+    j->next = NULL;
+    j->background = background;
+    if (counter)
+        atomic_add_u32(&counter->value, 1u);
+    return j;
+}
+
+static void jobs_submit(jobs_fn fn, void *user, jobs_counter_t *counter, uint8_t background)
+{
+    if (!fn)
+        return;
+
+    jobs_job_t *j = g_jobs.initialized ? jobs_alloc(fn, user, counter, background) : NULL;
+    if (!j)
+    {
+        const uint32_t self = jobs_self();
+        jobs_overflow_enter();
+        fn(user, self);
+        jobs_overflow_leave();
+        return;
+    }
+
+    jobs_enqueue(j);
+}
+
+void jobs_run(jobs_fn fn, void *user, jobs_counter_t *counter)
+{
+    jobs_submit(fn, user, counter, 0);
+}
+
+void jobs_run_background(jobs_fn fn, void *user, jobs_counter_t *counter)
+{
+    jobs_submit(fn, user, counter, 1);
+}
+
+void jobs_run_after(jobs_counter_t *dependency, jobs_fn fn, void *user, jobs_counter_t *counter)
+{
+    if (!fn)
+        return;
+    if (!dependency)
+    {
+        jobs_run(fn, user, counter);
+        return;
+    }
+
+    jobs_job_t *j = g_jobs.initialized ? jobs_alloc(fn, user, counter, 0) : NULL;
+    if (!j)
+    {
+        jobs_wait(dependency);
+        const uint32_t self = jobs_self();
+        jobs_overflow_enter();
+        fn(user, self);
+        jobs_overflow_leave();
+        return;
+    }
+
+    jobs_spin_lock(&dependency->lock);
+    if (atomic_load_u32(&dependency->value))
+    {
+        j->next = dependency->waiters;
+        dependency->waiters = j;
+        j = NULL;
+    }
+    jobs_spin_unlock(&dependency->lock);
+
+    if (j)
+        jobs_enqueue(j);
+}
+
+bool jobs_counter_done(jobs_counter_t *counter)
+{
+    return !counter || atomic_load_u32(&counter->value) == 0;
+}
+
+// Sleeps until a counter reaches zero or foreground work is queued. wait_seq closes the window
+// between the last check and the cond wait.
+static void jobs_park(jobs_counter_t *counter, bool helping)
+{
+    threads_mutex_lock(&g_jobs.wait_m);
+    atomic_add_u32(&g_jobs.waiting, 1u);
+    const uint32_t seq = g_jobs.wait_seq;
+    if (atomic_load_u32(&counter->value) && !(helping && atomic_load_u32(&g_jobs.foreground)))
+    {
+        while (seq == g_jobs.wait_seq)
+            threads_cond_wait(&g_jobs.wait_cv, &g_jobs.wait_m);
+    }
+    atomic_sub_u32(&g_jobs.waiting, 1u);
+    threads_mutex_unlock(&g_jobs.wait_m);
+}
+
+void jobs_wait(jobs_counter_t *counter)
+{
+    if (!counter)
+        return;
+
+    if (!g_jobs.initialized)
+    {
+        while (atomic_load_u32(&counter->value))
+            threads_yield();
+    }
+    else
+    {
+        // Any thread that owns a worker index helps; overflow threads only park.
+        const uint32_t self = jobs_self();
+        const bool helping = g_jobs.worker_count && !g_jobs_overflow;
+        uint32_t spins = 0;
+        while (atomic_load_u32(&counter->value))
+        {
+            jobs_job_t *j = helping ? jobs_find(self, false) : NULL;
+            if (j)
+            {
+                jobs_execute(j, self);
+                spins = 0;
+            }
+            else if (++spins < JOBS_IDLE_SPINS)
+            {
+                threads_yield();
+            }
+            else
+            {
+                jobs_park(counter, helping);
+                spins = 0;
+            }
+        }
+    }
+
+    // The releasing thread may still hold the counter lock; let it finish before the caller
+    // reuses or frees the counter.
+    jobs_spin_lock(&counter->lock);
+    jobs_spin_unlock(&counter->lock);
+}
+
+typedef struct jobs_batch_t
+{
+    jobs_range_fn fn;
+    void *user;
+    uint32_t count;
+    uint32_t grain;
+    uint32_t range_count;
+    volatile uint32_t next;
+} jobs_batch_t;
+
+static void jobs_batch_run(void *user, uint32_t worker_index)
+{
+    jobs_batch_t *b = (jobs_batch_t *)user;
+    for (;;)
+    {
+        uint32_t r = atomic_add_u32(&b->next, 1u) - 1u;
+        if (r >= b->range_count)
+            break;
+
+        uint32_t begin = r * b->grain;
+        uint32_t end = (b->count - begin > b->grain) ? begin + b->grain : b->count;
+
+        b->fn(b->user, begin, end, worker_index);
+    }
+}
+
+void jobs_parallel_for(uint32_t count, uint32_t grain, jobs_range_fn fn, void *user)
+{
+    if (!count || !fn)
+        return;
+    if (!grain)
+        grain = 1u;
+
+    jobs_batch_t b;
+    b.fn = fn;
+    b.user = user;
+    b.count = count;
+    b.grain = grain;
+    b.range_count = (count + grain - 1u) / grain;
+    b.next = 0;
+
+    uint32_t helpers = b.range_count - 1u;
+    if (helpers > g_jobs.worker_count)
+        helpers = g_jobs.worker_count;
+
+    jobs_counter_t c;
+    memset(&c, 0, sizeof(c));
+
+    for (uint32_t i = 0; i < helpers; ++i)
+        jobs_run(jobs_batch_run, &b, &c);
+
+    const uint32_t self = jobs_self();
+    jobs_overflow_enter();
+    jobs_batch_run(&b, self);
+    jobs_overflow_leave();
+    jobs_wait(&c);
+}
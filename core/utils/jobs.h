@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct jobs_job_t jobs_job_t;
+
+// Counts outstanding jobs. Zero-initialize before first use; a counter may be reused once it
+// reaches zero. jobs_run_after can queue work behind a counter.
+typedef struct jobs_counter_t
+{
+    volatile uint32_t value;
+    volatile uint32_t lock;
+    jobs_job_t *waiters;
+} jobs_counter_t;
+
+// worker_index is stable for the executing thread: 0 = the thread that called jobs_init,
+// 1..N = pool workers, above that = other threads that use the pool. Always < jobs_thread_count().
+typedef void (*jobs_fn)(void *user, uint32_t worker_index);
+typedef void (*jobs_range_fn)(void *user, uint32_t begin, uint32_t end, uint32_t worker_index);
+
+bool jobs_init(uint32_t worker_count);
+void jobs_shutdown(void);
+
+// Upper bound on worker_index, for sizing per-worker scratch.
+uint32_t jobs_thread_count(void);
+// Threads that execute queued jobs: the pool workers plus the init thread.
+uint32_t jobs_pool_size(void);
+uint32_t jobs_worker_index(void);
+bool jobs_is_pool_thread(void);
+
+// At most this many workers run background jobs at once (default: all but one).
+uint32_t jobs_background_limit(void);
+void jobs_set_background_limit(uint32_t limit);
+
+// Short, CPU-bound work. Runs on any pool thread, including threads helping in jobs_wait.
+void jobs_run(jobs_fn fn, void *user, jobs_counter_t *counter);
+// Long-running or blocking work (file I/O, decoding). Only picked up by pool workers, at most
+// jobs_background_limit() at a time, and never by a thread that is helping while it waits, so a
+// frame-critical wait cannot get stuck behind it.
+void jobs_run_background(jobs_fn fn, void *user, jobs_counter_t *counter);
+// Queues fn once dependency reaches zero. counter is incremented immediately.
+void jobs_run_after(jobs_counter_t *dependency, jobs_fn fn, void *user, jobs_counter_t *counter);
+
+bool jobs_counter_done(jobs_counter_t *counter);
+// Blocks until counter reaches zero. The waiting thread executes queued short jobs and sleeps
+// once there are none left.
+void jobs_wait(jobs_counter_t *counter);
+
+// Splits [0, count) into grain-sized ranges and runs them on the pool. The caller participates
+// and the call returns once every range has finished. Safe to nest inside jobs.
+void jobs_parallel_for(uint32_t count, uint32_t grain, jobs_range_fn fn, void *user);
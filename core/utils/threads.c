@@ -167,4 +167,326 @@ uint32_t threads_get_cpu_logical_count(void)
     return (n > 0) ? (uint32_t)n : 1u;
 }
 
-#endif
\ No newline at end of file
+#endif
+
+#if defined(_WIN32)
+
+typedef struct win_mutex_t
+{
+    SRWLOCK l;
+} win_mutex_t;
+
+typedef struct win_cond_t
+{
+    CONDITION_VARIABLE cv;
+} win_cond_t;
+
+typedef struct win_thread_t
+{
+    HANDLE h;
+    void (*fn)(void *);
+    void *arg;
+} win_thread_t;
+
+static DWORD WINAPI win_thread_trampoline(LPVOID p)
+{
+    win_thread_t *t = (win_thread_t *)p;
+    t->fn(t->arg);
+    return 0;
+}
+
+bool threads_mutex_init(mutex_t *m)
+{
+    win_mutex_t *x = (win_mutex_t *)malloc(sizeof(win_mutex_t));
+    if (!x)
+        return false;
+    InitializeSRWLock(&x->l);
+    m->p = x;
+    return true;
+}
+
+void threads_mutex_destroy(mutex_t *m)
+{
+    free(m->p);
+    m->p = NULL;
+}
+
+void threads_mutex_lock(mutex_t *m)
+{
+    win_mutex_t *x = (win_mutex_t *)m->p;
+    AcquireSRWLockExclusive(&x->l);
+}
+
+void threads_mutex_unlock(mutex_t *m)
+{
+    win_mutex_t *x = (win_mutex_t *)m->p;
+    ReleaseSRWLockExclusive(&x->l);
+}
+
+bool threads_cond_init(cond_t *c)
+{
+    win_cond_t *x = (win_cond_t *)malloc(sizeof(win_cond_t));
+    if (!x)
+        return false;
+    InitializeConditionVariable(&x->cv);
+    c->p = x;
+    return true;
+}
+
+void threads_cond_destroy(cond_t *c)
+{
+    free(c->p);
+    c->p = NULL;
+}
+
+void threads_cond_wait(cond_t *c, mutex_t *m)
+{
+    win_cond_t *cv = (win_cond_t *)c->p;
+    win_mutex_t *mx = (win_mutex_t *)m->p;
+    SleepConditionVariableSRW(&cv->cv, &mx->l, INFINITE, 0);
+}
+
+void threads_cond_signal(cond_t *c)
+{
+    win_cond_t *cv = (win_cond_t *)c->p;
+    WakeConditionVariable(&cv->cv);
+}
+
+void threads_cond_broadcast(cond_t *c)
+{
+    win_cond_t *cv = (win_cond_t *)c->p;
+    WakeAllConditionVariable(&cv->cv);
+}
+
+bool threads_thread_create(thread_t *t, void (*fn)(void *), void *arg)
+{
+    win_thread_t *x = (win_thread_t *)malloc(sizeof(win_thread_t));
+    if (!x)
+        return false;
+    x->fn = fn;
+    x->arg = arg;
+    x->h = CreateThread(NULL, 0, win_thread_trampoline, x, 0, NULL);
+    if (!x->h)
+    {
+        free(x);
+        return false;
+    }
+    t->p = x;
+    return true;
+}
+
+void threads_thread_join(thread_t *t)
+{
+    win_thread_t *x = (win_thread_t *)t->p;
+    if (!x)
+        return;
+    WaitForSingleObject(x->h, INFINITE);
+    CloseHandle(x->h);
+    free(x);
+    t->p = NULL;
+}
+
+void threads_yield(void)
+{
+    SwitchToThread();
+}
+
+void threads_futex_wait(volatile uint32_t *addr, uint32_t expected, uint32_t timeout_ms)
+{
+    WaitOnAddress((volatile VOID *)addr, &expected, sizeof(expected), timeout_ms ? (DWORD)timeout_ms : INFINITE);
+}
+
+void threads_futex_wake(volatile uint32_t *addr, bool all)
+{
+    if (all)
+        WakeByAddressAll((PVOID)addr);
+    else
+        WakeByAddressSingle((PVOID)addr);
+}
+
+#else
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef struct posix_mutex_t
+{
+    pthread_mutex_t m;
+} posix_mutex_t;
+
+typedef struct posix_cond_t
+{
+    pthread_cond_t c;
+} posix_cond_t;
+
+typedef struct posix_thread_t
+{
+    pthread_t t;
+    void (*fn)(void *);
+    void *arg;
+} posix_thread_t;
+
+static void *posix_thread_trampoline(void *p)
+{
+    posix_thread_t *x = (posix_thread_t *)p;
+    x->fn(x->arg);
+    return NULL;
+}
+
+bool threads_mutex_init(mutex_t *m)
+{
+    posix_mutex_t *x = (posix_mutex_t *)malloc(sizeof(posix_mutex_t));
+    if (!x)
+        return false;
+    if (pthread_mutex_init(&x->m, NULL) != 0)
+    {
+        free(x);
+        return false;
+    }
+    m->p = x;
+    return true;
+}
+
+void threads_mutex_destroy(mutex_t *m)
+{
+    posix_mutex_t *x = (posix_mutex_t *)m->p;
+    if (!x)
+        return;
+    pthread_mutex_destroy(&x->m);
+    free(x);
+    m->p = NULL;
+}
+
+void threads_mutex_lock(mutex_t *m)
+{
+    posix_mutex_t *x = (posix_mutex_t *)m->p;
+    pthread_mutex_lock(&x->m);
+}
+
+void threads_mutex_unlock(mutex_t *m)
+{
+    posix_mutex_t *x = (posix_mutex_t *)m->p;
+    pthread_mutex_unlock(&x->m);
+}
+
+bool threads_cond_init(cond_t *c)
+{
+    posix_cond_t *x = (posix_cond_t *)malloc(sizeof(posix_cond_t));
+    if (!x)
+        return false;
+    if (pthread_cond_init(&x->c, NULL) != 0)
+    {
+        free(x);
+        return false;
+    }
+    c->p = x;
+    return true;
+}
+
+void threads_cond_destroy(cond_t *c)
+{
+    posix_cond_t *x = (posix_cond_t *)c->p;
+    if (!x)
+        return;
+    pthread_cond_destroy(&x->c);
+    free(x);
+    c->p = NULL;
+}
+
+void threads_cond_wait(cond_t *c, mutex_t *m)
+{
+    posix_cond_t *cv = (posix_cond_t *)c->p;
+    posix_mutex_t *mx = (posix_mutex_t *)m->p;
+    pthread_cond_wait(&cv->c, &mx->m);
+}
+
+void threads_cond_signal(cond_t *c)
+{
+    posix_cond_t *cv = (posix_cond_t *)c->p;
+    pthread_cond_signal(&cv->c);
+}
+
+void threads_cond_broadcast(cond_t *c)
+{
+    posix_cond_t *cv = (posix_cond_t *)c->p;
+    pthread_cond_broadcast(&cv->c);
+}
+
+bool threads_thread_create(thread_t *t, void (*fn)(void *), void *arg)
+{
+    posix_thread_t *x = (posix_thread_t *)malloc(sizeof(posix_thread_t));
+    if (!x)
+        return false;
+    x->fn = fn;
+    x->arg = arg;
+    if (pthread_create(&x->t, NULL, posix_thread_trampoline, x) != 0)
+    {
+        free(x);
+        return false;
+    }
+    t->p = x;
+    return true;
+}
+
+void threads_thread_join(thread_t *t)
+{
+    posix_thread_t *x = (posix_thread_t *)t->p;
+    if (!x)
+        return;
+    pthread_join(x->t, NULL);
+    free(x);
+    t->p = NULL;
+}
+
+void threads_yield(void)
+{
+    sched_yield();
+}
+
+#if defined(__linux__)
+
+void threads_futex_wait(volatile uint32_t *addr, uint32_t expected, uint32_t timeout_ms)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(timeout_ms / 1000u);
+    ts.tv_nsec = (long)(timeout_ms % 1000u) * 1000000L;
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAIT_PRIVATE, expected, timeout_ms ? &ts : NULL, NULL, 0);
+}
+
+void threads_futex_wake(volatile uint32_t *addr, bool all)
+{
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, NULL, NULL, 0);
+}
+
+#else
+
+// No address-wait primitive: poll with a short sleep.
+void threads_futex_wait(volatile uint32_t *addr, uint32_t expected, uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    if (__atomic_load_n(addr, __ATOMIC_SEQ_CST) != expected)
+        return;
+    struct timespec ts;
+    ts.tv_sec = 0;
+    ts.tv_nsec = 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+void threads_futex_wake(volatile uint32_t *addr, bool all)
+{
+    (void)addr;
+    (void)all;
+}
+
+#endif
+
+#endif
@@ -1,6 +1,77 @@
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+typedef struct mutex_t
+{
+    void *p;
+} mutex_t;
+typedef struct cond_t
+{
+    void *p;
+} cond_t;
+typedef struct thread_t
+{
+    void *p;
+} thread_t;
 
 uint32_t threads_get_process_count(void);
 uint32_t threads_get_system_count(void);
 uint32_t threads_get_cpu_logical_count(void);
+
+bool threads_mutex_init(mutex_t *m);
+void threads_mutex_destroy(mutex_t *m);
+void threads_mutex_lock(mutex_t *m);
+void threads_mutex_unlock(mutex_t *m);
+
+bool threads_cond_init(cond_t *c);
+void threads_cond_destroy(cond_t *c);
+void threads_cond_wait(cond_t *c, mutex_t *m);
+void threads_cond_signal(cond_t *c);
+void threads_cond_broadcast(cond_t *c);
+
+bool threads_thread_create(thread_t *t, void (*fn)(void *), void *arg);
+void threads_thread_join(thread_t *t);
+void threads_yield(void);
+
+// Sleeps while *addr == expected (futex on Linux, WaitOnAddress on Windows). Wakeups may be
+// spurious and timeout_ms == 0 waits indefinitely; callers re-check their condition in a loop.
+void threads_futex_wait(volatile uint32_t *addr, uint32_t expected, uint32_t timeout_ms);
+void threads_futex_wake(volatile uint32_t *addr, bool all);
+
+// Sequentially consistent atomics shared by the job system and asset manager.
+#if defined(_MSC_VER)
+static inline uint32_t atomic_load_u32(volatile uint32_t *p) { return (uint32_t)_InterlockedCompareExchange((volatile long *)p, 0, 0); }
+static inline void atomic_store_u32(volatile uint32_t *p, uint32_t v) { _InterlockedExchange((volatile long *)p, (long)v); }
+static inline uint32_t atomic_add_u32(volatile uint32_t *p, uint32_t v) { return (uint32_t)_InterlockedExchangeAdd((volatile long *)p, (long)v) + v; }
+static inline uint32_t atomic_sub_u32(volatile uint32_t *p, uint32_t v) { return (uint32_t)_InterlockedExchangeAdd((volatile long *)p, -(long)v) - v; }
+static inline bool atomic_cas_u32(volatile uint32_t *p, uint32_t expected, uint32_t desired) { return (uint32_t)_InterlockedCompareExchange((volatile long *)p, (long)desired, (long)expected) == expected; }
+static inline void *atomic_load_ptr(void *volatile *p) { return _InterlockedCompareExchangePointer(p, NULL, NULL); }
+static inline void atomic_store_ptr(void *volatile *p, void *v) { _InterlockedExchangePointer(p, v); }
+static inline uint64_t atomic_load_u64(volatile uint64_t *p) { return (uint64_t)_InterlockedCompareExchange64((volatile __int64 *)p, 0, 0); }
+static inline void atomic_store_u64(volatile uint64_t *p, uint64_t v) { _InterlockedExchange64((volatile __int64 *)p, (__int64)v); }
+static inline uint64_t atomic_load_u64_relaxed(volatile uint64_t *p) { return (uint64_t)__iso_volatile_load64((volatile __int64 *)p); }
+static inline void atomic_store_u64_relaxed(volatile uint64_t *p, uint64_t v) { __iso_volatile_store64((volatile __int64 *)p, (__int64)v); }
+#else
+static inline uint32_t atomic_load_u32(volatile uint32_t *p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+static inline void atomic_store_u32(volatile uint32_t *p, uint32_t v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+static inline uint32_t atomic_add_u32(volatile uint32_t *p, uint32_t v) { return __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST); }
+static inline uint32_t atomic_sub_u32(volatile uint32_t *p, uint32_t v) { return __atomic_sub_fetch(p, v, __ATOMIC_SEQ_CST); }
+static inline bool atomic_cas_u32(volatile uint32_t *p, uint32_t expected, uint32_t desired) { return __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
+static inline void *atomic_load_ptr(void *volatile *p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+static inline void atomic_store_ptr(void *volatile *p, void *v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+static inline uint64_t atomic_load_u64(volatile uint64_t *p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+static inline void atomic_store_u64(volatile uint64_t *p, uint64_t v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+static inline uint64_t atomic_load_u64_relaxed(volatile uint64_t *p) { return __atomic_load_n(p, __ATOMIC_RELAXED); }
+static inline void atomic_store_u64_relaxed(volatile uint64_t *p, uint64_t v) { __atomic_store_n(p, v, __ATOMIC_RELAXED); }
+#endif
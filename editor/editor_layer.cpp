@@ -111,6 +111,8 @@ static void editor_apply_project(editor_layer_data_t *d)
         d->asset_browser->SetAssetManager(d->ctx.assets);
         d->asset_browser->SetProjectRoot(std::filesystem::path{});
         d->asset_browser->SetScanRoot(std::filesystem::path{});
+        if (d->ctx.assets)
+            asset_manager_set_build_cache_dir(d->ctx.assets, NULL);
         return;
     }
 
@@ -121,6 +123,9 @@ static void editor_apply_project(editor_layer_data_t *d)
     d->asset_browser->SetAssetManager(d->ctx.assets);
     d->asset_browser->SetProjectRoot(p->root_dir);
     d->asset_browser->SetScanRoot(p->assets_dir);
+
+    if (d->ctx.assets)
+        asset_manager_set_build_cache_dir(d->ctx.assets, (p->cache_dir / "pack").string().c_str());
 }
 
 static void editor_windows_init(editor_layer_data_t *d, Application *app)
@@ -163,6 +168,9 @@ static void editor_windows_tick(editor_layer_data_t *d, float dt, Application *a
 
     editor_apply_project(d);
 
+    if (d->asset_browser)
+        d->asset_browser->Update();
+
     for (auto &wptr : d->windows)
     {
         editor::CBaseWindow *w = wptr.get();
@@ -3,7 +3,6 @@
 #include <chrono>
 #include <algorithm>
 #include <string.h>
-#include <thread>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
@@ -16,6 +15,7 @@
 extern "C"
 {
 #include "asset_manager/asset_manager.h"
+#include "utils/jobs.h"
 }
 
 #include "imgui.h"
@@ -83,6 +83,11 @@ namespace editor
         Draw();
     }
 
+    void CAssetBrowserWindow::Update()
+    {
+        KickScanner();
+    }
+
     void CAssetBrowserWindow::SetAssetManager(asset_manager_t* am)
     {
         m_am = am;
@@ -142,6 +147,7 @@ namespace editor
             return;
         }
 
+        StopScanner();
         m_scan_root_abs = make_abs_norm(abs_scan_root);
         EnsureScanner();
     }
@@ -174,7 +180,8 @@ namespace editor
             return;
 
         m_scan_run.store(1);
-        m_scan_thread = std::thread(&CAssetBrowserWindow::ScannerThreadMain, this);
+        m_scan_started = 0;
+        KickScanner();
     }
 
     void CAssetBrowserWindow::StopScanner()
@@ -183,8 +190,9 @@ namespace editor
             return;
 
         m_scan_run.store(0);
-        if (m_scan_thread.joinable())
-            m_scan_thread.join();
+        jobs_wait(&m_scan_jobs);
+        m_scan_prev.clear();
+        m_scan_missing = 0;
     }
 
     uint64_t CAssetBrowserWindow::FileTimeToU64(std::filesystem::file_time_type ft)
@@ -297,192 +305,203 @@ namespace editor
         return ASSET_TYPE_TO_STRING(t);
     }
 
-    void CAssetBrowserWindow::ScannerThreadMain()
+    void CAssetBrowserWindow::ScanJobMain(void *user, uint32_t)
     {
-        std::unordered_map<std::filesystem::path, file_stamp_t> prev;
-        uint32_t missing_scans = 0;
+        static_cast<CAssetBrowserWindow *>(user)->ScanOnce();
+    }
 
-        while (m_scan_run.load())
-        {
-            pending_snapshot_t snap;
-            std::unordered_map<std::filesystem::path, file_stamp_t> now;
+    void CAssetBrowserWindow::KickScanner()
+    {
+        if (!m_scan_run.load() || !jobs_counter_done(&m_scan_jobs))
+            return;
 
-            std::error_code ec;
-            bool scan_ok = false;
-            bool root_exists = false;
+        uint32_t ms = m_scan_interval_ms;
+        if (ms < 100) ms = 100;
 
-            try
+        auto now = std::chrono::steady_clock::now();
+        if (m_scan_started && now - m_scan_last < std::chrono::milliseconds(ms))
+            return;
+
+        m_scan_started = 1;
+        m_scan_last = now;
+        jobs_run_background(&CAssetBrowserWindow::ScanJobMain, this, &m_scan_jobs);
+    }
+
+    void CAssetBrowserWindow::ScanOnce()
+    {
+        pending_snapshot_t snap;
+        std::unordered_map<std::filesystem::path, file_stamp_t> now;
+
+        std::error_code ec;
+        bool scan_ok = false;
+        bool root_exists = false;
+
+        try
+        {
+            if (!m_scan_root_abs.empty())
             {
-                if (!m_scan_root_abs.empty())
+                root_exists = std::filesystem::exists(m_scan_root_abs, ec) && std::filesystem::is_directory(m_scan_root_abs, ec);
+                if (ec)
                 {
-                    root_exists = std::filesystem::exists(m_scan_root_abs, ec) && std::filesystem::is_directory(m_scan_root_abs, ec);
-                    if (ec)
-                    {
-                        ec.clear();
-                    }
-                    else if (root_exists)
+                    ec.clear();
+                }
+                else if (root_exists)
+                {
+                    std::filesystem::recursive_directory_iterator it(m_scan_root_abs, std::filesystem::directory_options::skip_permission_denied, ec);
+                    std::filesystem::recursive_directory_iterator end;
+                    if (!ec)
                     {
-                        std::filesystem::recursive_directory_iterator it(m_scan_root_abs, std::filesystem::directory_options::skip_permission_denied, ec);
-                        std::filesystem::recursive_directory_iterator end;
-                        if (!ec)
+                        scan_ok = true;
+
+                        for (; it != end && m_scan_run.load(); it.increment(ec))
                         {
-                            scan_ok = true;
+                            if (ec)
+                            {
+                                ec.clear();
+                                continue;
+                            }
 
-                            for (; it != end && m_scan_run.load(); it.increment(ec))
+                            auto p = it->path();
+                            auto rel = std::filesystem::relative(p, m_scan_root_abs, ec);
+                            if (ec)
                             {
-                                if (ec)
-                                {
-                                    ec.clear();
-                                    continue;
-                                }
-
-                                auto p = it->path();
-                                auto rel = std::filesystem::relative(p, m_scan_root_abs, ec);
-                                if (ec)
-                                {
-                                    ec.clear();
-                                    continue;
-                                }
-
-                                if (is_dir_ignored_rel(rel))
-                                {
-                                    if (it->is_directory(ec))
-                                        it.disable_recursion_pending();
-                                    continue;
-                                }
+                                ec.clear();
+                                continue;
+                            }
 
+                            if (is_dir_ignored_rel(rel))
+                            {
                                 if (it->is_directory(ec))
-                                {
-                                    snap.folders_rel.push_back(rel.lexically_normal());
-                                    continue;
-                                }
-
-                                if (!it->is_regular_file(ec))
-                                    continue;
-
-                                file_stamp_t st;
-                                auto ft = std::filesystem::last_write_time(p, ec);
-                                if (ec)
-                                {
-                                    ec.clear();
-                                    continue;
-                                }
-                                st.write_time = FileTimeToU64(ft);
-
-                                auto fs = std::filesystem::file_size(p, ec);
-                                if (ec)
-                                {
-                                    ec.clear();
-                                    fs = 0;
-                                }
-                                st.file_size = (uint64_t)fs;
-
-                                now[p] = st;
-
-                                item_t item;
-                                try
-                                {
-                                    item.abs_path = p.lexically_normal();
-                                    item.rel_path = rel.lexically_normal();
-                                    item.id = HashPath64(item.rel_path);
-                                    item.ext = ToLower(item.abs_path.extension().string());
-                                    item.name = StemString(item.abs_path);
-                                    item.type = m_cb.resolve_type_from_path ? m_cb.resolve_type_from_path(item.abs_path) : ASSET_NONE;
-                                    item.stamp = st;
-                                }
-                                catch (const std::bad_alloc&)
-                                {
-                                    LOG_ERROR("AssetBrowser: out of memory while indexing a file (size=%" PRIu64 " bytes)", (uint64_t)st.file_size);
-                                    continue;
-                                }
-                                catch (const std::exception&)
-                                {
-                                    // Skip problematic entries (e.g. very long/invalid paths, transient IO issues, OOM).
-                                    continue;
-                                }
-                                catch (...)
-                                {
-                                    continue;
-                                }
-
-                                snap.items.push_back(std::move(item));
+                                    it.disable_recursion_pending();
+                                continue;
                             }
+
+                            if (it->is_directory(ec))
+                            {
+                                snap.folders_rel.push_back(rel.lexically_normal());
+                                continue;
+                            }
+
+                            if (!it->is_regular_file(ec))
+                                continue;
+
+                            file_stamp_t st;
+                            auto ft = std::filesystem::last_write_time(p, ec);
+                            if (ec)
+                            {
+                                ec.clear();
+                                continue;
+                            }
+                            st.write_time = FileTimeToU64(ft);
+
+                            auto fs = std::filesystem::file_size(p, ec);
+                            if (ec)
+                            {
+                                ec.clear();
+                                fs = 0;
+                            }
+                            st.file_size = (uint64_t)fs;
+
+                            now[p] = st;
+
+                            item_t item;
+                            try
+                            {
+                                item.abs_path = p.lexically_normal();
+                                item.rel_path = rel.lexically_normal();
+                                item.id = HashPath64(item.rel_path);
+                                item.ext = ToLower(item.abs_path.extension().string());
+                                item.name = StemString(item.abs_path);
+                                item.type = m_cb.resolve_type_from_path ? m_cb.resolve_type_from_path(item.abs_path) : ASSET_NONE;
+                                item.stamp = st;
+                            }
+                            catch (const std::bad_alloc&)
+                            {
+                                LOG_ERROR("AssetBrowser: out of memory while indexing a file (size=%" PRIu64 " bytes)", (uint64_t)st.file_size);
+                                continue;
+                            }
+                            catch (const std::exception&)
+                            {
+                                // Skip problematic entries (e.g. very long/invalid paths, transient IO issues, OOM).
+                                continue;
+                            }
+                            catch (...)
+                            {
+                                continue;
+                            }
+
+                            snap.items.push_back(std::move(item));
                         }
                     }
                 }
             }
-            catch (const std::exception& e)
-            {
-                LOG_ERROR("AssetBrowser scan exception: %s", e.what());
-                scan_ok = false;
-            }
-            catch (...)
-            {
-                LOG_ERROR("AssetBrowser scan exception: unknown");
-                scan_ok = false;
-            }
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR("AssetBrowser scan exception: %s", e.what());
+            scan_ok = false;
+        }
+        catch (...)
+        {
+            LOG_ERROR("AssetBrowser scan exception: unknown");
+            scan_ok = false;
+        }
 
-            if (!scan_ok)
-            {
-                if (!m_scan_root_abs.empty() && !root_exists)
-                    missing_scans++;
-                else
-                    missing_scans = 0;
-            }
+        if (!scan_ok)
+        {
+            if (!m_scan_root_abs.empty() && !root_exists)
+                m_scan_missing++;
             else
+                m_scan_missing = 0;
+        }
+        else
+        {
+            m_scan_missing = 0;
+        }
+
+        bool changed = false;
+        if (scan_ok)
+        {
+            if (now.size() != m_scan_prev.size())
             {
-                missing_scans = 0;
+                changed = true;
             }
-
-            bool changed = false;
-            if (scan_ok)
+            else
             {
-                if (now.size() != prev.size())
-                {
-                    changed = true;
-                }
-                else
+                for (auto& kv : now)
                 {
-                    for (auto& kv : now)
+                    auto it = m_scan_prev.find(kv.first);
+                    if (it == m_scan_prev.end())
                     {
-                        auto it = prev.find(kv.first);
-                        if (it == prev.end())
-                        {
-                            changed = true;
-                            break;
-                        }
-                        if (it->second.write_time != kv.second.write_time || it->second.file_size != kv.second.file_size)
-                        {
-                            changed = true;
-                            break;
-                        }
+                        changed = true;
+                        break;
+                    }
+                    if (it->second.write_time != kv.second.write_time || it->second.file_size != kv.second.file_size)
+                    {
+                        changed = true;
+                        break;
                     }
                 }
             }
-            else if (missing_scans >= 4 && !prev.empty())
-            {
-                // Avoid UI flicker if the directory disappears momentarily (e.g. rename/swap): only clear after
-                // a few consecutive failed scans.
-                changed = true;
-                snap.items.clear();
-                snap.folders_rel.clear();
-            }
+        }
+        else if (m_scan_missing >= 4 && !m_scan_prev.empty())
+        {
+            // Avoid UI flicker if the directory disappears momentarily (e.g. rename/swap): only clear after
+            // a few consecutive failed scans.
+            changed = true;
+            snap.items.clear();
+            snap.folders_rel.clear();
+        }
 
-            if (changed)
+        if (changed)
+        {
+            snap.valid = 1;
             {
-                snap.valid = 1;
-                {
-                    std::lock_guard<std::mutex> lk(m_pending_mtx);
-                    m_pending = std::move(snap);
-                }
-                m_pending_dirty.store(1);
-                prev = std::move(now);
+                std::lock_guard<std::mutex> lk(m_pending_mtx);
+                m_pending = std::move(snap);
             }
-
-            uint32_t ms = m_scan_interval_ms;
-            if (ms < 100) ms = 100;
-            for (uint32_t t = 0; t < ms && m_scan_run.load(); t += 25)
-                std::this_thread::sleep_for(std::chrono::milliseconds(25));
+            m_pending_dirty.store(1);
+            m_scan_prev = std::move(now);
         }
     }
 
@@ -7,7 +7,7 @@
 #include <vector>
 #include <unordered_map>
 #include <filesystem>
-#include <thread>
+#include <chrono>
 #include <mutex>
 #include <atomic>
 #include <memory>
@@ -19,6 +19,7 @@ extern "C"
 #include "handle.h"
 #include "asset_manager/asset_types.h"
 #include "asset_manager/asset_manager.h"
+#include "utils/jobs.h"
 }
 
 namespace editor
@@ -55,6 +56,9 @@ namespace editor
         void SetTileSize(float px);
         void SetCallbacks(const callbacks_t &cb);
 
+        // Runs every editor frame, visible or not, so the scan keeps up while the window is hidden.
+        void Update();
+
     private:
         bool BeginImpl() override;
         void EndImpl() override;
@@ -106,7 +110,9 @@ namespace editor
 
         void EnsureScanner();
         void StopScanner();
-        void ScannerThreadMain();
+        void KickScanner();
+        void ScanOnce();
+        static void ScanJobMain(void *user, uint32_t worker_index);
 
         void ApplyPendingSnapshot();
         void RebuildFolderTree();
@@ -145,8 +151,13 @@ namespace editor
 
         callbacks_t m_cb{};
 
-        std::thread m_scan_thread;
+        // Directory scans run as background jobs, at most one in flight, kicked from Draw().
+        jobs_counter_t m_scan_jobs{};
         std::atomic<uint8_t> m_scan_run{0};
+        uint8_t m_scan_started = 0;
+        std::chrono::steady_clock::time_point m_scan_last{};
+        std::unordered_map<std::filesystem::path, file_stamp_t> m_scan_prev;
+        uint32_t m_scan_missing = 0;
 
         std::mutex m_pending_mtx;
         pending_snapshot_t m_pending;
@@ -67,6 +67,12 @@ namespace editor
                     (double)bytes_to_mb(m_Snapshot.tex_stream_evicted_bytes_last_frame),
                     (unsigned)m_Snapshot.tex_stream_evictions_last_frame,
                     (unsigned)m_Snapshot.tex_stream_pending_uploads);
+        ImGui::Text("host: %.1f MB held (budget %.1f MB)  system %.0f / %.0f MB  unloaded %u",
+                    (double)bytes_to_mb(m_Snapshot.host_resident_bytes),
+                    (double)bytes_to_mb(m_Snapshot.host_budget_bytes),
+                    (double)bytes_to_mb(m_Snapshot.host_used_bytes),
+                    (double)bytes_to_mb(m_Snapshot.host_limit_bytes),
+                    (unsigned)m_Snapshot.host_evictions_total);
 
         ImGui::SeparatorText("Queues");
         ImGui::Text("jobs_pending: %u", m_Snapshot.jobs_pending);
@@ -92,7 +98,7 @@ namespace editor
             ImGuiTableFlags_Hideable |
             ImGuiTableFlags_ScrollY;
 
-        if (!ImGui::BeginTable("##asset_table", 14, table_flags, ImVec2(0.0f, 0.0f)))
+        if (!ImGui::BeginTable("##asset_table", 15, table_flags, ImVec2(0.0f, 0.0f)))
             return;
 
         ImGui::TableSetupScrollFreeze(0, 1);
@@ -103,6 +109,7 @@ namespace editor
         ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed, 110.0f);
         ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed, 80.0f);
         ImGui::TableSetupColumn("Inflight", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableSetupColumn("Deps", ImGuiTableColumnFlags_WidthFixed, 70.0f);
         ImGui::TableSetupColumn("Flags", ImGuiTableColumnFlags_WidthFixed, 110.0f);
         ImGui::TableSetupColumn("VRAM (MB)", ImGuiTableColumnFlags_WidthFixed, 90.0f);
         ImGui::TableSetupColumn("Mips", ImGuiTableColumnFlags_WidthFixed, 120.0f);
@@ -172,43 +179,50 @@ namespace editor
             ImGui::TableSetColumnIndex(6);
             ImGui::Text("%u", (unsigned)s.inflight);
 
+            // Direct dependencies, and in brackets how many of them (plus the asset itself) are still loading.
             ImGui::TableSetColumnIndex(7);
+            if (s.dep_count)
+                ImGui::Text("%u (%u)", (unsigned)s.dep_count, (unsigned)s.deps_pending);
+            else
+                ImGui::TextUnformatted("-");
+
+            ImGui::TableSetColumnIndex(8);
             if (s.flags & ASSET_FLAG_NO_UNLOAD)
                 ImGui::TextUnformatted("NO_UNLOAD");
             else
                 ImGui::TextUnformatted("-");
 
-            ImGui::TableSetColumnIndex(8);
+            ImGui::TableSetColumnIndex(9);
             if (s.vram_bytes)
                 ImGui::Text("%.2f", (double)bytes_to_mb(s.vram_bytes));
             else
                 ImGui::TextUnformatted("-");
 
-            ImGui::TableSetColumnIndex(9);
+            ImGui::TableSetColumnIndex(10);
             if (s.type == ASSET_IMAGE && s.state == ASSET_STATE_READY && s.img_mip_count)
                 ImGui::Text("%u  %u/%u%s  p%u", (unsigned)s.img_mip_count, (unsigned)s.img_resident_top_mip, (unsigned)s.img_target_top_mip, s.img_forced ? " *" : "", (unsigned)s.img_priority);
             else
                 ImGui::TextUnformatted("-");
 
-            ImGui::TableSetColumnIndex(10);
+            ImGui::TableSetColumnIndex(11);
             if (s.type == ASSET_IMAGE && s.state == ASSET_STATE_READY && s.img_mip_count)
                 ImGui::Text("0x%08X%08X", (unsigned)(s.img_residency_mask >> 32), (unsigned)(s.img_residency_mask & 0xFFFFFFFFu));
             else
                 ImGui::TextUnformatted("-");
 
-            ImGui::TableSetColumnIndex(11);
+            ImGui::TableSetColumnIndex(12);
             if (s.last_requested_ms)
                 ImGui::Text("%.1f", (double)age_ms / 1000.0);
             else
                 ImGui::TextUnformatted("-");
 
-            ImGui::TableSetColumnIndex(12);
+            ImGui::TableSetColumnIndex(13);
             if (s.last_requested_ms && m_Snapshot.streaming_enabled && m_Snapshot.stream_unused_ms)
                 ImGui::Text("%.1f", (double)remain_ms / 1000.0);
             else
                 ImGui::TextUnformatted("-");
 
-            ImGui::TableSetColumnIndex(13);
+            ImGui::TableSetColumnIndex(14);
             ImGui::TextUnformatted(s.path[0] ? s.path : "-");
         }
 
@@ -44,7 +44,7 @@ namespace editor
 
     static bool inspector_handle_valid(ihandle_t h)
     {
-        return ((uint32_t)h.value | (uint32_t)h.type | (uint32_t)h.meta) != 0;
+        return (h.value | (uint64_t)h.type | (uint64_t)h.meta) != 0;
     }
 
     static void inspector_make_asset_label(CEditorContext *ctx, ihandle_t h, char *out, uint32_t out_sz)
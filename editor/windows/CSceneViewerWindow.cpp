@@ -6,6 +6,7 @@ extern "C"
 #include "core/systems/ecs/components/c_tag.h"
 #include "core/systems/ecs/components/c_transform.h"
 #include "core/systems/ecs/entity.h"
+#include "core/systems/ecs/view.h"
 }
 
 #include <stdio.h>
@@ -79,16 +80,18 @@ namespace editor
         children.clear();
         roots.clear();
 
-        uint32_t n = ecs_count(w, c_tag_t);
-        c_tag_t *tags = ecs_dense(w, c_tag_t);
-        if (!tags || n == 0)
+        ecs_component_id_t tag_id = ecs_component_id(w, c_tag_t);
+        ecs_view_t v;
+        if (!tag_id || !ecs_view_init(&v, w, 1u, &tag_id))
             return;
 
         ecs_entity_t root = ecs_world_root(w);
 
-        for (uint32_t i = 0; i < n; ++i)
+        ecs_entity_t e = 0;
+        void *c[1];
+
+        while (ecs_view_next(&v, &e, c))
         {
-            ecs_entity_t e = tags[i].base.entity;
             if (!ecs_entity_is_alive(w, e))
                 continue;
 
@@ -163,6 +163,16 @@ namespace editor
                     (unsigned)m_Snapshot.tex_stream_evictions_last_frame,
                     (unsigned)m_Snapshot.tex_stream_stable_frames,
                     (unsigned)m_Snapshot.tex_stream_evict_unused_ms);
+        {
+            const uint32_t settled = m_Snapshot.tex_prefetch_hits_total + m_Snapshot.tex_prefetch_misses_total;
+            const double hit_rate = settled ? 100.0 * (double)m_Snapshot.tex_prefetch_hits_total / (double)settled : 0.0;
+            ImGui::Text("Prefetch: %u issued  %u hit  %u miss (%.0f%% hit)   wasted %.2f MB",
+                        (unsigned)m_Snapshot.tex_prefetch_issued_total,
+                        (unsigned)m_Snapshot.tex_prefetch_hits_total,
+                        (unsigned)m_Snapshot.tex_prefetch_misses_total,
+                        hit_rate,
+                        (double)bytes_to_mb(m_Snapshot.tex_prefetch_wasted_bytes_total));
+        }
 
         // VRAM caveat / sparse stats (Task Manager only drops when sparse commit/decommit is supported+used).
         {
@@ -464,18 +464,20 @@ namespace editor
                     if (st.vram_budget_bytes)
                     {
                         snprintf(asset_line, sizeof(asset_line),
-                                 "Tex: %.1f/%.0f MB  up %.2f MB (%u)  ev %.2f MB (%u)  pend %u  jobs %u/%u",
+                                 "Tex: %.1f/%.0f MB  up %.2f MB (%u)  ev %.2f MB (%u)  pend %u  jobs %u/%u  get %u (%u locked)",
                                  vram_mb, bud_mb, up_mb, (unsigned)st.tex_stream_uploads_last_frame, ev_mb, (unsigned)st.tex_stream_evictions_last_frame,
                                  (unsigned)st.tex_stream_pending_uploads,
-                                 (unsigned)st.jobs_pending, (unsigned)st.done_pending);
+                                 (unsigned)st.jobs_pending, (unsigned)st.done_pending,
+                                 (unsigned)st.get_any_last_frame, (unsigned)st.get_any_locked_last_frame);
                     }
                     else
                     {
                         snprintf(asset_line, sizeof(asset_line),
-                                 "Tex: %.1f MB  up %.2f MB (%u)  ev %.2f MB (%u)  pend %u  jobs %u/%u",
+                                 "Tex: %.1f MB  up %.2f MB (%u)  ev %.2f MB (%u)  pend %u  jobs %u/%u  get %u (%u locked)",
                                  vram_mb, up_mb, (unsigned)st.tex_stream_uploads_last_frame, ev_mb, (unsigned)st.tex_stream_evictions_last_frame,
                                  (unsigned)st.tex_stream_pending_uploads,
-                                 (unsigned)st.jobs_pending, (unsigned)st.done_pending);
+                                 (unsigned)st.jobs_pending, (unsigned)st.done_pending,
+                                 (unsigned)st.get_any_last_frame, (unsigned)st.get_any_locked_last_frame);
                     }
                 }
             }
@@ -218,7 +218,10 @@ vec3 srgb_to_linear(vec3 c)
 
 vec3 tangent_space_normal(vec2 uv)
 {
-    vec3 n = texture(u_NormalTex, uv).xyz * 2.0 - 1.0;
+    // z is rebuilt from xy: BC5 normal maps only store two channels.
+    vec3 n;
+    n.xy = texture(u_NormalTex, uv).xy * 2.0 - 1.0;
+    n.z = sqrt(max(1.0 - dot(n.xy, n.xy), 0.0));
     n.xy *= u_NormalStrength;
     return normalize(n);
 }
@@ -0,0 +1,152 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "utils/jobs.h"
+#include "managers/asset_manager/asset_codec.h"
+
+// Matches CODEC_CHUNK_SIZE in asset_codec.c; sizes around it cover partial and exact last chunks.
+#define CHUNK (256u * 1024u)
+
+static const uint32_t g_sizes[] = {1u, 100u, CHUNK - 1u, CHUNK, CHUNK + 1u, 3u * CHUNK + 17u, 70u * CHUNK + 5u};
+
+static uint32_t test_rand(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// Half structured (runs and a repeating ramp), half noise, so chunks compress differently.
+static void fill(uint8_t *p, uint32_t n, uint32_t seed)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if ((i / 4096u) & 1u)
+            p[i] = (uint8_t)test_rand(&seed);
+        else
+            p[i] = (uint8_t)((i / 64u) + (i & 7u));
+    }
+}
+
+static void test_round_trip(void)
+{
+    const uint8_t codecs[] = {ASSET_CODEC_LZ4, ASSET_CODEC_ZSTD};
+    for (uint32_t c = 0; c < 2u; ++c)
+    {
+        for (uint32_t s = 0; s < sizeof(g_sizes) / sizeof(g_sizes[0]); ++s)
+        {
+            const uint32_t n = g_sizes[s];
+            uint8_t *src = (uint8_t *)malloc(n);
+            uint8_t *dst = (uint8_t *)malloc(n);
+            TEST_CHECK(src && dst);
+            if (!src || !dst)
+            {
+                free(src);
+                free(dst);
+                return;
+            }
+            fill(src, n, 0x1234u + s);
+
+            uint8_t *enc = NULL;
+            uint32_t enc_size = 0;
+            TEST_CHECK(asset_codec_encode(codecs[c], src, n, &enc, &enc_size));
+            TEST_CHECK(enc && enc_size > 0u);
+
+            memset(dst, 0xCD, n);
+            TEST_CHECK(asset_codec_decode(codecs[c], enc, enc_size, dst, n));
+            TEST_CHECK(memcmp(src, dst, n) == 0);
+
+            free(enc);
+            free(dst);
+            free(src);
+        }
+    }
+}
+
+static void test_compresses(void)
+{
+    const uint32_t n = 4u * CHUNK;
+    uint8_t *src = (uint8_t *)malloc(n);
+    TEST_CHECK(src != NULL);
+    if (!src)
+        return;
+    for (uint32_t i = 0; i < n; ++i)
+        src[i] = (uint8_t)((i / 64u) + (i & 7u));
+
+    uint8_t *lz4 = NULL;
+    uint8_t *zstd = NULL;
+    uint32_t lz4_size = 0;
+    uint32_t zstd_size = 0;
+    TEST_CHECK(asset_codec_encode(ASSET_CODEC_LZ4, src, n, &lz4, &lz4_size));
+    TEST_CHECK(asset_codec_encode(ASSET_CODEC_ZSTD, src, n, &zstd, &zstd_size));
+    TEST_CHECK(lz4_size > 0u && lz4_size < n / 8u);
+    TEST_CHECK(zstd_size > 0u && zstd_size < n / 8u);
+
+    free(zstd);
+    free(lz4);
+    free(src);
+}
+
+static void test_rejects_bad_input(void)
+{
+    const uint32_t n = 2u * CHUNK + 3u;
+    uint8_t *src = (uint8_t *)malloc(n);
+    uint8_t *dst = (uint8_t *)malloc(n + 1u);
+    TEST_CHECK(src && dst);
+    if (!src || !dst)
+    {
+        free(src);
+        free(dst);
+        return;
+    }
+    fill(src, n, 77u);
+
+    uint8_t *enc = NULL;
+    uint32_t enc_size = 0;
+    TEST_CHECK(asset_codec_encode(ASSET_CODEC_ZSTD, src, n, &enc, &enc_size));
+
+    // Wrong codec, wrong size, truncated frame and a chunk table pointing past the payload.
+    TEST_CHECK(!asset_codec_decode(ASSET_CODEC_NONE, enc, enc_size, dst, n));
+    TEST_CHECK(!asset_codec_decode(ASSET_CODEC_COUNT, enc, enc_size, dst, n));
+    TEST_CHECK(!asset_codec_decode(ASSET_CODEC_ZSTD, enc, enc_size, dst, n - 1u));
+    TEST_CHECK(!asset_codec_decode(ASSET_CODEC_ZSTD, enc, enc_size, dst, n + 1u));
+    TEST_CHECK(!asset_codec_decode(ASSET_CODEC_ZSTD, enc, 8u, dst, n));
+    TEST_CHECK(!asset_codec_decode(ASSET_CODEC_ZSTD, enc, enc_size - 16u, dst, n));
+
+    uint8_t *bad = (uint8_t *)malloc(enc_size);
+    TEST_CHECK(bad != NULL);
+    if (bad)
+    {
+        memcpy(bad, enc, enc_size);
+        memset(bad, 0, 4u);
+        TEST_CHECK(!asset_codec_decode(ASSET_CODEC_ZSTD, bad, enc_size, dst, n));
+        free(bad);
+    }
+
+    // Encoding needs a real codec and data.
+    uint8_t *none = NULL;
+    uint32_t none_size = 1u;
+    TEST_CHECK(!asset_codec_encode(ASSET_CODEC_NONE, src, n, &none, &none_size));
+    TEST_CHECK(none == NULL && none_size == 0u);
+    TEST_CHECK(!asset_codec_encode(ASSET_CODEC_LZ4, src, 0u, &none, &none_size));
+
+    TEST_CHECK(asset_codec_get(ASSET_CODEC_NONE) == NULL);
+    TEST_CHECK(asset_codec_get(ASSET_CODEC_LZ4) != NULL && asset_codec_get(ASSET_CODEC_ZSTD) != NULL);
+
+    free(enc);
+    free(dst);
+    free(src);
+}
+
+int main(void)
+{
+    if (!jobs_init(3u))
+        return 1;
+    TEST_RUN(test_round_trip);
+    TEST_RUN(test_compresses);
+    TEST_RUN(test_rejects_bad_input);
+    jobs_shutdown();
+    return test_failures ? 1 : 0;
+}
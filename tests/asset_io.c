@@ -0,0 +1,272 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "test.h"
+#include "utils/threads.h"
+#include "managers/asset_manager/asset_io.h"
+
+#define FILE_COUNT 48u
+#define SUBMITTERS 6u
+#define READS_PER_SUBMITTER 400u
+#define QUEUE_DEPTH 4u
+#define IO_DIR "asset_io_test_files"
+// Index of a path that is never created; its reads must fail.
+#define MISSING_FILE FILE_COUNT
+
+typedef struct io_test_t
+{
+    asset_io_t io;
+    volatile uint32_t ok;
+    volatile uint32_t failed;
+    volatile uint32_t corrupt;
+    volatile uint32_t callbacks;
+
+    // Buffers handed over by the callbacks, released by another thread so the queue-depth limit
+    // is exercised with buffers that outlive the callback.
+    mutex_t held_m;
+    uint8_t *held[FILE_COUNT * 4u];
+    uint32_t held_count;
+    uint32_t held_peak;
+    volatile uint32_t releasing;
+} io_test_t;
+
+static io_test_t g_t;
+
+static uint32_t file_size(uint32_t i)
+{
+    // From a few bytes to a little over 1 MB, so large reads take several syscalls.
+    return 1u + (i * 7919u * 37u) % (1u << 20) + ((i & 3u) == 0u ? (1u << 20) : 0u);
+}
+
+static uint8_t file_byte(uint32_t i, uint32_t at)
+{
+    return (uint8_t)(i * 31u + at * 7u + (at >> 12));
+}
+
+static void file_path(char *out, size_t cap, uint32_t i)
+{
+    snprintf(out, cap, IO_DIR "/f%u.bin", i);
+}
+
+static bool files(bool create)
+{
+    if (create)
+    {
+#if defined(_WIN32)
+        _mkdir(IO_DIR);
+#else
+        mkdir(IO_DIR, 0755);
+#endif
+    }
+
+    bool ok = true;
+    char path[64];
+    for (uint32_t i = 0; i < FILE_COUNT; ++i)
+    {
+        file_path(path, sizeof(path), i);
+        if (!create)
+        {
+            remove(path);
+            continue;
+        }
+
+        const uint32_t n = file_size(i);
+        uint8_t *data = (uint8_t *)malloc(n);
+        FILE *f = data ? fopen(path, "wb") : NULL;
+        if (f)
+        {
+            for (uint32_t k = 0; k < n; ++k)
+                data[k] = file_byte(i, k);
+            ok &= fwrite(data, 1, n, f) == n;
+            ok &= fclose(f) == 0;
+        }
+        else
+        {
+            ok = false;
+        }
+        free(data);
+    }
+
+    if (!create)
+    {
+#if defined(_WIN32)
+        _rmdir(IO_DIR);
+#else
+        rmdir(IO_DIR);
+#endif
+    }
+    return ok;
+}
+
+static void read_done(void *user, uint8_t *data, uint32_t size)
+{
+    const uint32_t i = (uint32_t)(uintptr_t)user - 1u;
+    if (!data)
+    {
+        if (i != MISSING_FILE)
+            atomic_add_u32(&g_t.corrupt, 1u);
+        atomic_add_u32(&g_t.failed, 1u);
+        atomic_add_u32(&g_t.callbacks, 1u);
+        return;
+    }
+
+    bool good = i < FILE_COUNT && size == file_size(i);
+    for (uint32_t k = 0; good && k < size; k += 61u)
+        good = data[k] == file_byte(i, k);
+    good = good && data[size - 1u] == file_byte(i, size - 1u);
+    if (!good)
+        atomic_add_u32(&g_t.corrupt, 1u);
+    atomic_add_u32(&g_t.ok, 1u);
+
+    threads_mutex_lock(&g_t.held_m);
+    g_t.held[g_t.held_count++] = data;
+    if (g_t.held_count > g_t.held_peak)
+        g_t.held_peak = g_t.held_count;
+    threads_mutex_unlock(&g_t.held_m);
+
+    atomic_add_u32(&g_t.callbacks, 1u);
+}
+
+static void releaser_main(void *arg)
+{
+    (void)arg;
+    while (atomic_load_u32(&g_t.releasing))
+    {
+        uint8_t *data = NULL;
+        threads_mutex_lock(&g_t.held_m);
+        if (g_t.held_count)
+            data = g_t.held[--g_t.held_count];
+        threads_mutex_unlock(&g_t.held_m);
+
+        if (data)
+            asset_io_release(&g_t.io, data);
+        else
+            threads_yield();
+    }
+}
+
+static void submitter_main(void *arg)
+{
+    const uint32_t seed = (uint32_t)(uintptr_t)arg;
+    char path[64];
+    for (uint32_t n = 0; n < READS_PER_SUBMITTER; ++n)
+    {
+        // Every 50th read asks for the missing file.
+        const uint32_t i = (n % 50u == 49u) ? MISSING_FILE : (seed * 13u + n * 7u) % FILE_COUNT;
+        file_path(path, sizeof(path), i);
+        if (!asset_io_read(&g_t.io, path, read_done, (void *)(uintptr_t)(i + 1u)))
+            atomic_add_u32(&g_t.corrupt, 1u);
+    }
+}
+
+static bool wait_callbacks(uint32_t n)
+{
+    for (uint32_t spin = 0; spin < 2000000u; ++spin)
+    {
+        if (atomic_load_u32(&g_t.callbacks) >= n)
+            return true;
+        threads_yield();
+    }
+    return false;
+}
+
+static void reset(void)
+{
+    memset(&g_t, 0, sizeof(g_t));
+    threads_mutex_init(&g_t.held_m);
+}
+
+static void stress(asset_io_backend_t backend)
+{
+    reset();
+    TEST_CHECK(asset_io_init(&g_t.io, QUEUE_DEPTH, backend));
+
+    atomic_store_u32(&g_t.releasing, 1u);
+    thread_t releaser;
+    TEST_CHECK(threads_thread_create(&releaser, releaser_main, NULL));
+
+    thread_t t[SUBMITTERS];
+    for (uint32_t i = 0; i < SUBMITTERS; ++i)
+        TEST_CHECK(threads_thread_create(&t[i], submitter_main, (void *)(uintptr_t)i));
+    for (uint32_t i = 0; i < SUBMITTERS; ++i)
+        threads_thread_join(&t[i]);
+
+    const uint32_t total = SUBMITTERS * READS_PER_SUBMITTER;
+    TEST_CHECK(wait_callbacks(total));
+    atomic_store_u32(&g_t.releasing, 0u);
+    threads_thread_join(&releaser);
+
+    // Buffers waiting for the releaser count against the queue depth, so reads stall meanwhile.
+    TEST_CHECK(g_t.callbacks == total);
+    TEST_CHECK(g_t.corrupt == 0u);
+    TEST_CHECK(g_t.failed == SUBMITTERS * (READS_PER_SUBMITTER / 50u));
+    TEST_CHECK(g_t.ok + g_t.failed == total);
+    TEST_CHECK(g_t.held_peak >= 1u && g_t.held_peak <= QUEUE_DEPTH);
+
+    while (g_t.held_count)
+        asset_io_release(&g_t.io, g_t.held[--g_t.held_count]);
+    asset_io_shutdown(&g_t.io);
+    threads_mutex_destroy(&g_t.held_m);
+}
+
+static void cancel(asset_io_backend_t backend)
+{
+    reset();
+    TEST_CHECK(asset_io_init(&g_t.io, 1u, backend));
+
+    // The first buffer is never released before shutdown, so every later read stays queued and
+    // is cancelled: its callback still runs, with NULL.
+    char path[64];
+    const uint32_t n = 32u;
+    for (uint32_t k = 0; k < n; ++k)
+    {
+        const uint32_t i = k % FILE_COUNT;
+        file_path(path, sizeof(path), i);
+        TEST_CHECK(asset_io_read(&g_t.io, path, read_done, (void *)(uintptr_t)(i + 1u)));
+    }
+    TEST_CHECK(wait_callbacks(1u));
+
+    asset_io_shutdown(&g_t.io);
+    TEST_CHECK(g_t.callbacks == n);
+    TEST_CHECK(g_t.ok == 1u && g_t.held_count == 1u);
+    TEST_CHECK(g_t.failed == n - 1u);
+    TEST_CHECK(!asset_io_read(&g_t.io, path, read_done, NULL));
+
+    asset_io_release(&g_t.io, g_t.held[0]);
+    threads_mutex_destroy(&g_t.held_m);
+}
+
+static void test_threads(void)
+{
+    stress(ASSET_IO_BACKEND_THREADS);
+    cancel(ASSET_IO_BACKEND_THREADS);
+}
+
+// Without io_uring support AUTO falls back to reader threads; the same checks apply.
+static void test_uring(void)
+{
+    stress(ASSET_IO_BACKEND_AUTO);
+    cancel(ASSET_IO_BACKEND_AUTO);
+}
+
+int main(void)
+{
+    if (!files(true))
+    {
+        files(false);
+        return 1;
+    }
+    TEST_RUN(test_threads);
+    TEST_RUN(test_uring);
+    files(false);
+    return test_failures ? 1 : 0;
+}
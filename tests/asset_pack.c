@@ -0,0 +1,425 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "test.h"
+#include "utils/jobs.h"
+#include "iKv1.h"
+#include "managers/asset_manager/asset_manager.h"
+#include "managers/asset_manager/asset_codec.h"
+
+#define ASSET_COUNT 24u
+// asset_manager_request only queues paths that exist, so each material gets an empty file here.
+#define SOURCE_DIR "asset_pack_test_files"
+#define PACK_PATH "asset_pack_test.pack"
+#define BAD_PACK_PATH "asset_pack_test_bad.pack"
+
+// Mirrors the version 3 layout in asset_manager.c; the tests read packs the way another tool would.
+typedef struct test_pack_hdr_t
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved0;
+    uint32_t toc_count;
+    uint32_t reserved1;
+    uint64_t toc_offset;
+    uint64_t data_offset;
+    uint64_t file_size;
+} test_pack_hdr_t;
+
+typedef struct test_pack_toc_t
+{
+    uint64_t key;
+    uint16_t type;
+    uint16_t variant;
+    uint32_t flags;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t uncompressed_size;
+    uint8_t codec;
+    uint8_t reserved1;
+    uint16_t reserved2;
+    uint32_t reserved3;
+} test_pack_toc_t;
+
+_Static_assert(sizeof(test_pack_hdr_t) == 40, "pack header layout");
+_Static_assert(sizeof(test_pack_toc_t) == 40, "pack toc layout");
+
+static uint32_t g_blob_loads;
+
+static void source_path(char *out, size_t cap, uint32_t id)
+{
+    snprintf(out, cap, SOURCE_DIR "/mat_%u", id);
+}
+
+static bool source_files(bool create)
+{
+    if (create)
+    {
+#if defined(_WIN32)
+        _mkdir(SOURCE_DIR);
+#else
+        mkdir(SOURCE_DIR, 0755);
+#endif
+    }
+
+    bool ok = true;
+    char path[64];
+    for (uint32_t i = 0; i < ASSET_COUNT; ++i)
+    {
+        source_path(path, sizeof(path), i);
+        if (!create)
+        {
+            remove(path);
+            continue;
+        }
+        FILE *f = fopen(path, "wb");
+        ok &= f != NULL;
+        if (f)
+            fclose(f);
+    }
+
+    if (!create)
+    {
+#if defined(_WIN32)
+        _rmdir(SOURCE_DIR);
+#else
+        rmdir(SOURCE_DIR);
+#endif
+    }
+    return ok;
+}
+
+static asset_material_t expected_material(uint32_t id)
+{
+    asset_material_t m;
+    memset(&m, 0, sizeof(m));
+    m.flags = (id & 1u) ? MAT_FLAG_DOUBLE_SIDED : 0;
+    // Values the text format stores exactly.
+    m.albedo = (vec3){(float)id * 0.125f, (float)id * 0.25f, (float)id * 0.5f};
+    m.roughness = (float)id / 32.0f;
+    m.metallic = 1.0f - m.roughness;
+    m.opacity = 1.0f;
+    m.normal_strength = 1.0f;
+    m.height_steps = (int)id;
+    return m;
+}
+
+// The material format has no name field, so the id travels in height_steps.
+static uint32_t material_id(const asset_material_t *m)
+{
+    return (uint32_t)m->height_steps;
+}
+
+static bool material_matches(const asset_material_t *m)
+{
+    const uint32_t id = material_id(m);
+    if (id >= ASSET_COUNT)
+        return false;
+    const asset_material_t e = expected_material(id);
+    return m->flags == e.flags && m->albedo.x == e.albedo.x && m->albedo.y == e.albedo.y && m->albedo.z == e.albedo.z &&
+           m->roughness == e.roughness && m->metallic == e.metallic && m->height_steps == e.height_steps;
+}
+
+static bool test_can_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr)
+{
+    (void)am;
+    return !path_is_ptr && strncmp(path, SOURCE_DIR "/", sizeof(SOURCE_DIR)) == 0;
+}
+
+// Materials are synthesized from the file name; the built-in material module saves them.
+static bool test_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr, asset_any_t *out, ihandle_t *out_handle)
+{
+    (void)am;
+    (void)path_is_ptr;
+    (void)out_handle;
+    out->type = ASSET_MATERIAL;
+    out->state = ASSET_STATE_LOADING;
+    out->as.material = expected_material((uint32_t)strtoul(path + sizeof(SOURCE_DIR "/mat_") - 1u, NULL, 10));
+    return true;
+}
+
+static bool test_load_blob(asset_manager_t *am, const char *path, const asset_blob_t *blob, asset_any_t *out, ihandle_t *out_handle)
+{
+    (void)am;
+    (void)path;
+    (void)out_handle;
+
+    const uint32_t size = blob->codec != ASSET_CODEC_NONE ? blob->uncompressed_size : blob->size;
+    char *text = (char *)malloc((size_t)size + 1u);
+    if (!text)
+        return false;
+
+    bool ok = blob->codec == ASSET_CODEC_NONE ? (memcpy(text, blob->data, size), true)
+                                              : asset_codec_decode(blob->codec, blob->data, blob->size, text, size);
+    text[size] = 0;
+
+    ikv_node_t *root = ok ? ikv_parse_string(text) : NULL;
+    free(text);
+    asset_material_t m;
+    ok = root && material_from_ikv(root, &m);
+    ikv_free(root);
+    if (!ok)
+        return false;
+
+    out->type = ASSET_MATERIAL;
+    out->state = ASSET_STATE_LOADING;
+    out->as.material = m;
+    atomic_add_u32(&g_blob_loads, 1u);
+    return true;
+}
+
+static bool test_init(asset_manager_t *am, asset_any_t *asset)
+{
+    (void)am;
+    return asset->type == ASSET_MATERIAL;
+}
+
+static void test_cleanup(asset_manager_t *am, asset_any_t *asset)
+{
+    (void)am;
+    free(asset->as.material.name);
+    asset->as.material.name = NULL;
+}
+
+static bool manager_init(asset_manager_t *am)
+{
+    asset_manager_desc_t desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.worker_count = jobs_background_limit();
+    desc.max_inflight_jobs = 256u;
+    desc.handle_type = iHANDLE_TYPE_ASSET;
+    desc.pump_per_frame = 1024u;
+    if (!asset_manager_init(am, &desc))
+        return false;
+
+    asset_module_desc_t m;
+    memset(&m, 0, sizeof(m));
+    m.type = ASSET_MATERIAL;
+    m.name = "TEST_PACK_MATERIAL";
+    m.load_fn = test_load;
+    m.init_fn = test_init;
+    m.cleanup_fn = test_cleanup;
+    m.can_load_fn = test_can_load;
+    m.load_blob_fn = test_load_blob;
+    return asset_manager_register_module(am, m);
+}
+
+static bool request_all(asset_manager_t *am, ihandle_t *handles)
+{
+    char path[64];
+    for (uint32_t i = 0; i < ASSET_COUNT; ++i)
+    {
+        source_path(path, sizeof(path), i);
+        handles[i] = asset_manager_request(am, ASSET_MATERIAL, path);
+        if (!ihandle_is_valid(handles[i]))
+            return false;
+    }
+
+    for (uint32_t spin = 0; spin < 100000u && !all_loaded(am); ++spin)
+    {
+        asset_manager_pump(am, 1024u);
+        threads_yield();
+    }
+    asset_manager_pump(am, 1024u);
+    return all_loaded(am);
+}
+
+static bool all_ready(asset_manager_t *am, const ihandle_t *handles)
+{
+    bool ok = true;
+    for (uint32_t i = 0; i < ASSET_COUNT; ++i)
+    {
+        const asset_any_t *a = asset_manager_get_any(am, handles[i]);
+        ok &= a && a->type == ASSET_MATERIAL && material_matches(&a->as.material) && material_id(&a->as.material) == i;
+    }
+    return ok;
+}
+
+static bool check_layout(const uint8_t *data, uint64_t size, uint8_t codec)
+{
+    test_pack_hdr_t hdr;
+    memcpy(&hdr, data, sizeof(hdr));
+    bool ok = hdr.magic == 0x4B434150u && hdr.version == 3u && hdr.file_size == size;
+    ok &= hdr.toc_count == ASSET_COUNT && (hdr.toc_offset & 15u) == 0u;
+    ok &= hdr.data_offset == sizeof(hdr) && hdr.toc_offset + (uint64_t)hdr.toc_count * sizeof(test_pack_toc_t) == size;
+    if (!ok)
+        return false;
+
+    uint32_t compressed = 0;
+    const test_pack_toc_t *toc = (const test_pack_toc_t *)(data + hdr.toc_offset);
+    for (uint32_t i = 0; i < hdr.toc_count; ++i)
+    {
+        const test_pack_toc_t *e = &toc[i];
+        ok &= i == 0u || e->key > toc[i - 1u].key;
+        ok &= e->type == ASSET_MATERIAL && (e->key >> 48) == e->type;
+        ok &= (e->offset & 63u) == 0u && e->offset >= hdr.data_offset && e->offset + e->size <= hdr.toc_offset;
+        ok &= e->codec == ASSET_CODEC_NONE ? e->uncompressed_size == e->size : e->codec == codec && e->uncompressed_size > e->size;
+        compressed += e->codec != ASSET_CODEC_NONE;
+    }
+    return ok && (codec == ASSET_CODEC_NONE ? compressed == 0u : compressed > 0u);
+}
+
+static bool write_pack(const char *path, const uint8_t *data, uint64_t size)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+    bool ok = fwrite(data, 1, (size_t)size, f) == size;
+    return (fclose(f) == 0) && ok;
+}
+
+static void round_trip(uint8_t codec)
+{
+    TEST_CHECK(source_files(true));
+
+    asset_manager_t *am = (asset_manager_t *)calloc(1, sizeof(asset_manager_t));
+    TEST_CHECK(am && manager_init(am));
+    if (!am)
+        return;
+    asset_manager_set_pack_codec(am, ASSET_MATERIAL, codec);
+
+    ihandle_t handles[ASSET_COUNT];
+    TEST_CHECK(request_all(am, handles));
+    TEST_CHECK(all_ready(am, handles));
+
+    uint8_t *data = NULL;
+    uint64_t size = 0;
+    TEST_CHECK(asset_manager_build_pack(am, &data, &size));
+    TEST_CHECK(data && size > sizeof(test_pack_hdr_t));
+    TEST_CHECK(data && check_layout(data, size, codec));
+
+    // Building again from the same slots produces the same bytes.
+    uint8_t *again = NULL;
+    uint64_t again_size = 0;
+    TEST_CHECK(asset_manager_build_pack(am, &again, &again_size));
+    TEST_CHECK(again_size == size && again && data && memcmp(again, data, (size_t)size) == 0);
+    asset_manager_free_pack(again);
+
+    TEST_CHECK(data && write_pack(PACK_PATH, data, size));
+    asset_manager_shutdown(am);
+    source_files(false);
+
+    // A fresh manager finds every entry by key and loads the requests from the pack alone.
+    memset(am, 0, sizeof(*am));
+    TEST_CHECK(manager_init(am));
+    TEST_CHECK(asset_manager_mount_pack(am, PACK_PATH));
+
+    if (data)
+    {
+        test_pack_hdr_t hdr;
+        memcpy(&hdr, data, sizeof(hdr));
+        const test_pack_toc_t *toc = (const test_pack_toc_t *)(data + hdr.toc_offset);
+        bool found = true;
+        for (uint32_t i = 0; i < hdr.toc_count; ++i)
+        {
+            ihandle_t h;
+            memset(&h, 0, sizeof(h));
+            h.value = (uint32_t)toc[i].key;
+            h.type = (ihandle_type_t)(toc[i].key >> 48);
+            h.meta = (uint16_t)(toc[i].key >> 32);
+
+            asset_blob_t blob;
+            found &= asset_manager_pack_find(am, h, &blob) && blob.size == toc[i].size && blob.codec == toc[i].codec &&
+                     memcmp(blob.data, data + toc[i].offset, toc[i].size) == 0;
+        }
+        TEST_CHECK(found);
+    }
+
+    g_blob_loads = 0;
+    TEST_CHECK(request_all(am, handles));
+    TEST_CHECK(all_ready(am, handles));
+    TEST_CHECK(g_blob_loads == ASSET_COUNT);
+
+    asset_manager_shutdown(am);
+    free(am);
+    asset_manager_free_pack(data);
+    remove(PACK_PATH);
+}
+
+static void test_round_trip(void)
+{
+    round_trip(ASSET_CODEC_NONE);
+    round_trip(ASSET_CODEC_LZ4);
+    round_trip(ASSET_CODEC_ZSTD);
+}
+
+static bool mount_corrupted(asset_manager_t *am, const uint8_t *data, uint64_t size, uint64_t at, const void *bytes, uint32_t n)
+{
+    uint8_t *bad = (uint8_t *)malloc((size_t)size);
+    if (!bad)
+        return true;
+    memcpy(bad, data, (size_t)size);
+    if (bytes)
+        memcpy(bad + at, bytes, n);
+    const bool mounted = write_pack(BAD_PACK_PATH, bad, bytes ? size : at) && asset_manager_mount_pack(am, BAD_PACK_PATH);
+    free(bad);
+    remove(BAD_PACK_PATH);
+    return mounted;
+}
+
+static void test_rejects_bad_pack(void)
+{
+    TEST_CHECK(source_files(true));
+
+    asset_manager_t *am = (asset_manager_t *)calloc(1, sizeof(asset_manager_t));
+    TEST_CHECK(am && manager_init(am));
+    if (!am)
+        return;
+
+    ihandle_t handles[ASSET_COUNT];
+    TEST_CHECK(request_all(am, handles));
+
+    uint8_t *data = NULL;
+    uint64_t size = 0;
+    TEST_CHECK(asset_manager_build_pack(am, &data, &size));
+    source_files(false);
+    if (!data)
+    {
+        asset_manager_shutdown(am);
+        free(am);
+        return;
+    }
+
+    test_pack_hdr_t hdr;
+    memcpy(&hdr, data, sizeof(hdr));
+    const uint64_t toc = hdr.toc_offset;
+
+    const uint32_t bad_magic = 0x12345678u;
+    const uint16_t old_version = 2u;
+    const uint64_t far_offset = size;
+    const uint64_t low_key = 0;
+
+    TEST_CHECK(mount_corrupted(am, data, size, 0, NULL, 0) == false);
+    TEST_CHECK(mount_corrupted(am, data, size, size - 1u, NULL, 0) == false);
+    TEST_CHECK(mount_corrupted(am, data, size, offsetof(test_pack_hdr_t, magic), &bad_magic, sizeof(bad_magic)) == false);
+    TEST_CHECK(mount_corrupted(am, data, size, offsetof(test_pack_hdr_t, version), &old_version, sizeof(old_version)) == false);
+    TEST_CHECK(mount_corrupted(am, data, size, offsetof(test_pack_hdr_t, toc_offset), &far_offset, sizeof(far_offset)) == false);
+    TEST_CHECK(mount_corrupted(am, data, size, toc + sizeof(test_pack_toc_t) + offsetof(test_pack_toc_t, key), &low_key, sizeof(low_key)) == false);
+    TEST_CHECK(mount_corrupted(am, data, size, toc + offsetof(test_pack_toc_t, offset), &far_offset, sizeof(far_offset)) == false);
+    // The untouched pack still mounts, so the failures above come from the corruption.
+    TEST_CHECK(mount_corrupted(am, data, size, 0, data, 0) == true);
+
+    asset_manager_free_pack(data);
+    asset_manager_shutdown(am);
+    free(am);
+}
+
+int main(void)
+{
+    if (!jobs_init(3u))
+        return 1;
+    TEST_RUN(test_round_trip);
+    TEST_RUN(test_rejects_bad_pack);
+    jobs_shutdown();
+    return test_failures ? 1 : 0;
+}
@@ -0,0 +1,308 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "test.h"
+#include "utils/jobs.h"
+#include "managers/asset_manager/asset_manager.h"
+
+#define ASSET_COUNT 64u
+// Per priority class; far fewer than ASSET_COUNT so requests overflow the rings.
+#define RING_CAP 4u
+#define SOURCE_DIR "asset_queue_test_files"
+
+// Loads wait for the gate, so the rings fill up behind the first one.
+static volatile uint32_t g_gate;
+static volatile uint32_t g_started;
+static volatile uint32_t g_loads[ASSET_COUNT];
+// Assets with this id fail to initialise; ASSET_COUNT disables it.
+static uint32_t g_fail_id = ASSET_COUNT;
+
+static void source_path(char *out, size_t cap, uint32_t id)
+{
+    snprintf(out, cap, SOURCE_DIR "/mat_%u", id);
+}
+
+static bool source_files(bool create)
+{
+    if (create)
+    {
+#if defined(_WIN32)
+        _mkdir(SOURCE_DIR);
+#else
+        mkdir(SOURCE_DIR, 0755);
+#endif
+    }
+
+    bool ok = true;
+    char path[64];
+    for (uint32_t i = 0; i < ASSET_COUNT; ++i)
+    {
+        source_path(path, sizeof(path), i);
+        if (!create)
+        {
+            remove(path);
+            continue;
+        }
+        FILE *f = fopen(path, "wb");
+        ok &= f != NULL;
+        if (f)
+            fclose(f);
+    }
+
+    if (!create)
+    {
+#if defined(_WIN32)
+        _rmdir(SOURCE_DIR);
+#else
+        rmdir(SOURCE_DIR);
+#endif
+    }
+    return ok;
+}
+
+static bool test_can_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr)
+{
+    (void)am;
+    return !path_is_ptr && strncmp(path, SOURCE_DIR "/", sizeof(SOURCE_DIR)) == 0;
+}
+
+static bool test_load(asset_manager_t *am, const char *path, uint32_t path_is_ptr, asset_any_t *out, ihandle_t *out_handle)
+{
+    (void)am;
+    (void)path_is_ptr;
+    (void)out_handle;
+
+    atomic_add_u32(&g_started, 1u);
+    while (!atomic_load_u32(&g_gate))
+        threads_yield();
+
+    const uint32_t id = (uint32_t)strtoul(path + sizeof(SOURCE_DIR "/mat_") - 1u, NULL, 10);
+    if (id >= ASSET_COUNT)
+        return false;
+    atomic_add_u32(&g_loads[id], 1u);
+
+    memset(&out->as.material, 0, sizeof(out->as.material));
+    out->type = ASSET_MATERIAL;
+    out->state = ASSET_STATE_LOADING;
+    out->as.material.height_steps = (int)id;
+    return true;
+}
+
+static bool test_init(asset_manager_t *am, asset_any_t *asset)
+{
+    (void)am;
+    return asset->type == ASSET_MATERIAL && (uint32_t)asset->as.material.height_steps != g_fail_id;
+}
+
+static bool manager_init(asset_manager_t *am)
+{
+    atomic_store_u32(&g_gate, 0u);
+    atomic_store_u32(&g_started, 0u);
+    g_fail_id = ASSET_COUNT;
+    for (uint32_t i = 0; i < ASSET_COUNT; ++i)
+        atomic_store_u32(&g_loads[i], 0u);
+
+    asset_manager_desc_t desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.worker_count = 1u;
+    desc.max_inflight_jobs = RING_CAP;
+    desc.handle_type = iHANDLE_TYPE_ASSET;
+    desc.pump_per_frame = 1024u;
+    if (!asset_manager_init(am, &desc))
+        return false;
+
+    asset_module_desc_t m;
+    memset(&m, 0, sizeof(m));
+    m.type = ASSET_MATERIAL;
+    m.name = "TEST_QUEUE_MATERIAL";
+    m.load_fn = test_load;
+    m.init_fn = test_init;
+    m.can_load_fn = test_can_load;
+    return asset_manager_register_module(am, m);
+}
+
+static ihandle_t request(asset_manager_t *am, uint32_t id, asset_priority_t priority)
+{
+    char path[64];
+    source_path(path, sizeof(path), id);
+    return asset_manager_request_ex(am, ASSET_MATERIAL, path, priority);
+}
+
+static uint32_t ring_entries(asset_manager_t *am)
+{
+    uint32_t n = 0;
+    for (uint32_t p = 0; p < ASSET_PRIORITY_COUNT; ++p)
+        n += asset_ring_count(&am->jobs[p]);
+    return n;
+}
+
+static void wait_started(uint32_t n)
+{
+    for (uint32_t spin = 0; spin < 1000000u && atomic_load_u32(&g_started) < n; ++spin)
+        threads_yield();
+}
+
+// Opens the gate and pumps until every requested asset is published.
+static bool finish(asset_manager_t *am, const ihandle_t *handles, uint32_t count)
+{
+    atomic_store_u32(&g_gate, 1u);
+    for (uint32_t spin = 0; spin < 100000u && !all_loaded(am); ++spin)
+    {
+        asset_manager_pump(am, 1024u);
+        threads_yield();
+    }
+    asset_manager_pump(am, 1024u);
+
+    bool ok = all_loaded(am) != 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const asset_any_t *a = asset_manager_get_any(am, handles[i]);
+        ok &= a && a->type == ASSET_MATERIAL && a->as.material.height_steps == (int)i;
+        ok &= atomic_load_u32(&g_loads[i]) == 1u;
+    }
+    return ok;
+}
+
+static void test_full_ring_defers(void)
+{
+    asset_manager_t am;
+    TEST_CHECK(manager_init(&am));
+
+    ihandle_t handles[ASSET_COUNT];
+    for (uint32_t i = 0; i < ASSET_COUNT; ++i)
+    {
+        handles[i] = request(&am, i, ASSET_PRIORITY_NORMAL);
+        TEST_CHECK(ihandle_is_valid(handles[i]));
+    }
+
+    // The overflow waits in LOADING instead of failing.
+    asset_manager_stats_t st;
+    TEST_CHECK(asset_manager_get_stats(&am, &st));
+    TEST_CHECK(st.jobs_deferred > 0u && st.jobs_deferred < ASSET_COUNT);
+    TEST_CHECK(ring_entries(&am) <= RING_CAP);
+
+    // Raising a deferred load moves it into another class right away.
+    TEST_CHECK(asset_manager_set_priority(&am, handles[ASSET_COUNT - 1u], ASSET_PRIORITY_VISIBLE));
+
+    TEST_CHECK(finish(&am, handles, ASSET_COUNT));
+    TEST_CHECK(asset_manager_get_stats(&am, &st));
+    TEST_CHECK(st.jobs_deferred == 0u && st.jobs_stale == 0u && st.jobs_pending == 0u);
+    asset_manager_shutdown(&am);
+}
+
+static void test_requeue_reuses_entries(void)
+{
+    asset_manager_t am;
+    TEST_CHECK(manager_init(&am));
+
+    // The first load holds the only loader; the others stay queued.
+    ihandle_t handles[4];
+    handles[0] = request(&am, 0u, ASSET_PRIORITY_NORMAL);
+    wait_started(1u);
+    for (uint32_t i = 1; i < 4u; ++i)
+        handles[i] = request(&am, i, ASSET_PRIORITY_BACKGROUND);
+    TEST_CHECK(ring_entries(&am) == 3u);
+
+    // Moving back and forth reuses the entry already in each ring instead of adding one per move.
+    for (uint32_t k = 0; k < 100u; ++k)
+    {
+        TEST_CHECK(asset_manager_set_priority(&am, handles[1], ASSET_PRIORITY_VISIBLE));
+        TEST_CHECK(asset_manager_set_priority(&am, handles[1], ASSET_PRIORITY_BACKGROUND));
+    }
+    TEST_CHECK(ring_entries(&am) == 4u);
+    TEST_CHECK(!asset_manager_set_priority(&am, handles[1], ASSET_PRIORITY_BACKGROUND));
+
+    // A touch raises to VISIBLE through the entry that is already there.
+    asset_manager_touch(&am, handles[1]);
+    TEST_CHECK(ring_entries(&am) == 4u);
+    // A request at a lower class than the queued one changes nothing.
+    TEST_CHECK(ihandle_eq(request(&am, 1u, ASSET_PRIORITY_PREFETCH), handles[1]));
+    TEST_CHECK(ring_entries(&am) == 4u);
+
+    asset_manager_stats_t st;
+    TEST_CHECK(asset_manager_get_stats(&am, &st));
+    TEST_CHECK(st.jobs_requeued_total == 201u);
+    TEST_CHECK(atomic_load_u32(&am.jobs_stale) == 1u);
+
+    // Cancelled loads leave a stale entry behind; a new request queues a fresh one.
+    TEST_CHECK(asset_manager_cancel(&am, handles[2]));
+    TEST_CHECK(atomic_load_u32(&am.jobs_stale) == 2u);
+    TEST_CHECK(ihandle_eq(request(&am, 2u, ASSET_PRIORITY_NORMAL), handles[2]));
+
+    TEST_CHECK(finish(&am, handles, 4u));
+    TEST_CHECK(atomic_load_u32(&am.jobs_stale) == 0u && ring_entries(&am) == 0u);
+    asset_manager_shutdown(&am);
+}
+
+static void test_dependency_failure(void)
+{
+    asset_manager_t am;
+    TEST_CHECK(manager_init(&am));
+    g_fail_id = 2u;
+
+    // 0 -> 1 -> 2, where 2 fails to load; 3 hangs off 0 and loads fine.
+    ihandle_t handles[4];
+    for (uint32_t i = 0; i < 4u; ++i)
+        handles[i] = request(&am, i, ASSET_PRIORITY_NORMAL);
+    TEST_CHECK(asset_manager_add_dependency(&am, handles[0], handles[1]));
+    TEST_CHECK(asset_manager_add_dependency(&am, handles[1], handles[2]));
+    TEST_CHECK(asset_manager_add_dependency(&am, handles[0], handles[3]));
+    TEST_CHECK(asset_manager_closure_state(&am, handles[0]) == ASSET_STATE_LOADING);
+
+    // Edges back into the closure are refused.
+    TEST_CHECK(!asset_manager_add_dependency(&am, handles[2], handles[0]));
+    TEST_CHECK(!asset_manager_add_dependency(&am, handles[1], handles[0]));
+    TEST_CHECK(!asset_manager_add_dependency(&am, handles[0], handles[0]));
+
+    atomic_store_u32(&g_gate, 1u);
+    for (uint32_t spin = 0; spin < 100000u && !all_loaded(&am); ++spin)
+    {
+        asset_manager_pump(&am, 1024u);
+        threads_yield();
+    }
+    asset_manager_pump(&am, 1024u);
+    TEST_CHECK(all_loaded(&am));
+
+    // The parents are READY themselves, but their closures are not.
+    TEST_CHECK(asset_manager_get_any(&am, handles[0]) != NULL);
+    TEST_CHECK(!asset_manager_closure_ready(&am, handles[0]));
+    TEST_CHECK(!asset_manager_closure_ready(&am, handles[1]));
+    TEST_CHECK(asset_manager_closure_state(&am, handles[0]) == ASSET_STATE_FAILED);
+    TEST_CHECK(asset_manager_closure_state(&am, handles[1]) == ASSET_STATE_FAILED);
+    TEST_CHECK(asset_manager_closure_state(&am, handles[2]) == ASSET_STATE_FAILED);
+    TEST_CHECK(asset_manager_closure_ready(&am, handles[3]));
+    TEST_CHECK(asset_manager_closure_state(&am, handles[3]) == ASSET_STATE_READY);
+
+    // A new parent of a failed closure starts out failed.
+    ihandle_t late = request(&am, 4u, ASSET_PRIORITY_NORMAL);
+    TEST_CHECK(asset_manager_add_dependency(&am, late, handles[1]));
+    TEST_CHECK(asset_manager_closure_state(&am, late) == ASSET_STATE_FAILED);
+    asset_manager_shutdown(&am);
+}
+
+int main(void)
+{
+    if (!jobs_init(3u))
+        return 1;
+    if (!source_files(true))
+    {
+        source_files(false);
+        jobs_shutdown();
+        return 1;
+    }
+    TEST_RUN(test_full_ring_defers);
+    TEST_RUN(test_requeue_reuses_entries);
+    TEST_RUN(test_dependency_failure);
+    source_files(false);
+    jobs_shutdown();
+    return test_failures ? 1 : 0;
+}
@@ -0,0 +1,461 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "utils/threads.h"
+#include "managers/asset_manager/asset_staging.h"
+
+// Stand-in for the GL backend: the buffer is plain memory and fence n signals once the test says
+// so (or when someone blocks on it, like a GPU that eventually finishes).
+typedef struct fake_gpu_t
+{
+    uint32_t buffers_live;
+    uint32_t fences_issued;
+    uint32_t fences_signalled;
+    uint32_t fences_live;
+    uint32_t blocking_waits;
+    bool fail_fences;
+} fake_gpu_t;
+
+static void *fake_create(void *user, uint64_t size, uint32_t *out_buffer)
+{
+    fake_gpu_t *g = (fake_gpu_t *)user;
+    g->buffers_live++;
+    *out_buffer = 1u;
+    return malloc((size_t)size);
+}
+
+static void fake_destroy(void *user, uint32_t buffer)
+{
+    fake_gpu_t *g = (fake_gpu_t *)user;
+    TEST_CHECK(buffer == 1u);
+    g->buffers_live--;
+}
+
+static void *fake_fence(void *user)
+{
+    fake_gpu_t *g = (fake_gpu_t *)user;
+    if (g->fail_fences)
+        return NULL;
+    g->fences_live++;
+    return (void *)(uintptr_t)++g->fences_issued;
+}
+
+static bool fake_fence_wait(void *user, void *fence, uint64_t timeout_ns)
+{
+    fake_gpu_t *g = (fake_gpu_t *)user;
+    const uint32_t n = (uint32_t)(uintptr_t)fence;
+    if (timeout_ns == UINT64_MAX)
+    {
+        g->blocking_waits++;
+        if (g->fences_signalled < n)
+            g->fences_signalled = n;
+    }
+    return n <= g->fences_signalled;
+}
+
+static void fake_fence_free(void *user, void *fence)
+{
+    fake_gpu_t *g = (fake_gpu_t *)user;
+    (void)fence;
+    g->fences_live--;
+}
+
+// The buffer memory is freed here rather than in destroy_fn, which only sees the buffer name.
+static bool staging_open(asset_staging_t *s, fake_gpu_t *g, uint64_t size, uint32_t max_regions)
+{
+    memset(g, 0, sizeof(*g));
+    asset_staging_backend_t b;
+    memset(&b, 0, sizeof(b));
+    b.user = g;
+    b.create_fn = fake_create;
+    b.destroy_fn = fake_destroy;
+    b.fence_fn = fake_fence;
+    b.fence_wait_fn = fake_fence_wait;
+    b.fence_free_fn = fake_fence_free;
+    return asset_staging_init(s, size, max_regions, &b);
+}
+
+static void staging_close(asset_staging_t *s)
+{
+    uint8_t *mem = s->base;
+    asset_staging_shutdown(s);
+    free(mem);
+}
+
+static uint64_t staging_used(asset_staging_t *s)
+{
+    uint64_t used = 0;
+    asset_staging_usage(s, &used, NULL);
+    return used;
+}
+
+// Release, fence and let the fake GPU finish, then reclaim.
+static void staging_flush(asset_staging_t *s, fake_gpu_t *g)
+{
+    asset_staging_fence(s);
+    g->fences_signalled = g->fences_issued;
+    asset_staging_retire(s);
+}
+
+static void test_init(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+
+    TEST_CHECK(staging_open(&s, &g, 1000, 5));
+    TEST_CHECK(s.size == 768);
+    TEST_CHECK(s.region_mask == 7u);
+    TEST_CHECK(g.buffers_live == 1u);
+    staging_close(&s);
+    TEST_CHECK(g.buffers_live == 0u);
+
+    TEST_CHECK(!staging_open(&s, &g, 255, 4));
+    TEST_CHECK(g.buffers_live == 0u);
+
+    asset_staging_backend_t b;
+    memset(&b, 0, sizeof(b));
+    b.create_fn = fake_create;
+    b.user = &g;
+    TEST_CHECK(!asset_staging_init(&s, 4096, 4, &b));
+    TEST_CHECK(!asset_staging_init(&s, 4096, 4, NULL));
+}
+
+static void test_alloc_alignment(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 4096, 16));
+
+    asset_staging_alloc_t a, b, c;
+    TEST_CHECK(asset_staging_alloc(&s, 1, 16u, &a));
+    TEST_CHECK(a.id != 0 && a.offset == 0 && a.ptr == s.base);
+    TEST_CHECK(asset_staging_alloc(&s, 8, 64u, &b));
+    TEST_CHECK(b.offset == 64);
+    // Alignments that are not a power of two fall back to 16.
+    TEST_CHECK(asset_staging_alloc(&s, 8, 3u, &c));
+    TEST_CHECK(c.offset == 80);
+    TEST_CHECK(b.id > a.id && c.id > b.id);
+
+    uint64_t off = 0;
+    TEST_CHECK(asset_staging_offset_of(&s, (uint8_t *)b.ptr + 5, &off) && off == 69);
+    TEST_CHECK(!asset_staging_offset_of(&s, s.base + s.size, &off));
+    TEST_CHECK(!asset_staging_offset_of(&s, &off, &off));
+
+    TEST_CHECK(!asset_staging_alloc(&s, 0, 16u, &a) && a.id == 0 && a.ptr == NULL);
+    TEST_CHECK(!asset_staging_alloc(&s, 4097, 16u, &a));
+
+    staging_close(&s);
+}
+
+static void test_full_ring(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 1024, 16));
+
+    asset_staging_alloc_t a, b;
+    TEST_CHECK(asset_staging_alloc(&s, 1024, 16u, &a));
+    TEST_CHECK(!asset_staging_alloc(&s, 16, 16u, &b));
+
+    uint64_t used = 0, failures = 0;
+    asset_staging_usage(&s, &used, &failures);
+    TEST_CHECK(used == 1024 && failures == 1);
+
+    // Released but not fenced, then fenced but not signalled: still in use.
+    asset_staging_release(&s, a.id);
+    asset_staging_retire(&s);
+    TEST_CHECK(staging_used(&s) == 1024);
+    asset_staging_fence(&s);
+    asset_staging_retire(&s);
+    TEST_CHECK(g.fences_issued == 1 && staging_used(&s) == 1024);
+    TEST_CHECK(!asset_staging_alloc(&s, 16, 16u, &b));
+
+    g.fences_signalled = 1;
+    asset_staging_retire(&s);
+    TEST_CHECK(staging_used(&s) == 0);
+    TEST_CHECK(g.fences_live == 0);
+    TEST_CHECK(asset_staging_alloc(&s, 16, 16u, &b));
+
+    staging_close(&s);
+}
+
+static void test_in_order_reclaim(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 1024, 16));
+
+    asset_staging_alloc_t a, b, c;
+    TEST_CHECK(asset_staging_alloc(&s, 256, 16u, &a));
+    TEST_CHECK(asset_staging_alloc(&s, 256, 16u, &b));
+    TEST_CHECK(asset_staging_alloc(&s, 256, 16u, &c));
+
+    // b finishes first but sits behind a, which keeps the free space contiguous.
+    asset_staging_release(&s, b.id);
+    staging_flush(&s, &g);
+    TEST_CHECK(staging_used(&s) == 768);
+
+    asset_staging_release(&s, a.id);
+    asset_staging_fence(&s);
+    asset_staging_retire(&s);
+    TEST_CHECK(staging_used(&s) == 768);
+
+    g.fences_signalled = g.fences_issued;
+    asset_staging_retire(&s);
+    TEST_CHECK(staging_used(&s) == 256);
+
+    asset_staging_release(&s, c.id);
+    staging_flush(&s, &g);
+    TEST_CHECK(staging_used(&s) == 0);
+
+    staging_close(&s);
+}
+
+static void test_wrap(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 1024, 16));
+
+    asset_staging_alloc_t a, b, c;
+    TEST_CHECK(asset_staging_alloc(&s, 768, 16u, &a));
+    asset_staging_release(&s, a.id);
+    staging_flush(&s, &g);
+    TEST_CHECK(staging_used(&s) == 0);
+
+    // 512 bytes do not fit in the 256 left before the end; the region starts over at 0 and the
+    // skipped tail counts as used until the region is reclaimed.
+    TEST_CHECK(asset_staging_alloc(&s, 512, 16u, &b));
+    TEST_CHECK(b.offset == 0 && b.ptr == s.base);
+    TEST_CHECK(staging_used(&s) == 768);
+    TEST_CHECK(!asset_staging_alloc(&s, 512, 16u, &c));
+    TEST_CHECK(asset_staging_alloc(&s, 256, 16u, &c));
+    TEST_CHECK(c.offset == 512);
+
+    asset_staging_release(&s, b.id);
+    asset_staging_release(&s, c.id);
+    staging_flush(&s, &g);
+    TEST_CHECK(staging_used(&s) == 0);
+
+    staging_close(&s);
+}
+
+static void test_region_cap(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 4096, 4));
+
+    asset_staging_alloc_t r[5];
+    for (uint32_t i = 0; i < 4; ++i)
+        TEST_CHECK(asset_staging_alloc(&s, 16, 16u, &r[i]));
+    TEST_CHECK(!asset_staging_alloc(&s, 16, 16u, &r[4]));
+
+    asset_staging_release(&s, r[0].id);
+    staging_flush(&s, &g);
+    TEST_CHECK(asset_staging_alloc(&s, 16, 16u, &r[4]));
+
+    staging_close(&s);
+}
+
+static void test_release_unknown(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 4096, 16));
+
+    asset_staging_alloc_t a;
+    TEST_CHECK(asset_staging_alloc(&s, 64, 16u, &a));
+
+    // Nothing released, nothing to fence.
+    asset_staging_release(&s, 0);
+    asset_staging_release(&s, a.id + 1);
+    asset_staging_fence(&s);
+    TEST_CHECK(g.fences_issued == 0);
+
+    asset_staging_release(&s, a.id);
+    asset_staging_release(&s, a.id);
+    asset_staging_fence(&s);
+    asset_staging_fence(&s);
+    TEST_CHECK(g.fences_issued == 1);
+
+    staging_close(&s);
+}
+
+static void test_fence_failures(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 4096, 16));
+
+    asset_staging_alloc_t a;
+    TEST_CHECK(asset_staging_alloc(&s, 64, 16u, &a));
+    asset_staging_release(&s, a.id);
+
+    // A failed fence leaves the region waiting for the next one.
+    g.fail_fences = true;
+    staging_flush(&s, &g);
+    TEST_CHECK(staging_used(&s) == 64);
+
+    g.fail_fences = false;
+    staging_flush(&s, &g);
+    TEST_CHECK(staging_used(&s) == 0);
+
+    staging_close(&s);
+}
+
+static void test_fence_table_full(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 1u << 20, 256));
+
+    asset_staging_alloc_t a;
+    for (uint32_t i = 0; i < ASSET_STAGING_MAX_FENCES + 1u; ++i)
+    {
+        TEST_CHECK(asset_staging_alloc(&s, 64, 16u, &a));
+        asset_staging_release(&s, a.id);
+        asset_staging_fence(&s);
+    }
+    TEST_CHECK(g.fences_issued == ASSET_STAGING_MAX_FENCES);
+    TEST_CHECK(s.fence_count == ASSET_STAGING_MAX_FENCES);
+
+    // Retiring part of the table makes room; the region that missed out is fenced next time.
+    g.fences_signalled = 10;
+    asset_staging_retire(&s);
+    TEST_CHECK(s.fence_count == ASSET_STAGING_MAX_FENCES - 10u);
+    TEST_CHECK(staging_used(&s) == 64ull * (ASSET_STAGING_MAX_FENCES + 1u - 10u));
+
+    staging_flush(&s, &g);
+    TEST_CHECK(g.fences_issued == ASSET_STAGING_MAX_FENCES + 1u);
+    TEST_CHECK(staging_used(&s) == 0);
+    TEST_CHECK(g.fences_live == 0);
+
+    staging_close(&s);
+}
+
+static void test_shutdown_waits(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 4096, 16));
+
+    asset_staging_alloc_t a;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        TEST_CHECK(asset_staging_alloc(&s, 64, 16u, &a));
+        asset_staging_release(&s, a.id);
+        asset_staging_fence(&s);
+    }
+    TEST_CHECK(g.fences_live == 3);
+
+    staging_close(&s);
+    TEST_CHECK(g.blocking_waits == 3);
+    TEST_CHECK(g.fences_live == 0);
+    TEST_CHECK(g.buffers_live == 0);
+
+    // Calls after shutdown are no-ops.
+    TEST_CHECK(!asset_staging_alloc(&s, 64, 16u, &a));
+    asset_staging_release(&s, 1);
+    asset_staging_fence(&s);
+    asset_staging_retire(&s);
+    TEST_CHECK(staging_used(&s) == 0);
+}
+
+#define WRITERS 4u
+#define WRITES_PER_THREAD 20000u
+
+typedef struct writer_t
+{
+    asset_staging_t *s;
+    volatile uint32_t *done;
+    uint32_t index;
+    uint32_t overlaps;
+    uint32_t allocs;
+} writer_t;
+
+// Fills each region with its own byte and checks nobody else wrote into it before releasing.
+static void writer_thread(void *arg)
+{
+    writer_t *w = (writer_t *)arg;
+    for (uint32_t i = 0; i < WRITES_PER_THREAD; ++i)
+    {
+        const uint64_t size = 16u + ((i * 7u + w->index * 13u) % 200u);
+        const uint8_t tag = (uint8_t)(w->index * 64u + (i & 63u));
+        asset_staging_alloc_t a;
+        if (!asset_staging_alloc(w->s, size, 16u, &a))
+        {
+            threads_yield();
+            continue;
+        }
+        w->allocs++;
+        memset(a.ptr, tag, (size_t)size);
+        threads_yield();
+        for (uint64_t k = 0; k < size; ++k)
+        {
+            if (((const uint8_t *)a.ptr)[k] != tag)
+            {
+                w->overlaps++;
+                break;
+            }
+        }
+        asset_staging_release(w->s, a.id);
+    }
+    atomic_add_u32(w->done, 1u);
+}
+
+static void test_threaded_writers(void)
+{
+    asset_staging_t s;
+    fake_gpu_t g;
+    TEST_CHECK(staging_open(&s, &g, 16384, 64));
+
+    volatile uint32_t done = 0;
+    writer_t writers[WRITERS];
+    thread_t threads[WRITERS];
+    for (uint32_t i = 0; i < WRITERS; ++i)
+    {
+        writers[i] = (writer_t){&s, &done, i, 0, 0};
+        TEST_CHECK(threads_thread_create(&threads[i], writer_thread, &writers[i]));
+    }
+
+    // The render thread's side: fence and retire while the writers run.
+    while (atomic_load_u32(&done) < WRITERS)
+    {
+        staging_flush(&s, &g);
+        threads_yield();
+    }
+    for (uint32_t i = 0; i < WRITERS; ++i)
+        threads_thread_join(&threads[i]);
+
+    staging_flush(&s, &g);
+    uint32_t allocs = 0;
+    for (uint32_t i = 0; i < WRITERS; ++i)
+    {
+        TEST_CHECK(writers[i].overlaps == 0);
+        allocs += writers[i].allocs;
+    }
+    TEST_CHECK(allocs > 0);
+    TEST_CHECK(staging_used(&s) == 0);
+
+    staging_close(&s);
+}
+
+int main(void)
+{
+    TEST_RUN(test_init);
+    TEST_RUN(test_alloc_alignment);
+    TEST_RUN(test_full_ring);
+    TEST_RUN(test_in_order_reclaim);
+    TEST_RUN(test_wrap);
+    TEST_RUN(test_region_cap);
+    TEST_RUN(test_release_unknown);
+    TEST_RUN(test_fence_failures);
+    TEST_RUN(test_fence_table_full);
+    TEST_RUN(test_shutdown_waits);
+    TEST_RUN(test_threaded_writers);
+    return test_failures ? 1 : 0;
+}
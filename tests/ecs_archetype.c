@@ -0,0 +1,327 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "utils/jobs.h"
+#include "core/systems/ecs/ecs.h"
+#include "core/systems/ecs/view.h"
+#include "core/systems/ecs/serialize.h"
+#include "core/systems/ecs/components/c_mesh_renderer.h"
+
+#define ENTITIES 2000u
+
+typedef struct t_pos_t
+{
+    uint32_t id;
+    float x;
+    base_component_t base;
+} t_pos_t;
+
+typedef struct t_vel_t
+{
+    uint32_t id;
+    float dx;
+    base_component_t base;
+} t_vel_t;
+
+// Large enough that a chunk holds only a handful of rows, so migrations cross chunk boundaries.
+typedef struct t_big_t
+{
+    uint32_t id;
+    uint8_t payload[2000];
+    base_component_t base;
+} t_big_t;
+
+typedef struct test_world_t
+{
+    ecs_world_t w;
+    ecs_component_id_t pos;
+    ecs_component_id_t vel;
+    ecs_component_id_t big;
+    ecs_entity_t e[ENTITIES];
+} test_world_t;
+
+static void world_open(test_world_t *t)
+{
+    ecs_world_init(&t->w, (ecs_world_desc_t){.storage = ECS_STORAGE_ARCHETYPE});
+    t->pos = ecs_register_component_type(&t->w, "t_pos_t", sizeof(t_pos_t), offsetof(t_pos_t, base), NULL, NULL, NULL);
+    t->vel = ecs_register_component_type(&t->w, "t_vel_t", sizeof(t_vel_t), offsetof(t_vel_t, base), NULL, NULL, NULL);
+    t->big = ecs_register_component_type(&t->w, "t_big_t", sizeof(t_big_t), offsetof(t_big_t, base), NULL, NULL, NULL);
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+        t->e[i] = ecs_entity_create(&t->w);
+}
+
+static bool pos_ok(test_world_t *t, uint32_t i)
+{
+    const t_pos_t *p = (const t_pos_t *)ecs_get_raw(&t->w, t->e[i], t->pos);
+    return p && p->id == i && p->x == (float)i && p->base.entity == t->e[i];
+}
+
+static bool vel_ok(test_world_t *t, uint32_t i)
+{
+    const t_vel_t *v = (const t_vel_t *)ecs_get_raw(&t->w, t->e[i], t->vel);
+    return v && v->id == i && v->dx == -(float)i && v->base.entity == t->e[i];
+}
+
+static void add_pos(test_world_t *t, uint32_t i)
+{
+    t_pos_t *p = (t_pos_t *)ecs_add_raw(&t->w, t->e[i], t->pos);
+    TEST_CHECK(p && p->id == 0);
+    if (p)
+    {
+        p->id = i;
+        p->x = (float)i;
+    }
+}
+
+static void add_vel(test_world_t *t, uint32_t i)
+{
+    t_vel_t *v = (t_vel_t *)ecs_add_raw(&t->w, t->e[i], t->vel);
+    TEST_CHECK(v != NULL);
+    if (v)
+    {
+        v->id = i;
+        v->dx = -(float)i;
+    }
+}
+
+static void test_add_get_remove(void)
+{
+    test_world_t *t = (test_world_t *)calloc(1, sizeof(test_world_t));
+    world_open(t);
+
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+        add_pos(t, i);
+    TEST_CHECK(ecs_count_raw(&t->w, t->pos) == ENTITIES);
+
+    // Adding again returns the existing component untouched.
+    const t_pos_t *again = (const t_pos_t *)ecs_add_raw(&t->w, t->e[7], t->pos);
+    TEST_CHECK(again && again->id == 7u);
+
+    bool all = true;
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+        all &= pos_ok(t, i) && !ecs_has_raw(&t->w, t->e[i], t->vel);
+    TEST_CHECK(all);
+
+    for (uint32_t i = 0; i < ENTITIES; i += 3u)
+        TEST_CHECK(ecs_remove_raw(&t->w, t->e[i], t->pos));
+    TEST_CHECK(!ecs_remove_raw(&t->w, t->e[0], t->pos));
+    TEST_CHECK(!ecs_remove_raw(&t->w, t->e[1], t->vel));
+
+    // Swap-removal moves the last rows into the holes; every survivor keeps its own data.
+    all = true;
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+    {
+        if (i % 3u == 0u)
+            all &= ecs_get_raw(&t->w, t->e[i], t->pos) == NULL;
+        else
+        {
+            all &= pos_ok(t, i);
+            expected++;
+        }
+    }
+    TEST_CHECK(all);
+    TEST_CHECK(ecs_count_raw(&t->w, t->pos) == expected);
+
+    ecs_world_destroy(&t->w);
+    free(t);
+}
+
+static void test_migrate(void)
+{
+    test_world_t *t = (test_world_t *)calloc(1, sizeof(test_world_t));
+    world_open(t);
+
+    // {pos} -> {pos, vel} -> {pos, vel, big} -> {vel, big} for different subsets.
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+        add_pos(t, i);
+    for (uint32_t i = 0; i < ENTITIES; i += 2u)
+        add_vel(t, i);
+    for (uint32_t i = 0; i < ENTITIES; i += 4u)
+    {
+        t_big_t *b = (t_big_t *)ecs_add_raw(&t->w, t->e[i], t->big);
+        TEST_CHECK(b != NULL);
+        if (b)
+        {
+            b->id = i;
+            memset(b->payload, (int)(i & 0xFFu), sizeof(b->payload));
+        }
+    }
+    for (uint32_t i = 0; i < ENTITIES; i += 8u)
+        TEST_CHECK(ecs_remove_raw(&t->w, t->e[i], t->pos));
+
+    bool all = true;
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+    {
+        const bool has_pos = i % 8u != 0u;
+        const bool has_vel = i % 2u == 0u;
+        const bool has_big = i % 4u == 0u;
+        all &= has_pos ? pos_ok(t, i) : !ecs_has_raw(&t->w, t->e[i], t->pos);
+        all &= has_vel ? vel_ok(t, i) : !ecs_has_raw(&t->w, t->e[i], t->vel);
+        const t_big_t *b = (const t_big_t *)ecs_get_raw(&t->w, t->e[i], t->big);
+        if (has_big)
+            all &= b && b->id == i && b->payload[0] == (uint8_t)i && b->payload[sizeof(b->payload) - 1u] == (uint8_t)i;
+        else
+            all &= b == NULL;
+    }
+    TEST_CHECK(all);
+    TEST_CHECK(ecs_count_raw(&t->w, t->vel) == ENTITIES / 2u);
+    TEST_CHECK(ecs_count_raw(&t->w, t->big) == ENTITIES / 4u);
+
+    // Destroying entities takes them out of every archetype.
+    for (uint32_t i = 0; i < ENTITIES; i += 5u)
+        ecs_entity_destroy(&t->w, t->e[i]);
+    all = true;
+    for (uint32_t i = 1; i < ENTITIES; ++i)
+        if (i % 5u != 0u && i % 2u == 0u)
+            all &= vel_ok(t, i);
+    TEST_CHECK(all);
+
+    ecs_world_destroy(&t->w);
+    free(t);
+}
+
+typedef struct iterate_ctx_t
+{
+    ecs_component_id_t pos;
+    uint32_t *seen;
+} iterate_ctx_t;
+
+static void iterate_chunk(ecs_view_t *chunk, uint32_t chunk_index, uint32_t worker_index, void *user)
+{
+    (void)chunk_index;
+    (void)worker_index;
+    iterate_ctx_t *ctx = (iterate_ctx_t *)user;
+    ecs_entity_t e;
+    void *c[2];
+    while (ecs_view_next(chunk, &e, c))
+    {
+        const t_pos_t *p = (const t_pos_t *)c[0];
+        if (p->id < ENTITIES && p->base.entity == e)
+            atomic_add_u32(&ctx->seen[p->id], 1u);
+    }
+}
+
+static void test_iterate(void)
+{
+    test_world_t *t = (test_world_t *)calloc(1, sizeof(test_world_t));
+    world_open(t);
+
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+    {
+        add_pos(t, i);
+        if (i % 3u != 1u)
+            add_vel(t, i);
+        if (i % 7u == 0u)
+            TEST_CHECK(ecs_add_raw(&t->w, t->e[i], t->big) != NULL);
+    }
+
+    // The view spans the {pos, vel} and {pos, vel, big} archetypes and skips {pos} and {pos, big}.
+    ecs_view_t v;
+    TEST_CHECK(ECS_VIEW2(&v, &t->w, t->pos, t->vel));
+    uint32_t *seen = (uint32_t *)calloc(ENTITIES, sizeof(uint32_t));
+    ecs_entity_t e;
+    void *c[2];
+    bool match = true;
+    while (ecs_view_next(&v, &e, c))
+    {
+        const t_pos_t *p = (const t_pos_t *)c[0];
+        const t_vel_t *d = (const t_vel_t *)c[1];
+        match &= p->id == d->id && p->base.entity == e && d->base.entity == e;
+        if (p->id < ENTITIES)
+            seen[p->id]++;
+    }
+    TEST_CHECK(match);
+    bool once = true;
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+        once &= seen[i] == (i % 3u != 1u ? 1u : 0u);
+    TEST_CHECK(once);
+
+    // Split into sub-views and run them on the pool: each row still comes up exactly once.
+    memset(seen, 0, ENTITIES * sizeof(uint32_t));
+    iterate_ctx_t ctx = {t->pos, seen};
+    ecs_view_reset(&v);
+    ecs_view_parallel_for(&v, 64u, iterate_chunk, &ctx);
+    once = true;
+    for (uint32_t i = 0; i < ENTITIES; ++i)
+        once &= seen[i] == (i % 3u != 1u ? 1u : 0u);
+    TEST_CHECK(once);
+
+    free(seen);
+    ecs_world_destroy(&t->w);
+    free(t);
+}
+
+static const c_mesh_renderer_t *mesh_renderer_of(ecs_world_t *w, ecs_entity_t e)
+{
+    return (const c_mesh_renderer_t *)ecs_get_raw(w, e, ecs_component_id(w, c_mesh_renderer_t));
+}
+
+static void test_scene_mesh_renderer(void)
+{
+    ecs_world_t w;
+    ecs_world_init(&w, (ecs_world_desc_t){.storage = ECS_STORAGE_ARCHETYPE});
+    c_mesh_renderer_register(&w);
+
+    // An index and generation past 16 bits only survive the explicit record.
+    const ihandle_t model = ihandle_with_meta(ihandle_make(5u, 70000u, 0x12345u), 2u);
+    ecs_entity_t e = ecs_entity_create(&w);
+    c_mesh_renderer_t *mr = (c_mesh_renderer_t *)ecs_add_raw(&w, e, ecs_component_id(&w, c_mesh_renderer_t));
+    TEST_CHECK(mr != NULL);
+    if (mr)
+        mr->model = model;
+
+    vector_t bytes;
+    TEST_CHECK(ecs_scene_save_to_memory(&w, &bytes));
+    ecs_world_destroy(&w);
+
+    ecs_world_init(&w, (ecs_world_desc_t){.storage = ECS_STORAGE_ARCHETYPE});
+    c_mesh_renderer_register(&w);
+    TEST_CHECK(ecs_scene_load_from_memory(&w, (const uint8_t *)bytes.data, bytes.size));
+    mr = (c_mesh_renderer_t *)mesh_renderer_of(&w, e);
+    TEST_CHECK(mr && ihandle_eq(mr->model, model));
+    vector_free(&bytes);
+
+    // A scene saved while ihandle_t was 8 bytes: one entity, one raw c_mesh_renderer_t record.
+    static const char name[] = "c_mesh_renderer_t";
+    const uint32_t head[] = {0x314E4353u, 1u, 0u, 1u, 0u, 1u, 1u};
+    const uint16_t name_len = (uint16_t)(sizeof(name) - 1u);
+    const uint32_t rec_head[] = {1u, 0u, 8u};
+    const uint32_t old_value = (7u << 16) | 42u;
+    const uint16_t old_type_meta[] = {5u, 2u};
+
+    uint8_t legacy[128];
+    uint32_t n = 0;
+    memcpy(legacy + n, head, sizeof(head));
+    n += (uint32_t)sizeof(head);
+    memcpy(legacy + n, &name_len, 2);
+    n += 2u;
+    memcpy(legacy + n, name, name_len);
+    n += name_len;
+    memcpy(legacy + n, rec_head, sizeof(rec_head));
+    n += (uint32_t)sizeof(rec_head);
+    memcpy(legacy + n, &old_value, 4);
+    memcpy(legacy + n + 4u, old_type_meta, 4);
+    n += 8u;
+
+    TEST_CHECK(ecs_scene_load_from_memory(&w, legacy, n));
+    mr = (c_mesh_renderer_t *)mesh_renderer_of(&w, ecs_entity_pack(0u, 1u));
+    TEST_CHECK(mr && ihandle_eq(mr->model, ihandle_with_meta(ihandle_make(5u, 42u, 7u), 2u)));
+
+    ecs_world_destroy(&w);
+}
+
+int main(void)
+{
+    if (!jobs_init(3u))
+        return 1;
+    TEST_RUN(test_add_get_remove);
+    TEST_RUN(test_migrate);
+    TEST_RUN(test_iterate);
+    TEST_RUN(test_scene_mesh_renderer);
+    jobs_shutdown();
+    return test_failures ? 1 : 0;
+}
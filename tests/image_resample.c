@@ -0,0 +1,244 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "managers/asset_manager/loaders/image_mips.h"
+#include "managers/asset_manager/loaders/image_resample.h"
+
+static uint32_t test_rng = 12345u;
+
+static uint32_t test_rand(void)
+{
+    test_rng = test_rng * 1664525u + 1013904223u;
+    return test_rng >> 8;
+}
+
+// Odd sizes exercise the edge clamps and the 1-pixel axes; the wide ones the vector tails.
+static const uint32_t k_sizes[][2] = {
+    {1, 1}, {1, 7}, {7, 1}, {2, 2}, {3, 3}, {5, 9}, {17, 13}, {64, 64}, {101, 37}, {256, 3}, {3, 256}, {333, 129},
+};
+static const uint32_t k_channels[] = {1u, 3u, 4u};
+
+// Every ISA the CPU and build support, compared level by level against the scalar reference.
+static void test_downsample_matches_scalar(void)
+{
+    const uint32_t saved = asset_image_resample_isa();
+    uint32_t compared = 0;
+
+    for (uint32_t si = 0; si < sizeof(k_sizes) / sizeof(k_sizes[0]); ++si)
+        for (uint32_t ci = 0; ci < sizeof(k_channels) / sizeof(k_channels[0]); ++ci)
+            for (uint32_t f = 0; f < ASSET_IMAGE_MIP_FILTER_COUNT; ++f)
+                for (uint32_t flags = 0; flags <= ASSET_IMAGE_MIP_SRGB; ++flags)
+                {
+                    const uint32_t sw = k_sizes[si][0];
+                    const uint32_t sh = k_sizes[si][1];
+                    const uint32_t c = k_channels[ci];
+                    const size_t n = (size_t)sw * sh * c;
+                    const size_t dn = (size_t)(sw > 1u ? sw / 2u : 1u) * (sh > 1u ? sh / 2u : 1u) * c;
+
+                    uint8_t *s8 = (uint8_t *)malloc(n);
+                    float *sf = (float *)malloc(n * sizeof(float));
+                    uint8_t *ref8 = (uint8_t *)malloc(dn);
+                    uint8_t *o8 = (uint8_t *)malloc(dn);
+                    float *reff = (float *)malloc(dn * sizeof(float));
+                    float *of = (float *)malloc(dn * sizeof(float));
+                    if (!s8 || !sf || !ref8 || !o8 || !reff || !of)
+                    {
+                        TEST_CHECK(!"out of memory");
+                        return;
+                    }
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        s8[i] = (uint8_t)test_rand();
+                        sf[i] = (float)(test_rand() % 100000u) / 1000.0f;
+                    }
+
+                    TEST_CHECK(asset_image_resample_set_isa(ASSET_IMAGE_ISA_SCALAR));
+                    TEST_CHECK(asset_image_downsample_u8(ref8, s8, sw, sh, c, f, flags));
+                    TEST_CHECK(asset_image_downsample_f32(reff, sf, sw, sh, c, f));
+
+                    for (uint32_t isa = ASSET_IMAGE_ISA_SCALAR + 1u; isa < ASSET_IMAGE_ISA_COUNT; ++isa)
+                    {
+                        if (!asset_image_resample_set_isa(isa))
+                            continue;
+                        memset(o8, 0xCD, dn);
+                        memset(of, 0xCD, dn * sizeof(float));
+                        TEST_CHECK(asset_image_downsample_u8(o8, s8, sw, sh, c, f, flags));
+                        TEST_CHECK(asset_image_downsample_f32(of, sf, sw, sh, c, f));
+                        if (memcmp(o8, ref8, dn) != 0 || memcmp(of, reff, dn * sizeof(float)) != 0)
+                        {
+                            fprintf(stderr, "  %s differs: %ux%u c=%u filter=%u flags=%u\n",
+                                    asset_image_resample_isa_name(isa), sw, sh, c, f, flags);
+                            test_failures++;
+                        }
+                        compared++;
+                    }
+
+                    free(s8);
+                    free(sf);
+                    free(ref8);
+                    free(o8);
+                    free(reff);
+                    free(of);
+                }
+
+    asset_image_resample_set_isa(saved);
+    if (!compared)
+        printf("  no SIMD kernels in this build or CPU; scalar only\n");
+}
+
+// Whole chains go through the same kernels plus the level split across jobs.
+static void test_chain_matches_scalar(void)
+{
+    const uint32_t saved = asset_image_resample_isa();
+    const uint32_t w = 300u;
+    const uint32_t h = 170u;
+
+    for (uint32_t ci = 0; ci < sizeof(k_channels) / sizeof(k_channels[0]); ++ci)
+    {
+        const uint32_t c = k_channels[ci];
+        const size_t n = (size_t)w * h * c;
+        uint8_t *s8 = (uint8_t *)malloc(n);
+        float *sf = (float *)malloc(n * sizeof(float));
+        if (!s8 || !sf)
+        {
+            TEST_CHECK(!"out of memory");
+            free(s8);
+            free(sf);
+            return;
+        }
+        // Channels follow one brightness so the chain is not mistaken for a packed mask, which
+        // would turn the sRGB path off.
+        for (size_t i = 0; i < n; i += c)
+        {
+            const uint32_t base = test_rand();
+            for (uint32_t k = 0; k < c; ++k)
+            {
+                s8[i + k] = (uint8_t)(base ^ (test_rand() & 7u));
+                sf[i + k] = (float)(base % 100000u) / 1000.0f + (float)k;
+            }
+        }
+
+        for (uint32_t f = 0; f < ASSET_IMAGE_MIP_FILTER_COUNT; ++f)
+        {
+            asset_image_mip_chain_t *ref8 = NULL;
+            asset_image_mip_chain_t *reff = NULL;
+            TEST_CHECK(asset_image_resample_set_isa(ASSET_IMAGE_ISA_SCALAR));
+            TEST_CHECK(asset_image_mips_build_u8(&ref8, s8, w, h, c, f, ASSET_IMAGE_MIP_SRGB));
+            TEST_CHECK(asset_image_mips_build_f32(&reff, sf, w, h, c, f));
+
+            for (uint32_t isa = ASSET_IMAGE_ISA_SCALAR + 1u; isa < ASSET_IMAGE_ISA_COUNT && ref8 && reff; ++isa)
+            {
+                if (!asset_image_resample_set_isa(isa))
+                    continue;
+                asset_image_mip_chain_t *o8 = NULL;
+                asset_image_mip_chain_t *of = NULL;
+                TEST_CHECK(asset_image_mips_build_u8(&o8, s8, w, h, c, f, ASSET_IMAGE_MIP_SRGB));
+                TEST_CHECK(asset_image_mips_build_f32(&of, sf, w, h, c, f));
+                if (o8 && of)
+                {
+                    TEST_CHECK(o8->total_size == ref8->total_size && of->total_size == reff->total_size);
+                    if (o8->total_size == ref8->total_size && memcmp(o8->data, ref8->data, (size_t)ref8->total_size) != 0)
+                    {
+                        fprintf(stderr, "  %s u8 chain differs: c=%u filter=%u\n", asset_image_resample_isa_name(isa), c, f);
+                        test_failures++;
+                    }
+                    if (of->total_size == reff->total_size && memcmp(of->data, reff->data, (size_t)reff->total_size) != 0)
+                    {
+                        fprintf(stderr, "  %s f32 chain differs: c=%u filter=%u\n", asset_image_resample_isa_name(isa), c, f);
+                        test_failures++;
+                    }
+                }
+                asset_image_mips_free(o8);
+                asset_image_mips_free(of);
+            }
+            asset_image_mips_free(ref8);
+            asset_image_mips_free(reff);
+        }
+        free(s8);
+        free(sf);
+    }
+
+    asset_image_resample_set_isa(saved);
+}
+
+// Flat images stay flat in every mode; the windowed filters' weights have to sum to one exactly
+// after quantization.
+static void test_flat_round_trip(void)
+{
+    uint8_t s[16 * 16 * 4];
+    uint8_t d[8 * 8 * 4];
+    for (uint32_t v = 0; v < 256u; ++v)
+        for (uint32_t f = 0; f < ASSET_IMAGE_MIP_FILTER_COUNT; ++f)
+            for (uint32_t flags = 0; flags <= ASSET_IMAGE_MIP_SRGB; ++flags)
+            {
+                memset(s, (int)v, sizeof(s));
+                TEST_CHECK(asset_image_downsample_u8(d, s, 16, 16, 4, f, flags));
+                bool flat = true;
+                for (uint32_t i = 0; i < sizeof(d); ++i)
+                    flat &= d[i] == v;
+                TEST_CHECK(flat);
+            }
+}
+
+// Black/white checkerboard: linear light averages to 0.5, which is 188 in sRGB; alpha stays linear.
+static void test_srgb_checker(void)
+{
+    uint8_t s[4 * 4 * 4];
+    uint8_t d[2 * 2 * 4];
+    for (uint32_t i = 0; i < 16u; ++i)
+    {
+        const uint8_t v = ((i & 1u) ^ ((i / 4u) & 1u)) ? 255u : 0u;
+        memset(s + i * 4u, v, 3);
+        s[i * 4u + 3u] = v;
+    }
+
+    TEST_CHECK(asset_image_downsample_u8(d, s, 4, 4, 4, ASSET_IMAGE_MIP_FILTER_BOX, ASSET_IMAGE_MIP_SRGB));
+    TEST_CHECK(d[0] == 188u && d[3] == 128u);
+    TEST_CHECK(asset_image_downsample_u8(d, s, 4, 4, 4, ASSET_IMAGE_MIP_FILTER_BOX, 0u));
+    TEST_CHECK(d[0] == 128u && d[3] == 128u);
+}
+
+// A checker of two unit normals passes for a normal map: the chain drops sRGB unless the color
+// space was given.
+static void test_known_color_space(void)
+{
+    uint8_t s[8 * 8 * 4];
+    for (uint32_t i = 0; i < 64u; ++i)
+    {
+        const bool odd = ((i & 1u) ^ ((i / 8u) & 1u)) != 0u;
+        uint8_t *p = s + i * 4u;
+        p[0] = odd ? 255u : 128u;
+        p[1] = 128u;
+        p[2] = odd ? 128u : 255u;
+        p[3] = 255u;
+    }
+
+    uint8_t linear[4 * 4 * 4];
+    uint8_t srgb[4 * 4 * 4];
+    TEST_CHECK(asset_image_downsample_u8(linear, s, 8, 8, 4, ASSET_IMAGE_MIP_FILTER_BOX, 0u));
+    TEST_CHECK(asset_image_downsample_u8(srgb, s, 8, 8, 4, ASSET_IMAGE_MIP_FILTER_BOX, ASSET_IMAGE_MIP_SRGB));
+    TEST_CHECK(memcmp(linear, srgb, sizeof(linear)) != 0);
+
+    asset_image_mip_chain_t *guessed = NULL;
+    asset_image_mip_chain_t *known = NULL;
+    TEST_CHECK(asset_image_mips_build_u8(&guessed, s, 8, 8, 4, ASSET_IMAGE_MIP_FILTER_BOX, ASSET_IMAGE_MIP_SRGB));
+    TEST_CHECK(asset_image_mips_build_u8(&known, s, 8, 8, 4, ASSET_IMAGE_MIP_FILTER_BOX, ASSET_IMAGE_MIP_SRGB | ASSET_IMAGE_MIP_COLOR_KNOWN));
+    TEST_CHECK(guessed && memcmp(guessed->level[1], linear, sizeof(linear)) == 0);
+    TEST_CHECK(known && memcmp(known->level[1], srgb, sizeof(srgb)) == 0);
+    asset_image_mips_free(guessed);
+    asset_image_mips_free(known);
+}
+
+int main(void)
+{
+    printf("resample kernels: %s\n", asset_image_resample_isa_name(asset_image_resample_isa()));
+    TEST_RUN(test_downsample_matches_scalar);
+    TEST_RUN(test_chain_matches_scalar);
+    TEST_RUN(test_flat_round_trip);
+    TEST_RUN(test_srgb_checker);
+    TEST_RUN(test_known_color_space);
+    return test_failures ? 1 : 0;
+}
@@ -0,0 +1,362 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "utils/jobs.h"
+#include "managers/asset_manager/asset_manager.h"
+#include "managers/asset_manager/loaders/asset_image_itex.h"
+#include "managers/asset_manager/loaders/image_mips.h"
+
+#define ITEX_TEST_FILE "itex_test.itex"
+
+// On-disk layout of a version 3 file: the header ends after mip_count and every level is raw.
+#pragma pack(push, 1)
+typedef struct itex_v3_header_t
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint32_t is_float;
+    uint32_t has_alpha;
+    uint32_t has_smooth_alpha;
+    uint32_t uncompressed_size;
+    uint32_t compressed_size;
+    uint32_t handle_value;
+    uint16_t handle_type;
+    uint16_t handle_meta;
+    uint32_t codec;
+    uint32_t mip_count;
+} itex_v3_header_t;
+
+typedef struct itex_v3_mip_t
+{
+    uint32_t offset;
+    uint32_t size;
+    uint32_t codec;
+    uint32_t reserved;
+} itex_v3_mip_t;
+#pragma pack(pop)
+
+static asset_manager_t g_am;
+static asset_module_desc_t g_itex;
+
+static uint32_t test_rand(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static ihandle_t test_handle(uint32_t value)
+{
+    ihandle_t h = ihandle_invalid();
+    h.value = value;
+    h.type = iHANDLE_TYPE_ASSET;
+    h.meta = (uint16_t)ASSET_IMAGE;
+    return h;
+}
+
+static asset_any_t make_image(uint32_t w, uint32_t h, uint32_t channels, bool is_float, uint32_t seed)
+{
+    asset_any_t a;
+    memset(&a, 0, sizeof(a));
+    a.type = ASSET_IMAGE;
+    a.state = ASSET_STATE_READY;
+    a.as.image.width = w;
+    a.as.image.height = h;
+    a.as.image.channels = channels;
+    a.as.image.is_float = is_float ? 1u : 0u;
+    a.as.image.has_alpha = channels == 4u;
+
+    const size_t n = (size_t)w * h * channels;
+    if (is_float)
+    {
+        float *p = (float *)malloc(n * sizeof(float));
+        for (size_t i = 0; p && i < n; ++i)
+            p[i] = (float)(test_rand(&seed) & 0xFFFFu) / 4096.0f;
+        a.as.image.pixels = (uint8_t *)p;
+    }
+    else
+    {
+        uint8_t *p = (uint8_t *)malloc(n);
+        for (size_t i = 0; p && i < n; ++i)
+            p[i] = (uint8_t)((i / channels) % w * 3u + (test_rand(&seed) & 15u));
+        a.as.image.pixels = p;
+    }
+    return a;
+}
+
+// The chain the saver stores: the image flipped vertically, then filtered with the manager's settings.
+static asset_image_mip_chain_t *reference_chain(const asset_any_t *a)
+{
+    const asset_image_t *img = &a->as.image;
+    const size_t row = (size_t)img->width * img->channels * (img->is_float ? 4u : 1u);
+    uint8_t *flipped = (uint8_t *)malloc(row * img->height);
+    if (!flipped)
+        return NULL;
+    for (uint32_t y = 0; y < img->height; ++y)
+        memcpy(flipped + (size_t)y * row, img->pixels + (size_t)(img->height - 1u - y) * row, row);
+
+    asset_image_mip_chain_t *chain = NULL;
+    if (img->is_float)
+        asset_image_mips_build_f32(&chain, (const float *)(const void *)flipped, img->width, img->height, img->channels, asset_manager_get_image_mip_filter(&g_am));
+    else
+        asset_image_mips_build_u8(&chain, flipped, img->width, img->height, img->channels, asset_manager_get_image_mip_filter(&g_am), asset_manager_get_image_mip_flags(&g_am, img->color_space));
+    free(flipped);
+    if (chain)
+        chain->color_space = img->color_space;
+    return chain;
+}
+
+// Checks the levels in RAM after a load, then reads the sharper ones back through mip_read_fn.
+static void check_loaded(const asset_any_t *out, ihandle_t hid, ihandle_t expect_handle, const asset_image_mip_chain_t *ref, const asset_blob_t *blob)
+{
+    const asset_image_t *img = &out->as.image;
+    const asset_image_mip_chain_t *m = img->mips;
+    TEST_CHECK(out->type == ASSET_IMAGE && m != NULL);
+    if (!m)
+        return;
+    TEST_CHECK(ihandle_eq(hid, expect_handle));
+    TEST_CHECK(m->color_space == ref->color_space && img->color_space == ref->color_space);
+    TEST_CHECK(img->width == ref->width[0] && img->height == ref->height[0]);
+    TEST_CHECK(m->mip_count == ref->mip_count && img->mip_count == ref->mip_count);
+    TEST_CHECK(m->bc_format == ref->bc_format && m->bytes_per_pixel == ref->bytes_per_pixel);
+    TEST_CHECK(m->resident_first == asset_manager_image_resident_first(&g_am, ref->mip_count));
+
+    bool same = m->mip_count == ref->mip_count;
+    for (uint32_t i = m->resident_first; same && i < m->mip_count; ++i)
+        same = m->level[i] && m->size[i] == ref->size[i] && memcmp(m->level[i], ref->level[i], (size_t)ref->size[i]) == 0;
+    TEST_CHECK(same);
+
+    if (!blob || !m->resident_first)
+        return;
+
+    uint8_t *levels[ASSET_IMAGE_MAX_MIPS];
+    memset(levels, 0, sizeof(levels));
+    const uint32_t last = m->resident_first - 1u;
+    TEST_CHECK(g_itex.mip_read_fn(&g_am, ITEX_TEST_FILE, blob, m, 0u, last, levels));
+    same = true;
+    for (uint32_t i = 0; i <= last; ++i)
+    {
+        same &= levels[i] && memcmp(levels[i], ref->level[i], (size_t)ref->size[i]) == 0;
+        free(levels[i]);
+    }
+    TEST_CHECK(same);
+}
+
+static bool write_file(const char *path, const uint8_t *data, uint32_t size)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+    const bool ok = fwrite(data, 1, size, f) == size;
+    fclose(f);
+    return ok;
+}
+
+static void round_trip(const asset_any_t *a, uint8_t codec, ihandle_t h)
+{
+    asset_manager_set_pack_codec(&g_am, ASSET_IMAGE, codec);
+    asset_image_mip_chain_t *ref = reference_chain(a);
+    TEST_CHECK(ref != NULL);
+    if (!ref)
+        return;
+
+    asset_blob_t blob;
+    memset(&blob, 0, sizeof(blob));
+    TEST_CHECK(g_itex.save_blob_fn(&g_am, h, a, &blob));
+    TEST_CHECK(blob.data && blob.size > 0u && (blob.flags & ASSET_BLOB_FLAG_PRECOMPRESSED));
+
+    // Straight from the blob, as a mounted pack hands it over.
+    asset_any_t out;
+    ihandle_t hid;
+    TEST_CHECK(g_itex.load_blob_fn(&g_am, ITEX_TEST_FILE, &blob, &out, &hid));
+    check_loaded(&out, hid, h, ref, &blob);
+    g_itex.cleanup_fn(&g_am, &out);
+
+    // From a file through load_fn, which reads only the table and the resident levels.
+    TEST_CHECK(write_file(ITEX_TEST_FILE, blob.data, blob.size));
+    TEST_CHECK(g_itex.load_fn(&g_am, ITEX_TEST_FILE, 0u, &out, &hid));
+    check_loaded(&out, hid, h, ref, NULL);
+    g_itex.cleanup_fn(&g_am, &out);
+    remove(ITEX_TEST_FILE);
+
+    // A truncated blob is rejected instead of read past its end.
+    asset_blob_t cut = blob;
+    cut.size = blob.size - 1u;
+    TEST_CHECK(!g_itex.load_blob_fn(&g_am, ITEX_TEST_FILE, &cut, &out, &hid));
+
+    g_itex.blob_free_fn(&g_am, &blob);
+    asset_image_mips_free(ref);
+}
+
+static void test_v4_pixels(void)
+{
+    asset_manager_set_pack_texture_compression(&g_am, false);
+    const uint8_t codecs[] = {ASSET_CODEC_NONE, ASSET_CODEC_LZ4, ASSET_CODEC_ZSTD};
+    const uint32_t channels[] = {1u, 3u, 4u};
+    for (uint32_t c = 0; c < 3u; ++c)
+    {
+        // The header keeps the color space the chain was built for.
+        asset_any_t a = make_image(96u, 40u, channels[c], false, 7u + c);
+        a.as.image.color_space = c % ASSET_IMAGE_COLOR_SPACE_COUNT;
+        round_trip(&a, codecs[c], test_handle(0x100u + c));
+        free(a.as.image.pixels);
+    }
+
+    asset_any_t f = make_image(33u, 17u, 4u, true, 99u);
+    round_trip(&f, ASSET_CODEC_ZSTD, test_handle(0x200u));
+    free(f.as.image.pixels);
+    asset_manager_set_pack_codec(&g_am, ASSET_IMAGE, ASSET_CODEC_ZSTD);
+}
+
+static void test_v4_blocks(void)
+{
+    asset_manager_set_pack_texture_compression(&g_am, true);
+    asset_any_t a = make_image(64u, 64u, 3u, false, 5u);
+    const ihandle_t h = test_handle(0x300u);
+
+    asset_blob_t blob;
+    memset(&blob, 0, sizeof(blob));
+    TEST_CHECK(g_itex.save_blob_fn(&g_am, h, &a, &blob));
+
+    asset_any_t out;
+    ihandle_t hid;
+    TEST_CHECK(g_itex.load_blob_fn(&g_am, ITEX_TEST_FILE, &blob, &out, &hid));
+    const asset_image_mip_chain_t *m = out.as.image.mips;
+    TEST_CHECK(m && m->bc_format != 0u && m->mip_count == 7u);
+    TEST_CHECK(ihandle_eq(hid, h));
+
+    // Block chains are written as they are, so saving the loaded image again gives the same bytes
+    // once its sharper levels are read back.
+    uint8_t *levels[ASSET_IMAGE_MAX_MIPS];
+    memset(levels, 0, sizeof(levels));
+    if (m && m->resident_first)
+    {
+        TEST_CHECK(g_itex.mip_read_fn(&g_am, ITEX_TEST_FILE, &blob, m, 0u, m->resident_first - 1u, levels));
+        for (uint32_t i = 0; i < m->resident_first; ++i)
+            out.as.image.mips->level[i] = levels[i];
+    }
+
+    asset_blob_t again;
+    memset(&again, 0, sizeof(again));
+    TEST_CHECK(g_itex.save_blob_fn(&g_am, h, &out, &again));
+    TEST_CHECK(again.size == blob.size && again.data && memcmp(again.data, blob.data, blob.size) == 0);
+
+    if (m)
+    {
+        for (uint32_t i = 0; i < m->resident_first; ++i)
+        {
+            out.as.image.mips->level[i] = NULL;
+            free(levels[i]);
+        }
+    }
+    g_itex.blob_free_fn(&g_am, &again);
+    g_itex.blob_free_fn(&g_am, &blob);
+    g_itex.cleanup_fn(&g_am, &out);
+    free(a.as.image.pixels);
+    asset_manager_set_pack_texture_compression(&g_am, false);
+}
+
+static void test_v3_legacy(void)
+{
+    asset_any_t a = make_image(48u, 20u, 4u, false, 11u);
+    asset_image_mip_chain_t *ref = reference_chain(&a);
+    TEST_CHECK(ref != NULL);
+    if (!ref)
+    {
+        free(a.as.image.pixels);
+        return;
+    }
+
+    const ihandle_t h = test_handle(0x400u);
+    const uint32_t table = ref->mip_count * (uint32_t)sizeof(itex_v3_mip_t);
+    const uint32_t payload_at = (uint32_t)sizeof(itex_v3_header_t) + table;
+    const uint32_t size = payload_at + (uint32_t)ref->total_size;
+    uint8_t *file = (uint8_t *)calloc(1, size);
+    TEST_CHECK(sizeof(itex_v3_header_t) == 56u && file != NULL);
+    if (!file)
+    {
+        asset_image_mips_free(ref);
+        free(a.as.image.pixels);
+        return;
+    }
+
+    itex_v3_header_t hd;
+    memset(&hd, 0, sizeof(hd));
+    hd.magic = 0x58455449u;
+    hd.version = 3u;
+    hd.header_size = (uint16_t)sizeof(hd);
+    hd.width = a.as.image.width;
+    hd.height = a.as.image.height;
+    hd.channels = a.as.image.channels;
+    hd.has_alpha = 1u;
+    hd.uncompressed_size = (uint32_t)ref->total_size;
+    hd.compressed_size = (uint32_t)ref->total_size;
+    hd.handle_value = (uint32_t)h.value;
+    hd.handle_type = h.type;
+    hd.handle_meta = h.meta;
+    hd.mip_count = ref->mip_count;
+    memcpy(file, &hd, sizeof(hd));
+
+    uint32_t cursor = payload_at;
+    for (uint32_t i = 0; i < ref->mip_count; ++i)
+    {
+        itex_v3_mip_t e = {cursor, (uint32_t)ref->size[i], 0u, 0u};
+        memcpy(file + sizeof(hd) + i * sizeof(e), &e, sizeof(e));
+        memcpy(file + cursor, ref->level[i], (size_t)ref->size[i]);
+        cursor += (uint32_t)ref->size[i];
+    }
+
+    asset_blob_t blob;
+    memset(&blob, 0, sizeof(blob));
+    blob.data = file;
+    blob.size = size;
+
+    asset_any_t out;
+    ihandle_t hid;
+    TEST_CHECK(g_itex.load_blob_fn(&g_am, ITEX_TEST_FILE, &blob, &out, &hid));
+    check_loaded(&out, hid, h, ref, &blob);
+    g_itex.cleanup_fn(&g_am, &out);
+
+    TEST_CHECK(write_file(ITEX_TEST_FILE, file, size));
+    TEST_CHECK(g_itex.load_fn(&g_am, ITEX_TEST_FILE, 0u, &out, &hid));
+    check_loaded(&out, hid, h, ref, NULL);
+    g_itex.cleanup_fn(&g_am, &out);
+    remove(ITEX_TEST_FILE);
+
+    // A level table entry pointing past the end of the file is rejected.
+    itex_v3_mip_t bad = {size, 16u, 0u, 0u};
+    memcpy(file + sizeof(hd), &bad, sizeof(bad));
+    TEST_CHECK(!g_itex.load_blob_fn(&g_am, ITEX_TEST_FILE, &blob, &out, &hid));
+
+    free(file);
+    asset_image_mips_free(ref);
+    free(a.as.image.pixels);
+}
+
+int main(void)
+{
+    if (!jobs_init(3u))
+        return 1;
+
+    asset_manager_desc_t desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.handle_type = iHANDLE_TYPE_ASSET;
+    if (!asset_manager_init(&g_am, &desc))
+        return 1;
+    g_itex = asset_module_image_itex();
+
+    TEST_RUN(test_v4_pixels);
+    TEST_RUN(test_v4_blocks);
+    TEST_RUN(test_v3_legacy);
+
+    asset_manager_shutdown(&g_am);
+    jobs_shutdown();
+    return test_failures ? 1 : 0;
+}
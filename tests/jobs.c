@@ -0,0 +1,212 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "utils/jobs.h"
+#include "utils/threads.h"
+
+#define POOL_WORKERS 3u
+// More than the job system has dedicated slots for, so some threads share the overflow slot.
+#define EXTERNAL_THREADS 12u
+#define RANGE_COUNT 4096u
+
+typedef struct ext_ctx_t
+{
+    uint32_t index;
+    uint32_t worker_index;
+    volatile uint32_t *busy;
+    volatile uint32_t collisions;
+    volatile uint32_t sum;
+} ext_ctx_t;
+
+static void sleep_ms(uint32_t ms)
+{
+    volatile uint32_t never = 0;
+    threads_futex_wait(&never, 0u, ms);
+}
+
+static void index_main(void *arg)
+{
+    ext_ctx_t *ctx = (ext_ctx_t *)arg;
+    ctx->worker_index = jobs_worker_index();
+}
+
+static void test_external_index(void)
+{
+    thread_t t[4];
+    ext_ctx_t ctx[4];
+    memset(ctx, 0, sizeof(ctx));
+    for (uint32_t i = 0; i < 4u; ++i)
+        TEST_CHECK(threads_thread_create(&t[i], index_main, &ctx[i]));
+    for (uint32_t i = 0; i < 4u; ++i)
+        threads_thread_join(&t[i]);
+
+    // Each thread outside the pool gets its own index past the pool's.
+    bool distinct = true;
+    for (uint32_t i = 0; i < 4u; ++i)
+    {
+        distinct &= ctx[i].worker_index >= jobs_pool_size() && ctx[i].worker_index < jobs_thread_count();
+        for (uint32_t k = 0; k < i; ++k)
+            distinct &= ctx[i].worker_index != ctx[k].worker_index;
+    }
+    TEST_CHECK(distinct);
+    TEST_CHECK(jobs_worker_index() == 0u);
+}
+
+// Two threads running with the same worker_index at once would share its scratch.
+static void range_check(void *user, uint32_t begin, uint32_t end, uint32_t worker_index)
+{
+    ext_ctx_t *ctx = (ext_ctx_t *)user;
+    if (worker_index >= jobs_thread_count())
+    {
+        atomic_add_u32(&ctx->collisions, 1u);
+        return;
+    }
+    if (atomic_add_u32(&ctx->busy[worker_index], 1u) != 1u)
+        atomic_add_u32(&ctx->collisions, 1u);
+    for (uint32_t i = begin; i < end; ++i)
+        atomic_add_u32(&ctx->sum, 1u);
+    threads_yield();
+    atomic_sub_u32(&ctx->busy[worker_index], 1u);
+}
+
+static void parallel_main(void *arg)
+{
+    ext_ctx_t *ctx = (ext_ctx_t *)arg;
+    jobs_parallel_for(RANGE_COUNT, 64u, range_check, ctx);
+}
+
+static void test_parallel_for_external(void)
+{
+    volatile uint32_t *busy = (volatile uint32_t *)calloc(jobs_thread_count(), sizeof(uint32_t));
+    thread_t t[EXTERNAL_THREADS];
+    ext_ctx_t ctx[EXTERNAL_THREADS];
+    memset(ctx, 0, sizeof(ctx));
+    for (uint32_t i = 0; i < EXTERNAL_THREADS; ++i)
+    {
+        ctx[i].busy = busy;
+        TEST_CHECK(threads_thread_create(&t[i], parallel_main, &ctx[i]));
+    }
+
+    ext_ctx_t own = {0};
+    own.busy = busy;
+    jobs_parallel_for(RANGE_COUNT, 64u, range_check, &own);
+
+    for (uint32_t i = 0; i < EXTERNAL_THREADS; ++i)
+        threads_thread_join(&t[i]);
+
+    // Every batch checks the shared busy table, so a collision in any of them shows up here.
+    uint32_t collisions = own.collisions;
+    bool sums = own.sum == RANGE_COUNT;
+    for (uint32_t i = 0; i < EXTERNAL_THREADS; ++i)
+    {
+        collisions += ctx[i].collisions;
+        sums &= ctx[i].sum == RANGE_COUNT;
+    }
+    TEST_CHECK(collisions == 0u);
+    TEST_CHECK(sums);
+    free((void *)busy);
+}
+
+typedef struct background_ctx_t
+{
+    volatile uint32_t running;
+    volatile uint32_t peak;
+    volatile uint32_t done;
+} background_ctx_t;
+
+static void background_job(void *user, uint32_t worker_index)
+{
+    (void)worker_index;
+    background_ctx_t *ctx = (background_ctx_t *)user;
+    const uint32_t now = atomic_add_u32(&ctx->running, 1u);
+    uint32_t peak = atomic_load_u32(&ctx->peak);
+    while (now > peak && !atomic_cas_u32(&ctx->peak, peak, now))
+        peak = atomic_load_u32(&ctx->peak);
+    sleep_ms(10u);
+    atomic_sub_u32(&ctx->running, 1u);
+    atomic_add_u32(&ctx->done, 1u);
+}
+
+static void short_job(void *user, uint32_t worker_index)
+{
+    (void)worker_index;
+    atomic_add_u32((volatile uint32_t *)user, 1u);
+}
+
+static void short_main(void *arg)
+{
+    volatile uint32_t *count = (volatile uint32_t *)arg;
+    jobs_counter_t c;
+    memset(&c, 0, sizeof(c));
+    for (uint32_t i = 0; i < 64u; ++i)
+        jobs_run(short_job, (void *)count, &c);
+    jobs_wait(&c);
+}
+
+static void test_background_limit(void)
+{
+    TEST_CHECK(jobs_background_limit() == POOL_WORKERS - 1u);
+
+    background_ctx_t ctx = {0};
+    jobs_counter_t bg;
+    memset(&bg, 0, sizeof(bg));
+    for (uint32_t i = 0; i < 16u; ++i)
+        jobs_run_background(background_job, &ctx, &bg);
+
+    // Short jobs queued from another thread still finish while the background queue is full.
+    volatile uint32_t count = 0;
+    thread_t t;
+    TEST_CHECK(threads_thread_create(&t, short_main, (void *)&count));
+    threads_thread_join(&t);
+    TEST_CHECK(count == 64u);
+
+    jobs_wait(&bg);
+    TEST_CHECK(ctx.done == 16u);
+    TEST_CHECK(ctx.peak >= 1u && ctx.peak <= jobs_background_limit());
+
+    jobs_set_background_limit(1u);
+    memset(&ctx, 0, sizeof(ctx));
+    for (uint32_t i = 0; i < 6u; ++i)
+        jobs_run_background(background_job, &ctx, &bg);
+    jobs_wait(&bg);
+    TEST_CHECK(ctx.done == 6u && ctx.peak == 1u);
+    jobs_set_background_limit(POOL_WORKERS - 1u);
+}
+
+static void wait_main(void *arg)
+{
+    jobs_wait((jobs_counter_t *)arg);
+}
+
+static void test_wait_parks(void)
+{
+    // Threads that find nothing to help with go to sleep and are woken when the counter settles.
+    background_ctx_t ctx = {0};
+    jobs_counter_t c;
+    memset(&c, 0, sizeof(c));
+    for (uint32_t i = 0; i < 4u; ++i)
+        jobs_run_background(background_job, &ctx, &c);
+
+    thread_t t[4];
+    for (uint32_t i = 0; i < 4u; ++i)
+        TEST_CHECK(threads_thread_create(&t[i], wait_main, &c));
+    jobs_wait(&c);
+    for (uint32_t i = 0; i < 4u; ++i)
+        threads_thread_join(&t[i]);
+    TEST_CHECK(ctx.done == 4u);
+}
+
+int main(void)
+{
+    if (!jobs_init(POOL_WORKERS))
+        return 1;
+    TEST_RUN(test_external_index);
+    TEST_RUN(test_parallel_for_external);
+    TEST_RUN(test_background_limit);
+    TEST_RUN(test_wait_parks);
+    jobs_shutdown();
+    return test_failures ? 1 : 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdio.h>
+
+static int test_failures;
+
+#define TEST_CHECK(cond)                                                             \
+    do                                                                               \
+    {                                                                                \
+        if (!(cond))                                                                 \
+        {                                                                            \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                         \
+        }                                                                            \
+    } while (0)
+
+#define TEST_RUN(fn)                                                        \
+    do                                                                      \
+    {                                                                       \
+        const int before = test_failures;                                   \
+        fn();                                                               \
+        printf("%-40s %s\n", #fn, test_failures == before ? "ok" : "FAIL"); \
+    } while (0)